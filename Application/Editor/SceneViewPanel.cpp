@@ -2404,32 +2404,12 @@ void SceneViewPanel::updateParticlePreview(float deltaTime)
                 glm::vec3 velocity = (worldPos - ps.lastPosition) / std::max(deltaTime, 0.001f);
                 ps.emitter->SetConfig(ps.emitterConfig);
                 ps.emitter->Update(*ps.pool, deltaTime, worldPos, velocity * ps.emitterConfig.inheritVelocityMultiplier, worldScale);
-                ps.affectors.UpdateBatch(ps.pool->GetParticles(), deltaTime);
+                ps.affectors.UpdateBatch(ps.pool->GetStreams(), deltaTime);
                 if (ps.collisionEnabled)
                 {
-                    for (auto& particle : ps.pool->GetParticles())
-                    {
-                        float distance = glm::dot(particle.position - ps.collisionPlanePoint, ps.collisionPlaneNormal);
-                        if (distance < 0.0f)
-                        {
-                            if (ps.collisionKillOnHit)
-                            {
-                                particle.age = particle.lifetime;
-                            }
-                            else
-                            {
-                                particle.position -= ps.collisionPlaneNormal * distance;
-                                float normalVelocity = glm::dot(particle.velocity, ps.collisionPlaneNormal);
-                                if (normalVelocity < 0.0f)
-                                {
-                                    glm::vec3 normalComponent = ps.collisionPlaneNormal * normalVelocity;
-                                    glm::vec3 tangentComponent = particle.velocity - normalComponent;
-                                    particle.velocity = tangentComponent * (1.0f - ps.collisionFriction) - 
-                                                        normalComponent * ps.collisionBounciness;
-                                }
-                            }
-                        }
-                    }
+                    Particles::Kernels::PlaneCollision(ps.pool->GetStreams(), glm::vec2(ps.collisionPlanePoint),
+                                                       glm::vec2(ps.collisionPlaneNormal), ps.collisionBounciness,
+                                                       ps.collisionFriction, ps.collisionKillOnHit);
                 }
                 ps.pool->RemoveDeadParticles();
                 ps.pool->SyncToGPU();
@@ -4,6 +4,7 @@
 #include "IComponent.h"
 #include "../Systems/WorldStreaming/ChunkManager.h"
 #include <memory>
+#include <string>
 
 namespace ECS
 {
@@ -12,6 +13,10 @@ namespace ECS
         int loadRadius = 4;
         int unloadRadius = 6;
         float tileSize = 16.0f;
+        int maxGenerateJobs = WorldStreaming::ChunkManager::DefaultMaxInFlight;  ///< 同时在工作线程上生成的区块数。
+        float integrationBudgetMs = static_cast<float>(WorldStreaming::ChunkManager::DefaultIntegrationBudgetMs);  ///< 每帧接入区块的时间预算。
+        float lookAheadSeconds = WorldStreaming::ChunkManager::DefaultLookAheadSeconds;  ///< 按相机速度预取的时间。
+        std::string saveDirectory;  ///< 区域文件目录，为空时不持久化，卸载的区块直接丢弃。
         std::shared_ptr<WorldStreaming::ChunkManager> chunkManager;
     };
 }
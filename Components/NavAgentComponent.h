@@ -3,8 +3,14 @@
 
 #include "IComponent.h"
 #include "Core.h"
+#include <memory>
 #include <vector>
 
+namespace Navigation
+{
+    class FlowField;
+}
+
 namespace ECS
 {
     struct NavAgentComponent : IComponent
@@ -13,8 +19,20 @@ namespace ECS
         float speed = 100.0f;
         std::vector<Vector2f> path;
         int currentWaypointIndex = 0;
+        std::vector<Vector2f> corridor;  ///< 分层寻路得到的拐点，按需细化后追加到 path。
+        int corridorIndex = 0;           ///< 下一个待细化路段的终点下标。
+        std::shared_ptr<const Navigation::FlowField> flowField;  ///< 与同目标代理共享的流场，非空时按流场移动。
+        int pathPriority = 0;  ///< 异步寻路请求的优先级，越大越先处理。
+        bool smoothPath = true;    ///< 收到路径后按视线拉直，删除多余的逐格路径点。
+        float cornerRadius = 0.0f;  ///< 拉直后拐角圆化的半径（世界单位），不大于 0 时不圆化。
+        float radius = 16.0f;     ///< 局部避让使用的碰撞半径。
+        float maxSpeed = 0.0f;    ///< 避让时允许的最大速度，不大于 0 时取 speed。
+        int maxNeighbors = 10;    ///< 避让时考虑的最近邻居数。
+        Vector2f velocity{0.0f, 0.0f};  ///< 上一帧避让后实际采用的速度。
+        bool avoidanceEnabled = false;  ///< 是否参与代理之间的 ORCA 避让。
         bool hasArrived = true;
         bool isPathRequested = false;
+        bool isPathPending = false;  ///< 请求已排队但结果尚未交付，期间沿旧路径或直线前进。
     };
 }
 
@@ -3,6 +3,7 @@
 #include "../Data/ParticleData.h"
 #include "../Particles/Emitter.h"
 #include "../Particles/Affector.h"
+#include "../Particles/ParticleCulling.h"
 #include "IComponent.h"
 #include "AssetHandle.h"
 #include "ComponentRegistry.h"
@@ -68,6 +69,10 @@ namespace ECS
         float physicsCollisionFriction = 0.1f;
         bool physicsCollisionKillOnHit = false;
         float particleRadius = 2.0f; // 粒子碰撞半径（像素）
+        // 离屏休眠与粒子预算
+        bool cullWhenOffscreen = true; // 离开视口后降低模拟频率或休眠
+        float cullingMargin = 64.0f; // 视口外仍按可见处理的边距（像素）
+        int importance = 0; // 超出全局粒子预算时重要度低的发射器先被裁掉
         ParticlePlayState playState = ParticlePlayState::Stopped;
         float systemTime = 0.0f; 
         std::unique_ptr<Particles::ParticlePool> pool;
@@ -75,6 +80,12 @@ namespace ECS
         Particles::AffectorChain affectors;
         glm::vec3 lastPosition{0.0f};
         glm::vec3 currentVelocity{0.0f};
+        Particles::SimulationLod simulationLod = Particles::SimulationLod::Full;
+        Particles::ParticleBounds worldBounds; 
+        Particles::ParticleBounds liveBounds; 
+        float sleepingTime = 0.0f; 
+        float reducedDeltaTime = 0.0f; 
+        uint32_t lodFrameCounter = 0;
         bool configDirty = true;
         bool editorPreviewActive = false; 
         void Initialize()
@@ -158,6 +169,26 @@ namespace ECS
         {
             return affectors.Add<Particles::LinearDragAffector>(damping);
         }
+        /**
+         * @brief 从休眠中唤醒，把休眠期间的模拟时间快进到当前。
+         */
+        void WakeUp(const glm::vec3& worldPosition, const glm::vec2& scale)
+        {
+            if (sleepingTime <= 0.0f) return;
+            if (emitter && pool)
+            {
+                bool emit = loop || systemTime < duration;
+                Particles::FastForward(*emitter, *pool, affectors, sleepingTime, worldPosition, scale, emit);
+            }
+            systemTime += sleepingTime;
+            if (loop && duration > 0.0f)
+            {
+                systemTime = std::fmod(systemTime, duration);
+            }
+            sleepingTime = 0.0f;
+            reducedDeltaTime = 0.0f;
+            lastPosition = worldPosition;
+        }
         void Play()
         {
             if (playState == ParticlePlayState::Stopped)
@@ -175,7 +206,7 @@ namespace ECS
                     for (float t = 0.0f; t < prewarmTime; t += dt)
                     {
                         emitter->Update(*pool, dt);
-                        affectors.UpdateBatch(pool->GetParticles(), dt);
+                        affectors.UpdateBatch(pool->GetStreams(), dt);
                         pool->RemoveDeadParticles();
                     }
                 }
@@ -279,6 +310,9 @@ namespace ECS
               , physicsCollisionFriction(other.physicsCollisionFriction)
               , physicsCollisionKillOnHit(other.physicsCollisionKillOnHit)
               , particleRadius(other.particleRadius)
+              , cullWhenOffscreen(other.cullWhenOffscreen)
+              , cullingMargin(other.cullingMargin)
+              , importance(other.importance)
         {
             configDirty = true;
         }
@@ -332,6 +366,9 @@ namespace ECS
                 physicsCollisionFriction = other.physicsCollisionFriction;
                 physicsCollisionKillOnHit = other.physicsCollisionKillOnHit;
                 particleRadius = other.particleRadius;
+                cullWhenOffscreen = other.cullWhenOffscreen;
+                cullingMargin = other.cullingMargin;
+                importance = other.importance;
                 configDirty = true;
             }
             return *this;
@@ -431,6 +468,7 @@ namespace YAML
             node["drag"] = config.drag;
             node["inheritVelocityMultiplier"] = config.inheritVelocityMultiplier;
             node["maxParticles"] = config.maxParticles;
+            node["randomSeed"] = config.randomSeed;
             return node;
         }
         static bool decode(const Node& node, Particles::EmitterConfig& config)
@@ -471,6 +509,7 @@ namespace YAML
             if (node["drag"]) config.drag = node["drag"].as<Particles::FloatRange>();
             config.inheritVelocityMultiplier = node["inheritVelocityMultiplier"].as<float>(0.0f);
             config.maxParticles = node["maxParticles"].as<uint32_t>(1000);
+            config.randomSeed = node["randomSeed"].as<uint32_t>(0);
             return true;
         }
     };
@@ -535,6 +574,9 @@ namespace YAML
             node["physicsCollisionFriction"] = ps.physicsCollisionFriction;
             node["physicsCollisionKillOnHit"] = ps.physicsCollisionKillOnHit;
             node["particleRadius"] = ps.particleRadius;
+            node["cullWhenOffscreen"] = ps.cullWhenOffscreen;
+            node["cullingMargin"] = ps.cullingMargin;
+            node["importance"] = ps.importance;
             return node;
         }
         static bool decode(const Node& node, ECS::ParticleSystemComponent& ps)
@@ -618,6 +660,9 @@ namespace YAML
             ps.physicsCollisionFriction = node["physicsCollisionFriction"].as<float>(0.1f);
             ps.physicsCollisionKillOnHit = node["physicsCollisionKillOnHit"].as<bool>(false);
             ps.particleRadius = node["particleRadius"].as<float>(2.0f);
+            ps.cullWhenOffscreen = node["cullWhenOffscreen"].as<bool>(true);
+            ps.cullingMargin = node["cullingMargin"].as<float>(64.0f);
+            ps.importance = node["importance"].as<int>(0);
             ps.configDirty = true;
             return true;
         }
@@ -771,6 +816,8 @@ namespace CustomDrawing
                     config.maxParticles = static_cast<uint32_t>(maxParticles);
                     changed = true;
                 }
+                if (ImGui::DragScalar("Random Seed", ImGuiDataType_U32, &config.randomSeed)) changed = true;
+                ImGui::SetItemTooltip("0=每次运行随机, 非0=相同种子重现相同的发射序列");
                 ImGui::SeparatorText("Shape");
                 const char* shapeItems[] = {"Point", "Circle", "Sphere", "Box", "Cone", "Edge", "Hemisphere", "Rectangle"};
                 int shapeIndex = static_cast<int>(config.shape);
@@ -915,6 +962,26 @@ namespace CustomDrawing
                     changed = true;
                 }
             }
+            if (ImGui::Checkbox("Cull When Offscreen", &ps.cullWhenOffscreen))
+            {
+                callbacks.onValueChanged();
+                changed = true;
+            }
+            ImGui::SetItemTooltip("离开视口后休眠，重新可见时快进到当前状态");
+            if (ps.cullWhenOffscreen)
+            {
+                if (ImGui::DragFloat("Culling Margin", &ps.cullingMargin, 1.0f, 0.0f, 4096.0f))
+                {
+                    callbacks.onValueChanged();
+                    changed = true;
+                }
+            }
+            if (ImGui::DragInt("Importance", &ps.importance, 1, -100, 100))
+            {
+                callbacks.onValueChanged();
+                changed = true;
+            }
+            ImGui::SetItemTooltip("超出全局粒子预算时重要度低的发射器先被裁掉");
             ImGui::SeparatorText("Force Fields");
             if (ImGui::Checkbox("Gravity", &ps.gravityEnabled))
             {
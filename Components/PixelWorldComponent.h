@@ -14,6 +14,8 @@ namespace ECS
         uint32_t worldHeight = 512;
         float pixelScale = 1.0f;
         bool paused = false;
+        bool cpuSimulation = false; ///< 使用 CPU 多线程模拟；没有图形上下文时总是使用 CPU。
+        uint32_t seed = 0;          ///< CPU 模拟的随机种子。
         std::shared_ptr<PixelWorld> world;
     };
 }
@@ -31,6 +33,8 @@ namespace YAML
             node["worldHeight"] = rhs.worldHeight;
             node["pixelScale"] = rhs.pixelScale;
             node["paused"] = rhs.paused;
+            node["cpuSimulation"] = rhs.cpuSimulation;
+            node["seed"] = rhs.seed;
             return node;
         }
 
@@ -42,6 +46,8 @@ namespace YAML
             if (node["worldHeight"]) rhs.worldHeight = node["worldHeight"].as<uint32_t>();
             if (node["pixelScale"]) rhs.pixelScale = node["pixelScale"].as<float>();
             if (node["paused"]) rhs.paused = node["paused"].as<bool>();
+            if (node["cpuSimulation"]) rhs.cpuSimulation = node["cpuSimulation"].as<bool>();
+            if (node["seed"]) rhs.seed = node["seed"].as<uint32_t>();
             return true;
         }
     };
@@ -71,6 +71,7 @@ namespace ECS
 
 
         std::unordered_map<Vector2i, ResolvedTile, Vector2iHash> runtimeTileCache; ///< 运行时瓦片缓存，键为瓦片位置，值为已解析的瓦片信息。
+        uint64_t runtimeRevision = 0; ///< 运行时瓦片缓存每次重建后递增，供导航烘焙等系统检测变化。
         std::unordered_map<Vector2i, Guid, Vector2iHash> instantiatedPrefabs; ///< 已实例化的预制体映射，键为瓦片位置，值为预制体的全局唯一标识符。
     };
 
@@ -6,24 +6,23 @@
 #include <glm/glm.hpp>
 namespace Particles
 {
-    struct alignas(16) ParticleData
+    struct ParticleData
     {
-        glm::vec3 position{0.0f};      
-        float age{0.0f};               
-        glm::vec3 velocity{0.0f};      
-        float lifetime{1.0f};          
-        glm::vec4 color{1.0f};         
-        glm::vec2 size{1.0f};          
-        float rotation{0.0f};          
-        float angularVelocity{0.0f};   
-        glm::vec4 startColor{1.0f};    
-        glm::vec4 endColor{1.0f};      
-        glm::vec2 startSize{1.0f};     
-        glm::vec2 endSize{1.0f};       
-        uint32_t textureIndex{0};      
-        uint32_t flags{0};             
-        float mass{1.0f};              
-        float drag{0.0f};              
+        glm::vec2 position{0.0f};
+        glm::vec2 velocity{0.0f};
+        float age{0.0f};
+        float lifetime{1.0f};
+        glm::vec4 color{1.0f};
+        glm::vec2 size{1.0f};
+        float rotation{0.0f};
+        float angularVelocity{0.0f};
+        glm::vec4 startColor{1.0f};
+        glm::vec4 endColor{1.0f};
+        glm::vec2 startSize{1.0f};
+        glm::vec2 endSize{1.0f};
+        uint32_t textureIndex{0};
+        float mass{1.0f};
+        float drag{0.0f};
         [[nodiscard]] float GetNormalizedAge() const
         {
             return lifetime > 0.0f ? age / lifetime : 1.0f;
@@ -40,6 +39,95 @@ namespace Particles
         glm::vec4 sizeAndUV;           
         glm::vec4 uvScaleAndIndex;     
     };
+    /**
+     * @brief 粒子属性的结构数组（SoA）存储。
+     *
+     * 每个属性一条连续的 float 流，影响器以批处理内核的形式逐流处理，
+     * 可以直接交给 SIMD 层做向量运算。所有流的长度始终等于 count。
+     */
+    struct ParticleStreams
+    {
+        std::vector<float> positionX, positionY;
+        std::vector<float> velocityX, velocityY;
+        std::vector<float> age, lifetime;
+        std::vector<float> rotation, angularVelocity;
+        std::vector<float> sizeX, sizeY;
+        std::vector<float> startSizeX, startSizeY, endSizeX, endSizeY;
+        std::vector<float> colorR, colorG, colorB, colorA;
+        std::vector<float> startColorR, startColorG, startColorB, startColorA;
+        std::vector<float> endColorR, endColorG, endColorB, endColorA;
+        std::vector<float> mass, drag;
+        std::vector<uint32_t> textureIndex;
+        size_t count = 0;
+        template<typename Fn>
+        void ForEachStream(Fn&& fn)
+        {
+            for (auto* stream : {&positionX, &positionY, &velocityX, &velocityY, &age, &lifetime,
+                                 &rotation, &angularVelocity, &sizeX, &sizeY,
+                                 &startSizeX, &startSizeY, &endSizeX, &endSizeY,
+                                 &colorR, &colorG, &colorB, &colorA,
+                                 &startColorR, &startColorG, &startColorB, &startColorA,
+                                 &endColorR, &endColorG, &endColorB, &endColorA, &mass, &drag})
+            {
+                fn(*stream);
+            }
+            fn(textureIndex);
+        }
+        void Resize(size_t newCount)
+        {
+            ForEachStream([newCount](auto& stream) { stream.resize(newCount); });
+            count = newCount;
+        }
+        void Reserve(size_t capacity)
+        {
+            ForEachStream([capacity](auto& stream) { stream.reserve(capacity); });
+        }
+        void Set(size_t i, const ParticleData& p)
+        {
+            positionX[i] = p.position.x; positionY[i] = p.position.y;
+            velocityX[i] = p.velocity.x; velocityY[i] = p.velocity.y;
+            age[i] = p.age; lifetime[i] = p.lifetime;
+            rotation[i] = p.rotation; angularVelocity[i] = p.angularVelocity;
+            sizeX[i] = p.size.x; sizeY[i] = p.size.y;
+            startSizeX[i] = p.startSize.x; startSizeY[i] = p.startSize.y;
+            endSizeX[i] = p.endSize.x; endSizeY[i] = p.endSize.y;
+            colorR[i] = p.color.r; colorG[i] = p.color.g; colorB[i] = p.color.b; colorA[i] = p.color.a;
+            startColorR[i] = p.startColor.r; startColorG[i] = p.startColor.g;
+            startColorB[i] = p.startColor.b; startColorA[i] = p.startColor.a;
+            endColorR[i] = p.endColor.r; endColorG[i] = p.endColor.g;
+            endColorB[i] = p.endColor.b; endColorA[i] = p.endColor.a;
+            mass[i] = p.mass; drag[i] = p.drag;
+            textureIndex[i] = p.textureIndex;
+        }
+        [[nodiscard]] ParticleData Get(size_t i) const
+        {
+            ParticleData p;
+            p.position = {positionX[i], positionY[i]};
+            p.velocity = {velocityX[i], velocityY[i]};
+            p.age = age[i]; p.lifetime = lifetime[i];
+            p.rotation = rotation[i]; p.angularVelocity = angularVelocity[i];
+            p.size = {sizeX[i], sizeY[i]};
+            p.startSize = {startSizeX[i], startSizeY[i]};
+            p.endSize = {endSizeX[i], endSizeY[i]};
+            p.color = {colorR[i], colorG[i], colorB[i], colorA[i]};
+            p.startColor = {startColorR[i], startColorG[i], startColorB[i], startColorA[i]};
+            p.endColor = {endColorR[i], endColorG[i], endColorB[i], endColorA[i]};
+            p.mass = mass[i]; p.drag = drag[i];
+            p.textureIndex = textureIndex[i];
+            return p;
+        }
+        [[nodiscard]] bool IsDead(size_t i) const
+        {
+            return age[i] >= lifetime[i];
+        }
+        /**
+         * @brief 把下标 from 的粒子移动到下标 to（交换压缩使用）。
+         */
+        void Move(size_t to, size_t from)
+        {
+            ForEachStream([to, from](auto& stream) { stream[to] = stream[from]; });
+        }
+    };
     class ParticlePool
     {
     public:
@@ -49,70 +137,83 @@ namespace Particles
         }
         void Reserve(size_t capacity)
         {
-            m_particles.reserve(capacity);
+            m_streams.Reserve(capacity);
             m_gpuData.reserve(capacity);
         }
-        ParticleData& Emit()
+        size_t Emit(const ParticleData& particle = {})
         {
-            m_particles.emplace_back();
-            m_gpuData.emplace_back();
-            return m_particles.back();
+            size_t index = m_streams.count;
+            m_streams.Resize(index + 1);
+            m_streams.Set(index, particle);
+            return index;
         }
         size_t EmitBatch(size_t count)
         {
-            size_t startIndex = m_particles.size();
-            m_particles.resize(m_particles.size() + count);
-            m_gpuData.resize(m_gpuData.size() + count);
+            size_t startIndex = m_streams.count;
+            m_streams.Resize(startIndex + count);
+            const ParticleData defaults;
+            for (size_t i = startIndex; i < m_streams.count; ++i)
+            {
+                m_streams.Set(i, defaults);
+            }
             return startIndex;
         }
+        /**
+         * @brief 以交换压缩移除死亡粒子：死亡粒子由末尾的存活粒子填补，存活粒子的相对顺序不保证。
+         */
         size_t RemoveDeadParticles()
         {
-            size_t removed = 0;
+            size_t count = m_streams.count;
             size_t i = 0;
-            while (i < m_particles.size())
+            while (i < count)
             {
-                if (m_particles[i].IsDead())
+                if (m_streams.IsDead(i))
                 {
-                    if (i != m_particles.size() - 1)
+                    --count;
+                    while (count > i && m_streams.IsDead(count))
                     {
-                        std::swap(m_particles[i], m_particles.back());
-                        std::swap(m_gpuData[i], m_gpuData.back());
+                        --count;
+                    }
+                    if (count > i)
+                    {
+                        m_streams.Move(i, count);
                     }
-                    m_particles.pop_back();
-                    m_gpuData.pop_back();
-                    ++removed;
-                }
-                else
-                {
-                    ++i;
                 }
+                ++i;
+            }
+            size_t removed = m_streams.count - count;
+            if (removed > 0)
+            {
+                m_streams.Resize(count);
             }
             return removed;
         }
         void Clear()
         {
-            m_particles.clear();
+            m_streams.Resize(0);
             m_gpuData.clear();
         }
         void SyncToGPU()
         {
-            for (size_t i = 0; i < m_particles.size(); ++i)
+            const size_t n = m_streams.count;
+            m_gpuData.resize(n);
+            const ParticleStreams& s = m_streams;
+            for (size_t i = 0; i < n; ++i)
             {
-                const auto& p = m_particles[i];
                 auto& gpu = m_gpuData[i];
-                gpu.positionAndRotation = glm::vec4(p.position, p.rotation);
-                gpu.color = p.color;
-                gpu.sizeAndUV = glm::vec4(p.size, 0.0f, 0.0f);
-                gpu.uvScaleAndIndex = glm::vec4(1.0f, 1.0f, static_cast<float>(p.textureIndex), 0.0f);
+                gpu.positionAndRotation = glm::vec4(s.positionX[i], s.positionY[i], 0.0f, s.rotation[i]);
+                gpu.color = glm::vec4(s.colorR[i], s.colorG[i], s.colorB[i], s.colorA[i]);
+                gpu.sizeAndUV = glm::vec4(s.sizeX[i], s.sizeY[i], 0.0f, 0.0f);
+                gpu.uvScaleAndIndex = glm::vec4(1.0f, 1.0f, static_cast<float>(s.textureIndex[i]), 0.0f);
             }
         }
-        [[nodiscard]] size_t Size() const { return m_particles.size(); }
-        [[nodiscard]] bool Empty() const { return m_particles.empty(); }
-        [[nodiscard]] size_t Capacity() const { return m_particles.capacity(); }
-        [[nodiscard]] ParticleData& operator[](size_t index) { return m_particles[index]; }
-        [[nodiscard]] const ParticleData& operator[](size_t index) const { return m_particles[index]; }
-        [[nodiscard]] std::vector<ParticleData>& GetParticles() { return m_particles; }
-        [[nodiscard]] const std::vector<ParticleData>& GetParticles() const { return m_particles; }
+        [[nodiscard]] size_t Size() const { return m_streams.count; }
+        [[nodiscard]] bool Empty() const { return m_streams.count == 0; }
+        [[nodiscard]] size_t Capacity() const { return m_streams.positionX.capacity(); }
+        [[nodiscard]] ParticleData Get(size_t index) const { return m_streams.Get(index); }
+        void Set(size_t index, const ParticleData& particle) { m_streams.Set(index, particle); }
+        [[nodiscard]] ParticleStreams& GetStreams() { return m_streams; }
+        [[nodiscard]] const ParticleStreams& GetStreams() const { return m_streams; }
         [[nodiscard]] std::vector<ParticleGPUData>& GetGPUData() { return m_gpuData; }
         [[nodiscard]] const std::vector<ParticleGPUData>& GetGPUData() const { return m_gpuData; }
         [[nodiscard]] const void* GetGPUDataPtr() const
@@ -123,12 +224,8 @@ namespace Particles
         {
             return m_gpuData.size() * sizeof(ParticleGPUData);
         }
-        auto begin() { return m_particles.begin(); }
-        auto end() { return m_particles.end(); }
-        auto begin() const { return m_particles.begin(); }
-        auto end() const { return m_particles.end(); }
     private:
-        std::vector<ParticleData> m_particles;    
+        ParticleStreams m_streams;
         std::vector<ParticleGPUData> m_gpuData;   
     };
     enum class EmitterShape : uint8_t
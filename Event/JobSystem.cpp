@@ -89,7 +89,11 @@ JobHandle JobSystem::Schedule(IJob* job)
         m_taskQueues[queueIndex].push_back(std::move(task));
     }
 
-
+    // 工作线程在持有 m_globalMutex 时检查等待条件；先获取一次该锁，
+    // 保证通知不会落在检查条件与进入等待之间而丢失
+    {
+        std::lock_guard<std::mutex> lock(m_globalMutex);
+    }
     m_condition.notify_all();
     return handle;
 }
@@ -16,6 +16,7 @@
 #include <condition_variable>
 #include <future>
 #include <atomic>
+#include <type_traits>
 
 
 /**
@@ -94,6 +95,58 @@ public:
      */
     static void CompleteAll(std::vector<JobHandle>& handles);
 
+    /**
+     * @brief 调度一组作业并等待全部完成。
+     *
+     * 只有一个作业时直接在调用线程上执行。作业对象由调用方持有，返回前不能移动或销毁。
+     * 等待期间不会执行其他作业，因此不能在作业内部调用。
+     * @param jobs 要执行的作业，元素类型需派生自 IJob。
+     */
+    template <typename Job>
+    static void RunAll(std::vector<Job>& jobs)
+    {
+        if (jobs.empty()) return;
+        if (jobs.size() == 1)
+        {
+            jobs.front().Execute();
+            return;
+        }
+
+        std::vector<JobHandle> handles;
+        handles.reserve(jobs.size());
+        auto& jobSystem = GetInstance();
+        for (auto& job : jobs)
+            handles.push_back(jobSystem.Schedule(&job));
+        CompleteAll(handles);
+    }
+
+    /**
+     * @brief 对 [0, count) 的每个下标调度一个作业执行 fn(index)，并等待全部完成。
+     *
+     * 基于 RunAll，约束相同。
+     * @param count 下标数量。
+     * @param fn 可调用对象，签名为 void(size_t)，会被多个线程同时调用。
+     */
+    template <typename Fn>
+    static void ParallelFor(size_t count, Fn&& fn)
+    {
+        struct IndexJob : public IJob
+        {
+            std::remove_reference_t<Fn>* fn = nullptr;
+            size_t index = 0;
+
+            void Execute() override { (*fn)(index); }
+        };
+
+        std::vector<IndexJob> jobs(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            jobs[i].fn = &fn;
+            jobs[i].index = i;
+        }
+        RunAll(jobs);
+    }
+
     /**
      * @brief 获取作业系统当前配置的线程数量。
      *
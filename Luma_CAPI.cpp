@@ -1385,6 +1385,50 @@ LUMA_API void AnimationController_SetInt(LumaSceneHandle scene, LumaEntityHandle
     }
 }
 
+LUMA_API int AnimationController_GetParameterId(LumaSceneHandle scene, LumaEntityHandle entity, const char* name)
+{
+    if (auto* controller = GetController(scene, entity))
+    {
+        if (name)
+        {
+            return controller->GetVariableId(name);
+        }
+    }
+    return -1;
+}
+
+LUMA_API void AnimationController_SetFloatById(LumaSceneHandle scene, LumaEntityHandle entity, int id, float value)
+{
+    if (auto* controller = GetController(scene, entity))
+    {
+        controller->SetVariable(id, value);
+    }
+}
+
+LUMA_API void AnimationController_SetBoolById(LumaSceneHandle scene, LumaEntityHandle entity, int id, bool value)
+{
+    if (auto* controller = GetController(scene, entity))
+    {
+        controller->SetVariable(id, value);
+    }
+}
+
+LUMA_API void AnimationController_SetIntById(LumaSceneHandle scene, LumaEntityHandle entity, int id, int value)
+{
+    if (auto* controller = GetController(scene, entity))
+    {
+        controller->SetVariable(id, value);
+    }
+}
+
+LUMA_API void AnimationController_SetTriggerById(LumaSceneHandle scene, LumaEntityHandle entity, int id)
+{
+    if (auto* controller = GetController(scene, entity))
+    {
+        controller->SetTrigger(id);
+    }
+}
+
 LUMA_API void AnimationController_SetFrameRate(LumaSceneHandle scene, LumaEntityHandle entity, float frameRate)
 {
     if (auto* controller = GetController(scene, entity))
@@ -3346,6 +3390,83 @@ LUMA_API float NavAgent_GetSpeed(LumaSceneHandle scene, LumaEntityHandle entity)
     return 0.0f;
 }
 
+LUMA_API void NavAgent_SetPathPriority(LumaSceneHandle scene, LumaEntityHandle entity, int priority)
+{
+    if (auto* comp = TryGetComponent<ECS::NavAgentComponent>(AsScene(scene), entity))
+    {
+        comp->pathPriority = priority;
+    }
+}
+
+LUMA_API int NavAgent_GetPathPriority(LumaSceneHandle scene, LumaEntityHandle entity)
+{
+    if (auto* comp = TryGetComponent<ECS::NavAgentComponent>(AsScene(scene), entity))
+    {
+        return comp->pathPriority;
+    }
+    return 0;
+}
+
+LUMA_API void NavAgent_SetPathSmoothing(LumaSceneHandle scene, LumaEntityHandle entity, bool enabled,
+                                        float cornerRadius)
+{
+    if (auto* comp = TryGetComponent<ECS::NavAgentComponent>(AsScene(scene), entity))
+    {
+        comp->smoothPath = enabled;
+        comp->cornerRadius = cornerRadius;
+    }
+}
+
+LUMA_API bool NavAgent_IsPathSmoothingEnabled(LumaSceneHandle scene, LumaEntityHandle entity)
+{
+    if (auto* comp = TryGetComponent<ECS::NavAgentComponent>(AsScene(scene), entity))
+    {
+        return comp->smoothPath;
+    }
+    return false;
+}
+
+LUMA_API float NavAgent_GetCornerRadius(LumaSceneHandle scene, LumaEntityHandle entity)
+{
+    if (auto* comp = TryGetComponent<ECS::NavAgentComponent>(AsScene(scene), entity))
+    {
+        return comp->cornerRadius;
+    }
+    return 0.0f;
+}
+
+LUMA_API void NavAgent_SetAvoidance(LumaSceneHandle scene, LumaEntityHandle entity, bool enabled, float radius,
+                                    float maxSpeed, int maxNeighbors)
+{
+    if (auto* comp = TryGetComponent<ECS::NavAgentComponent>(AsScene(scene), entity))
+    {
+        comp->avoidanceEnabled = enabled;
+        comp->radius = radius;
+        comp->maxSpeed = maxSpeed;
+        comp->maxNeighbors = maxNeighbors;
+        if (!enabled)
+            comp->velocity = {0.0f, 0.0f};
+    }
+}
+
+LUMA_API bool NavAgent_IsAvoidanceEnabled(LumaSceneHandle scene, LumaEntityHandle entity)
+{
+    if (auto* comp = TryGetComponent<ECS::NavAgentComponent>(AsScene(scene), entity))
+    {
+        return comp->avoidanceEnabled;
+    }
+    return false;
+}
+
+LUMA_API void NavAgent_GetVelocity(LumaSceneHandle scene, LumaEntityHandle entity, float* outX, float* outY)
+{
+    if (auto* comp = TryGetComponent<ECS::NavAgentComponent>(AsScene(scene), entity))
+    {
+        if (outX) *outX = comp->velocity.x;
+        if (outY) *outY = comp->velocity.y;
+    }
+}
+
 LUMA_API bool NavAgent_HasArrived(LumaSceneHandle scene, LumaEntityHandle entity)
 {
     if (auto* comp = TryGetComponent<ECS::NavAgentComponent>(AsScene(scene), entity))
@@ -3363,6 +3484,10 @@ LUMA_API void NavAgent_Stop(LumaSceneHandle scene, LumaEntityHandle entity)
         comp->isPathRequested = false;
         comp->path.clear();
         comp->currentWaypointIndex = 0;
+        comp->corridor.clear();
+        comp->corridorIndex = 0;
+        comp->flowField.reset();
+        comp->isPathPending = false;
     }
 }
 
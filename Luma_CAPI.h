@@ -486,6 +486,50 @@ LUMA_API void AnimationController_SetInt(LumaSceneHandle scene, LumaEntityHandle
  */
 LUMA_API void AnimationController_SetTrigger(LumaSceneHandle scene, LumaEntityHandle entity, const char* name);
 
+/**
+ * @brief 获取动画控制器参数的标识，供脚本缓存后按标识设置参数。
+ * @param[in] scene 场景句柄。
+ * @param[in] entity 实体句柄。
+ * @param[in] name 参数的名称。
+ * @return 参数标识，不存在时返回 -1。
+ */
+LUMA_API int AnimationController_GetParameterId(LumaSceneHandle scene, LumaEntityHandle entity, const char* name);
+
+/**
+ * @brief 按标识设置动画控制器中的浮点参数。
+ * @param[in] scene 场景句柄。
+ * @param[in] entity 实体句柄。
+ * @param[in] id 参数标识。
+ * @param[in] value 要设置的浮点值。
+ */
+LUMA_API void AnimationController_SetFloatById(LumaSceneHandle scene, LumaEntityHandle entity, int id, float value);
+
+/**
+ * @brief 按标识设置动画控制器中的布尔参数。
+ * @param[in] scene 场景句柄。
+ * @param[in] entity 实体句柄。
+ * @param[in] id 参数标识。
+ * @param[in] value 要设置的布尔值。
+ */
+LUMA_API void AnimationController_SetBoolById(LumaSceneHandle scene, LumaEntityHandle entity, int id, bool value);
+
+/**
+ * @brief 按标识设置动画控制器中的整数参数。
+ * @param[in] scene 场景句柄。
+ * @param[in] entity 实体句柄。
+ * @param[in] id 参数标识。
+ * @param[in] value 要设置的整数值。
+ */
+LUMA_API void AnimationController_SetIntById(LumaSceneHandle scene, LumaEntityHandle entity, int id, int value);
+
+/**
+ * @brief 按标识设置动画控制器中的触发器。
+ * @param[in] scene 场景句柄。
+ * @param[in] entity 实体句柄。
+ * @param[in] id 触发器标识。
+ */
+LUMA_API void AnimationController_SetTriggerById(LumaSceneHandle scene, LumaEntityHandle entity, int id);
+
 /**
  * @brief 设置动画控制器的帧率。
  * @param[in] scene 场景句柄。
@@ -2759,6 +2803,16 @@ LUMA_API void NavAgent_SetDestination(LumaSceneHandle scene, LumaEntityHandle en
 LUMA_API void NavAgent_GetDestination(LumaSceneHandle scene, LumaEntityHandle entity, float* outX, float* outY);
 LUMA_API void NavAgent_SetSpeed(LumaSceneHandle scene, LumaEntityHandle entity, float speed);
 LUMA_API float NavAgent_GetSpeed(LumaSceneHandle scene, LumaEntityHandle entity);
+LUMA_API void NavAgent_SetPathPriority(LumaSceneHandle scene, LumaEntityHandle entity, int priority);
+LUMA_API int NavAgent_GetPathPriority(LumaSceneHandle scene, LumaEntityHandle entity);
+LUMA_API void NavAgent_SetPathSmoothing(LumaSceneHandle scene, LumaEntityHandle entity, bool enabled,
+                                        float cornerRadius);
+LUMA_API bool NavAgent_IsPathSmoothingEnabled(LumaSceneHandle scene, LumaEntityHandle entity);
+LUMA_API float NavAgent_GetCornerRadius(LumaSceneHandle scene, LumaEntityHandle entity);
+LUMA_API void NavAgent_SetAvoidance(LumaSceneHandle scene, LumaEntityHandle entity, bool enabled, float radius,
+                                    float maxSpeed, int maxNeighbors);
+LUMA_API bool NavAgent_IsAvoidanceEnabled(LumaSceneHandle scene, LumaEntityHandle entity);
+LUMA_API void NavAgent_GetVelocity(LumaSceneHandle scene, LumaEntityHandle entity, float* outX, float* outY);
 LUMA_API bool NavAgent_HasArrived(LumaSceneHandle scene, LumaEntityHandle entity);
 LUMA_API void NavAgent_Stop(LumaSceneHandle scene, LumaEntityHandle entity);
 
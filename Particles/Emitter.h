@@ -1,6 +1,9 @@
 #ifndef PARTICLE_EMITTER_H
 #define PARTICLE_EMITTER_H
 #include "../Data/ParticleData.h"
+#include "ParticleRandom.h"
+#include <algorithm>
+#include <cmath>
 #include <random>
 #include <functional>
 #include <glm/gtc/constants.hpp>
@@ -35,14 +38,16 @@ namespace Particles
         float inheritVelocityMultiplier = 0.0f;  
         uint32_t maxParticles = 1000;
         bool emitFromEdge = false;         
+        uint32_t randomSeed = 0;           // 0 表示每次运行使用不同的随机种子
     };
     class Emitter
     {
     public:
-        explicit Emitter(const EmitterConfig& config = {})
+        explicit Emitter(const EmitterConfig& config = {}, uint64_t emitterId = 0)
             : m_config(config)
-            , m_rng(std::random_device{}())
+            , m_emitterId(emitterId)
         {
+            Reseed();
         }
         void Update(ParticlePool& pool, float deltaTime, 
                    const glm::vec3& worldPosition = glm::vec3(0.0f),
@@ -56,11 +61,11 @@ namespace Particles
             if (m_config.emissionRate > 0.0f)
             {
                 m_emissionAccumulator += m_config.emissionRate * deltaTime;
-                while (m_emissionAccumulator >= 1.0f && 
-                       pool.Size() < m_config.maxParticles)
+                if (m_emissionAccumulator >= 1.0f)
                 {
-                    EmitParticle(pool);
-                    m_emissionAccumulator -= 1.0f;
+                    const float whole = std::floor(m_emissionAccumulator);
+                    m_emissionAccumulator -= whole;
+                    EmitBatch(pool, static_cast<uint32_t>(whole));
                 }
             }
             if (m_config.burstCount > 0 && m_config.burstInterval > 0.0f)
@@ -75,254 +80,424 @@ namespace Particles
         }
         void Burst(ParticlePool& pool, uint32_t count)
         {
-            for (uint32_t i = 0; i < count && pool.Size() < m_config.maxParticles; ++i)
-            {
-                EmitParticle(pool);
-            }
+            EmitBatch(pool, count);
         }
         void EmitParticle(ParticlePool& pool)
+        {
+            EmitBatch(pool, 1);
+        }
+        /**
+         * @brief 批量发射粒子。
+         *
+         * 先为整批粒子一次性生成随机数组，再按形状批量采样位置与方向，最后直接写入粒子流。
+         * 超出 maxParticles 的部分被丢弃。
+         */
+        void EmitBatch(ParticlePool& pool, uint32_t requested)
         {
             if (pool.Size() >= m_config.maxParticles) return;
-            ParticleData& p = pool.Emit();
-            SpawnResult spawn = GetSpawnPositionAndDirection();
-            p.position = m_emitterPosition + spawn.position;
-            float speed = RandomRange(m_config.speed);
-            p.velocity = spawn.direction * speed;
-            if (m_config.inheritVelocityMultiplier > 0.0f)
-            {
-                p.velocity += m_emitterVelocity * m_config.inheritVelocityMultiplier;
-            }
-            p.lifetime = RandomRange(m_config.lifetime);
-            p.age = 0.0f;
-            if (m_config.alignToDirection && glm::length(spawn.direction) > 0.001f)
+            const size_t count = std::min<size_t>(requested, m_config.maxParticles - pool.Size());
+            if (count == 0) return;
+            m_batch.Resize(count);
+            SampleShape(count);
+            if (m_config.randomizeDirection > 0.0f)
             {
-                p.rotation = std::atan2(spawn.direction.y, spawn.direction.x);
+                PerturbDirections(count, m_config.randomizeDirection);
             }
-            else
+            if (m_config.directionRandomness > 0.0f)
             {
-                p.rotation = RandomRange(m_config.rotation);
+                PerturbDirections(count, m_config.directionRandomness);
             }
-            p.angularVelocity = RandomRange(m_config.angularVelocity);
-            p.startSize = RandomRange(m_config.size) * m_emitterScale;
-            p.endSize = RandomRange(m_config.endSize) * m_emitterScale;
-            p.size = p.startSize;
-            p.startColor = RandomRange(m_config.startColor);
-            p.endColor = RandomRange(m_config.endColor);
-            p.color = p.startColor;
-            p.mass = RandomRange(m_config.mass);
-            p.drag = RandomRange(m_config.drag);
+            const size_t first = pool.EmitBatch(count);
+            WriteParticles(pool.GetStreams(), first, count);
             if (m_onParticleSpawn)
             {
-                m_onParticleSpawn(p);
+                for (size_t i = first; i < first + count; ++i)
+                {
+                    ParticleData p = pool.Get(i);
+                    m_onParticleSpawn(p);
+                    pool.Set(i, p);
+                }
             }
         }
         EmitterConfig& GetConfig() { return m_config; }
         const EmitterConfig& GetConfig() const { return m_config; }
-        void SetConfig(const EmitterConfig& config) { m_config = config; }
+        void SetConfig(const EmitterConfig& config)
+        {
+            const bool reseed = config.randomSeed != m_config.randomSeed;
+            m_config = config;
+            if (reseed) Reseed();
+        }
+        /**
+         * @brief 设置发射器 ID。固定种子下，相同的种子与 ID 产生相同的发射序列。
+         */
+        void SetEmitterId(uint64_t emitterId)
+        {
+            if (emitterId == m_emitterId) return;
+            m_emitterId = emitterId;
+            Reseed();
+        }
+        uint64_t GetEmitterId() const { return m_emitterId; }
         void SetEnabled(bool enabled) { m_enabled = enabled; }
         bool IsEnabled() const { return m_enabled; }
         void Reset()
         {
             m_emissionAccumulator = 0.0f;
             m_burstTimer = 0.0f;
+            if (m_config.randomSeed != 0)
+            {
+                m_rng.SetCounter(0);
+            }
+        }
+        /**
+         * @brief 跳过 seconds 秒而不发射粒子。
+         *
+         * 清空发射累积量；爆发计时器与随机计数器按跳过的时间推进，而不是回到起点，
+         * 固定种子的发射器跳过后从新的位置继续随机序列，不会重放开头。相同的状态与时长得到相同的结果。
+         */
+        void SkipTime(float seconds)
+        {
+            if (seconds <= 0.0f) return;
+            m_emissionAccumulator = 0.0f;
+            double skipped = static_cast<double>(m_config.emissionRate) * seconds;
+            if (m_config.burstCount > 0 && m_config.burstInterval > 0.0f)
+            {
+                const float total = m_burstTimer + seconds;
+                skipped += std::floor(total / m_config.burstInterval) * static_cast<double>(m_config.burstCount);
+                m_burstTimer = std::fmod(total, m_config.burstInterval);
+            }
+            // 按跳过期间本应发射的粒子数推进计数器，每个粒子按最多消耗的均匀随机数计
+            const double counters = std::ceil(skipped * MaxUniformsPerParticle / PhiloxRandom::BlockSize);
+            m_rng.SetCounter(m_rng.GetCounter() + static_cast<uint64_t>(counters));
         }
         void SetOnParticleSpawn(std::function<void(ParticleData&)> callback)
         {
             m_onParticleSpawn = std::move(callback);
         }
     private:
-        struct SpawnResult
+        /// 发射一个粒子最多消耗的均匀随机数：形状 3 个、两次方向扰动各 3 个、其余属性 10 个。
+        static constexpr double MaxUniformsPerParticle = 19.0;
+        /**
+         * @brief 一批发射的临时数据，按属性分数组存放。
+         */
+        struct SpawnBatch
         {
-            glm::vec3 position;
-            glm::vec3 direction;
+            std::vector<float> posX, posY, posZ;
+            std::vector<float> dirX, dirY, dirZ;
+            std::vector<float> u0, u1, u2;
+            void Resize(size_t count)
+            {
+                for (auto* v : {&posX, &posY, &posZ, &dirX, &dirY, &dirZ, &u0, &u1, &u2})
+                {
+                    v->resize(count);
+                }
+            }
         };
-        SpawnResult GetSpawnPositionAndDirection()
+        void Reseed()
         {
-            SpawnResult result;
-            result.position = glm::vec3(0.0f);
-            result.direction = glm::vec3(0.0f, -1.0f, 0.0f); 
-            bool fromShell = (m_config.emitFrom == ShapeEmitFrom::Shell) || m_config.emitFromEdge;
+            uint64_t seed = m_config.randomSeed;
+            if (seed == 0)
+            {
+                std::random_device device;
+                seed = (static_cast<uint64_t>(device()) << 32) | device();
+            }
+            m_rng.Seed(seed, m_emitterId);
+        }
+        void FillConstantDirection(size_t count, const glm::vec3& direction)
+        {
+            std::fill_n(m_batch.dirX.begin(), count, direction.x);
+            std::fill_n(m_batch.dirY.begin(), count, direction.y);
+            std::fill_n(m_batch.dirZ.begin(), count, direction.z);
+        }
+        /**
+         * @brief dir = mix(base, dir, t)，逐分量与 glm::mix 一致。
+         */
+        void MixDirections(size_t count, const glm::vec3& base, float t)
+        {
+            auto& b = m_batch;
+            for (size_t i = 0; i < count; ++i)
+            {
+                b.dirX[i] = base.x * (1.0f - t) + b.dirX[i] * t;
+                b.dirY[i] = base.y * (1.0f - t) + b.dirY[i] * t;
+                b.dirZ[i] = base.z * (1.0f - t) + b.dirZ[i] * t;
+            }
+        }
+        void SampleShape(size_t count)
+        {
+            auto& b = m_batch;
+            const bool fromShell = (m_config.emitFrom == ShapeEmitFrom::Shell) || m_config.emitFromEdge;
+            const glm::vec3 baseDirection = glm::normalize(m_config.direction);
+            const glm::vec3 size = m_config.shapeSize;
+            std::fill_n(b.posX.begin(), count, 0.0f);
+            std::fill_n(b.posY.begin(), count, 0.0f);
+            std::fill_n(b.posZ.begin(), count, 0.0f);
             switch (m_config.shape)
             {
-                case EmitterShape::Point:
-                {
-                    result.position = glm::vec3(0.0f);
-                    result.direction = glm::normalize(m_config.direction);
-                    break;
-                }
                 case EmitterShape::Circle:
                 {
-                    float angle = RandomFloat() * glm::two_pi<float>();
-                    float radius = fromShell ? 
-                                   m_config.shapeSize.x : 
-                                   std::sqrt(RandomFloat()) * m_config.shapeSize.x;
-                    float cosA = std::cos(angle);
-                    float sinA = std::sin(angle);
-                    result.position = glm::vec3(cosA * radius, sinA * radius, 0.0f);
-                    glm::vec3 radialDir = radius > 0.001f ? 
-                        glm::normalize(glm::vec3(cosA, sinA, 0.0f)) : 
-                        glm::vec3(0.0f, -1.0f, 0.0f);
-                    result.direction = glm::mix(
-                        glm::normalize(m_config.direction),
-                        radialDir,
-                        m_config.spherizeDirection
-                    );
+                    m_rng.FillUniform(b.u0.data(), count);
+                    if (!fromShell) m_rng.FillUniform(b.u1.data(), count);
+                    for (size_t i = 0; i < count; ++i)
+                    {
+                        const float angle = b.u0[i] * glm::two_pi<float>();
+                        const float radius = fromShell ? size.x : std::sqrt(b.u1[i]) * size.x;
+                        const float cosA = std::cos(angle);
+                        const float sinA = std::sin(angle);
+                        b.posX[i] = cosA * radius;
+                        b.posY[i] = sinA * radius;
+                        // (cosA, sinA) 已是单位向量
+                        b.dirX[i] = radius > 0.001f ? cosA : 0.0f;
+                        b.dirY[i] = radius > 0.001f ? sinA : -1.0f;
+                        b.dirZ[i] = 0.0f;
+                    }
+                    MixDirections(count, baseDirection, m_config.spherizeDirection);
                     break;
                 }
                 case EmitterShape::Sphere:
                 case EmitterShape::Hemisphere:
                 {
-                    float u = RandomFloat();
-                    float v = RandomFloat();
-                    float theta = u * glm::two_pi<float>();
-                    float phi = (m_config.shape == EmitterShape::Hemisphere) ?
-                        std::acos(v) : 
-                        std::acos(2.0f * v - 1.0f); 
-                    float radius = fromShell ? 
-                                   m_config.shapeSize.x : 
-                                   std::cbrt(RandomFloat()) * m_config.shapeSize.x;
-                    glm::vec3 sphereDir(
-                        std::sin(phi) * std::cos(theta),
-                        std::sin(phi) * std::sin(theta),
-                        std::cos(phi)
-                    );
-                    result.position = sphereDir * radius;
-                    result.direction = glm::mix(
-                        glm::normalize(m_config.direction),
-                        sphereDir,
-                        m_config.spherizeDirection > 0.0f ? m_config.spherizeDirection : 1.0f
-                    );
+                    const bool hemisphere = m_config.shape == EmitterShape::Hemisphere;
+                    m_rng.FillUniform(b.u0.data(), count);
+                    m_rng.FillUniform(b.u1.data(), count);
+                    if (!fromShell) m_rng.FillUniform(b.u2.data(), count);
+                    for (size_t i = 0; i < count; ++i)
+                    {
+                        const float theta = b.u0[i] * glm::two_pi<float>();
+                        const float phi = hemisphere ? std::acos(b.u1[i]) : std::acos(2.0f * b.u1[i] - 1.0f);
+                        const float radius = fromShell ? size.x : std::cbrt(b.u2[i]) * size.x;
+                        b.dirX[i] = std::sin(phi) * std::cos(theta);
+                        b.dirY[i] = std::sin(phi) * std::sin(theta);
+                        b.dirZ[i] = std::cos(phi);
+                        b.posX[i] = b.dirX[i] * radius;
+                        b.posY[i] = b.dirY[i] * radius;
+                        b.posZ[i] = b.dirZ[i] * radius;
+                    }
+                    MixDirections(count, baseDirection,
+                                  m_config.spherizeDirection > 0.0f ? m_config.spherizeDirection : 1.0f);
                     break;
                 }
                 case EmitterShape::Box:
                 case EmitterShape::Rectangle:
                 {
-                    glm::vec3 pos;
-                    glm::vec3 normal(0.0f, -1.0f, 0.0f);
-                    if (m_config.shape == EmitterShape::Rectangle || m_config.shapeSize.z < 0.001f)
+                    FillConstantDirection(count, glm::vec3(0.0f, -1.0f, 0.0f));
+                    m_rng.FillUniform(b.u0.data(), count);
+                    m_rng.FillUniform(b.u1.data(), count);
+                    if (m_config.shape == EmitterShape::Rectangle || size.z < 0.001f)
                     {
-                        pos = glm::vec3(
-                            (RandomFloat() - 0.5f) * m_config.shapeSize.x,
-                            (RandomFloat() - 0.5f) * m_config.shapeSize.y,
-                            0.0f
-                        );
-                        normal = glm::vec3(0.0f, -1.0f, 0.0f);
+                        for (size_t i = 0; i < count; ++i)
+                        {
+                            b.posX[i] = (b.u0[i] - 0.5f) * size.x;
+                            b.posY[i] = (b.u1[i] - 0.5f) * size.y;
+                        }
                     }
                     else if (fromShell)
                     {
-                        int face = static_cast<int>(RandomFloat() * 6);
-                        switch (face)
+                        m_rng.FillUniform(b.u2.data(), count);
+                        for (size_t i = 0; i < count; ++i)
                         {
-                            case 0: pos = {-0.5f, RandomFloat() - 0.5f, RandomFloat() - 0.5f}; normal = {-1,0,0}; break;
-                            case 1: pos = {0.5f, RandomFloat() - 0.5f, RandomFloat() - 0.5f}; normal = {1,0,0}; break;
-                            case 2: pos = {RandomFloat() - 0.5f, -0.5f, RandomFloat() - 0.5f}; normal = {0,-1,0}; break;
-                            case 3: pos = {RandomFloat() - 0.5f, 0.5f, RandomFloat() - 0.5f}; normal = {0,1,0}; break;
-                            case 4: pos = {RandomFloat() - 0.5f, RandomFloat() - 0.5f, -0.5f}; normal = {0,0,-1}; break;
-                            case 5: pos = {RandomFloat() - 0.5f, RandomFloat() - 0.5f, 0.5f}; normal = {0,0,1}; break;
-                            default: break;
+                            // u0 选面，u1/u2 为面内坐标
+                            const int face = std::min(static_cast<int>(b.u0[i] * 6.0f), 5);
+                            const int axis = face >> 1;
+                            const float side = (face & 1) ? 0.5f : -0.5f;
+                            float local[3];
+                            local[axis] = side;
+                            local[(axis + 1) % 3] = b.u1[i] - 0.5f;
+                            local[(axis + 2) % 3] = b.u2[i] - 0.5f;
+                            float normal[3] = {0.0f, 0.0f, 0.0f};
+                            normal[axis] = (face & 1) ? 1.0f : -1.0f;
+                            b.posX[i] = local[0] * size.x;
+                            b.posY[i] = local[1] * size.y;
+                            b.posZ[i] = local[2] * size.z;
+                            b.dirX[i] = normal[0];
+                            b.dirY[i] = normal[1];
+                            b.dirZ[i] = normal[2];
                         }
-                        pos *= m_config.shapeSize;
                     }
                     else
                     {
-                        pos = glm::vec3(
-                            (RandomFloat() - 0.5f) * m_config.shapeSize.x,
-                            (RandomFloat() - 0.5f) * m_config.shapeSize.y,
-                            (RandomFloat() - 0.5f) * m_config.shapeSize.z
-                        );
+                        m_rng.FillUniform(b.u2.data(), count);
+                        for (size_t i = 0; i < count; ++i)
+                        {
+                            b.posX[i] = (b.u0[i] - 0.5f) * size.x;
+                            b.posY[i] = (b.u1[i] - 0.5f) * size.y;
+                            b.posZ[i] = (b.u2[i] - 0.5f) * size.z;
+                        }
                     }
-                    result.position = pos;
-                    result.direction = glm::mix(
-                        glm::normalize(m_config.direction),
-                        normal,
-                        m_config.spherizeDirection
-                    );
+                    MixDirections(count, baseDirection, m_config.spherizeDirection);
                     break;
                 }
                 case EmitterShape::Cone:
                 {
-                    float angle = RandomFloat() * glm::two_pi<float>();
-                    float coneAngleRad = glm::radians(m_config.coneAngle);
-                    float t = fromShell ? 1.0f : RandomFloat(); 
-                    float currentRadius = t * m_config.coneRadius;
-                    float cosA = std::cos(angle);
-                    float sinA = std::sin(angle);
-                    result.position = glm::vec3(
-                        cosA * currentRadius,
-                        t * m_config.coneLength,  
-                        sinA * currentRadius
-                    );
-                    glm::vec3 outward(cosA, 0.0f, sinA);
-                    glm::vec3 forward(0.0f, 1.0f, 0.0f);
-                    float outwardAmount = std::sin(coneAngleRad);
-                    float forwardAmount = std::cos(coneAngleRad);
-                    result.direction = glm::normalize(outward * outwardAmount + forward * forwardAmount);
+                    m_rng.FillUniform(b.u0.data(), count);
+                    if (!fromShell) m_rng.FillUniform(b.u1.data(), count);
+                    const float coneAngleRad = glm::radians(m_config.coneAngle);
+                    const float outwardAmount = std::sin(coneAngleRad);
+                    const float forwardAmount = std::cos(coneAngleRad);
+                    for (size_t i = 0; i < count; ++i)
+                    {
+                        const float angle = b.u0[i] * glm::two_pi<float>();
+                        const float t = fromShell ? 1.0f : b.u1[i];
+                        const float currentRadius = t * m_config.coneRadius;
+                        const float cosA = std::cos(angle);
+                        const float sinA = std::sin(angle);
+                        b.posX[i] = cosA * currentRadius;
+                        b.posY[i] = t * m_config.coneLength;
+                        b.posZ[i] = sinA * currentRadius;
+                        // outward * sin + forward * cos 的长度恒为 1，无需再归一化
+                        b.dirX[i] = cosA * outwardAmount;
+                        b.dirY[i] = forwardAmount;
+                        b.dirZ[i] = sinA * outwardAmount;
+                    }
                     break;
                 }
                 case EmitterShape::Edge:
                 {
-                    float t = RandomFloat();
-                    result.position = glm::vec3(
-                        (t - 0.5f) * m_config.shapeSize.x,
-                        0.0f,
-                        0.0f
-                    );
-                    result.direction = glm::normalize(m_config.direction);
+                    m_rng.FillUniform(b.u0.data(), count);
+                    for (size_t i = 0; i < count; ++i)
+                    {
+                        b.posX[i] = (b.u0[i] - 0.5f) * size.x;
+                    }
+                    FillConstantDirection(count, baseDirection);
                     break;
                 }
+                case EmitterShape::Point:
                 default:
-                    result.direction = glm::normalize(m_config.direction);
+                    FillConstantDirection(count, baseDirection);
                     break;
             }
-            if (m_config.randomizeDirection > 0.0f)
+            for (size_t i = 0; i < count; ++i)
             {
-                glm::vec3 randomDir = glm::normalize(glm::vec3(
-                    RandomFloat() * 2.0f - 1.0f,
-                    RandomFloat() * 2.0f - 1.0f,
-                    RandomFloat() * 2.0f - 1.0f
-                ));
-                result.direction = glm::normalize(glm::mix(
-                    result.direction,
-                    randomDir,
-                    m_config.randomizeDirection
-                ));
+                b.posX[i] *= m_emitterScale.x;
+                b.posY[i] *= m_emitterScale.y;
             }
-            if (m_config.directionRandomness > 0.0f)
-            {
-                glm::vec3 randomDir = glm::normalize(glm::vec3(
-                    RandomFloat() * 2.0f - 1.0f,
-                    RandomFloat() * 2.0f - 1.0f,
-                    RandomFloat() * 2.0f - 1.0f
-                ));
-                result.direction = glm::normalize(glm::mix(
-                    result.direction,
-                    randomDir,
-                    m_config.directionRandomness
-                ));
-            }
-            result.position.x *= m_emitterScale.x;
-            result.position.y *= m_emitterScale.y;
-            return result;
-        }
-        float RandomFloat()
-        {
-            return m_distribution(m_rng);
         }
-        float RandomRange(const FloatRange& range)
+        /**
+         * @brief dir = normalize(mix(dir, randomUnit, amount))，随机方向取自 [-1, 1]^3 后归一化。
+         */
+        void PerturbDirections(size_t count, float amount)
         {
-            return range.Lerp(RandomFloat());
+            auto& b = m_batch;
+            m_rng.FillUniform(b.u0.data(), count);
+            m_rng.FillUniform(b.u1.data(), count);
+            m_rng.FillUniform(b.u2.data(), count);
+            for (size_t i = 0; i < count; ++i)
+            {
+                glm::vec3 random(b.u0[i] * 2.0f - 1.0f, b.u1[i] * 2.0f - 1.0f, b.u2[i] * 2.0f - 1.0f);
+                const float randomLength = glm::length(random);
+                random = randomLength > 1e-6f ? random / randomLength : glm::vec3(0.0f, 1.0f, 0.0f);
+                glm::vec3 dir = glm::mix(glm::vec3(b.dirX[i], b.dirY[i], b.dirZ[i]), random, amount);
+                const float length = glm::length(dir);
+                dir = length > 1e-6f ? dir / length : random;
+                b.dirX[i] = dir.x;
+                b.dirY[i] = dir.y;
+                b.dirZ[i] = dir.z;
+            }
         }
-        glm::vec2 RandomRange(const Vec2Range& range)
+        /**
+         * @brief 用 [min, max] 区间内的均匀随机值填充一条流。
+         */
+        void FillRange(float* out, size_t count, float minValue, float maxValue)
         {
-            return range.Lerp(RandomFloat());
+            if (minValue == maxValue)
+            {
+                std::fill_n(out, count, minValue);
+                return;
+            }
+            m_rng.FillUniform(out, count);
+            const float span = maxValue - minValue;
+            for (size_t i = 0; i < count; ++i)
+            {
+                out[i] = minValue + span * out[i];
+            }
         }
-        glm::vec3 RandomRange(const Vec3Range& range)
+        /**
+         * @brief 把共享同一个插值参数的向量区间写入多条流。
+         */
+        template<size_t N>
+        void FillVectorRange(float* const (&outs)[N], size_t count, const float* minValues, const float* maxValues)
         {
-            return range.Lerp(RandomFloat());
+            float* t = m_batch.u0.data();
+            m_rng.FillUniform(t, count);
+            for (size_t c = 0; c < N; ++c)
+            {
+                const float minValue = minValues[c];
+                const float span = maxValues[c] - minValue;
+                for (size_t i = 0; i < count; ++i)
+                {
+                    outs[c][i] = minValue * (1.0f - t[i]) + (minValue + span) * t[i];
+                }
+            }
         }
-        glm::vec4 RandomRange(const ColorRange& range)
+        void WriteParticles(ParticleStreams& s, size_t first, size_t count)
         {
-            return range.Lerp(RandomFloat());
+            auto& b = m_batch;
+            const glm::vec3 inherited = m_config.inheritVelocityMultiplier > 0.0f
+                                            ? m_emitterVelocity * m_config.inheritVelocityMultiplier
+                                            : glm::vec3(0.0f);
+            float* speed = b.u1.data();
+            FillRange(speed, count, m_config.speed.min, m_config.speed.max);
+            for (size_t i = 0; i < count; ++i)
+            {
+                s.positionX[first + i] = m_emitterPosition.x + b.posX[i];
+                s.positionY[first + i] = m_emitterPosition.y + b.posY[i];
+                s.velocityX[first + i] = b.dirX[i] * speed[i] + inherited.x;
+                s.velocityY[first + i] = b.dirY[i] * speed[i] + inherited.y;
+            }
+            FillRange(s.lifetime.data() + first, count, m_config.lifetime.min, m_config.lifetime.max);
+            std::fill_n(s.age.begin() + first, count, 0.0f);
+            FillRange(s.rotation.data() + first, count, m_config.rotation.min, m_config.rotation.max);
+            if (m_config.alignToDirection)
+            {
+                for (size_t i = 0; i < count; ++i)
+                {
+                    const float dx = b.dirX[i], dy = b.dirY[i], dz = b.dirZ[i];
+                    if (dx * dx + dy * dy + dz * dz > 0.001f * 0.001f)
+                    {
+                        s.rotation[first + i] = std::atan2(dy, dx);
+                    }
+                }
+            }
+            FillRange(s.angularVelocity.data() + first, count, m_config.angularVelocity.min,
+                      m_config.angularVelocity.max);
+            {
+                float* const outs[2] = {s.startSizeX.data() + first, s.startSizeY.data() + first};
+                const float lo[2] = {m_config.size.min.x * m_emitterScale.x, m_config.size.min.y * m_emitterScale.y};
+                const float hi[2] = {m_config.size.max.x * m_emitterScale.x, m_config.size.max.y * m_emitterScale.y};
+                FillVectorRange(outs, count, lo, hi);
+            }
+            {
+                float* const outs[2] = {s.endSizeX.data() + first, s.endSizeY.data() + first};
+                const float lo[2] = {m_config.endSize.min.x * m_emitterScale.x,
+                                     m_config.endSize.min.y * m_emitterScale.y};
+                const float hi[2] = {m_config.endSize.max.x * m_emitterScale.x,
+                                     m_config.endSize.max.y * m_emitterScale.y};
+                FillVectorRange(outs, count, lo, hi);
+            }
+            std::copy_n(s.startSizeX.begin() + first, count, s.sizeX.begin() + first);
+            std::copy_n(s.startSizeY.begin() + first, count, s.sizeY.begin() + first);
+            {
+                float* const outs[4] = {s.startColorR.data() + first, s.startColorG.data() + first,
+                                        s.startColorB.data() + first, s.startColorA.data() + first};
+                const glm::vec4& lo = m_config.startColor.min;
+                const glm::vec4& hi = m_config.startColor.max;
+                const float los[4] = {lo.r, lo.g, lo.b, lo.a};
+                const float his[4] = {hi.r, hi.g, hi.b, hi.a};
+                FillVectorRange(outs, count, los, his);
+            }
+            {
+                float* const outs[4] = {s.endColorR.data() + first, s.endColorG.data() + first,
+                                        s.endColorB.data() + first, s.endColorA.data() + first};
+                const glm::vec4& lo = m_config.endColor.min;
+                const glm::vec4& hi = m_config.endColor.max;
+                const float los[4] = {lo.r, lo.g, lo.b, lo.a};
+                const float his[4] = {hi.r, hi.g, hi.b, hi.a};
+                FillVectorRange(outs, count, los, his);
+            }
+            std::copy_n(s.startColorR.begin() + first, count, s.colorR.begin() + first);
+            std::copy_n(s.startColorG.begin() + first, count, s.colorG.begin() + first);
+            std::copy_n(s.startColorB.begin() + first, count, s.colorB.begin() + first);
+            std::copy_n(s.startColorA.begin() + first, count, s.colorA.begin() + first);
+            FillRange(s.mass.data() + first, count, m_config.mass.min, m_config.mass.max);
+            FillRange(s.drag.data() + first, count, m_config.drag.min, m_config.drag.max);
         }
     private:
         EmitterConfig m_config;
@@ -332,8 +507,9 @@ namespace Particles
         glm::vec3 m_emitterPosition{0.0f};
         glm::vec3 m_emitterVelocity{0.0f};
         glm::vec2 m_emitterScale{1.0f};
-        std::mt19937 m_rng;
-        std::uniform_real_distribution<float> m_distribution{0.0f, 1.0f};
+        uint64_t m_emitterId = 0;
+        PhiloxRandom m_rng;
+        SpawnBatch m_batch;
         std::function<void(ParticleData&)> m_onParticleSpawn;
     };
 } 
@@ -0,0 +1,183 @@
+#ifndef PARTICLE_CULLING_H
+#define PARTICLE_CULLING_H
+#include "../Data/ParticleData.h"
+#include "Emitter.h"
+#include "Affector.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+namespace Particles
+{
+    /**
+     * @brief 发射器的模拟细节级别。
+     */
+    enum class SimulationLod : uint8_t
+    {
+        Full,     ///< 在视口内，每帧模拟。
+        Reduced,  ///< 在视口外但靠近视口，隔帧以双倍步长模拟。
+        Sleeping  ///< 远离视口或被预算裁掉，不模拟，重新唤醒时快进。
+    };
+    /**
+     * @brief 世界空间轴对齐包围盒。
+     */
+    struct ParticleBounds
+    {
+        glm::vec2 min{std::numeric_limits<float>::max()};
+        glm::vec2 max{std::numeric_limits<float>::lowest()};
+        [[nodiscard]] bool IsValid() const { return min.x <= max.x && min.y <= max.y; }
+        [[nodiscard]] bool Intersects(const ParticleBounds& other) const
+        {
+            return IsValid() && other.IsValid() &&
+                   min.x <= other.max.x && max.x >= other.min.x &&
+                   min.y <= other.max.y && max.y >= other.min.y;
+        }
+        [[nodiscard]] ParticleBounds Expanded(float margin) const
+        {
+            return {min - glm::vec2(margin), max + glm::vec2(margin)};
+        }
+        void Merge(const ParticleBounds& other)
+        {
+            if (!other.IsValid()) return;
+            min = glm::min(min, other.min);
+            max = glm::max(max, other.max);
+        }
+    };
+    /**
+     * @brief 根据发射器配置计算保守的世界包围盒。
+     *
+     * 包围盒覆盖形状范围、最大速度与最大寿命下的位移、恒定加速度带来的位移以及粒子尺寸，
+     * 只要发射器不移动，新发射的粒子就不会越过它。
+     * @param config 发射器配置。
+     * @param worldPosition 发射器世界位置。
+     * @param scale 发射器缩放。
+     * @param acceleration 作用于粒子的恒定加速度（如重力）。
+     */
+    inline ParticleBounds ComputeEmitterBounds(const EmitterConfig& config, const glm::vec2& worldPosition,
+                                               const glm::vec2& scale, const glm::vec2& acceleration)
+    {
+        const float maxLifetime = std::max(config.lifetime.min, config.lifetime.max);
+        const float maxSpeed = std::max(std::abs(config.speed.min), std::abs(config.speed.max));
+        glm::vec2 shapeExtent(std::max(config.shapeSize.x, config.shapeSize.y));
+        if (config.shape == EmitterShape::Cone)
+        {
+            shapeExtent = glm::vec2(std::max(config.coneRadius, config.coneLength));
+        }
+        shapeExtent *= glm::vec2(std::abs(scale.x), std::abs(scale.y));
+        const float maxSize = std::max({config.size.min.x, config.size.min.y, config.size.max.x, config.size.max.y,
+                                        config.endSize.min.x, config.endSize.min.y,
+                                        config.endSize.max.x, config.endSize.max.y}) *
+                              std::max(std::abs(scale.x), std::abs(scale.y));
+        const float travel = maxSpeed * maxLifetime;
+        const glm::vec2 drift = 0.5f * acceleration * maxLifetime * maxLifetime;
+        ParticleBounds bounds;
+        bounds.min = worldPosition - shapeExtent - glm::vec2(travel + maxSize) + glm::min(drift, glm::vec2(0.0f));
+        bounds.max = worldPosition + shapeExtent + glm::vec2(travel + maxSize) + glm::max(drift, glm::vec2(0.0f));
+        return bounds;
+    }
+    /**
+     * @brief 根据包围盒与视口的关系选择模拟细节级别。
+     * @param bounds 发射器包围盒。
+     * @param view 视口在世界空间的范围。
+     * @param margin 视为可见的额外边距。
+     */
+    inline SimulationLod ClassifyEmitter(const ParticleBounds& bounds, const ParticleBounds& view, float margin)
+    {
+        if (bounds.Intersects(view.Expanded(margin)))
+        {
+            return SimulationLod::Full;
+        }
+        const glm::vec2 viewSize = view.max - view.min;
+        if (bounds.Intersects(view.Expanded(margin + 0.5f * std::max(viewSize.x, viewSize.y))))
+        {
+            return SimulationLod::Reduced;
+        }
+        return SimulationLod::Sleeping;
+    }
+    /**
+     * @brief 粒子预算中的一个发射器请求。
+     */
+    struct ParticleBudgetRequest
+    {
+        size_t index = 0;        ///< 调用方的发射器下标。
+        int importance = 0;      ///< 重要度，越大越优先保留。
+        float distanceSq = 0.0f; ///< 到视口中心的距离平方，同重要度时近者优先。
+        uint32_t cost = 0;       ///< 发射器最多占用的粒子数。
+        bool admitted = false;   ///< 输出：是否在预算内。
+    };
+    /**
+     * @brief 在全局粒子预算内按重要度接纳发射器。
+     *
+     * 按重要度降序、距离升序排序后依次接纳，第一个放不下的发射器及其后的全部发射器被裁掉，
+     * 因此被裁掉的总是最不重要的那一部分。budget 为 0 表示不限制。
+     * @return 被接纳发射器的总开销。
+     */
+    inline size_t ApplyParticleBudget(std::vector<ParticleBudgetRequest>& requests, size_t budget)
+    {
+        std::stable_sort(requests.begin(), requests.end(),
+                         [](const ParticleBudgetRequest& a, const ParticleBudgetRequest& b)
+                         {
+                             if (a.importance != b.importance) return a.importance > b.importance;
+                             return a.distanceSq < b.distanceSq;
+                         });
+        size_t used = 0;
+        bool exhausted = false;
+        for (auto& request : requests)
+        {
+            if (!exhausted && (budget == 0 || used + request.cost <= budget))
+            {
+                request.admitted = true;
+                used += request.cost;
+            }
+            else
+            {
+                request.admitted = false;
+                exhausted = true;
+            }
+        }
+        return used;
+    }
+    /// 快进使用的固定粗步长（秒）。
+    constexpr float FastForwardStep = 1.0f / 20.0f;
+    /**
+     * @brief 以固定粗步长把休眠的发射器快进 elapsed 秒。
+     *
+     * 超过最大寿命的部分不会影响当前可见的粒子，因此快进时长被限制在最大寿命以内：
+     * 休眠时间不少于最大寿命时清空粒子池，发射器跳过窗口之前的时间（爆发计时与随机序列照常推进），
+     * 再从空池模拟一个完整寿命窗口得到稳态。
+     * 步长与步数只由 elapsed 和配置决定，相同输入得到相同的步进序列。
+     * @param emitter 发射器。
+     * @param pool 粒子池。
+     * @param affectors 影响器链。
+     * @param elapsed 休眠的模拟时间。
+     * @param worldPosition 发射器当前的世界位置。
+     * @param scale 发射器缩放。
+     * @param emit 快进期间是否继续发射。
+     */
+    inline void FastForward(Emitter& emitter, ParticlePool& pool, AffectorChain& affectors, float elapsed,
+                            const glm::vec3& worldPosition, const glm::vec2& scale, bool emit)
+    {
+        if (elapsed <= 0.0f) return;
+        const EmitterConfig& config = emitter.GetConfig();
+        const float window = std::max(config.lifetime.min, config.lifetime.max);
+        float remaining = elapsed;
+        if (elapsed >= window)
+        {
+            pool.Clear();
+            emitter.SkipTime(elapsed - window);
+            remaining = window;
+        }
+        const int steps = static_cast<int>(std::ceil(remaining / FastForwardStep));
+        const float dt = steps > 0 ? remaining / static_cast<float>(steps) : 0.0f;
+        for (int i = 0; i < steps; ++i)
+        {
+            if (emit)
+            {
+                emitter.Update(pool, dt, worldPosition, glm::vec3(0.0f), scale);
+            }
+            affectors.UpdateBatch(pool.GetStreams(), dt);
+            pool.RemoveDeadParticles();
+        }
+    }
+}
+#endif
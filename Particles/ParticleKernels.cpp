@@ -0,0 +1,434 @@
+#include "ParticleKernels.h"
+#include "../Utils/SIMDWrapper.h"
+#include <algorithm>
+#include <cmath>
+
+namespace Particles::Kernels
+{
+    namespace
+    {
+        template<typename Fn>
+        void ForEachBlock(size_t count, Fn&& fn)
+        {
+            for (size_t begin = 0; begin < count; begin += BlockSize)
+            {
+                fn(begin, std::min(BlockSize, count - begin));
+            }
+        }
+
+        /**
+         * @brief 计算一个块内的速度大小。
+         */
+        void BlockSpeed(SIMD& simd, const ParticleStreams& s, size_t begin, size_t n, float* speed)
+        {
+            const float* vx = s.velocityX.data() + begin;
+            const float* vy = s.velocityY.data() + begin;
+            simd.VectorMultiply(vy, vy, speed, n);
+            simd.VectorMultiplyAdd(vx, vx, speed, speed, n);
+            simd.VectorSqrt(speed, speed, n);
+        }
+
+        /**
+         * @brief 计算一个块内粒子相对 center 的偏移 (dx, dy) 与距离。
+         */
+        void BlockOffset(SIMD& simd, const ParticleStreams& s, size_t begin, size_t n, const glm::vec2& center,
+                         float* dx, float* dy, float* distance)
+        {
+            simd.VectorScalarAdd(s.positionX.data() + begin, -center.x, dx, n);
+            simd.VectorScalarAdd(s.positionY.data() + begin, -center.y, dy, n);
+            simd.VectorMultiply(dy, dy, distance, n);
+            simd.VectorMultiplyAdd(dx, dx, distance, distance, n);
+            simd.VectorSqrt(distance, distance, n);
+        }
+
+        /**
+         * @brief 径向力场的掩码：距离在 [0.001, radius] 内时 inverse 为 1/距离，weight 为 1 - 距离/radius，
+         * 范围外两者都为 0。用选择代替跳过，整个循环没有分支。
+         */
+        void RadialMask(const float* distance, size_t n, float radius, float* inverse, float* weight)
+        {
+            const float invRadius = 1.0f / radius;
+            for (size_t i = 0; i < n; ++i)
+            {
+                const float d = distance[i];
+                const bool inside = d >= 0.001f && d <= radius;
+                inverse[i] = inside ? 1.0f / std::max(d, 0.001f) : 0.0f;
+                weight[i] = inside ? 1.0f - d * invRadius : 0.0f;
+            }
+        }
+
+        /**
+         * @brief weight 逐元素求 exponent 次幂。0 到 8 的整数次幂用 SIMD 乘法按平方展开，其余交给 std::pow，
+         * 此时权重为 0 的粒子结果为 0。
+         */
+        void BlockPow(SIMD& simd, float* weight, size_t n, float exponent)
+        {
+            if (exponent == std::floor(exponent) && exponent >= 0.0f && exponent <= 8.0f)
+            {
+                float base[BlockSize];
+                std::copy(weight, weight + n, base);
+                std::fill(weight, weight + n, 1.0f);
+                for (auto e = static_cast<uint32_t>(exponent); e != 0; e >>= 1)
+                {
+                    if (e & 1u) simd.VectorMultiply(weight, base, weight, n);
+                    if (e > 1u) simd.VectorMultiply(base, base, base, n);
+                }
+                return;
+            }
+            for (size_t i = 0; i < n; ++i)
+            {
+                // 范围外的权重为 0，负指数时 pow 为无穷大，乘以为 0 的 1/距离会得到 NaN
+                weight[i] = weight[i] > 0.0f ? std::pow(weight[i], exponent) : 0.0f;
+            }
+        }
+
+        /**
+         * @brief 无分支的 sin：按 2π 归约到 [-π, π]，再按 sin(x) = sin(±π - x) 折到 [-π/2, π/2] 后用 11 次多项式，
+         * 误差约 1e-7。std::sin 是库函数调用，写在循环里无法向量化。
+         */
+        inline float PolySin(float x)
+        {
+            constexpr float Pi = 3.14159265358979f;
+            constexpr float HalfPi = 1.57079632679490f;
+            constexpr float InvTwoPi = 0.159154943091895f;
+            x -= 2.0f * Pi * std::floor(x * InvTwoPi + 0.5f);
+            x = x > HalfPi ? Pi - x : (x < -HalfPi ? -Pi - x : x);
+            const float x2 = x * x;
+            return x * (1.0f + x2 * (-1.0f / 6.0f + x2 * (1.0f / 120.0f + x2 * (-1.0f / 5040.0f +
+                   x2 * (1.0f / 362880.0f + x2 * (-1.0f / 39916800.0f))))));
+        }
+    }
+
+    void AdvanceAge(ParticleStreams& s, float deltaTime)
+    {
+        SIMD::GetInstance().VectorScalarAdd(s.age.data(), deltaTime, s.age.data(), s.count);
+    }
+
+    void ApplyAcceleration(ParticleStreams& s, const glm::vec2& acceleration, float deltaTime)
+    {
+        auto& simd = SIMD::GetInstance();
+        simd.VectorScalarAdd(s.velocityX.data(), acceleration.x * deltaTime, s.velocityX.data(), s.count);
+        simd.VectorScalarAdd(s.velocityY.data(), acceleration.y * deltaTime, s.velocityY.data(), s.count);
+    }
+
+    void ApplyQuadraticDrag(ParticleStreams& s, float coefficient, float deltaTime)
+    {
+        auto& simd = SIMD::GetInstance();
+        const float k = coefficient * deltaTime;
+        ForEachBlock(s.count, [&](size_t begin, size_t n)
+        {
+            float factor[BlockSize];
+            BlockSpeed(simd, s, begin, n, factor);
+            // v += -v/|v| * c|v|^2 dt  等价于  v *= 1 - c|v| dt
+            for (size_t i = 0; i < n; ++i)
+            {
+                factor[i] = factor[i] > 0.001f ? 1.0f - k * factor[i] : 1.0f;
+            }
+            simd.VectorMultiply(s.velocityX.data() + begin, factor, s.velocityX.data() + begin, n);
+            simd.VectorMultiply(s.velocityY.data() + begin, factor, s.velocityY.data() + begin, n);
+        });
+    }
+
+    void ScaleVelocity(ParticleStreams& s, float factor)
+    {
+        auto& simd = SIMD::GetInstance();
+        simd.VectorScalarMultiply(s.velocityX.data(), factor, s.velocityX.data(), s.count);
+        simd.VectorScalarMultiply(s.velocityY.data(), factor, s.velocityY.data(), s.count);
+    }
+
+    void ClampSpeed(ParticleStreams& s, float minSpeed, float maxSpeed)
+    {
+        auto& simd = SIMD::GetInstance();
+        ForEachBlock(s.count, [&](size_t begin, size_t n)
+        {
+            float factor[BlockSize];
+            BlockSpeed(simd, s, begin, n, factor);
+            for (size_t i = 0; i < n; ++i)
+            {
+                const float speed = factor[i];
+                float target = speed;
+                if (speed > maxSpeed) target = maxSpeed;
+                else if (speed < minSpeed) target = minSpeed;
+                factor[i] = speed > 0.001f ? target / speed : 1.0f;
+            }
+            simd.VectorMultiply(s.velocityX.data() + begin, factor, s.velocityX.data() + begin, n);
+            simd.VectorMultiply(s.velocityY.data() + begin, factor, s.velocityY.data() + begin, n);
+        });
+    }
+
+    void IntegratePosition(ParticleStreams& s, float deltaTime)
+    {
+        auto& simd = SIMD::GetInstance();
+        simd.VectorScalarMultiplyAdd(s.velocityX.data(), deltaTime, s.positionX.data(), s.positionX.data(), s.count);
+        simd.VectorScalarMultiplyAdd(s.velocityY.data(), deltaTime, s.positionY.data(), s.positionY.data(), s.count);
+    }
+
+    void IntegrateRotation(ParticleStreams& s, float deltaTime)
+    {
+        SIMD::GetInstance().VectorScalarMultiplyAdd(s.angularVelocity.data(), deltaTime, s.rotation.data(),
+                                                    s.rotation.data(), s.count);
+    }
+
+    void Translate(ParticleStreams& s, const glm::vec2& offset)
+    {
+        auto& simd = SIMD::GetInstance();
+        simd.VectorScalarAdd(s.positionX.data(), offset.x, s.positionX.data(), s.count);
+        simd.VectorScalarAdd(s.positionY.data(), offset.y, s.positionY.data(), s.count);
+    }
+
+    void ApplyAttractor(ParticleStreams& s, const glm::vec2& center, float strength, float radius,
+                        float falloff, float deltaTime)
+    {
+        auto& simd = SIMD::GetInstance();
+        ForEachBlock(s.count, [&](size_t begin, size_t n)
+        {
+            float dx[BlockSize], dy[BlockSize], distance[BlockSize], scale[BlockSize], weight[BlockSize];
+            BlockOffset(simd, s, begin, n, center, dx, dy, distance);
+            RadialMask(distance, n, radius, scale, weight);
+            BlockPow(simd, weight, n, falloff);
+            // 偏移是粒子指向中心的反方向，系数取负
+            simd.VectorMultiply(weight, scale, scale, n);
+            simd.VectorScalarMultiply(scale, -strength * deltaTime, scale, n);
+            simd.VectorMultiplyAdd(dx, scale, s.velocityX.data() + begin, s.velocityX.data() + begin, n);
+            simd.VectorMultiplyAdd(dy, scale, s.velocityY.data() + begin, s.velocityY.data() + begin, n);
+        });
+    }
+
+    void ApplyVortex(ParticleStreams& s, const glm::vec2& center, float axisZ, float strength, float radius,
+                     float deltaTime)
+    {
+        auto& simd = SIMD::GetInstance();
+        ForEachBlock(s.count, [&](size_t begin, size_t n)
+        {
+            float dx[BlockSize], dy[BlockSize], distance[BlockSize], scale[BlockSize], weight[BlockSize];
+            BlockOffset(simd, s, begin, n, center, dx, dy, distance);
+            RadialMask(distance, n, radius, scale, weight);
+            simd.VectorMultiply(weight, scale, scale, n);
+            // 平面内 cross(axis, n) 只剩 z 轴分量的贡献：(-az * ny, az * nx)
+            simd.VectorScalarMultiply(scale, axisZ * strength * deltaTime, scale, n);
+            simd.VectorMultiplyAdd(dx, scale, s.velocityY.data() + begin, s.velocityY.data() + begin, n);
+            simd.VectorScalarMultiply(scale, -1.0f, scale, n);
+            simd.VectorMultiplyAdd(dy, scale, s.velocityX.data() + begin, s.velocityX.data() + begin, n);
+        });
+    }
+
+    void ApplyNoiseForce(ParticleStreams& s, float strength, float frequency, float scrollSpeed, float deltaTime)
+    {
+        auto& simd = SIMD::GetInstance();
+        ForEachBlock(s.count, [&](size_t begin, size_t n)
+        {
+            float time[BlockSize], nx[BlockSize], ny[BlockSize], fx[BlockSize], fy[BlockSize];
+            simd.VectorScalarMultiply(s.age.data() + begin, scrollSpeed, time, n);
+            simd.VectorScalarMultiplyAdd(s.positionX.data() + begin, frequency, time, nx, n);
+            simd.VectorScalarMultiplyAdd(s.positionY.data() + begin, frequency, time, ny, n);
+            // 噪声的 z 分量就是 time；cos(x) = sin(x + π/2)
+            constexpr float HalfPi = 1.57079632679490f;
+            for (size_t i = 0; i < n; ++i)
+            {
+                const float t = time[i];
+                fx[i] = PolySin(ny[i] * 2.1f + t * 1.3f) * PolySin(nx[i] * 1.7f + t + HalfPi);
+                fy[i] = PolySin(t * 2.3f + nx[i] * 1.5f) * PolySin(ny[i] * 1.9f + t * 1.1f + HalfPi);
+            }
+            simd.VectorScalarMultiplyAdd(fx, strength * deltaTime, s.velocityX.data() + begin,
+                                         s.velocityX.data() + begin, n);
+            simd.VectorScalarMultiplyAdd(fy, strength * deltaTime, s.velocityY.data() + begin,
+                                         s.velocityY.data() + begin, n);
+        });
+    }
+
+    void NormalizedAge(const ParticleStreams& s, size_t begin, size_t count, float* out)
+    {
+        const float* age = s.age.data() + begin;
+        const float* lifetime = s.lifetime.data() + begin;
+        for (size_t i = 0; i < count; ++i)
+        {
+            out[i] = lifetime[i] > 0.0f ? age[i] / lifetime[i] : 1.0f;
+        }
+    }
+
+    void ColorOverLifetime(ParticleStreams& s)
+    {
+        auto& simd = SIMD::GetInstance();
+        ForEachBlock(s.count, [&](size_t begin, size_t n)
+        {
+            float t[BlockSize];
+            NormalizedAge(s, begin, n, t);
+            simd.VectorLerp(s.startColorR.data() + begin, s.endColorR.data() + begin, t, s.colorR.data() + begin, n);
+            simd.VectorLerp(s.startColorG.data() + begin, s.endColorG.data() + begin, t, s.colorG.data() + begin, n);
+            simd.VectorLerp(s.startColorB.data() + begin, s.endColorB.data() + begin, t, s.colorB.data() + begin, n);
+            simd.VectorLerp(s.startColorA.data() + begin, s.endColorA.data() + begin, t, s.colorA.data() + begin, n);
+        });
+    }
+
+    void GradientColor(ParticleStreams& s, const float* stopPositions, const glm::vec4* stopColors,
+                       size_t stopCount)
+    {
+        if (stopCount == 0) return;
+        ForEachBlock(s.count, [&](size_t begin, size_t n)
+        {
+            float t[BlockSize];
+            NormalizedAge(s, begin, n, t);
+            for (size_t i = 0; i < n; ++i)
+            {
+                size_t stop = 0;
+                while (stop < stopCount - 1 && stopPositions[stop + 1] < t[i])
+                {
+                    ++stop;
+                }
+                glm::vec4 color;
+                if (stop >= stopCount - 1)
+                {
+                    color = stopColors[stopCount - 1];
+                }
+                else
+                {
+                    const float localT = (t[i] - stopPositions[stop]) /
+                                         (stopPositions[stop + 1] - stopPositions[stop]);
+                    color = glm::mix(stopColors[stop], stopColors[stop + 1], localT);
+                }
+                const size_t p = begin + i;
+                s.colorR[p] = color.r;
+                s.colorG[p] = color.g;
+                s.colorB[p] = color.b;
+                s.colorA[p] = color.a;
+            }
+        });
+    }
+
+    void SizeOverLifetime(ParticleStreams& s)
+    {
+        auto& simd = SIMD::GetInstance();
+        ForEachBlock(s.count, [&](size_t begin, size_t n)
+        {
+            float t[BlockSize];
+            NormalizedAge(s, begin, n, t);
+            simd.VectorLerp(s.startSizeX.data() + begin, s.endSizeX.data() + begin, t, s.sizeX.data() + begin, n);
+            simd.VectorLerp(s.startSizeY.data() + begin, s.endSizeY.data() + begin, t, s.sizeY.data() + begin, n);
+        });
+    }
+
+    void SizeCurve(ParticleStreams& s, const std::function<float(float)>& curve)
+    {
+        if (!curve) return;
+        auto& simd = SIMD::GetInstance();
+        ForEachBlock(s.count, [&](size_t begin, size_t n)
+        {
+            float scale[BlockSize];
+            NormalizedAge(s, begin, n, scale);
+            for (size_t i = 0; i < n; ++i)
+            {
+                scale[i] = curve(scale[i]);
+            }
+            simd.VectorMultiply(s.startSizeX.data() + begin, scale, s.sizeX.data() + begin, n);
+            simd.VectorMultiply(s.startSizeY.data() + begin, scale, s.sizeY.data() + begin, n);
+        });
+    }
+
+    void AlphaFade(ParticleStreams& s, float fadeInTime, float fadeOutTime)
+    {
+        auto& simd = SIMD::GetInstance();
+        const float fadeOutStart = 1.0f - fadeOutTime;
+        ForEachBlock(s.count, [&](size_t begin, size_t n)
+        {
+            float alpha[BlockSize];
+            NormalizedAge(s, begin, n, alpha);
+            for (size_t i = 0; i < n; ++i)
+            {
+                const float t = alpha[i];
+                alpha[i] = t < fadeInTime ? t / fadeInTime : (t > fadeOutStart ? (1.0f - t) / fadeOutTime : 1.0f);
+            }
+            simd.VectorMultiply(s.startColorA.data() + begin, alpha, s.colorA.data() + begin, n);
+        });
+    }
+
+    void SequenceFrameOverLifetime(ParticleStreams& s, uint32_t frameCount, float cycles)
+    {
+        if (frameCount <= 1)
+        {
+            std::fill(s.textureIndex.begin(), s.textureIndex.end(), 0u);
+            return;
+        }
+        ForEachBlock(s.count, [&](size_t begin, size_t n)
+        {
+            float t[BlockSize];
+            NormalizedAge(s, begin, n, t);
+            uint32_t* frames = s.textureIndex.data() + begin;
+            for (size_t i = 0; i < n; ++i)
+            {
+                float cycle = t[i] * cycles;
+                cycle -= std::floor(cycle);
+                frames[i] = std::min(static_cast<uint32_t>(cycle * frameCount), frameCount - 1);
+            }
+        });
+    }
+
+    void SequenceFrameFPS(ParticleStreams& s, uint32_t frameCount, float fps)
+    {
+        if (frameCount <= 1)
+        {
+            std::fill(s.textureIndex.begin(), s.textureIndex.end(), 0u);
+            return;
+        }
+        const float* age = s.age.data();
+        uint32_t* frames = s.textureIndex.data();
+        for (size_t i = 0; i < s.count; ++i)
+        {
+            frames[i] = static_cast<uint32_t>(age[i] * fps) % frameCount;
+        }
+    }
+
+    void PlaneCollision(ParticleStreams& s, const glm::vec2& planePoint, const glm::vec2& planeNormal,
+                        float bounciness, float friction, bool killOnCollision)
+    {
+        auto& simd = SIMD::GetInstance();
+        ForEachBlock(s.count, [&](size_t begin, size_t n)
+        {
+            float* px = s.positionX.data() + begin;
+            float* py = s.positionY.data() + begin;
+            float* vx = s.velocityX.data() + begin;
+            float* vy = s.velocityY.data() + begin;
+            // 与逐粒子公式相同的运算顺序，贴近平面的粒子与参考落在同一侧
+            float distance[BlockSize], dx[BlockSize];
+            simd.VectorScalarAdd(px, -planePoint.x, dx, n);
+            simd.VectorScalarAdd(py, -planePoint.y, distance, n);
+            simd.VectorScalarMultiply(distance, planeNormal.y, distance, n);
+            simd.VectorScalarMultiplyAdd(dx, planeNormal.x, distance, distance, n);
+            if (killOnCollision)
+            {
+                float* age = s.age.data() + begin;
+                const float* lifetime = s.lifetime.data() + begin;
+                for (size_t i = 0; i < n; ++i)
+                {
+                    age[i] = distance[i] < 0.0f ? lifetime[i] : age[i];
+                }
+                return;
+            }
+
+            // 穿入的粒子沿法线推回平面；未穿入的粒子推回距离为 0
+            for (size_t i = 0; i < n; ++i)
+            {
+                distance[i] = std::min(distance[i], 0.0f);
+            }
+            simd.VectorScalarMultiplyAdd(distance, -planeNormal.x, px, px, n);
+            simd.VectorScalarMultiplyAdd(distance, -planeNormal.y, py, py, n);
+
+            // 只有穿入且朝平面内运动的粒子反弹：其余粒子的法向速度记为 0、切向保留系数为 1，速度不变
+            float normalVelocity[BlockSize], keep[BlockSize];
+            simd.VectorScalarMultiply(vy, planeNormal.y, normalVelocity, n);
+            simd.VectorScalarMultiplyAdd(vx, planeNormal.x, normalVelocity, normalVelocity, n);
+            for (size_t i = 0; i < n; ++i)
+            {
+                const bool bounce = distance[i] < 0.0f && normalVelocity[i] < 0.0f;
+                normalVelocity[i] = bounce ? normalVelocity[i] : 0.0f;
+                keep[i] = bounce ? 1.0f - friction : 1.0f;
+            }
+            // v = (v - n * vn) * keep - n * vn * bounciness
+            simd.VectorScalarMultiplyAdd(normalVelocity, -planeNormal.x, vx, vx, n);
+            simd.VectorScalarMultiplyAdd(normalVelocity, -planeNormal.y, vy, vy, n);
+            simd.VectorMultiply(vx, keep, vx, n);
+            simd.VectorMultiply(vy, keep, vy, n);
+            simd.VectorScalarMultiplyAdd(normalVelocity, -planeNormal.x * bounciness, vx, vx, n);
+            simd.VectorScalarMultiplyAdd(normalVelocity, -planeNormal.y * bounciness, vy, vy, n);
+        });
+    }
+}
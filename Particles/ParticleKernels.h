@@ -0,0 +1,54 @@
+#ifndef PARTICLE_KERNELS_H
+#define PARTICLE_KERNELS_H
+#include "../Data/ParticleData.h"
+#include <cstdint>
+#include <functional>
+#include <glm/glm.hpp>
+
+/**
+ * @brief 粒子 SoA 批处理内核。
+ *
+ * 每个内核一次处理整条属性流，内部按固定大小的块划分，块内的线性运算交给 SIMD 层，
+ * 非线性部分（三角函数、幂函数、分支选择）写成无依赖的紧凑循环，便于编译器自动向量化。
+ * 内核不跳过已死亡粒子：死亡粒子会在同一帧的 RemoveDeadParticles 中被移除，
+ * 对它们多做一次运算比逐个判断更便宜。
+ */
+namespace Particles::Kernels
+{
+    /// 内核内部临时缓冲的块大小（粒子数）。
+    constexpr size_t BlockSize = 256;
+
+    void AdvanceAge(ParticleStreams& s, float deltaTime);
+    void ApplyAcceleration(ParticleStreams& s, const glm::vec2& acceleration, float deltaTime);
+    void ApplyQuadraticDrag(ParticleStreams& s, float coefficient, float deltaTime);
+    void ScaleVelocity(ParticleStreams& s, float factor);
+    void ClampSpeed(ParticleStreams& s, float minSpeed, float maxSpeed);
+    void IntegratePosition(ParticleStreams& s, float deltaTime);
+    void IntegrateRotation(ParticleStreams& s, float deltaTime);
+    void Translate(ParticleStreams& s, const glm::vec2& offset);
+    void ApplyAttractor(ParticleStreams& s, const glm::vec2& center, float strength, float radius,
+                        float falloff, float deltaTime);
+    void ApplyVortex(ParticleStreams& s, const glm::vec2& center, float axisZ, float strength, float radius,
+                     float deltaTime);
+    void ApplyNoiseForce(ParticleStreams& s, float strength, float frequency, float scrollSpeed, float deltaTime);
+
+    /**
+     * @brief 计算 [begin, begin + count) 区间的归一化年龄，lifetime <= 0 时为 1。
+     */
+    void NormalizedAge(const ParticleStreams& s, size_t begin, size_t count, float* out);
+    void ColorOverLifetime(ParticleStreams& s);
+    void GradientColor(ParticleStreams& s, const float* stopPositions, const glm::vec4* stopColors,
+                       size_t stopCount);
+    void SizeOverLifetime(ParticleStreams& s);
+    void SizeCurve(ParticleStreams& s, const std::function<float(float)>& curve);
+    void AlphaFade(ParticleStreams& s, float fadeInTime, float fadeOutTime);
+    void SequenceFrameOverLifetime(ParticleStreams& s, uint32_t frameCount, float cycles);
+    void SequenceFrameFPS(ParticleStreams& s, uint32_t frameCount, float fps);
+
+    /**
+     * @brief 平面碰撞：穿入平面的粒子被推回平面并反弹，或直接杀死。
+     */
+    void PlaneCollision(ParticleStreams& s, const glm::vec2& planePoint, const glm::vec2& planeNormal,
+                        float bounciness, float friction, bool killOnCollision);
+}
+#endif
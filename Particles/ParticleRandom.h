@@ -0,0 +1,122 @@
+#ifndef PARTICLE_RANDOM_H
+#define PARTICLE_RANDOM_H
+#include <cstddef>
+#include <cstdint>
+namespace Particles
+{
+    /**
+     * @brief Philox4x32-10 计数器随机数生成器。
+     *
+     * 输出只由（密钥，计数器）决定，没有跨调用的串行状态依赖，
+     * 因此一次可以为整块数组生成随机数，内层循环没有数据依赖，便于编译器向量化。
+     * 密钥由种子与发射器 ID 组合而成：相同的种子与 ID 总是得到相同的序列。
+     */
+    class PhiloxRandom
+    {
+    public:
+        static constexpr size_t BlockSize = 4; ///< 每个计数器产生的 32 位随机数个数。
+
+        PhiloxRandom() = default;
+        PhiloxRandom(uint64_t seed, uint64_t streamId)
+        {
+            Seed(seed, streamId);
+        }
+        /**
+         * @brief 重新设置种子与流 ID，计数器归零。
+         */
+        void Seed(uint64_t seed, uint64_t streamId)
+        {
+            m_key0 = static_cast<uint32_t>(seed);
+            m_key1 = static_cast<uint32_t>(seed >> 32);
+            m_stream = streamId;
+            m_counter = 0;
+        }
+        /**
+         * @brief 用 [0, 1) 均匀分布的浮点数填充数组，消耗 ceil(count / 4) 个计数器。
+         */
+        void FillUniform(float* out, size_t count)
+        {
+            const size_t blocks = (count + BlockSize - 1) / BlockSize;
+            const uint64_t base = m_counter;
+            const size_t full = count / BlockSize;
+            for (size_t b = 0; b < full; ++b)
+            {
+                uint32_t r[BlockSize];
+                Generate(base + b, r);
+                for (size_t k = 0; k < BlockSize; ++k)
+                {
+                    out[b * BlockSize + k] = ToUnitFloat(r[k]);
+                }
+            }
+            if (full < blocks)
+            {
+                uint32_t r[BlockSize];
+                Generate(base + full, r);
+                for (size_t k = 0; full * BlockSize + k < count; ++k)
+                {
+                    out[full * BlockSize + k] = ToUnitFloat(r[k]);
+                }
+            }
+            m_counter += blocks;
+        }
+        /**
+         * @brief 生成单个 [0, 1) 浮点数（消耗一个完整的计数器）。
+         */
+        float NextFloat()
+        {
+            float value;
+            FillUniform(&value, 1);
+            return value;
+        }
+        [[nodiscard]] uint64_t GetCounter() const { return m_counter; }
+        void SetCounter(uint64_t counter) { m_counter = counter; }
+        /**
+         * @brief 对给定计数器计算一个 Philox4x32-10 输出块。
+         */
+        void Generate(uint64_t counter, uint32_t out[BlockSize]) const
+        {
+            uint32_t c0 = static_cast<uint32_t>(counter);
+            uint32_t c1 = static_cast<uint32_t>(counter >> 32);
+            uint32_t c2 = static_cast<uint32_t>(m_stream);
+            uint32_t c3 = static_cast<uint32_t>(m_stream >> 32);
+            uint32_t k0 = m_key0;
+            uint32_t k1 = m_key1;
+            for (int round = 0; round < 10; ++round)
+            {
+                const uint64_t p0 = static_cast<uint64_t>(Multiplier0) * c0;
+                const uint64_t p1 = static_cast<uint64_t>(Multiplier1) * c2;
+                const uint32_t hi0 = static_cast<uint32_t>(p0 >> 32);
+                const uint32_t lo0 = static_cast<uint32_t>(p0);
+                const uint32_t hi1 = static_cast<uint32_t>(p1 >> 32);
+                const uint32_t lo1 = static_cast<uint32_t>(p1);
+                c0 = hi1 ^ c1 ^ k0;
+                c1 = lo1;
+                c2 = hi0 ^ c3 ^ k1;
+                c3 = lo0;
+                k0 += Weyl0;
+                k1 += Weyl1;
+            }
+            out[0] = c0;
+            out[1] = c1;
+            out[2] = c2;
+            out[3] = c3;
+        }
+        /**
+         * @brief 取高 24 位映射到 [0, 1)，保证结果严格小于 1。
+         */
+        static float ToUnitFloat(uint32_t value)
+        {
+            return static_cast<float>(value >> 8) * (1.0f / 16777216.0f);
+        }
+    private:
+        static constexpr uint32_t Multiplier0 = 0xD2511F53u;
+        static constexpr uint32_t Multiplier1 = 0xCD9E8D57u;
+        static constexpr uint32_t Weyl0 = 0x9E3779B9u;
+        static constexpr uint32_t Weyl1 = 0xBB67AE85u;
+        uint32_t m_key0 = 0;
+        uint32_t m_key1 = 0;
+        uint64_t m_stream = 0;
+        uint64_t m_counter = 0;
+    };
+}
+#endif
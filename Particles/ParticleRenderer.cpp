@@ -210,6 +210,9 @@ namespace Particles
                 continue;
             if (!ps.pool || ps.pool->Empty())
                 continue;
+            // 休眠的发射器包围盒必然在视口外，跳过上传
+            if (ps.simulationLod == Particles::SimulationLod::Sleeping && !ps.editorPreviewActive)
+                continue;
             ParticleBatch batch;
             batch.entity = entity;
             batch.component = &ps;
@@ -280,14 +283,14 @@ namespace Particles
             BatchRenderInfo info;
             info.batch = &batch;
             info.globalStartOffset = allGPUData.size();
-            const auto& particles = batch.component->pool->GetParticles();
+            const auto& textureIndices = batch.component->pool->GetStreams().textureIndex;
             const auto& gpuData = batch.component->pool->GetGPUData();
             if (batch.component->useSequenceAnimation && !batch.component->textureFrames.empty())
             {
                 std::map<uint32_t, std::vector<size_t>> particlesByTexture;
-                for (size_t i = 0; i < particles.size(); ++i)
+                for (size_t i = 0; i < textureIndices.size(); ++i)
                 {
-                    uint32_t texIdx = std::min(particles[i].textureIndex,
+                    uint32_t texIdx = std::min(textureIndices[i],
                                                static_cast<uint32_t>(batch.component->textureFrames.size() - 1));
                     particlesByTexture[texIdx].push_back(i);
                 }
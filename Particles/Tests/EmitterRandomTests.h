@@ -0,0 +1,436 @@
+#ifndef EMITTER_RANDOM_TESTS_H
+#define EMITTER_RANDOM_TESTS_H
+
+/**
+ * @file EmitterRandomTests.h
+ * @brief Property-based tests for the counter-based RNG and batched burst emission
+ *
+ * Feature: particle-batch-emission
+ */
+
+#include "../Emitter.h"
+#include "../ParticleRandom.h"
+#include "../../Utils/Logger.h"
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace EmitterRandomTests
+{
+    /**
+     * @brief Random generator for emitter tests
+     */
+    class EmitterRandomGenerator
+    {
+    public:
+        explicit EmitterRandomGenerator(unsigned int seed) : m_gen(seed) {}
+
+        float RandomFloat(float min, float max)
+        {
+            std::uniform_real_distribution<float> dist(min, max);
+            return dist(m_gen);
+        }
+
+        uint32_t RandomUInt()
+        {
+            return m_gen();
+        }
+
+    private:
+        std::mt19937 m_gen;
+    };
+
+    /**
+     * @brief Test result structure for detailed failure reporting
+     */
+    struct TestResult
+    {
+        bool passed = true;
+        std::string failureMessage;
+        int failedIteration = -1;
+    };
+
+    /**
+     * @brief Pearson chi-square statistic of a histogram against a uniform expectation
+     */
+    inline double ChiSquare(const std::vector<int>& bins, size_t samples)
+    {
+        const double expected = static_cast<double>(samples) / static_cast<double>(bins.size());
+        double chi = 0.0;
+        for (int observed : bins)
+        {
+            const double diff = observed - expected;
+            chi += diff * diff / expected;
+        }
+        return chi;
+    }
+
+    /**
+     * @brief Loose upper bound for a chi-square variable with the given degrees of freedom
+     *
+     * mean + 5 standard deviations; a correct generator essentially never exceeds it.
+     */
+    inline double ChiSquareLimit(size_t degreesOfFreedom)
+    {
+        const double k = static_cast<double>(degreesOfFreedom);
+        return k + 5.0 * std::sqrt(2.0 * k);
+    }
+
+    inline Particles::EmitterConfig BurstConfig(Particles::EmitterShape shape, uint32_t seed)
+    {
+        Particles::EmitterConfig config;
+        config.shape = shape;
+        config.shapeSize = glm::vec3(20.0f, 10.0f, 0.0f);
+        config.emissionRate = 0.0f;
+        config.maxParticles = 200000;
+        config.randomSeed = seed;
+        config.speed = {0.0f, 0.0f};
+        config.lifetime = {1.0f, 2.0f};
+        return config;
+    }
+
+    /**
+     * Property: Philox4x32-10 matches the published known-answer vectors
+     */
+    inline TestResult TestProperty_PhiloxKnownAnswer()
+    {
+        TestResult result;
+        struct Vector
+        {
+            uint64_t seed;
+            uint64_t stream;
+            uint64_t counter;
+            uint32_t expected[4];
+        };
+        // Random123 kat_vectors (philox4x32 10): counter = {c0, c1}, stream = {c2, c3}, seed = {k0, k1}
+        const Vector vectors[] = {
+            {0x0000000000000000ull, 0x0000000000000000ull, 0x0000000000000000ull,
+             {0x6627e8d5u, 0xe169c58du, 0xbc57ac4cu, 0x9b00dbd8u}},
+            {0xffffffffffffffffull, 0xffffffffffffffffull, 0xffffffffffffffffull,
+             {0x408f276du, 0x41c83b0eu, 0xa20bc7c6u, 0x6d5451fdu}},
+            {0x299f31d0a4093822ull, 0x0370734413198a2eull, 0x85a308d3243f6a88ull,
+             {0xd16cfe09u, 0x94fdccebu, 0x5001e420u, 0x24126ea1u}},
+        };
+        int index = 0;
+        for (const auto& v : vectors)
+        {
+            Particles::PhiloxRandom rng(v.seed, v.stream);
+            uint32_t out[Particles::PhiloxRandom::BlockSize];
+            rng.Generate(v.counter, out);
+            for (size_t k = 0; k < Particles::PhiloxRandom::BlockSize; ++k)
+            {
+                if (out[k] != v.expected[k])
+                {
+                    std::ostringstream oss;
+                    oss << "Vector " << index << " word " << k << ": expected 0x" << std::hex << v.expected[k]
+                        << ", got 0x" << out[k];
+                    result.passed = false;
+                    result.failedIteration = index;
+                    result.failureMessage = oss.str();
+                    return result;
+                }
+            }
+            ++index;
+        }
+        return result;
+    }
+
+    /**
+     * Property: FillUniform is uniform on [0, 1) and independent of how the request is split
+     */
+    inline TestResult TestProperty_UniformAndSplitInvariant(int iterations = 20)
+    {
+        TestResult result;
+        EmitterRandomGenerator gen(29u);
+        const size_t samples = 64000;
+        const size_t binCount = 64;
+        for (int i = 0; i < iterations; ++i)
+        {
+            const uint64_t seed = (static_cast<uint64_t>(gen.RandomUInt()) << 32) | gen.RandomUInt();
+            const uint64_t stream = gen.RandomUInt();
+            Particles::PhiloxRandom whole(seed, stream);
+            std::vector<float> values(samples);
+            whole.FillUniform(values.data(), samples);
+
+            std::vector<int> bins(binCount, 0);
+            for (float value : values)
+            {
+                if (value < 0.0f || value >= 1.0f)
+                {
+                    result.passed = false;
+                    result.failedIteration = i;
+                    result.failureMessage = "Value outside [0, 1): " + std::to_string(value);
+                    return result;
+                }
+                ++bins[static_cast<size_t>(value * binCount)];
+            }
+            const double chi = ChiSquare(bins, samples);
+            if (chi > ChiSquareLimit(binCount - 1))
+            {
+                result.passed = false;
+                result.failedIteration = i;
+                result.failureMessage = "Chi-square too large: " + std::to_string(chi);
+                return result;
+            }
+
+            // 按 4 的倍数拆分请求应得到完全相同的序列
+            Particles::PhiloxRandom split(seed, stream);
+            std::vector<float> pieces(samples);
+            size_t offset = 0;
+            while (offset < samples)
+            {
+                const size_t chunk = std::min<size_t>(samples - offset, 4 * (1 + gen.RandomUInt() % 300));
+                split.FillUniform(pieces.data() + offset, chunk);
+                offset += chunk;
+            }
+            if (pieces != values)
+            {
+                result.passed = false;
+                result.failedIteration = i;
+                result.failureMessage = "Split requests produced a different sequence";
+                return result;
+            }
+        }
+        return result;
+    }
+
+    /**
+     * Property: filled circles are area-uniform (radius² and angle both uniform)
+     */
+    inline TestResult TestProperty_CircleAreaUniform(int iterations = 10)
+    {
+        TestResult result;
+        const size_t samples = 40000;
+        const size_t binCount = 40;
+        for (int i = 0; i < iterations; ++i)
+        {
+            Particles::EmitterConfig config = BurstConfig(Particles::EmitterShape::Circle, 1000u + i);
+            Particles::Emitter emitter(config, static_cast<uint64_t>(i));
+            Particles::ParticlePool pool(samples);
+            emitter.Burst(pool, samples);
+            if (pool.Size() != samples)
+            {
+                result.passed = false;
+                result.failedIteration = i;
+                result.failureMessage = "Burst emitted " + std::to_string(pool.Size()) + " particles";
+                return result;
+            }
+
+            const float radius = config.shapeSize.x;
+            std::vector<int> radialBins(binCount, 0);
+            std::vector<int> angleBins(binCount, 0);
+            const auto& s = pool.GetStreams();
+            for (size_t p = 0; p < samples; ++p)
+            {
+                const float x = s.positionX[p];
+                const float y = s.positionY[p];
+                const float r2 = (x * x + y * y) / (radius * radius);
+                if (r2 > 1.0001f)
+                {
+                    result.passed = false;
+                    result.failedIteration = i;
+                    result.failureMessage = "Particle spawned outside the circle";
+                    return result;
+                }
+                const float angle = std::atan2(y, x) / glm::two_pi<float>() + 0.5f;
+                ++radialBins[std::min(static_cast<size_t>(r2 * binCount), binCount - 1)];
+                ++angleBins[std::min(static_cast<size_t>(angle * binCount), binCount - 1)];
+            }
+            const double radialChi = ChiSquare(radialBins, samples);
+            const double angleChi = ChiSquare(angleBins, samples);
+            if (radialChi > ChiSquareLimit(binCount - 1) || angleChi > ChiSquareLimit(binCount - 1))
+            {
+                std::ostringstream oss;
+                oss << "Circle not area-uniform: radial chi " << radialChi << ", angle chi " << angleChi;
+                result.passed = false;
+                result.failedIteration = i;
+                result.failureMessage = oss.str();
+                return result;
+            }
+        }
+        return result;
+    }
+
+    /**
+     * Property: rectangles and edges spawn uniformly across their extent
+     */
+    inline TestResult TestProperty_RectangleAndEdgeUniform(int iterations = 10)
+    {
+        TestResult result;
+        const size_t samples = 40000;
+        const size_t binCount = 40;
+        for (int i = 0; i < iterations; ++i)
+        {
+            for (auto shape : {Particles::EmitterShape::Rectangle, Particles::EmitterShape::Edge})
+            {
+                Particles::EmitterConfig config = BurstConfig(shape, 2000u + i);
+                Particles::Emitter emitter(config, 7);
+                Particles::ParticlePool pool(samples);
+                emitter.Burst(pool, samples);
+
+                std::vector<int> xBins(binCount, 0);
+                std::vector<int> yBins(binCount, 0);
+                const auto& s = pool.GetStreams();
+                for (size_t p = 0; p < samples; ++p)
+                {
+                    const float u = s.positionX[p] / config.shapeSize.x + 0.5f;
+                    const float v = s.positionY[p] / config.shapeSize.y + 0.5f;
+                    ++xBins[std::min(static_cast<size_t>(std::max(u, 0.0f) * binCount), binCount - 1)];
+                    ++yBins[std::min(static_cast<size_t>(std::max(v, 0.0f) * binCount), binCount - 1)];
+                }
+                const bool isEdge = shape == Particles::EmitterShape::Edge;
+                const double xChi = ChiSquare(xBins, samples);
+                const double yChi = isEdge ? 0.0 : ChiSquare(yBins, samples);
+                if (xChi > ChiSquareLimit(binCount - 1) || yChi > ChiSquareLimit(binCount - 1))
+                {
+                    std::ostringstream oss;
+                    oss << (isEdge ? "Edge" : "Rectangle") << " not uniform: x chi " << xChi << ", y chi " << yChi;
+                    result.passed = false;
+                    result.failedIteration = i;
+                    result.failureMessage = oss.str();
+                    return result;
+                }
+            }
+        }
+        return result;
+    }
+
+    /**
+     * Property: the same seed and emitter ID reproduce the same particles; a different ID does not
+     */
+    inline TestResult TestProperty_SeedReproducible(int iterations = 50)
+    {
+        TestResult result;
+        EmitterRandomGenerator gen(31u);
+        for (int i = 0; i < iterations; ++i)
+        {
+            Particles::EmitterConfig config =
+                BurstConfig(static_cast<Particles::EmitterShape>(gen.RandomUInt() % 8), 1u + gen.RandomUInt());
+            config.speed = {gen.RandomFloat(0.0f, 10.0f), gen.RandomFloat(10.0f, 50.0f)};
+            config.randomizeDirection = gen.RandomFloat(0.0f, 1.0f);
+            config.emissionRate = gen.RandomFloat(10.0f, 500.0f);
+            const uint64_t emitterId = gen.RandomUInt();
+
+            auto run = [&](uint64_t id)
+            {
+                Particles::Emitter emitter(config, id);
+                Particles::ParticlePool pool(config.maxParticles);
+                emitter.Burst(pool, 37);
+                for (int frame = 0; frame < 20; ++frame)
+                {
+                    emitter.Update(pool, 1.0f / 60.0f, glm::vec3(3.0f, -2.0f, 0.0f));
+                }
+                std::vector<float> trace;
+                const auto& s = pool.GetStreams();
+                for (size_t p = 0; p < pool.Size(); ++p)
+                {
+                    trace.insert(trace.end(), {s.positionX[p], s.positionY[p], s.velocityX[p], s.velocityY[p],
+                                               s.lifetime[p], s.startSizeX[p], s.startColorR[p]});
+                }
+                return trace;
+            };
+
+            const auto first = run(emitterId);
+            const auto second = run(emitterId);
+            if (first != second)
+            {
+                result.passed = false;
+                result.failedIteration = i;
+                result.failureMessage = "Same seed and emitter ID produced different particles";
+                return result;
+            }
+            if (first == run(emitterId + 1))
+            {
+                result.passed = false;
+                result.failedIteration = i;
+                result.failureMessage = "Different emitter IDs produced identical particles";
+                return result;
+            }
+        }
+        return result;
+    }
+
+    /**
+     * @brief Measure burst emission throughput against a per-particle mt19937 loop
+     */
+    inline void RunBurstEmissionBenchmark(uint32_t burstSize = 100000, int bursts = 20)
+    {
+        Particles::EmitterConfig config = BurstConfig(Particles::EmitterShape::Circle, 1u);
+        config.speed = {10.0f, 40.0f};
+        config.randomizeDirection = 0.3f;
+
+        using Clock = std::chrono::high_resolution_clock;
+        std::mt19937 mt(1u);
+        std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+        Particles::ParticlePool scalarPool(burstSize);
+        auto start = Clock::now();
+        for (int b = 0; b < bursts; ++b)
+        {
+            scalarPool.Clear();
+            for (uint32_t p = 0; p < burstSize; ++p)
+            {
+                Particles::ParticleData particle;
+                const float angle = dist(mt) * glm::two_pi<float>();
+                const float radius = std::sqrt(dist(mt)) * config.shapeSize.x;
+                particle.position = glm::vec2(std::cos(angle), std::sin(angle)) * radius;
+                particle.velocity = glm::vec2(std::cos(angle), std::sin(angle)) * config.speed.Lerp(dist(mt));
+                particle.lifetime = config.lifetime.Lerp(dist(mt));
+                particle.startSize = config.size.Lerp(dist(mt));
+                particle.endSize = config.endSize.Lerp(dist(mt));
+                particle.startColor = config.startColor.Lerp(dist(mt));
+                particle.endColor = config.endColor.Lerp(dist(mt));
+                scalarPool.Emit(particle);
+            }
+        }
+        const double scalarMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count() / bursts;
+
+        Particles::Emitter emitter(config, 1);
+        Particles::ParticlePool batchPool(burstSize);
+        start = Clock::now();
+        for (int b = 0; b < bursts; ++b)
+        {
+            batchPool.Clear();
+            emitter.Burst(batchPool, burstSize);
+        }
+        const double batchMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count() / bursts;
+
+        LogInfo("Burst emission: {} particles, per-particle mt19937 {:.2f} ms, batched Philox {:.2f} ms ({:.2f}x)",
+                burstSize, scalarMs, batchMs, batchMs > 0.0 ? scalarMs / batchMs : 0.0);
+    }
+
+    inline bool RunTest(const char* name, const TestResult& result)
+    {
+        if (result.passed)
+        {
+            LogInfo("{} PASSED", name);
+            return true;
+        }
+        LogError("{} FAILED at iteration {}: {}", name, result.failedIteration, result.failureMessage);
+        return false;
+    }
+
+    /**
+     * @brief Run all emitter random tests
+     *
+     * @return true if all tests pass, false otherwise
+     */
+    inline bool RunAllEmitterRandomTests()
+    {
+        LogInfo("=== Running Emitter Random Tests ===");
+
+        bool allPassed = true;
+        allPassed &= RunTest("Philox known-answer vectors", TestProperty_PhiloxKnownAnswer());
+        allPassed &= RunTest("Uniform and split-invariant", TestProperty_UniformAndSplitInvariant());
+        allPassed &= RunTest("Circle spawn is area-uniform", TestProperty_CircleAreaUniform());
+        allPassed &= RunTest("Rectangle and edge spawn uniform", TestProperty_RectangleAndEdgeUniform());
+        allPassed &= RunTest("Seeded emission is reproducible", TestProperty_SeedReproducible());
+
+        LogInfo("=== Emitter Random Tests Complete ===");
+        return allPassed;
+    }
+}
+
+#endif // EMITTER_RANDOM_TESTS_H
@@ -0,0 +1,423 @@
+#ifndef PARTICLE_CULLING_TESTS_H
+#define PARTICLE_CULLING_TESTS_H
+
+/**
+ * @file ParticleCullingTests.h
+ * @brief Property-based tests for off-screen emitter sleeping, LOD and the particle budget
+ *
+ * Feature: particle-emitter-sleeping
+ */
+
+#include "../ParticleCulling.h"
+#include "../../Utils/Logger.h"
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace ParticleCullingTests
+{
+    /**
+     * @brief Random generator for culling tests
+     */
+    class CullingRandomGenerator
+    {
+    public:
+        explicit CullingRandomGenerator(unsigned int seed) : m_gen(seed) {}
+
+        float RandomFloat(float min, float max)
+        {
+            std::uniform_real_distribution<float> dist(min, max);
+            return dist(m_gen);
+        }
+
+        int RandomInt(int min, int max)
+        {
+            std::uniform_int_distribution<int> dist(min, max);
+            return dist(m_gen);
+        }
+
+    private:
+        std::mt19937 m_gen;
+    };
+
+    /**
+     * @brief Test result structure for detailed failure reporting
+     */
+    struct TestResult
+    {
+        bool passed = true;
+        std::string failureMessage;
+        int failedIteration = -1;
+    };
+
+    inline Particles::EmitterConfig RandomConfig(CullingRandomGenerator& gen)
+    {
+        Particles::EmitterConfig config;
+        config.shape = static_cast<Particles::EmitterShape>(gen.RandomInt(0, 7));
+        config.shapeSize = glm::vec3(gen.RandomFloat(0.0f, 40.0f), gen.RandomFloat(0.0f, 40.0f), 0.0f);
+        config.coneRadius = gen.RandomFloat(0.0f, 20.0f);
+        config.coneLength = gen.RandomFloat(0.0f, 20.0f);
+        config.emissionRate = gen.RandomFloat(5.0f, 200.0f);
+        const float lifeMin = gen.RandomFloat(0.2f, 2.0f);
+        config.lifetime = {lifeMin, lifeMin + gen.RandomFloat(0.0f, 2.0f)};
+        const float speedMin = gen.RandomFloat(0.0f, 100.0f);
+        config.speed = {speedMin, speedMin + gen.RandomFloat(0.0f, 100.0f)};
+        config.directionRandomness = gen.RandomFloat(0.0f, 1.0f);
+        config.maxParticles = static_cast<uint32_t>(gen.RandomInt(50, 2000));
+        return config;
+    }
+
+    inline void BuildChain(Particles::AffectorChain& chain, const glm::vec3& gravity)
+    {
+        chain.Clear();
+        chain.Add<Particles::LifetimeAffector>();
+        chain.Add<Particles::GravityAffector>(gravity);
+        chain.Add<Particles::VelocityAffector>();
+        chain.Add<Particles::ColorOverLifetimeAffector>();
+        chain.Add<Particles::SizeOverLifetimeAffector>();
+    }
+
+    /**
+     * @brief Property: 预算只裁掉最不重要的发射器
+     *
+     * For any set of requests and budget, the admitted emitters form a prefix of
+     * the (importance desc, distance asc) order, their total cost fits the budget,
+     * and the first shed emitter would not have fit.
+     */
+    inline TestResult TestProperty_BudgetShedsLeastImportant(int iterations = 100)
+    {
+        TestResult result;
+        CullingRandomGenerator gen(2024u);
+
+        for (int i = 0; i < iterations; ++i)
+        {
+            std::vector<Particles::ParticleBudgetRequest> requests(gen.RandomInt(0, 64));
+            for (size_t r = 0; r < requests.size(); ++r)
+            {
+                requests[r].index = r;
+                requests[r].importance = gen.RandomInt(-3, 3);
+                requests[r].distanceSq = gen.RandomFloat(0.0f, 1.0e6f);
+                requests[r].cost = static_cast<uint32_t>(gen.RandomInt(0, 5000));
+            }
+            const size_t budget = static_cast<size_t>(gen.RandomInt(0, 60000));
+            const size_t used = Particles::ApplyParticleBudget(requests, budget);
+
+            size_t sum = 0;
+            bool shedSeen = false;
+            for (size_t r = 0; r < requests.size(); ++r)
+            {
+                const auto& request = requests[r];
+                if (r > 0)
+                {
+                    const auto& prev = requests[r - 1];
+                    if (prev.importance < request.importance ||
+                        (prev.importance == request.importance && prev.distanceSq > request.distanceSq))
+                    {
+                        result.passed = false;
+                        result.failedIteration = i;
+                        result.failureMessage = "Requests are not ordered by importance and distance";
+                        return result;
+                    }
+                }
+                if (request.admitted)
+                {
+                    if (shedSeen)
+                    {
+                        result.passed = false;
+                        result.failedIteration = i;
+                        result.failureMessage = "A less important emitter was admitted after a more important one was shed";
+                        return result;
+                    }
+                    sum += request.cost;
+                }
+                else if (!shedSeen)
+                {
+                    shedSeen = true;
+                    if (budget == 0 || sum + request.cost <= budget)
+                    {
+                        result.passed = false;
+                        result.failedIteration = i;
+                        result.failureMessage = "Emitter shed although it fit into the remaining budget";
+                        return result;
+                    }
+                }
+            }
+            if (sum != used || (budget != 0 && sum > budget))
+            {
+                result.passed = false;
+                result.failedIteration = i;
+                result.failureMessage = "Admitted cost " + std::to_string(sum) + " exceeds budget " +
+                                        std::to_string(budget);
+                return result;
+            }
+        }
+        return result;
+    }
+
+    /**
+     * @brief Property: 保守包围盒始终包含所有存活粒子
+     */
+    inline TestResult TestProperty_BoundsContainParticles(int iterations = 50)
+    {
+        TestResult result;
+        CullingRandomGenerator gen(31u);
+        const float dt = 1.0f / 60.0f;
+
+        for (int i = 0; i < iterations; ++i)
+        {
+            const Particles::EmitterConfig config = RandomConfig(gen);
+            const glm::vec3 gravity(0.0f, gen.RandomFloat(-200.0f, 200.0f), 0.0f);
+            const glm::vec3 position(gen.RandomFloat(-1000.0f, 1000.0f), gen.RandomFloat(-1000.0f, 1000.0f), 0.0f);
+            Particles::Emitter emitter(config);
+            Particles::ParticlePool pool(config.maxParticles);
+            Particles::AffectorChain chain;
+            BuildChain(chain, gravity);
+            const Particles::ParticleBounds bounds =
+                Particles::ComputeEmitterBounds(config, glm::vec2(position), glm::vec2(1.0f), glm::vec2(gravity));
+
+            for (int frame = 0; frame < 240; ++frame)
+            {
+                emitter.Update(pool, dt, position);
+                chain.UpdateBatch(pool.GetStreams(), dt);
+                pool.RemoveDeadParticles();
+                const auto& s = pool.GetStreams();
+                for (size_t p = 0; p < s.count; ++p)
+                {
+                    if (s.positionX[p] < bounds.min.x - 1e-2f || s.positionX[p] > bounds.max.x + 1e-2f ||
+                        s.positionY[p] < bounds.min.y - 1e-2f || s.positionY[p] > bounds.max.y + 1e-2f)
+                    {
+                        result.passed = false;
+                        result.failedIteration = i;
+                        std::ostringstream oss;
+                        oss << "Particle at (" << s.positionX[p] << ", " << s.positionY[p]
+                            << ") escaped bounds [" << bounds.min.x << ", " << bounds.min.y << "] - ["
+                            << bounds.max.x << ", " << bounds.max.y << "]";
+                        result.failureMessage = oss.str();
+                        return result;
+                    }
+                }
+            }
+        }
+        return result;
+    }
+
+    /**
+     * @brief Property: 远离视口的发射器休眠，与视口相交的发射器完整模拟
+     */
+    inline TestResult TestProperty_ClassifyByDistance(int iterations = 100)
+    {
+        TestResult result;
+        CullingRandomGenerator gen(5u);
+        const Particles::ParticleBounds viewBounds{{-640.0f, -360.0f}, {640.0f, 360.0f}};
+
+        for (int i = 0; i < iterations; ++i)
+        {
+            const float margin = gen.RandomFloat(0.0f, 128.0f);
+            const glm::vec2 extent(gen.RandomFloat(1.0f, 100.0f), gen.RandomFloat(1.0f, 100.0f));
+            const glm::vec2 inside(gen.RandomFloat(-640.0f, 640.0f), gen.RandomFloat(-360.0f, 360.0f));
+            const glm::vec2 far(gen.RandomFloat(5000.0f, 10000.0f), gen.RandomFloat(-10000.0f, 10000.0f));
+
+            if (Particles::ClassifyEmitter({inside - extent, inside + extent}, viewBounds, margin) !=
+                Particles::SimulationLod::Full ||
+                Particles::ClassifyEmitter({far - extent, far + extent}, viewBounds, margin) !=
+                Particles::SimulationLod::Sleeping)
+            {
+                result.passed = false;
+                result.failedIteration = i;
+                result.failureMessage = "Emitter LOD does not follow its distance to the view";
+                return result;
+            }
+        }
+        return result;
+    }
+
+    /**
+     * @brief Property: 重新进入视口时快进到接近连续模拟的稳态，且结果可复现
+     *
+     * An emitter that slept for T seconds and is fast-forwarded has a particle count
+     * close to an emitter simulated every frame for T seconds, all its particles are
+     * alive, and fast-forwarding two copies of the same state gives identical pools.
+     */
+    inline TestResult TestProperty_ReentryFastForward(int iterations = 50)
+    {
+        TestResult result;
+        CullingRandomGenerator gen(77u);
+        const float dt = 1.0f / 60.0f;
+
+        for (int i = 0; i < iterations; ++i)
+        {
+            Particles::EmitterConfig config = RandomConfig(gen);
+            config.maxParticles = 100000;
+            const glm::vec3 position(gen.RandomFloat(-100.0f, 100.0f), 0.0f, 0.0f);
+            const float sleepTime = gen.RandomFloat(0.5f, 10.0f);
+            Particles::AffectorChain chain;
+            BuildChain(chain, glm::vec3(0.0f, 50.0f, 0.0f));
+
+            Particles::Emitter continuous(config);
+            Particles::ParticlePool continuousPool;
+            const int frames = static_cast<int>(sleepTime / dt);
+            for (int frame = 0; frame < frames; ++frame)
+            {
+                continuous.Update(continuousPool, dt, position);
+                chain.UpdateBatch(continuousPool.GetStreams(), dt);
+                continuousPool.RemoveDeadParticles();
+            }
+
+            Particles::Emitter sleeper(config);
+            Particles::ParticlePool sleeperPool;
+            Particles::Emitter sleeperCopy = sleeper;
+            Particles::ParticlePool copyPool;
+            Particles::FastForward(sleeper, sleeperPool, chain, frames * dt, position, glm::vec2(1.0f), true);
+            Particles::FastForward(sleeperCopy, copyPool, chain, frames * dt, position, glm::vec2(1.0f), true);
+
+            const float expected = static_cast<float>(continuousPool.Size());
+            const float actual = static_cast<float>(sleeperPool.Size());
+            if (std::abs(actual - expected) > 0.2f * expected + 4.0f)
+            {
+                result.passed = false;
+                result.failedIteration = i;
+                std::ostringstream oss;
+                oss << "Fast-forwarded emitter has " << actual << " particles, continuous simulation has "
+                    << expected << " after " << frames * dt << "s";
+                result.failureMessage = oss.str();
+                return result;
+            }
+
+            const auto& a = sleeperPool.GetStreams();
+            const auto& b = copyPool.GetStreams();
+            if (a.count != b.count || a.positionX != b.positionX || a.positionY != b.positionY || a.age != b.age)
+            {
+                result.passed = false;
+                result.failedIteration = i;
+                result.failureMessage = "Fast-forwarding identical state produced different pools";
+                return result;
+            }
+            for (size_t p = 0; p < a.count; ++p)
+            {
+                if (a.IsDead(p))
+                {
+                    result.passed = false;
+                    result.failedIteration = i;
+                    result.failureMessage = "Fast-forward left a dead particle in the pool";
+                    return result;
+                }
+            }
+        }
+        return result;
+    }
+
+    /**
+     * @brief Property: 长时间休眠后的快进延续发射器状态，而不是回到起点
+     *
+     * A fixed-seed emitter that re-enters twice after sleeping longer than its lifetime
+     * does not replay the same spawn sequence, and a burst-only emitter keeps its burst
+     * phase: it has live particles after fast-forwarding exactly when an emitter simulated
+     * every frame does.
+     */
+    inline TestResult TestProperty_ReentryContinuesEmitterState(int iterations = 50)
+    {
+        TestResult result;
+        CullingRandomGenerator gen(78u);
+        const float dt = 1.0f / 60.0f;
+
+        for (int i = 0; i < iterations; ++i)
+        {
+            Particles::AffectorChain chain;
+            BuildChain(chain, glm::vec3(0.0f, 50.0f, 0.0f));
+
+            Particles::EmitterConfig config = RandomConfig(gen);
+            config.speed = {10.0f, 100.0f};
+            config.randomSeed = static_cast<uint32_t>(gen.RandomInt(1, 1 << 30));
+            const float window = std::max(config.lifetime.min, config.lifetime.max);
+            Particles::Emitter emitter(config);
+            Particles::ParticlePool first;
+            Particles::ParticlePool second;
+            Particles::FastForward(emitter, first, chain, window * 2.0f, glm::vec3(0.0f), glm::vec2(1.0f), true);
+            second = first;
+            Particles::FastForward(emitter, second, chain, window * 2.0f, glm::vec3(0.0f), glm::vec2(1.0f), true);
+            const auto& a = first.GetStreams();
+            const auto& b = second.GetStreams();
+            if (a.count > 0 && a.count == b.count && a.velocityX == b.velocityX && a.velocityY == b.velocityY)
+            {
+                result.passed = false;
+                result.failedIteration = i;
+                result.failureMessage = "Second re-entry replayed the spawn sequence of the first";
+                return result;
+            }
+
+            // Burst-only emitter whose lifetime is shorter than the burst interval
+            Particles::EmitterConfig burst = config;
+            burst.emissionRate = 0.0f;
+            burst.lifetime = {1.0f, 1.0f};
+            burst.burstCount = static_cast<uint32_t>(gen.RandomInt(5, 50));
+            burst.burstInterval = gen.RandomFloat(1.5f, 4.0f);
+            // Keep the time since the last burst away from the lifetime edge
+            int frames;
+            float sinceBurst;
+            do
+            {
+                frames = gen.RandomInt(120, 720);
+                sinceBurst = std::fmod(frames * dt, burst.burstInterval);
+            } while (std::abs(sinceBurst - 1.0f) < 0.25f || sinceBurst < 0.25f ||
+                     sinceBurst > burst.burstInterval - 0.25f);
+
+            Particles::Emitter continuous(burst);
+            Particles::ParticlePool continuousPool;
+            for (int frame = 0; frame < frames; ++frame)
+            {
+                continuous.Update(continuousPool, dt);
+                chain.UpdateBatch(continuousPool.GetStreams(), dt);
+                continuousPool.RemoveDeadParticles();
+            }
+            Particles::Emitter sleeper(burst);
+            Particles::ParticlePool sleeperPool;
+            Particles::FastForward(sleeper, sleeperPool, chain, frames * dt, glm::vec3(0.0f), glm::vec2(1.0f), true);
+            if ((continuousPool.Size() > 0) != (sleeperPool.Size() > 0))
+            {
+                result.passed = false;
+                result.failedIteration = i;
+                std::ostringstream oss;
+                oss << "After " << frames * dt << "s with bursts every " << burst.burstInterval
+                    << "s, continuous simulation has " << continuousPool.Size()
+                    << " particles and the fast-forwarded emitter has " << sleeperPool.Size();
+                result.failureMessage = oss.str();
+                return result;
+            }
+        }
+        return result;
+    }
+
+    inline bool RunTest(const char* name, const TestResult& result)
+    {
+        if (result.passed)
+        {
+            LogInfo("{} PASSED", name);
+            return true;
+        }
+        LogError("{} FAILED at iteration {}: {}", name, result.failedIteration, result.failureMessage);
+        return false;
+    }
+
+    /**
+     * @brief Run all particle culling tests
+     *
+     * @return true if all tests pass, false otherwise
+     */
+    inline bool RunAllParticleCullingTests()
+    {
+        LogInfo("=== Running Particle Culling Tests ===");
+
+        bool allPassed = true;
+        allPassed &= RunTest("Budget sheds least important emitters", TestProperty_BudgetShedsLeastImportant());
+        allPassed &= RunTest("Emitter bounds contain particles", TestProperty_BoundsContainParticles());
+        allPassed &= RunTest("Emitter LOD follows view distance", TestProperty_ClassifyByDistance());
+        allPassed &= RunTest("Re-entry fast-forward", TestProperty_ReentryFastForward());
+        allPassed &= RunTest("Re-entry continues emitter state", TestProperty_ReentryContinuesEmitterState());
+
+        LogInfo("=== Particle Culling Tests Complete ===");
+        return allPassed;
+    }
+}
+
+#endif // PARTICLE_CULLING_TESTS_H
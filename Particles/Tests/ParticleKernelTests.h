@@ -0,0 +1,631 @@
+#ifndef PARTICLE_KERNEL_TESTS_H
+#define PARTICLE_KERNEL_TESTS_H
+
+/**
+ * @file ParticleKernelTests.h
+ * @brief Property-based tests and benchmark for the SoA particle kernels
+ *
+ * Random particle sets are simulated twice: once through the SoA ParticlePool and
+ * the batch affectors, once through a scalar reference that keeps the original
+ * array-of-structs per-particle affector logic. Both results must agree within a
+ * small tolerance after every frame.
+ *
+ * Feature: particle-soa-kernels
+ */
+
+#include "../Affector.h"
+#include "../../Utils/Logger.h"
+#include "../../Utils/SIMDWrapper.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace ParticleKernelTests
+{
+    /**
+     * @brief Random generator for particle tests
+     */
+    class ParticleRandomGenerator
+    {
+    public:
+        explicit ParticleRandomGenerator(unsigned int seed) : m_gen(seed) {}
+
+        float RandomFloat(float min, float max)
+        {
+            std::uniform_real_distribution<float> dist(min, max);
+            return dist(m_gen);
+        }
+
+        int RandomInt(int min, int max)
+        {
+            std::uniform_int_distribution<int> dist(min, max);
+            return dist(m_gen);
+        }
+
+    private:
+        std::mt19937 m_gen;
+    };
+
+    /**
+     * @brief Test result structure for detailed failure reporting
+     */
+    struct TestResult
+    {
+        bool passed = true;
+        std::string failureMessage;
+        int failedIteration = -1;
+    };
+
+    /**
+     * @brief 标量参考实现使用的 AoS 粒子，字段与改造前的 ParticleData 一致。
+     */
+    struct ReferenceParticle
+    {
+        glm::vec3 position{0.0f};
+        glm::vec3 velocity{0.0f};
+        float age = 0.0f;
+        float lifetime = 1.0f;
+        glm::vec4 color{1.0f};
+        glm::vec2 size{1.0f};
+        float rotation = 0.0f;
+        float angularVelocity = 0.0f;
+        glm::vec4 startColor{1.0f};
+        glm::vec4 endColor{1.0f};
+        glm::vec2 startSize{1.0f};
+        glm::vec2 endSize{1.0f};
+        uint32_t textureIndex = 0;
+
+        float GetNormalizedAge() const { return lifetime > 0.0f ? age / lifetime : 1.0f; }
+        bool IsDead() const { return age >= lifetime; }
+    };
+
+    /**
+     * @brief 参考模拟参数，覆盖默认影响器链的所有可选项。
+     */
+    struct ReferenceSettings
+    {
+        glm::vec3 gravity{0.0f, 98.1f, 0.0f};
+        float damping = 0.98f;
+        float dragCoefficient = 0.01f;
+        glm::vec3 vortexCenter{0.0f};
+        float vortexStrength = 10.0f;
+        float vortexRadius = 100.0f;
+        float noiseStrength = 5.0f;
+        float noiseFrequency = 1.0f;
+        float noiseSpeed = 1.0f;
+        glm::vec3 attractorPosition{0.0f};
+        float attractorStrength = 50.0f;
+        float attractorRadius = 100.0f;
+        float maxSpeed = 400.0f;
+        float fadeIn = 0.1f;
+        float fadeOut = 0.3f;
+        uint32_t frameCount = 8;
+        glm::vec3 planePoint{0.0f, 150.0f, 0.0f};
+        glm::vec3 planeNormal{0.0f, -1.0f, 0.0f};
+    };
+
+    /**
+     * @brief 改造前逐粒子影响器的逐字翻译，作为标量参考。
+     */
+    inline void ReferenceStep(std::vector<ReferenceParticle>& particles, const ReferenceSettings& cfg, float dt)
+    {
+        for (auto& p : particles)
+        {
+            if (p.IsDead()) continue;
+            p.age += dt;
+        }
+        for (auto& p : particles)
+        {
+            if (p.IsDead()) continue;
+            p.velocity += cfg.gravity * dt;
+            p.velocity *= std::pow(cfg.damping, dt * 60.0f);
+
+            float speed = glm::length(p.velocity);
+            if (speed > 0.001f)
+            {
+                p.velocity += -glm::normalize(p.velocity) * cfg.dragCoefficient * speed * speed * dt;
+            }
+
+            glm::vec3 toParticle = p.position - cfg.vortexCenter;
+            float distance = glm::length(toParticle);
+            if (distance >= 0.001f && distance <= cfg.vortexRadius)
+            {
+                glm::vec3 tangent = glm::cross(glm::vec3(0.0f, 0.0f, 1.0f), glm::normalize(toParticle));
+                p.velocity += tangent * cfg.vortexStrength * (1.0f - distance / cfg.vortexRadius) * dt;
+            }
+
+            float time = p.age * cfg.noiseSpeed;
+            glm::vec3 noisePos = p.position * cfg.noiseFrequency + glm::vec3(time);
+            glm::vec3 force;
+            force.x = std::sin(noisePos.y * 2.1f + noisePos.z * 1.3f) * std::cos(noisePos.x * 1.7f + time);
+            force.y = std::sin(noisePos.z * 2.3f + noisePos.x * 1.5f) * std::cos(noisePos.y * 1.9f + time * 1.1f);
+            force.z = 0.0f;
+            p.velocity += force * cfg.noiseStrength * dt;
+
+            glm::vec3 toAttractor = cfg.attractorPosition - p.position;
+            distance = glm::length(toAttractor);
+            if (distance >= 0.001f && distance <= cfg.attractorRadius)
+            {
+                float f = cfg.attractorStrength * std::pow(1.0f - distance / cfg.attractorRadius, 2.0f);
+                p.velocity += glm::normalize(toAttractor) * f * dt;
+            }
+
+            speed = glm::length(p.velocity);
+            if (speed > cfg.maxSpeed && speed > 0.001f)
+            {
+                p.velocity = glm::normalize(p.velocity) * cfg.maxSpeed;
+            }
+
+            p.position += p.velocity * dt;
+
+            float t = p.GetNormalizedAge();
+            p.color = glm::mix(p.startColor, p.endColor, t);
+            p.size = glm::mix(p.startSize, p.endSize, t);
+            p.rotation += p.angularVelocity * dt;
+
+            float alpha = 1.0f;
+            if (t < cfg.fadeIn) alpha = t / cfg.fadeIn;
+            else if (t > 1.0f - cfg.fadeOut) alpha = (1.0f - t) / cfg.fadeOut;
+            p.color.a = p.startColor.a * alpha;
+
+            float cycle = t - std::floor(t);
+            p.textureIndex = std::min(static_cast<uint32_t>(cycle * cfg.frameCount), cfg.frameCount - 1);
+
+            float planeDistance = glm::dot(p.position - cfg.planePoint, cfg.planeNormal);
+            if (planeDistance < 0.0f)
+            {
+                p.position -= cfg.planeNormal * planeDistance;
+                float normalVelocity = glm::dot(p.velocity, cfg.planeNormal);
+                if (normalVelocity < 0.0f)
+                {
+                    glm::vec3 normalComponent = cfg.planeNormal * normalVelocity;
+                    glm::vec3 tangentComponent = p.velocity - normalComponent;
+                    p.velocity = tangentComponent * 0.9f - normalComponent * 0.5f;
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief 按参考模拟的顺序构造批处理影响器链。
+     */
+    inline void BuildChain(Particles::AffectorChain& chain, const ReferenceSettings& cfg)
+    {
+        chain.Clear();
+        chain.Add<Particles::LifetimeAffector>();
+        chain.Add<Particles::GravityAffector>(cfg.gravity);
+        chain.Add<Particles::LinearDragAffector>(cfg.damping);
+        chain.Add<Particles::DragAffector>(cfg.dragCoefficient);
+        auto vortex = chain.Add<Particles::VortexAffector>();
+        vortex->center = cfg.vortexCenter;
+        vortex->strength = cfg.vortexStrength;
+        vortex->radius = cfg.vortexRadius;
+        auto noise = chain.Add<Particles::NoiseForceAffector>();
+        noise->strength = cfg.noiseStrength;
+        noise->frequency = cfg.noiseFrequency;
+        noise->scrollSpeed = cfg.noiseSpeed;
+        auto attractor = chain.Add<Particles::AttractorAffector>();
+        attractor->position = cfg.attractorPosition;
+        attractor->strength = cfg.attractorStrength;
+        attractor->radius = cfg.attractorRadius;
+        auto limit = chain.Add<Particles::VelocityLimitAffector>();
+        limit->maxSpeed = cfg.maxSpeed;
+        chain.Add<Particles::VelocityAffector>();
+        chain.Add<Particles::ColorOverLifetimeAffector>();
+        chain.Add<Particles::SizeOverLifetimeAffector>();
+        chain.Add<Particles::RotationAffector>();
+        auto fade = chain.Add<Particles::AlphaFadeAffector>();
+        fade->fadeInTime = cfg.fadeIn;
+        fade->fadeOutTime = cfg.fadeOut;
+        auto frames = chain.Add<Particles::SequenceFrameAnimationAffector>();
+        frames->frameCount = cfg.frameCount;
+        auto plane = chain.Add<Particles::PlaneCollisionAffector>();
+        plane->planePoint = cfg.planePoint;
+        plane->planeNormal = cfg.planeNormal;
+        plane->bounciness = 0.5f;
+        plane->friction = 0.1f;
+    }
+
+    inline ReferenceParticle RandomParticle(ParticleRandomGenerator& gen)
+    {
+        ReferenceParticle p;
+        p.position = {gen.RandomFloat(-120.0f, 120.0f), gen.RandomFloat(-120.0f, 120.0f), 0.0f};
+        p.velocity = {gen.RandomFloat(-200.0f, 200.0f), gen.RandomFloat(-200.0f, 200.0f), 0.0f};
+        p.lifetime = gen.RandomFloat(0.2f, 3.0f);
+        p.age = gen.RandomFloat(0.0f, p.lifetime * 0.5f);
+        p.rotation = gen.RandomFloat(-3.0f, 3.0f);
+        p.angularVelocity = gen.RandomFloat(-5.0f, 5.0f);
+        p.startColor = {gen.RandomFloat(0, 1), gen.RandomFloat(0, 1), gen.RandomFloat(0, 1), gen.RandomFloat(0, 1)};
+        p.endColor = {gen.RandomFloat(0, 1), gen.RandomFloat(0, 1), gen.RandomFloat(0, 1), gen.RandomFloat(0, 1)};
+        p.startSize = {gen.RandomFloat(1, 16), gen.RandomFloat(1, 16)};
+        p.endSize = {gen.RandomFloat(0, 16), gen.RandomFloat(0, 16)};
+        p.color = p.startColor;
+        p.size = p.startSize;
+        return p;
+    }
+
+    inline Particles::ParticleData ToParticleData(const ReferenceParticle& r)
+    {
+        Particles::ParticleData p;
+        p.position = glm::vec2(r.position);
+        p.velocity = glm::vec2(r.velocity);
+        p.age = r.age;
+        p.lifetime = r.lifetime;
+        p.color = r.color;
+        p.size = r.size;
+        p.rotation = r.rotation;
+        p.angularVelocity = r.angularVelocity;
+        p.startColor = r.startColor;
+        p.endColor = r.endColor;
+        p.startSize = r.startSize;
+        p.endSize = r.endSize;
+        return p;
+    }
+
+    inline bool Near(float a, float b, float tolerance)
+    {
+        return std::abs(a - b) <= tolerance * std::max(1.0f, std::max(std::abs(a), std::abs(b)));
+    }
+
+    /**
+     * @brief Property: SoA 批处理内核与标量参考结果一致
+     *
+     * For any particle set, simulating N frames with the batch affector chain gives
+     * the same live particles as the scalar per-particle reference (within 1e-3
+     * relative tolerance).
+     */
+    inline TestResult TestProperty_KernelsMatchScalarReference(int iterations = 100, int frames = 30)
+    {
+        TestResult result;
+        ParticleRandomGenerator gen(4242u);
+        ReferenceSettings cfg;
+        Particles::AffectorChain chain;
+        BuildChain(chain, cfg);
+        const float dt = 1.0f / 60.0f;
+
+        for (int i = 0; i < iterations; ++i)
+        {
+            const int count = gen.RandomInt(1, 1200);
+            std::vector<ReferenceParticle> reference;
+            Particles::ParticlePool pool(count);
+            for (int p = 0; p < count; ++p)
+            {
+                reference.push_back(RandomParticle(gen));
+                pool.Emit(ToParticleData(reference.back()));
+            }
+
+            for (int frame = 0; frame < frames; ++frame)
+            {
+                ReferenceStep(reference, cfg, dt);
+                chain.UpdateBatch(pool.GetStreams(), dt);
+
+                for (size_t p = 0; p < reference.size(); ++p)
+                {
+                    const ReferenceParticle& expected = reference[p];
+                    if (expected.IsDead()) continue;
+                    const Particles::ParticleData actual = pool.Get(p);
+                    const bool same = actual.IsDead() == expected.IsDead() &&
+                        Near(actual.position.x, expected.position.x, 1e-3f) &&
+                        Near(actual.position.y, expected.position.y, 1e-3f) &&
+                        Near(actual.velocity.x, expected.velocity.x, 1e-3f) &&
+                        Near(actual.velocity.y, expected.velocity.y, 1e-3f) &&
+                        Near(actual.rotation, expected.rotation, 1e-4f) &&
+                        Near(actual.color.r, expected.color.r, 1e-4f) &&
+                        Near(actual.color.a, expected.color.a, 1e-4f) &&
+                        Near(actual.size.x, expected.size.x, 1e-4f) &&
+                        Near(actual.size.y, expected.size.y, 1e-4f);
+                    if (!same)
+                    {
+                        result.passed = false;
+                        result.failedIteration = i;
+                        std::ostringstream oss;
+                        oss << "Frame " << frame << " particle " << p << ": SoA position ("
+                            << actual.position.x << ", " << actual.position.y << ") velocity ("
+                            << actual.velocity.x << ", " << actual.velocity.y << ") vs reference ("
+                            << expected.position.x << ", " << expected.position.y << ") ("
+                            << expected.velocity.x << ", " << expected.velocity.y << ")";
+                        result.failureMessage = oss.str();
+                        return result;
+                    }
+                }
+            }
+        }
+        return result;
+    }
+
+    /**
+     * @brief 掩码内核改写前的逐粒子标量循环，作为参考。
+     */
+    inline void ScalarAttractor(Particles::ParticleStreams& s, const glm::vec2& center, float strength, float radius,
+                                float falloff, float deltaTime)
+    {
+        for (size_t i = 0; i < s.count; ++i)
+        {
+            const float dx = center.x - s.positionX[i];
+            const float dy = center.y - s.positionY[i];
+            const float distance = std::sqrt(dx * dx + dy * dy);
+            if (distance < 0.001f || distance > radius) continue;
+            const float scale = strength * std::pow(1.0f - distance / radius, falloff) * deltaTime / distance;
+            s.velocityX[i] += dx * scale;
+            s.velocityY[i] += dy * scale;
+        }
+    }
+
+    inline void ScalarVortex(Particles::ParticleStreams& s, const glm::vec2& center, float axisZ, float strength,
+                             float radius, float deltaTime)
+    {
+        for (size_t i = 0; i < s.count; ++i)
+        {
+            const float dx = s.positionX[i] - center.x;
+            const float dy = s.positionY[i] - center.y;
+            const float distance = std::sqrt(dx * dx + dy * dy);
+            if (distance < 0.001f || distance > radius) continue;
+            const float scale = axisZ * strength * (1.0f - distance / radius) * deltaTime / distance;
+            s.velocityX[i] -= dy * scale;
+            s.velocityY[i] += dx * scale;
+        }
+    }
+
+    inline void ScalarNoiseForce(Particles::ParticleStreams& s, float strength, float frequency, float scrollSpeed,
+                                 float deltaTime)
+    {
+        for (size_t i = 0; i < s.count; ++i)
+        {
+            const float time = s.age[i] * scrollSpeed;
+            const float nx = s.positionX[i] * frequency + time;
+            const float ny = s.positionY[i] * frequency + time;
+            s.velocityX[i] += std::sin(ny * 2.1f + time * 1.3f) * std::cos(nx * 1.7f + time) * strength * deltaTime;
+            s.velocityY[i] += std::sin(time * 2.3f + nx * 1.5f) * std::cos(ny * 1.9f + time * 1.1f) * strength *
+                              deltaTime;
+        }
+    }
+
+    inline void ScalarPlaneCollision(Particles::ParticleStreams& s, const glm::vec2& planePoint,
+                                     const glm::vec2& planeNormal, float bounciness, float friction,
+                                     bool killOnCollision)
+    {
+        for (size_t i = 0; i < s.count; ++i)
+        {
+            const float distance = (s.positionX[i] - planePoint.x) * planeNormal.x +
+                                   (s.positionY[i] - planePoint.y) * planeNormal.y;
+            if (distance >= 0.0f) continue;
+            if (killOnCollision)
+            {
+                s.age[i] = s.lifetime[i];
+                continue;
+            }
+            s.positionX[i] -= planeNormal.x * distance;
+            s.positionY[i] -= planeNormal.y * distance;
+            const float normalVelocity = s.velocityX[i] * planeNormal.x + s.velocityY[i] * planeNormal.y;
+            if (normalVelocity < 0.0f)
+            {
+                const float nx = planeNormal.x * normalVelocity;
+                const float ny = planeNormal.y * normalVelocity;
+                s.velocityX[i] = (s.velocityX[i] - nx) * (1.0f - friction) - nx * bounciness;
+                s.velocityY[i] = (s.velocityY[i] - ny) * (1.0f - friction) - ny * bounciness;
+            }
+        }
+    }
+
+    /**
+     * @brief Property: 掩码内核与逐粒子标量循环结果一致
+     *
+     * Each kernel runs once on a random pool and once through the scalar loop above. The parameters
+     * cover integer and fractional falloffs, both plane modes and any plane orientation, and the pools
+     * include particles exactly at the centre, on the radius and on the plane, where the masks switch.
+     */
+    inline TestResult TestProperty_MaskedKernelsMatchScalarLoops(int iterations = 200)
+    {
+        TestResult result;
+        ParticleRandomGenerator gen(4343u);
+        static const float falloffs[] = {0.0f, 1.0f, 2.0f, 3.0f, 8.0f, 0.5f, 1.7f, 9.0f};
+
+        for (int i = 0; i < iterations; ++i)
+        {
+            const glm::vec2 center(gen.RandomFloat(-50.0f, 50.0f), gen.RandomFloat(-50.0f, 50.0f));
+            const float radius = gen.RandomFloat(10.0f, 150.0f);
+            const float angle = gen.RandomFloat(0.0f, 6.2831853f);
+            const glm::vec2 normal(std::cos(angle), std::sin(angle));
+
+            Particles::ParticlePool pool;
+            const int count = gen.RandomInt(1, 700);
+            for (int p = 0; p < count; ++p)
+            {
+                Particles::ParticleData data = ToParticleData(RandomParticle(gen));
+                switch (gen.RandomInt(0, 9))
+                {
+                case 0: data.position = center; break;
+                case 1: data.position = center + glm::vec2(radius, 0.0f); break;
+                case 2: data.position = center + glm::vec2(0.0f, 0.0005f); break;
+                case 3: data.position = center + normal * 1e-6f; break;
+                default: break;
+                }
+                pool.Emit(data);
+            }
+            Particles::ParticleStreams actual = pool.GetStreams();
+            Particles::ParticleStreams expected = actual;
+            const float dt = 1.0f / 60.0f;
+
+            const char* kernel = nullptr;
+            switch (i % 4)
+            {
+            case 0:
+            {
+                kernel = "ApplyAttractor";
+                const float falloff = falloffs[gen.RandomInt(0, 7)];
+                const float strength = gen.RandomFloat(-100.0f, 100.0f);
+                Particles::Kernels::ApplyAttractor(actual, center, strength, radius, falloff, dt);
+                ScalarAttractor(expected, center, strength, radius, falloff, dt);
+                break;
+            }
+            case 1:
+            {
+                kernel = "ApplyVortex";
+                const float axisZ = gen.RandomInt(0, 1) ? 1.0f : -1.0f;
+                const float strength = gen.RandomFloat(-50.0f, 50.0f);
+                Particles::Kernels::ApplyVortex(actual, center, axisZ, strength, radius, dt);
+                ScalarVortex(expected, center, axisZ, strength, radius, dt);
+                break;
+            }
+            case 2:
+            {
+                kernel = "ApplyNoiseForce";
+                const float strength = gen.RandomFloat(0.0f, 50.0f);
+                const float frequency = gen.RandomFloat(0.01f, 3.0f);
+                const float scroll = gen.RandomFloat(0.0f, 5.0f);
+                Particles::Kernels::ApplyNoiseForce(actual, strength, frequency, scroll, dt);
+                ScalarNoiseForce(expected, strength, frequency, scroll, dt);
+                break;
+            }
+            default:
+            {
+                kernel = "PlaneCollision";
+                const float bounciness = gen.RandomFloat(0.0f, 1.0f);
+                const float friction = gen.RandomFloat(0.0f, 1.0f);
+                const bool kill = gen.RandomInt(0, 2) == 0;
+                Particles::Kernels::PlaneCollision(actual, center, normal, bounciness, friction, kill);
+                ScalarPlaneCollision(expected, center, normal, bounciness, friction, kill);
+                break;
+            }
+            }
+
+            for (size_t p = 0; p < actual.count; ++p)
+            {
+                if (!Near(actual.positionX[p], expected.positionX[p], 1e-5f) ||
+                    !Near(actual.positionY[p], expected.positionY[p], 1e-5f) ||
+                    !Near(actual.velocityX[p], expected.velocityX[p], 1e-4f) ||
+                    !Near(actual.velocityY[p], expected.velocityY[p], 1e-4f) || actual.age[p] != expected.age[p])
+                {
+                    std::ostringstream oss;
+                    oss << kernel << ": particle " << p << " ends at (" << actual.positionX[p] << ", "
+                        << actual.positionY[p] << "), scalar loop at (" << expected.positionX[p] << ", "
+                        << expected.positionY[p] << "); velocity (" << actual.velocityX[p] << ", "
+                        << actual.velocityY[p] << "), scalar loop gives (" << expected.velocityX[p] << ", "
+                        << expected.velocityY[p] << ")";
+                    result.passed = false;
+                    result.failedIteration = i;
+                    result.failureMessage = oss.str();
+                    return result;
+                }
+            }
+        }
+        return result;
+    }
+
+    /**
+     * @brief Property: 交换压缩恰好移除死亡粒子，且保留全部存活粒子
+     */
+    inline TestResult TestProperty_RemoveDeadKeepsSurvivors(int iterations = 100)
+    {
+        TestResult result;
+        ParticleRandomGenerator gen(99u);
+
+        for (int i = 0; i < iterations; ++i)
+        {
+            Particles::ParticlePool pool;
+            const int count = gen.RandomInt(0, 500);
+            std::vector<float> expectedIds;
+            for (int p = 0; p < count; ++p)
+            {
+                Particles::ParticleData data;
+                data.lifetime = 1.0f;
+                data.age = gen.RandomInt(0, 2) == 0 ? 1.5f : 0.25f;
+                data.mass = static_cast<float>(p);
+                if (!data.IsDead()) expectedIds.push_back(data.mass);
+                pool.Emit(data);
+            }
+
+            const size_t removed = pool.RemoveDeadParticles();
+            std::vector<float> ids(pool.GetStreams().mass.begin(), pool.GetStreams().mass.end());
+            std::sort(ids.begin(), ids.end());
+
+            if (removed != count - expectedIds.size() || ids != expectedIds)
+            {
+                result.passed = false;
+                result.failedIteration = i;
+                result.failureMessage = "Compaction removed " + std::to_string(removed) + " particles, kept " +
+                                        std::to_string(ids.size()) + ", expected " +
+                                        std::to_string(expectedIds.size()) + " survivors";
+                return result;
+            }
+        }
+        return result;
+    }
+
+    /**
+     * @brief 1M 粒子基准：对比 SoA 批处理内核与标量 AoS 参考的每帧耗时。
+     */
+    inline void RunParticleKernelBenchmark(size_t particleCount = 1000000, int frames = 10)
+    {
+        ParticleRandomGenerator gen(7u);
+        ReferenceSettings cfg;
+        Particles::AffectorChain chain;
+        BuildChain(chain, cfg);
+        const float dt = 1.0f / 60.0f;
+
+        std::vector<ReferenceParticle> reference;
+        reference.reserve(particleCount);
+        Particles::ParticlePool pool(particleCount);
+        for (size_t p = 0; p < particleCount; ++p)
+        {
+            ReferenceParticle particle = RandomParticle(gen);
+            particle.lifetime = 1000.0f;
+            reference.push_back(particle);
+            pool.Emit(ToParticleData(particle));
+        }
+
+        using Clock = std::chrono::high_resolution_clock;
+        auto start = Clock::now();
+        for (int frame = 0; frame < frames; ++frame)
+        {
+            ReferenceStep(reference, cfg, dt);
+        }
+        const double scalarMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count() / frames;
+
+        start = Clock::now();
+        for (int frame = 0; frame < frames; ++frame)
+        {
+            chain.UpdateBatch(pool.GetStreams(), dt);
+        }
+        const double soaMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count() / frames;
+
+        LogInfo("Particle kernels ({}): {} particles, scalar AoS {:.2f} ms/frame, SoA batch {:.2f} ms/frame ({:.2f}x)",
+                SIMD::GetInstance().GetSupportedInstructions(), particleCount, scalarMs, soaMs,
+                soaMs > 0.0 ? scalarMs / soaMs : 0.0);
+    }
+
+    inline bool RunTest(const char* name, const TestResult& result)
+    {
+        if (result.passed)
+        {
+            LogInfo("{} PASSED", name);
+            return true;
+        }
+        LogError("{} FAILED at iteration {}: {}", name, result.failedIteration, result.failureMessage);
+        return false;
+    }
+
+    /**
+     * @brief Run all particle kernel tests
+     *
+     * @return true if all tests pass, false otherwise
+     */
+    inline bool RunAllParticleKernelTests()
+    {
+        LogInfo("=== Running Particle Kernel Tests ===");
+
+        bool allPassed = true;
+        allPassed &= RunTest("SoA kernels match scalar reference", TestProperty_KernelsMatchScalarReference());
+        allPassed &= RunTest("Masked kernels match scalar loops", TestProperty_MaskedKernelsMatchScalarLoops());
+        allPassed &= RunTest("Dead particle compaction keeps survivors", TestProperty_RemoveDeadKeepsSurvivors());
+
+        LogInfo("=== Particle Kernel Tests Complete ===");
+        return allPassed;
+    }
+}
+
+#endif // PARTICLE_KERNEL_TESTS_H
@@ -0,0 +1,226 @@
+#include "AssetPackage.h"
+#include "../Utils/BlockCompressor.h"
+#include "../Utils/Logger.h"
+#include "../Utils/Path.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+using namespace AssetPackageFormat;
+
+namespace
+{
+    bool ReadManifest(const std::filesystem::path& manifestPath, std::vector<std::string>& outFileNames)
+    {
+        std::ifstream manifestFile(manifestPath);
+        if (!manifestFile) return false;
+
+        std::string fileName;
+        while (std::getline(manifestFile, fileName))
+        {
+            if (!fileName.empty() && fileName.back() == '\r')
+                fileName.pop_back();
+            if (!fileName.empty())
+                outFileNames.push_back(fileName);
+        }
+        return true;
+    }
+}
+
+bool AssetPackage::Open(const std::filesystem::path& manifestPath)
+{
+    Close();
+
+    std::vector<std::string> fileNames;
+    if (!ReadManifest(manifestPath, fileNames))
+    {
+        LogError("AssetPackage: 无法打开包清单 {}", manifestPath.string());
+        return false;
+    }
+
+    const std::filesystem::path directory = manifestPath.parent_path();
+    if (!m_index.Open(directory / IndexFileName))
+    {
+        LogError("AssetPackage: 无法打开包索引 {}", (directory / IndexFileName).string());
+        return false;
+    }
+
+    IndexHeader header;
+    if (m_index.Size() < sizeof(IndexHeader) + MacSize)
+    {
+        LogError("AssetPackage: 包索引已截断");
+        Close();
+        return false;
+    }
+    std::memcpy(&header, m_index.Data(), sizeof(header));
+    const size_t tableSize = static_cast<size_t>(header.entryCount) * sizeof(IndexEntry);
+    if (header.magic != Magic || header.version != Version || header.fileCount != fileNames.size() ||
+        m_index.Size() != sizeof(IndexHeader) + tableSize + MacSize)
+    {
+        LogError("AssetPackage: 包索引格式不符或已截断");
+        Close();
+        return false;
+    }
+
+    auto& crypto = EngineCrypto::GetInstance();
+    m_keys = crypto.DeriveRecordKeys(std::vector<unsigned char>(header.salt, header.salt + SaltSize));
+    const size_t macOffset = sizeof(IndexHeader) + tableSize;
+    if (!crypto.VerifyRecordMac(m_keys, m_index.Data(), macOffset, m_index.Data() + macOffset))
+    {
+        LogError("AssetPackage: 包索引校验失败 (MAC mismatch)");
+        Close();
+        return false;
+    }
+
+    for (const auto& fileName : fileNames)
+    {
+        auto file = std::make_unique<MappedFile>();
+        // 空数据文件无法映射，但也不会被任何记录引用
+        std::error_code ec;
+        if (!file->Open(directory / fileName) && std::filesystem::file_size(directory / fileName, ec) != 0)
+        {
+            LogError("AssetPackage: 无法打开数据文件 {}", fileName);
+            Close();
+            return false;
+        }
+        m_files.push_back(std::move(file));
+    }
+
+    m_entries = reinterpret_cast<const IndexEntry*>(m_index.Data() + sizeof(IndexHeader));
+    m_entryCount = header.entryCount;
+    return true;
+}
+
+void AssetPackage::Close()
+{
+    m_index.Close();
+    m_files.clear();
+    m_keys = {};
+    m_entries = nullptr;
+    m_entryCount = 0;
+}
+
+const IndexEntry* AssetPackage::Find(const Guid& guid) const
+{
+    const uint8_t* key = guid.GetBytes().data();
+    const IndexEntry* end = m_entries + m_entryCount;
+    const IndexEntry* it = std::lower_bound(m_entries, end, key, [](const IndexEntry& entry, const uint8_t* k)
+    {
+        return std::memcmp(entry.guid, k, sizeof(entry.guid)) < 0;
+    });
+    if (it == end || std::memcmp(it->guid, key, sizeof(it->guid)) != 0) return nullptr;
+    return it;
+}
+
+AssetPackage::ReadResult AssetPackage::Read(const Guid& guid, std::vector<uint8_t>& outData) const
+{
+    const IndexEntry* entry = Find(guid);
+    if (!entry) return ReadResult::Missing;
+    return Read(*entry, outData);
+}
+
+AssetPackage::ReadResult AssetPackage::Read(const IndexEntry& entry, std::vector<uint8_t>& outData) const
+{
+    if (entry.file >= m_files.size()) return ReadResult::Corrupt;
+    const MappedFile& file = *m_files[entry.file];
+    if (entry.offset > file.Size() || entry.size > file.Size() - entry.offset) return ReadResult::Corrupt;
+
+    std::vector<unsigned char> plain;
+    if (!EngineCrypto::GetInstance().DecryptRecord(m_keys, file.Data() + entry.offset, entry.size, entry.mac, plain))
+        return ReadResult::Corrupt;
+
+    if (!(entry.flags & Compressed))
+    {
+        if (plain.size() != entry.rawSize) return ReadResult::Corrupt;
+        outData.assign(plain.begin(), plain.end());
+        return ReadResult::Ok;
+    }
+    outData.resize(entry.rawSize);
+    if (!BlockCompressor::Decompress(plain.data(), plain.size(), outData.data(), outData.size()))
+        return ReadResult::Corrupt;
+    return ReadResult::Ok;
+}
+
+AssetPackageBuilder::AssetPackageBuilder()
+{
+    auto& crypto = EngineCrypto::GetInstance();
+    m_salt = crypto.GenerateSalt();
+    m_keys = crypto.DeriveRecordKeys(m_salt);
+}
+
+void AssetPackageBuilder::Add(const Guid& guid, const std::vector<uint8_t>& data)
+{
+    Record record;
+    std::memcpy(record.entry.guid, guid.GetBytes().data(), sizeof(record.entry.guid));
+    record.entry.rawSize = static_cast<uint32_t>(data.size());
+
+    std::vector<uint8_t> compressed;
+    BlockCompressor::Compress(data.data(), data.size(), compressed);
+    const bool useCompressed = compressed.size() < data.size();
+    if (useCompressed) record.entry.flags |= Compressed;
+    const std::vector<uint8_t>& plain = useCompressed ? compressed : data;
+
+    record.data = EngineCrypto::GetInstance().EncryptRecord(m_keys, plain.data(), plain.size(), record.entry.mac);
+    record.entry.size = static_cast<uint32_t>(record.data.size());
+    m_records[guid.GetBytes()] = std::move(record);
+}
+
+bool AssetPackageBuilder::Write(const std::filesystem::path& directory, int fileCount) const
+{
+    size_t totalSize = 0;
+    for (const auto& [guid, record] : m_records)
+        totalSize += record.data.size();
+    const size_t maxFiles = std::clamp<size_t>(m_records.size(), 1, UINT16_MAX);
+    const size_t files = std::clamp<size_t>(static_cast<size_t>(std::max(fileCount, 1)), 1, maxFiles);
+
+    std::vector<unsigned char> index(sizeof(IndexHeader) + m_records.size() * sizeof(IndexEntry) + MacSize);
+    IndexHeader header;
+    header.entryCount = static_cast<uint32_t>(m_records.size());
+    header.fileCount = static_cast<uint32_t>(files);
+    std::copy(m_salt.begin(), m_salt.end(), header.salt);
+    std::memcpy(index.data(), &header, sizeof(header));
+
+    // 按字节数均分，记录不会跨文件
+    std::vector<std::string> fileNames;
+    std::vector<unsigned char> fileData;
+    size_t slot = 0;
+    size_t written = 0;
+    for (auto it = m_records.begin(); fileNames.size() < files; )
+    {
+        const size_t fileIndex = fileNames.size();
+        const size_t target = totalSize * (fileIndex + 1) / files;
+        fileData.clear();
+        for (; it != m_records.end() && (written < target || fileIndex + 1 == files); ++it, ++slot)
+        {
+            IndexEntry entry = it->second.entry;
+            entry.file = static_cast<uint16_t>(fileIndex);
+            entry.offset = fileData.size();
+            std::memcpy(index.data() + sizeof(IndexHeader) + slot * sizeof(IndexEntry), &entry, sizeof(entry));
+            fileData.insert(fileData.end(), it->second.data.begin(), it->second.data.end());
+            written += it->second.data.size();
+        }
+
+        std::string fileName = Guid::NewGuid().ToString() + ".luma_pack";
+        if (!Path::WriteAllBytes((directory / fileName).string(), fileData))
+        {
+            LogError("AssetPackageBuilder: 写入数据文件失败 {}", fileName);
+            return false;
+        }
+        fileNames.push_back(std::move(fileName));
+    }
+
+    const size_t macOffset = index.size() - MacSize;
+    EngineCrypto::GetInstance().ComputeRecordMac(m_keys, index.data(), macOffset, index.data() + macOffset);
+    if (!Path::WriteAllBytes((directory / IndexFileName).string(), index))
+    {
+        LogError("AssetPackageBuilder: 写入包索引失败");
+        return false;
+    }
+
+    std::ofstream manifestFile(directory / ManifestFileName);
+    for (const auto& name : fileNames)
+    {
+        manifestFile << name << std::endl;
+    }
+    return static_cast<bool>(manifestFile);
+}
@@ -0,0 +1,142 @@
+#ifndef ASSETPACKAGE_H
+#define ASSETPACKAGE_H
+
+#include "../Utils/EngineCrypto.h"
+#include "../Utils/Guid.h"
+#include "../Utils/MappedFile.h"
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @brief 资源包格式。
+ *
+ * package.manifest 逐行列出数据文件名，package.index 由头部、按 GUID 字节序排列的索引表和索引 MAC 组成。
+ * 每个资产是数据文件中一条独立的 AES-256-GCM 记录（nonce + 密文），明文先经 LZ 块压缩（只在变小时使用）；
+ * 记录的认证标签保存在索引条目中，索引 MAC 覆盖头部与整张表，因此替换、交换或截断记录都能被发现。
+ */
+namespace AssetPackageFormat
+{
+    constexpr uint32_t Magic = 0x4B504D4C; // "LMPK"
+    constexpr uint32_t Version = 3;
+    constexpr size_t SaltSize = 16;
+    constexpr size_t MacSize = EngineCrypto::RecordMacSize;
+    constexpr const char* ManifestFileName = "package.manifest";
+    constexpr const char* IndexFileName = "package.index";
+
+    enum EntryFlags : uint16_t
+    {
+        Compressed = 1 << 0
+    };
+
+    struct IndexHeader
+    {
+        uint32_t magic = Magic;
+        uint32_t version = Version;
+        uint32_t entryCount = 0;
+        uint32_t fileCount = 0;
+        uint8_t salt[SaltSize] = {};
+    };
+
+    struct IndexEntry
+    {
+        uint8_t guid[16] = {};
+        uint64_t offset = 0;   ///< 记录在数据文件中的偏移。
+        uint32_t size = 0;     ///< 记录字节数（nonce + 密文）。
+        uint32_t rawSize = 0;  ///< 解压后的字节数。
+        uint16_t file = 0;     ///< 清单中的第几个数据文件。
+        uint16_t flags = 0;
+        uint32_t reserved = 0;
+        uint8_t mac[MacSize] = {}; ///< 记录的认证标签。
+    };
+
+    static_assert(sizeof(IndexHeader) == 32);
+    static_assert(sizeof(IndexEntry) == 56);
+}
+
+/**
+ * @brief 资源包的只读视图。索引与数据文件通过内存映射打开，读取单个资产只解密并解压对应的一条记录。
+ *
+ * Open 之后的读取不修改状态，可在多个线程上同时进行。
+ */
+class LUMA_API AssetPackage
+{
+public:
+    enum class ReadResult
+    {
+        Ok,
+        Missing,  ///< 包中没有该资产。
+        Corrupt   ///< 记录越界、认证失败或解压失败。
+    };
+
+    AssetPackage() = default;
+    ~AssetPackage() = default;
+
+    AssetPackage(const AssetPackage&) = delete;
+    AssetPackage& operator=(const AssetPackage&) = delete;
+
+    /**
+     * @brief 打开清单所在目录中的包，并校验索引 MAC。
+     * @return 文件缺失、格式不符或索引被改动时返回 false
+     */
+    bool Open(const std::filesystem::path& manifestPath);
+    void Close();
+
+    bool IsOpen() const { return m_index.IsOpen(); }
+    size_t GetAssetCount() const { return m_entryCount; }
+    /// 按 GUID 字节序排列的索引表。
+    const AssetPackageFormat::IndexEntry* GetEntries() const { return m_entries; }
+
+    /// 二分查找，未找到时返回 nullptr。
+    const AssetPackageFormat::IndexEntry* Find(const Guid& guid) const;
+
+    ReadResult Read(const Guid& guid, std::vector<uint8_t>& outData) const;
+    ReadResult Read(const AssetPackageFormat::IndexEntry& entry, std::vector<uint8_t>& outData) const;
+
+private:
+    MappedFile m_index;
+    std::vector<std::unique_ptr<MappedFile>> m_files;
+    EngineCrypto::RecordKeys m_keys;
+    const AssetPackageFormat::IndexEntry* m_entries = nullptr;
+    size_t m_entryCount = 0;
+};
+
+/**
+ * @brief 组装资源包。Add 时即压缩并加密记录，Write 一次写出全部文件。
+ */
+class LUMA_API AssetPackageBuilder
+{
+public:
+    AssetPackageBuilder();
+
+    /**
+     * @brief 添加一个资产，同一 GUID 重复添加时保留最后一次的数据。
+     */
+    void Add(const Guid& guid, const std::vector<uint8_t>& data);
+    size_t GetAssetCount() const { return m_records.size(); }
+
+    /**
+     * @brief 把记录按顺序切分到 fileCount 个随机命名的数据文件，再写出索引与清单。
+     * @param directory 输出目录
+     * @param fileCount 数据文件数量，会被限制在 [1, 资产数] 内
+     * @return 写入失败时返回 false
+     */
+    bool Write(const std::filesystem::path& directory, int fileCount) const;
+
+private:
+    struct Record
+    {
+        AssetPackageFormat::IndexEntry entry;
+        std::vector<unsigned char> data;
+    };
+
+    std::vector<unsigned char> m_salt;
+    EngineCrypto::RecordKeys m_keys;
+    std::map<std::array<uint8_t, 16>, Record> m_records; ///< 按 GUID 字节序排列。
+};
+
+#endif
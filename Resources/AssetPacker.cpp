@@ -1,5 +1,6 @@
 #include "AssetPacker.h"
 #include "AssetManager.h"
+#include "AssetPackage.h"
 #include "../Utils/EngineCrypto.h"
 #include "../Utils/Logger.h"
 #include "../Utils/Path.h"
@@ -161,117 +162,31 @@ bool AssetPacker::Pack(const std::unordered_map<std::string, AssetMetadata>& ass
             return true;
         }
 
-        
-        nlohmann::json rootJson = nlohmann::json::object();
-        nlohmann::json indexJson = nlohmann::json::array();
-
-        try
-        {
-            size_t currentOffset = 0;
-            for (const auto& [guid, metadata] : db)
-            {
-                try
-                {
-                    nlohmann::json metaJson;
-                    to_json(metaJson, metadata);
-
-                    
-                    std::vector<uint8_t> singleAssetData = nlohmann::json::to_msgpack(metaJson);
-
-                    
-                    nlohmann::json indexEntry;
-                    indexEntry["guid"] = guid;
-                    indexEntry["offset"] = currentOffset;
-                    indexEntry["size"] = singleAssetData.size();
-                    indexJson.push_back(indexEntry);
-
-                    rootJson[guid] = std::move(metaJson);
-                    currentOffset += singleAssetData.size();
-                }
-                catch (const std::exception& e)
-                {
-                    LogError("AssetPacker: 序列化资产失败 {}: {}", guid, e.what());
-                    throw;
-                }
-            }
-        }
-        catch (const std::exception& e)
+        // 每个资产单独序列化、压缩并加密，运行时按 GUID 只解码请求的那一条
+        AssetPackageBuilder builder;
+        for (const auto& [guid, metadata] : db)
         {
-            LogError("AssetPacker: 序列化失败: {}", e.what());
-            throw;
-        }
-
-        LogInfo("AssetPacker: 已序列化 {} 个资产到JSON", rootJson.size());
-
-        
-        std::vector<uint8_t> binaryData;
-        std::vector<uint8_t> indexData;
-        try
-        {
-            binaryData = nlohmann::json::to_msgpack(rootJson);
-            indexData = nlohmann::json::to_msgpack(indexJson);
-        }
-        catch (const std::exception& e)
-        {
-            LogError("AssetPacker: MessagePack转换失败: {}", e.what());
-            throw;
-        }
-
-        
-        std::vector<unsigned char> packageData(binaryData.begin(), binaryData.end());
-        auto encryptedPackage = EngineCrypto::GetInstance().Encrypt(packageData);
-
-        
-        std::vector<unsigned char> indexPackageData(indexData.begin(), indexData.end());
-        auto encryptedIndex = EngineCrypto::GetInstance().Encrypt(indexPackageData);
-
-        LogInfo("AssetPacker: 序列化数据库大小: {} 字节, 加密大小: {} 字节, 索引大小: {} 字节",
-                packageData.size(), encryptedPackage.size(), encryptedIndex.size());
-
-        if (encryptedPackage.empty())
-        {
-            throw std::runtime_error("Encryption resulted in an empty package.");
-        }
-
-        
-        Path::WriteAllBytes((outputPath / "package.index").string(), encryptedIndex);
-
-        
-        std::vector<std::string> chunkFileNames;
-        std::mt19937 rng(std::random_device{}());
-        int numChunks = std::uniform_int_distribution<>(1, std::min((int)encryptedPackage.size(), maxChunks))(rng);
-        size_t remainingSize = encryptedPackage.size();
-        size_t offset = 0;
-
-        for (int i = 0; i < numChunks; ++i)
-        {
-            size_t chunkSize;
-            if (i == numChunks - 1)
+            try
             {
-                chunkSize = remainingSize;
+                nlohmann::json metaJson;
+                to_json(metaJson, metadata);
+                builder.Add(metadata.guid.Valid() ? metadata.guid : Guid::FromString(guid),
+                            nlohmann::json::to_msgpack(metaJson));
             }
-            else
+            catch (const std::exception& e)
             {
-                size_t minChunkSize = 1;
-                size_t maxChunkSize = remainingSize - (numChunks - 1 - i);
-                chunkSize = std::uniform_int_distribution<size_t>(minChunkSize, maxChunkSize)(rng);
+                LogError("AssetPacker: 序列化资产失败 {}: {}", guid, e.what());
+                throw;
             }
-
-            std::string chunkFileName = Guid::NewGuid().ToString() + ".luma_pack";
-            chunkFileNames.push_back(chunkFileName);
-
-            Path::WriteAllBytes((outputPath / chunkFileName).string(),
-                                {encryptedPackage.data() + offset, encryptedPackage.data() + offset + chunkSize});
-
-            offset += chunkSize;
-            remainingSize -= chunkSize;
         }
 
-        
-        std::ofstream manifestFile(outputPath / "package.manifest");
-        for (const auto& name : chunkFileNames)
+        LogInfo("AssetPacker: 已序列化 {} 个资产", builder.GetAssetCount());
+
+        std::mt19937 rng(std::random_device{}());
+        const int numChunks = std::uniform_int_distribution<>(1, std::max(1, maxChunks))(rng);
+        if (!builder.Write(outputPath, numChunks))
         {
-            manifestFile << name << std::endl;
+            throw std::runtime_error("Failed to write asset package.");
         }
 
         if (!SaveAddressablesIndex(assetDatabase, outputPath))
@@ -279,7 +194,7 @@ bool AssetPacker::Pack(const std::unordered_map<std::string, AssetMetadata>& ass
             LogWarn("AssetPacker: Addressables 索引写入失败");
         }
 
-        LogInfo("AssetPacker: 打包完成,已创建 {} 个数据块", chunkFileNames.size());
+        LogInfo("AssetPacker: 打包完成,已创建 {} 个数据块", std::min<size_t>(numChunks, builder.GetAssetCount()));
         return true;
     }
     catch (const std::exception& e)
@@ -333,77 +248,24 @@ bool AssetPacker::SaveAddressablesIndex(const std::unordered_map<std::string, As
     }
 }
 
-std::vector<unsigned char> AssetPacker::ReadChunkFile(const std::filesystem::path& chunkPath)
+std::shared_ptr<const AssetPackage> AssetPacker::OpenPackage(const std::filesystem::path& packageManifestPath)
 {
-    return Path::ReadAllBytes(Path::GetFullPath(chunkPath.string()));
-}
-
-std::vector<unsigned char> AssetPacker::LoadPackageData(const std::filesystem::path& packageManifestPath)
-{
-    
-    std::ifstream manifestFile(packageManifestPath);
-    if (!manifestFile)
-    {
-        throw std::runtime_error("Cannot open package manifest: " + packageManifestPath.string());
-    }
+    static std::shared_ptr<const AssetPackage> cachedPackage;
+    static std::filesystem::path cachedPath;
+    static std::mutex cacheMutex;
 
-    std::vector<std::string> chunkFileNames;
-    std::string chunkFileName;
-    while (std::getline(manifestFile, chunkFileName))
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    if (!cachedPackage || cachedPath != packageManifestPath)
     {
-        
-        if (!chunkFileName.empty() && chunkFileName.back() == '\r')
+        auto package = std::make_shared<AssetPackage>();
+        if (!package->Open(packageManifestPath))
         {
-            chunkFileName.pop_back();
+            throw std::runtime_error("Cannot open asset package: " + packageManifestPath.string());
         }
-        if (!chunkFileName.empty())
-        {
-            chunkFileNames.push_back(chunkFileName);
-        }
-    }
-    manifestFile.close();
-
-    if (chunkFileNames.empty())
-    {
-        throw std::runtime_error("Package manifest is empty.");
-    }
-
-    
-    const size_t numChunks = chunkFileNames.size();
-    std::vector<std::future<std::vector<unsigned char>>> futures;
-    futures.reserve(numChunks);
-
-    const std::filesystem::path parentPath = packageManifestPath.parent_path();
-
-    for (const auto& fileName : chunkFileNames)
-    {
-        std::filesystem::path chunkPath = parentPath / fileName;
-        futures.push_back(std::async(std::launch::async, ReadChunkFile, chunkPath));
-    }
-
-    
-    std::vector<unsigned char> encryptedPackage;
-    size_t totalSize = 0;
-
-    std::vector<std::vector<unsigned char>> chunkDataList;
-    chunkDataList.reserve(numChunks);
-
-    for (size_t i = 0; i < numChunks; ++i)
-    {
-        auto chunkData = futures[i].get();
-        totalSize += chunkData.size();
-        chunkDataList.push_back(std::move(chunkData));
-    }
-
-    encryptedPackage.reserve(totalSize);
-    for (auto& chunkData : chunkDataList)
-    {
-        encryptedPackage.insert(encryptedPackage.end(),
-                                std::make_move_iterator(chunkData.begin()),
-                                std::make_move_iterator(chunkData.end()));
+        cachedPackage = std::move(package);
+        cachedPath = packageManifestPath;
     }
-
-    return encryptedPackage;
+    return cachedPackage;
 }
 
 std::unordered_map<std::string, AssetIndexEntry> AssetPacker::LoadIndex(const std::filesystem::path& packageManifestPath)
@@ -412,28 +274,21 @@ std::unordered_map<std::string, AssetIndexEntry> AssetPacker::LoadIndex(const st
 
     try
     {
-        const std::filesystem::path parentPath = packageManifestPath.parent_path();
-        const std::filesystem::path indexPath = parentPath / "package.index";
-
-        
-        auto encryptedIndex = Path::ReadAllBytes(Path::GetFullPath(indexPath.string()));
-
-        
-        auto decryptedIndex = EngineCrypto::GetInstance().Decrypt(encryptedIndex);
-
-        
-        std::vector<uint8_t> indexData(decryptedIndex.begin(), decryptedIndex.end());
-        nlohmann::json indexJson = nlohmann::json::from_msgpack(indexData);
+        auto package = OpenPackage(packageManifestPath);
+        const AssetPackageFormat::IndexEntry* entries = package->GetEntries();
 
         std::unordered_map<std::string, AssetIndexEntry> indexMap;
-        indexMap.reserve(indexJson.size());
+        indexMap.reserve(package->GetAssetCount());
 
-        for (const auto& entry : indexJson)
+        for (size_t i = 0; i < package->GetAssetCount(); ++i)
         {
+            std::array<uint8_t, 16> guidBytes;
+            std::copy(std::begin(entries[i].guid), std::end(entries[i].guid), guidBytes.begin());
+
             AssetIndexEntry indexEntry;
-            indexEntry.guid = entry.at("guid").get<std::string>();
-            indexEntry.offset = entry.at("offset").get<size_t>();
-            indexEntry.size = entry.at("size").get<size_t>();
+            indexEntry.guid = Guid(guidBytes).ToString();
+            indexEntry.offset = entries[i].offset;
+            indexEntry.size = entries[i].size;
 
             indexMap[indexEntry.guid] = indexEntry;
         }
@@ -535,32 +390,22 @@ AssetMetadata AssetPacker::LoadSingleAsset(const std::filesystem::path& packageM
 {
     try
     {
-        
-        static std::vector<unsigned char> cachedPackageData;
-        static std::filesystem::path cachedPath;
-        static std::mutex cacheMutex;
-
-        std::lock_guard<std::mutex> lock(cacheMutex);
+        // 包只在首次访问时打开，之后每次只解密并解析这一条记录
+        auto package = OpenPackage(packageManifestPath);
 
-        
-        if (cachedPath != packageManifestPath)
-        {
-            auto encryptedPackage = LoadPackageData(packageManifestPath);
-            cachedPackageData = EngineCrypto::GetInstance().Decrypt(encryptedPackage);
-            cachedPath = packageManifestPath;
-        }
-
-        
-        std::vector<uint8_t> binaryData(cachedPackageData.begin(), cachedPackageData.end());
-        nlohmann::json rootJson = nlohmann::json::from_msgpack(binaryData);
-
-        if (!rootJson.contains(indexEntry.guid))
+        std::vector<uint8_t> binaryData;
+        switch (package->Read(Guid::FromString(indexEntry.guid), binaryData))
         {
+        case AssetPackage::ReadResult::Ok:
+            break;
+        case AssetPackage::ReadResult::Missing:
             throw std::runtime_error("Asset not found in package: " + indexEntry.guid);
+        case AssetPackage::ReadResult::Corrupt:
+            throw std::runtime_error("Asset record is corrupt: " + indexEntry.guid);
         }
 
         AssetMetadata metadata;
-        from_json(rootJson[indexEntry.guid], metadata);
+        from_json(nlohmann::json::from_msgpack(binaryData), metadata);
 
         return metadata;
     }
@@ -577,49 +422,16 @@ std::unordered_map<std::string, AssetMetadata> AssetPacker::Unpack(const std::fi
 
     try
     {
-        auto encryptedPackage = LoadPackageData(packageManifestPath);
+        auto package = OpenPackage(packageManifestPath);
+        const size_t assetCount = package->GetAssetCount();
 
-        LogInfo("AssetPacker: 所有数据块已加载,总加密大小: {} 字节", encryptedPackage.size());
+        LogInfo("AssetPacker: 开始多线程解码,共 {} 个资产", assetCount);
 
-        
-        auto decryptedData = EngineCrypto::GetInstance().Decrypt(encryptedPackage);
-
-        LogInfo("AssetPacker: 解密数据大小: {} 字节", decryptedData.size());
-
-        
-        std::vector<uint8_t> binaryData(decryptedData.begin(), decryptedData.end());
-        nlohmann::json rootJson;
-
-        try
-        {
-            rootJson = nlohmann::json::from_msgpack(binaryData);
-        }
-        catch (const std::exception& e)
-        {
-            LogError("AssetPacker: MessagePack解析失败: {}", e.what());
-            throw;
-        }
-
-        if (!rootJson.is_object())
-        {
-            throw std::runtime_error("Unpacked data is not a valid asset database.");
-        }
-
-        LogInfo("AssetPacker: 开始多线程JSON解析,共 {} 个资产", rootJson.size());
-
-        
-        std::vector<std::pair<std::string, nlohmann::json>> jsonEntries;
-        jsonEntries.reserve(rootJson.size());
-
-        for (auto it = rootJson.begin(); it != rootJson.end(); ++it)
-        {
-            jsonEntries.emplace_back(it.key(), it.value());
-        }
-
-        
+        // 记录彼此独立，各线程直接解密并解析自己那一段
         const size_t hardwareConcurrency = std::thread::hardware_concurrency();
-        const size_t numThreads = std::min(hardwareConcurrency > 0 ? hardwareConcurrency : 4, jsonEntries.size());
-        const size_t chunkSize = (jsonEntries.size() + numThreads - 1) / numThreads;
+        const size_t numThreads = std::max<size_t>(1, std::min(hardwareConcurrency > 0 ? hardwareConcurrency : 4,
+                                                               assetCount));
+        const size_t chunkSize = (assetCount + numThreads - 1) / numThreads;
 
         
         std::vector<std::future<std::unordered_map<std::string, AssetMetadata>>> parseFutures;
@@ -628,31 +440,42 @@ std::unordered_map<std::string, AssetMetadata> AssetPacker::Unpack(const std::fi
         for (size_t i = 0; i < numThreads; ++i)
         {
             size_t startIdx = i * chunkSize;
-            size_t endIdx = std::min(startIdx + chunkSize, jsonEntries.size());
+            size_t endIdx = std::min(startIdx + chunkSize, assetCount);
 
-            if (startIdx >= jsonEntries.size())
+            if (startIdx >= assetCount)
                 break;
 
             parseFutures.push_back(std::async(std::launch::async,
-                                              [&jsonEntries, startIdx, endIdx
+                                              [&package, startIdx, endIdx
                                               ]() -> std::unordered_map<std::string, AssetMetadata>
                                               {
                                                   std::unordered_map<std::string, AssetMetadata> localResult;
                                                   localResult.reserve(endIdx - startIdx);
 
+                                                  std::vector<uint8_t> binaryData;
                                                   for (size_t idx = startIdx; idx < endIdx; ++idx)
                                                   {
-                                                      const auto& entry = jsonEntries[idx];
+                                                      const auto& entry = package->GetEntries()[idx];
+                                                      std::array<uint8_t, 16> guidBytes;
+                                                      std::copy(std::begin(entry.guid), std::end(entry.guid),
+                                                                guidBytes.begin());
+                                                      const std::string guid = Guid(guidBytes).ToString();
                                                       try
                                                       {
+                                                          if (package->Read(entry, binaryData) !=
+                                                              AssetPackage::ReadResult::Ok)
+                                                          {
+                                                              throw std::runtime_error("Asset record is corrupt.");
+                                                          }
                                                           AssetMetadata metadata;
-                                                          from_json(entry.second, metadata);
-                                                          localResult[entry.first] = std::move(metadata);
+                                                          from_json(nlohmann::json::from_msgpack(binaryData),
+                                                                    metadata);
+                                                          localResult[guid] = std::move(metadata);
                                                       }
                                                       catch (const std::exception& e)
                                                       {
                                                           LogError("AssetPacker: 反序列化资产失败 {}: {}",
-                                                                   entry.first, e.what());
+                                                                   guid, e.what());
                                                           throw;
                                                       }
                                                   }
@@ -664,7 +487,7 @@ std::unordered_map<std::string, AssetMetadata> AssetPacker::Unpack(const std::fi
 
         
         std::unordered_map<std::string, AssetMetadata> result;
-        result.reserve(jsonEntries.size());
+        result.reserve(assetCount);
 
         for (auto& future : parseFutures)
         {
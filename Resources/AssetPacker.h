@@ -1,20 +1,23 @@
 #ifndef ASSETPACKER_H
 #define ASSETPACKER_H
 #include <filesystem>
+#include <memory>
 #include <vector>
 #include <string>
 #include <unordered_map>
 #include "../Utils/Guid.h"
 #include "../Resources/AssetMetadata.h"
 
+class AssetPackage;
+
 /**
  * @brief 资产索引条目,用于快速查找资产在打包文件中的位置
  */
 struct AssetIndexEntry
 {
     std::string guid;           ///< 资产的全局唯一标识符
-    size_t offset;              ///< 资产数据在文件中的偏移量
-    size_t size;                ///< 资产数据的大小(字节)
+    size_t offset;              ///< 资产记录在数据文件中的偏移量
+    size_t size;                ///< 资产记录的大小(字节,压缩并加密后)
 };
 
 /**
@@ -85,7 +88,7 @@ public:
 private:
     static bool SaveAddressablesIndex(const std::unordered_map<std::string, AssetMetadata>& assetDatabase,
                                       const std::filesystem::path& outputPath);
-    static std::vector<unsigned char> ReadChunkFile(const std::filesystem::path& chunkPath);
-    static std::vector<unsigned char> LoadPackageData(const std::filesystem::path& packageManifestPath);
+    /// 打开并缓存最近使用的包，多次调用共享同一份内存映射。
+    static std::shared_ptr<const AssetPackage> OpenPackage(const std::filesystem::path& packageManifestPath);
 };
 #endif
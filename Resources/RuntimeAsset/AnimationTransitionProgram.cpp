@@ -0,0 +1,292 @@
+#include "AnimationTransitionProgram.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "Logger.h"
+
+AnimationTransitionProgram::AnimationTransitionProgram(const AnimationControllerData& data)
+{
+    m_defaults.reserve(data.Variables.size());
+    for (const auto& var : data.Variables)
+    {
+        if (m_parameterIds.contains(var.Name))
+        {
+            LogWarn("动画变量 {} 重复定义，后定义的值将覆盖之前的值", var.Name);
+            AssignValue(m_defaults[m_parameterIds[var.Name]], var.Value);
+            continue;
+        }
+        if (m_defaults.size() >= std::numeric_limits<uint16_t>::max())
+        {
+            LogWarn("动画变量数量超过上限，变量 {} 将被忽略", var.Name);
+            continue;
+        }
+
+        AnimationParameterSlot slot;
+        slot.type = var.Type;
+        if (var.Type != VariableType::VariableType_Trigger)
+        {
+            AssignValue(slot, var.Value);
+        }
+        m_parameterIds[var.Name] = static_cast<int>(m_defaults.size());
+        m_defaults.push_back(slot);
+    }
+
+    m_states.reserve(data.States.size());
+    for (const auto& [guid, state] : data.States)
+    {
+        CompiledState compiled;
+        compileState(state, compiled);
+        if (guid == SpecialStateGuids::AnyState())
+        {
+            m_anyState = compiled;
+        }
+        else
+        {
+            m_stateIndices[guid] = static_cast<int>(m_states.size());
+            m_states.push_back(compiled);
+        }
+    }
+}
+
+void AnimationTransitionProgram::compileState(const AnimationState& state, CompiledState& outState)
+{
+    outState.firstTransition = static_cast<uint32_t>(m_transitions.size());
+    outState.transitionCount = static_cast<uint32_t>(state.Transitions.size());
+
+    for (const auto& transition : state.Transitions)
+    {
+        CompiledTransition compiled;
+        compiled.source = &transition;
+        compiled.toGuid = transition.ToGuid;
+        compiled.priority = transition.priority;
+        compiled.hasExitTime = transition.hasExitTime;
+        compiled.firstInstruction = static_cast<uint32_t>(m_instructions.size());
+        compiled.firstTrigger = static_cast<uint32_t>(m_triggerSlots.size());
+
+        for (const auto& condition : transition.Conditions)
+        {
+            ConditionInstruction instruction = compileCondition(condition);
+            m_instructions.push_back(instruction);
+            if (instruction.op == ConditionOpCode::Trigger)
+            {
+                m_triggerSlots.push_back(instruction.slot);
+            }
+        }
+
+        compiled.instructionCount = static_cast<uint32_t>(m_instructions.size()) - compiled.firstInstruction;
+        compiled.triggerCount = static_cast<uint32_t>(m_triggerSlots.size()) - compiled.firstTrigger;
+        m_transitions.push_back(compiled);
+    }
+
+    auto begin = m_transitions.begin() + outState.firstTransition;
+    std::stable_sort(begin, m_transitions.end(), [](const CompiledTransition& a, const CompiledTransition& b)
+    {
+        return a.priority > b.priority;
+    });
+}
+
+ConditionInstruction AnimationTransitionProgram::compileCondition(const Condition& condition)
+{
+    ConditionInstruction instruction;
+
+    std::visit([&](auto&& arg)
+    {
+        using T = std::decay_t<decltype(arg)>;
+        auto it = m_parameterIds.find(arg.VarName);
+        if (it == m_parameterIds.end())
+        {
+            LogWarn("动画变量 {} 未定义，相关条件将始终为假", arg.VarName);
+            return;
+        }
+
+        const VariableType type = m_defaults[it->second].type;
+        const bool isBoolean = type == VariableType::VariableType_Bool || type == VariableType::VariableType_Trigger;
+        instruction.slot = static_cast<uint16_t>(it->second);
+
+        if constexpr (std::is_same_v<T, FloatCondition>)
+        {
+            if (type == VariableType::VariableType_Float)
+            {
+                instruction.op = (arg.op == FloatCondition::GreaterThan)
+                                     ? ConditionOpCode::FloatGreater
+                                     : ConditionOpCode::FloatLess;
+                instruction.floatOperand = arg.Value;
+            }
+        }
+        else if constexpr (std::is_same_v<T, IntCondition>)
+        {
+            if (type == VariableType::VariableType_Int)
+            {
+                switch (arg.op)
+                {
+                case IntCondition::GreaterThan: instruction.op = ConditionOpCode::IntGreater;
+                    break;
+                case IntCondition::LessThan: instruction.op = ConditionOpCode::IntLess;
+                    break;
+                case IntCondition::Equal: instruction.op = ConditionOpCode::IntEqual;
+                    break;
+                case IntCondition::NotEqual: instruction.op = ConditionOpCode::IntNotEqual;
+                    break;
+                }
+                instruction.intOperand = arg.Value;
+            }
+        }
+        else if constexpr (std::is_same_v<T, BoolCondition>)
+        {
+            if (isBoolean)
+            {
+                instruction.op = (arg.op == BoolCondition::IsTrue)
+                                     ? ConditionOpCode::BoolTrue
+                                     : ConditionOpCode::BoolFalse;
+            }
+        }
+        else if constexpr (std::is_same_v<T, TriggerCondition>)
+        {
+            if (isBoolean)
+            {
+                instruction.op = ConditionOpCode::Trigger;
+            }
+        }
+
+        if (instruction.op == ConditionOpCode::AlwaysFalse)
+        {
+            LogWarn("动画条件与变量 {} 的类型不匹配，相关条件将始终为假", arg.VarName);
+        }
+    }, condition);
+
+    return instruction;
+}
+
+int AnimationTransitionProgram::GetParameterId(std::string_view name) const
+{
+    auto it = m_parameterIds.find(std::string(name));
+    return it != m_parameterIds.end() ? it->second : InvalidId;
+}
+
+int AnimationTransitionProgram::FindState(const Guid& stateGuid) const
+{
+    auto it = m_stateIndices.find(stateGuid);
+    return it != m_stateIndices.end() ? it->second : InvalidId;
+}
+
+bool AnimationTransitionProgram::Evaluate(const CompiledTransition& transition,
+                                          const AnimationParameterSlot* parameters) const
+{
+    const ConditionInstruction* ip = m_instructions.data() + transition.firstInstruction;
+    const ConditionInstruction* end = ip + transition.instructionCount;
+
+    for (; ip != end; ++ip)
+    {
+        const AnimationParameterSlot& p = parameters[ip->slot];
+        bool result = false;
+        switch (ip->op)
+        {
+        case ConditionOpCode::FloatGreater: result = p.floatValue > ip->floatOperand;
+            break;
+        case ConditionOpCode::FloatLess: result = p.floatValue < ip->floatOperand;
+            break;
+        case ConditionOpCode::BoolTrue:
+        case ConditionOpCode::Trigger: result = p.boolValue;
+            break;
+        case ConditionOpCode::BoolFalse: result = !p.boolValue;
+            break;
+        case ConditionOpCode::IntGreater: result = p.intValue > ip->intOperand;
+            break;
+        case ConditionOpCode::IntLess: result = p.intValue < ip->intOperand;
+            break;
+        case ConditionOpCode::IntEqual: result = p.intValue == ip->intOperand;
+            break;
+        case ConditionOpCode::IntNotEqual: result = p.intValue != ip->intOperand;
+            break;
+        case ConditionOpCode::AlwaysFalse: result = false;
+            break;
+        }
+        if (!result)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+const CompiledTransition* AnimationTransitionProgram::firstPassing(const CompiledState& state, bool isAnyState,
+                                                                   const Guid& currentGuid,
+                                                                   bool animationHasFinished,
+                                                                   const CompiledTransition* mustBeat,
+                                                                   const AnimationParameterSlot* parameters) const
+{
+    const CompiledTransition* it = m_transitions.data() + state.firstTransition;
+    const CompiledTransition* end = it + state.transitionCount;
+
+    for (; it != end; ++it)
+    {
+        // 区间按优先级降序排列，之后的过渡不可能再胜出
+        if (mustBeat && it->priority <= mustBeat->priority)
+        {
+            return nullptr;
+        }
+
+        if (isAnyState)
+        {
+            if (it->toGuid == currentGuid) continue;
+        }
+        else if (it->hasExitTime && !animationHasFinished)
+        {
+            continue;
+        }
+
+        if (Evaluate(*it, parameters))
+        {
+            return it;
+        }
+    }
+    return nullptr;
+}
+
+const CompiledTransition* AnimationTransitionProgram::FindBestTransition(int stateIndex, const Guid& currentGuid,
+                                                                         bool animationHasFinished,
+                                                                         const AnimationParameterSlot* parameters)
+const
+{
+    const CompiledTransition* best = firstPassing(m_anyState, true, currentGuid, animationHasFinished, nullptr,
+                                                  parameters);
+
+    if (stateIndex >= 0 && stateIndex < static_cast<int>(m_states.size()))
+    {
+        // 与旧求值器一致：当前状态的过渡只有在优先级严格更高时才能取代任意状态的过渡
+        if (const CompiledTransition* own = firstPassing(m_states[stateIndex], false, currentGuid,
+                                                         animationHasFinished, best, parameters))
+        {
+            best = own;
+        }
+    }
+    return best;
+}
+
+void AnimationTransitionProgram::ConsumeTriggers(const CompiledTransition& transition,
+                                                 AnimationParameterSlot* parameters) const
+{
+    const uint16_t* slot = m_triggerSlots.data() + transition.firstTrigger;
+    for (uint32_t i = 0; i < transition.triggerCount; ++i)
+    {
+        parameters[slot[i]].boolValue = false;
+    }
+}
+
+void AnimationTransitionProgram::AssignValue(AnimationParameterSlot& slot, const std::variant<float, bool, int>& value)
+{
+    std::visit([&](auto&& v)
+    {
+        switch (slot.type)
+        {
+        case VariableType::VariableType_Float: slot.floatValue = static_cast<float>(v);
+            break;
+        case VariableType::VariableType_Int: slot.intValue = static_cast<int>(v);
+            break;
+        case VariableType::VariableType_Bool:
+        case VariableType::VariableType_Trigger: slot.boolValue = static_cast<bool>(v);
+            break;
+        }
+    }, value);
+}
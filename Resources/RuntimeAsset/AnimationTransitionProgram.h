@@ -0,0 +1,183 @@
+#ifndef ANIMATIONTRANSITIONPROGRAM_H
+#define ANIMATIONTRANSITIONPROGRAM_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+#include "AnimationControllerData.h"
+
+/**
+ * @brief 条件字节码的操作码。
+ *
+ * 每条指令对一个已解析为整数槽位的参数做一次类型确定的比较。
+ */
+enum class ConditionOpCode : uint8_t
+{
+    FloatGreater, ///< 浮点参数 > 操作数。
+    FloatLess,    ///< 浮点参数 < 操作数。
+    BoolTrue,     ///< 布尔参数为真。
+    BoolFalse,    ///< 布尔参数为假。
+    IntGreater,   ///< 整型参数 > 操作数。
+    IntLess,      ///< 整型参数 < 操作数。
+    IntEqual,     ///< 整型参数 == 操作数。
+    IntNotEqual,  ///< 整型参数 != 操作数。
+    Trigger,      ///< 触发器已被置位。
+    AlwaysFalse   ///< 引用了未定义或类型不匹配的参数，恒为假。
+};
+
+/**
+ * @brief 一条条件指令，8 字节定长。
+ */
+struct ConditionInstruction
+{
+    ConditionOpCode op = ConditionOpCode::AlwaysFalse; ///< 操作码。
+    uint16_t slot = 0; ///< 参数槽位。
+
+    union
+    {
+        float floatOperand; ///< 浮点比较值。
+        int intOperand;     ///< 整型比较值。
+    };
+
+    ConditionInstruction() : intOperand(0) {}
+};
+
+/**
+ * @brief 一个参数槽位的运行时值。
+ *
+ * 值始终按声明类型存放，求值时不需要再做类型分派。
+ */
+struct AnimationParameterSlot
+{
+    VariableType type = VariableType::VariableType_Float; ///< 声明类型。
+    float floatValue = 0.0f; ///< 浮点值。
+    int intValue = 0; ///< 整型值。
+    bool boolValue = false; ///< 布尔值（触发器也使用此字段）。
+};
+
+/**
+ * @brief 编译后的过渡。
+ */
+struct CompiledTransition
+{
+    const Transition* source = nullptr; ///< 指向原始过渡数据。
+    Guid toGuid; ///< 目标状态。
+    int priority = 0; ///< 优先级。
+    bool hasExitTime = true; ///< 是否有退出时间。
+    uint32_t firstInstruction = 0; ///< 在指令数组中的起始下标。
+    uint32_t instructionCount = 0; ///< 指令条数。
+    uint32_t firstTrigger = 0; ///< 在触发器槽位数组中的起始下标。
+    uint32_t triggerCount = 0; ///< 需要在过渡后复位的触发器数量。
+};
+
+/**
+ * @brief 编译后的状态：一段按优先级降序（稳定）排列的过渡区间。
+ */
+struct CompiledState
+{
+    uint32_t firstTransition = 0; ///< 起始下标。
+    uint32_t transitionCount = 0; ///< 过渡数量。
+};
+
+/**
+ * @brief 动画状态机过渡程序。
+ *
+ * 在加载时把 AnimationControllerData 中以字符串引用参数的条件编译为扁平的指令数组，
+ * 参数名解析为整数槽位，每个状态（包括任意状态）的过渡按优先级预排序。
+ * 运行时求值只做数组访问与比较，不再涉及字符串哈希与 map 查找。
+ *
+ * 选择结果与逐帧解释 Condition 的旧求值器完全一致：同优先级时任意状态的过渡优先，
+ * 同一状态内保持声明顺序。
+ *
+ * @note 程序内部保存了指向源数据中 Transition 的指针，源数据必须比程序活得更久。
+ */
+class AnimationTransitionProgram
+{
+public:
+    static constexpr int InvalidId = -1; ///< 无效的参数或状态标识。
+
+    AnimationTransitionProgram() = default;
+
+    /**
+     * @brief 编译动画控制器数据。
+     * @param data 源数据，编译后不得移动或销毁。
+     */
+    explicit AnimationTransitionProgram(const AnimationControllerData& data);
+
+    /**
+     * @brief 按名称获取参数槽位标识。
+     * @param name 参数名称。
+     * @return 槽位标识，不存在时返回 InvalidId。
+     */
+    int GetParameterId(std::string_view name) const;
+
+    /**
+     * @brief 获取参数数量。
+     */
+    size_t GetParameterCount() const { return m_defaults.size(); }
+
+    /**
+     * @brief 获取参数的默认值集合，用作控制器的初始参数块。
+     */
+    const std::vector<AnimationParameterSlot>& GetDefaultParameters() const { return m_defaults; }
+
+    /**
+     * @brief 按 Guid 获取编译后状态的下标。
+     * @return 状态下标，不存在时返回 InvalidId。
+     */
+    int FindState(const Guid& stateGuid) const;
+
+    /**
+     * @brief 对一个过渡的全部条件求值。
+     * @param transition 编译后的过渡。
+     * @param parameters 参数块。
+     * @return 条件全部满足（或没有条件）时返回 true。
+     */
+    bool Evaluate(const CompiledTransition& transition, const AnimationParameterSlot* parameters) const;
+
+    /**
+     * @brief 查找当前应当执行的过渡。
+     * @param stateIndex 当前状态下标，可以为 InvalidId。
+     * @param currentGuid 当前状态的 Guid，用于排除指向自身的任意状态过渡。
+     * @param animationHasFinished 当前动画是否已播放完毕。
+     * @param parameters 参数块。
+     * @return 最佳过渡，没有满足条件的过渡时返回 nullptr。
+     */
+    const CompiledTransition* FindBestTransition(int stateIndex, const Guid& currentGuid,
+                                                 bool animationHasFinished,
+                                                 const AnimationParameterSlot* parameters) const;
+
+    /**
+     * @brief 复位过渡所使用的触发器。
+     */
+    void ConsumeTriggers(const CompiledTransition& transition, AnimationParameterSlot* parameters) const;
+
+    /**
+     * @brief 以参数的声明类型写入一个值。
+     * @param slot 目标槽位。
+     * @param value 新值，会被转换为槽位的声明类型。
+     */
+    static void AssignValue(AnimationParameterSlot& slot, const std::variant<float, bool, int>& value);
+
+private:
+    const CompiledTransition* firstPassing(const CompiledState& state, bool isAnyState, const Guid& currentGuid,
+                                           bool animationHasFinished, const CompiledTransition* mustBeat,
+                                           const AnimationParameterSlot* parameters) const;
+    void compileState(const AnimationState& state, CompiledState& outState);
+    ConditionInstruction compileCondition(const Condition& condition);
+
+    std::unordered_map<std::string, int> m_parameterIds; ///< 参数名到槽位的映射，仅在按名称访问时使用。
+    std::vector<AnimationParameterSlot> m_defaults; ///< 参数默认值。
+    std::vector<ConditionInstruction> m_instructions; ///< 所有过渡的条件指令。
+    std::vector<uint16_t> m_triggerSlots; ///< 每个过渡需要复位的触发器槽位。
+    std::vector<CompiledTransition> m_transitions; ///< 所有编译后的过渡。
+    std::vector<CompiledState> m_states; ///< 所有编译后的状态。
+    std::unordered_map<Guid, int> m_stateIndices; ///< 状态 Guid 到下标的映射。
+    CompiledState m_anyState; ///< 任意状态的过渡区间。
+};
+
+#endif
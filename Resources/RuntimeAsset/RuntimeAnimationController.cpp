@@ -55,6 +55,7 @@ void RuntimeAnimationController::playInternal(const sk_sp<RuntimeAnimationClip>&
     }
 
     m_currentAnimationGuid = clip->GetSourceGuid();
+    m_currentStateIndex = m_transitionProgram.FindState(m_currentAnimationGuid);
     m_currentAnimationName = clip->GetName();
     m_currentTime = 0.0f;
     m_currentFrameIndex = 0;
@@ -75,77 +76,29 @@ void RuntimeAnimationController::playInternal(const sk_sp<RuntimeAnimationClip>&
     m_justTransitioned = true;
 }
 
-bool RuntimeAnimationController::EvaluateCondition(const std::vector<Condition>& conditions)
+void RuntimeAnimationController::SetTrigger(const std::string& name)
 {
-    if (conditions.empty())
+    const int id = m_transitionProgram.GetParameterId(name);
+    if (id != AnimationTransitionProgram::InvalidId && m_parameters[id].type == VariableType::VariableType_Trigger)
     {
-        return true;
+        m_parameters[id].boolValue = true;
     }
-
-    for (const auto& condition : conditions)
+    else
     {
-        bool result = false;
-
-
-        std::visit([&](auto&& arg)
-        {
-            using T = std::decay_t<decltype(arg)>;
-            if (!m_variables.contains(arg.VarName))
-            {
-                LogWarn("动画变量 {} 未定义", arg.VarName);
-                result = false;
-                return;
-            }
-
-            if constexpr (std::is_same_v<T, FloatCondition>)
-            {
-                auto varValue = std::get<float>(m_variables[arg.VarName]);
-                result = (arg.op == FloatCondition::GreaterThan) ? (varValue > arg.Value) : (varValue < arg.Value);
-            }
-            else if constexpr (std::is_same_v<T, IntCondition>)
-            {
-                auto varValue = std::get<int>(m_variables[arg.VarName]);
-                switch (arg.op)
-                {
-                case IntCondition::GreaterThan: result = varValue > arg.Value;
-                    break;
-                case IntCondition::LessThan: result = varValue < arg.Value;
-                    break;
-                case IntCondition::Equal: result = varValue == arg.Value;
-                    break;
-                case IntCondition::NotEqual: result = varValue != arg.Value;
-                    break;
-                }
-            }
-            else if constexpr (std::is_same_v<T, BoolCondition>)
-            {
-                auto varValue = std::get<bool>(m_variables[arg.VarName]);
-                result = (arg.op == BoolCondition::IsTrue) ? varValue : !varValue;
-            }
-
-            else if constexpr (std::is_same_v<T, TriggerCondition>)
-            {
-                result = std::get<bool>(m_variables[arg.VarName]);
-            }
-        }, condition);
-
-        if (!result)
-        {
-            return false;
-        }
+        LogWarn("尝试设置一个无效或不存在的触发器: {}", name);
     }
-    return true;
 }
 
-void RuntimeAnimationController::SetTrigger(const std::string& name)
+void RuntimeAnimationController::SetTrigger(int id)
 {
-    if (m_variables.contains(name) && m_variableTypes[name] == VariableType::VariableType_Trigger)
+    if (id >= 0 && id < static_cast<int>(m_parameters.size()) &&
+        m_parameters[id].type == VariableType::VariableType_Trigger)
     {
-        m_variables[name] = true;
+        m_parameters[id].boolValue = true;
     }
     else
     {
-        LogWarn("尝试设置一个无效或不存在的触发器: {}", name);
+        LogWarn("尝试设置一个无效或不存在的触发器: #{}", id);
     }
 }
 
@@ -302,17 +255,8 @@ RuntimeAnimationController::RuntimeAnimationController(AnimationControllerData d
         }
     }
 
-
-    for (auto& var : m_animationControllerData.Variables)
-    {
-        m_variables[var.Name] = var.Value;
-        m_variableTypes[var.Name] = var.Type;
-
-        if (var.Type == VariableType::VariableType_Trigger)
-        {
-            m_variables[var.Name] = false;
-        }
-    }
+    m_transitionProgram = AnimationTransitionProgram(m_animationControllerData);
+    m_parameters = m_transitionProgram.GetDefaultParameters();
 }
 
 void RuntimeAnimationController::PlayAnimation(const Guid& guid, float speed, float transitionDuration)
@@ -356,9 +300,10 @@ bool RuntimeAnimationController::IsAnimationPlaying(const std::string& animation
 
 void RuntimeAnimationController::SetVariable(const std::string& name, std::variant<float, bool, int> value)
 {
-    if (m_variables.contains(name))
+    const int id = m_transitionProgram.GetParameterId(name);
+    if (id != AnimationTransitionProgram::InvalidId)
     {
-        m_variables[name] = value;
+        AnimationTransitionProgram::AssignValue(m_parameters[id], value);
     }
     else
     {
@@ -366,6 +311,23 @@ void RuntimeAnimationController::SetVariable(const std::string& name, std::varia
     }
 }
 
+void RuntimeAnimationController::SetVariable(int id, std::variant<float, bool, int> value)
+{
+    if (id >= 0 && id < static_cast<int>(m_parameters.size()))
+    {
+        AnimationTransitionProgram::AssignValue(m_parameters[id], value);
+    }
+    else
+    {
+        LogWarn("尝试设置未定义的动画变量: #{}", id);
+    }
+}
+
+int RuntimeAnimationController::GetVariableId(const std::string& name) const
+{
+    return m_transitionProgram.GetParameterId(name);
+}
+
 void RuntimeAnimationController::SetFrameRate(float frameRate)
 {
     if (frameRate > 0.0f)
@@ -404,47 +366,9 @@ void RuntimeAnimationController::PlayEntryAnimation()
 
 const Transition* RuntimeAnimationController::FindBestTransition(bool animationHasFinished)
 {
-    const Transition* bestCandidate = nullptr;
-
-
-    auto evaluate = [&](const Transition& t)
-    {
-        if (EvaluateCondition(t.Conditions))
-        {
-            if (!bestCandidate || t.priority > bestCandidate->priority)
-            {
-                bestCandidate = &t;
-            }
-        }
-    };
-
-
-    if (m_animationControllerData.States.contains(SpecialStateGuids::AnyState()))
-    {
-        const auto& anyState = m_animationControllerData.States.at(SpecialStateGuids::AnyState());
-        for (const auto& transition : anyState.Transitions)
-        {
-            if (transition.ToGuid != m_currentAnimationGuid)
-            {
-                evaluate(transition);
-            }
-        }
-    }
-
-
-    if (m_animationControllerData.States.contains(m_currentAnimationGuid))
-    {
-        const auto& currentState = m_animationControllerData.States.at(m_currentAnimationGuid);
-        for (const auto& transition : currentState.Transitions)
-        {
-            if (!transition.hasExitTime || animationHasFinished)
-            {
-                evaluate(transition);
-            }
-        }
-    }
-
-    return bestCandidate;
+    const CompiledTransition* best = m_transitionProgram.FindBestTransition(
+        m_currentStateIndex, m_currentAnimationGuid, animationHasFinished, m_parameters.data());
+    return best ? best->source : nullptr;
 }
 
 void RuntimeAnimationController::Update(float deltaTime)
@@ -478,27 +402,20 @@ void RuntimeAnimationController::Update(float deltaTime)
     }
     else
     {
-        const Transition* bestTransition = FindBestTransition(isCurrentAnimationFinished);
+        const CompiledTransition* bestTransition = m_transitionProgram.FindBestTransition(
+            m_currentStateIndex, m_currentAnimationGuid, isCurrentAnimationFinished, m_parameters.data());
 
         if (bestTransition)
         {
             auto loader = AnimationClipLoader();
-            sk_sp<RuntimeAnimationClip> nextClip = loader.LoadAsset(bestTransition->ToGuid);
+            sk_sp<RuntimeAnimationClip> nextClip = loader.LoadAsset(bestTransition->toGuid);
 
             if (nextClip && nextClip->GetSourceGuid() != m_currentAnimationGuid)
             {
                 LogInfo("过渡触发: 从 {} 切换到目标状态", m_currentAnimationName);
-                playInternal(nextClip, 1.0f, bestTransition->TransitionDuration);
-
+                playInternal(nextClip, 1.0f, bestTransition->source->TransitionDuration);
 
-                for (const auto& condition : bestTransition->Conditions)
-                {
-                    if (std::holds_alternative<TriggerCondition>(condition))
-                    {
-                        const auto& triggerCond = std::get<TriggerCondition>(condition);
-                        m_variables[triggerCond.VarName] = false;
-                    }
-                }
+                m_transitionProgram.ConsumeTriggers(*bestTransition, m_parameters.data());
             }
         }
     }
@@ -1,6 +1,7 @@
 #ifndef RUNTIMEANIMATIONCONTROLLER_H
 #define RUNTIMEANIMATIONCONTROLLER_H
 #include "AnimationControllerData.h"
+#include "AnimationTransitionProgram.h"
 #include "IRuntimeAsset.h"
 #include "RuntimeAnimationClip.h"
 #include "Event/LumaEvent.h"
@@ -14,8 +15,9 @@ class RuntimeAnimationController : public IRuntimeAsset
 {
 private:
     AnimationControllerData m_animationControllerData; ///< 动画控制器数据。
-    std::unordered_map<std::string, std::variant<float, bool, int>> m_variables; ///< 动画控制器中的变量集合。
-    std::unordered_map<std::string, VariableType> m_variableTypes; ///< 动画控制器中变量的类型。
+    AnimationTransitionProgram m_transitionProgram; ///< 加载时编译的过渡条件程序。
+    std::vector<AnimationParameterSlot> m_parameters; ///< 按槽位存放的变量值。
+    int m_currentStateIndex = AnimationTransitionProgram::InvalidId; ///< 当前状态在过渡程序中的下标。
     bool EntryPlayed = false; ///< 标记入口动画是否已播放。
     std::unordered_map<std::string, bool> m_animationPlayingStates; ///< 存储动画的播放状态。
     std::unordered_map<std::string, sk_sp<RuntimeAnimationClip>> m_animationClips; ///< 存储所有运行时动画剪辑。
@@ -48,12 +50,6 @@ private:
     bool m_isPlaying = false; ///< 标记动画是否正在播放。
     bool m_justTransitioned = false; ///< 标记是否刚刚完成过渡。
 
-    /**
-     * @brief 评估一组条件是否满足。
-     * @param conditions 要评估的条件列表。
-     * @return 如果所有条件都满足则返回 true，否则返回 false。
-     */
-    bool EvaluateCondition(const std::vector<Condition>& conditions);
     /**
      * @brief 更新基于帧的动画。
      * @param deltaTime 帧之间的时间差。
@@ -129,11 +125,28 @@ public:
      * @param value 变量值（可以是浮点数、布尔值或整数）。
      */
     void SetVariable(const std::string& name, std::variant<float, bool, int> value);
+    /**
+     * @brief 按槽位标识设置变量值，避免按名称查找。
+     * @param id 通过 GetVariableId 获取的变量标识。
+     * @param value 变量值，会被转换为变量的声明类型。
+     */
+    void SetVariable(int id, std::variant<float, bool, int> value);
     /**
      * @brief 触发动画控制器中的一个触发器。
      * @param name 触发器名称。
      */
     void SetTrigger(const std::string& name);
+    /**
+     * @brief 按槽位标识触发一个触发器。
+     * @param id 通过 GetVariableId 获取的触发器标识。
+     */
+    void SetTrigger(int id);
+    /**
+     * @brief 获取变量的槽位标识，供脚本缓存后使用。
+     * @param name 变量名称。
+     * @return 变量标识，不存在时返回 -1。
+     */
+    int GetVariableId(const std::string& name) const;
     /**
      * @brief 设置动画的帧率。
      * @param frameRate 要设置的帧率。
@@ -0,0 +1,367 @@
+#ifndef ANIMATION_TRANSITION_PROGRAM_TESTS_H
+#define ANIMATION_TRANSITION_PROGRAM_TESTS_H
+
+/**
+ * @file AnimationTransitionProgramTests.h
+ * @brief Property-based tests for the compiled animator transition program
+ *
+ * Random controllers are compiled with AnimationTransitionProgram and driven by
+ * random parameter streams. Each step the transition chosen by the compiled
+ * program is compared against a reference evaluator that interprets the
+ * string-keyed Condition lists exactly like the original per-frame evaluator.
+ *
+ * Feature: animator-condition-bytecode
+ */
+
+#include "../RuntimeAsset/AnimationTransitionProgram.h"
+#include "../../Utils/Logger.h"
+#include <random>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+namespace AnimationTransitionProgramTests
+{
+    using VariableMap = std::unordered_map<std::string, std::variant<float, bool, int>>;
+
+    /**
+     * @brief Random generator for animator tests
+     */
+    class AnimatorRandomGenerator
+    {
+    public:
+        explicit AnimatorRandomGenerator(unsigned int seed) : m_gen(seed) {}
+
+        int RandomInt(int min, int max)
+        {
+            std::uniform_int_distribution<int> dist(min, max);
+            return dist(m_gen);
+        }
+
+        float RandomFloat(float min, float max)
+        {
+            std::uniform_real_distribution<float> dist(min, max);
+            return dist(m_gen);
+        }
+
+        bool RandomBool(float probability = 0.5f)
+        {
+            return RandomFloat(0.0f, 1.0f) < probability;
+        }
+
+    private:
+        std::mt19937 m_gen;
+    };
+
+    /**
+     * @brief Test result structure for detailed failure reporting
+     */
+    struct TestResult
+    {
+        bool passed = true;
+        std::string failureMessage;
+        int failedIteration = -1;
+    };
+
+    /**
+     * @brief 参考求值器：与编译前的逐帧字符串求值逻辑一致。
+     */
+    inline bool ReferenceEvaluate(const std::vector<Condition>& conditions, const VariableMap& variables)
+    {
+        for (const auto& condition : conditions)
+        {
+            bool result = false;
+            std::visit([&](auto&& arg)
+            {
+                using T = std::decay_t<decltype(arg)>;
+                auto it = variables.find(arg.VarName);
+                if (it == variables.end()) return;
+
+                if constexpr (std::is_same_v<T, FloatCondition>)
+                {
+                    float v = std::get<float>(it->second);
+                    result = (arg.op == FloatCondition::GreaterThan) ? (v > arg.Value) : (v < arg.Value);
+                }
+                else if constexpr (std::is_same_v<T, IntCondition>)
+                {
+                    int v = std::get<int>(it->second);
+                    switch (arg.op)
+                    {
+                    case IntCondition::GreaterThan: result = v > arg.Value;
+                        break;
+                    case IntCondition::LessThan: result = v < arg.Value;
+                        break;
+                    case IntCondition::Equal: result = v == arg.Value;
+                        break;
+                    case IntCondition::NotEqual: result = v != arg.Value;
+                        break;
+                    }
+                }
+                else if constexpr (std::is_same_v<T, BoolCondition>)
+                {
+                    bool v = std::get<bool>(it->second);
+                    result = (arg.op == BoolCondition::IsTrue) ? v : !v;
+                }
+                else if constexpr (std::is_same_v<T, TriggerCondition>)
+                {
+                    result = std::get<bool>(it->second);
+                }
+            }, condition);
+
+            if (!result) return false;
+        }
+        return true;
+    }
+
+    inline const Transition* ReferenceFindBestTransition(const AnimationControllerData& data,
+                                                         const Guid& current, bool finished,
+                                                         const VariableMap& variables)
+    {
+        const Transition* best = nullptr;
+        auto evaluate = [&](const Transition& t)
+        {
+            if (ReferenceEvaluate(t.Conditions, variables) && (!best || t.priority > best->priority))
+            {
+                best = &t;
+            }
+        };
+
+        if (auto it = data.States.find(SpecialStateGuids::AnyState()); it != data.States.end())
+        {
+            for (const auto& t : it->second.Transitions)
+            {
+                if (t.ToGuid != current) evaluate(t);
+            }
+        }
+        if (auto it = data.States.find(current); it != data.States.end())
+        {
+            for (const auto& t : it->second.Transitions)
+            {
+                if (!t.hasExitTime || finished) evaluate(t);
+            }
+        }
+        return best;
+    }
+
+    /**
+     * @brief 生成一个随机控制器，条件只引用类型匹配的变量或未定义的变量。
+     */
+    inline AnimationControllerData GenerateController(AnimatorRandomGenerator& gen, std::vector<Guid>& outStates)
+    {
+        AnimationControllerData data;
+
+        const int varCount = gen.RandomInt(1, 24);
+        for (int i = 0; i < varCount; ++i)
+        {
+            AnimationVariable var;
+            var.Name = "param_" + std::to_string(i);
+            var.Type = static_cast<VariableType>(gen.RandomInt(0, 3));
+            switch (var.Type)
+            {
+            case VariableType::VariableType_Float: var.Value = gen.RandomFloat(-1.0f, 1.0f);
+                break;
+            case VariableType::VariableType_Int: var.Value = gen.RandomInt(-2, 2);
+                break;
+            default: var.Value = gen.RandomBool();
+                break;
+            }
+            data.Variables.push_back(var);
+        }
+
+        const int stateCount = gen.RandomInt(1, 12);
+        outStates.clear();
+        for (int i = 0; i < stateCount; ++i) outStates.push_back(Guid::NewGuid());
+
+        auto makeCondition = [&]() -> Condition
+        {
+            if (gen.RandomBool(0.05f))
+            {
+                return TriggerCondition{"undefined_param"};
+            }
+            const auto& var = data.Variables[gen.RandomInt(0, varCount - 1)];
+            switch (var.Type)
+            {
+            case VariableType::VariableType_Float:
+                return FloatCondition{static_cast<FloatCondition::Comparison>(gen.RandomInt(0, 1)), var.Name,
+                                      gen.RandomFloat(-1.0f, 1.0f)};
+            case VariableType::VariableType_Int:
+                return IntCondition{static_cast<IntCondition::Comparison>(gen.RandomInt(0, 3)), var.Name,
+                                    gen.RandomInt(-2, 2)};
+            case VariableType::VariableType_Bool:
+                return BoolCondition{static_cast<BoolCondition::Comparison>(gen.RandomInt(0, 1)), var.Name};
+            default:
+                return TriggerCondition{var.Name};
+            }
+        };
+
+        auto makeState = [&]()
+        {
+            AnimationState state;
+            const int transitionCount = gen.RandomInt(0, 16);
+            for (int t = 0; t < transitionCount; ++t)
+            {
+                Transition transition;
+                transition.ToGuid = outStates[gen.RandomInt(0, stateCount - 1)];
+                transition.priority = gen.RandomInt(0, 3);
+                transition.hasExitTime = gen.RandomBool();
+                const int condCount = gen.RandomInt(0, 4);
+                for (int c = 0; c < condCount; ++c) transition.Conditions.push_back(makeCondition());
+                state.Transitions.push_back(transition);
+            }
+            return state;
+        };
+
+        for (const auto& guid : outStates) data.States[guid] = makeState();
+        if (gen.RandomBool(0.8f)) data.States[SpecialStateGuids::AnyState()] = makeState();
+        return data;
+    }
+
+    /**
+     * @brief Property: 编译后的过渡选择与旧求值器一致
+     *
+     * For any controller and any stream of parameter writes, the compiled program
+     * selects the same transition as the reference evaluator, and consuming the
+     * selected transition's triggers leaves both parameter stores equal.
+     */
+    inline TestResult TestProperty_CompiledMatchesReference(int iterations = 100, int stepsPerController = 200)
+    {
+        TestResult result;
+        AnimatorRandomGenerator gen(12345u);
+
+        for (int i = 0; i < iterations; ++i)
+        {
+            std::vector<Guid> states;
+            const AnimationControllerData data = GenerateController(gen, states);
+            const AnimationTransitionProgram program(data);
+
+            VariableMap reference;
+            for (const auto& var : data.Variables)
+            {
+                reference[var.Name] = var.Type == VariableType::VariableType_Trigger
+                                          ? std::variant<float, bool, int>(false)
+                                          : var.Value;
+            }
+            std::vector<AnimationParameterSlot> slots = program.GetDefaultParameters();
+
+            for (int step = 0; step < stepsPerController; ++step)
+            {
+                const auto& var = data.Variables[gen.RandomInt(0, static_cast<int>(data.Variables.size()) - 1)];
+                std::variant<float, bool, int> value;
+                switch (var.Type)
+                {
+                case VariableType::VariableType_Float: value = gen.RandomFloat(-1.0f, 1.0f);
+                    break;
+                case VariableType::VariableType_Int: value = gen.RandomInt(-2, 2);
+                    break;
+                default: value = gen.RandomBool();
+                    break;
+                }
+                reference[var.Name] = value;
+                AnimationTransitionProgram::AssignValue(slots[program.GetParameterId(var.Name)], value);
+
+                const Guid& current = states[gen.RandomInt(0, static_cast<int>(states.size()) - 1)];
+                const bool finished = gen.RandomBool();
+
+                const Transition* expected = ReferenceFindBestTransition(data, current, finished, reference);
+                const CompiledTransition* actual = program.FindBestTransition(
+                    program.FindState(current), current, finished, slots.data());
+
+                if ((actual ? actual->source : nullptr) != expected)
+                {
+                    result.passed = false;
+                    result.failedIteration = i;
+                    std::ostringstream oss;
+                    oss << "Step " << step << ": compiled program chose "
+                        << (actual ? actual->source->TransitionName + "@" + std::to_string(actual->priority) : "none")
+                        << " but reference chose "
+                        << (expected ? expected->TransitionName + "@" + std::to_string(expected->priority) : "none");
+                    result.failureMessage = oss.str();
+                    return result;
+                }
+
+                if (actual)
+                {
+                    program.ConsumeTriggers(*actual, slots.data());
+                    for (const auto& condition : expected->Conditions)
+                    {
+                        if (const auto* trigger = std::get_if<TriggerCondition>(&condition);
+                            trigger && reference.contains(trigger->VarName))
+                        {
+                            reference[trigger->VarName] = false;
+                        }
+                    }
+                }
+            }
+        }
+        return result;
+    }
+
+    /**
+     * @brief Property: 参数标识稳定且与名称查找一致
+     */
+    inline TestResult TestProperty_ParameterIdsResolve(int iterations = 100)
+    {
+        TestResult result;
+        AnimatorRandomGenerator gen(777u);
+
+        for (int i = 0; i < iterations; ++i)
+        {
+            std::vector<Guid> states;
+            const AnimationControllerData data = GenerateController(gen, states);
+            const AnimationTransitionProgram program(data);
+
+            for (const auto& var : data.Variables)
+            {
+                const int id = program.GetParameterId(var.Name);
+                if (id < 0 || program.GetDefaultParameters()[id].type != var.Type)
+                {
+                    result.passed = false;
+                    result.failedIteration = i;
+                    result.failureMessage = "Parameter " + var.Name + " did not resolve to a slot of its type";
+                    return result;
+                }
+            }
+            if (program.GetParameterId("undefined_param") != AnimationTransitionProgram::InvalidId)
+            {
+                result.passed = false;
+                result.failedIteration = i;
+                result.failureMessage = "Undefined parameter resolved to a valid slot";
+                return result;
+            }
+        }
+        return result;
+    }
+
+    inline bool RunTest(const char* name, const TestResult& result)
+    {
+        if (result.passed)
+        {
+            LogInfo("{} PASSED", name);
+            return true;
+        }
+        LogError("{} FAILED at iteration {}: {}", name, result.failedIteration, result.failureMessage);
+        return false;
+    }
+
+    /**
+     * @brief Run all animator transition program tests
+     *
+     * @return true if all tests pass, false otherwise
+     */
+    inline bool RunAllAnimationTransitionProgramTests()
+    {
+        LogInfo("=== Running Animation Transition Program Tests ===");
+
+        bool allPassed = true;
+        allPassed &= RunTest("Compiled transitions match reference evaluator",
+                             TestProperty_CompiledMatchesReference());
+        allPassed &= RunTest("Parameter ids resolve", TestProperty_ParameterIdsResolve());
+
+        LogInfo("=== Animation Transition Program Tests Complete ===");
+        return allPassed;
+    }
+}
+
+#endif // ANIMATION_TRANSITION_PROGRAM_TESTS_H
@@ -0,0 +1,530 @@
+#ifndef ASSET_PACKAGE_TESTS_H
+#define ASSET_PACKAGE_TESTS_H
+
+/**
+ * @file AssetPackageTests.h
+ * @brief Property-based tests for the per-asset random-access package format
+ *
+ * Random sets of records are written with AssetPackageBuilder and read back
+ * through AssetPackage. Every record must round-trip byte for byte; flipping a
+ * byte in a data file, swapping two records, editing the index or truncating
+ * any file must be reported instead of returning wrong data. The benchmark
+ * compares per-asset load latency with the previous single-blob layout.
+ *
+ * Feature: asset-package-records
+ */
+
+#include "../AssetPackage.h"
+#include "../../Utils/EngineCrypto.h"
+#include "../../Utils/Logger.h"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace AssetPackageTests
+{
+    /**
+     * @brief Random generator for package tests
+     */
+    class PackageRandomGenerator
+    {
+    public:
+        explicit PackageRandomGenerator(unsigned int seed) : m_gen(seed) {}
+
+        int RandomInt(int min, int max)
+        {
+            std::uniform_int_distribution<int> dist(min, max);
+            return dist(m_gen);
+        }
+
+        bool RandomBool(float probability = 0.5f)
+        {
+            std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+            return dist(m_gen) < probability;
+        }
+
+        Guid RandomGuid()
+        {
+            std::array<uint8_t, 16> bytes;
+            for (auto& b : bytes)
+                b = static_cast<uint8_t>(RandomInt(0, 255));
+            return Guid(bytes);
+        }
+
+    private:
+        std::mt19937 m_gen;
+    };
+
+    /**
+     * @brief Test result structure for detailed failure reporting
+     */
+    struct TestResult
+    {
+        bool passed = true;
+        std::string failureMessage;
+        int failedIteration = -1;
+    };
+
+    /**
+     * @brief Scratch directory removed on destruction
+     */
+    class ScratchDirectory
+    {
+    public:
+        explicit ScratchDirectory(const char* name)
+        {
+            static std::atomic<int> counter{0};
+            m_path = std::filesystem::temp_directory_path() /
+                (std::string("luma_") + name + "_" + std::to_string(counter++) + "_" +
+                 std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()));
+            std::filesystem::create_directories(m_path);
+        }
+
+        ~ScratchDirectory()
+        {
+            std::error_code ec;
+            std::filesystem::remove_all(m_path, ec);
+        }
+
+        const std::filesystem::path& Path() const { return m_path; }
+
+    private:
+        std::filesystem::path m_path;
+    };
+
+    /**
+     * @brief Random record: empty, repetitive text-like bytes (compressible) or noise
+     */
+    inline std::vector<uint8_t> RandomPayload(PackageRandomGenerator& gen)
+    {
+        const int kind = gen.RandomInt(0, 9);
+        if (kind == 0) return {};
+        const int size = gen.RandomInt(1, kind < 5 ? 200 : 3000);
+        std::vector<uint8_t> data(static_cast<size_t>(size));
+        if (kind % 2 == 0)
+        {
+            for (auto& b : data)
+                b = static_cast<uint8_t>(gen.RandomInt(0, 255));
+        }
+        else
+        {
+            const char* words[] = {"assetPath", "Textures/", "importerSettings", ".png", "guid", "fileHash"};
+            size_t pos = 0;
+            while (pos < data.size())
+            {
+                const char* word = words[gen.RandomInt(0, 5)];
+                for (size_t k = 0; word[k] && pos < data.size(); ++k)
+                    data[pos++] = static_cast<uint8_t>(word[k]);
+            }
+        }
+        return data;
+    }
+
+    struct BuiltPackage
+    {
+        std::vector<Guid> guids;
+        std::vector<std::vector<uint8_t>> payloads;
+        std::filesystem::path manifest;
+    };
+
+    inline BuiltPackage BuildPackage(PackageRandomGenerator& gen, const std::filesystem::path& directory, int count,
+                                     int fileCount, const std::vector<std::vector<uint8_t>>& extra = {})
+    {
+        BuiltPackage built;
+        AssetPackageBuilder builder;
+        for (int i = 0; i < count; ++i)
+            built.payloads.push_back(RandomPayload(gen));
+        built.payloads.insert(built.payloads.end(), extra.begin(), extra.end());
+        for (const auto& payload : built.payloads)
+        {
+            built.guids.push_back(gen.RandomGuid());
+            builder.Add(built.guids.back(), payload);
+        }
+        builder.Write(directory, fileCount);
+        built.manifest = directory / AssetPackageFormat::ManifestFileName;
+        return built;
+    }
+
+    inline std::vector<std::string> ReadManifestNames(const std::filesystem::path& manifest)
+    {
+        std::vector<std::string> names;
+        std::ifstream file(manifest);
+        std::string line;
+        while (std::getline(file, line))
+        {
+            if (!line.empty()) names.push_back(line);
+        }
+        return names;
+    }
+
+    inline std::vector<char> ReadFile(const std::filesystem::path& path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        return std::vector<char>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    inline void WriteFile(const std::filesystem::path& path, const std::vector<char>& data)
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file.write(data.data(), static_cast<std::streamsize>(data.size()));
+    }
+
+    /**
+     * @brief 逐条读出并与写入的数据比较；expectCorrupt 返回 true 的记录必须报告 Corrupt
+     */
+    template <typename Pred>
+    inline std::string CheckRecords(const AssetPackage& package, const BuiltPackage& built, Pred expectCorrupt)
+    {
+        std::vector<uint8_t> data;
+        for (size_t i = 0; i < built.guids.size(); ++i)
+        {
+            const AssetPackageFormat::IndexEntry* entry = package.Find(built.guids[i]);
+            if (!entry) return "record " + std::to_string(i) + " missing from index";
+            const auto result = package.Read(*entry, data);
+            if (expectCorrupt(*entry))
+            {
+                if (result != AssetPackage::ReadResult::Corrupt)
+                    return "damaged record " + std::to_string(i) + " was not reported as corrupt";
+            }
+            else if (result != AssetPackage::ReadResult::Ok || data != built.payloads[i])
+            {
+                return "record " + std::to_string(i) + " did not round-trip";
+            }
+        }
+        return {};
+    }
+
+    /**
+     * @brief Property: every record reads back unchanged; the index is sorted and unknown GUIDs are missing
+     */
+    inline TestResult TestProperty_RecordsRoundTrip(int iterations = 20)
+    {
+        TestResult result;
+        PackageRandomGenerator gen(4901u);
+
+        for (int i = 0; i < iterations; ++i)
+        {
+            ScratchDirectory scratch("asset_package");
+            const BuiltPackage built = BuildPackage(gen, scratch.Path(), gen.RandomInt(0, 300), gen.RandomInt(1, 8));
+
+            AssetPackage package;
+            std::string failure;
+            if (!package.Open(built.manifest))
+                failure = "package failed to open";
+            else if (package.GetAssetCount() != built.guids.size())
+                failure = "asset count " + std::to_string(package.GetAssetCount()) + ", expected " +
+                    std::to_string(built.guids.size());
+            else
+                failure = CheckRecords(package, built, [](const auto&) { return false; });
+
+            for (size_t k = 1; failure.empty() && k < package.GetAssetCount(); ++k)
+            {
+                if (std::memcmp(package.GetEntries()[k - 1].guid, package.GetEntries()[k].guid, 16) >= 0)
+                    failure = "index is not sorted at entry " + std::to_string(k);
+            }
+            std::vector<uint8_t> data;
+            if (failure.empty() && package.Read(gen.RandomGuid(), data) != AssetPackage::ReadResult::Missing)
+                failure = "unknown guid was not reported missing";
+
+            if (!failure.empty())
+            {
+                result.passed = false;
+                result.failedIteration = i;
+                result.failureMessage = failure;
+                return result;
+            }
+        }
+        return result;
+    }
+
+    /**
+     * @brief Property: a flipped byte in a data file or two swapped records are rejected; other records still load
+     */
+    inline TestResult TestProperty_TamperedRecordsRejected(int iterations = 30)
+    {
+        TestResult result;
+        PackageRandomGenerator gen(4902u);
+
+        for (int i = 0; i < iterations; ++i)
+        {
+            ScratchDirectory scratch("asset_package_tamper");
+            // 末尾两条记录等长，交换后索引仍指向合法的密文
+            const BuiltPackage built = BuildPackage(gen, scratch.Path(), gen.RandomInt(2, 120), gen.RandomInt(1, 4),
+                                                    {std::vector<uint8_t>(100, 1), std::vector<uint8_t>(100, 2)});
+            const auto names = ReadManifestNames(built.manifest);
+
+            AssetPackage clean;
+            clean.Open(built.manifest);
+            const AssetPackageFormat::IndexEntry a = *clean.Find(built.guids[built.guids.size() - 2]);
+            const AssetPackageFormat::IndexEntry b = *clean.Find(built.guids.back());
+            clean.Close();
+
+            std::string failure;
+            if (gen.RandomBool() || a.size != b.size)
+            {
+                const int fileIndex = gen.RandomInt(0, static_cast<int>(names.size()) - 1);
+                auto bytes = ReadFile(scratch.Path() / names[fileIndex]);
+                if (bytes.empty()) continue;
+                const size_t pos = static_cast<size_t>(gen.RandomInt(0, static_cast<int>(bytes.size()) - 1));
+                bytes[pos] = static_cast<char>(bytes[pos] ^ (1 << gen.RandomInt(0, 7)));
+                WriteFile(scratch.Path() / names[fileIndex], bytes);
+
+                AssetPackage package;
+                if (!package.Open(built.manifest))
+                    failure = "package with a damaged data file failed to open";
+                else
+                    failure = CheckRecords(package, built, [&](const AssetPackageFormat::IndexEntry& entry)
+                    {
+                        return entry.file == fileIndex && pos >= entry.offset && pos < entry.offset + entry.size;
+                    });
+            }
+            else
+            {
+                auto bytesA = ReadFile(scratch.Path() / names[a.file]);
+                auto bytesB = ReadFile(scratch.Path() / names[b.file]);
+                std::vector<char> recordA(bytesA.begin() + a.offset, bytesA.begin() + a.offset + a.size);
+                std::vector<char> recordB(bytesB.begin() + b.offset, bytesB.begin() + b.offset + b.size);
+                if (a.file == b.file)
+                {
+                    std::copy(recordB.begin(), recordB.end(), bytesA.begin() + a.offset);
+                    std::copy(recordA.begin(), recordA.end(), bytesA.begin() + b.offset);
+                    WriteFile(scratch.Path() / names[a.file], bytesA);
+                }
+                else
+                {
+                    std::copy(recordB.begin(), recordB.end(), bytesA.begin() + a.offset);
+                    std::copy(recordA.begin(), recordA.end(), bytesB.begin() + b.offset);
+                    WriteFile(scratch.Path() / names[a.file], bytesA);
+                    WriteFile(scratch.Path() / names[b.file], bytesB);
+                }
+
+                AssetPackage package;
+                if (!package.Open(built.manifest))
+                    failure = "package with swapped records failed to open";
+                else
+                    failure = CheckRecords(package, built, [&](const AssetPackageFormat::IndexEntry& entry)
+                    {
+                        return std::memcmp(entry.guid, a.guid, 16) == 0 || std::memcmp(entry.guid, b.guid, 16) == 0;
+                    });
+            }
+
+            if (!failure.empty())
+            {
+                result.passed = false;
+                result.failedIteration = i;
+                result.failureMessage = failure;
+                return result;
+            }
+        }
+        return result;
+    }
+
+    /**
+     * @brief Property: any edit to the index, or a missing data file, makes Open fail
+     */
+    inline TestResult TestProperty_TamperedIndexRejected(int iterations = 30)
+    {
+        TestResult result;
+        PackageRandomGenerator gen(4903u);
+
+        for (int i = 0; i < iterations; ++i)
+        {
+            ScratchDirectory scratch("asset_package_index");
+            const BuiltPackage built = BuildPackage(gen, scratch.Path(), gen.RandomInt(1, 80), gen.RandomInt(1, 4));
+            const auto indexPath = scratch.Path() / AssetPackageFormat::IndexFileName;
+
+            std::string mode;
+            if (gen.RandomBool(0.8f))
+            {
+                auto bytes = ReadFile(indexPath);
+                const size_t pos = static_cast<size_t>(gen.RandomInt(0, static_cast<int>(bytes.size()) - 1));
+                bytes[pos] = static_cast<char>(bytes[pos] ^ (1 << gen.RandomInt(0, 7)));
+                WriteFile(indexPath, bytes);
+                mode = "index byte " + std::to_string(pos) + " flipped";
+            }
+            else
+            {
+                const auto names = ReadManifestNames(built.manifest);
+                std::filesystem::remove(scratch.Path() / names[gen.RandomInt(0, static_cast<int>(names.size()) - 1)]);
+                mode = "data file removed";
+            }
+
+            AssetPackage package;
+            if (package.Open(built.manifest))
+            {
+                result.passed = false;
+                result.failedIteration = i;
+                result.failureMessage = "package opened after " + mode;
+                return result;
+            }
+        }
+        return result;
+    }
+
+    /**
+     * @brief Property: truncating a data file only loses the records past the cut; a truncated index never opens
+     */
+    inline TestResult TestProperty_TruncationDetected(int iterations = 30)
+    {
+        TestResult result;
+        PackageRandomGenerator gen(4904u);
+
+        for (int i = 0; i < iterations; ++i)
+        {
+            ScratchDirectory scratch("asset_package_truncate");
+            const BuiltPackage built = BuildPackage(gen, scratch.Path(), gen.RandomInt(1, 150), gen.RandomInt(1, 4));
+            const auto names = ReadManifestNames(built.manifest);
+
+            std::string failure;
+            if (gen.RandomBool(0.7f))
+            {
+                const int fileIndex = gen.RandomInt(0, static_cast<int>(names.size()) - 1);
+                const auto path = scratch.Path() / names[fileIndex];
+                const auto size = std::filesystem::file_size(path);
+                if (size == 0) continue;
+                const auto cut = static_cast<size_t>(gen.RandomInt(0, static_cast<int>(size) - 1));
+                std::filesystem::resize_file(path, cut);
+
+                AssetPackage package;
+                if (!package.Open(built.manifest))
+                    failure = "package with a truncated data file failed to open";
+                else
+                    failure = CheckRecords(package, built, [&](const AssetPackageFormat::IndexEntry& entry)
+                    {
+                        return entry.file == fileIndex && entry.offset + entry.size > cut;
+                    });
+            }
+            else
+            {
+                const auto indexPath = scratch.Path() / AssetPackageFormat::IndexFileName;
+                const auto size = std::filesystem::file_size(indexPath);
+                std::filesystem::resize_file(indexPath, static_cast<size_t>(gen.RandomInt(0, static_cast<int>(size) - 1)));
+                AssetPackage package;
+                if (package.Open(built.manifest))
+                    failure = "package opened with a truncated index";
+            }
+
+            if (!failure.empty())
+            {
+                result.passed = false;
+                result.failedIteration = i;
+                result.failureMessage = failure;
+                return result;
+            }
+        }
+        return result;
+    }
+
+    /**
+     * @brief Benchmark: per-asset load latency for a large package, record layout versus one encrypted msgpack blob
+     *
+     * The blob path mirrors the previous LoadSingleAsset: the decrypted package is cached, but every request copies
+     * it and parses the whole msgpack root to find one asset.
+     */
+    inline void RunAssetPackageBenchmark(int assetCount = 50000, int samples = 2000, int blobSamples = 5)
+    {
+        using Clock = std::chrono::steady_clock;
+        LogInfo("=== Asset Package Benchmark ({} assets) ===", assetCount);
+
+        PackageRandomGenerator gen(4905u);
+        std::vector<Guid> guids;
+        nlohmann::json root = nlohmann::json::object();
+        AssetPackageBuilder builder;
+        for (int i = 0; i < assetCount; ++i)
+        {
+            const Guid guid = gen.RandomGuid();
+            const std::string name = "Asset_" + std::to_string(i);
+            nlohmann::json meta = {
+                {"guid", guid.ToString()},
+                {"fileHash", std::to_string(gen.RandomInt(0, INT32_MAX)) + std::to_string(gen.RandomInt(0, INT32_MAX))},
+                {"assetPath", "Textures/Environment/" + name + ".png"},
+                {"type", gen.RandomInt(1, 17)},
+                {"addressName", name},
+                {"groupNames", nlohmann::json::array({"Default"})},
+                {"importerSettings", "filterMode: Linear\nwrapMode: Repeat\nppu: 32\nmipmaps: false\n"}
+            };
+            guids.push_back(guid);
+            builder.Add(guid, nlohmann::json::to_msgpack(meta));
+            root[guid.ToString()] = std::move(meta);
+        }
+
+        ScratchDirectory scratch("asset_package_bench");
+        auto start = Clock::now();
+        builder.Write(scratch.Path(), 8);
+        const double writeMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+        AssetPackage package;
+        start = Clock::now();
+        package.Open(scratch.Path() / AssetPackageFormat::ManifestFileName);
+        const double openMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+        std::vector<uint8_t> data;
+        size_t parsed = 0;
+        start = Clock::now();
+        for (int i = 0; i < samples; ++i)
+        {
+            package.Read(guids[static_cast<size_t>(gen.RandomInt(0, assetCount - 1))], data);
+            parsed += nlohmann::json::from_msgpack(data).size();
+        }
+        const double recordUs = std::chrono::duration<double, std::micro>(Clock::now() - start).count() / samples;
+
+        const std::vector<uint8_t> blob = nlohmann::json::to_msgpack(root);
+        const auto encrypted = EngineCrypto::GetInstance().Encrypt(std::vector<unsigned char>(blob.begin(), blob.end()));
+        start = Clock::now();
+        const auto cached = EngineCrypto::GetInstance().Decrypt(encrypted);
+        const double blobOpenMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        start = Clock::now();
+        for (int i = 0; i < blobSamples; ++i)
+        {
+            std::vector<uint8_t> copy(cached.begin(), cached.end());
+            nlohmann::json all = nlohmann::json::from_msgpack(copy);
+            parsed += all[guids[static_cast<size_t>(gen.RandomInt(0, assetCount - 1))].ToString()].size();
+        }
+        const double blobUs = std::chrono::duration<double, std::micro>(Clock::now() - start).count() / blobSamples;
+
+        LogInfo("Write: {:.1f} ms, open (index MAC + key derivation): {:.2f} ms, blob decrypt: {:.2f} ms", writeMs,
+                openMs, blobOpenMs);
+        LogInfo("Per-asset load: {:.1f} us (records) vs {:.0f} us (blob re-parse), {:.0f}x ({} fields read)",
+                recordUs, blobUs, blobUs / recordUs, parsed);
+    }
+
+    inline bool RunTest(const char* name, const TestResult& result)
+    {
+        if (result.passed)
+        {
+            LogInfo("{} PASSED", name);
+            return true;
+        }
+        LogError("{} FAILED at iteration {}: {}", name, result.failedIteration, result.failureMessage);
+        return false;
+    }
+
+    /**
+     * @brief Run all asset package tests
+     *
+     * @return true if all tests pass, false otherwise
+     */
+    inline bool RunAllAssetPackageTests()
+    {
+        LogInfo("=== Running Asset Package Tests ===");
+
+        bool allPassed = true;
+        allPassed &= RunTest("Records round-trip", TestProperty_RecordsRoundTrip());
+        allPassed &= RunTest("Tampered records rejected", TestProperty_TamperedRecordsRejected());
+        allPassed &= RunTest("Tampered index rejected", TestProperty_TamperedIndexRejected());
+        allPassed &= RunTest("Truncation detected", TestProperty_TruncationDetected());
+
+        LogInfo("=== Asset Package Tests Complete ===");
+        return allPassed;
+    }
+}
+
+#endif // ASSET_PACKAGE_TESTS_H
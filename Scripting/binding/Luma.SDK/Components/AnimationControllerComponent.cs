@@ -94,6 +94,34 @@ public class AnimationController : LogicComponent<AnimationControllerComponent>
         Native.AnimationController_SetTrigger(Entity.ScenePtr, Entity.Id, name);
     }
     
+    /// <summary>
+    /// 获取参数标识。缓存后可通过按标识的重载设置参数，避免每次按名称查找。
+    /// </summary>
+    public int GetParameterId(string name)
+    {
+        return Native.AnimationController_GetParameterId(Entity.ScenePtr, Entity.Id, name);
+    }
+
+    public void SetFloat(int id, float value)
+    {
+        Native.AnimationController_SetFloatById(Entity.ScenePtr, Entity.Id, id, value);
+    }
+
+    public void SetBool(int id, bool value)
+    {
+        Native.AnimationController_SetBoolById(Entity.ScenePtr, Entity.Id, id, value);
+    }
+
+    public void SetInt(int id, int value)
+    {
+        Native.AnimationController_SetIntById(Entity.ScenePtr, Entity.Id, id, value);
+    }
+
+    public void SetTrigger(int id)
+    {
+        Native.AnimationController_SetTriggerById(Entity.ScenePtr, Entity.Id, id);
+    }
+    
     public void SetFrameRate(float frameRate)
     {
         Native.AnimationController_SetFrameRate(Entity.ScenePtr, Entity.Id, frameRate);
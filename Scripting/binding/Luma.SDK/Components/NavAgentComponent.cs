@@ -34,8 +34,45 @@ public class NavAgent : ILogicComponent
         set => Native.NavAgent_SetSpeed(Entity.ScenePtr, Entity.Id, value);
     }
 
+    public int PathPriority
+    {
+        get => Native.NavAgent_GetPathPriority(Entity.ScenePtr, Entity.Id);
+        set => Native.NavAgent_SetPathPriority(Entity.ScenePtr, Entity.Id, value);
+    }
+
+    public bool IsPathSmoothingEnabled => Native.NavAgent_IsPathSmoothingEnabled(Entity.ScenePtr, Entity.Id);
+
+    public float CornerRadius => Native.NavAgent_GetCornerRadius(Entity.ScenePtr, Entity.Id);
+
+    public bool IsAvoidanceEnabled => Native.NavAgent_IsAvoidanceEnabled(Entity.ScenePtr, Entity.Id);
+
+    public Vector2 Velocity
+    {
+        get
+        {
+            Native.NavAgent_GetVelocity(Entity.ScenePtr, Entity.Id, out float x, out float y);
+            return new Vector2 { X = x, Y = y };
+        }
+    }
+
     public bool HasArrived => Native.NavAgent_HasArrived(Entity.ScenePtr, Entity.Id);
 
+    /// <summary>
+    /// 开启或关闭路径拉直。cornerRadius 大于 0 时在拉直后按该半径圆化拐角。
+    /// </summary>
+    public void SetPathSmoothing(bool enabled, float cornerRadius = 0.0f)
+    {
+        Native.NavAgent_SetPathSmoothing(Entity.ScenePtr, Entity.Id, enabled, cornerRadius);
+    }
+
+    /// <summary>
+    /// 开启或关闭与其他代理之间的局部避让。maxSpeed 不大于 0 时使用 Speed。
+    /// </summary>
+    public void SetAvoidance(bool enabled, float radius = 16.0f, float maxSpeed = 0.0f, int maxNeighbors = 10)
+    {
+        Native.NavAgent_SetAvoidance(Entity.ScenePtr, Entity.Id, enabled, radius, maxSpeed, maxNeighbors);
+    }
+
     public void SetDestination(Vector2 target)
     {
         Native.NavAgent_SetDestination(Entity.ScenePtr, Entity.Id, target.X, target.Y);
@@ -153,6 +153,22 @@ internal static class Native
     [DllImport(DllName, CharSet = CharSet.Ansi)]
     internal static extern void AnimationController_SetTrigger(IntPtr scene, uint entity, string name);
 
+    [DllImport(DllName, CharSet = CharSet.Ansi)]
+    internal static extern int AnimationController_GetParameterId(IntPtr scene, uint entity, string name);
+
+    [DllImport(DllName)]
+    internal static extern void AnimationController_SetFloatById(IntPtr scene, uint entity, int id, float value);
+
+    [DllImport(DllName)]
+    internal static extern void AnimationController_SetBoolById(IntPtr scene, uint entity, int id,
+        [MarshalAs(UnmanagedType.I1)] bool value);
+
+    [DllImport(DllName)]
+    internal static extern void AnimationController_SetIntById(IntPtr scene, uint entity, int id, int value);
+
+    [DllImport(DllName)]
+    internal static extern void AnimationController_SetTriggerById(IntPtr scene, uint entity, int id);
+
     [DllImport(DllName)]
     internal static extern void AnimationController_SetFrameRate(IntPtr scene, uint entity, float frameRate);
 
@@ -748,6 +764,34 @@ internal static class Native
     [DllImport(DllName)]
     internal static extern float NavAgent_GetSpeed(IntPtr scene, uint entity);
 
+    [DllImport(DllName)]
+    internal static extern void NavAgent_SetPathPriority(IntPtr scene, uint entity, int priority);
+
+    [DllImport(DllName)]
+    internal static extern int NavAgent_GetPathPriority(IntPtr scene, uint entity);
+
+    [DllImport(DllName)]
+    internal static extern void NavAgent_SetPathSmoothing(IntPtr scene, uint entity,
+        [MarshalAs(UnmanagedType.I1)] bool enabled, float cornerRadius);
+
+    [DllImport(DllName)]
+    [return: MarshalAs(UnmanagedType.I1)]
+    internal static extern bool NavAgent_IsPathSmoothingEnabled(IntPtr scene, uint entity);
+
+    [DllImport(DllName)]
+    internal static extern float NavAgent_GetCornerRadius(IntPtr scene, uint entity);
+
+    [DllImport(DllName)]
+    internal static extern void NavAgent_SetAvoidance(IntPtr scene, uint entity,
+        [MarshalAs(UnmanagedType.I1)] bool enabled, float radius, float maxSpeed, int maxNeighbors);
+
+    [DllImport(DllName)]
+    [return: MarshalAs(UnmanagedType.I1)]
+    internal static extern bool NavAgent_IsAvoidanceEnabled(IntPtr scene, uint entity);
+
+    [DllImport(DllName)]
+    internal static extern void NavAgent_GetVelocity(IntPtr scene, uint entity, out float outX, out float outY);
+
     [DllImport(DllName)]
     [return: MarshalAs(UnmanagedType.I1)]
     internal static extern bool NavAgent_HasArrived(IntPtr scene, uint entity);
@@ -10,6 +10,8 @@ struct SimParams {
     height: u32,
     frame: u32,
     dt: f32,
+    origin_x: u32,
+    origin_y: u32,
 }
 
 @group(0) @binding(0) var<storage, read> input: array<Pixel>;
@@ -25,8 +27,11 @@ const STEAM: u32 = 5u;
 const OIL: u32   = 6u;
 const LAVA: u32  = 7u;
 
+// x, y 为逻辑坐标：缓冲按环面寻址，逻辑 (0, 0) 位于 (origin_x, origin_y)
 fn idx(x: u32, y: u32) -> u32 {
-    return y * params.width + x;
+    let px = (x + params.origin_x) % params.width;
+    let py = (y + params.origin_y) % params.height;
+    return py * params.width + px;
 }
 
 fn in_bounds(x: i32, y: i32) -> bool {
@@ -86,7 +91,8 @@ fn main(@builtin(global_invocation_id) gid: vec3u) {
 
     let ix = i32(x);
     let iy = i32(y);
-    let rng = hash(x * 15823u + y * 9737u + params.frame * 6271u);
+    // 随机数取缓冲坐标，窗口滚动时留在原位的像素随机选择不变
+    let rng = hash((i % params.width) * 15823u + (i / params.width) * 9737u + params.frame * 6271u);
 
     switch (me.pixel_type) {
         case 1u: { // sand
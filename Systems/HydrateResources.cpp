@@ -1011,6 +1011,7 @@ namespace Systems
                 }
             }
         }
+        ++tilemap.runtimeRevision;
 
         std::vector<ECS::Vector2i> coordsToDelete;
         for (const auto& [coord, guid] : tilemap.instantiatedPrefabs)
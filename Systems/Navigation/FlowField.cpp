@@ -0,0 +1,241 @@
+#include "FlowField.h"
+#include "../../Event/JobSystem.h"
+#include <algorithm>
+#include <cmath>
+
+namespace Navigation
+{
+    namespace
+    {
+        static constexpr int DX8[] = {-1, 0, 1, 0, -1, -1, 1, 1};
+        static constexpr int DY8[] = {0, -1, 0, 1, -1, 1, -1, 1};
+        static constexpr float SQRT2 = 1.41421356f;
+
+        bool SameRect(const NavRect& a, const NavRect& b)
+        {
+            if (a.IsEmpty() || b.IsEmpty()) return a.IsEmpty() && b.IsEmpty();
+            return a.minX == b.minX && a.minY == b.minY && a.maxX == b.maxX && a.maxY == b.maxY;
+        }
+    }
+
+    void FlowField::Build(const NavGrid& grid, int goalX, int goalY, const NavRect& bounds, SearchContext& context)
+    {
+        m_goalX = goalX;
+        m_goalY = goalY;
+        m_bounds = bounds;
+        m_revision = grid.revision;
+        m_rect = {0, 0, grid.width - 1, grid.height - 1};
+        if (!bounds.IsEmpty())
+        {
+            m_rect.minX = std::max(m_rect.minX, bounds.minX);
+            m_rect.minY = std::max(m_rect.minY, bounds.minY);
+            m_rect.maxX = std::min(m_rect.maxX, bounds.maxX);
+            m_rect.maxY = std::min(m_rect.maxY, bounds.maxY);
+        }
+
+        const size_t cellCount = m_rect.IsEmpty()
+                                     ? 0
+                                     : static_cast<size_t>(m_rect.Width()) * static_cast<size_t>(m_rect.Height());
+        m_integration.assign(cellCount, Unreachable);
+        m_direction.assign(cellCount, NoDirection);
+        if (!m_rect.Contains(goalX, goalY) || !grid.IsWalkable(goalX, goalY))
+            return;
+
+        auto walkable = [&](int x, int y) { return m_rect.Contains(x, y) && grid.IsWalkable(x, y); };
+        const int width = m_rect.Width();
+
+        // 移动规则对称（对角移动要求两侧正交格都可走），从目标反向搜索即得到各格到目标的距离
+        context.Begin(cellCount);
+        context.Relax(static_cast<int32_t>(Index(goalX, goalY)), 0.0f, 0.0f, SearchContext::NoParent);
+        while (!context.OpenEmpty())
+        {
+            const int32_t cur = context.PopMin();
+            const int cx = m_rect.minX + cur % width;
+            const int cy = m_rect.minY + cur / width;
+            const float g = context.G(cur);
+            const float curCost = grid.GetCost(cx, cy);
+            m_integration[static_cast<size_t>(cur)] = g;
+
+            const int32_t parent = context.Parent(cur);
+            if (parent != SearchContext::NoParent)
+            {
+                const int dx = (m_rect.minX + parent % width) - cx;
+                const int dy = (m_rect.minY + parent / width) - cy;
+                for (uint8_t d = 0; d < 8; ++d)
+                {
+                    if (DX8[d] == dx && DY8[d] == dy)
+                    {
+                        m_direction[static_cast<size_t>(cur)] = d;
+                        break;
+                    }
+                }
+            }
+
+            for (int d = 0; d < 8; ++d)
+            {
+                const int nx = cx + DX8[d];
+                const int ny = cy + DY8[d];
+                if (!walkable(nx, ny)) continue;
+                if (d >= 4 && (!walkable(cx + DX8[d], cy) || !walkable(cx, cy + DY8[d]))) continue;
+                // 反向搜索：从 (nx, ny) 走进当前格，按当前格的代价计费
+                context.Relax(static_cast<int32_t>(Index(nx, ny)), g + ((d >= 4) ? SQRT2 : 1.0f) * curCost, 0.0f, cur);
+            }
+        }
+    }
+
+    bool FlowField::Direction(int x, int y, int& dx, int& dy) const
+    {
+        if (!Contains(x, y)) return false;
+        const uint8_t d = m_direction[Index(x, y)];
+        if (d == NoDirection) return false;
+        dx = DX8[d];
+        dy = DY8[d];
+        return true;
+    }
+
+    ECS::Vector2f FlowField::SampleDirection(const NavGrid& grid, ECS::Vector2f position) const
+    {
+        const auto [x, y] = grid.WorldToGrid(position);
+        int dx, dy;
+        if (!Direction(x, y, dx, dy)) return {0.0f, 0.0f};
+        const ECS::Vector2f target = grid.GridToWorld(x + dx, y + dy);
+        const float tx = target.x - position.x;
+        const float ty = target.y - position.y;
+        const float length = std::sqrt(tx * tx + ty * ty);
+        if (length <= 0.0f) return {0.0f, 0.0f};
+        return {tx / length, ty / length};
+    }
+
+    int FlowFieldService::FindEntry(int goalX, int goalY, const NavRect& bounds) const
+    {
+        for (size_t i = 0; i < m_entries.size(); ++i)
+        {
+            const FlowField& field = *m_entries[i].field;
+            if (field.GetGoalX() == goalX && field.GetGoalY() == goalY && SameRect(field.GetBounds(), bounds))
+                return static_cast<int>(i);
+        }
+        return -1;
+    }
+
+    std::shared_ptr<const FlowField> FlowFieldService::Acquire(const NavGrid& grid, int goalX, int goalY,
+                                                               const NavRect& bounds)
+    {
+        if (m_entries.empty())
+        {
+            m_revision = grid.revision;
+            m_width = grid.width;
+            m_height = grid.height;
+        }
+
+        const int index = FindEntry(goalX, goalY, bounds);
+        if (index >= 0)
+        {
+            Entry& entry = m_entries[static_cast<size_t>(index)];
+            if (entry.dirty)
+            {
+                entry.field->Build(grid, goalX, goalY, bounds, SearchContext::ForCurrentThread());
+                entry.dirty = false;
+            }
+            return entry.field;
+        }
+
+        auto field = std::make_shared<FlowField>();
+        field->Build(grid, goalX, goalY, bounds, SearchContext::ForCurrentThread());
+        m_entries.push_back({field, false});
+        return field;
+    }
+
+    std::shared_ptr<const FlowField> FlowFieldService::Find(int goalX, int goalY, const NavRect& bounds) const
+    {
+        const int index = FindEntry(goalX, goalY, bounds);
+        return index >= 0 ? m_entries[static_cast<size_t>(index)].field : nullptr;
+    }
+
+    int FlowFieldService::GetReferenceCount(int goalX, int goalY, const NavRect& bounds) const
+    {
+        const int index = FindEntry(goalX, goalY, bounds);
+        return index >= 0 ? static_cast<int>(m_entries[static_cast<size_t>(index)].field.use_count()) - 1 : 0;
+    }
+
+    void FlowFieldService::Update(const NavGrid& grid)
+    {
+        // 只剩缓存自身持有的流场已无人使用
+        m_entries.erase(std::remove_if(m_entries.begin(), m_entries.end(),
+                                       [](const Entry& entry) { return entry.field.use_count() <= 1; }),
+                        m_entries.end());
+
+        if (grid.width != m_width || grid.height != m_height ||
+            !grid.ForEachChangeSince(m_revision, [&](int x, int y)
+            {
+                for (auto& entry : m_entries)
+                {
+                    if (entry.field->Contains(x, y))
+                        entry.dirty = true;
+                }
+            }))
+        {
+            for (auto& entry : m_entries)
+                entry.dirty = true;
+        }
+        m_revision = grid.revision;
+        m_width = grid.width;
+        m_height = grid.height;
+
+        std::vector<FlowField*> dirty;
+        for (auto& entry : m_entries)
+        {
+            if (!entry.dirty) continue;
+            dirty.push_back(entry.field.get());
+            entry.dirty = false;
+        }
+        if (!dirty.empty())
+            Rebuild(grid, dirty);
+    }
+
+    void FlowFieldService::Rebuild(const NavGrid& grid, const std::vector<FlowField*>& fields)
+    {
+        if (fields.size() == 1)
+        {
+            FlowField& field = *fields.front();
+            field.Build(grid, field.GetGoalX(), field.GetGoalY(), field.GetBounds(), SearchContext::ForCurrentThread());
+            return;
+        }
+
+        struct FlowFieldJob : public IJob
+        {
+            const NavGrid* grid;
+            FlowField* field;
+
+            FlowFieldJob(const NavGrid* g, FlowField* f) : grid(g), field(f)
+            {
+            }
+
+            void Execute() override
+            {
+                field->Build(*grid, field->GetGoalX(), field->GetGoalY(), field->GetBounds(),
+                             SearchContext::ForCurrentThread());
+            }
+        };
+
+        std::vector<FlowFieldJob> jobs;
+        std::vector<JobHandle> handles;
+        jobs.reserve(fields.size());
+        for (FlowField* field : fields)
+            jobs.emplace_back(&grid, field);
+        auto& jobSystem = JobSystem::GetInstance();
+        for (auto& job : jobs)
+            handles.push_back(jobSystem.Schedule(&job));
+        JobSystem::CompleteAll(handles);
+    }
+
+    void FlowFieldService::InvalidateAll()
+    {
+        for (auto& entry : m_entries)
+            entry.dirty = true;
+    }
+
+    void FlowFieldService::Clear()
+    {
+        m_entries.clear();
+    }
+}
@@ -0,0 +1,127 @@
+#ifndef FLOWFIELD_H
+#define FLOWFIELD_H
+
+#include "NavGrid.h"
+#include "SearchContext.h"
+#include "../../Components/Core.h"
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+
+namespace Navigation
+{
+    /**
+     * @brief 指向同一目标格子的流场。
+     *
+     * 积分场保存每个格子到目标的最短路径长度（以格子为单位，移动规则与 A* 一致），
+     * 方向场保存每个格子沿最短路径的下一步。共享同一目标的代理只需采样方向场，无需各自寻路。
+     */
+    class FlowField
+    {
+    public:
+        static constexpr uint8_t NoDirection = 0xFF;
+        static constexpr float Unreachable = std::numeric_limits<float>::infinity();
+
+        /**
+         * @brief 从目标反向做 Dijkstra。bounds 非空时只覆盖该矩形（与网格求交）。
+         */
+        void Build(const NavGrid& grid, int goalX, int goalY, const NavRect& bounds, SearchContext& context);
+
+        bool Contains(int x, int y) const { return m_rect.Contains(x, y); }
+        bool IsReachable(int x, int y) const { return Distance(x, y) != Unreachable; }
+
+        /**
+         * @brief 到目标的路径长度；区域外或不可达时为 Unreachable。
+         */
+        float Distance(int x, int y) const
+        {
+            return Contains(x, y) ? m_integration[Index(x, y)] : Unreachable;
+        }
+
+        /**
+         * @brief 下一步的格子偏移。目标格子、区域外或不可达时返回 false。
+         */
+        bool Direction(int x, int y, int& dx, int& dy) const;
+
+        /**
+         * @brief 采样世界坐标处的移动方向：指向下一格中心的单位向量，无方向时为零向量。
+         */
+        ECS::Vector2f SampleDirection(const NavGrid& grid, ECS::Vector2f position) const;
+
+        int GetGoalX() const { return m_goalX; }
+        int GetGoalY() const { return m_goalY; }
+        const NavRect& GetBounds() const { return m_bounds; }
+        const NavRect& GetRect() const { return m_rect; }
+        uint64_t GetRevision() const { return m_revision; }
+
+    private:
+        size_t Index(int x, int y) const
+        {
+            return static_cast<size_t>(y - m_rect.minY) * static_cast<size_t>(m_rect.Width()) +
+                static_cast<size_t>(x - m_rect.minX);
+        }
+
+        int m_goalX = 0;
+        int m_goalY = 0;
+        NavRect m_bounds;  ///< 请求时的区域，作为缓存键的一部分。
+        NavRect m_rect;    ///< 实际覆盖的区域。
+        uint64_t m_revision = 0;
+        std::vector<float> m_integration;
+        std::vector<uint8_t> m_direction;
+    };
+
+    /**
+     * @brief 按目标缓存流场并做引用计数。
+     *
+     * Acquire 返回的 shared_ptr 即引用；所有持有者释放后，流场在下一次 Update 时被回收。
+     * 网格修改后，覆盖到修改格子的流场会在 Update 中原地重建，持有者无需重新获取。
+     * 所有接口都应在同一线程调用；多个流场的重建会分发到 JobSystem。
+     */
+    class FlowFieldService
+    {
+    public:
+        /**
+         * @brief 获取（必要时构建）指向目标格子的流场。
+         */
+        std::shared_ptr<const FlowField> Acquire(const NavGrid& grid, int goalX, int goalY,
+                                                 const NavRect& bounds = {});
+
+        /**
+         * @brief 已缓存的流场，不存在时返回空。
+         */
+        std::shared_ptr<const FlowField> Find(int goalX, int goalY, const NavRect& bounds = {}) const;
+
+        /**
+         * @brief 回收无人引用的流场，并按网格修改记录重建受影响的流场。
+         */
+        void Update(const NavGrid& grid);
+
+        /**
+         * @brief 整张网格被替换时调用，所有流场在下一次 Update 时重建。
+         */
+        void InvalidateAll();
+
+        void Clear();
+
+        size_t GetFieldCount() const { return m_entries.size(); }
+        int GetReferenceCount(int goalX, int goalY, const NavRect& bounds = {}) const;
+
+    private:
+        struct Entry
+        {
+            std::shared_ptr<FlowField> field;
+            bool dirty = false;
+        };
+
+        int FindEntry(int goalX, int goalY, const NavRect& bounds) const;
+        void Rebuild(const NavGrid& grid, const std::vector<FlowField*>& fields);
+
+        std::vector<Entry> m_entries;
+        uint64_t m_revision = 0;
+        int m_width = 0;
+        int m_height = 0;
+    };
+}
+
+#endif
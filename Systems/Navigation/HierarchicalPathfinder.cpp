@@ -0,0 +1,624 @@
+#include "HierarchicalPathfinder.h"
+#include "../../Event/JobSystem.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+
+namespace Navigation
+{
+    namespace
+    {
+        static constexpr int DX8[] = {-1, 0, 1, 0, -1, -1, 1, 1};
+        static constexpr int DY8[] = {0, -1, 0, 1, -1, 1, -1, 1};
+        static constexpr float SQRT2 = 1.41421356f;
+
+        /// 边界上连通段短于该长度时只放一个入口，否则在两端各放一个。
+        static constexpr int MaxSingleEntranceLength = 6;
+
+        inline float Octile(int ax, int ay, int bx, int by)
+        {
+            const int dx = std::abs(ax - bx);
+            const int dy = std::abs(ay - by);
+            const int diag = std::min(dx, dy);
+            return static_cast<float>(dx + dy - 2 * diag) + SQRT2 * static_cast<float>(diag);
+        }
+    }
+
+    HierarchicalPathfinder::HierarchicalPathfinder(int clusterSize)
+        : m_clusterSize(std::max(clusterSize, 2))
+    {
+    }
+
+    int32_t HierarchicalPathfinder::ClusterAt(int x, int y) const
+    {
+        return (y / m_clusterSize) * m_clustersX + (x / m_clusterSize);
+    }
+
+    int32_t HierarchicalPathfinder::AllocateNode(int x, int y)
+    {
+        int32_t id;
+        if (!m_freeNodes.empty())
+        {
+            id = m_freeNodes.back();
+            m_freeNodes.pop_back();
+        }
+        else
+        {
+            id = static_cast<int32_t>(m_nodes.size());
+            m_nodes.emplace_back();
+        }
+        Node& node = m_nodes[id];
+        node.x = x;
+        node.y = y;
+        node.cluster = ClusterAt(x, y);
+        node.edges.clear();
+        m_clusters[node.cluster].nodes.push_back(id);
+        return id;
+    }
+
+    void HierarchicalPathfinder::Build(const NavGrid& grid)
+    {
+        BeginBuild(grid);
+        std::vector<int32_t> all(m_clusters.size());
+        for (int32_t c = 0; c < static_cast<int32_t>(all.size()); ++c)
+            all[c] = c;
+        BuildIntraEdges(grid, all);
+        EndBuild(grid);
+    }
+
+    void HierarchicalPathfinder::BeginBuild(const NavGrid& grid)
+    {
+        m_built = false;
+        m_width = grid.width;
+        m_height = grid.height;
+        m_clustersX = (grid.width + m_clusterSize - 1) / m_clusterSize;
+        m_clustersY = (grid.height + m_clusterSize - 1) / m_clusterSize;
+        m_clusters.assign(static_cast<size_t>(m_clustersX * m_clustersY), {});
+        m_nodes.clear();
+        m_freeNodes.clear();
+        m_borders.assign(m_clusters.size() * 2, {});
+        // 网格可能换了尺寸，按旧网格增长的上下文不再复用
+        m_gridContexts.Clear();
+        m_abstractContexts.Clear();
+        m_clusterContexts.Clear();
+
+        for (int cy = 0; cy < m_clustersY; ++cy)
+        {
+            for (int cx = 0; cx < m_clustersX; ++cx)
+            {
+                NavRect& rect = m_clusters[cy * m_clustersX + cx].rect;
+                rect.minX = cx * m_clusterSize;
+                rect.minY = cy * m_clusterSize;
+                rect.maxX = std::min(rect.minX + m_clusterSize, grid.width) - 1;
+                rect.maxY = std::min(rect.minY + m_clusterSize, grid.height) - 1;
+            }
+        }
+        for (int32_t c = 0; c < static_cast<int32_t>(m_clusters.size()); ++c)
+        {
+            BuildBorder(grid, c, East);
+            BuildBorder(grid, c, North);
+        }
+    }
+
+    void HierarchicalPathfinder::BuildClusterEdges(const NavGrid& grid, int32_t cluster)
+    {
+        BuildIntraEdges(grid, cluster);
+    }
+
+    void HierarchicalPathfinder::EndBuild(const NavGrid& grid)
+    {
+        m_revision = grid.revision;
+        m_built = true;
+    }
+
+    void HierarchicalPathfinder::Update(const NavGrid& grid)
+    {
+        if (!m_built || grid.width != m_width || grid.height != m_height)
+        {
+            Build(grid);
+            return;
+        }
+        if (grid.revision == m_revision)
+            return;
+
+        std::vector<uint8_t> dirtyClusters(m_clusters.size(), 0);
+        std::vector<uint8_t> dirtyBorders(m_borders.size(), 0);
+        auto markBorder = [&](int32_t cluster, int side)
+        {
+            dirtyBorders[cluster * 2 + side] = 1;
+            dirtyClusters[cluster] = 1;
+            const int cx = cluster % m_clustersX;
+            const int cy = cluster / m_clustersX;
+            if (side == East && cx + 1 < m_clustersX) dirtyClusters[cluster + 1] = 1;
+            if (side == North && cy + 1 < m_clustersY) dirtyClusters[cluster + m_clustersX] = 1;
+        };
+        const bool tracked = grid.ForEachChangeSince(m_revision, [&](int x, int y)
+        {
+            const int32_t cluster = ClusterAt(x, y);
+            const NavRect& rect = m_clusters[cluster].rect;
+            dirtyClusters[cluster] = 1;
+            if (x == rect.maxX) markBorder(cluster, East);
+            if (x == rect.minX && rect.minX > 0) markBorder(cluster - 1, East);
+            if (y == rect.maxY) markBorder(cluster, North);
+            if (y == rect.minY && rect.minY > 0) markBorder(cluster - m_clustersX, North);
+        });
+        if (!tracked)
+        {
+            Build(grid);
+            return;
+        }
+
+        for (int32_t border = 0; border < static_cast<int32_t>(dirtyBorders.size()); ++border)
+        {
+            if (!dirtyBorders[border]) continue;
+            ClearBorder(border);
+            BuildBorder(grid, border / 2, border % 2);
+        }
+        std::vector<int32_t> clusters;
+        for (int32_t c = 0; c < static_cast<int32_t>(dirtyClusters.size()); ++c)
+        {
+            if (dirtyClusters[c]) clusters.push_back(c);
+        }
+        BuildIntraEdges(grid, clusters);
+        m_revision = grid.revision;
+    }
+
+    void HierarchicalPathfinder::ClearBorder(int32_t border)
+    {
+        for (int32_t id : m_borders[border])
+        {
+            Node& node = m_nodes[id];
+            auto& clusterNodes = m_clusters[node.cluster].nodes;
+            clusterNodes.erase(std::remove(clusterNodes.begin(), clusterNodes.end(), id), clusterNodes.end());
+            node.edges.clear();
+            m_freeNodes.push_back(id);
+        }
+        m_borders[border].clear();
+    }
+
+    void HierarchicalPathfinder::BuildBorder(const NavGrid& grid, int32_t cluster, int side)
+    {
+        const NavRect rect = m_clusters[cluster].rect;
+        const bool east = side == East;
+        if (east ? rect.maxX + 1 >= grid.width : rect.maxY + 1 >= grid.height)
+            return;
+
+        const int first = east ? rect.minY : rect.minX;
+        const int last = east ? rect.maxY : rect.maxX;
+        auto insideCell = [&](int t) { return east ? std::make_pair(rect.maxX, t) : std::make_pair(t, rect.maxY); };
+        auto outsideCell = [&](int t) { return east ? std::make_pair(rect.maxX + 1, t) : std::make_pair(t, rect.maxY + 1); };
+        auto open = [&](int t)
+        {
+            auto [ix, iy] = insideCell(t);
+            auto [ox, oy] = outsideCell(t);
+            return grid.IsWalkable(ix, iy) && grid.IsWalkable(ox, oy);
+        };
+        auto addEntrance = [&](int t)
+        {
+            auto [ix, iy] = insideCell(t);
+            auto [ox, oy] = outsideCell(t);
+            const int32_t inside = AllocateNode(ix, iy);
+            const int32_t outside = AllocateNode(ox, oy);
+            m_nodes[inside].edges.push_back({outside, 1.0f, true});
+            m_nodes[outside].edges.push_back({inside, 1.0f, true});
+            m_borders[cluster * 2 + side].push_back(inside);
+            m_borders[cluster * 2 + side].push_back(outside);
+        };
+
+        int t = first;
+        while (t <= last)
+        {
+            if (!open(t))
+            {
+                ++t;
+                continue;
+            }
+            const int runStart = t;
+            while (t <= last && open(t)) ++t;
+            const int runEnd = t - 1;
+            if (runEnd - runStart + 1 < MaxSingleEntranceLength)
+            {
+                addEntrance((runStart + runEnd) / 2);
+            }
+            else
+            {
+                addEntrance(runStart);
+                addEntrance(runEnd);
+            }
+        }
+    }
+
+    std::vector<std::pair<int, int>> HierarchicalPathfinder::NodeCells(const std::vector<int32_t>& ids) const
+    {
+        std::vector<std::pair<int, int>> cells;
+        cells.reserve(ids.size() + 1);
+        for (int32_t id : ids)
+            cells.push_back({m_nodes[id].x, m_nodes[id].y});
+        return cells;
+    }
+
+    void HierarchicalPathfinder::BuildIntraEdges(const NavGrid& grid, int32_t cluster)
+    {
+        const Cluster& c = m_clusters[cluster];
+        for (int32_t id : c.nodes)
+        {
+            auto& edges = m_nodes[id].edges;
+            edges.erase(std::remove_if(edges.begin(), edges.end(), [](const Edge& e) { return !e.inter; }),
+                        edges.end());
+        }
+        // 簇内距离是对称的，只需从每个节点求到后续节点的距离
+        std::vector<std::pair<int, int>> cells = NodeCells(c.nodes);
+        std::vector<float> costs;
+        std::vector<uint8_t> local;
+        SearchContextPool::Lease context = m_clusterContexts.Acquire();
+        for (size_t i = 0; i + 1 < c.nodes.size(); ++i)
+        {
+            cells.erase(cells.begin());
+            Node& node = m_nodes[c.nodes[i]];
+            ClusterDistances(grid, c.rect, node.x, node.y, cells, *context, local, costs);
+            for (size_t k = 0; k < costs.size(); ++k)
+            {
+                if (costs[k] < 0.0f) continue;
+                const int32_t other = c.nodes[i + 1 + k];
+                node.edges.push_back({other, costs[k], false});
+                m_nodes[other].edges.push_back({c.nodes[i], costs[k], false});
+            }
+        }
+    }
+
+    void HierarchicalPathfinder::BuildIntraEdges(const NavGrid& grid, const std::vector<int32_t>& clusters)
+    {
+        // 各簇只写自己节点的边，可以并行；此期间不会分配节点，m_nodes 不会重新分配
+        static constexpr size_t ClustersPerJob = 64;
+        if (clusters.size() <= ClustersPerJob)
+        {
+            for (int32_t c : clusters)
+                BuildIntraEdges(grid, c);
+            return;
+        }
+
+        struct IntraEdgeJob : public IJob
+        {
+            HierarchicalPathfinder* owner;
+            const NavGrid* grid;
+            const int32_t* clusters;
+            size_t count;
+
+            IntraEdgeJob(HierarchicalPathfinder* o, const NavGrid* g, const int32_t* c, size_t n)
+                : owner(o), grid(g), clusters(c), count(n)
+            {
+            }
+
+            void Execute() override
+            {
+                for (size_t i = 0; i < count; ++i)
+                    owner->BuildIntraEdges(*grid, clusters[i]);
+            }
+        };
+
+        std::vector<IntraEdgeJob> jobs;
+        std::vector<JobHandle> handles;
+        jobs.reserve((clusters.size() + ClustersPerJob - 1) / ClustersPerJob);
+        for (size_t begin = 0; begin < clusters.size(); begin += ClustersPerJob)
+        {
+            jobs.emplace_back(this, &grid, clusters.data() + begin,
+                              std::min(ClustersPerJob, clusters.size() - begin));
+        }
+        auto& jobSystem = JobSystem::GetInstance();
+        for (auto& job : jobs)
+            handles.push_back(jobSystem.Schedule(&job));
+        JobSystem::CompleteAll(handles);
+    }
+
+    void HierarchicalPathfinder::ClusterDistances(const NavGrid& grid, const NavRect& rect, int sx, int sy,
+                                                  const std::vector<std::pair<int, int>>& targets,
+                                                  SearchContext& context, std::vector<uint8_t>& local,
+                                                  std::vector<float>& costs) const
+    {
+        costs.assign(targets.size(), -1.0f);
+        if (!grid.IsWalkable(sx, sy)) return;
+
+        // 把簇拷贝到四周补一圈障碍的局部数组中，内层循环不再需要边界检查
+        const int stride = rect.Width() + 2;
+        const int rows = rect.Height() + 2;
+        local.assign(static_cast<size_t>(stride * rows), 0);
+        for (int y = rect.minY; y <= rect.maxY; ++y)
+        {
+            const uint64_t* row = grid.Row(y);
+            uint8_t* dst = local.data() + (y - rect.minY + 1) * stride + 1;
+            for (int x = rect.minX; x <= rect.maxX; ++x)
+                dst[x - rect.minX] = static_cast<uint8_t>((row[x / NavGrid::BitsPerWord] >> (x % NavGrid::BitsPerWord)) & 1u);
+        }
+        auto index = [&](int x, int y) { return (y - rect.minY + 1) * stride + (x - rect.minX + 1); };
+        const int32_t offsets[8] = {-1, -stride, 1, stride, -1 - stride, -1 + stride, 1 - stride, 1 + stride};
+
+        std::vector<int32_t> targetCells(targets.size());
+        for (size_t k = 0; k < targets.size(); ++k)
+            targetCells[k] = index(targets[k].first, targets[k].second);
+
+        context.Begin(local.size());
+        context.Relax(index(sx, sy), 0.0f, 0.0f, SearchContext::NoParent);
+        size_t remaining = targets.size();
+        while (!context.OpenEmpty() && remaining > 0)
+        {
+            const int32_t cur = context.PopMin();
+            for (size_t k = 0; k < targetCells.size(); ++k)
+            {
+                if (targetCells[k] == cur)
+                {
+                    costs[k] = context.G(cur);
+                    --remaining;
+                }
+            }
+            const float g = context.G(cur);
+            for (int d = 0; d < 4; ++d)
+            {
+                if (local[cur + offsets[d]])
+                    context.Relax(cur + offsets[d], g + 1.0f, 0.0f, cur);
+            }
+            for (int d = 4; d < 8; ++d)
+            {
+                const int32_t next = cur + offsets[d];
+                if (local[next] && local[cur + DX8[d]] && local[cur + DY8[d] * stride])
+                    context.Relax(next, g + SQRT2, 0.0f, cur);
+            }
+        }
+    }
+
+    AbstractPath HierarchicalPathfinder::FindAbstractPath(const NavGrid& grid, const PathRequest& request) const
+    {
+        AbstractPath result;
+        auto [sx, sy] = grid.WorldToGrid(request.start);
+        auto [ex, ey] = grid.WorldToGrid(request.end);
+        if (!m_built || !grid.IsWalkable(sx, sy) || !grid.IsWalkable(ex, ey))
+            return result;
+
+        const int32_t startCluster = ClusterAt(sx, sy);
+        const int32_t goalCluster = ClusterAt(ex, ey);
+        const auto& startNodes = m_clusters[startCluster].nodes;
+        const auto& goalNodes = m_clusters[goalCluster].nodes;
+
+        // 同簇时把终点也作为起点的目标，簇内直连成为一条候选边
+        std::vector<std::pair<int, int>> startTargets = NodeCells(startNodes);
+        if (startCluster == goalCluster)
+            startTargets.push_back({ex, ey});
+        std::vector<float> startCosts;
+        std::vector<float> goalCosts;
+        {
+            SearchContextPool::Lease local = m_clusterContexts.Acquire();
+            std::vector<uint8_t> cells;
+            ClusterDistances(grid, m_clusters[startCluster].rect, sx, sy, startTargets, *local, cells, startCosts);
+            ClusterDistances(grid, m_clusters[goalCluster].rect, ex, ey, NodeCells(goalNodes), *local, cells,
+                             goalCosts);
+        }
+        const float directCost = startCluster == goalCluster ? startCosts.back() : -1.0f;
+
+        const int32_t startId = static_cast<int32_t>(m_nodes.size());
+        const int32_t goalId = startId + 1;
+        SearchContextPool::Lease lease = m_abstractContexts.Acquire();
+        SearchContext& context = *lease;
+        context.Begin(m_nodes.size() + 2);
+        context.Relax(startId, 0.0f, Octile(sx, sy, ex, ey), SearchContext::NoParent);
+        bool found = false;
+        while (!context.OpenEmpty())
+        {
+            const int32_t cur = context.PopMin();
+            ++result.expandedNodes;
+            if (cur == goalId)
+            {
+                found = true;
+                break;
+            }
+            const float g = context.G(cur);
+            if (cur == startId)
+            {
+                for (size_t k = 0; k < startNodes.size(); ++k)
+                {
+                    if (startCosts[k] < 0.0f) continue;
+                    const Node& node = m_nodes[startNodes[k]];
+                    context.Relax(startNodes[k], startCosts[k], Octile(node.x, node.y, ex, ey), startId);
+                }
+                if (directCost >= 0.0f)
+                    context.Relax(goalId, directCost, 0.0f, startId);
+                continue;
+            }
+            const Node& node = m_nodes[cur];
+            for (const Edge& edge : node.edges)
+            {
+                const Node& target = m_nodes[edge.target];
+                context.Relax(edge.target, g + edge.cost, Octile(target.x, target.y, ex, ey), cur);
+            }
+            if (node.cluster == goalCluster)
+            {
+                for (size_t k = 0; k < goalNodes.size(); ++k)
+                {
+                    if (goalNodes[k] == cur && goalCosts[k] >= 0.0f)
+                        context.Relax(goalId, g + goalCosts[k], 0.0f, cur);
+                }
+            }
+        }
+        if (!found)
+            return result;
+
+        result.found = true;
+        result.cost = context.G(goalId);
+        for (int32_t id = goalId; id != SearchContext::NoParent; id = context.Parent(id))
+        {
+            if (id == goalId) result.corners.push_back({ex, ey});
+            else if (id == startId) result.corners.push_back({sx, sy});
+            else result.corners.push_back({m_nodes[id].x, m_nodes[id].y});
+        }
+        std::reverse(result.corners.begin(), result.corners.end());
+        return result;
+    }
+
+    bool HierarchicalPathfinder::RefineSegment(const NavGrid& grid, std::pair<int, int> from, std::pair<int, int> to,
+                                               bool allowDiagonal, std::vector<ECS::Vector2f>& waypoints) const
+    {
+        if (from == to)
+            return true;
+        const NavRect& a = m_clusters[ClusterAt(from.first, from.second)].rect;
+        const NavRect& b = m_clusters[ClusterAt(to.first, to.second)].rect;
+        PathRequest request;
+        request.start = grid.GridToWorld(from.first, from.second);
+        request.end = grid.GridToWorld(to.first, to.second);
+        request.allowDiagonal = allowDiagonal;
+        request.bounds = {std::min(a.minX, b.minX), std::min(a.minY, b.minY),
+                          std::max(a.maxX, b.maxX), std::max(a.maxY, b.maxY)};
+        PathResult segment = Pathfinder::FindPath(grid, request, *m_gridContexts.Acquire());
+        if (!segment.found)
+            return false;
+        waypoints.insert(waypoints.end(), segment.waypoints.begin(), segment.waypoints.end());
+        return true;
+    }
+
+    bool HierarchicalPathfinder::IsLongQuery(int sx, int sy, int ex, int ey) const
+    {
+        return std::max(std::abs(ex - sx), std::abs(ey - sy)) > LocalSearchClusters * m_clusterSize;
+    }
+
+    PathResult HierarchicalPathfinder::FindPath(const NavGrid& grid, const PathRequest& request) const
+    {
+        auto [sx, sy] = grid.WorldToGrid(request.start);
+        auto [ex, ey] = grid.WorldToGrid(request.end);
+        if (!m_built || !request.allowDiagonal || grid.width != m_width || grid.height != m_height ||
+            (sx == ex && sy == ey))
+            return Pathfinder::FindPath(grid, request);
+
+        if (!IsLongQuery(sx, sy, ex, ey))
+        {
+            // 短查询通常不需要绕远，先在起终点周围一个簇宽的窗口内求最优路径
+            PathRequest local = request;
+            local.bounds = {std::min(sx, ex) - m_clusterSize, std::min(sy, ey) - m_clusterSize,
+                            std::max(sx, ex) + m_clusterSize, std::max(sy, ey) + m_clusterSize};
+            PathResult direct = Pathfinder::FindPath(grid, local, *m_gridContexts.Acquire());
+            if (direct.found)
+                return direct;
+        }
+
+        PathResult result;
+        const AbstractPath abstractPath = FindAbstractPath(grid, request);
+        result.expandedNodes = abstractPath.expandedNodes;
+        if (!abstractPath.found)
+            return result;
+        for (size_t i = 0; i + 1 < abstractPath.corners.size(); ++i)
+        {
+            if (!RefineSegment(grid, abstractPath.corners[i], abstractPath.corners[i + 1], true, result.waypoints))
+            {
+                result.waypoints.clear();
+                return result;
+            }
+        }
+        result.found = true;
+        result.cost = abstractPath.cost;
+        return result;
+    }
+
+    HierarchyBuildTask::~HierarchyBuildTask()
+    {
+        Cancel();
+        for (auto& build : m_cancelled)
+            JobSystem::CompleteAll(build->handles);
+    }
+
+    void HierarchyBuildTask::BuildJob::Execute()
+    {
+        if (build->cancelled.load(std::memory_order_relaxed))
+            return;
+        if (count == 0)
+        {
+            build->hierarchy.BeginBuild(build->grid);
+            return;
+        }
+        for (int32_t c = first; c < first + count; ++c)
+        {
+            if (build->cancelled.load(std::memory_order_relaxed))
+                return;
+            build->hierarchy.BuildClusterEdges(build->grid, c);
+        }
+    }
+
+    void HierarchyBuildTask::Start(const NavGrid& grid, int clusterSize)
+    {
+        Cancel();
+        m_current = std::make_unique<Build>(clusterSize);
+        // 只复制构建需要的可走性，代价层与修改记录留在原网格上
+        NavGrid& snapshot = m_current->grid;
+        snapshot.width = grid.width;
+        snapshot.height = grid.height;
+        snapshot.cellSize = grid.cellSize;
+        snapshot.origin = grid.origin;
+        snapshot.wordsPerRow = grid.wordsPerRow;
+        snapshot.walkableBits = grid.walkableBits;
+        snapshot.revision = grid.revision;
+        Schedule(*m_current);
+    }
+
+    bool HierarchyBuildTask::Poll(HierarchicalPathfinder& out)
+    {
+        m_cancelled.erase(std::remove_if(m_cancelled.begin(), m_cancelled.end(),
+                                         [](const std::unique_ptr<Build>& build) { return IsDone(*build); }),
+                          m_cancelled.end());
+        if (!m_current || !IsDone(*m_current))
+            return false;
+        if (!m_current->layoutDone)
+        {
+            m_current->layoutDone = true;
+            Schedule(*m_current);
+            if (!m_current->handles.empty())
+                return false;
+        }
+        m_current->hierarchy.EndBuild(m_current->grid);
+        out = std::move(m_current->hierarchy);
+        m_current.reset();
+        return true;
+    }
+
+    void HierarchyBuildTask::Cancel()
+    {
+        if (!m_current)
+            return;
+        m_current->cancelled.store(true, std::memory_order_relaxed);
+        m_cancelled.push_back(std::move(m_current));
+    }
+
+    bool HierarchyBuildTask::IsDone(Build& build)
+    {
+        for (auto& handle : build.handles)
+        {
+            if (handle.valid() && handle.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+                return false;
+        }
+        return true;
+    }
+
+    void HierarchyBuildTask::Schedule(Build& build)
+    {
+        // 各簇只写自己节点的边，按批并行；划分簇的作业已结束，可以覆盖它的作业对象
+        static constexpr int32_t ClustersPerJob = 64;
+        build.handles.clear();
+        build.jobs.clear();
+        if (!build.layoutDone)
+        {
+            build.jobs.push_back({});
+            build.jobs.back().build = &build;
+        }
+        else
+        {
+            const int32_t clusters = build.hierarchy.GetClusterCount();
+            build.jobs.reserve(static_cast<size_t>((clusters + ClustersPerJob - 1) / ClustersPerJob));
+            for (int32_t first = 0; first < clusters; first += ClustersPerJob)
+            {
+                BuildJob job;
+                job.build = &build;
+                job.first = first;
+                job.count = std::min(ClustersPerJob, clusters - first);
+                build.jobs.push_back(job);
+            }
+        }
+        auto& jobSystem = JobSystem::GetInstance();
+        for (auto& job : build.jobs)
+            build.handles.push_back(jobSystem.Schedule(&job));
+    }
+}
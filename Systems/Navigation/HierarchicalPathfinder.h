@@ -0,0 +1,220 @@
+#ifndef HIERARCHICALPATHFINDER_H
+#define HIERARCHICALPATHFINDER_H
+
+#include "NavGrid.h"
+#include "Pathfinder.h"
+#include "SearchContext.h"
+#include "../../Event/JobSystem.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace Navigation
+{
+    /**
+     * @brief 抽象图上的路径：相邻拐点位于同一个簇或跨越一条簇边界。
+     */
+    struct AbstractPath
+    {
+        bool found = false;
+        std::vector<std::pair<int, int>> corners;  ///< 包含起点与终点的格子坐标。
+        float cost = 0.0f;                         ///< 抽象图上的路径长度（以格子为单位）。
+        int expandedNodes = 0;
+    };
+
+    /**
+     * @brief HPA* 分层寻路。
+     *
+     * 网格被切分为固定大小的簇；相邻簇之间每段连通的边界生成入口节点，
+     * 同一簇内的入口节点之间预先计算簇内最短路径作为边。长距离查询只在抽象图上搜索，
+     * 再按需把每一段细化为逐格路径。网格修改后只修复受影响的簇和它们的边界。
+     *
+     * 查询是 const 且线程安全的，搜索上下文从寻路器自己的池中借用，全量构建时释放。Build/Update 不能与查询并发，簇内边的计算会分发到 JobSystem 并等待完成，
+     * 因此不能在作业中调用。大网格的全量构建应交给 HierarchyBuildTask。
+     */
+    class HierarchicalPathfinder
+    {
+    public:
+        static constexpr int DefaultClusterSize = 32;
+        /// 起终点的切比雪夫距离不超过该簇数时，先在附近窗口内直接搜索。
+        static constexpr int LocalSearchClusters = 2;
+
+        explicit HierarchicalPathfinder(int clusterSize = DefaultClusterSize);
+
+        void Build(const NavGrid& grid);
+
+        /**
+         * @brief 分阶段构建，供后台构建使用：BeginBuild 划分簇并生成入口节点，之后每个簇调用一次
+         * BuildClusterEdges（不同的簇可以在不同线程上并发），全部完成后调用 EndBuild。完成前不能查询。
+         */
+        void BeginBuild(const NavGrid& grid);
+        void BuildClusterEdges(const NavGrid& grid, int32_t cluster);
+        void EndBuild(const NavGrid& grid);
+
+        /**
+         * @brief 按 NavGrid 的修改记录增量修复；尚未构建、尺寸改变或记录不足时全量重建。
+         */
+        void Update(const NavGrid& grid);
+
+        /**
+         * @brief 在抽象图上寻路，不做细化。
+         */
+        AbstractPath FindAbstractPath(const NavGrid& grid, const PathRequest& request) const;
+
+        /**
+         * @brief 把抽象路径中相邻两个拐点之间的一段细化为逐格路径点（不含 from，含 to）。
+         */
+        bool RefineSegment(const NavGrid& grid, std::pair<int, int> from, std::pair<int, int> to,
+                           bool allowDiagonal, std::vector<ECS::Vector2f>& waypoints) const;
+
+        /**
+         * @brief 是否为需要抽象搜索的长距离查询。
+         */
+        bool IsLongQuery(int sx, int sy, int ex, int ey) const;
+
+        /**
+         * @brief 短查询先在附近窗口内直接搜索；长查询或窗口内找不到时做抽象搜索并立即细化全部路段。
+         */
+        PathResult FindPath(const NavGrid& grid, const PathRequest& request) const;
+
+        int GetClusterSize() const { return m_clusterSize; }
+        size_t GetNodeCount() const { return m_nodes.size() - m_freeNodes.size(); }
+        uint64_t GetRevision() const { return m_revision; }
+        bool IsBuilt() const { return m_built; }
+        int32_t GetClusterCount() const { return static_cast<int32_t>(m_clusters.size()); }
+        /// 池中空闲的搜索上下文总数。
+        size_t GetPooledContextCount() const
+        {
+            return m_gridContexts.GetFreeCount() + m_abstractContexts.GetFreeCount() +
+                   m_clusterContexts.GetFreeCount();
+        }
+
+    private:
+        enum BorderSide : int
+        {
+            East = 0,
+            North = 1
+        };
+
+        struct Edge
+        {
+            int32_t target;
+            float cost;
+            bool inter;
+        };
+
+        struct Node
+        {
+            int x = 0;
+            int y = 0;
+            int32_t cluster = -1;
+            std::vector<Edge> edges;
+        };
+
+        struct Cluster
+        {
+            NavRect rect;
+            std::vector<int32_t> nodes;
+        };
+
+        int32_t ClusterAt(int x, int y) const;
+        int32_t AllocateNode(int x, int y);
+        void ClearBorder(int32_t border);
+        void BuildBorder(const NavGrid& grid, int32_t cluster, int side);
+        void BuildIntraEdges(const NavGrid& grid, int32_t cluster);
+        void BuildIntraEdges(const NavGrid& grid, const std::vector<int32_t>& clusters);
+
+        std::vector<std::pair<int, int>> NodeCells(const std::vector<int32_t>& ids) const;
+
+        /**
+         * @brief 在簇内从 (sx, sy) 做 Dijkstra，返回到各目标格子的距离（不可达为负）。cells 是调用方的临时缓冲。
+         */
+        void ClusterDistances(const NavGrid& grid, const NavRect& rect, int sx, int sy,
+                              const std::vector<std::pair<int, int>>& targets, SearchContext& context,
+                              std::vector<uint8_t>& cells, std::vector<float>& costs) const;
+
+        int m_clusterSize;
+        int m_clustersX = 0;
+        int m_clustersY = 0;
+        int m_width = 0;
+        int m_height = 0;
+        bool m_built = false;
+        uint64_t m_revision = 0;
+        std::vector<Cluster> m_clusters;
+        std::vector<Node> m_nodes;
+        std::vector<int32_t> m_freeNodes;
+        std::vector<std::vector<int32_t>> m_borders;  ///< 下标 cluster * 2 + BorderSide。
+
+        mutable SearchContextPool m_gridContexts;      ///< 逐格搜索，与网格等大。
+        mutable SearchContextPool m_abstractContexts;  ///< 抽象图搜索，与节点数等大。
+        mutable SearchContextPool m_clusterContexts;   ///< 簇内 Dijkstra，与簇等大。
+    };
+
+    /**
+     * @brief 在 JobSystem 上后台构建 HierarchicalPathfinder，不阻塞调用线程。
+     *
+     * Start 对网格拍快照后立即返回；划分簇作为一个作业，完成后簇内边再分批分发，阶段之间由 Poll 推进，
+     * 作业内部从不等待其他作业。结果对应快照时的网格版本，取回后用 Update 补上之后的修改。
+     * 除工作线程上的作业外，所有接口都应在同一线程调用。
+     */
+    class HierarchyBuildTask
+    {
+    public:
+        HierarchyBuildTask() = default;
+        ~HierarchyBuildTask();
+
+        HierarchyBuildTask(const HierarchyBuildTask&) = delete;
+        HierarchyBuildTask& operator=(const HierarchyBuildTask&) = delete;
+
+        /**
+         * @brief 以 clusterSize 开始构建 grid 的快照，取消进行中的构建。
+         */
+        void Start(const NavGrid& grid, int clusterSize);
+
+        /**
+         * @brief 推进构建；完成时把结果移入 out 并返回 true。
+         */
+        bool Poll(HierarchicalPathfinder& out);
+
+        /**
+         * @brief 取消构建；已在工作线程上的作业尽快返回，之后由 Poll 或析构回收。
+         */
+        void Cancel();
+
+        bool IsRunning() const { return m_current != nullptr; }
+
+    private:
+        struct Build;
+
+        struct BuildJob : public IJob
+        {
+            Build* build = nullptr;
+            int32_t first = 0;
+            int32_t count = 0;  ///< 为 0 时执行 BeginBuild，否则计算 [first, first + count) 的簇内边。
+
+            void Execute() override;
+        };
+
+        struct Build
+        {
+            NavGrid grid;
+            HierarchicalPathfinder hierarchy;
+            bool layoutDone = false;
+            std::atomic<bool> cancelled{false};
+            std::vector<BuildJob> jobs;
+            std::vector<JobHandle> handles;
+
+            explicit Build(int clusterSize) : hierarchy(clusterSize) {}
+        };
+
+        static bool IsDone(Build& build);
+        static void Schedule(Build& build);
+
+        std::unique_ptr<Build> m_current;
+        std::vector<std::unique_ptr<Build>> m_cancelled;  ///< 作业结束后才能释放。
+    };
+}
+
+#endif
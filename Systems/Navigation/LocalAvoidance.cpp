@@ -0,0 +1,383 @@
+#include "LocalAvoidance.h"
+#include "../../Event/JobSystem.h"
+#include <algorithm>
+#include <functional>
+
+namespace Navigation
+{
+    namespace
+    {
+        static constexpr float Epsilon = 1e-5f;
+        static constexpr size_t AgentsPerJob = 512;
+        /// 建哈希时每块都有一整张桶计数表，块取得更大以减少清零与前缀和的开销。
+        static constexpr size_t HashAgentsPerJob = 4096;
+
+        struct Vec2
+        {
+            float x = 0.0f;
+            float y = 0.0f;
+
+            Vec2() = default;
+            Vec2(float px, float py) : x(px), y(py) {}
+            explicit Vec2(const ECS::Vector2f& v) : x(v.x), y(v.y) {}
+
+            Vec2 operator+(const Vec2& o) const { return {x + o.x, y + o.y}; }
+            Vec2 operator-(const Vec2& o) const { return {x - o.x, y - o.y}; }
+            Vec2 operator-() const { return {-x, -y}; }
+            Vec2 operator*(float s) const { return {x * s, y * s}; }
+            Vec2 operator/(float s) const { return {x / s, y / s}; }
+        };
+
+        inline float Dot(const Vec2& a, const Vec2& b) { return a.x * b.x + a.y * b.y; }
+        inline float Det(const Vec2& a, const Vec2& b) { return a.x * b.y - a.y * b.x; }
+        inline float LengthSq(const Vec2& v) { return Dot(v, v); }
+
+        inline Vec2 Normalize(const Vec2& v)
+        {
+            const float length = std::sqrt(LengthSq(v));
+            return length > Epsilon ? v / length : Vec2{};
+        }
+
+        /// 半平面：point 在边界上，方向左侧为可行区域。
+        struct Line
+        {
+            Vec2 point;
+            Vec2 direction;
+        };
+
+        /**
+         * @brief 在第 lineNo 条约束线上、速度圆内求最优点，同时满足之前的全部约束。
+         */
+        bool LinearProgram1(const std::vector<Line>& lines, size_t lineNo, float radius, const Vec2& optVelocity,
+                            bool directionOpt, Vec2& result)
+        {
+            const Line& line = lines[lineNo];
+            const float dotProduct = Dot(line.point, line.direction);
+            const float discriminant = dotProduct * dotProduct + radius * radius - LengthSq(line.point);
+            if (discriminant < 0.0f) return false;
+
+            const float sqrtDiscriminant = std::sqrt(discriminant);
+            float tLeft = -dotProduct - sqrtDiscriminant;
+            float tRight = -dotProduct + sqrtDiscriminant;
+            for (size_t i = 0; i < lineNo; ++i)
+            {
+                const float denominator = Det(line.direction, lines[i].direction);
+                const float numerator = Det(lines[i].direction, line.point - lines[i].point);
+                if (std::fabs(denominator) <= Epsilon)
+                {
+                    if (numerator < 0.0f) return false;
+                    continue;
+                }
+                const float t = numerator / denominator;
+                if (denominator >= 0.0f)
+                    tRight = std::min(tRight, t);
+                else
+                    tLeft = std::max(tLeft, t);
+                if (tLeft > tRight) return false;
+            }
+
+            if (directionOpt)
+            {
+                result = Dot(optVelocity, line.direction) > 0.0f ? line.point + line.direction * tRight
+                                                                 : line.point + line.direction * tLeft;
+            }
+            else
+            {
+                const float t = Dot(line.direction, optVelocity - line.point);
+                result = line.point + line.direction * std::clamp(t, tLeft, tRight);
+            }
+            return true;
+        }
+
+        /**
+         * @brief 速度圆内满足全部约束且最接近 optVelocity 的点；返回首个无解的约束下标，全部满足时返回约束数。
+         */
+        size_t LinearProgram2(const std::vector<Line>& lines, float radius, const Vec2& optVelocity,
+                              bool directionOpt, Vec2& result)
+        {
+            if (directionOpt)
+                result = optVelocity * radius;
+            else if (LengthSq(optVelocity) > radius * radius)
+                result = Normalize(optVelocity) * radius;
+            else
+                result = optVelocity;
+
+            for (size_t i = 0; i < lines.size(); ++i)
+            {
+                if (Det(lines[i].direction, lines[i].point - result) > 0.0f)
+                {
+                    const Vec2 previous = result;
+                    if (!LinearProgram1(lines, i, radius, optVelocity, directionOpt, result))
+                    {
+                        result = previous;
+                        return i;
+                    }
+                }
+            }
+            return lines.size();
+        }
+
+        /**
+         * @brief 约束无解时，求使最大穿透距离最小的速度。
+         */
+        void LinearProgram3(const std::vector<Line>& lines, size_t beginLine, float radius, Vec2& result,
+                            std::vector<Line>& projected)
+        {
+            float distance = 0.0f;
+            for (size_t i = beginLine; i < lines.size(); ++i)
+            {
+                if (Det(lines[i].direction, lines[i].point - result) <= distance) continue;
+
+                projected.clear();
+                for (size_t j = 0; j < i; ++j)
+                {
+                    Line line;
+                    const float determinant = Det(lines[i].direction, lines[j].direction);
+                    if (std::fabs(determinant) <= Epsilon)
+                    {
+                        if (Dot(lines[i].direction, lines[j].direction) > 0.0f) continue;
+                        line.point = (lines[i].point + lines[j].point) * 0.5f;
+                    }
+                    else
+                    {
+                        line.point = lines[i].point +
+                            lines[i].direction *
+                            (Det(lines[j].direction, lines[i].point - lines[j].point) / determinant);
+                    }
+                    line.direction = Normalize(lines[j].direction - lines[i].direction);
+                    projected.push_back(line);
+                }
+
+                const Vec2 previous = result;
+                if (LinearProgram2(projected, radius, Vec2{-lines[i].direction.y, lines[i].direction.x}, true,
+                                   result) < projected.size())
+                {
+                    result = previous;
+                }
+                distance = Det(lines[i].direction, lines[i].point - result);
+            }
+        }
+
+        /**
+         * @brief 把 [0, count) 按 chunk 切块分发到 JobSystem，块数为 1 时直接在当前线程执行。
+         */
+        void RunInChunks(size_t count, size_t chunk, const std::function<void(size_t, size_t)>& fn)
+        {
+            if (count <= chunk)
+            {
+                fn(0, count);
+                return;
+            }
+
+            struct RangeJob : public IJob
+            {
+                const std::function<void(size_t, size_t)>* fn;
+                size_t begin;
+                size_t end;
+
+                RangeJob(const std::function<void(size_t, size_t)>* f, size_t b, size_t e) : fn(f), begin(b), end(e)
+                {
+                }
+
+                void Execute() override { (*fn)(begin, end); }
+            };
+
+            std::vector<RangeJob> jobs;
+            std::vector<JobHandle> handles;
+            jobs.reserve((count + chunk - 1) / chunk);
+            for (size_t begin = 0; begin < count; begin += chunk)
+                jobs.emplace_back(&fn, begin, std::min(count, begin + chunk));
+            auto& jobSystem = JobSystem::GetInstance();
+            for (auto& job : jobs)
+                handles.push_back(jobSystem.Schedule(&job));
+            JobSystem::CompleteAll(handles);
+        }
+    }
+
+    void AgentSpatialHash::Build(const std::vector<AvoidanceAgent>& agents, float cellSize)
+    {
+        m_cellSize = std::max(cellSize, Epsilon);
+        m_inverseCellSize = 1.0f / m_cellSize;
+
+        const size_t count = agents.size();
+        uint32_t bucketCount = 16;
+        while (bucketCount < count * 2)
+            bucketCount <<= 1;
+        m_mask = bucketCount - 1;
+        const size_t chunks = std::max<size_t>(1, (count + HashAgentsPerJob - 1) / HashAgentsPerJob);
+
+        // 每块独立统计自己的桶计数，避免原子操作；随后按 (桶, 块) 顺序求前缀和，分散时各块写入互不重叠的区间
+        m_agentBuckets.resize(count);
+        m_chunkCounts.assign(chunks * bucketCount, 0);
+        RunInChunks(count, HashAgentsPerJob, [&](size_t begin, size_t end)
+        {
+            uint32_t* counts = m_chunkCounts.data() + (begin / HashAgentsPerJob) * bucketCount;
+            for (size_t i = begin; i < end; ++i)
+            {
+                const uint32_t bucket = Bucket(CellCoord(agents[i].position.x), CellCoord(agents[i].position.y));
+                m_agentBuckets[i] = bucket;
+                ++counts[bucket];
+            }
+        });
+
+        m_buckets.assign(bucketCount + 1, 0);
+        uint32_t offset = 0;
+        for (uint32_t bucket = 0; bucket < bucketCount; ++bucket)
+        {
+            m_buckets[bucket] = offset;
+            for (size_t chunk = 0; chunk < chunks; ++chunk)
+            {
+                uint32_t& slot = m_chunkCounts[chunk * bucketCount + bucket];
+                const uint32_t n = slot;
+                slot = offset;
+                offset += n;
+            }
+        }
+        m_buckets[bucketCount] = offset;
+
+        m_indices.resize(count);
+        RunInChunks(count, HashAgentsPerJob, [&](size_t begin, size_t end)
+        {
+            uint32_t* cursors = m_chunkCounts.data() + (begin / HashAgentsPerJob) * bucketCount;
+            for (size_t i = begin; i < end; ++i)
+                m_indices[cursors[m_agentBuckets[i]]++] = static_cast<uint32_t>(i);
+        });
+    }
+
+    OrcaSolver::OrcaSolver(float timeHorizon)
+        : m_timeHorizon(std::max(timeHorizon, Epsilon))
+    {
+    }
+
+    float OrcaSolver::NeighborDistance(const AvoidanceAgent& agent) const
+    {
+        if (agent.neighborDistance > 0.0f) return agent.neighborDistance;
+        return agent.maxSpeed * m_timeHorizon + agent.radius * 2.0f;
+    }
+
+    void OrcaSolver::ComputeVelocities(const std::vector<AvoidanceAgent>& agents, float deltaTime,
+                                       std::vector<ECS::Vector2f>& velocities)
+    {
+        velocities.resize(agents.size());
+        if (agents.empty()) return;
+
+        float cellSize = 0.0f;
+        for (const auto& agent : agents)
+            cellSize = std::max(cellSize, NeighborDistance(agent));
+        m_hash.Build(agents, cellSize);
+
+        RunInChunks(agents.size(), AgentsPerJob, [&](size_t begin, size_t end)
+        {
+            SolveRange(agents, deltaTime, begin, end, velocities);
+        });
+    }
+
+    void OrcaSolver::SolveRange(const std::vector<AvoidanceAgent>& agents, float deltaTime, size_t begin, size_t end,
+                                std::vector<ECS::Vector2f>& velocities) const
+    {
+        thread_local std::vector<std::pair<float, uint32_t>> neighbors;
+        thread_local std::vector<Line> lines;
+        thread_local std::vector<Line> projected;
+
+        const float invTimeHorizon = 1.0f / m_timeHorizon;
+        const float invTimeStep = deltaTime > Epsilon ? 1.0f / deltaTime : 0.0f;
+
+        for (size_t index = begin; index < end; ++index)
+        {
+            const AvoidanceAgent& agent = agents[index];
+            const Vec2 position(agent.position);
+            const Vec2 velocity(agent.velocity);
+
+            // 保留距离最近的 maxNeighbors 个邻居；列表满后搜索半径收缩到当前最远者
+            neighbors.clear();
+            const float range = NeighborDistance(agent);
+            float rangeSq = range * range;
+            if (agent.maxNeighbors > 0)
+            {
+                m_hash.ForEachCandidate(agent.position, range, [&](uint32_t other)
+                {
+                    if (other == index) return;
+                    const float distSq = LengthSq(Vec2(agents[other].position) - position);
+                    if (distSq >= rangeSq) return;
+                    if (neighbors.size() < static_cast<size_t>(agent.maxNeighbors))
+                        neighbors.push_back({distSq, other});
+                    size_t i = neighbors.size() - 1;
+                    while (i > 0 && distSq < neighbors[i - 1].first)
+                    {
+                        neighbors[i] = neighbors[i - 1];
+                        --i;
+                    }
+                    neighbors[i] = {distSq, other};
+                    if (neighbors.size() == static_cast<size_t>(agent.maxNeighbors))
+                        rangeSq = neighbors.back().first;
+                });
+            }
+
+            lines.clear();
+            for (const auto& [distSq, other] : neighbors)
+            {
+                const AvoidanceAgent& neighbor = agents[other];
+                const Vec2 relativePosition = Vec2(neighbor.position) - position;
+                const Vec2 relativeVelocity = velocity - Vec2(neighbor.velocity);
+                const float combinedRadius = agent.radius + neighbor.radius;
+                const float combinedRadiusSq = combinedRadius * combinedRadius;
+
+                Line line;
+                Vec2 u;
+                if (distSq > combinedRadiusSq)
+                {
+                    // 尚未相交：截断速度障碍锥，按相对速度落在截断圆还是两条腿上分别处理
+                    const Vec2 w = relativeVelocity - relativePosition * invTimeHorizon;
+                    const float wLengthSq = LengthSq(w);
+                    const float dotProduct = Dot(w, relativePosition);
+                    if (dotProduct < 0.0f && dotProduct * dotProduct > combinedRadiusSq * wLengthSq)
+                    {
+                        const float wLength = std::sqrt(wLengthSq);
+                        const Vec2 unitW = w / wLength;
+                        line.direction = {unitW.y, -unitW.x};
+                        u = unitW * (combinedRadius * invTimeHorizon - wLength);
+                    }
+                    else
+                    {
+                        const float leg = std::sqrt(distSq - combinedRadiusSq);
+                        if (Det(relativePosition, w) > 0.0f)
+                        {
+                            line.direction = Vec2{relativePosition.x * leg - relativePosition.y * combinedRadius,
+                                                  relativePosition.x * combinedRadius + relativePosition.y * leg} /
+                                distSq;
+                        }
+                        else
+                        {
+                            line.direction = -Vec2{relativePosition.x * leg + relativePosition.y * combinedRadius,
+                                                   -relativePosition.x * combinedRadius + relativePosition.y * leg} /
+                                distSq;
+                        }
+                        u = line.direction * Dot(relativeVelocity, line.direction) - relativeVelocity;
+                    }
+                }
+                else
+                {
+                    // 已经相交：要求在一帧内分开
+                    const Vec2 w = relativeVelocity - relativePosition * invTimeStep;
+                    const float wLength = std::sqrt(LengthSq(w));
+                    const Vec2 unitW = wLength > Epsilon ? w / wLength : Vec2{1.0f, 0.0f};
+                    line.direction = {unitW.y, -unitW.x};
+                    u = unitW * (combinedRadius * invTimeStep - wLength);
+                }
+                line.point = velocity + u * 0.5f;
+                lines.push_back(line);
+            }
+
+            Vec2 result;
+            const Vec2 preferred(agent.preferredVelocity);
+            const size_t failed = LinearProgram2(lines, agent.maxSpeed, preferred, false, result);
+            if (failed < lines.size())
+                LinearProgram3(lines, failed, agent.maxSpeed, result, projected);
+
+            // 约束线几乎与速度圆相切时判别式的舍入误差会让结果略微越出速度圆
+            if (LengthSq(result) > agent.maxSpeed * agent.maxSpeed)
+                result = Normalize(result) * agent.maxSpeed;
+            velocities[index] = ECS::Vector2f(result.x, result.y);
+        }
+    }
+}
@@ -0,0 +1,128 @@
+#ifndef LOCALAVOIDANCE_H
+#define LOCALAVOIDANCE_H
+
+#include "../../Components/Core.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace Navigation
+{
+    /**
+     * @brief 参与局部避让的代理。速度单位为世界单位每秒。
+     */
+    struct AvoidanceAgent
+    {
+        ECS::Vector2f position{0.0f, 0.0f};
+        ECS::Vector2f velocity{0.0f, 0.0f};           ///< 上一帧实际采用的速度。
+        ECS::Vector2f preferredVelocity{0.0f, 0.0f};  ///< 不考虑其他代理时想要的速度。
+        float radius = 16.0f;
+        float maxSpeed = 100.0f;
+        float neighborDistance = 0.0f;  ///< 邻居搜索半径，不大于 0 时按速度与时间窗自动推算。
+        int maxNeighbors = 10;
+    };
+
+    /**
+     * @brief 每帧重建的均匀空间哈希。
+     *
+     * 代理按所在格子的哈希值做计数排序，计算格子、统计和分散三个阶段都按代理分块并行。
+     * 不同格子可能落入同一个桶，查询时按距离过滤。
+     */
+    class AgentSpatialHash
+    {
+    public:
+        void Build(const std::vector<AvoidanceAgent>& agents, float cellSize);
+
+        /**
+         * @brief 遍历与 position 距离不超过 range 的格子中的全部代理，每个代理至多一次（调用方自行按距离过滤）。
+         */
+        template <typename Fn>
+        void ForEachCandidate(ECS::Vector2f position, float range, Fn&& fn) const
+        {
+            if (m_buckets.empty()) return;
+            const int minX = CellCoord(position.x - range);
+            const int maxX = CellCoord(position.x + range);
+            const int minY = CellCoord(position.y - range);
+            const int maxY = CellCoord(position.y + range);
+
+            // 覆盖的格子不少于桶数时直接遍历全部代理
+            const int64_t cells = (static_cast<int64_t>(maxX) - minX + 1) * (static_cast<int64_t>(maxY) - minY + 1);
+            if (cells >= static_cast<int64_t>(m_mask) + 1)
+            {
+                for (uint32_t index : m_indices)
+                    fn(index);
+                return;
+            }
+
+            // 不同格子可能落入同一个桶，去重后再遍历
+            thread_local std::vector<uint32_t> buckets;
+            buckets.clear();
+            for (int cy = minY; cy <= maxY; ++cy)
+            {
+                for (int cx = minX; cx <= maxX; ++cx)
+                    buckets.push_back(Bucket(cx, cy));
+            }
+            std::sort(buckets.begin(), buckets.end());
+            buckets.erase(std::unique(buckets.begin(), buckets.end()), buckets.end());
+            for (uint32_t bucket : buckets)
+            {
+                for (uint32_t i = m_buckets[bucket]; i < m_buckets[bucket + 1]; ++i)
+                    fn(m_indices[i]);
+            }
+        }
+
+        float GetCellSize() const { return m_cellSize; }
+
+    private:
+        int CellCoord(float v) const { return static_cast<int>(std::floor(v * m_inverseCellSize)); }
+
+        uint32_t Bucket(int cx, int cy) const
+        {
+            const uint32_t h = static_cast<uint32_t>(cx) * 73856093u ^ static_cast<uint32_t>(cy) * 19349663u;
+            return (h * 2654435761u >> 7) & m_mask;
+        }
+
+        float m_cellSize = 1.0f;
+        float m_inverseCellSize = 1.0f;
+        uint32_t m_mask = 0;
+        std::vector<uint32_t> m_buckets;  ///< 桶 b 的代理位于 m_indices[m_buckets[b], m_buckets[b + 1])。
+        std::vector<uint32_t> m_indices;
+        std::vector<uint32_t> m_agentBuckets;
+        std::vector<uint32_t> m_chunkCounts;
+    };
+
+    /**
+     * @brief ORCA（最优互惠碰撞避让）速度求解。
+     *
+     * 对每个代理，用最近的若干邻居构造半平面约束，再用增量线性规划求出最接近期望速度的可行速度；
+     * 约束无解时最小化最大穿透。每个代理只读取上一帧的状态，因此按代理分块并行求解，结果与线程数无关。
+     * 只处理代理之间的避让，墙体由寻路与调用方的可走性检查负责。
+     */
+    class OrcaSolver
+    {
+    public:
+        static constexpr float DefaultTimeHorizon = 1.5f;
+
+        explicit OrcaSolver(float timeHorizon = DefaultTimeHorizon);
+
+        /**
+         * @brief 为每个代理计算新速度，结果写入 velocities（与 agents 一一对应）。
+         */
+        void ComputeVelocities(const std::vector<AvoidanceAgent>& agents, float deltaTime,
+                               std::vector<ECS::Vector2f>& velocities);
+
+        float NeighborDistance(const AvoidanceAgent& agent) const;
+        float GetTimeHorizon() const { return m_timeHorizon; }
+        const AgentSpatialHash& GetSpatialHash() const { return m_hash; }
+
+    private:
+        void SolveRange(const std::vector<AvoidanceAgent>& agents, float deltaTime, size_t begin, size_t end,
+                        std::vector<ECS::Vector2f>& velocities) const;
+
+        float m_timeHorizon;
+        AgentSpatialHash m_hash;
+    };
+}
+
+#endif
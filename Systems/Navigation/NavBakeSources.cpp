@@ -0,0 +1,205 @@
+#include "NavBakeSources.h"
+#include "../WorldStreaming/ChunkManager.h"
+#include "../PixelWorld/ChunkedPixelWorld.h"
+#include <cmath>
+
+namespace Navigation
+{
+    namespace
+    {
+        /// 半开区间 [minValue, maxValue) 覆盖的格子下标闭区间，格子 i 占 [i * size, (i + 1) * size)。
+        void CoveredRange(float minValue, float maxValue, float size, int& first, int& last)
+        {
+            first = static_cast<int>(std::floor(minValue / size));
+            last = static_cast<int>(std::floor(maxValue / size));
+        }
+    }
+
+    NavMaterialTable PixelMaterialTable()
+    {
+        NavMaterialTable table;
+        table.Set(PixelType::Air, {false, 1});
+        table.Set(PixelType::Sand, {true, 1});
+        table.Set(PixelType::Water, {false, 4});
+        table.Set(PixelType::Stone, {true, 1});
+        table.Set(PixelType::Fire, {false, 16});
+        table.Set(PixelType::Steam, {false, 1});
+        table.Set(PixelType::Oil, {false, 4});
+        table.Set(PixelType::Lava, {false, 64});
+        return table;
+    }
+
+    void TilemapNavSource::Sync(const ECS::TilemapComponent& tilemap, ECS::Vector2f position)
+    {
+        const bool moved = position != m_position || tilemap.cellSize != m_cellSize;
+        if (m_synced && !moved && tilemap.runtimeRevision == m_revision)
+            return;
+
+        std::unordered_set<ECS::Vector2i, ECS::Vector2iHash> solid;
+        for (const auto& [coord, tile] : tilemap.runtimeTileCache)
+        {
+            if (std::holds_alternative<SpriteTileData>(tile.data))
+                solid.insert(coord);
+        }
+
+        if (moved)
+        {
+            // 整体移动或缩放：旧位置与新位置的所有固体瓦片都要重新烘焙
+            for (const auto& coord : m_solid)
+                m_changes.push_back(TileRect(coord));
+            m_position = position;
+            m_cellSize = tilemap.cellSize;
+            for (const auto& coord : solid)
+                m_changes.push_back(TileRect(coord));
+        }
+        else
+        {
+            for (const auto& coord : solid)
+            {
+                if (!m_solid.contains(coord)) m_changes.push_back(TileRect(coord));
+            }
+            for (const auto& coord : m_solid)
+            {
+                if (!solid.contains(coord)) m_changes.push_back(TileRect(coord));
+            }
+        }
+        m_solid.swap(solid);
+        m_revision = tilemap.runtimeRevision;
+        m_synced = true;
+    }
+
+    NavCellSample TilemapNavSource::Sample(const NavWorldRect& area) const
+    {
+        if (m_solid.empty() || m_cellSize.x <= 0.0f || m_cellSize.y <= 0.0f) return {};
+
+        // 瓦片以坐标为中心，平移半个格子后即为 [i * size, (i + 1) * size) 的划分
+        int minX, maxX, minY, maxY;
+        CoveredRange(area.minX - m_position.x + m_cellSize.x * 0.5f, area.maxX - m_position.x + m_cellSize.x * 0.5f,
+                     m_cellSize.x, minX, maxX);
+        CoveredRange(area.minY - m_position.y + m_cellSize.y * 0.5f, area.maxY - m_position.y + m_cellSize.y * 0.5f,
+                     m_cellSize.y, minY, maxY);
+
+        const int64_t covered = static_cast<int64_t>(maxX - minX + 1) * (maxY - minY + 1);
+        if (covered > static_cast<int64_t>(m_solid.size()))
+        {
+            for (const auto& coord : m_solid)
+            {
+                if (coord.x >= minX && coord.x <= maxX && coord.y >= minY && coord.y <= maxY) return {true, 1};
+            }
+            return {};
+        }
+        for (int y = minY; y <= maxY; ++y)
+        {
+            for (int x = minX; x <= maxX; ++x)
+            {
+                if (m_solid.contains(ECS::Vector2i(x, y))) return {true, 1};
+            }
+        }
+        return {};
+    }
+
+    bool TilemapNavSource::CollectChanges(std::vector<NavWorldRect>& out)
+    {
+        out.insert(out.end(), m_changes.begin(), m_changes.end());
+        m_changes.clear();
+        return true;
+    }
+
+    NavWorldRect TilemapNavSource::TileRect(const ECS::Vector2i& coord) const
+    {
+        const float centerX = m_position.x + m_cellSize.x * static_cast<float>(coord.x);
+        const float centerY = m_position.y + m_cellSize.y * static_cast<float>(coord.y);
+        return {centerX - m_cellSize.x * 0.5f, centerY - m_cellSize.y * 0.5f,
+                centerX + m_cellSize.x * 0.5f, centerY + m_cellSize.y * 0.5f};
+    }
+
+    ChunkTileNavSource::ChunkTileNavSource(std::shared_ptr<WorldStreaming::ChunkManager> manager,
+                                           NavMaterialTable materials)
+        : m_manager(std::move(manager)), m_materials(std::move(materials))
+    {
+    }
+
+    NavCellSample ChunkTileNavSource::Sample(const NavWorldRect& area) const
+    {
+        using WorldStreaming::Chunk;
+        const float tileSize = m_manager->GetTileSize();
+        int minX, maxX, minY, maxY;
+        CoveredRange(area.minX, area.maxX, tileSize, minX, maxX);
+        CoveredRange(area.minY, area.maxY, tileSize, minY, maxY);
+
+        // 按区块遍历，每个区块只查一次表
+        const auto chunkOf = [](int tile) { return tile >= 0 ? tile / Chunk::SIZE : (tile - Chunk::SIZE + 1) / Chunk::SIZE; };
+        NavCellSample sample;
+        for (int cy = chunkOf(minY); cy <= chunkOf(maxY); ++cy)
+        {
+            for (int cx = chunkOf(minX); cx <= chunkOf(maxX); ++cx)
+            {
+                const Chunk* chunk = m_manager->GetChunk({cx, cy});
+                if (!chunk) continue;
+                const int x0 = std::max(minX - cx * Chunk::SIZE, 0);
+                const int y0 = std::max(minY - cy * Chunk::SIZE, 0);
+                const int x1 = std::min(maxX - cx * Chunk::SIZE, Chunk::SIZE - 1);
+                const int y1 = std::min(maxY - cy * Chunk::SIZE, Chunk::SIZE - 1);
+                uint16_t row[Chunk::SIZE];
+                for (int y = y0; y <= y1; ++y)
+                {
+                    chunk->GetTiles().GetRegion(x0, y, x1 - x0 + 1, 1, row);
+                    for (int x = x0; x <= x1; ++x)
+                    {
+                        sample.Merge(m_materials.Get(row[x - x0]));
+                        if (sample.solid) return sample;
+                    }
+                }
+            }
+        }
+        return sample;
+    }
+
+    bool ChunkTileNavSource::CollectChanges(std::vector<NavWorldRect>& out)
+    {
+        const float tileSize = m_manager->GetTileSize();
+        const bool tracked = tileSize == m_tileSize &&
+            m_manager->ForEachChangeSince(m_revision, [&](const WorldStreaming::TileRegionChange& change)
+            {
+                out.push_back({static_cast<float>(change.minX) * tileSize, static_cast<float>(change.minY) * tileSize,
+                               static_cast<float>(change.maxX + 1) * tileSize,
+                               static_cast<float>(change.maxY + 1) * tileSize});
+            });
+        m_revision = m_manager->GetRevision();
+        m_tileSize = tileSize;
+        return tracked;
+    }
+
+    PixelWorldNavSource::PixelWorldNavSource(std::shared_ptr<ChunkedPixelWorld> world, float pixelScale,
+                                             NavMaterialTable materials)
+        : m_world(std::move(world)), m_pixelScale(pixelScale), m_materials(std::move(materials))
+    {
+    }
+
+    NavCellSample PixelWorldNavSource::Sample(const NavWorldRect& area) const
+    {
+        int minX, maxX, minY, maxY;
+        CoveredRange(area.minX, area.maxX, m_pixelScale, minX, maxX);
+        CoveredRange(area.minY, area.maxY, m_pixelScale, minY, maxY);
+
+        NavCellSample sample;
+        m_world->VisitPixelTypes(minX, minY, maxX, maxY, [&](uint32_t type)
+        {
+            sample.Merge(m_materials.Get(type));
+            return !sample.solid;
+        });
+        return sample;
+    }
+
+    bool PixelWorldNavSource::CollectChanges(std::vector<NavWorldRect>& out)
+    {
+        const bool tracked = m_world->ForEachChangeSince(m_revision, [&](const PixelRegionChange& change)
+        {
+            out.push_back({static_cast<float>(change.minX) * m_pixelScale, static_cast<float>(change.minY) * m_pixelScale,
+                           static_cast<float>(change.maxX + 1) * m_pixelScale,
+                           static_cast<float>(change.maxY + 1) * m_pixelScale});
+        });
+        m_revision = m_world->GetRevision();
+        return tracked;
+    }
+}
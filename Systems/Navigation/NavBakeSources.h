@@ -0,0 +1,92 @@
+#ifndef NAVBAKESOURCES_H
+#define NAVBAKESOURCES_H
+
+#include "NavGridBaker.h"
+#include "../../Components/Core.h"
+#include "../../Components/TilemapComponent.h"
+#include <memory>
+#include <unordered_set>
+#include <vector>
+
+namespace WorldStreaming
+{
+    class ChunkManager;
+}
+
+class ChunkedPixelWorld;
+
+namespace Navigation
+{
+    /**
+     * @brief 像素类型的默认导航属性：沙与石为固体，水与油代价较高，熔岩代价很高，其余可走。
+     *
+     * WorldStreaming 的地形生成同样以像素类型作为瓦片编号，两类烘焙源共用这张表。
+     */
+    NavMaterialTable PixelMaterialTable();
+
+    /**
+     * @brief 瓦片地图烘焙源：SpriteTileData 瓦片为固体（与瓦片碰撞体的判定一致），瓦片以坐标为中心占一个格子。
+     */
+    class TilemapNavSource : public INavBakeSource
+    {
+    public:
+        /**
+         * @brief 与瓦片地图同步。只在运行时缓存版本、位置或格子尺寸改变时重建固体集合，并记录增删的瓦片。
+         */
+        void Sync(const ECS::TilemapComponent& tilemap, ECS::Vector2f position);
+
+        NavCellSample Sample(const NavWorldRect& area) const override;
+        bool CollectChanges(std::vector<NavWorldRect>& out) override;
+
+    private:
+        NavWorldRect TileRect(const ECS::Vector2i& coord) const;
+
+        std::unordered_set<ECS::Vector2i, ECS::Vector2iHash> m_solid;
+        std::vector<NavWorldRect> m_changes;
+        ECS::Vector2f m_position{0.0f, 0.0f};
+        ECS::Vector2f m_cellSize{0.0f, 0.0f};
+        uint64_t m_revision = 0;
+        bool m_synced = false;
+        bool m_reset = false;
+    };
+
+    /**
+     * @brief 流式区块烘焙源：按材质表解释已加载区块的瓦片编号，未加载的区域视为空。
+     */
+    class ChunkTileNavSource : public INavBakeSource
+    {
+    public:
+        ChunkTileNavSource(std::shared_ptr<WorldStreaming::ChunkManager> manager, NavMaterialTable materials);
+
+        NavCellSample Sample(const NavWorldRect& area) const override;
+        bool CollectChanges(std::vector<NavWorldRect>& out) override;
+
+        const WorldStreaming::ChunkManager* GetManager() const { return m_manager.get(); }
+
+    private:
+        std::shared_ptr<WorldStreaming::ChunkManager> m_manager;
+        NavMaterialTable m_materials;
+        uint64_t m_revision = 0;
+        float m_tileSize = 0.0f;
+    };
+
+    /**
+     * @brief 区块像素世界烘焙源：按材质表解释像素类型，每个像素在世界中占 pixelScale 见方。
+     */
+    class PixelWorldNavSource : public INavBakeSource
+    {
+    public:
+        PixelWorldNavSource(std::shared_ptr<ChunkedPixelWorld> world, float pixelScale, NavMaterialTable materials);
+
+        NavCellSample Sample(const NavWorldRect& area) const override;
+        bool CollectChanges(std::vector<NavWorldRect>& out) override;
+
+    private:
+        std::shared_ptr<ChunkedPixelWorld> m_world;
+        float m_pixelScale;
+        NavMaterialTable m_materials;
+        uint64_t m_revision = 0;
+    };
+}
+
+#endif
@@ -3,25 +3,67 @@
 
 #include "../../Components/Core.h"
 #include <vector>
+#include <algorithm>
+#include <cstddef>
 #include <cstdint>
 #include <utility>
 
 namespace Navigation
 {
+    /**
+     * @brief 闭区间格子矩形。max 小于 min 时为空，寻路时表示不限制范围。
+     */
+    struct NavRect
+    {
+        int minX = 0;
+        int minY = 0;
+        int maxX = -1;
+        int maxY = -1;
+
+        bool IsEmpty() const { return maxX < minX || maxY < minY; }
+        int Width() const { return maxX - minX + 1; }
+        int Height() const { return maxY - minY + 1; }
+
+        bool Contains(int x, int y) const
+        {
+            return x >= minX && x <= maxX && y >= minY && y <= maxY;
+        }
+    };
+
+    struct NavCellChange
+    {
+        int x;
+        int y;
+        uint64_t revision;
+    };
+
     struct NavGrid
     {
+        static constexpr size_t MaxTrackedChanges = 65536;
+        static constexpr int BitsPerWord = 64;
+
         int width = 0;
         int height = 0;
         float cellSize = 32.0f;
-        std::vector<uint8_t> walkable;
+        int wordsPerRow = 0;                 ///< 每行占用的 64 位字数，行尾多出的位恒为 0。
+        std::vector<uint64_t> walkableBits;  ///< 按行存储的可走性位图，第 x 格对应该行第 x / 64 个字的第 x % 64 位。
+        /**
+         * 可选代价层：为空时每格进入代价为 1，否则为每格 1~255 的进入代价倍率。
+         * A* 与流场按代价搜索；跳点搜索只适用于等代价网格，存在代价层时退回 A*；HPA 抽象图仍按等代价估计走廊。
+         */
+        std::vector<uint8_t> costs;
         ECS::Vector2f origin{0.0f, 0.0f};
+        uint64_t revision = 0;               ///< 每次可走性或代价实际改变时递增。
+        uint64_t trimmedRevision = 0;        ///< 不晚于该版本的修改记录已被丢弃。
+        std::vector<NavCellChange> changes;  ///< 最近的修改记录，按版本递增。
 
         NavGrid() = default;
 
         NavGrid(int w, int h, float cs, ECS::Vector2f org = {0.0f, 0.0f})
-            : width(w), height(h), cellSize(cs), origin(org),
-              walkable(static_cast<size_t>(w * h), 1)
+            : width(w), height(h), cellSize(cs), wordsPerRow((w + BitsPerWord - 1) / BitsPerWord),
+              walkableBits(static_cast<size_t>(wordsPerRow) * static_cast<size_t>(h), 0), origin(org)
         {
+            FillBits(true);
         }
 
         bool InBounds(int x, int y) const
@@ -29,16 +71,102 @@ namespace Navigation
             return x >= 0 && x < width && y >= 0 && y < height;
         }
 
+        const uint64_t* Row(int y) const { return walkableBits.data() + static_cast<size_t>(y) * wordsPerRow; }
+
         bool IsWalkable(int x, int y) const
         {
             if (!InBounds(x, y)) return false;
-            return walkable[static_cast<size_t>(y * width + x)] != 0;
+            return (Row(y)[x / BitsPerWord] >> (x % BitsPerWord)) & 1u;
         }
 
         void SetWalkable(int x, int y, bool v)
         {
             if (!InBounds(x, y)) return;
-            walkable[static_cast<size_t>(y * width + x)] = v ? 1 : 0;
+            uint64_t& word = walkableBits[static_cast<size_t>(y) * wordsPerRow + x / BitsPerWord];
+            const uint64_t bit = uint64_t{1} << (x % BitsPerWord);
+            if (((word & bit) != 0) == v) return;
+            word ^= bit;
+            RecordChange(x, y);
+        }
+
+        /**
+         * @brief 第 y 行 [x0, x1] 是否全部可走，按 64 位字整体比较。越界视为不可走。
+         */
+        bool IsRowSpanWalkable(int y, int x0, int x1) const
+        {
+            if (x0 > x1) std::swap(x0, x1);
+            if (y < 0 || y >= height || x0 < 0 || x1 >= width) return false;
+            const uint64_t* row = Row(y);
+            const int firstWord = x0 / BitsPerWord;
+            const int lastWord = x1 / BitsPerWord;
+            for (int w = firstWord; w <= lastWord; ++w)
+            {
+                uint64_t mask = ~uint64_t{0};
+                if (w == firstWord) mask &= ~uint64_t{0} << (x0 % BitsPerWord);
+                if (w == lastWord) mask &= ~uint64_t{0} >> (BitsPerWord - 1 - x1 % BitsPerWord);
+                if ((row[w] & mask) != mask) return false;
+            }
+            return true;
+        }
+
+        /**
+         * @brief 把所有格子设为同一可走性。不逐格记录修改，而是丢弃修改记录，依赖方随后全量重建。
+         */
+        void Fill(bool v)
+        {
+            FillBits(v);
+            InvalidateHistory();
+        }
+
+        bool HasCosts() const { return !costs.empty(); }
+
+        uint8_t GetCost(int x, int y) const
+        {
+            if (costs.empty() || !InBounds(x, y)) return 1;
+            return costs[static_cast<size_t>(y) * width + x];
+        }
+
+        /**
+         * @brief 设置格子的进入代价（0 按 1 处理）。第一次设置非 1 的代价时才分配代价层。
+         */
+        void SetCost(int x, int y, uint8_t cost)
+        {
+            if (!InBounds(x, y)) return;
+            cost = std::max<uint8_t>(cost, 1);
+            if (costs.empty())
+            {
+                if (cost == 1) return;
+                costs.assign(static_cast<size_t>(width) * static_cast<size_t>(height), 1);
+            }
+            uint8_t& cell = costs[static_cast<size_t>(y) * width + x];
+            if (cell == cost) return;
+            cell = cost;
+            RecordChange(x, y);
+        }
+
+        /**
+         * @brief 移除代价层，所有格子恢复为等代价。
+         */
+        void ClearCosts()
+        {
+            if (costs.empty()) return;
+            costs.clear();
+            InvalidateHistory();
+        }
+
+        /**
+         * @brief 遍历 sinceRevision 之后的可走性与代价修改。
+         * @return 所需记录已被丢弃时返回 false，调用方应全量重建。
+         */
+        template <typename Fn>
+        bool ForEachChangeSince(uint64_t sinceRevision, Fn&& fn) const
+        {
+            if (sinceRevision < trimmedRevision) return false;
+            auto it = std::upper_bound(changes.begin(), changes.end(), sinceRevision,
+                                       [](uint64_t r, const NavCellChange& change) { return r < change.revision; });
+            for (; it != changes.end(); ++it)
+                fn(it->x, it->y);
+            return true;
         }
 
         ECS::Vector2f GridToWorld(int x, int y) const
@@ -55,6 +183,33 @@ namespace Navigation
             int gy = static_cast<int>((pos.y - origin.y) / cellSize);
             return {gx, gy};
         }
+
+    private:
+        void FillBits(bool v)
+        {
+            std::fill(walkableBits.begin(), walkableBits.end(), v ? ~uint64_t{0} : uint64_t{0});
+            const int tail = width % BitsPerWord;
+            if (!v || tail == 0) return;
+            for (int y = 0; y < height; ++y)
+                walkableBits[static_cast<size_t>(y + 1) * wordsPerRow - 1] = (uint64_t{1} << tail) - 1;
+        }
+
+        void RecordChange(int x, int y)
+        {
+            changes.push_back({x, y, ++revision});
+            if (changes.size() > MaxTrackedChanges)
+            {
+                const size_t drop = changes.size() / 2;
+                trimmedRevision = changes[drop - 1].revision;
+                changes.erase(changes.begin(), changes.begin() + static_cast<std::ptrdiff_t>(drop));
+            }
+        }
+
+        void InvalidateHistory()
+        {
+            changes.clear();
+            trimmedRevision = ++revision;
+        }
     };
 }
 
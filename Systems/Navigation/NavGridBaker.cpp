@@ -0,0 +1,207 @@
+#include "NavGridBaker.h"
+#include "../../Event/JobSystem.h"
+#include <bit>
+#include <cmath>
+
+namespace Navigation
+{
+    namespace
+    {
+        /// 每个任务采样的格子数。
+        static constexpr size_t CellsPerJob = 1024;
+        /// 采样矩形向内收缩的比例，恰好贴着格子边界的固体不会堵住相邻格子。
+        static constexpr float SampleInset = 1e-3f;
+
+        struct SampleJob : public IJob
+        {
+            const NavGridBaker* baker;
+            const NavGrid* grid;
+            const int32_t* cells;
+            NavCellSample* samples;
+            size_t count;
+
+            SampleJob(const NavGridBaker* b, const NavGrid* g, const int32_t* c, NavCellSample* s, size_t n)
+                : baker(b), grid(g), cells(c), samples(s), count(n)
+            {
+            }
+
+            void Execute() override
+            {
+                for (size_t i = 0; i < count; ++i)
+                    samples[i] = baker->SampleCell(*grid, cells[i] % grid->width, cells[i] / grid->width);
+            }
+        };
+    }
+
+    void NavGridBaker::AddSource(std::shared_ptr<INavBakeSource> source)
+    {
+        if (!source) return;
+        m_sources.push_back(std::move(source));
+        MarkAllDirty();
+    }
+
+    void NavGridBaker::RemoveSource(const INavBakeSource* source)
+    {
+        const auto it = std::remove_if(m_sources.begin(), m_sources.end(),
+                                       [source](const auto& s) { return s.get() == source; });
+        if (it == m_sources.end()) return;
+        m_sources.erase(it, m_sources.end());
+        MarkAllDirty();
+    }
+
+    void NavGridBaker::ClearSources()
+    {
+        m_sources.clear();
+        MarkAllDirty();
+    }
+
+    void NavGridBaker::MarkDirty(const NavWorldRect& area)
+    {
+        m_pending.push_back(area);
+    }
+
+    void NavGridBaker::MarkAllDirty()
+    {
+        m_fullRebake = true;
+    }
+
+    size_t NavGridBaker::BakeAll(NavGrid& grid)
+    {
+        MarkAllDirty();
+        return Update(grid);
+    }
+
+    size_t NavGridBaker::Update(NavGrid& grid)
+    {
+        if (grid.width <= 0 || grid.height <= 0) return 0;
+        if (!MatchesLayout(grid))
+        {
+            m_width = grid.width;
+            m_height = grid.height;
+            m_cellSize = grid.cellSize;
+            m_origin = grid.origin;
+            m_dirtyBits.assign(grid.walkableBits.size(), 0);
+            m_fullRebake = true;
+        }
+
+        // 即使要全量烘焙也要收集一遍修改，推进各烘焙源的记录位置
+        for (auto& source : m_sources)
+        {
+            if (!source->CollectChanges(m_pending))
+                m_fullRebake = true;
+        }
+
+        if (m_fullRebake)
+        {
+            const int tail = grid.width % NavGrid::BitsPerWord;
+            std::fill(m_dirtyBits.begin(), m_dirtyBits.end(), ~uint64_t{0});
+            for (int y = 0; tail != 0 && y < grid.height; ++y)
+                m_dirtyBits[static_cast<size_t>(y + 1) * grid.wordsPerRow - 1] = (uint64_t{1} << tail) - 1;
+            m_fullRebake = false;
+        }
+        else
+        {
+            for (const auto& area : m_pending)
+                MarkCells(grid, area);
+        }
+        m_pending.clear();
+        return BakeMarked(grid);
+    }
+
+    NavCellSample NavGridBaker::SampleCell(const NavGrid& grid, int x, int y) const
+    {
+        const float inset = grid.cellSize * SampleInset;
+        const NavWorldRect area{
+            grid.origin.x + static_cast<float>(x) * grid.cellSize + inset,
+            grid.origin.y + static_cast<float>(y) * grid.cellSize + inset,
+            grid.origin.x + static_cast<float>(x + 1) * grid.cellSize - inset,
+            grid.origin.y + static_cast<float>(y + 1) * grid.cellSize - inset
+        };
+        NavCellSample sample;
+        for (const auto& source : m_sources)
+        {
+            sample.Merge(source->Sample(area));
+            if (sample.solid) break;
+        }
+        return sample;
+    }
+
+    void NavGridBaker::MarkCells(const NavGrid& grid, const NavWorldRect& area)
+    {
+        // 只会多标不会漏标：边界恰好落在格子线上时把相邻格子也算进来
+        const float inverse = 1.0f / grid.cellSize;
+        const int minX = std::max(static_cast<int>(std::floor((area.minX - grid.origin.x) * inverse)), 0);
+        const int minY = std::max(static_cast<int>(std::floor((area.minY - grid.origin.y) * inverse)), 0);
+        const int maxX = std::min(static_cast<int>(std::floor((area.maxX - grid.origin.x) * inverse)), grid.width - 1);
+        const int maxY = std::min(static_cast<int>(std::floor((area.maxY - grid.origin.y) * inverse)), grid.height - 1);
+        if (minX > maxX || minY > maxY) return;
+
+        const int firstWord = minX / NavGrid::BitsPerWord;
+        const int lastWord = maxX / NavGrid::BitsPerWord;
+        for (int y = minY; y <= maxY; ++y)
+        {
+            uint64_t* row = m_dirtyBits.data() + static_cast<size_t>(y) * grid.wordsPerRow;
+            for (int w = firstWord; w <= lastWord; ++w)
+            {
+                uint64_t mask = ~uint64_t{0};
+                if (w == firstWord) mask &= ~uint64_t{0} << (minX % NavGrid::BitsPerWord);
+                if (w == lastWord) mask &= ~uint64_t{0} >> (NavGrid::BitsPerWord - 1 - maxX % NavGrid::BitsPerWord);
+                row[w] |= mask;
+            }
+        }
+    }
+
+    size_t NavGridBaker::BakeMarked(NavGrid& grid)
+    {
+        m_cells.clear();
+        for (int y = 0; y < grid.height; ++y)
+        {
+            uint64_t* row = m_dirtyBits.data() + static_cast<size_t>(y) * grid.wordsPerRow;
+            for (int w = 0; w < grid.wordsPerRow; ++w)
+            {
+                for (uint64_t bits = row[w]; bits != 0; bits &= bits - 1)
+                    m_cells.push_back(y * grid.width + w * NavGrid::BitsPerWord + std::countr_zero(bits));
+                row[w] = 0;
+            }
+        }
+        if (m_cells.empty()) return 0;
+
+        // 采样并行，写回串行：SetWalkable/SetCost 会追加网格的修改记录
+        m_samples.resize(m_cells.size());
+        if (m_cells.size() <= CellsPerJob)
+        {
+            SampleJob(this, &grid, m_cells.data(), m_samples.data(), m_cells.size()).Execute();
+        }
+        else
+        {
+            std::vector<SampleJob> jobs;
+            std::vector<JobHandle> handles;
+            jobs.reserve((m_cells.size() + CellsPerJob - 1) / CellsPerJob);
+            for (size_t begin = 0; begin < m_cells.size(); begin += CellsPerJob)
+            {
+                jobs.emplace_back(this, &grid, m_cells.data() + begin, m_samples.data() + begin,
+                                  std::min(CellsPerJob, m_cells.size() - begin));
+            }
+            auto& jobSystem = JobSystem::GetInstance();
+            for (auto& job : jobs)
+                handles.push_back(jobSystem.Schedule(&job));
+            JobSystem::CompleteAll(handles);
+        }
+
+        for (size_t i = 0; i < m_cells.size(); ++i)
+        {
+            const int x = m_cells[i] % grid.width;
+            const int y = m_cells[i] / grid.width;
+            grid.SetWalkable(x, y, !m_samples[i].solid);
+            grid.SetCost(x, y, m_samples[i].cost);
+        }
+        return m_cells.size();
+    }
+
+    bool NavGridBaker::MatchesLayout(const NavGrid& grid) const
+    {
+        return grid.width == m_width && grid.height == m_height && grid.cellSize == m_cellSize &&
+            grid.origin.x == m_origin.x && grid.origin.y == m_origin.y &&
+            m_dirtyBits.size() == grid.walkableBits.size();
+    }
+}
@@ -0,0 +1,144 @@
+#ifndef NAVGRIDBAKER_H
+#define NAVGRIDBAKER_H
+
+#include "NavGrid.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace Navigation
+{
+    /**
+     * @brief 世界坐标下的半开矩形 [min, max)。
+     */
+    struct NavWorldRect
+    {
+        float minX = 0.0f;
+        float minY = 0.0f;
+        float maxX = 0.0f;
+        float maxY = 0.0f;
+    };
+
+    /**
+     * @brief 一块区域的导航采样结果：任一部分为固体即不可走，代价取区域内的最大值。
+     */
+    struct NavCellSample
+    {
+        bool solid = false;
+        uint8_t cost = 1;
+
+        void Merge(const NavCellSample& other)
+        {
+            solid = solid || other.solid;
+            cost = std::max(cost, other.cost);
+        }
+    };
+
+    /**
+     * @brief 材质编号（瓦片编号、像素类型等）到导航采样结果的映射。0 默认可走，未登记的编号按 fallback 处理。
+     */
+    class NavMaterialTable
+    {
+    public:
+        NavCellSample fallback{true, 1};
+
+        void Set(uint32_t material, NavCellSample sample)
+        {
+            if (material >= m_samples.size())
+                m_samples.resize(material + 1, fallback);
+            m_samples[material] = sample;
+        }
+
+        NavCellSample Get(uint32_t material) const
+        {
+            if (material < m_samples.size()) return m_samples[material];
+            return material == 0 ? NavCellSample{} : fallback;
+        }
+
+    private:
+        std::vector<NavCellSample> m_samples{NavCellSample{}};
+    };
+
+    /**
+     * @brief 烘焙源：把关卡数据转换为导航采样，并报告自上次收集以来修改过的区域。
+     *
+     * Sample 可能在多个工作线程上并发调用，实现不得修改共享状态。
+     */
+    class INavBakeSource
+    {
+    public:
+        virtual ~INavBakeSource() = default;
+
+        /**
+         * @brief 采样 area 覆盖的区域。
+         */
+        virtual NavCellSample Sample(const NavWorldRect& area) const = 0;
+
+        /**
+         * @brief 把上次调用以来修改过的世界区域追加到 out。
+         * @return 无法给出增量（修改记录已丢弃、数据整体替换等）时返回 false，烘焙器随后全量重烘焙。
+         */
+        virtual bool CollectChanges(std::vector<NavWorldRect>& out) = 0;
+    };
+
+    /**
+     * @brief 从烘焙源生成 NavGrid 的可走性与代价层，只重新采样被修改区域覆盖的格子。
+     *
+     * 结果通过 SetWalkable/SetCost 写回网格，HPA、流场与寻路队列沿用网格的修改记录增量更新。
+     * 增量烘焙与全量烘焙对同一数据得到相同的网格。
+     */
+    class NavGridBaker
+    {
+    public:
+        void AddSource(std::shared_ptr<INavBakeSource> source);
+        void RemoveSource(const INavBakeSource* source);
+        void ClearSources();
+
+        /**
+         * @brief 标记世界区域需要重新烘焙。
+         */
+        void MarkDirty(const NavWorldRect& area);
+
+        /**
+         * @brief 下次 Update 时重新烘焙整个网格。
+         */
+        void MarkAllDirty();
+
+        /**
+         * @brief 忽略修改记录，重新采样网格的全部格子。
+         * @return 重新采样的格子数。
+         */
+        size_t BakeAll(NavGrid& grid);
+
+        /**
+         * @brief 收集各烘焙源的修改，只重新采样受影响的格子。网格尺寸或原点改变时全量烘焙。
+         * @return 重新采样的格子数。
+         */
+        size_t Update(NavGrid& grid);
+
+        /**
+         * @brief 格子 (x, y) 在所有烘焙源中的合并采样。
+         */
+        NavCellSample SampleCell(const NavGrid& grid, int x, int y) const;
+
+    private:
+        void MarkCells(const NavGrid& grid, const NavWorldRect& area);
+        size_t BakeMarked(NavGrid& grid);
+        bool MatchesLayout(const NavGrid& grid) const;
+
+        std::vector<std::shared_ptr<INavBakeSource>> m_sources;
+        std::vector<NavWorldRect> m_pending;  ///< 尚未映射到格子的脏区域。
+        std::vector<uint64_t> m_dirtyBits;    ///< 与 NavGrid::walkableBits 同布局的脏格子位图。
+        std::vector<int32_t> m_cells;
+        std::vector<NavCellSample> m_samples;
+        bool m_fullRebake = true;
+        int m_width = 0;
+        int m_height = 0;
+        float m_cellSize = 0.0f;
+        ECS::Vector2f m_origin{0.0f, 0.0f};
+    };
+}
+
+#endif
@@ -1,11 +1,39 @@
 #include "NavigationSystem.h"
 #include "../../Components/NavAgentComponent.h"
 #include "../../Components/Transform.h"
+#include "../../Components/TilemapComponent.h"
+#include "../../Components/ColliderComponent.h"
+#include "../../Components/ChunkWorldComponent.h"
 #include "../../Resources/RuntimeAsset/RuntimeScene.h"
+#include <algorithm>
 #include <cmath>
+#include <unordered_map>
 
 namespace Systems
 {
+    namespace
+    {
+        uint64_t GoalKey(int x, int y)
+        {
+            return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(y);
+        }
+
+        /// 向目标移动 step 距离，到达时返回 true。
+        bool MoveTowards(ECS::Vector2f& position, ECS::Vector2f target, float step)
+        {
+            ECS::Vector2f diff = target - position;
+            float dist = std::sqrt(diff.x * diff.x + diff.y * diff.y);
+            if (dist <= step)
+            {
+                position = target;
+                return true;
+            }
+            position.x += diff.x / dist * step;
+            position.y += diff.y / dist * step;
+            return false;
+        }
+    }
+
     void NavigationSystem::OnCreate(RuntimeScene* scene, EngineContext& engineCtx)
     {
     }
@@ -15,17 +43,117 @@ namespace Systems
         if (m_grid.width == 0 || m_grid.height == 0)
             return;
 
+        if (m_autoBake)
+            BakeFromScene(scene);
+        UpdateHierarchy();
+        m_flowFields.Update(m_grid);
+        m_pathQueue.Update(m_grid);
+
+        auto refineNextSegment = [this](ECS::NavAgentComponent& agent)
+        {
+            // 分层图正在后台重建，或走廊来自 SetGrid 之前的网格时，返回 false 让代理重新寻路
+            if (!m_hierarchy.IsBuilt())
+                return false;
+            const int index = agent.corridorIndex;
+            const auto from = m_grid.WorldToGrid(agent.corridor[index - 1]);
+            const auto to = m_grid.WorldToGrid(agent.corridor[index]);
+            if (!m_grid.InBounds(from.first, from.second) || !m_grid.InBounds(to.first, to.second))
+                return false;
+            ++agent.corridorIndex;
+            // 寻路结果不含起点格子，首段以起点为锚点拉直
+            if (agent.path.empty())
+            {
+                agent.path.push_back(m_grid.GridToWorld(from.first, from.second));
+                agent.currentWaypointIndex = 1;
+            }
+            const size_t appended = agent.path.size() - 1;
+            if (!m_hierarchy.RefineSegment(m_grid, from, to, true, agent.path))
+                return false;
+            SmoothPath(agent, appended);
+            return true;
+        };
+
         auto& registry = scene->GetRegistry();
         auto view = registry.view<ECS::NavAgentComponent, ECS::TransformComponent>();
 
+        // 交付异步寻路结果，每帧最多占用 PathIntegrationBudgetMs
+        m_pathQueue.Integrate(PathIntegrationBudgetMs, [&](uint64_t requester, const Navigation::PathResult& result)
+        {
+            const auto entity = static_cast<entt::entity>(static_cast<uint32_t>(requester));
+            if (!registry.valid(entity) || !view.contains(entity))
+                return;
+            auto& agent = view.get<ECS::NavAgentComponent>(entity);
+            if (!agent.isPathPending)
+                return;
+            agent.isPathPending = false;
+            agent.path = result.waypoints;
+            agent.currentWaypointIndex = 0;
+
+            // 等待期间代理可能已经前进，从它当前所在格子之后继续
+            const auto cell = m_grid.WorldToGrid(view.get<ECS::TransformComponent>(entity).position);
+            for (size_t i = 0; i < agent.path.size(); ++i)
+            {
+                if (m_grid.WorldToGrid(agent.path[i]) == cell)
+                    agent.currentWaypointIndex = static_cast<int>(i) + 1;
+            }
+
+            // 路径不含代理所在格子时补上它作为拉直的锚点
+            if (agent.currentWaypointIndex == 0 && agent.smoothPath && !agent.path.empty())
+            {
+                agent.path.insert(agent.path.begin(), m_grid.GridToWorld(cell.first, cell.second));
+                agent.currentWaypointIndex = 1;
+            }
+            SmoothPath(agent, static_cast<size_t>(std::max(agent.currentWaypointIndex - 1, 0)));
+            agent.hasArrived = !result.found || agent.path.empty();
+        });
+
+        // 统计本帧各目标格子的寻路请求数，目标相同的代理足够多时改用共享流场；同时记录参与避让的代理移动前的位置
+        std::unordered_map<uint64_t, int> requestsPerGoal;
+        m_avoidanceEntities.clear();
+        m_avoidanceAgents.clear();
+        for (auto entity : view)
+        {
+            const auto& agent = view.get<ECS::NavAgentComponent>(entity);
+            if (!agent.Enable)
+                continue;
+            if (agent.isPathRequested)
+            {
+                const auto [gx, gy] = m_grid.WorldToGrid(agent.destination);
+                ++requestsPerGoal[GoalKey(gx, gy)];
+            }
+            if (agent.avoidanceEnabled && deltaTime > 0.0f)
+            {
+                Navigation::AvoidanceAgent avoidance;
+                avoidance.position = view.get<ECS::TransformComponent>(entity).position;
+                avoidance.velocity = agent.velocity;
+                avoidance.radius = agent.radius;
+                avoidance.maxSpeed = agent.maxSpeed > 0.0f ? agent.maxSpeed : agent.speed;
+                avoidance.maxNeighbors = agent.maxNeighbors;
+                m_avoidanceEntities.push_back(static_cast<uint32_t>(entity));
+                m_avoidanceAgents.push_back(avoidance);
+            }
+        }
+
         for (auto entity : view)
         {
             auto& agent = view.get<ECS::NavAgentComponent>(entity);
             auto& transform = view.get<ECS::TransformComponent>(entity);
+            const uint64_t requester = static_cast<uint32_t>(entity);
 
             if (!agent.Enable)
                 continue;
 
+            // 队列被清空时重新请求；代理被停下时取消排队中的请求
+            if (agent.isPathPending && !m_pathQueue.IsPending(requester))
+            {
+                agent.isPathPending = false;
+                agent.isPathRequested = true;
+            }
+            else if (!agent.isPathPending && m_pathQueue.IsPending(requester))
+            {
+                m_pathQueue.Cancel(requester);
+            }
+
             if (agent.isPathRequested)
             {
                 Navigation::PathRequest req;
@@ -33,13 +161,86 @@ namespace Systems
                 req.end = agent.destination;
                 req.allowDiagonal = true;
 
-                auto result = Navigation::Pathfinder::FindPath(m_grid, req);
-                agent.path = std::move(result.waypoints);
-                agent.currentWaypointIndex = 0;
-                agent.hasArrived = !result.found || agent.path.empty();
+                agent.corridor.clear();
+                agent.corridorIndex = 0;
+                agent.flowField.reset();
+
+                const auto [sx, sy] = m_grid.WorldToGrid(req.start);
+                const auto [ex, ey] = m_grid.WorldToGrid(req.end);
+                const bool useFlowField =
+                    requestsPerGoal[GoalKey(ex, ey)] >= FlowFieldAgentThreshold || m_flowFields.Find(ex, ey);
+                // 分层图构建完成前，长距离查询同样交给异步队列做逐格搜索
+                const bool longQuery =
+                    !useFlowField && m_hierarchy.IsBuilt() && m_hierarchy.IsLongQuery(sx, sy, ex, ey);
+                if (useFlowField || longQuery)
+                {
+                    agent.path.clear();
+                    agent.currentWaypointIndex = 0;
+                    agent.isPathPending = false;
+                    m_pathQueue.Cancel(requester);
+                }
+
+                bool found = false;
+                if (useFlowField)
+                {
+                    agent.flowField = m_flowFields.Acquire(m_grid, ex, ey);
+                    found = agent.flowField->IsReachable(sx, sy);
+                    if (!found)
+                        agent.flowField.reset();
+                }
+                else if (longQuery)
+                {
+                    // 长距离查询只搜索抽象图，路段在行进中逐段细化
+                    auto abstractPath = m_hierarchy.FindAbstractPath(m_grid, req);
+                    if (abstractPath.found)
+                    {
+                        for (auto& [cx, cy] : abstractPath.corners)
+                            agent.corridor.push_back(m_grid.GridToWorld(cx, cy));
+                        agent.corridorIndex = 1;
+                        found = refineNextSegment(agent);
+                    }
+                }
+                else
+                {
+                    // 短查询交给异步队列，结果到达前保留旧路径
+                    m_pathQueue.Submit(m_grid, requester, req, agent.pathPriority);
+                    agent.isPathPending = true;
+                    found = true;
+                }
+                agent.hasArrived = !found || (!agent.flowField && !agent.isPathPending && agent.path.empty());
                 agent.isPathRequested = false;
             }
 
+            if (agent.flowField)
+            {
+                if (agent.hasArrived || !FollowFlowField(agent, transform.position, agent.speed * deltaTime))
+                    agent.flowField.reset();
+                continue;
+            }
+
+            // 剩余路径点不足时提前细化下一段，细化失败说明网格已改变，重新寻路
+            while (!agent.hasArrived &&
+                   agent.corridorIndex > 0 && agent.corridorIndex < static_cast<int>(agent.corridor.size()) &&
+                   static_cast<int>(agent.path.size()) - agent.currentWaypointIndex < 2)
+            {
+                if (!refineNextSegment(agent))
+                {
+                    agent.isPathRequested = true;
+                    break;
+                }
+            }
+
+            // 等待结果时沿旧路径前进，旧路径走完后直线走向目标，遇到不可走的格子则原地等待
+            if (agent.isPathPending && agent.currentWaypointIndex >= static_cast<int>(agent.path.size()))
+            {
+                ECS::Vector2f next = transform.position;
+                MoveTowards(next, agent.destination, agent.speed * deltaTime);
+                const auto [nx, ny] = m_grid.WorldToGrid(next);
+                if (m_grid.IsWalkable(nx, ny))
+                    transform.position = next;
+                continue;
+            }
+
             if (agent.hasArrived || agent.path.empty())
                 continue;
 
@@ -49,39 +250,215 @@ namespace Systems
                 continue;
             }
 
-            ECS::Vector2f target = agent.path[agent.currentWaypointIndex];
-            ECS::Vector2f diff = target - transform.position;
-            float dist = std::sqrt(diff.x * diff.x + diff.y * diff.y);
-            float step = agent.speed * deltaTime;
-
-            if (dist <= step)
+            if (MoveTowards(transform.position, agent.path[agent.currentWaypointIndex], agent.speed * deltaTime))
             {
-                transform.position = target;
                 agent.currentWaypointIndex++;
 
-                if (agent.currentWaypointIndex >= static_cast<int>(agent.path.size()))
+                if (agent.currentWaypointIndex >= static_cast<int>(agent.path.size()) && !agent.isPathPending)
                     agent.hasArrived = true;
             }
-            else
+        }
+
+        ApplyAvoidance(scene, deltaTime);
+    }
+
+    void NavigationSystem::SmoothPath(ECS::NavAgentComponent& agent, size_t from) const
+    {
+        if (!agent.smoothPath)
+            return;
+        Navigation::PathSmoother::Simplify(m_grid, agent.path, from);
+        if (agent.cornerRadius > 0.0f)
+            Navigation::PathSmoother::RoundCorners(m_grid, agent.path, agent.cornerRadius, from);
+    }
+
+    void NavigationSystem::ApplyAvoidance(RuntimeScene* scene, float deltaTime)
+    {
+        if (m_avoidanceAgents.empty())
+            return;
+
+        auto& registry = scene->GetRegistry();
+        const float invDeltaTime = 1.0f / deltaTime;
+        for (size_t i = 0; i < m_avoidanceAgents.size(); ++i)
+        {
+            auto& avoidance = m_avoidanceAgents[i];
+            const auto entity = static_cast<entt::entity>(m_avoidanceEntities[i]);
+            const auto& moved = registry.get<ECS::TransformComponent>(entity).position;
+            avoidance.preferredVelocity = ECS::Vector2f((moved.x - avoidance.position.x) * invDeltaTime,
+                                                        (moved.y - avoidance.position.y) * invDeltaTime);
+        }
+
+        m_avoidance.ComputeVelocities(m_avoidanceAgents, deltaTime, m_avoidanceVelocities);
+
+        // 避让只考虑代理之间的约束，新位置落在不可走格子时改为沿单轴滑动，仍不可走则停在原地
+        for (size_t i = 0; i < m_avoidanceAgents.size(); ++i)
+        {
+            const auto& avoidance = m_avoidanceAgents[i];
+            const auto entity = static_cast<entt::entity>(m_avoidanceEntities[i]);
+            auto& agent = registry.get<ECS::NavAgentComponent>(entity);
+            auto& position = registry.get<ECS::TransformComponent>(entity).position;
+
+            const ECS::Vector2f start = avoidance.position;
+            ECS::Vector2f velocity = m_avoidanceVelocities[i];
+            auto walkable = [this](float x, float y)
+            {
+                const auto [gx, gy] = m_grid.WorldToGrid(ECS::Vector2f(x, y));
+                return m_grid.IsWalkable(gx, gy);
+            };
+            if (!walkable(start.x + velocity.x * deltaTime, start.y + velocity.y * deltaTime))
             {
-                ECS::Vector2f dir{diff.x / dist, diff.y / dist};
-                transform.position.x += dir.x * step;
-                transform.position.y += dir.y * step;
+                if (walkable(start.x + velocity.x * deltaTime, start.y))
+                    velocity.y = 0.0f;
+                else if (walkable(start.x, start.y + velocity.y * deltaTime))
+                    velocity.x = 0.0f;
+                else
+                    velocity = ECS::Vector2f(0.0f, 0.0f);
             }
+            position = ECS::Vector2f(start.x + velocity.x * deltaTime, start.y + velocity.y * deltaTime);
+            agent.velocity = velocity;
         }
     }
 
+    bool NavigationSystem::FollowFlowField(ECS::NavAgentComponent& agent, ECS::Vector2f& position, float step) const
+    {
+        const auto& field = *agent.flowField;
+        const auto [x, y] = m_grid.WorldToGrid(position);
+        if (x == field.GetGoalX() && y == field.GetGoalY())
+        {
+            if (MoveTowards(position, agent.destination, step))
+            {
+                agent.hasArrived = true;
+                return false;
+            }
+            return true;
+        }
+
+        // 网格修改后当前格子可能已不可达，此时停下
+        int dx, dy;
+        if (!field.Direction(x, y, dx, dy))
+        {
+            agent.hasArrived = true;
+            return false;
+        }
+        MoveTowards(position, m_grid.GridToWorld(x + dx, y + dy), step);
+        return true;
+    }
+
     void NavigationSystem::OnDestroy(RuntimeScene* scene)
     {
+        m_hierarchyBuild.Cancel();
     }
 
     void NavigationSystem::SetGrid(const Navigation::NavGrid& grid)
     {
         m_grid = grid;
+        if (m_autoBake)
+            m_baker.BakeAll(m_grid);
+        RebuildHierarchy();
+        m_flowFields.InvalidateAll();
+        m_pathQueue.Clear();
+    }
+
+    void NavigationSystem::UpdateHierarchy()
+    {
+        m_hierarchyBuild.Poll(m_hierarchy);
+        if (!m_hierarchy.IsBuilt())
+            return;
+        // 修改记录已被截断（后台构建期间或单帧改动过多）时无法增量修复，改为后台重建而不在主线程上全量构建
+        if (!m_grid.ForEachChangeSince(m_hierarchy.GetRevision(), [](int, int) {}))
+        {
+            RebuildHierarchy();
+            return;
+        }
+        m_hierarchy.Update(m_grid);
+    }
+
+    void NavigationSystem::RebuildHierarchy()
+    {
+        const int clusterSize = m_hierarchy.GetClusterSize();
+        m_hierarchy = Navigation::HierarchicalPathfinder(clusterSize);
+        m_hierarchyBuild.Start(m_grid, clusterSize);
     }
 
     Navigation::NavGrid& NavigationSystem::GetGrid()
     {
         return m_grid;
     }
+
+    void NavigationSystem::SetAutoBake(bool enabled)
+    {
+        m_autoBake = enabled;
+        m_baker.MarkAllDirty();
+    }
+
+    void NavigationSystem::AddBakeSource(std::shared_ptr<Navigation::INavBakeSource> source)
+    {
+        m_baker.AddSource(std::move(source));
+    }
+
+    void NavigationSystem::RemoveBakeSource(const Navigation::INavBakeSource* source)
+    {
+        m_baker.RemoveSource(source);
+    }
+
+    void NavigationSystem::BakeFromScene(RuntimeScene* scene)
+    {
+        auto& registry = scene->GetRegistry();
+
+        // 瓦片地图：只有带瓦片碰撞体的地图参与烘焙
+        std::unordered_map<uint32_t, std::shared_ptr<Navigation::TilemapNavSource>> tilemaps;
+        auto tilemapView = registry.view<ECS::TilemapComponent, ECS::TilemapColliderComponent, ECS::TransformComponent>();
+        for (auto entity : tilemapView)
+        {
+            const auto& tilemap = tilemapView.get<ECS::TilemapComponent>(entity);
+            if (!tilemap.Enable || !tilemapView.get<ECS::TilemapColliderComponent>(entity).Enable)
+                continue;
+            const uint32_t id = static_cast<uint32_t>(entity);
+            auto it = m_tilemapSources.find(id);
+            std::shared_ptr<Navigation::TilemapNavSource> source;
+            if (it != m_tilemapSources.end())
+            {
+                source = it->second;
+            }
+            else
+            {
+                source = std::make_shared<Navigation::TilemapNavSource>();
+                m_baker.AddSource(source);
+            }
+            source->Sync(tilemap, tilemapView.get<ECS::TransformComponent>(entity).position);
+            tilemaps.emplace(id, std::move(source));
+        }
+        for (auto& [id, source] : m_tilemapSources)
+        {
+            if (!tilemaps.contains(id))
+                m_baker.RemoveSource(source.get());
+        }
+        m_tilemapSources.swap(tilemaps);
+
+        std::unordered_map<const WorldStreaming::ChunkManager*, std::shared_ptr<Navigation::ChunkTileNavSource>> chunkWorlds;
+        auto chunkView = registry.view<ECS::ChunkWorldComponent>();
+        for (auto entity : chunkView)
+        {
+            const auto& world = chunkView.get<ECS::ChunkWorldComponent>(entity);
+            if (!world.Enable || !world.chunkManager)
+                continue;
+            auto it = m_chunkSources.find(world.chunkManager.get());
+            if (it != m_chunkSources.end())
+            {
+                chunkWorlds.emplace(it->first, it->second);
+                continue;
+            }
+            auto source = std::make_shared<Navigation::ChunkTileNavSource>(world.chunkManager,
+                                                                           Navigation::PixelMaterialTable());
+            m_baker.AddSource(source);
+            chunkWorlds.emplace(world.chunkManager.get(), std::move(source));
+        }
+        for (auto& [manager, source] : m_chunkSources)
+        {
+            if (!chunkWorlds.contains(manager))
+                m_baker.RemoveSource(source.get());
+        }
+        m_chunkSources.swap(chunkWorlds);
+
+        m_baker.Update(m_grid);
+    }
 }
@@ -4,6 +4,22 @@
 #include "../ISystem.h"
 #include "NavGrid.h"
 #include "Pathfinder.h"
+#include "HierarchicalPathfinder.h"
+#include "FlowField.h"
+#include "PathRequestQueue.h"
+#include "LocalAvoidance.h"
+#include "PathSmoother.h"
+#include "NavGridBaker.h"
+#include "NavBakeSources.h"
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace ECS
+{
+    struct NavAgentComponent;
+}
 
 namespace Systems
 {
@@ -17,8 +33,70 @@ namespace Systems
         void SetGrid(const Navigation::NavGrid& grid);
         Navigation::NavGrid& GetGrid();
 
+        /**
+         * @brief 开启后每帧从场景中带碰撞体的瓦片地图、流式区块世界以及额外登记的烘焙源增量烘焙网格。
+         *
+         * 网格的尺寸、格子大小与原点仍由 SetGrid 决定，烘焙只填写可走性与代价层。
+         */
+        void SetAutoBake(bool enabled);
+        bool IsAutoBakeEnabled() const { return m_autoBake; }
+
+        /**
+         * @brief 登记场景组件之外的烘焙源（例如 ChunkedPixelWorld），自动烘焙时一并采样。
+         */
+        void AddBakeSource(std::shared_ptr<Navigation::INavBakeSource> source);
+        void RemoveBakeSource(const Navigation::INavBakeSource* source);
+
     private:
+        /// 同一帧内请求同一目标格子的代理数达到该值时改用共享流场。
+        static constexpr int FlowFieldAgentThreshold = 16;
+        /// 每帧交付异步寻路结果的时间预算（毫秒）。
+        static constexpr double PathIntegrationBudgetMs = 1.0;
+
+        /**
+         * @brief 沿流场移动一步；到达目标或无路可走时返回 false。
+         */
+        bool FollowFlowField(ECS::NavAgentComponent& agent, ECS::Vector2f& position, float step) const;
+
+        /**
+         * @brief 按代理设置拉直并圆化 agent.path 中 from 之后的部分，from 及之前的路径点不变。
+         */
+        void SmoothPath(ECS::NavAgentComponent& agent, size_t from) const;
+
+        /**
+         * @brief 把本帧寻路移动换算为期望速度，经 ORCA 调整后重新移动参与避让的代理。
+         */
+        void ApplyAvoidance(RuntimeScene* scene, float deltaTime);
+
+        /**
+         * @brief 同步场景中的瓦片地图与区块世界烘焙源，并增量烘焙网格。
+         */
+        void BakeFromScene(RuntimeScene* scene);
+
+        /**
+         * @brief 取回后台构建完成的分层图，并按修改记录增量修复到当前网格。
+         */
+        void UpdateHierarchy();
+
+        /**
+         * @brief 丢弃分层图并在 JobSystem 上重新构建；完成前所有查询都走异步 A* 队列。
+         */
+        void RebuildHierarchy();
+
         Navigation::NavGrid m_grid;
+        Navigation::HierarchicalPathfinder m_hierarchy;
+        Navigation::HierarchyBuildTask m_hierarchyBuild;
+        Navigation::FlowFieldService m_flowFields;
+        Navigation::PathRequestQueue m_pathQueue;
+        Navigation::OrcaSolver m_avoidance;
+        std::vector<uint32_t> m_avoidanceEntities;               ///< 本帧参与避让的实体。
+        std::vector<Navigation::AvoidanceAgent> m_avoidanceAgents;  ///< position 为本帧移动前的位置。
+        std::vector<ECS::Vector2f> m_avoidanceVelocities;
+        bool m_autoBake = false;
+        Navigation::NavGridBaker m_baker;
+        std::unordered_map<uint32_t, std::shared_ptr<Navigation::TilemapNavSource>> m_tilemapSources;
+        std::unordered_map<const WorldStreaming::ChunkManager*, std::shared_ptr<Navigation::ChunkTileNavSource>>
+            m_chunkSources;
     };
 }
 
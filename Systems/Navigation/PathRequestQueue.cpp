@@ -0,0 +1,400 @@
+#include "PathRequestQueue.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+namespace Navigation
+{
+    namespace
+    {
+        static constexpr float SQRT2 = 1.41421356f;
+        /// 一次同步的修改数超过该值时直接清空缓存，比逐条检查更快。
+        static constexpr size_t MaxIncrementalChanges = 256;
+
+        inline float Distance(int ax, int ay, int bx, int by, bool diagonal)
+        {
+            const int dx = std::abs(ax - bx);
+            const int dy = std::abs(ay - by);
+            if (!diagonal) return static_cast<float>(dx + dy);
+            const int diag = std::min(dx, dy);
+            return static_cast<float>(dx + dy - 2 * diag) + SQRT2 * static_cast<float>(diag);
+        }
+
+        inline size_t HashCombine(size_t seed, size_t value)
+        {
+            return seed ^ (value + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2));
+        }
+
+        std::shared_ptr<const NavGrid> MakeSnapshot(const NavGrid& grid)
+        {
+            // 只复制寻路需要的数据，修改记录留在原网格上
+            auto snapshot = std::make_shared<NavGrid>();
+            snapshot->width = grid.width;
+            snapshot->height = grid.height;
+            snapshot->cellSize = grid.cellSize;
+            snapshot->origin = grid.origin;
+            snapshot->wordsPerRow = grid.wordsPerRow;
+            snapshot->walkableBits = grid.walkableBits;
+            snapshot->costs = grid.costs;
+            snapshot->revision = grid.revision;
+            return snapshot;
+        }
+    }
+
+    bool PathRequestQueue::PathKey::operator==(const PathKey& other) const
+    {
+        return sx == other.sx && sy == other.sy && ex == other.ex && ey == other.ey &&
+            allowDiagonal == other.allowDiagonal && mode == other.mode &&
+            bounds.minX == other.bounds.minX && bounds.minY == other.bounds.minY &&
+            bounds.maxX == other.bounds.maxX && bounds.maxY == other.bounds.maxY;
+    }
+
+    size_t PathRequestQueue::PathKeyHash::operator()(const PathKey& key) const
+    {
+        size_t seed = std::hash<int>{}(key.sx);
+        for (int value : {key.sy, key.ex, key.ey, key.bounds.minX, key.bounds.minY, key.bounds.maxX, key.bounds.maxY,
+                          static_cast<int>(key.allowDiagonal), static_cast<int>(key.mode)})
+        {
+            seed = HashCombine(seed, std::hash<int>{}(value));
+        }
+        return seed;
+    }
+
+    void PathRequestQueue::SolveJob::Execute()
+    {
+        result = Pathfinder::FindPath(*grid, request);
+    }
+
+    PathRequestQueue::PathRequestQueue(size_t cacheCapacity, int maxInFlight)
+        : m_cacheCapacity(cacheCapacity), m_maxInFlight(std::max(maxInFlight, 1))
+    {
+    }
+
+    PathRequestQueue::~PathRequestQueue()
+    {
+        WaitForInFlight();
+    }
+
+    PathRequestQueue::PathKey PathRequestQueue::MakeKey(const NavGrid& grid, const PathRequest& request) const
+    {
+        const auto [sx, sy] = grid.WorldToGrid(request.start);
+        const auto [ex, ey] = grid.WorldToGrid(request.end);
+        return {sx, sy, ex, ey, request.allowDiagonal, request.mode, request.bounds};
+    }
+
+    std::shared_ptr<const PathRequestQueue::SolvedPath> PathRequestQueue::MakeSolvedPath(
+        const NavGrid& grid, const PathKey& key, PathResult&& result) const
+    {
+        auto solved = std::make_shared<SolvedPath>();
+        SolvedPath& path = *solved;
+        path.box = {key.sx, key.sy, key.sx, key.sy};
+        path.cells.reserve(result.waypoints.size() + 1);
+        path.cells.push_back({key.sx, key.sy});
+        for (const auto& waypoint : result.waypoints)
+        {
+            const auto [x, y] = grid.WorldToGrid(waypoint);
+            path.cells.push_back({x, y});
+            path.box.minX = std::min(path.box.minX, x);
+            path.box.minY = std::min(path.box.minY, y);
+            path.box.maxX = std::max(path.box.maxX, x);
+            path.box.maxY = std::max(path.box.maxY, y);
+        }
+        path.result = std::move(result);
+        return solved;
+    }
+
+    bool PathRequestQueue::IsAffected(const PathKey& key, const SolvedPath& path, int x, int y, bool walkable,
+                                      bool weighted)
+    {
+        if (!key.bounds.IsEmpty() && !key.bounds.Contains(x, y)) return false;
+        const PathResult& result = path.result;
+        if (walkable)
+        {
+            // 新打开的格子只有在经过它的路径下界短于现有路径时才可能带来更短的路径
+            if (!result.found) return true;
+            const float lowerBound = Distance(key.sx, key.sy, x, y, key.allowDiagonal) +
+                Distance(x, y, key.ex, key.ey, key.allowDiagonal);
+            if (lowerBound < result.cost - 1e-4f) return true;
+            // 有代价层时可走格子的修改也可能是代价上升，按阻挡继续检查路径本身
+            if (!weighted) return false;
+        }
+
+        // 新阻挡的格子在路径上或紧邻对角移动时路径失效
+        if (!result.found) return false;
+        if (x < path.box.minX - 1 || x > path.box.maxX + 1 || y < path.box.minY - 1 || y > path.box.maxY + 1)
+            return false;
+        for (const auto& [cx, cy] : path.cells)
+        {
+            if (std::abs(cx - x) <= 1 && std::abs(cy - y) <= 1) return true;
+        }
+        return false;
+    }
+
+    bool PathRequestQueue::IsCurrent(const Waiter& waiter) const
+    {
+        auto it = m_tickets.find(waiter.requester);
+        return it != m_tickets.end() && it->second == waiter.ticket;
+    }
+
+    void PathRequestQueue::SyncRevision(const NavGrid& grid)
+    {
+        if (grid.width == m_width && grid.height == m_height && grid.revision == m_revision)
+            return;
+
+        // 缓存条目与尚未交付的结果都可能被修改影响：前者丢弃，后者重新排队
+        std::vector<uint8_t> staleReady(m_ready.size(), 0);
+        bool invalidateAll = grid.width != m_width || grid.height != m_height;
+        if (!invalidateAll)
+        {
+            size_t changes = 0;
+            const bool weighted = grid.HasCosts();
+            const bool tracked = grid.ForEachChangeSince(m_revision, [&](int x, int y)
+            {
+                if (++changes > MaxIncrementalChanges) return;
+                const bool walkable = grid.IsWalkable(x, y);
+                for (auto it = m_cache.begin(); it != m_cache.end();)
+                {
+                    if (IsAffected(it->key, *it->path, x, y, walkable, weighted))
+                    {
+                        m_cacheIndex.erase(it->key);
+                        it = m_cache.erase(it);
+                    }
+                    else
+                    {
+                        ++it;
+                    }
+                }
+                for (size_t i = 0; i < m_ready.size(); ++i)
+                {
+                    if (!staleReady[i] && IsAffected(m_ready[i].key, *m_ready[i].path, x, y, walkable, weighted))
+                        staleReady[i] = 1;
+                }
+            });
+            invalidateAll = !tracked || changes > MaxIncrementalChanges;
+        }
+        if (invalidateAll)
+        {
+            m_cache.clear();
+            m_cacheIndex.clear();
+            std::fill(staleReady.begin(), staleReady.end(), 1);
+        }
+
+        std::deque<Ready> ready;
+        for (size_t i = 0; i < m_ready.size(); ++i)
+        {
+            Ready& entry = m_ready[i];
+            if (!staleReady[i])
+            {
+                ready.push_back(std::move(entry));
+                continue;
+            }
+            if (!IsCurrent(entry.waiter)) continue;
+            ++m_stats.stale;
+            Solve solve;
+            solve.request = entry.request;
+            solve.priority = entry.priority;
+            solve.submitTick = m_tick;
+            solve.waiters.push_back(entry.waiter);
+            Enqueue(entry.key, std::move(solve));
+        }
+        m_ready = std::move(ready);
+
+        m_revision = grid.revision;
+        m_width = grid.width;
+        m_height = grid.height;
+    }
+
+    void PathRequestQueue::Submit(const NavGrid& grid, uint64_t requester, const PathRequest& request, int priority)
+    {
+        if (IsPending(requester))
+            ++m_stats.cancelled;
+        const uint64_t ticket = ++m_nextTicket;
+        m_tickets[requester] = ticket;
+        SyncRevision(grid);
+
+        const PathKey key = MakeKey(grid, request);
+        auto cached = m_cacheIndex.find(key);
+        if (cached != m_cacheIndex.end())
+        {
+            m_cache.splice(m_cache.begin(), m_cache, cached->second);
+            m_ready.push_back({{requester, ticket}, key, request, priority, cached->second->path});
+            ++m_stats.cacheHits;
+            return;
+        }
+
+        for (auto& flight : m_inFlight)
+        {
+            if (flight.key == key)
+            {
+                flight.solve.waiters.push_back({requester, ticket});
+                flight.solve.priority = std::max(flight.solve.priority, priority);
+                ++m_stats.coalesced;
+                return;
+            }
+        }
+
+        auto pending = m_pending.find(key);
+        if (pending != m_pending.end())
+        {
+            pending->second.waiters.push_back({requester, ticket});
+            pending->second.priority = std::max(pending->second.priority, priority);
+            ++m_stats.coalesced;
+            return;
+        }
+
+        Solve solve;
+        solve.request = request;
+        solve.priority = priority;
+        solve.submitTick = m_tick;
+        solve.waiters.push_back({requester, ticket});
+        m_pending.emplace(key, std::move(solve));
+    }
+
+    void PathRequestQueue::Cancel(uint64_t requester)
+    {
+        // 排队中的搜索在分发前检查请求编号，无需在这里查找
+        if (m_tickets.erase(requester) != 0)
+            ++m_stats.cancelled;
+    }
+
+    void PathRequestQueue::Enqueue(const PathKey& key, Solve&& solve)
+    {
+        auto pending = m_pending.find(key);
+        if (pending == m_pending.end())
+        {
+            m_pending.emplace(key, std::move(solve));
+            return;
+        }
+        Solve& existing = pending->second;
+        existing.priority = std::max(existing.priority, solve.priority);
+        existing.submitTick = std::min(existing.submitTick, solve.submitTick);
+        existing.waiters.insert(existing.waiters.end(), solve.waiters.begin(), solve.waiters.end());
+    }
+
+    void PathRequestQueue::Update(const NavGrid& grid)
+    {
+        SyncRevision(grid);
+        CollectCompleted(grid);
+        Dispatch(grid);
+        ++m_tick;
+    }
+
+    void PathRequestQueue::CollectCompleted(const NavGrid& grid)
+    {
+        for (size_t i = 0; i < m_inFlight.size();)
+        {
+            InFlight& flight = m_inFlight[i];
+            if (flight.handle.valid() &&
+                flight.handle.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+            {
+                ++i;
+                continue;
+            }
+            InFlight done = std::move(flight);
+            m_inFlight.erase(m_inFlight.begin() + static_cast<std::ptrdiff_t>(i));
+            ++m_stats.solved;
+
+            auto& waiters = done.solve.waiters;
+            waiters.erase(std::remove_if(waiters.begin(), waiters.end(),
+                                         [this](const Waiter& waiter) { return !IsCurrent(waiter); }),
+                          waiters.end());
+
+            // 搜索期间网格改变且影响到结果时重新排队
+            const NavGrid& solvedGrid = *done.job->grid;
+            auto path = MakeSolvedPath(grid, done.key, std::move(done.job->result));
+            bool stale = solvedGrid.width != grid.width || solvedGrid.height != grid.height;
+            if (!stale && solvedGrid.revision != grid.revision)
+            {
+                stale = !grid.ForEachChangeSince(solvedGrid.revision, [&](int x, int y)
+                {
+                    if (!stale && IsAffected(done.key, *path, x, y, grid.IsWalkable(x, y), grid.HasCosts()))
+                        stale = true;
+                }) || stale;
+            }
+            if (stale)
+            {
+                ++m_stats.stale;
+                if (!waiters.empty())
+                    Enqueue(done.key, std::move(done.solve));
+                continue;
+            }
+
+            if (m_cacheCapacity > 0 && m_cacheIndex.find(done.key) == m_cacheIndex.end())
+            {
+                m_cache.push_front({done.key, path});
+                m_cacheIndex[done.key] = m_cache.begin();
+                if (m_cache.size() > m_cacheCapacity)
+                {
+                    m_cacheIndex.erase(m_cache.back().key);
+                    m_cache.pop_back();
+                }
+            }
+            for (const Waiter& waiter : waiters)
+                m_ready.push_back({waiter, done.key, done.solve.request, done.solve.priority, path});
+        }
+    }
+
+    void PathRequestQueue::Dispatch(const NavGrid& grid)
+    {
+        while (static_cast<int>(m_inFlight.size()) < m_maxInFlight && !m_pending.empty())
+        {
+            auto best = m_pending.end();
+            int64_t bestScore = 0;
+            for (auto it = m_pending.begin(); it != m_pending.end(); ++it)
+            {
+                const int64_t score = it->second.priority +
+                    static_cast<int64_t>(AgingPerTick) * static_cast<int64_t>(m_tick - it->second.submitTick);
+                if (best == m_pending.end() || score > bestScore ||
+                    (score == bestScore && it->second.submitTick < best->second.submitTick))
+                {
+                    best = it;
+                    bestScore = score;
+                }
+            }
+
+            auto& waiters = best->second.waiters;
+            waiters.erase(std::remove_if(waiters.begin(), waiters.end(),
+                                         [this](const Waiter& waiter) { return !IsCurrent(waiter); }),
+                          waiters.end());
+            if (waiters.empty())
+            {
+                m_pending.erase(best);
+                continue;
+            }
+
+            if (!m_snapshot || m_snapshot->revision != grid.revision || m_snapshot->width != grid.width ||
+                m_snapshot->height != grid.height)
+            {
+                m_snapshot = MakeSnapshot(grid);
+            }
+
+            InFlight flight;
+            flight.key = best->first;
+            flight.solve = std::move(best->second);
+            flight.job = std::make_unique<SolveJob>();
+            flight.job->grid = m_snapshot;
+            flight.job->request = flight.solve.request;
+            m_pending.erase(best);
+            flight.handle = JobSystem::GetInstance().Schedule(flight.job.get());
+            m_inFlight.push_back(std::move(flight));
+        }
+    }
+
+    void PathRequestQueue::WaitForInFlight()
+    {
+        for (auto& flight : m_inFlight)
+            JobSystem::Complete(flight.handle);
+    }
+
+    void PathRequestQueue::Clear()
+    {
+        WaitForInFlight();
+        m_inFlight.clear();
+        m_pending.clear();
+        m_ready.clear();
+        m_tickets.clear();
+        m_cache.clear();
+        m_cacheIndex.clear();
+        m_snapshot.reset();
+    }
+}
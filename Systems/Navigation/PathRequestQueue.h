@@ -0,0 +1,212 @@
+#ifndef PATHREQUESTQUEUE_H
+#define PATHREQUESTQUEUE_H
+
+#include "NavGrid.h"
+#include "Pathfinder.h"
+#include "../../Event/JobSystem.h"
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace Navigation
+{
+    struct PathQueueStats
+    {
+        uint64_t solved = 0;      ///< 在工作线程上完成的搜索次数。
+        uint64_t cacheHits = 0;   ///< 直接由缓存应答的请求数。
+        uint64_t coalesced = 0;   ///< 与已有搜索合并的请求数。
+        uint64_t stale = 0;       ///< 因网格在搜索期间改变而重新排队的结果数。
+        uint64_t cancelled = 0;   ///< 被取消或被同一请求者的新请求取代的请求数。
+    };
+
+    /**
+     * @brief 异步寻路请求队列。
+     *
+     * 请求按优先级排队，每次 Update 最多把 maxInFlight 个搜索分发到 JobSystem，
+     * 搜索在网格快照上进行，不会与主线程的网格修改竞争。等待越久的请求等效优先级越高，低优先级请求不会饿死。
+     * 同一请求者的新请求取代旧请求；起终点格子相同的请求合并为一次搜索；
+     * 最近的结果保存在 LRU 缓存中，网格修改时只丢弃可能受影响的条目。
+     * 完成的结果由 Integrate 在时间预算内交给调用方。除工作线程上的搜索外，所有接口都应在同一线程调用。
+     */
+    class PathRequestQueue
+    {
+    public:
+        static constexpr size_t DefaultCacheCapacity = 512;
+        static constexpr int DefaultMaxInFlight = 4;
+        /// 请求每等待一次 Update，等效优先级增加的量。
+        static constexpr int AgingPerTick = 1;
+
+        explicit PathRequestQueue(size_t cacheCapacity = DefaultCacheCapacity, int maxInFlight = DefaultMaxInFlight);
+        ~PathRequestQueue();
+
+        PathRequestQueue(const PathRequestQueue&) = delete;
+        PathRequestQueue& operator=(const PathRequestQueue&) = delete;
+
+        /**
+         * @brief 提交请求，取代该请求者尚未交付的旧请求。优先级越大越先处理。
+         */
+        void Submit(const NavGrid& grid, uint64_t requester, const PathRequest& request, int priority = 0);
+
+        /**
+         * @brief 取消请求者尚未交付的请求；已在工作线程上的搜索照常完成，但结果被丢弃。
+         */
+        void Cancel(uint64_t requester);
+
+        bool IsPending(uint64_t requester) const { return m_tickets.count(requester) != 0; }
+
+        /**
+         * @brief 处理网格修改、回收完成的搜索并分发新的搜索。每帧调用一次。
+         */
+        void Update(const NavGrid& grid);
+
+        /**
+         * @brief 按完成顺序交付结果，直到用完 budgetMs；每次至少交付一个。
+         * @param fn 以 (requester, const PathResult&) 调用。
+         * @return 交付的结果数。
+         */
+        template <typename Fn>
+        size_t Integrate(double budgetMs, Fn&& fn)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            size_t count = 0;
+            while (!m_ready.empty())
+            {
+                if (count > 0 &&
+                    std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() >=
+                    budgetMs)
+                    break;
+                Ready ready = std::move(m_ready.front());
+                m_ready.pop_front();
+                auto it = m_tickets.find(ready.waiter.requester);
+                if (it == m_tickets.end() || it->second != ready.waiter.ticket) continue;
+                m_tickets.erase(it);
+                fn(ready.waiter.requester, ready.path->result);
+                ++count;
+            }
+            return count;
+        }
+
+        /**
+         * @brief 阻塞等待所有已分发的搜索完成。
+         */
+        void WaitForInFlight();
+
+        void Clear();
+
+        const PathQueueStats& GetStats() const { return m_stats; }
+        size_t GetPendingCount() const { return m_pending.size(); }
+        size_t GetInFlightCount() const { return m_inFlight.size(); }
+        size_t GetReadyCount() const { return m_ready.size(); }
+        size_t GetCacheSize() const { return m_cache.size(); }
+
+    private:
+        struct PathKey
+        {
+            int sx, sy, ex, ey;
+            bool allowDiagonal;
+            PathSearchMode mode;
+            NavRect bounds;
+
+            bool operator==(const PathKey& other) const;
+        };
+
+        struct PathKeyHash
+        {
+            size_t operator()(const PathKey& key) const;
+        };
+
+        struct Waiter
+        {
+            uint64_t requester;
+            uint64_t ticket;
+        };
+
+        struct Solve
+        {
+            PathRequest request;
+            int priority = 0;
+            uint64_t submitTick = 0;
+            std::vector<Waiter> waiters;
+        };
+
+        struct SolveJob : public IJob
+        {
+            std::shared_ptr<const NavGrid> grid;
+            PathRequest request;
+            PathResult result;
+
+            void Execute() override;
+        };
+
+        struct InFlight
+        {
+            PathKey key;
+            Solve solve;
+            std::unique_ptr<SolveJob> job;
+            JobHandle handle;
+        };
+
+        /// 路径及其经过的格子，用于判断网格修改是否影响它。
+        struct SolvedPath
+        {
+            PathResult result;
+            std::vector<std::pair<int, int>> cells;
+            NavRect box;
+        };
+
+        struct CacheEntry
+        {
+            PathKey key;
+            std::shared_ptr<const SolvedPath> path;
+        };
+
+        /// 已完成但尚未交付的结果；交付前网格改变且影响到它时重新排队。
+        struct Ready
+        {
+            Waiter waiter;
+            PathKey key;
+            PathRequest request;
+            int priority;
+            std::shared_ptr<const SolvedPath> path;
+        };
+
+        PathKey MakeKey(const NavGrid& grid, const PathRequest& request) const;
+        std::shared_ptr<const SolvedPath> MakeSolvedPath(const NavGrid& grid, const PathKey& key,
+                                                         PathResult&& result) const;
+
+        /**
+         * @brief 格子 (x, y) 变为 walkable 状态（weighted 时也可能是代价改变）后，该路径是否可能不再可走或不再最短。
+         */
+        static bool IsAffected(const PathKey& key, const SolvedPath& path, int x, int y, bool walkable, bool weighted);
+
+        void SyncRevision(const NavGrid& grid);
+        void CollectCompleted(const NavGrid& grid);
+        void Dispatch(const NavGrid& grid);
+        void Enqueue(const PathKey& key, Solve&& solve);
+        bool IsCurrent(const Waiter& waiter) const;
+
+        size_t m_cacheCapacity;
+        int m_maxInFlight;
+        uint64_t m_tick = 0;
+        uint64_t m_nextTicket = 0;
+        uint64_t m_revision = 0;
+        int m_width = 0;
+        int m_height = 0;
+
+        std::unordered_map<uint64_t, uint64_t> m_tickets;  ///< 请求者 -> 当前有效的请求编号。
+        std::unordered_map<PathKey, Solve, PathKeyHash> m_pending;
+        std::vector<InFlight> m_inFlight;
+        std::deque<Ready> m_ready;
+        std::list<CacheEntry> m_cache;  ///< 头部为最近使用。
+        std::unordered_map<PathKey, std::list<CacheEntry>::iterator, PathKeyHash> m_cacheIndex;
+        std::shared_ptr<const NavGrid> m_snapshot;
+        PathQueueStats m_stats;
+    };
+}
+
+#endif
@@ -0,0 +1,221 @@
+#include "PathSmoother.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+
+namespace Navigation
+{
+    namespace
+    {
+        static constexpr float Pi = 3.14159265f;
+        /// 圆弧每段最多转过的角度。
+        static constexpr float ArcStepAngle = Pi / 8.0f;
+        static constexpr int MaxArcSegments = 8;
+
+        int64_t FloorDiv(int64_t a, int64_t b)
+        {
+            const int64_t q = a / b;
+            return (a % b != 0 && (a < 0) != (b < 0)) ? q - 1 : q;
+        }
+
+        /// 两段路径方向相同（共线同向）。
+        bool SameDirection(ECS::Vector2f a, ECS::Vector2f b, ECS::Vector2f c)
+        {
+            const float ux = b.x - a.x, uy = b.y - a.y;
+            const float vx = c.x - b.x, vy = c.y - b.y;
+            const float cross = ux * vy - uy * vx;
+            const float scale = std::max(std::abs(ux) + std::abs(uy), 1e-6f) * std::max(std::abs(vx) + std::abs(vy), 1e-6f);
+            return std::abs(cross) <= 1e-5f * scale && ux * vx + uy * vy > 0.0f;
+        }
+    }
+
+    bool PathSmoother::IsCellCenter(const NavGrid& grid, ECS::Vector2f point, int& x, int& y)
+    {
+        x = static_cast<int>(std::floor((point.x - grid.origin.x) / grid.cellSize));
+        y = static_cast<int>(std::floor((point.y - grid.origin.y) / grid.cellSize));
+        const ECS::Vector2f center = grid.GridToWorld(x, y);
+        const float tolerance = grid.cellSize * 1e-4f;
+        return std::abs(center.x - point.x) <= tolerance && std::abs(center.y - point.y) <= tolerance;
+    }
+
+    bool PathSmoother::HasLineOfSight(const NavGrid& grid, int x0, int y0, int x1, int y1)
+    {
+        if (y0 == y1) return grid.IsRowSpanWalkable(y0, x0, x1);
+        if (y0 > y1)
+        {
+            std::swap(x0, x1);
+            std::swap(y0, y1);
+        }
+
+        // 坐标放大两倍后格子中心为整数。线段在第 y 行内的 x 范围是 [xa, xb]，逐行按 64 位字检查该范围；
+        // xa 或 xb 恰为整数说明线段穿过格子角点，范围向外扩一格，与对角移动规则一致地要求两侧格子可走
+        const int64_t cx0 = 2 * static_cast<int64_t>(x0) + 1;
+        const int64_t cy0 = 2 * static_cast<int64_t>(y0) + 1;
+        const int64_t cy1 = 2 * static_cast<int64_t>(y1) + 1;
+        const int64_t dx = 2 * static_cast<int64_t>(x1 - x0);
+        const int64_t dy = cy1 - cy0;
+        const int64_t denominator = 2 * dy;
+        for (int y = y0; y <= y1; ++y)
+        {
+            const int64_t low = std::max<int64_t>(2 * static_cast<int64_t>(y), cy0);
+            const int64_t high = std::min<int64_t>(2 * static_cast<int64_t>(y) + 2, cy1);
+            // 格子坐标 x = numerator / denominator
+            const int64_t a = cx0 * dy + (low - cy0) * dx;
+            const int64_t b = cx0 * dy + (high - cy0) * dx;
+            const int64_t lo = std::min(a, b);
+            const int64_t hi = std::max(a, b);
+            const int64_t first = FloorDiv(lo, denominator) - (lo % denominator == 0 ? 1 : 0);
+            const int64_t last = FloorDiv(hi, denominator);
+            if (first < 0 || last >= grid.width) return false;
+            if (!grid.IsRowSpanWalkable(y, static_cast<int>(first), static_cast<int>(last))) return false;
+        }
+        return true;
+    }
+
+    bool PathSmoother::IsSegmentClear(const NavGrid& grid, ECS::Vector2f from, ECS::Vector2f to)
+    {
+        int x0, y0, x1, y1;
+        const bool fromCenter = IsCellCenter(grid, from, x0, y0);
+        const bool toCenter = IsCellCenter(grid, to, x1, y1);
+        if (fromCenter && toCenter)
+            return HasLineOfSight(grid, x0, y0, x1, y1);
+
+        if (!grid.IsWalkable(x0, y0)) return false;
+
+        const float fx0 = (from.x - grid.origin.x) / grid.cellSize;
+        const float fy0 = (from.y - grid.origin.y) / grid.cellSize;
+        const float dx = (to.x - from.x) / grid.cellSize;
+        const float dy = (to.y - from.y) / grid.cellSize;
+        const int sx = dx > 0.0f ? 1 : (dx < 0.0f ? -1 : 0);
+        const int sy = dy > 0.0f ? 1 : (dy < 0.0f ? -1 : 0);
+        constexpr float Infinity = std::numeric_limits<float>::infinity();
+        const float tDeltaX = sx != 0 ? 1.0f / std::abs(dx) : Infinity;
+        const float tDeltaY = sy != 0 ? 1.0f / std::abs(dy) : Infinity;
+        float tMaxX = sx > 0 ? (x0 + 1 - fx0) / dx : (sx < 0 ? (fx0 - x0) / -dx : Infinity);
+        float tMaxY = sy > 0 ? (y0 + 1 - fy0) / dy : (sy < 0 ? (fy0 - y0) / -dy : Infinity);
+
+        // 逐个穿过格子边界（DDA），与 HasLineOfSight 相同地处理角点；步数上限防止浮点误差导致越过终点
+        int x = x0;
+        int y = y0;
+        const int maxSteps = std::abs(x1 - x0) + std::abs(y1 - y0) + 2;
+        for (int step = 0; step < maxSteps && (x != x1 || y != y1); ++step)
+        {
+            const float tMin = std::min(tMaxX, tMaxY);
+            if (tMin > 1.0f) break;
+            if (std::abs(tMaxX - tMaxY) <= 1e-6f)
+            {
+                if (!grid.IsWalkable(x + sx, y) || !grid.IsWalkable(x, y + sy)) return false;
+                x += sx;
+                y += sy;
+                tMaxX += tDeltaX;
+                tMaxY += tDeltaY;
+            }
+            else if (tMaxX < tMaxY)
+            {
+                x += sx;
+                tMaxX += tDeltaX;
+            }
+            else
+            {
+                y += sy;
+                tMaxY += tDeltaY;
+            }
+            if (!grid.IsWalkable(x, y)) return false;
+        }
+        return grid.IsWalkable(x1, y1);
+    }
+
+    size_t PathSmoother::Simplify(const NavGrid& grid, std::vector<ECS::Vector2f>& waypoints, size_t from)
+    {
+        const size_t count = waypoints.size();
+        if (count < from + 3) return 0;
+
+        // 先去掉同一直线上的中间点，视线检查只在拐点上进行
+        size_t write = from + 1;
+        for (size_t i = from + 1; i + 1 < count; ++i)
+        {
+            if (!SameDirection(waypoints[write - 1], waypoints[i], waypoints[i + 1]))
+                waypoints[write++] = waypoints[i];
+        }
+        waypoints[write++] = waypoints[count - 1];
+        waypoints.resize(write);
+
+        // 贪心拉直：锚点能直接看到的最远拐点之前的点都可以删除
+        size_t anchor = from;
+        write = from + 1;
+        for (size_t i = from + 2; i < waypoints.size(); ++i)
+        {
+            if (!IsSegmentClear(grid, waypoints[anchor], waypoints[i]))
+            {
+                waypoints[write] = waypoints[i - 1];
+                anchor = write++;
+            }
+        }
+        waypoints[write++] = waypoints.back();
+        waypoints.resize(write);
+        return count - write;
+    }
+
+    size_t PathSmoother::RoundCorners(const NavGrid& grid, std::vector<ECS::Vector2f>& waypoints, float radius,
+                                      size_t from)
+    {
+        const size_t count = waypoints.size();
+        if (radius <= 0.0f || count < from + 3) return 0;
+
+        std::vector<ECS::Vector2f> rounded(waypoints.begin(), waypoints.begin() + static_cast<std::ptrdiff_t>(from + 1));
+        std::vector<ECS::Vector2f> arc;
+        size_t corners = 0;
+        for (size_t i = from + 1; i + 1 < count; ++i)
+        {
+            const ECS::Vector2f a = waypoints[i - 1];
+            const ECS::Vector2f p = waypoints[i];
+            const ECS::Vector2f b = waypoints[i + 1];
+            const float inX = p.x - a.x, inY = p.y - a.y;
+            const float outX = b.x - p.x, outY = b.y - p.y;
+            const float inLength = std::sqrt(inX * inX + inY * inY);
+            const float outLength = std::sqrt(outX * outX + outY * outY);
+            if (inLength <= 1e-6f || outLength <= 1e-6f || SameDirection(a, p, b))
+            {
+                rounded.push_back(p);
+                continue;
+            }
+
+            // 切入切出距离不超过相邻路段的一半，相邻拐点的圆弧不会重叠
+            const float d = std::min({radius, inLength * 0.5f, outLength * 0.5f});
+            const ECS::Vector2f entry(p.x - inX / inLength * d, p.y - inY / inLength * d);
+            const ECS::Vector2f exit(p.x + outX / outLength * d, p.y + outY / outLength * d);
+            const float cosTurn = std::clamp((inX * outX + inY * outY) / (inLength * outLength), -1.0f, 1.0f);
+            const int segments = std::clamp(static_cast<int>(std::ceil(std::acos(cosTurn) / ArcStepAngle)), 2,
+                                            MaxArcSegments);
+
+            // 二次贝塞尔曲线位于三角形 entry-p-exit 内，但三角形可能盖住不可走格子，逐段检查弦
+            arc.clear();
+            arc.push_back(entry);
+            bool clear = true;
+            for (int k = 1; k <= segments && clear; ++k)
+            {
+                const float t = static_cast<float>(k) / static_cast<float>(segments);
+                const float u = 1.0f - t;
+                const ECS::Vector2f point(u * u * entry.x + 2.0f * u * t * p.x + t * t * exit.x,
+                                          u * u * entry.y + 2.0f * u * t * p.y + t * t * exit.y);
+                clear = IsSegmentClear(grid, arc.back(), point);
+                arc.push_back(point);
+            }
+
+            if (clear)
+            {
+                rounded.insert(rounded.end(), arc.begin(), arc.end());
+                ++corners;
+            }
+            else
+            {
+                rounded.push_back(p);
+            }
+        }
+        rounded.push_back(waypoints[count - 1]);
+        waypoints.swap(rounded);
+        return corners;
+    }
+}
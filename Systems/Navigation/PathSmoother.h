@@ -0,0 +1,54 @@
+#ifndef PATHSMOOTHER_H
+#define PATHSMOOTHER_H
+
+#include "NavGrid.h"
+#include "../../Components/Core.h"
+#include <cstddef>
+#include <vector>
+
+namespace Navigation
+{
+    /**
+     * @brief 路径平滑：视线拉直与拐角圆化。
+     *
+     * 视线判断与寻路的移动规则一致：线段经过的每个格子都必须可走，恰好穿过格子角点时两侧格子也必须可走，
+     * 因此平滑后的路径不会切过不可走格子的角。
+     */
+    class PathSmoother
+    {
+    public:
+        /**
+         * @brief 两个格子中心之间是否有视线。逐行求出线段覆盖的格子区间（整数运算），按 64 位字一次检查整段。
+         */
+        static bool HasLineOfSight(const NavGrid& grid, int x0, int y0, int x1, int y1);
+
+        /**
+         * @brief 任意两个世界坐标之间的线段是否只经过可走格子。
+         *
+         * 两端都是格子中心时等价于 HasLineOfSight，否则按格子边界逐格遍历（DDA）。
+         */
+        static bool IsSegmentClear(const NavGrid& grid, ECS::Vector2f from, ECS::Vector2f to);
+
+        /**
+         * @brief 拉直路径：从 waypoints[from] 开始，删除可以被视线跳过的路径点。
+         *
+         * from 及之前的点保持不变，终点总是保留。
+         * @return 删除的路径点数。
+         */
+        static size_t Simplify(const NavGrid& grid, std::vector<ECS::Vector2f>& waypoints, size_t from = 0);
+
+        /**
+         * @brief 把 waypoints[from] 之后的拐点替换为二次贝塞尔圆弧。
+         *
+         * 圆弧从拐点两侧各 radius（不超过相邻路段长度的一半）处切入切出，经过不可走格子的拐点保持原样。
+         * @return 被圆化的拐点数。
+         */
+        static size_t RoundCorners(const NavGrid& grid, std::vector<ECS::Vector2f>& waypoints, float radius,
+                                   size_t from = 0);
+
+    private:
+        static bool IsCellCenter(const NavGrid& grid, ECS::Vector2f point, int& x, int& y);
+    };
+}
+
+#endif
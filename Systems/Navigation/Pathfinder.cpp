@@ -1,130 +1,293 @@
 #include "Pathfinder.h"
-#include <queue>
-#include <unordered_map>
 #include <cmath>
 #include <algorithm>
+#include <cstdlib>
 
 namespace Navigation
 {
     namespace
     {
-        struct Node
-        {
-            int x, y;
-            float g, f;
-        };
-
-        struct NodeCmp
-        {
-            bool operator()(const Node& a, const Node& b) const { return a.f > b.f; }
-        };
-
-        inline int PackKey(int x, int y) { return y * 0x10000 + x; }
-
-        inline float Heuristic(int ax, int ay, int bx, int by)
-        {
-            float dx = static_cast<float>(ax - bx);
-            float dy = static_cast<float>(ay - by);
-            return std::sqrt(dx * dx + dy * dy);
-        }
-
         static constexpr int DX8[] = {-1, 0, 1, 0, -1, -1, 1, 1};
         static constexpr int DY8[] = {0, -1, 0, 1, -1, 1, -1, 1};
         static constexpr int DX4[] = {-1, 0, 1, 0};
         static constexpr int DY4[] = {0, -1, 0, 1};
         static constexpr float SQRT2 = 1.41421356f;
-    }
 
-    PathResult Pathfinder::FindPath(const NavGrid& grid, const PathRequest& request)
-    {
-        PathResult result;
-        auto [sx, sy] = grid.WorldToGrid(request.start);
-        auto [ex, ey] = grid.WorldToGrid(request.end);
+        inline int Sign(int v) { return (v > 0) - (v < 0); }
 
-        if (!grid.InBounds(sx, sy) || !grid.InBounds(ex, ey))
-            return result;
-        if (!grid.IsWalkable(sx, sy) || !grid.IsWalkable(ex, ey))
-            return result;
-
-        if (sx == ex && sy == ey)
+        /// 八方向用八方向距离，四方向用曼哈顿距离，二者都与移动代价一致。
+        inline float Heuristic(int ax, int ay, int bx, int by, bool diagonal)
         {
-            result.found = true;
-            result.waypoints.push_back(grid.GridToWorld(ex, ey));
-            return result;
+            const int dx = std::abs(ax - bx);
+            const int dy = std::abs(ay - by);
+            if (!diagonal) return static_cast<float>(dx + dy);
+            const int diag = std::min(dx, dy);
+            return static_cast<float>(dx + dy - 2 * diag) + SQRT2 * static_cast<float>(diag);
         }
 
-        const int dirCount = request.allowDiagonal ? 8 : 4;
-        const int* dx = request.allowDiagonal ? DX8 : DX4;
-        const int* dy = request.allowDiagonal ? DY8 : DY4;
-
-        std::priority_queue<Node, std::vector<Node>, NodeCmp> open;
-        std::unordered_map<int, float> gScore;
-        std::unordered_map<int, int> cameFrom;
-
-        int startKey = PackKey(sx, sy);
-        int endKey = PackKey(ex, ey);
-
-        gScore[startKey] = 0.0f;
-        open.push({sx, sy, 0.0f, Heuristic(sx, sy, ex, ey)});
-
-        bool pathFound = false;
-
-        while (!open.empty())
+        class GridSearch
         {
-            Node cur = open.top();
-            open.pop();
-
-            int curKey = PackKey(cur.x, cur.y);
-            if (curKey == endKey)
+        public:
+            GridSearch(const NavGrid& grid, const NavRect& rect, SearchContext& context, int ex, int ey, bool diagonal)
+                : m_grid(grid), m_rect(rect), m_context(context), m_ex(ex), m_ey(ey), m_diagonal(diagonal)
             {
-                pathFound = true;
-                break;
+                m_context.Begin(static_cast<size_t>(rect.Width()) * static_cast<size_t>(rect.Height()));
             }
 
-            if (cur.g > gScore[curKey])
-                continue;
+            bool Walkable(int x, int y) const { return m_rect.Contains(x, y) && m_grid.IsWalkable(x, y); }
+            int32_t Index(int x, int y) const { return (y - m_rect.minY) * m_rect.Width() + (x - m_rect.minX); }
+            int CellX(int32_t cell) const { return m_rect.minX + cell % m_rect.Width(); }
+            int CellY(int32_t cell) const { return m_rect.minY + cell / m_rect.Width(); }
+
+            void Open(int x, int y, float g, int32_t parent)
+            {
+                m_context.Relax(Index(x, y), g, Heuristic(x, y, m_ex, m_ey, m_diagonal), parent);
+            }
 
-            for (int d = 0; d < dirCount; ++d)
+            bool RunAStar(int sx, int sy, int& expanded)
             {
-                int nx = cur.x + dx[d];
-                int ny = cur.y + dy[d];
+                const int dirCount = m_diagonal ? 8 : 4;
+                const int* dx = m_diagonal ? DX8 : DX4;
+                const int* dy = m_diagonal ? DY8 : DY4;
+                const int32_t endIndex = Index(m_ex, m_ey);
+                Open(sx, sy, 0.0f, SearchContext::NoParent);
+                while (!m_context.OpenEmpty())
+                {
+                    const int32_t cur = m_context.PopMin();
+                    ++expanded;
+                    if (cur == endIndex) return true;
+                    const int cx = CellX(cur);
+                    const int cy = CellY(cur);
+                    const float g = m_context.G(cur);
+                    for (int d = 0; d < dirCount; ++d)
+                    {
+                        const int nx = cx + dx[d];
+                        const int ny = cy + dy[d];
+                        if (!Walkable(nx, ny)) continue;
+                        if (d >= 4 && (!Walkable(cx + dx[d], cy) || !Walkable(cx, cy + dy[d]))) continue;
+                        Open(nx, ny, g + ((d >= 4) ? SQRT2 : 1.0f) * m_grid.GetCost(nx, ny), cur);
+                    }
+                }
+                return false;
+            }
 
-                if (!grid.IsWalkable(nx, ny))
-                    continue;
+            /**
+             * @brief 跳点搜索。对角移动要求两侧正交格都可走（与 A* 的规则一致）。
+             */
+            bool RunJumpPoint(int sx, int sy, int& expanded)
+            {
+                const int32_t endIndex = Index(m_ex, m_ey);
+                Open(sx, sy, 0.0f, SearchContext::NoParent);
+                while (!m_context.OpenEmpty())
+                {
+                    const int32_t cur = m_context.PopMin();
+                    ++expanded;
+                    if (cur == endIndex) return true;
+                    const int cx = CellX(cur);
+                    const int cy = CellY(cur);
+                    int neighborX[8];
+                    int neighborY[8];
+                    const int count = PrunedNeighbors(cur, cx, cy, neighborX, neighborY);
+                    for (int i = 0; i < count; ++i)
+                    {
+                        const int ddx = neighborX[i] - cx;
+                        const int ddy = neighborY[i] - cy;
+                        int jx, jy;
+                        const bool hit = (ddx != 0 && ddy != 0)
+                                             ? JumpDiagonal(neighborX[i], neighborY[i], ddx, ddy, jx, jy)
+                                             : JumpStraight(neighborX[i], neighborY[i], ddx, ddy, jx, jy);
+                        if (!hit) continue;
+                        const int32_t jump = Index(jx, jy);
+                        if (m_context.IsClosed(jump)) continue;
+                        Open(jx, jy, m_context.G(cur) + Heuristic(cx, cy, jx, jy, true), cur);
+                    }
+                }
+                return false;
+            }
 
-                if (d >= 4)
+        private:
+            int PrunedNeighbors(int32_t cur, int x, int y, int* outX, int* outY) const
+            {
+                int count = 0;
+                auto push = [&](int nx, int ny)
                 {
-                    if (!grid.IsWalkable(cur.x + dx[d], cur.y) ||
-                        !grid.IsWalkable(cur.x, cur.y + dy[d]))
-                        continue;
+                    outX[count] = nx;
+                    outY[count] = ny;
+                    ++count;
+                };
+                const int32_t parent = m_context.Parent(cur);
+                if (parent == SearchContext::NoParent)
+                {
+                    for (int d = 0; d < 8; ++d)
+                    {
+                        const int nx = x + DX8[d];
+                        const int ny = y + DY8[d];
+                        if (!Walkable(nx, ny)) continue;
+                        if (d >= 4 && (!Walkable(x + DX8[d], y) || !Walkable(x, y + DY8[d]))) continue;
+                        push(nx, ny);
+                    }
+                    return count;
+                }
+                const int dx = Sign(x - CellX(parent));
+                const int dy = Sign(y - CellY(parent));
+                if (dx != 0 && dy != 0)
+                {
+                    const bool vertical = Walkable(x, y + dy);
+                    const bool horizontal = Walkable(x + dx, y);
+                    if (vertical) push(x, y + dy);
+                    if (horizontal) push(x + dx, y);
+                    if (vertical && horizontal && Walkable(x + dx, y + dy)) push(x + dx, y + dy);
                 }
+                else if (dx != 0)
+                {
+                    const bool next = Walkable(x + dx, y);
+                    const bool up = Walkable(x, y + 1);
+                    const bool down = Walkable(x, y - 1);
+                    if (next)
+                    {
+                        push(x + dx, y);
+                        if (up && Walkable(x + dx, y + 1)) push(x + dx, y + 1);
+                        if (down && Walkable(x + dx, y - 1)) push(x + dx, y - 1);
+                    }
+                    if (up) push(x, y + 1);
+                    if (down) push(x, y - 1);
+                }
+                else
+                {
+                    const bool next = Walkable(x, y + dy);
+                    const bool right = Walkable(x + 1, y);
+                    const bool left = Walkable(x - 1, y);
+                    if (next)
+                    {
+                        push(x, y + dy);
+                        if (right && Walkable(x + 1, y + dy)) push(x + 1, y + dy);
+                        if (left && Walkable(x - 1, y + dy)) push(x - 1, y + dy);
+                    }
+                    if (right) push(x + 1, y);
+                    if (left) push(x - 1, y);
+                }
+                return count;
+            }
 
-                float moveCost = (d >= 4) ? SQRT2 : 1.0f;
-                float ng = cur.g + moveCost;
-                int nKey = PackKey(nx, ny);
+            /// 沿水平或竖直方向跳跃，遇到目标或强制邻居时停下。
+            bool JumpStraight(int x, int y, int dx, int dy, int& outX, int& outY) const
+            {
+                while (Walkable(x, y))
+                {
+                    if (x == m_ex && y == m_ey)
+                    {
+                        outX = x;
+                        outY = y;
+                        return true;
+                    }
+                    const bool forced = (dx != 0)
+                                            ? ((Walkable(x, y - 1) && !Walkable(x - dx, y - 1)) ||
+                                               (Walkable(x, y + 1) && !Walkable(x - dx, y + 1)))
+                                            : ((Walkable(x - 1, y) && !Walkable(x - 1, y - dy)) ||
+                                               (Walkable(x + 1, y) && !Walkable(x + 1, y - dy)));
+                    if (forced)
+                    {
+                        outX = x;
+                        outY = y;
+                        return true;
+                    }
+                    x += dx;
+                    y += dy;
+                }
+                return false;
+            }
 
-                auto it = gScore.find(nKey);
-                if (it == gScore.end() || ng < it->second)
+            /// 沿对角方向跳跃，任一正交分量能跳到跳点时停下。
+            bool JumpDiagonal(int x, int y, int dx, int dy, int& outX, int& outY) const
+            {
+                while (Walkable(x, y))
                 {
-                    gScore[nKey] = ng;
-                    cameFrom[nKey] = curKey;
-                    open.push({nx, ny, ng, ng + Heuristic(nx, ny, ex, ey)});
+                    int jx, jy;
+                    if ((x == m_ex && y == m_ey) ||
+                        JumpStraight(x + dx, y, dx, 0, jx, jy) ||
+                        JumpStraight(x, y + dy, 0, dy, jx, jy))
+                    {
+                        outX = x;
+                        outY = y;
+                        return true;
+                    }
+                    if (!Walkable(x + dx, y) || !Walkable(x, y + dy)) return false;
+                    x += dx;
+                    y += dy;
                 }
+                return false;
             }
+
+            const NavGrid& m_grid;
+            NavRect m_rect;
+            SearchContext& m_context;
+            int m_ex;
+            int m_ey;
+            bool m_diagonal;
+        };
+    }
+
+    PathResult Pathfinder::FindPath(const NavGrid& grid, const PathRequest& request)
+    {
+        return FindPath(grid, request, SearchContext::ForCurrentThread());
+    }
+
+    PathResult Pathfinder::FindPath(const NavGrid& grid, const PathRequest& request, SearchContext& context)
+    {
+        PathResult result;
+        auto [sx, sy] = grid.WorldToGrid(request.start);
+        auto [ex, ey] = grid.WorldToGrid(request.end);
+
+        NavRect rect{0, 0, grid.width - 1, grid.height - 1};
+        if (!request.bounds.IsEmpty())
+        {
+            rect.minX = std::max(rect.minX, request.bounds.minX);
+            rect.minY = std::max(rect.minY, request.bounds.minY);
+            rect.maxX = std::min(rect.maxX, request.bounds.maxX);
+            rect.maxY = std::min(rect.maxY, request.bounds.maxY);
+        }
+
+        if (!rect.Contains(sx, sy) || !rect.Contains(ex, ey))
+            return result;
+        if (!grid.IsWalkable(sx, sy) || !grid.IsWalkable(ex, ey))
+            return result;
+
+        if (sx == ex && sy == ey)
+        {
+            result.found = true;
+            result.waypoints.push_back(grid.GridToWorld(ex, ey));
+            return result;
         }
 
+        // 跳点搜索依赖等代价假设，存在代价层时退回 A*
+        const bool jumpPoint = request.allowDiagonal && request.mode != PathSearchMode::AStar && !grid.HasCosts();
+        GridSearch search(grid, rect, context, ex, ey, request.allowDiagonal);
+        const bool pathFound = jumpPoint ? search.RunJumpPoint(sx, sy, result.expandedNodes)
+                                         : search.RunAStar(sx, sy, result.expandedNodes);
         if (!pathFound)
             return result;
 
         result.found = true;
+        const int32_t endIndex = search.Index(ex, ey);
+        result.cost = context.G(endIndex);
+
+        // 跳点之间是直线或纯对角线段，逐格展开后与 A* 的输出格式一致
         std::vector<std::pair<int, int>> gridPath;
-        int traceKey = endKey;
-        while (traceKey != startKey)
+        for (int32_t cell = endIndex; context.Parent(cell) != SearchContext::NoParent; cell = context.Parent(cell))
         {
-            int ty = traceKey / 0x10000;
-            int tx = traceKey - ty * 0x10000;
-            gridPath.push_back({tx, ty});
-            traceKey = cameFrom[traceKey];
+            const int32_t parent = context.Parent(cell);
+            int x = search.CellX(cell);
+            int y = search.CellY(cell);
+            const int px = search.CellX(parent);
+            const int py = search.CellY(parent);
+            const int stepX = Sign(px - x);
+            const int stepY = Sign(py - y);
+            while (x != px || y != py)
+            {
+                gridPath.push_back({x, y});
+                x += stepX;
+                y += stepY;
+            }
         }
         std::reverse(gridPath.begin(), gridPath.end());
 
@@ -2,28 +2,48 @@
 #define PATHFINDER_H
 
 #include "NavGrid.h"
+#include "SearchContext.h"
 #include "../../Components/Core.h"
 #include <vector>
 
 namespace Navigation
 {
+    enum class PathSearchMode : uint8_t
+    {
+        Auto,      ///< 允许对角移动时使用跳点搜索，否则使用 A*。
+        AStar,     ///< 逐格扩展的 A*。
+        JumpPoint  ///< 跳点搜索（JPS），仅适用于允许对角移动的等代价网格，网格有代价层时退回 A*。
+    };
+
     struct PathRequest
     {
         ECS::Vector2f start;
         ECS::Vector2f end;
         bool allowDiagonal = true;
+        PathSearchMode mode = PathSearchMode::Auto;
+        NavRect bounds;  ///< 非空时只在该矩形内搜索，搜索状态也只按矩形大小分配。
     };
 
     struct PathResult
     {
         bool found = false;
         std::vector<ECS::Vector2f> waypoints;
+        float cost = 0.0f;      ///< 路径代价（以格子为单位，按代价层加权）。
+        int expandedNodes = 0;  ///< 从开放列表弹出的节点数。
     };
 
     class Pathfinder
     {
     public:
+        /**
+         * @brief 使用当前线程的搜索上下文寻路。
+         */
         static PathResult FindPath(const NavGrid& grid, const PathRequest& request);
+
+        /**
+         * @brief 使用调用方提供的搜索上下文寻路。
+         */
+        static PathResult FindPath(const NavGrid& grid, const PathRequest& request, SearchContext& context);
     };
 }
 
@@ -0,0 +1,241 @@
+#ifndef SEARCHCONTEXT_H
+#define SEARCHCONTEXT_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Navigation
+{
+    /**
+     * @brief 网格搜索的可复用状态。
+     *
+     * g 值、父节点与堆位置按格子下标存放在与网格等大的稠密数组中。
+     * 每次查询只递增代号：戳记不等于当前代号的格子视为未访问，因此查询之间无需清空数组。
+     * 开放列表是支持 decrease-key 的二叉堆，每个格子最多在堆中出现一次。
+     */
+    class SearchContext
+    {
+    public:
+        static constexpr int32_t NoParent = -1;
+
+        /**
+         * @brief 开始一次新的查询。数组按需扩容，代号回绕时才整体清零。
+         */
+        void Begin(size_t cellCount)
+        {
+            if (m_stamp.size() < cellCount)
+            {
+                m_g.resize(cellCount);
+                m_parent.resize(cellCount);
+                m_heapIndex.resize(cellCount);
+                m_stamp.resize(cellCount, 0);
+            }
+            m_heap.clear();
+            if (++m_generation == 0)
+            {
+                std::fill(m_stamp.begin(), m_stamp.end(), 0u);
+                m_generation = 1;
+            }
+        }
+
+        bool IsVisited(int32_t cell) const { return m_stamp[cell] == m_generation; }
+        bool IsClosed(int32_t cell) const { return IsVisited(cell) && m_heapIndex[cell] == Closed; }
+        float G(int32_t cell) const { return m_g[cell]; }
+        int32_t Parent(int32_t cell) const { return m_parent[cell]; }
+
+        /**
+         * @brief 以更小的 g 值打开或更新一个格子。
+         * @return 格子之前未访问或 g 值被降低时返回 true。
+         */
+        bool Relax(int32_t cell, float g, float h, int32_t parent)
+        {
+            if (!IsVisited(cell))
+            {
+                m_stamp[cell] = m_generation;
+                m_g[cell] = g;
+                m_parent[cell] = parent;
+                m_heapIndex[cell] = static_cast<int32_t>(m_heap.size());
+                m_heap.push_back({g + h, g, cell});
+                SiftUp(m_heap.size() - 1);
+                return true;
+            }
+            const int32_t index = m_heapIndex[cell];
+            if (index == Closed || g >= m_g[cell]) return false;
+            m_g[cell] = g;
+            m_parent[cell] = parent;
+            m_heap[index] = {g + h, g, cell};
+            SiftUp(static_cast<size_t>(index));
+            return true;
+        }
+
+        bool OpenEmpty() const { return m_heap.empty(); }
+
+        /**
+         * @brief 弹出 f 值最小的格子并将其关闭。f 相同时优先 g 更大（离目标更近）的格子。
+         */
+        int32_t PopMin()
+        {
+            const int32_t cell = m_heap.front().cell;
+            m_heapIndex[cell] = Closed;
+            const HeapEntry last = m_heap.back();
+            m_heap.pop_back();
+            if (!m_heap.empty())
+            {
+                m_heap.front() = last;
+                m_heapIndex[last.cell] = 0;
+                SiftDown(0);
+            }
+            return cell;
+        }
+
+        /**
+         * @brief 当前线程复用的搜索上下文。
+         */
+        static SearchContext& ForCurrentThread()
+        {
+            thread_local SearchContext context;
+            return context;
+        }
+
+    private:
+        static constexpr int32_t Closed = -2;
+
+        struct HeapEntry
+        {
+            float f;
+            float g;
+            int32_t cell;
+        };
+
+        static bool Less(const HeapEntry& a, const HeapEntry& b)
+        {
+            return a.f < b.f || (a.f == b.f && a.g > b.g);
+        }
+
+        void SiftUp(size_t index)
+        {
+            const HeapEntry entry = m_heap[index];
+            while (index > 0)
+            {
+                const size_t parent = (index - 1) / 2;
+                if (!Less(entry, m_heap[parent])) break;
+                m_heap[index] = m_heap[parent];
+                m_heapIndex[m_heap[index].cell] = static_cast<int32_t>(index);
+                index = parent;
+            }
+            m_heap[index] = entry;
+            m_heapIndex[entry.cell] = static_cast<int32_t>(index);
+        }
+
+        void SiftDown(size_t index)
+        {
+            const HeapEntry entry = m_heap[index];
+            const size_t count = m_heap.size();
+            while (true)
+            {
+                size_t child = index * 2 + 1;
+                if (child >= count) break;
+                if (child + 1 < count && Less(m_heap[child + 1], m_heap[child])) ++child;
+                if (!Less(m_heap[child], entry)) break;
+                m_heap[index] = m_heap[child];
+                m_heapIndex[m_heap[index].cell] = static_cast<int32_t>(index);
+                index = child;
+            }
+            m_heap[index] = entry;
+            m_heapIndex[entry.cell] = static_cast<int32_t>(index);
+        }
+
+        std::vector<float> m_g;
+        std::vector<int32_t> m_parent;
+        std::vector<int32_t> m_heapIndex;
+        std::vector<uint32_t> m_stamp;
+        std::vector<HeapEntry> m_heap;
+        uint32_t m_generation = 0;
+    };
+
+    /**
+     * @brief 可从多个线程借用的搜索上下文池。
+     *
+     * 上下文随所服务网格的大小增长，池中的数量不超过曾经同时进行的查询数。与线程局部上下文不同，
+     * 这些数组属于池的所有者，由所有者在网格改变时 Clear 释放，而不是在每个线程上各留一份直到线程退出。
+     */
+    class SearchContextPool
+    {
+    public:
+        /**
+         * @brief 借出的上下文，析构时归还到池中。
+         */
+        class Lease
+        {
+        public:
+            Lease(SearchContextPool& pool, std::unique_ptr<SearchContext> context)
+                : m_pool(&pool), m_context(std::move(context))
+            {
+            }
+            Lease(Lease&&) noexcept = default;
+            Lease& operator=(Lease&&) = delete;
+            ~Lease()
+            {
+                if (m_context) m_pool->Release(std::move(m_context));
+            }
+
+            SearchContext& operator*() const { return *m_context; }
+            SearchContext* operator->() const { return m_context.get(); }
+
+        private:
+            SearchContextPool* m_pool;
+            std::unique_ptr<SearchContext> m_context;
+        };
+
+        SearchContextPool() = default;
+
+        /// 只转移空闲的上下文，双方都不能有借出未还的上下文。
+        SearchContextPool(SearchContextPool&& other) noexcept : m_free(std::move(other.m_free)) {}
+        SearchContextPool& operator=(SearchContextPool&& other) noexcept
+        {
+            m_free = std::move(other.m_free);
+            return *this;
+        }
+
+        Lease Acquire()
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_free.empty()) return Lease(*this, std::make_unique<SearchContext>());
+            std::unique_ptr<SearchContext> context = std::move(m_free.back());
+            m_free.pop_back();
+            return Lease(*this, std::move(context));
+        }
+
+        /**
+         * @brief 释放全部空闲上下文，不能有借出未还的上下文。
+         */
+        void Clear()
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_free.clear();
+            m_free.shrink_to_fit();
+        }
+
+        size_t GetFreeCount() const
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_free.size();
+        }
+
+    private:
+        void Release(std::unique_ptr<SearchContext> context)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_free.push_back(std::move(context));
+        }
+
+        mutable std::mutex m_mutex;
+        std::vector<std::unique_ptr<SearchContext>> m_free;
+    };
+}
+
+#endif
@@ -1,6 +1,9 @@
 #include "ParticleSystem.h"
 #include "PhysicsSystem.h"
+#include "../Components/IDComponent.h"
 #include "RuntimeAsset/RuntimeScene.h"
+#include "../Renderer/Camera.h"
+#include "../Utils/SIMDWrapper.h"
 #include <box2d/box2d.h>
 
 namespace Systems
@@ -55,41 +58,19 @@ namespace Systems
 
         if (ps->pool && !ps->pool->Empty())
         {
-            ps->affectors.UpdateBatch(ps->pool->GetParticles(), scaledDeltaTime);
+            auto& streams = ps->pool->GetStreams();
+            ps->affectors.UpdateBatch(streams, scaledDeltaTime);
 
             if (ps->collisionEnabled)
             {
-                for (auto& particle : ps->pool->GetParticles())
-                {
-                    float distance = glm::dot(particle.position - ps->collisionPlanePoint, ps->collisionPlaneNormal);
-                    if (distance < 0.0f)
-                    {
-                        if (ps->collisionKillOnHit)
-                        {
-                            particle.age = particle.lifetime;
-                        }
-                        else
-                        {
-                            particle.position -= ps->collisionPlaneNormal * distance;
-                            float normalVelocity = glm::dot(particle.velocity, ps->collisionPlaneNormal);
-                            if (normalVelocity < 0.0f)
-                            {
-                                glm::vec3 normalComponent = ps->collisionPlaneNormal * normalVelocity;
-                                glm::vec3 tangentComponent = particle.velocity - normalComponent;
-                                particle.velocity = tangentComponent * (1.0f - ps->collisionFriction) -
-                                                    normalComponent * ps->collisionBounciness;
-                            }
-                        }
-                    }
-                }
+                Particles::Kernels::PlaneCollision(streams, glm::vec2(ps->collisionPlanePoint),
+                                                   glm::vec2(ps->collisionPlaneNormal), ps->collisionBounciness,
+                                                   ps->collisionFriction, ps->collisionKillOnHit);
             }
 
             if (ps->simulationSpace == ECS::ParticleSimulationSpace::Local && transform)
             {
-                for (auto& particle : ps->pool->GetParticles())
-                {
-                    particle.position += positionDelta;
-                }
+                Particles::Kernels::Translate(streams, glm::vec2(positionDelta));
             }
         }
     }
@@ -105,13 +86,14 @@ namespace Systems
 
         float radiusMeters = ps->particleRadius * METER_PER_PIXEL;
 
-        for (auto& particle : ps->pool->GetParticles())
+        auto& streams = ps->pool->GetStreams();
+        for (size_t i = 0; i < streams.count; ++i)
         {
-            if (particle.IsDead()) continue;
+            if (streams.IsDead(i)) continue;
 
             b2Vec2 particlePos = {
-                particle.position.x * METER_PER_PIXEL,
-                -particle.position.y * METER_PER_PIXEL
+                streams.positionX[i] * METER_PER_PIXEL,
+                -streams.positionY[i] * METER_PER_PIXEL
             };
 
             b2AABB aabb;
@@ -171,23 +153,26 @@ namespace Systems
             {
                 if (ps->physicsCollisionKillOnHit)
                 {
-                    particle.age = particle.lifetime;
+                    streams.age[i] = streams.lifetime[i];
                 }
                 else
                 {
                     float pushDistance = ps->particleRadius * 0.5f;
-                    particle.position.x += ctx.collisionNormal.x * pushDistance;
-                    particle.position.y -= ctx.collisionNormal.y * pushDistance;
+                    streams.positionX[i] += ctx.collisionNormal.x * pushDistance;
+                    streams.positionY[i] -= ctx.collisionNormal.y * pushDistance;
 
-                    glm::vec3 normal(ctx.collisionNormal.x, -ctx.collisionNormal.y, 0.0f);
-                    float normalVelocity = glm::dot(particle.velocity, normal);
+                    glm::vec2 normal(ctx.collisionNormal.x, -ctx.collisionNormal.y);
+                    glm::vec2 velocity(streams.velocityX[i], streams.velocityY[i]);
+                    float normalVelocity = glm::dot(velocity, normal);
 
                     if (normalVelocity < 0.0f)
                     {
-                        glm::vec3 normalComponent = normal * normalVelocity;
-                        glm::vec3 tangentComponent = particle.velocity - normalComponent;
-                        particle.velocity = tangentComponent * (1.0f - ps->physicsCollisionFriction) -
-                                            normalComponent * ps->physicsCollisionBounciness;
+                        glm::vec2 normalComponent = normal * normalVelocity;
+                        glm::vec2 tangentComponent = velocity - normalComponent;
+                        velocity = tangentComponent * (1.0f - ps->physicsCollisionFriction) -
+                                   normalComponent * ps->physicsCollisionBounciness;
+                        streams.velocityX[i] = velocity.x;
+                        streams.velocityY[i] = velocity.y;
                     }
                 }
             }
@@ -211,16 +196,32 @@ namespace Systems
             if (needsInit)
             {
                 ps.Initialize();
-                if (ps.emitter) ps.emitter->SetConfig(ps.emitterConfig);
+                if (ps.emitter)
+                {
+                    ps.emitter->SetConfig(ps.emitterConfig);
+                    // 以实体 GUID 作为随机流 ID，固定种子时每个发射器的序列可重现且互不相同
+                    if (const auto* id = registry.try_get<ECS::IDComponent>(entity))
+                    {
+                        ps.emitter->SetEmitterId(std::hash<Guid>{}(id->guid));
+                    }
+                }
                 if (ps.playOnAwake && ps.playState == ECS::ParticlePlayState::Stopped)
                     ps.Play();
             }
         }
 
-        // Phase 2: Parallel particle simulation (emission + affectors + plane collision)
-        std::vector<ParticleUpdateJob> updateJobs;
-        std::vector<JobHandle> jobHandles;
-        auto& jobSystem = JobSystem::GetInstance();
+        // Phase 2: LOD classification and global budget (sequential)
+        const Particles::ParticleBounds viewBounds = GetViewBounds();
+        const glm::vec2 viewCenter = 0.5f * (viewBounds.min + viewBounds.max);
+        struct EmitterFrame
+        {
+            ECS::ParticleSystemComponent* ps;
+            const ECS::TransformComponent* transform;
+            glm::vec3 worldPos;
+            glm::vec2 worldScale;
+        };
+        std::vector<EmitterFrame> frames;
+        std::vector<Particles::ParticleBudgetRequest> budgetRequests;
 
         for (auto entity : view)
         {
@@ -231,22 +232,82 @@ namespace Systems
             if (registry.all_of<ECS::TransformComponent>(entity))
                 transform = &registry.get<ECS::TransformComponent>(entity);
 
-            glm::vec3 worldPos = GetWorldPosition(transform);
-            glm::vec2 worldScale = GetWorldScale(transform);
-            glm::vec3 positionDelta = worldPos - ps.lastPosition;
+            EmitterFrame frame{&ps, transform, GetWorldPosition(transform), GetWorldScale(transform)};
+            const glm::vec2 acceleration = ps.gravityEnabled ? glm::vec2(ps.gravity) : glm::vec2(0.0f);
+            ps.worldBounds = Particles::ComputeEmitterBounds(ps.emitterConfig, glm::vec2(frame.worldPos),
+                                                             frame.worldScale, acceleration);
+            ps.worldBounds.Merge(ps.liveBounds);
+            ps.simulationLod = ps.cullWhenOffscreen
+                                   ? Particles::ClassifyEmitter(ps.worldBounds, viewBounds, ps.cullingMargin)
+                                   : Particles::SimulationLod::Full;
+
+            if (ps.simulationLod != Particles::SimulationLod::Sleeping)
+            {
+                Particles::ParticleBudgetRequest request;
+                request.index = frames.size();
+                request.importance = ps.importance;
+                const glm::vec2 offset = glm::vec2(frame.worldPos) - viewCenter;
+                request.distanceSq = glm::dot(offset, offset);
+                request.cost = ps.emitterConfig.maxParticles;
+                budgetRequests.push_back(request);
+            }
+            frames.push_back(frame);
+        }
+
+        Particles::ApplyParticleBudget(budgetRequests, m_particleBudget);
+        for (const auto& request : budgetRequests)
+        {
+            if (request.admitted) continue;
+            // 被预算裁掉的发射器即使在视口内也不再显示粒子
+            auto* ps = frames[request.index].ps;
+            ps->simulationLod = Particles::SimulationLod::Sleeping;
+            if (ps->pool) ps->pool->Clear();
+            ps->liveBounds = {};
+        }
+
+        // Phase 3: Parallel particle simulation (emission + affectors + plane collision)
+        std::vector<ParticleUpdateJob> updateJobs;
+        std::vector<JobHandle> jobHandles;
+        auto& jobSystem = JobSystem::GetInstance();
+        updateJobs.reserve(frames.size());
 
-            updateJobs.push_back(ParticleUpdateJob{&ps, transform, deltaTime, worldPos, worldScale, positionDelta});
+        for (const auto& frame : frames)
+        {
+            auto& ps = *frame.ps;
+            const float scaledDeltaTime = deltaTime * ps.simulationSpeed;
+            if (ps.simulationLod == Particles::SimulationLod::Sleeping)
+            {
+                ps.sleepingTime += scaledDeltaTime;
+                ps.lastPosition = frame.worldPos;
+                continue;
+            }
+            ps.WakeUp(frame.worldPos, frame.worldScale);
+
+            float stepDeltaTime = deltaTime;
+            if (ps.simulationLod == Particles::SimulationLod::Reduced)
+            {
+                // 隔帧模拟，步长累积到执行的那一帧
+                ps.reducedDeltaTime += deltaTime;
+                if ((ps.lodFrameCounter++ & 1u) == 0u) continue;
+                stepDeltaTime = ps.reducedDeltaTime;
+            }
+            ps.reducedDeltaTime = 0.0f;
+
+            glm::vec3 positionDelta = frame.worldPos - ps.lastPosition;
+            updateJobs.emplace_back(&ps, frame.transform, stepDeltaTime, frame.worldPos, frame.worldScale,
+                                    positionDelta);
         }
 
         for (auto& job : updateJobs)
             jobHandles.push_back(jobSystem.Schedule(&job));
         JobSystem::CompleteAll(jobHandles);
 
-        // Phase 3: Box2D physics collision (sequential - Box2D is not thread-safe)
+        // Phase 4: Box2D physics collision (sequential - Box2D is not thread-safe)
         for (auto entity : view)
         {
             auto& ps = view.get<ECS::ParticleSystemComponent>(entity);
-            if (!ps.Enable || !ps.physicsCollisionEnabled || !ps.pool || ps.pool->Empty())
+            if (!ps.Enable || !ps.physicsCollisionEnabled || !ps.pool || ps.pool->Empty() ||
+                ps.simulationLod == Particles::SimulationLod::Sleeping)
                 continue;
 
             ParticleCollisionJob collisionJob;
@@ -255,7 +316,7 @@ namespace Systems
             collisionJob.Execute();
         }
 
-        // Phase 4: Cleanup and GPU sync (parallel)
+        // Phase 5: Cleanup, GPU sync and live bounds (parallel)
         std::vector<ParticleUpdateJob*> syncList;
         jobHandles.clear();
 
@@ -268,6 +329,7 @@ namespace Systems
                 {
                     ps->pool->RemoveDeadParticles();
                     ps->pool->SyncToGPU();
+                    ps->liveBounds = ComputeLiveBounds(*ps->pool);
                 }
             }
         };
@@ -276,7 +338,9 @@ namespace Systems
         for (auto entity : view)
         {
             auto& ps = view.get<ECS::ParticleSystemComponent>(entity);
-            if (!ps.Enable || !ps.pool || ps.pool->Empty()) continue;
+            if (!ps.Enable || !ps.pool || ps.pool->Empty() ||
+                ps.simulationLod == Particles::SimulationLod::Sleeping)
+                continue;
             SyncJob sj;
             sj.ps = &ps;
             syncJobs.push_back(std::move(sj));
@@ -307,6 +371,36 @@ namespace Systems
     {
         // Legacy single-threaded path kept for compatibility; new code uses job-based OnUpdate
     }
+    Particles::ParticleBounds ParticleSystem::GetViewBounds()
+    {
+        const Camera& camera = GetActiveCamera();
+        CameraProperties props = camera.GetProperties();
+        float viewWidth = props.viewport.width() / props.GetEffectiveZoom().x();
+        float viewHeight = props.viewport.height() / props.GetEffectiveZoom().y();
+        glm::vec2 cameraPos(props.position.x(), props.position.y());
+        glm::vec2 halfExtent(viewWidth * 0.5f, viewHeight * 0.5f);
+        if (props.rotation != 0.0f)
+        {
+            // 旋转后的视口取外接正方形，保证不会误判为不可见
+            float radius = glm::length(halfExtent);
+            halfExtent = glm::vec2(radius);
+        }
+        return {cameraPos - halfExtent, cameraPos + halfExtent};
+    }
+    Particles::ParticleBounds ParticleSystem::ComputeLiveBounds(const Particles::ParticlePool& pool)
+    {
+        Particles::ParticleBounds bounds;
+        if (pool.Empty()) return bounds;
+        auto& simd = SIMD::GetInstance();
+        const auto& streams = pool.GetStreams();
+        float maxSize = std::max(simd.VectorMax(streams.sizeX.data(), streams.count),
+                                 simd.VectorMax(streams.sizeY.data(), streams.count));
+        bounds.min = {simd.VectorMin(streams.positionX.data(), streams.count),
+                      simd.VectorMin(streams.positionY.data(), streams.count)};
+        bounds.max = {simd.VectorMax(streams.positionX.data(), streams.count),
+                      simd.VectorMax(streams.positionY.data(), streams.count)};
+        return bounds.Expanded(std::max(maxSize, 0.0f));
+    }
     glm::vec3 ParticleSystem::GetWorldPosition(const ECS::TransformComponent* transform)
     {
         if (!transform)
@@ -37,17 +37,31 @@ namespace Systems
     class ParticleSystem : public ISystem
     {
     public:
+        /// 默认的全局粒子预算（按发射器 maxParticles 计）。
+        static constexpr size_t DefaultParticleBudget = 200000;
+
         void OnCreate(RuntimeScene* scene, EngineContext& engineCtx) override;
         void OnUpdate(RuntimeScene* scene, float deltaTime, EngineContext& engineCtx) override;
         void OnDestroy(RuntimeScene* scene) override;
+
+        /**
+         * @brief 设置全局粒子预算，超出时重要度最低的发射器先被裁掉。
+         * @param budget 预算粒子数，0 表示不限制。
+         */
+        void SetParticleBudget(size_t budget) { m_particleBudget = budget; }
+        size_t GetParticleBudget() const { return m_particleBudget; }
     private:
         void UpdateParticleSystem(ECS::ParticleSystemComponent& ps, 
                                   const ECS::TransformComponent* transform,
                                   float deltaTime,
                                   PhysicsSystem* physicsSystem,
                                   entt::registry* registry);
+        Particles::ParticleBounds GetViewBounds();
+        static Particles::ParticleBounds ComputeLiveBounds(const Particles::ParticlePool& pool);
         glm::vec3 GetWorldPosition(const ECS::TransformComponent* transform);
         glm::vec2 GetWorldScale(const ECS::TransformComponent* transform);
+
+        size_t m_particleBudget = DefaultParticleBudget;
     };
 }
 #endif 
@@ -1,5 +1,11 @@
 #include "ChunkedPixelWorld.h"
+#include "PixelChunkCodec.h"
+#include "../ProceduralGen/TerrainPipeline.h"
+#include "../../Utils/Logger.h"
 #include <cmath>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
 #include <algorithm>
 
 ChunkedPixelWorld::ChunkedPixelWorld() = default;
@@ -12,8 +18,35 @@ void ChunkedPixelWorld::Initialize(std::shared_ptr<Nut::NutContext> ctx)
     const uint32_t simHeight = simWidth;
 
     m_activeSimulation = std::make_unique<PixelWorld>(simWidth, simHeight);
+    m_activeSimulation->SetReadbackEnabled(true);
     m_activeSimulation->Initialize(m_ctx);
     m_initialized = true;
+
+    if (m_windowValid)
+    {
+        UpdateSimOrigin();
+        for (int dy = -m_activeRadius; dy <= m_activeRadius; dy++)
+        {
+            for (int dx = -m_activeRadius; dx <= m_activeRadius; dx++)
+                WriteChunkToSim(*GetOrCreateChunk(m_viewCenterChunkX + dx, m_viewCenterChunkY + dy));
+        }
+    }
+}
+
+void ChunkedPixelWorld::SetTerrainPipeline(std::shared_ptr<TerrainPipeline> pipeline)
+{
+    if (pipeline && pipeline->GetChunkSize() != CHUNK_SIZE)
+    {
+        LogError("ChunkedPixelWorld: terrain pipeline chunk size {} does not match {}", pipeline->GetChunkSize(),
+                 CHUNK_SIZE);
+        return;
+    }
+    m_terrain = std::move(pipeline);
+}
+
+void ChunkedPixelWorld::SetResidencyRadius(int radius)
+{
+    m_residencyRadius = std::max(radius, m_activeRadius);
 }
 
 uint64_t ChunkedPixelWorld::ChunkKey(int cx, int cy)
@@ -33,31 +66,172 @@ void ChunkedPixelWorld::WorldToChunk(int wx, int wy, int& cx, int& cy, int& lx,
 
 ChunkedPixelWorld::PixelChunk* ChunkedPixelWorld::GetOrCreateChunk(int cx, int cy)
 {
-    uint64_t key = ChunkKey(cx, cy);
-    auto it = m_chunks.find(key);
+    auto it = m_chunks.find(ChunkKey(cx, cy));
     if (it != m_chunks.end())
         return it->second.get();
 
+    if (auto restored = RestoreChunk(cx, cy))
+        return InsertChunk(std::move(restored), false);
+    const bool regenerated = m_evictedClean.erase(ChunkKey(cx, cy)) > 0;
+    auto chunk = NewChunk(cx, cy);
+    GenerateChunkTerrain(*chunk);
+    return InsertChunk(std::move(chunk), !regenerated);
+}
+
+std::unique_ptr<ChunkedPixelWorld::PixelChunk> ChunkedPixelWorld::NewChunk(int cx, int cy)
+{
     auto chunk = std::make_unique<PixelChunk>();
     chunk->chunkX = cx;
     chunk->chunkY = cy;
     chunk->pixels.resize(static_cast<size_t>(CHUNK_SIZE) * CHUNK_SIZE, GPUPixel{0, 0, 0.0f, 0.0f});
-    chunk->dirty = true;
-    GenerateChunkTerrain(*chunk);
+    return chunk;
+}
 
+ChunkedPixelWorld::PixelChunk* ChunkedPixelWorld::InsertChunk(std::unique_ptr<PixelChunk> chunk, bool generated)
+{
+    const int cx = chunk->chunkX;
+    const int cy = chunk->chunkY;
     auto* ptr = chunk.get();
-    m_chunks[key] = std::move(chunk);
+    m_chunks[ChunkKey(cx, cy)] = std::move(chunk);
+    // 逐出后恢复的区块内容与逐出前相同，不算变化
+    if (generated)
+        RecordChange(cx * CHUNK_SIZE, cy * CHUNK_SIZE, cx * CHUNK_SIZE + CHUNK_SIZE - 1, cy * CHUNK_SIZE + CHUNK_SIZE - 1);
     return ptr;
 }
 
-const ChunkedPixelWorld::PixelChunk* ChunkedPixelWorld::GetChunk(int cx, int cy) const
+std::unique_ptr<ChunkedPixelWorld::PixelChunk> ChunkedPixelWorld::RestoreChunk(int cx, int cy)
+{
+    std::vector<uint8_t> data;
+    if (!m_store.Take(cx, cy, data)) return nullptr;
+    auto chunk = NewChunk(cx, cy);
+    if (!PixelChunkCodec::Decode(data.data(), data.size(), chunk->pixels.data(), chunk->pixels.size()))
+    {
+        LogError("ChunkedPixelWorld: evicted chunk ({}, {}) failed to decode, regenerating", cx, cy);
+        return nullptr;
+    }
+    chunk->modified = true;
+    return chunk;
+}
+
+void ChunkedPixelWorld::EvictDistantChunks()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_evictedCopiesMutex);
+        m_evictedCopies.clear();
+    }
+    for (auto it = m_chunks.begin(); it != m_chunks.end();)
+    {
+        const PixelChunk& chunk = *it->second;
+        if (chunk.active || (std::abs(chunk.chunkX - m_viewCenterChunkX) <= m_residencyRadius &&
+                             std::abs(chunk.chunkY - m_viewCenterChunkY) <= m_residencyRadius))
+        {
+            ++it;
+            continue;
+        }
+        if (chunk.modified)
+            m_store.Put(chunk.chunkX, chunk.chunkY, PixelChunkCodec::Encode(chunk.pixels.data(), chunk.pixels.size()));
+        else
+            m_evictedClean.insert(it->first);
+        it = m_chunks.erase(it);
+    }
+}
+
+std::shared_ptr<const ChunkedPixelWorld::PixelChunk> ChunkedPixelWorld::GetEvictedChunk(int cx, int cy) const
+{
+    auto findCopy = [&]() -> std::shared_ptr<const PixelChunk>
+    {
+        auto it = std::find_if(m_evictedCopies.begin(), m_evictedCopies.end(),
+                               [&](const auto& copy) { return copy->chunkX == cx && copy->chunkY == cy; });
+        if (it == m_evictedCopies.end()) return nullptr;
+        std::rotate(it, it + 1, m_evictedCopies.end());
+        return m_evictedCopies.back();
+    };
+    {
+        std::lock_guard<std::mutex> lock(m_evictedCopiesMutex);
+        if (auto copy = findCopy()) return copy;
+    }
+
+    // 解码与生成在锁外进行，各线程读取不同区块时互不阻塞；同一区块偶尔重复生成，结果相同
+    std::vector<uint8_t> data;
+    const bool stored = m_store.Peek(cx, cy, data);
+    if (!stored && !m_evictedClean.count(ChunkKey(cx, cy))) return nullptr;
+
+    std::shared_ptr<PixelChunk> chunk = NewChunk(cx, cy);
+    if (!stored || !PixelChunkCodec::Decode(data.data(), data.size(), chunk->pixels.data(), chunk->pixels.size()))
+        GenerateChunkTerrain(*chunk);
+
+    std::lock_guard<std::mutex> lock(m_evictedCopiesMutex);
+    if (auto copy = findCopy()) return copy;
+    if (m_evictedCopies.size() >= MaxEvictedCopies)
+        m_evictedCopies.erase(m_evictedCopies.begin());
+    m_evictedCopies.push_back(chunk);
+    return chunk;
+}
+
+void ChunkedPixelWorld::GenerateMissingChunks(int centerCX, int centerCY)
+{
+    if (!m_terrain) return;
+
+    std::vector<std::unique_ptr<PixelChunk>> created;
+    for (int dy = -m_activeRadius; dy <= m_activeRadius; dy++)
+    {
+        for (int dx = -m_activeRadius; dx <= m_activeRadius; dx++)
+        {
+            const int cx = centerCX + dx;
+            const int cy = centerCY + dy;
+            if (m_chunks.count(ChunkKey(cx, cy))) continue;
+            if (auto restored = RestoreChunk(cx, cy))
+                InsertChunk(std::move(restored), false);
+            else
+                created.push_back(NewChunk(cx, cy));
+        }
+    }
+    if (created.empty()) return;
+
+    const size_t area = static_cast<size_t>(CHUNK_SIZE) * CHUNK_SIZE;
+    std::vector<uint16_t> tiles(area * created.size());
+    std::vector<TerrainPipeline::Request> requests;
+    requests.reserve(created.size());
+    for (size_t i = 0; i < created.size(); i++)
+        requests.push_back({created[i]->chunkX * CHUNK_SIZE, created[i]->chunkY * CHUNK_SIZE, tiles.data() + i * area});
+    m_terrain->GenerateBatch(requests);
+
+    for (size_t i = 0; i < created.size(); i++)
+    {
+        ApplyTiles(*created[i], tiles.data() + i * area);
+        const bool regenerated = m_evictedClean.erase(ChunkKey(created[i]->chunkX, created[i]->chunkY)) > 0;
+        InsertChunk(std::move(created[i]), !regenerated);
+    }
+}
+
+void ChunkedPixelWorld::ApplyTiles(PixelChunk& chunk, const uint16_t* tiles)
+{
+    for (size_t i = 0; i < chunk.pixels.size(); i++)
+    {
+        const auto type = static_cast<PixelType::Value>(tiles[i]);
+        chunk.pixels[i] = GPUPixel{static_cast<uint32_t>(type), PixelWorld::DefaultColor(type), 0.0f, 0.0f};
+    }
+}
+
+const ChunkedPixelWorld::PixelChunk* ChunkedPixelWorld::GetChunk(int cx, int cy,
+                                                                  std::shared_ptr<const PixelChunk>& evicted) const
 {
     auto it = m_chunks.find(ChunkKey(cx, cy));
-    return it != m_chunks.end() ? it->second.get() : nullptr;
+    if (it != m_chunks.end()) return it->second.get();
+    evicted = GetEvictedChunk(cx, cy);
+    return evicted.get();
 }
 
-void ChunkedPixelWorld::GenerateChunkTerrain(PixelChunk& chunk)
+void ChunkedPixelWorld::GenerateChunkTerrain(PixelChunk& chunk) const
 {
+    if (m_terrain)
+    {
+        std::vector<uint16_t> tiles(chunk.pixels.size());
+        m_terrain->Generate(chunk.chunkX * CHUNK_SIZE, chunk.chunkY * CHUNK_SIZE, tiles.data());
+        ApplyTiles(chunk, tiles.data());
+        return;
+    }
+
     for (int ly = 0; ly < CHUNK_SIZE; ly++)
     {
         int wy = chunk.chunkY * CHUNK_SIZE + ly;
@@ -80,91 +254,112 @@ void ChunkedPixelWorld::SetViewCenter(float worldX, float worldY, float pixelSca
 {
     int newCX = static_cast<int>(std::floor(worldX / (CHUNK_SIZE * pixelScale)));
     int newCY = static_cast<int>(std::floor(worldY / (CHUNK_SIZE * pixelScale)));
+    if (m_windowValid && newCX == m_viewCenterChunkX && newCY == m_viewCenterChunkY) return;
 
-    if (newCX != m_viewCenterChunkX || newCY != m_viewCenterChunkY)
+    // 离开窗口的区块从自己的槽位回读，留在窗口内的区块槽位不变，不需要任何拷贝
+    if (m_windowValid)
     {
-        if (m_initialized)
-            SyncGPUToChunks();
-
-        m_viewCenterChunkX = newCX;
-        m_viewCenterChunkY = newCY;
-
-        for (auto& [_, chunk] : m_chunks)
-            chunk->active = false;
-
         for (int dy = -m_activeRadius; dy <= m_activeRadius; dy++)
         {
             for (int dx = -m_activeRadius; dx <= m_activeRadius; dx++)
             {
-                auto* chunk = GetOrCreateChunk(newCX + dx, newCY + dy);
-                chunk->active = true;
+                const int cx = m_viewCenterChunkX + dx;
+                const int cy = m_viewCenterChunkY + dy;
+                if (std::abs(cx - newCX) <= m_activeRadius && std::abs(cy - newCY) <= m_activeRadius) continue;
+                auto* chunk = GetOrCreateChunk(cx, cy);
+                if (m_initialized)
+                    ReadChunkFromSim(*chunk);
+                chunk->active = false;
             }
         }
-
-        if (m_initialized)
-            SyncChunksToGPU();
     }
-}
 
-void ChunkedPixelWorld::SyncChunksToGPU()
-{
-    if (!m_activeSimulation) return;
+    m_viewCenterChunkX = newCX;
+    m_viewCenterChunkY = newCY;
+    m_windowValid = true;
+    if (m_initialized)
+        UpdateSimOrigin();
 
-    const int diameter = m_activeRadius * 2 + 1;
-    const int startCX = m_viewCenterChunkX - m_activeRadius;
-    const int startCY = m_viewCenterChunkY - m_activeRadius;
+    GenerateMissingChunks(newCX, newCY);
 
-    for (int dy = 0; dy < diameter; dy++)
+    for (int dy = -m_activeRadius; dy <= m_activeRadius; dy++)
     {
-        for (int dx = 0; dx < diameter; dx++)
+        for (int dx = -m_activeRadius; dx <= m_activeRadius; dx++)
         {
-            int cx = startCX + dx;
-            int cy = startCY + dy;
-            auto* chunk = GetOrCreateChunk(cx, cy);
-
-            for (int ly = 0; ly < CHUNK_SIZE; ly++)
-            {
-                for (int lx = 0; lx < CHUNK_SIZE; lx++)
-                {
-                    int simX = dx * CHUNK_SIZE + lx;
-                    int simY = dy * CHUNK_SIZE + ly;
-                    size_t chunkIdx = static_cast<size_t>(ly) * CHUNK_SIZE + lx;
-                    auto& p = chunk->pixels[chunkIdx];
-                    m_activeSimulation->SetPixel(simX, simY, static_cast<PixelType::Value>(p.pixel_type));
-                }
-            }
+            auto* chunk = GetOrCreateChunk(newCX + dx, newCY + dy);
+            if (chunk->active) continue;
+            chunk->active = true;
+            if (m_initialized)
+                WriteChunkToSim(*chunk);
         }
     }
+
+    EvictDistantChunks();
 }
 
-void ChunkedPixelWorld::SyncGPUToChunks()
+int ChunkedPixelWorld::SlotX(int cx) const
 {
-    if (!m_activeSimulation) return;
+    const int diameter = m_activeRadius * 2 + 1;
+    return ((cx % diameter + diameter) % diameter) * CHUNK_SIZE;
+}
 
+int ChunkedPixelWorld::SlotY(int cy) const
+{
     const int diameter = m_activeRadius * 2 + 1;
-    const int startCX = m_viewCenterChunkX - m_activeRadius;
-    const int startCY = m_viewCenterChunkY - m_activeRadius;
+    return ((cy % diameter + diameter) % diameter) * CHUNK_SIZE;
+}
 
-    for (int dy = 0; dy < diameter; dy++)
+void ChunkedPixelWorld::UpdateSimOrigin()
+{
+    if (!m_activeSimulation) return;
+    m_activeSimulation->SetOrigin(static_cast<uint32_t>(SlotX(m_viewCenterChunkX - m_activeRadius)),
+                                  static_cast<uint32_t>(SlotY(m_viewCenterChunkY - m_activeRadius)));
+}
+
+void ChunkedPixelWorld::WriteChunkToSim(const PixelChunk& chunk)
+{
+    if (!m_activeSimulation) return;
+    m_activeSimulation->WritePixels(SlotX(chunk.chunkX), SlotY(chunk.chunkY), CHUNK_SIZE, CHUNK_SIZE,
+                                    chunk.pixels.data(), CHUNK_SIZE);
+}
+
+void ChunkedPixelWorld::ReadChunkFromSim(PixelChunk& chunk)
+{
+    if (!m_activeSimulation) return;
+
+    // CPU 镜像由异步回读维护，可能比 GPU 晚一帧，这里不等待
+    const size_t simWidth = m_activeSimulation->GetWidth();
+    const GPUPixel* simPixels = m_activeSimulation->GetPixels() + static_cast<size_t>(SlotY(chunk.chunkY)) * simWidth +
+                                static_cast<size_t>(SlotX(chunk.chunkX));
+    PixelRect changed;
+    for (int ly = 0; ly < CHUNK_SIZE; ly++)
     {
-        for (int dx = 0; dx < diameter; dx++)
+        const GPUPixel* src = simPixels + static_cast<size_t>(ly) * simWidth;
+        GPUPixel* dst = chunk.pixels.data() + static_cast<size_t>(ly) * CHUNK_SIZE;
+        if (!chunk.modified && std::memcmp(dst, src, sizeof(GPUPixel) * CHUNK_SIZE) != 0)
+            chunk.modified = true;
+        for (int lx = 0; lx < CHUNK_SIZE; lx++)
         {
-            int cx = startCX + dx;
-            int cy = startCY + dy;
-            auto* chunk = GetOrCreateChunk(cx, cy);
-
-            for (int ly = 0; ly < CHUNK_SIZE; ly++)
-            {
-                for (int lx = 0; lx < CHUNK_SIZE; lx++)
-                {
-                    int simX = dx * CHUNK_SIZE + lx;
-                    int simY = dy * CHUNK_SIZE + ly;
-                    size_t chunkIdx = static_cast<size_t>(ly) * CHUNK_SIZE + lx;
-                    uint32_t type = m_activeSimulation->GetPixel(simX, simY);
-                    chunk->pixels[chunkIdx].pixel_type = type;
-                }
-            }
+            if (dst[lx].pixel_type != src[lx].pixel_type)
+                changed.Add(lx, ly, lx, ly);
         }
+        std::copy(src, src + CHUNK_SIZE, dst);
+    }
+    if (!changed.Empty())
+    {
+        const int x0 = chunk.chunkX * CHUNK_SIZE;
+        const int y0 = chunk.chunkY * CHUNK_SIZE;
+        RecordChange(x0 + changed.minX, y0 + changed.minY, x0 + changed.maxX, y0 + changed.maxY);
+    }
+}
+
+void ChunkedPixelWorld::FlushActiveChunks()
+{
+    if (!m_initialized || !m_windowValid) return;
+    for (int dy = -m_activeRadius; dy <= m_activeRadius; dy++)
+    {
+        for (int dx = -m_activeRadius; dx <= m_activeRadius; dx++)
+            ReadChunkFromSim(*GetOrCreateChunk(m_viewCenterChunkX + dx, m_viewCenterChunkY + dy));
     }
 }
 
@@ -181,16 +376,110 @@ void ChunkedPixelWorld::SetPixel(int worldPixelX, int worldPixelY, PixelType::Va
 
     auto* chunk = GetOrCreateChunk(cx, cy);
     size_t i = static_cast<size_t>(ly) * CHUNK_SIZE + lx;
+    if (chunk->pixels[i].pixel_type != static_cast<uint32_t>(type))
+        RecordChange(worldPixelX, worldPixelY, worldPixelX, worldPixelY);
     chunk->pixels[i] = GPUPixel{static_cast<uint32_t>(type), PixelWorld::DefaultColor(type), 0.0f, 0.0f};
-    chunk->dirty = true;
+    chunk->modified = true;
 
     if (chunk->active && m_activeSimulation)
+        m_activeSimulation->SetPixel(SlotX(cx) + lx, SlotY(cy) + ly, type);
+}
+
+struct ChunkedPixelWorld::ChunkEditTarget
+{
+    ChunkedPixelWorld* world;
+    std::vector<PixelChunk*> touched;
+    std::vector<PixelChunk*> refreshed;
+    PixelChunk* cached = nullptr;
+
+    PixelRect GetBounds() const { return {INT_MIN / 2, INT_MIN / 2, INT_MAX / 2, INT_MAX / 2}; }
+
+    PixelChunk* ChunkAt(int cx, int cy)
     {
-        int startCX = m_viewCenterChunkX - m_activeRadius;
-        int startCY = m_viewCenterChunkY - m_activeRadius;
-        int simX = (cx - startCX) * CHUNK_SIZE + lx;
-        int simY = (cy - startCY) * CHUNK_SIZE + ly;
-        m_activeSimulation->SetPixel(simX, simY, type);
+        if (!cached || cached->chunkX != cx || cached->chunkY != cy)
+        {
+            cached = world->GetOrCreateChunk(cx, cy);
+            // 活动区块的存储只在离开窗口时更新，先回读模拟结果，免得把过期像素连同脏矩形写回去
+            if (cached->active && std::find(refreshed.begin(), refreshed.end(), cached) == refreshed.end())
+            {
+                world->ReadChunkFromSim(*cached);
+                refreshed.push_back(cached);
+            }
+        }
+        return cached;
+    }
+
+    void Touch(PixelChunk* chunk, int x0, int y0, int x1, int y1)
+    {
+        if (chunk->dirty.Empty()) touched.push_back(chunk);
+        chunk->dirty.Add(x0, y0, x1, y1);
+        chunk->modified = true;
+    }
+
+    uint32_t GetType(int x, int y)
+    {
+        int cx, cy, lx, ly;
+        WorldToChunk(x, y, cx, cy, lx, ly);
+        return ChunkAt(cx, cy)->pixels[static_cast<size_t>(ly) * CHUNK_SIZE + lx].pixel_type;
+    }
+
+    void Set(int x, int y, const GPUPixel& pixel)
+    {
+        int cx, cy, lx, ly;
+        WorldToChunk(x, y, cx, cy, lx, ly);
+        PixelChunk* chunk = ChunkAt(cx, cy);
+        chunk->pixels[static_cast<size_t>(ly) * CHUNK_SIZE + lx] = pixel;
+        Touch(chunk, lx, ly, lx, ly);
+    }
+
+    void FillSpan(int y, int x0, int x1, const GPUPixel& pixel, uint32_t replaceMask)
+    {
+        // 在区块边界处截断，每段整行写入
+        while (x0 <= x1)
+        {
+            int cx, cy, lx, ly;
+            WorldToChunk(x0, y, cx, cy, lx, ly);
+            const int count = std::min(x1 - x0 + 1, CHUNK_SIZE - lx);
+            PixelChunk* chunk = ChunkAt(cx, cy);
+            const auto changed = PixelEditBuffer::FillRow(chunk->pixels.data() + static_cast<size_t>(ly) * CHUNK_SIZE,
+                                                          ly, lx, lx + count - 1, pixel, replaceMask);
+            if (changed.x0 <= changed.x1) Touch(chunk, changed.x0, ly, changed.x1, ly);
+            x0 += count;
+        }
+    }
+};
+
+void ChunkedPixelWorld::ApplyEdits(const PixelEditBuffer& edits)
+{
+    if (edits.Empty()) return;
+    ChunkEditTarget target{this, {}, {}, nullptr};
+    edits.Apply(target);
+
+    for (PixelChunk* chunk : target.touched)
+    {
+        const PixelRect rect = chunk->dirty;
+        chunk->dirty = PixelRect{};
+        RecordChange(chunk->chunkX * CHUNK_SIZE + rect.minX, chunk->chunkY * CHUNK_SIZE + rect.minY,
+                     chunk->chunkX * CHUNK_SIZE + rect.maxX, chunk->chunkY * CHUNK_SIZE + rect.maxY);
+        if (chunk->active && m_activeSimulation)
+        {
+            m_activeSimulation->WritePixels(SlotX(chunk->chunkX) + rect.minX, SlotY(chunk->chunkY) + rect.minY,
+                                            rect.maxX - rect.minX + 1, rect.maxY - rect.minY + 1,
+                                            chunk->pixels.data() + static_cast<size_t>(rect.minY) * CHUNK_SIZE +
+                                                rect.minX,
+                                            CHUNK_SIZE);
+        }
+    }
+}
+
+void ChunkedPixelWorld::RecordChange(int minX, int minY, int maxX, int maxY)
+{
+    m_changes.push_back({minX, minY, maxX, maxY, ++m_revision});
+    if (m_changes.size() > MaxTrackedChanges)
+    {
+        const size_t drop = m_changes.size() / 2;
+        m_trimmedRevision = m_changes[drop - 1].revision;
+        m_changes.erase(m_changes.begin(), m_changes.begin() + static_cast<std::ptrdiff_t>(drop));
     }
 }
 
@@ -199,7 +488,8 @@ uint32_t ChunkedPixelWorld::GetPixel(int worldPixelX, int worldPixelY) const
     int cx, cy, lx, ly;
     WorldToChunk(worldPixelX, worldPixelY, cx, cy, lx, ly);
 
-    auto* chunk = GetChunk(cx, cy);
+    std::shared_ptr<const PixelChunk> evicted;
+    const PixelChunk* chunk = GetChunk(cx, cy, evicted);
     if (!chunk) return PixelType::Air;
     return chunk->pixels[static_cast<size_t>(ly) * CHUNK_SIZE + lx].pixel_type;
 }
@@ -218,3 +508,13 @@ uint32_t ChunkedPixelWorld::GetActiveHeight() const
 {
     return m_activeSimulation ? m_activeSimulation->GetHeight() : 0;
 }
+
+uint32_t ChunkedPixelWorld::GetActiveOriginX() const
+{
+    return m_activeSimulation ? m_activeSimulation->GetOriginX() : 0;
+}
+
+uint32_t ChunkedPixelWorld::GetActiveOriginY() const
+{
+    return m_activeSimulation ? m_activeSimulation->GetOriginY() : 0;
+}
@@ -2,10 +2,40 @@
 #define CHUNKED_PIXEL_WORLD_H
 
 #include "PixelWorld.h"
+#include "PixelChunkStore.h"
 #include <unordered_map>
+#include <unordered_set>
 #include <memory>
+#include <mutex>
 #include <cstdint>
+#include <algorithm>
+#include <vector>
 
+class TerrainPipeline;
+
+/**
+ * @brief 一次像素类型修改覆盖的世界像素坐标闭区间。
+ */
+struct PixelRegionChange
+{
+    int minX;
+    int minY;
+    int maxX;
+    int maxY;
+    uint64_t revision;
+};
+
+/**
+ * @brief 按区块存储的无限像素世界，视野周围 (2r+1)^2 个区块交给一个 PixelWorld 模拟。
+ *
+ * 模拟缓冲按环面寻址：区块 (cx, cy) 固定放在槽位 (cx mod D, cy mod D)，窗口左上角区块所在的槽位是模拟的原点。
+ * 视野移动一个区块时只回读离开的一列/一行、写入进入的一列/一行，其余区块原地不动。
+ *
+ * 离视野超过驻留半径的区块被逐出内存：改动过的区块压缩后交给 PixelChunkStore，从未改动的区块只记下坐标，
+ * 再次需要时按种子重新生成。逐出对外不可见，GetPixel 与 VisitPixelTypes 照常返回区块内容。
+ *
+ * 常量读取（GetPixel、VisitPixelTypes 等）可以从多个线程并发调用，例如导航烘焙的采样任务，但不能与修改世界的调用并发。
+ */
 class LUMA_API ChunkedPixelWorld
 {
 public:
@@ -17,38 +47,155 @@ public:
     void SetViewCenter(float worldX, float worldY, float pixelScale);
     void Step(float dt);
 
+    /**
+     * @brief 设置地形流水线，区块边长必须为 CHUNK_SIZE。视野移动时缺失的区块整批并行生成；未设置时地面以下全为石头。
+     */
+    void SetTerrainPipeline(std::shared_ptr<TerrainPipeline> pipeline);
+
+    /**
+     * @brief 设置驻留半径（区块，切比雪夫距离），不小于活动半径；视野移动后超出半径的区块被逐出。默认比活动半径大 2。
+     */
+    void SetResidencyRadius(int radius);
+    int GetResidencyRadius() const { return m_residencyRadius; }
+
+    /// 被逐出区块的压缩存储，可设置内存预算与溢出目录。
+    PixelChunkStore& GetChunkStore() { return m_store; }
+    const PixelChunkStore& GetChunkStore() const { return m_store; }
+    size_t GetResidentChunkCount() const { return m_chunks.size(); }
+
+    /**
+     * @brief 把活动区块的模拟结果回读到区块存储并记录变化。视野移动时只回读离开窗口的区块，
+     * 需要整窗最新数据（存档、烘焙导航）时先调用本函数。
+     */
+    void FlushActiveChunks();
+
     void SetPixel(int worldPixelX, int worldPixelY, PixelType::Value type);
     uint32_t GetPixel(int worldPixelX, int worldPixelY) const;
 
+    /**
+     * @brief 以世界像素坐标应用编辑命令。每个区块累计一个脏矩形，应用完成后每个区块只记录一次变化，
+     * 活动区块只把脏矩形写入模拟。
+     */
+    void ApplyEdits(const PixelEditBuffer& edits);
+
+    /**
+     * @brief 按区块遍历闭区间内各像素的类型（未生成的区块视为 Air），fn 返回 false 时提前结束。
+     */
+    template <typename Fn>
+    void VisitPixelTypes(int minX, int minY, int maxX, int maxY, Fn&& fn) const
+    {
+        int minCX, minCY, maxCX, maxCY, lx, ly;
+        WorldToChunk(minX, minY, minCX, minCY, lx, ly);
+        WorldToChunk(maxX, maxY, maxCX, maxCY, lx, ly);
+        for (int cy = minCY; cy <= maxCY; cy++)
+        {
+            for (int cx = minCX; cx <= maxCX; cx++)
+            {
+                std::shared_ptr<const PixelChunk> evicted;
+                const PixelChunk* chunk = GetChunk(cx, cy, evicted);
+                const int x0 = std::max(minX - cx * CHUNK_SIZE, 0);
+                const int y0 = std::max(minY - cy * CHUNK_SIZE, 0);
+                const int x1 = std::min(maxX - cx * CHUNK_SIZE, CHUNK_SIZE - 1);
+                const int y1 = std::min(maxY - cy * CHUNK_SIZE, CHUNK_SIZE - 1);
+                if (!chunk)
+                {
+                    if (!fn(static_cast<uint32_t>(PixelType::Air))) return;
+                    continue;
+                }
+                for (int y = y0; y <= y1; y++)
+                {
+                    const GPUPixel* row = chunk->pixels.data() + static_cast<size_t>(y) * CHUNK_SIZE;
+                    for (int x = x0; x <= x1; x++)
+                    {
+                        if (!fn(row[x].pixel_type)) return;
+                    }
+                }
+            }
+        }
+    }
+
+    uint64_t GetRevision() const { return m_revision; }
+
+    /**
+     * @brief 遍历 sinceRevision 之后像素类型发生变化的区域：区块生成、SetPixel/ApplyEdits，以及区块离开窗口或 FlushActiveChunks 时回读的模拟结果。
+     * @return 所需记录已被丢弃时返回 false，调用方应全量重建。
+     */
+    template <typename Fn>
+    bool ForEachChangeSince(uint64_t sinceRevision, Fn&& fn) const
+    {
+        if (sinceRevision < m_trimmedRevision) return false;
+        auto it = std::upper_bound(m_changes.begin(), m_changes.end(), sinceRevision,
+                                   [](uint64_t r, const PixelRegionChange& change) { return r < change.revision; });
+        for (; it != m_changes.end(); ++it)
+            fn(*it);
+        return true;
+    }
+
     wgpu::Texture GetRenderTexture() const;
     uint32_t GetActiveWidth() const;
     uint32_t GetActiveHeight() const;
+    /// 窗口左上角在渲染纹理中的像素位置，采样时以此为偏移并重复寻址。
+    uint32_t GetActiveOriginX() const;
+    uint32_t GetActiveOriginY() const;
 
 private:
     struct PixelChunk
     {
         int chunkX, chunkY;
         std::vector<GPUPixel> pixels;
-        bool dirty = true;
+        PixelRect dirty; ///< ApplyEdits 中尚未处理的改动，区块局部坐标。
         bool active = false;
+        bool modified = false; ///< 与生成结果不同，逐出时需要保存。
     };
 
+    struct ChunkEditTarget;
+
     std::unordered_map<uint64_t, std::unique_ptr<PixelChunk>> m_chunks;
     std::unique_ptr<PixelWorld> m_activeSimulation;
     std::shared_ptr<Nut::NutContext> m_ctx;
+    std::shared_ptr<TerrainPipeline> m_terrain;
+    PixelChunkStore m_store;
+    std::unordered_set<uint64_t> m_evictedClean; ///< 逐出时未改动的区块，恢复时重新生成。
+    /// 常量访问非驻留区块时解码或重新生成的只读副本，最近使用的在末尾。副本以共享所有权交出，淘汰不影响正在读取的线程。
+    mutable std::vector<std::shared_ptr<const PixelChunk>> m_evictedCopies;
+    mutable std::mutex m_evictedCopiesMutex;
+    static constexpr size_t MaxEvictedCopies = 16;
 
     int m_viewCenterChunkX = 0;
     int m_viewCenterChunkY = 0;
     int m_activeRadius = 3;
+    int m_residencyRadius = 5;
     bool m_initialized = false;
+    bool m_windowValid = false;
+
+    static constexpr size_t MaxTrackedChanges = 16384;
+    uint64_t m_revision = 0;
+    uint64_t m_trimmedRevision = 0;
+    std::vector<PixelRegionChange> m_changes;
 
     static uint64_t ChunkKey(int cx, int cy);
     static void WorldToChunk(int wx, int wy, int& cx, int& cy, int& lx, int& ly);
     PixelChunk* GetOrCreateChunk(int cx, int cy);
-    const PixelChunk* GetChunk(int cx, int cy) const;
-    void SyncChunksToGPU();
-    void SyncGPUToChunks();
-    void GenerateChunkTerrain(PixelChunk& chunk);
+    static std::unique_ptr<PixelChunk> NewChunk(int cx, int cy);
+    PixelChunk* InsertChunk(std::unique_ptr<PixelChunk> chunk, bool generated = true);
+    /// 从存储取回被逐出的改动区块；不存在或解码失败时返回 nullptr。
+    std::unique_ptr<PixelChunk> RestoreChunk(int cx, int cy);
+    void EvictDistantChunks();
+    /// 非驻留区块的只读副本（解码或重新生成），从未生成过的区块返回 nullptr。可以并发调用。
+    std::shared_ptr<const PixelChunk> GetEvictedChunk(int cx, int cy) const;
+    /// 以 (centerCX, centerCY) 为中心的活动窗口内缺失的区块交给地形流水线一次生成。
+    void GenerateMissingChunks(int centerCX, int centerCY);
+    static void ApplyTiles(PixelChunk& chunk, const uint16_t* tiles);
+    /// 驻留区块直接返回；非驻留区块的副本由 evicted 持有，返回的指针在 evicted 释放前有效。
+    const PixelChunk* GetChunk(int cx, int cy, std::shared_ptr<const PixelChunk>& evicted) const;
+    /// 区块在模拟缓冲中的槽位左上角（像素）。
+    int SlotX(int cx) const;
+    int SlotY(int cy) const;
+    void UpdateSimOrigin();
+    void WriteChunkToSim(const PixelChunk& chunk);
+    void ReadChunkFromSim(PixelChunk& chunk);
+    void GenerateChunkTerrain(PixelChunk& chunk) const;
+    void RecordChange(int minX, int minY, int maxX, int maxY);
 };
 
 #endif
@@ -2,7 +2,8 @@
 #include "PixelWorld.h"
 #include <cmath>
 #include <algorithm>
-#include <unordered_set>
+#include <bit>
+#include <unordered_map>
 
 bool MarchingSquares::IsSolid(uint32_t pixelType)
 {
@@ -25,27 +26,29 @@ std::vector<Contour> MarchingSquares::Extract(
     if (gridW < 2 || gridH < 2)
         return {};
 
-    auto sample = [&](int gx, int gy) -> bool
+    // 按行打包采样点，越界视为空
+    const int wordsPerRow = (gridW + 63) / 64;
+    std::vector<uint64_t> rows(static_cast<size_t>(wordsPerRow) * gridH, 0);
+    const int w = static_cast<int>(world.GetWidth());
+    const int h = static_cast<int>(world.GetHeight());
+    const GPUPixel* pixels = world.GetPixels();
+    for (int gy = 0; gy < gridH; gy++)
     {
-        int wx = startX + gx * step;
         int wy = startY + gy * step;
-        return IsSolid(world.GetPixel(wx, wy));
-    };
-
-    // edge key: pack two grid-coord pairs into uint64
-    auto edgeKey = [&](int x1, int y1, int x2, int y2) -> uint64_t
-    {
-        if (x1 > x2 || (x1 == x2 && y1 > y2))
+        if (wy < 0 || wy >= h)
+            continue;
+        const GPUPixel* row = pixels + static_cast<size_t>(wy) * w;
+        uint64_t* bits = rows.data() + static_cast<size_t>(gy) * wordsPerRow;
+        for (int gx = 0; gx < gridW; gx++)
         {
-            std::swap(x1, x2);
-            std::swap(y1, y2);
+            int wx = startX + gx * step;
+            if (wx >= 0 && wx < w && IsSolid(row[wx].pixel_type))
+                bits[gx >> 6] |= 1ull << (gx & 63);
         }
-        uint64_t a = (static_cast<uint64_t>(static_cast<uint16_t>(x1)) << 48) |
-                     (static_cast<uint64_t>(static_cast<uint16_t>(y1)) << 32);
-        uint64_t b = (static_cast<uint64_t>(static_cast<uint16_t>(x2)) << 16) |
-                      static_cast<uint64_t>(static_cast<uint16_t>(y2));
-        return a | b;
-    };
+    }
+
+    std::vector<ContourSegment> cells;
+    ExtractSegments(rows.data(), wordsPerRow, 0, 0, gridW - 2, gridH - 2, cells);
 
     // edge segments: midpoint of grid edges
     struct Segment
@@ -53,54 +56,17 @@ std::vector<Contour> MarchingSquares::Extract(
         ECS::Vector2f a, b;
     };
 
-    // Marching squares: for each cell, generate 0-2 segments
-    //   corners: TL=bit3, TR=bit2, BR=bit1, BL=bit0
-    //   midpoints: top(T), right(R), bottom(B), left(L)
-    std::vector<Segment> segments;
-
-    for (int gy = 0; gy < gridH - 1; gy++)
+    float half = static_cast<float>(step) * 0.5f;
+    auto toWorld = [&](int hx, int hy) -> ECS::Vector2f
     {
-        for (int gx = 0; gx < gridW - 1; gx++)
-        {
-            bool tl = sample(gx, gy);
-            bool tr = sample(gx + 1, gy);
-            bool br = sample(gx + 1, gy + 1);
-            bool bl = sample(gx, gy + 1);
-
-            int caseIdx = (tl ? 8 : 0) | (tr ? 4 : 0) | (br ? 2 : 0) | (bl ? 1 : 0);
-
-            if (caseIdx == 0 || caseIdx == 15)
-                continue;
-
-            float cx = static_cast<float>(startX + gx * step);
-            float cy = static_cast<float>(startY + gy * step);
-            float s = static_cast<float>(step);
-
-            ECS::Vector2f T = {(cx + cx + s) * 0.5f * pixelScale, cy * pixelScale};
-            ECS::Vector2f R = {(cx + s) * pixelScale, (cy + cy + s) * 0.5f * pixelScale};
-            ECS::Vector2f B = {(cx + cx + s) * 0.5f * pixelScale, (cy + s) * pixelScale};
-            ECS::Vector2f L = {cx * pixelScale, (cy + cy + s) * 0.5f * pixelScale};
+        return {(static_cast<float>(startX) + static_cast<float>(hx) * half) * pixelScale,
+                (static_cast<float>(startY) + static_cast<float>(hy) * half) * pixelScale};
+    };
 
-            switch (caseIdx)
-            {
-            case 1:  segments.push_back({L, B}); break;
-            case 2:  segments.push_back({B, R}); break;
-            case 3:  segments.push_back({L, R}); break;
-            case 4:  segments.push_back({T, R}); break;
-            case 5:  segments.push_back({L, T}); segments.push_back({B, R}); break;
-            case 6:  segments.push_back({T, B}); break;
-            case 7:  segments.push_back({L, T}); break;
-            case 8:  segments.push_back({T, L}); break;
-            case 9:  segments.push_back({T, B}); break;
-            case 10: segments.push_back({T, R}); segments.push_back({L, B}); break;
-            case 11: segments.push_back({T, R}); break;
-            case 12: segments.push_back({L, R}); break;
-            case 13: segments.push_back({B, R}); break;
-            case 14: segments.push_back({L, B}); break;
-            default: break;
-            }
-        }
-    }
+    std::vector<Segment> segments;
+    segments.reserve(cells.size());
+    for (const auto& seg : cells)
+        segments.push_back({toWorld(seg.ax, seg.ay), toWorld(seg.bx, seg.by)});
 
     if (segments.empty())
         return {};
@@ -199,6 +165,75 @@ std::vector<Contour> MarchingSquares::Extract(
     return contours;
 }
 
+void MarchingSquares::EmitCell(int caseIdx, int i, int j, std::vector<ContourSegment>& segments)
+{
+    //   corners: TL=bit3, TR=bit2, BR=bit1, BL=bit0
+    //   midpoints: top(T), right(R), bottom(B), left(L)
+    const int tx = 2 * i + 1, ty = 2 * j;
+    const int rx = 2 * i + 2, ry = 2 * j + 1;
+    const int bx = 2 * i + 1, by = 2 * j + 2;
+    const int lx = 2 * i, ly = 2 * j + 1;
+
+    switch (caseIdx)
+    {
+    case 1:  segments.push_back({lx, ly, bx, by}); break;
+    case 2:  segments.push_back({bx, by, rx, ry}); break;
+    case 3:  segments.push_back({lx, ly, rx, ry}); break;
+    case 4:  segments.push_back({rx, ry, tx, ty}); break;
+    case 5:  segments.push_back({lx, ly, bx, by}); segments.push_back({rx, ry, tx, ty}); break;
+    case 6:  segments.push_back({bx, by, tx, ty}); break;
+    case 7:  segments.push_back({lx, ly, tx, ty}); break;
+    case 8:  segments.push_back({tx, ty, lx, ly}); break;
+    case 9:  segments.push_back({tx, ty, bx, by}); break;
+    case 10: segments.push_back({tx, ty, lx, ly}); segments.push_back({bx, by, rx, ry}); break;
+    case 11: segments.push_back({tx, ty, rx, ry}); break;
+    case 12: segments.push_back({rx, ry, lx, ly}); break;
+    case 13: segments.push_back({rx, ry, bx, by}); break;
+    case 14: segments.push_back({bx, by, lx, ly}); break;
+    default: break;
+    }
+}
+
+void MarchingSquares::ExtractSegments(const uint64_t* rows, int wordsPerRow,
+                                      int cellMinX, int cellMinY, int cellMaxX, int cellMaxY,
+                                      std::vector<ContourSegment>& segments)
+{
+    if (cellMinX > cellMaxX || cellMinY > cellMaxY)
+        return;
+
+    for (int j = cellMinY; j <= cellMaxY; j++)
+    {
+        const uint64_t* top = rows + static_cast<size_t>(j) * wordsPerRow;
+        const uint64_t* bottom = top + wordsPerRow;
+        for (int w = cellMinX >> 6; w <= cellMaxX >> 6; w++)
+        {
+            // 把右侧采样点移到同一位上，跨字时取下一个字的最低位
+            const bool hasNext = w + 1 < wordsPerRow;
+            const uint64_t tl = top[w];
+            const uint64_t bl = bottom[w];
+            const uint64_t tr = (tl >> 1) | (hasNext ? top[w + 1] << 63 : 0);
+            const uint64_t br = (bl >> 1) | (hasNext ? bottom[w + 1] << 63 : 0);
+
+            // 四个角不全相同的单元才产生线段
+            uint64_t mixed = (tl ^ tr) | (bl ^ br) | (tl ^ bl);
+            const int base = w << 6;
+            if (cellMinX > base)
+                mixed &= ~0ull << (cellMinX - base);
+            if (cellMaxX < base + 63)
+                mixed &= ~0ull >> (63 - (cellMaxX - base));
+
+            while (mixed)
+            {
+                const int k = std::countr_zero(mixed);
+                mixed &= mixed - 1;
+                const int caseIdx = static_cast<int>(((tl >> k) & 1) << 3 | ((tr >> k) & 1) << 2 |
+                                                     ((br >> k) & 1) << 1 | ((bl >> k) & 1));
+                EmitCell(caseIdx, base + k, j, segments);
+            }
+        }
+    }
+}
+
 float MarchingSquares::PerpendicularDistance(const ECS::Vector2f& p,
                                             const ECS::Vector2f& a,
                                             const ECS::Vector2f& b)
@@ -1,6 +1,7 @@
 #ifndef MARCHING_SQUARES_H
 #define MARCHING_SQUARES_H
 
+#include <cstdint>
 #include <vector>
 #include "Components/Core.h"
 
@@ -12,9 +13,31 @@ struct Contour
     bool closed = true;
 };
 
+/**
+ * @brief 行进方块产生的有向线段，坐标以半个采样间距为单位。
+ *
+ * 法线 (dy, -dx) 指向空的一侧，与 Box2D 单面链的约定一致；鞍点单元按两个分离的角处理。
+ */
+struct ContourSegment
+{
+    int ax, ay;
+    int bx, by;
+};
+
 class MarchingSquares
 {
 public:
+    /**
+     * @brief 在打包的实心位图上提取线段。
+     *
+     * rows 每行 wordsPerRow 个 64 位字，第 k 位是第 k 列采样点。单元 (i, j) 以采样点 (i, j) 为左上角，
+     * 提取闭区间 [cellMinX, cellMaxX] x [cellMinY, cellMaxY] 内的单元，位图至少要有 cellMaxY + 2 行、
+     * cellMaxX + 2 列。整字计算每个单元是否跨越边界，全空或全满的单元成片跳过。
+     */
+    static void ExtractSegments(const uint64_t* rows, int wordsPerRow,
+                                int cellMinX, int cellMinY, int cellMaxX, int cellMaxY,
+                                std::vector<ContourSegment>& segments);
+
     static std::vector<Contour> Extract(
         const PixelWorld& world,
         int startX, int startY,
@@ -26,6 +49,7 @@ public:
     static Contour Simplify(const Contour& contour, float tolerance);
 
 private:
+    static void EmitCell(int caseIdx, int i, int j, std::vector<ContourSegment>& segments);
     static bool IsSolid(uint32_t pixelType);
     static float PerpendicularDistance(const ECS::Vector2f& p,
                                       const ECS::Vector2f& a,
@@ -0,0 +1,184 @@
+#include "PixelChunkCodec.h"
+#include "../../Utils/BlockCompressor.h"
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+    constexpr size_t HeaderSize = 5;  ///< Format + 游程层字节数（uint32）。
+
+    void PutVarint(std::vector<uint8_t>& out, uint64_t value)
+    {
+        while (value >= 0x80)
+        {
+            out.push_back(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<uint8_t>(value));
+    }
+
+    bool GetVarint(const uint8_t*& p, const uint8_t* end, uint64_t& value)
+    {
+        value = 0;
+        for (int shift = 0; shift < 64 && p < end; shift += 7)
+        {
+            const uint8_t byte = *p++;
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) return true;
+        }
+        return false;
+    }
+
+    void PutU32(std::vector<uint8_t>& out, uint32_t value)
+    {
+        for (int i = 0; i < 4; i++)
+            out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+    }
+
+    bool GetU32(const uint8_t*& p, const uint8_t* end, uint32_t& value)
+    {
+        if (end - p < 4) return false;
+        value = static_cast<uint32_t>(p[0]) | static_cast<uint32_t>(p[1]) << 8 | static_cast<uint32_t>(p[2]) << 16 |
+                static_cast<uint32_t>(p[3]) << 24;
+        p += 4;
+        return true;
+    }
+
+    uint32_t FloatBits(float value)
+    {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    }
+
+    float BitsFloat(uint32_t bits)
+    {
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+}
+
+void PixelChunkCodec::EncodeRuns(const GPUPixel* pixels, size_t count, std::vector<uint8_t>& out)
+{
+    // 游程：varint(长度 - 1)，varint(类型 << 1 | 是否默认色)，非默认色再跟 4 字节颜色
+    for (size_t i = 0; i < count;)
+    {
+        const uint32_t type = pixels[i].pixel_type;
+        const uint32_t color = pixels[i].color;
+        size_t end = i + 1;
+        while (end < count && pixels[end].pixel_type == type && pixels[end].color == color)
+            end++;
+        const bool defaultColor = type < 32 && color == DefaultPixelColor(static_cast<PixelType::Value>(type));
+        PutVarint(out, end - i - 1);
+        PutVarint(out, static_cast<uint64_t>(type) << 1 | (defaultColor ? 1u : 0u));
+        if (!defaultColor) PutU32(out, color);
+        i = end;
+    }
+
+    // 运动状态非 0 的像素：varint(个数)，每个 varint(下标差) + 两个 float 的位模式
+    size_t extras = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        if (FloatBits(pixels[i].lifetime) != 0 || FloatBits(pixels[i].velocity_y) != 0) extras++;
+    }
+    PutVarint(out, extras);
+    size_t previous = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        const uint32_t lifetime = FloatBits(pixels[i].lifetime);
+        const uint32_t velocity = FloatBits(pixels[i].velocity_y);
+        if (lifetime == 0 && velocity == 0) continue;
+        PutVarint(out, i - previous);
+        PutU32(out, lifetime);
+        PutU32(out, velocity);
+        previous = i;
+    }
+}
+
+bool PixelChunkCodec::DecodeRuns(const uint8_t* data, size_t size, GPUPixel* out, size_t count)
+{
+    const uint8_t* p = data;
+    const uint8_t* end = data + size;
+    for (size_t i = 0; i < count;)
+    {
+        uint64_t length, code;
+        if (!GetVarint(p, end, length) || !GetVarint(p, end, code)) return false;
+        if (length >= count - i || (code >> 1) > UINT32_MAX) return false;
+        const auto type = static_cast<uint32_t>(code >> 1);
+        uint32_t color;
+        if (code & 1u)
+        {
+            if (type >= 32) return false;
+            color = DefaultPixelColor(static_cast<PixelType::Value>(type));
+        }
+        else if (!GetU32(p, end, color))
+        {
+            return false;
+        }
+        const GPUPixel pixel{type, color, 0.0f, 0.0f};
+        std::fill(out + i, out + i + length + 1, pixel);
+        i += length + 1;
+    }
+
+    uint64_t extras;
+    if (!GetVarint(p, end, extras) || extras > count) return false;
+    size_t index = 0;
+    for (uint64_t e = 0; e < extras; e++)
+    {
+        uint64_t delta;
+        uint32_t lifetime, velocity;
+        if (!GetVarint(p, end, delta) || delta >= count - index || (e > 0 && delta == 0)) return false;
+        if (!GetU32(p, end, lifetime) || !GetU32(p, end, velocity)) return false;
+        index += delta;
+        out[index].lifetime = BitsFloat(lifetime);
+        out[index].velocity_y = BitsFloat(velocity);
+    }
+    return p == end;
+}
+
+std::vector<uint8_t> PixelChunkCodec::Encode(const GPUPixel* pixels, size_t count)
+{
+    std::vector<uint8_t> runs;
+    EncodeRuns(pixels, count, runs);
+
+    std::vector<uint8_t> out(HeaderSize);
+    BlockCompressor::Compress(runs.data(), runs.size(), out);
+    Format format = Format::RunsLz;
+    if (out.size() >= HeaderSize + runs.size())
+    {
+        out.resize(HeaderSize);
+        out.insert(out.end(), runs.begin(), runs.end());
+        format = Format::Runs;
+    }
+    out[0] = static_cast<uint8_t>(format);
+    const auto runBytes = static_cast<uint32_t>(runs.size());
+    for (int i = 0; i < 4; i++)
+        out[1 + i] = static_cast<uint8_t>(runBytes >> (8 * i));
+    return out;
+}
+
+bool PixelChunkCodec::Decode(const uint8_t* data, size_t size, GPUPixel* out, size_t count)
+{
+    const uint8_t* p = data + 1;
+    uint32_t runBytes;
+    if (size < HeaderSize || !GetU32(p, data + size, runBytes)) return false;
+    const uint8_t* payload = data + HeaderSize;
+    const size_t payloadSize = size - HeaderSize;
+
+    switch (static_cast<Format>(data[0]))
+    {
+    case Format::Runs:
+        return payloadSize == runBytes && DecodeRuns(payload, payloadSize, out, count);
+    case Format::RunsLz:
+    {
+        // 每个游程至少两字节，超过上限的长度只可能来自损坏的数据
+        if (runBytes > count * 32 + 16) return false;
+        std::vector<uint8_t> runs(runBytes);
+        return BlockCompressor::Decompress(payload, payloadSize, runs.data(), runs.size()) &&
+               DecodeRuns(runs.data(), runs.size(), out, count);
+    }
+    default:
+        return false;
+    }
+}
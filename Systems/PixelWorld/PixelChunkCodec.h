@@ -0,0 +1,37 @@
+#ifndef PIXEL_CHUNK_CODEC_H
+#define PIXEL_CHUNK_CODEC_H
+
+#include "PixelTypes.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief 像素区块的无损压缩。
+ *
+ * 第一层按 (类型, 颜色) 做游程编码，颜色等于该类型默认色时省略；lifetime/velocity_y 不为 0 的像素
+ * 单独记在游程之后。第二层是通用的 LZ 块压缩（BlockCompressor），只在确实变小时使用，
+ * 噪声地形的重复行在这一层被进一步压掉。解码结果与原始像素逐字节相同。
+ */
+class LUMA_API PixelChunkCodec
+{
+public:
+    enum class Format : uint8_t
+    {
+        Runs = 1,    ///< 只有游程层。
+        RunsLz = 2   ///< 游程层再经 LZ 块压缩。
+    };
+
+    static std::vector<uint8_t> Encode(const GPUPixel* pixels, size_t count);
+
+    /**
+     * @brief 解码到 count 个像素；数据损坏或像素数不符时返回 false，out 的内容未定义。
+     */
+    static bool Decode(const uint8_t* data, size_t size, GPUPixel* out, size_t count);
+
+    /// 游程层，供单独测试与基准使用。
+    static void EncodeRuns(const GPUPixel* pixels, size_t count, std::vector<uint8_t>& out);
+    static bool DecodeRuns(const uint8_t* data, size_t size, GPUPixel* out, size_t count);
+};
+
+#endif
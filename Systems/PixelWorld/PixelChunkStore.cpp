@@ -0,0 +1,148 @@
+#include "PixelChunkStore.h"
+#include "../WorldStreaming/RegionStore.h"
+#include "../../Utils/Logger.h"
+
+using WorldStreaming::ChunkCoord;
+using WorldStreaming::RegionFormat::Encoding;
+
+PixelChunkStore::PixelChunkStore() = default;
+
+PixelChunkStore::~PixelChunkStore() = default;
+
+uint64_t PixelChunkStore::Key(int cx, int cy)
+{
+    return (static_cast<uint64_t>(static_cast<uint32_t>(cx)) << 32) | static_cast<uint32_t>(cy);
+}
+
+namespace
+{
+    ChunkCoord CoordOf(uint64_t key)
+    {
+        return {static_cast<int32_t>(static_cast<uint32_t>(key >> 32)), static_cast<int32_t>(static_cast<uint32_t>(key))};
+    }
+}
+
+void PixelChunkStore::SetMemoryBudget(size_t bytes)
+{
+    m_memoryBudget = bytes;
+    EnforceBudget();
+}
+
+void PixelChunkStore::SetSpillDirectory(const std::filesystem::path& directory)
+{
+    if (m_disk)
+    {
+        // 换目录或关闭磁盘层前把磁盘上的区块读回内存，旧目录之后不再访问
+        const auto disk = std::move(m_disk);
+        for (uint64_t key : m_onDisk)
+        {
+            std::vector<uint8_t> data;
+            Encoding encoding;
+            if (!disk->LoadEncoded(CoordOf(key), data, encoding) || encoding != Encoding::PixelChunk)
+            {
+                LogWarn("PixelChunkStore: spilled chunk ({}, {}) could not be read back", CoordOf(key).x,
+                        CoordOf(key).y);
+                continue;
+            }
+            m_memoryBytes += data.size();
+            m_lru.push_back({key, std::move(data)});
+            m_memory[key] = std::prev(m_lru.end());
+        }
+        m_onDisk.clear();
+    }
+    if (!directory.empty())
+        m_disk = std::make_unique<WorldStreaming::RegionStore>(directory);
+    EnforceBudget();
+}
+
+void PixelChunkStore::Put(int cx, int cy, std::vector<uint8_t> data)
+{
+    const uint64_t key = Key(cx, cy);
+    m_onDisk.erase(key);
+    auto it = m_memory.find(key);
+    if (it != m_memory.end())
+    {
+        m_memoryBytes -= it->second->data.size();
+        m_lru.erase(it->second);
+    }
+    m_memoryBytes += data.size();
+    m_lru.push_front({key, std::move(data)});
+    m_memory[key] = m_lru.begin();
+    EnforceBudget();
+}
+
+bool PixelChunkStore::Take(int cx, int cy, std::vector<uint8_t>& outData)
+{
+    const uint64_t key = Key(cx, cy);
+    auto it = m_memory.find(key);
+    if (it != m_memory.end())
+    {
+        outData = std::move(it->second->data);
+        m_memoryBytes -= outData.size();
+        m_lru.erase(it->second);
+        m_memory.erase(it);
+        return true;
+    }
+
+    // 磁盘上的旧数据留在区域文件中，不在 m_onDisk 里就不会再被读取
+    if (!m_onDisk.erase(key)) return false;
+    Encoding encoding;
+    if (!m_disk->LoadEncoded({cx, cy}, outData, encoding) || encoding != Encoding::PixelChunk)
+    {
+        LogWarn("PixelChunkStore: spilled chunk ({}, {}) could not be read back", cx, cy);
+        return false;
+    }
+    ++m_diskLoads;
+    return true;
+}
+
+bool PixelChunkStore::Peek(int cx, int cy, std::vector<uint8_t>& outData) const
+{
+    const uint64_t key = Key(cx, cy);
+    auto it = m_memory.find(key);
+    if (it != m_memory.end())
+    {
+        outData = it->second->data;
+        return true;
+    }
+    if (!m_onDisk.count(key)) return false;
+    Encoding encoding;
+    return m_disk->LoadEncoded({cx, cy}, outData, encoding) && encoding == Encoding::PixelChunk;
+}
+
+bool PixelChunkStore::Contains(int cx, int cy) const
+{
+    const uint64_t key = Key(cx, cy);
+    return m_memory.count(key) || m_onDisk.count(key);
+}
+
+void PixelChunkStore::Flush()
+{
+    if (m_disk) m_disk->Flush();
+}
+
+PixelChunkStore::Stats PixelChunkStore::GetStats() const
+{
+    Stats stats;
+    stats.memoryBytes = m_memoryBytes;
+    stats.memoryChunks = m_memory.size();
+    stats.diskChunks = m_onDisk.size();
+    stats.spilled = m_spilled;
+    stats.diskLoads = m_diskLoads;
+    return stats;
+}
+
+void PixelChunkStore::EnforceBudget()
+{
+    if (!m_disk) return;
+    while (m_memoryBytes > m_memoryBudget && !m_lru.empty())
+    {
+        Entry& entry = m_lru.back();
+        m_memoryBytes -= entry.data.size();
+        m_disk->SaveEncoded(CoordOf(entry.key), std::move(entry.data), Encoding::PixelChunk);
+        m_onDisk.insert(entry.key);
+        m_memory.erase(entry.key);
+        m_lru.pop_back();
+        ++m_spilled;
+    }
+}
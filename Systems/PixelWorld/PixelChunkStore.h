@@ -0,0 +1,88 @@
+#ifndef PIXEL_CHUNK_STORE_H
+#define PIXEL_CHUNK_STORE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace WorldStreaming
+{
+    class RegionStore;
+}
+
+/**
+ * @brief 被逐出的像素区块的压缩数据，两级存储。
+ *
+ * 内存层按最近使用顺序保存编码后的区块，总字节数超过预算时把最久未用的区块交给 RegionStore 写入溢出目录，
+ * 需要时再从磁盘读回。未设置溢出目录时不限制内存。修改只在主线程进行；Peek 与 Contains 不改动任何状态，
+ * 没有修改进行时可以从多个线程并发调用。磁盘写入由 RegionStore 的后台线程完成。
+ */
+class LUMA_API PixelChunkStore
+{
+public:
+    struct Stats
+    {
+        size_t memoryBytes = 0;    ///< 内存层的编码数据总字节数。
+        size_t memoryChunks = 0;
+        size_t diskChunks = 0;     ///< 当前只在磁盘上的区块数。
+        uint64_t spilled = 0;      ///< 累计溢出到磁盘的次数。
+        uint64_t diskLoads = 0;    ///< 累计从磁盘取回的次数。
+    };
+
+    PixelChunkStore();
+    ~PixelChunkStore();
+
+    PixelChunkStore(const PixelChunkStore&) = delete;
+    PixelChunkStore& operator=(const PixelChunkStore&) = delete;
+
+    void SetMemoryBudget(size_t bytes);
+    size_t GetMemoryBudget() const { return m_memoryBudget; }
+
+    /**
+     * @brief 设置溢出目录并立即按预算溢出；空路径关闭磁盘层，已在磁盘上的区块先读回内存。
+     * 目录中此前会话留下的数据不会被读取。
+     */
+    void SetSpillDirectory(const std::filesystem::path& directory);
+
+    /// 保存区块的编码数据，覆盖旧版本。
+    void Put(int cx, int cy, std::vector<uint8_t> data);
+
+    /// 取出并移除区块的编码数据，不存在（或磁盘数据损坏）时返回 false。
+    bool Take(int cx, int cy, std::vector<uint8_t>& outData);
+
+    /// 读取但不移除，也不改变最近使用顺序。
+    bool Peek(int cx, int cy, std::vector<uint8_t>& outData) const;
+
+    bool Contains(int cx, int cy) const;
+
+    /// 阻塞直到溢出的区块全部写入磁盘。
+    void Flush();
+
+    Stats GetStats() const;
+
+private:
+    struct Entry
+    {
+        uint64_t key;
+        std::vector<uint8_t> data;
+    };
+
+    static uint64_t Key(int cx, int cy);
+    void EnforceBudget();
+
+    size_t m_memoryBudget = 64u << 20;
+    size_t m_memoryBytes = 0;
+    std::list<Entry> m_lru; ///< 表头最近使用。
+    std::unordered_map<uint64_t, std::list<Entry>::iterator> m_memory;
+    std::unordered_set<uint64_t> m_onDisk;
+    std::unique_ptr<WorldStreaming::RegionStore> m_disk;
+    uint64_t m_spilled = 0;
+    uint64_t m_diskLoads = 0;
+};
+
+#endif
@@ -0,0 +1,271 @@
+#include "PixelColliderGrid.h"
+#include "../../Event/JobSystem.h"
+#include <algorithm>
+
+PixelColliderGrid::PixelColliderGrid(int width, int height)
+{
+    Resize(width, height);
+}
+
+void PixelColliderGrid::Resize(int width, int height)
+{
+    m_width = std::max(width, 0);
+    m_height = std::max(height, 0);
+    m_chunksX = (m_width + ChunkSize - 1) / ChunkSize;
+    m_chunksY = (m_height + ChunkSize - 1) / ChunkSize;
+    m_chunks.assign(static_cast<size_t>(m_chunksX) * m_chunksY, ChunkState{});
+    for (int cy = 0; cy < m_chunksY; cy++)
+    {
+        for (int cx = 0; cx < m_chunksX; cx++)
+        {
+            ChunkState& chunk = m_chunks[static_cast<size_t>(cy) * m_chunksX + cx];
+            chunk.x0 = cx * ChunkSize;
+            chunk.y0 = cy * ChunkSize;
+        }
+    }
+    m_rebuilt.clear();
+    m_stats = {};
+    m_stats.totalChunks = static_cast<uint32_t>(m_chunks.size());
+}
+
+void PixelColliderGrid::SetSolidTypes(uint32_t typeMask)
+{
+    if (m_solidTypes == typeMask) return;
+    m_solidTypes = typeMask;
+    MarkAllDirty();
+}
+
+void PixelColliderGrid::SetSimplifyTolerance(float tolerance)
+{
+    if (m_tolerance == tolerance) return;
+    m_tolerance = tolerance;
+    MarkAllDirty();
+}
+
+void PixelColliderGrid::MarkAllDirty()
+{
+    for (auto& chunk : m_chunks)
+        chunk.dirty = true;
+}
+
+const std::vector<PixelColliderGrid::Chain>& PixelColliderGrid::GetChains(int chunkIndex) const
+{
+    return m_chunks[static_cast<size_t>(chunkIndex)].chains;
+}
+
+void PixelColliderGrid::Update(const GPUPixel* pixels)
+{
+    struct PackJob : public IJob
+    {
+        PixelColliderGrid* grid;
+        const GPUPixel* pixels;
+        size_t begin;
+        size_t end;
+
+        PackJob(PixelColliderGrid* g, const GPUPixel* p, size_t b, size_t e) : grid(g), pixels(p), begin(b), end(e)
+        {
+        }
+
+        void Execute() override
+        {
+            for (size_t i = begin; i < end; i++)
+            {
+                if (grid->PackMask(pixels, grid->m_chunks[i]))
+                    grid->m_chunks[i].dirty = true;
+            }
+        }
+    };
+
+    struct BuildJob : public IJob
+    {
+        const PixelColliderGrid* grid;
+        ChunkState* chunk;
+        std::vector<ContourSegment> segments;
+
+        BuildJob(const PixelColliderGrid* g, ChunkState* c) : grid(g), chunk(c) {}
+
+        void Execute() override
+        {
+            grid->BuildChains(*chunk, segments);
+            chunk->dirty = false;
+        }
+    };
+
+    m_rebuilt.clear();
+    m_stats.rebuiltChunks = 0;
+    m_stats.chains = 0;
+    if (m_chunks.empty()) return;
+
+    // 每行区块一个作业重新打包位图，位图变化的区块标脏
+    std::vector<PackJob> packJobs;
+    packJobs.reserve(static_cast<size_t>(m_chunksY));
+    for (int cy = 0; cy < m_chunksY; cy++)
+    {
+        const size_t begin = static_cast<size_t>(cy) * m_chunksX;
+        packJobs.emplace_back(this, pixels, begin, begin + m_chunksX);
+    }
+    JobSystem::RunAll(packJobs);
+
+    std::vector<BuildJob> buildJobs;
+    for (size_t i = 0; i < m_chunks.size(); i++)
+    {
+        if (!m_chunks[i].dirty) continue;
+        m_rebuilt.push_back(static_cast<int>(i));
+        buildJobs.emplace_back(this, &m_chunks[i]);
+    }
+    JobSystem::RunAll(buildJobs);
+
+    m_stats.rebuiltChunks = static_cast<uint32_t>(m_rebuilt.size());
+    for (int index : m_rebuilt)
+        m_stats.chains += static_cast<uint32_t>(m_chunks[static_cast<size_t>(index)].chains.size());
+}
+
+bool PixelColliderGrid::PackMask(const GPUPixel* pixels, ChunkState& chunk) const
+{
+    std::array<uint64_t, MaskSize> mask{};
+    const int left = chunk.x0 - MaskBorder;
+    const int top = chunk.y0 - MaskBorder;
+    const int c0 = std::max(0, -left);
+    const int c1 = std::min(MaskSize, m_width - left);
+    for (int r = 0; r < MaskSize; r++)
+    {
+        const int y = top + r;
+        if (y < 0 || y >= m_height) continue;
+        const GPUPixel* row = pixels + static_cast<size_t>(y) * m_width;
+        uint64_t bits = 0;
+        for (int c = c0; c < c1; c++)
+            bits |= static_cast<uint64_t>((m_solidTypes >> (row[left + c].pixel_type & 31u)) & 1u) << c;
+        mask[static_cast<size_t>(r)] = bits;
+    }
+
+    if (mask == chunk.mask) return false;
+    chunk.mask = mask;
+    return true;
+}
+
+void PixelColliderGrid::BuildChains(ChunkState& chunk, std::vector<ContourSegment>& segments) const
+{
+    chunk.chains.clear();
+
+    // 本区块负责的单元（位图坐标）；单元 i 由采样点 i、i + 1 围成，最左/最上的区块还负责世界外的一列/一行
+    const int ownedMinX = (chunk.x0 == 0 ? -1 : 0) + MaskBorder;
+    const int ownedMinY = (chunk.y0 == 0 ? -1 : 0) + MaskBorder;
+    const int ownedMaxX = std::min(ChunkSize, m_width - chunk.x0) - 1 + MaskBorder;
+    const int ownedMaxY = std::min(ChunkSize, m_height - chunk.y0) - 1 + MaskBorder;
+
+    // 向外多提取一圈单元，用来找开链的幽灵点
+    segments.clear();
+    MarchingSquares::ExtractSegments(chunk.mask.data(), 1, ownedMinX - 1, ownedMinY - 1, ownedMaxX + 1,
+                                     ownedMaxY + 1, segments);
+    if (segments.empty()) return;
+
+    // 每个边中点恰好是一条线段的起点和另一条线段的终点
+    constexpr int Stride = 2 * MaskSize + 1;
+    std::vector<int> startAt(static_cast<size_t>(Stride) * Stride, -1);
+    std::vector<int> endAt(static_cast<size_t>(Stride) * Stride, -1);
+    for (size_t i = 0; i < segments.size(); i++)
+    {
+        startAt[static_cast<size_t>(segments[i].ay) * Stride + segments[i].ax] = static_cast<int>(i);
+        endAt[static_cast<size_t>(segments[i].by) * Stride + segments[i].bx] = static_cast<int>(i);
+    }
+
+    auto owned = [&](int s)
+    {
+        const ContourSegment& seg = segments[static_cast<size_t>(s)];
+        const int i = std::min(seg.ax, seg.bx) >> 1;
+        const int j = std::min(seg.ay, seg.by) >> 1;
+        return i >= ownedMinX && i <= ownedMaxX && j >= ownedMinY && j <= ownedMaxY;
+    };
+    auto next = [&](int s)
+    {
+        const ContourSegment& seg = segments[static_cast<size_t>(s)];
+        return startAt[static_cast<size_t>(seg.by) * Stride + seg.bx];
+    };
+    auto prev = [&](int s)
+    {
+        const ContourSegment& seg = segments[static_cast<size_t>(s)];
+        return endAt[static_cast<size_t>(seg.ay) * Stride + seg.ax];
+    };
+    // 采样点位于像素中心
+    const float originX = static_cast<float>(chunk.x0 - MaskBorder) + 0.5f;
+    const float originY = static_cast<float>(chunk.y0 - MaskBorder) + 0.5f;
+    auto toPixel = [&](int hx, int hy) -> ECS::Vector2f
+    {
+        return {originX + static_cast<float>(hx) * 0.5f, originY + static_cast<float>(hy) * 0.5f};
+    };
+
+    std::vector<uint8_t> visited(segments.size(), 0);
+    Contour run;
+    for (int s = 0; s < static_cast<int>(segments.size()); s++)
+    {
+        if (visited[static_cast<size_t>(s)] || !owned(s)) continue;
+
+        // 回溯到连续的本区块线段的起点，绕回自身说明整条轮廓都在本区块内
+        int first = s;
+        bool loop = false;
+        for (;;)
+        {
+            const int p = prev(first);
+            if (p < 0 || !owned(p)) break;
+            if (p == s)
+            {
+                loop = true;
+                first = s;
+                break;
+            }
+            first = p;
+        }
+
+        run.points.clear();
+        run.closed = loop;
+        const ContourSegment& head = segments[static_cast<size_t>(first)];
+        run.points.push_back(toPixel(head.ax, head.ay));
+        int last = first;
+        for (int cur = first;;)
+        {
+            const ContourSegment& seg = segments[static_cast<size_t>(cur)];
+            visited[static_cast<size_t>(cur)] = 1;
+            run.points.push_back(toPixel(seg.bx, seg.by));
+            last = cur;
+            const int nx = next(cur);
+            if (loop ? nx == first : (nx < 0 || !owned(nx))) break;
+            cur = nx;
+        }
+
+        Chain chain;
+        chain.loop = loop;
+        Contour simplified = m_tolerance >= 0.0f ? MarchingSquares::Simplify(run, m_tolerance) : run;
+        if (loop)
+        {
+            // Box2D 的环不重复首点，且至少需要四个点
+            simplified.points.pop_back();
+            if (simplified.points.size() < 4)
+            {
+                simplified.points.assign(run.points.begin(), run.points.end() - 1);
+            }
+            chain.points = std::move(simplified.points);
+        }
+        else
+        {
+            const int before = prev(first);
+            const int after = next(last);
+            const auto& a = run.points[0];
+            const auto& b = run.points[1];
+            const auto& y = run.points[run.points.size() - 2];
+            const auto& z = run.points.back();
+            chain.points.reserve(simplified.points.size() + 2);
+            if (before >= 0)
+                chain.points.push_back(toPixel(segments[static_cast<size_t>(before)].ax,
+                                               segments[static_cast<size_t>(before)].ay));
+            else
+                chain.points.push_back({2.0f * a.x - b.x, 2.0f * a.y - b.y});
+            chain.points.insert(chain.points.end(), simplified.points.begin(), simplified.points.end());
+            if (after >= 0)
+                chain.points.push_back(toPixel(segments[static_cast<size_t>(after)].bx,
+                                               segments[static_cast<size_t>(after)].by));
+            else
+                chain.points.push_back({2.0f * z.x - y.x, 2.0f * z.y - y.y});
+        }
+        chunk.chains.push_back(std::move(chain));
+    }
+}
@@ -0,0 +1,91 @@
+#ifndef PIXEL_COLLIDER_GRID_H
+#define PIXEL_COLLIDER_GRID_H
+
+#include "PixelTypes.h"
+#include "MarchingSquares.h"
+#include <array>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief 按区块增量维护像素世界的碰撞轮廓。
+ *
+ * 每个区块保存一张打包的实心位图（含向外两格的边框）和脏标记。Update 先并行重新打包所有区块的位图，
+ * 位图变化的区块再并行提取行进方块线段、串成折线并简化；未变化的区块保留上次的结果。
+ * 每个单元只属于一个区块，跨区块的轮廓在区块边界处断开成开链，两侧的端点完全相同，拼起来仍然闭合。
+ * 开链首尾各多带一个相邻区块中的点作为 Box2D 的幽灵点。
+ */
+class LUMA_API PixelColliderGrid
+{
+public:
+    static constexpr int ChunkSize = 32;
+
+    struct Chain
+    {
+        std::vector<ECS::Vector2f> points;  ///< 像素坐标；开链的首尾两点是幽灵点。
+        bool loop = false;
+    };
+
+    struct Stats
+    {
+        uint32_t totalChunks = 0;
+        uint32_t rebuiltChunks = 0;  ///< 上次 Update 重建轮廓的区块数。
+        uint32_t chains = 0;         ///< 重建区块产生的链数。
+    };
+
+    PixelColliderGrid() = default;
+    PixelColliderGrid(int width, int height);
+
+    void Resize(int width, int height);
+
+    /// 视为实心的像素类型掩码，第 t 位对应 PixelType t。
+    void SetSolidTypes(uint32_t typeMask);
+    /// Douglas-Peucker 容差（像素），负数表示不简化。
+    void SetSimplifyTolerance(float tolerance);
+    void MarkAllDirty();
+
+    /**
+     * @brief 用 width * height 个行主序像素刷新位图，并重建位图变化的区块。
+     */
+    void Update(const GPUPixel* pixels);
+
+    /// 上次 Update 重建的区块下标（cy * chunksX + cx），按下标递增。
+    const std::vector<int>& GetRebuiltChunks() const { return m_rebuilt; }
+    const std::vector<Chain>& GetChains(int chunkIndex) const;
+
+    int GetWidth() const { return m_width; }
+    int GetHeight() const { return m_height; }
+    int GetChunksX() const { return m_chunksX; }
+    int GetChunksY() const { return m_chunksY; }
+    const Stats& GetStats() const { return m_stats; }
+
+private:
+    /// 位图第 0 行/列对应区块左上角向外 MaskBorder 格。
+    static constexpr int MaskBorder = 2;
+    static constexpr int MaskSize = ChunkSize + 2 * MaskBorder;
+    static_assert(MaskSize <= 64, "chunk mask rows must fit in one word");
+
+    struct ChunkState
+    {
+        int x0 = 0;
+        int y0 = 0;
+        std::array<uint64_t, MaskSize> mask{};
+        bool dirty = true;
+        std::vector<Chain> chains;
+    };
+
+    bool PackMask(const GPUPixel* pixels, ChunkState& chunk) const;
+    void BuildChains(ChunkState& chunk, std::vector<ContourSegment>& segments) const;
+
+    int m_width = 0;
+    int m_height = 0;
+    int m_chunksX = 0;
+    int m_chunksY = 0;
+    uint32_t m_solidTypes = (1u << PixelType::Sand) | (1u << PixelType::Stone);
+    float m_tolerance = 0.5f;
+    std::vector<ChunkState> m_chunks;
+    std::vector<int> m_rebuilt;
+    Stats m_stats;
+};
+
+#endif
@@ -0,0 +1,226 @@
+#include "PixelEditBuffer.h"
+#include <algorithm>
+#include <cstdlib>
+
+PixelDirtyTiles::PixelDirtyTiles(int width, int height, int tileSize)
+{
+    Resize(width, height, tileSize);
+}
+
+void PixelDirtyTiles::Resize(int width, int height, int tileSize)
+{
+    m_width = std::max(width, 0);
+    m_height = std::max(height, 0);
+    m_tileSize = std::max(tileSize, 1);
+    m_tilesX = (m_width + m_tileSize - 1) / m_tileSize;
+    m_tilesY = (m_height + m_tileSize - 1) / m_tileSize;
+    m_tiles.assign(static_cast<size_t>(m_tilesX) * m_tilesY, PixelRect{});
+    m_empty = true;
+}
+
+void PixelDirtyTiles::Add(int minX, int minY, int maxX, int maxY)
+{
+    minX = std::max(minX, 0);
+    minY = std::max(minY, 0);
+    maxX = std::min(maxX, m_width - 1);
+    maxY = std::min(maxY, m_height - 1);
+    if (minX > maxX || minY > maxY) return;
+
+    for (int ty = minY / m_tileSize; ty <= maxY / m_tileSize; ty++)
+    {
+        const int y0 = std::max(minY, ty * m_tileSize);
+        const int y1 = std::min(maxY, ty * m_tileSize + m_tileSize - 1);
+        for (int tx = minX / m_tileSize; tx <= maxX / m_tileSize; tx++)
+        {
+            const int x0 = std::max(minX, tx * m_tileSize);
+            const int x1 = std::min(maxX, tx * m_tileSize + m_tileSize - 1);
+            m_tiles[static_cast<size_t>(ty) * m_tilesX + tx].Add(x0, y0, x1, y1);
+        }
+    }
+    m_empty = false;
+}
+
+void PixelDirtyTiles::AddAll()
+{
+    Add(0, 0, m_width - 1, m_height - 1);
+}
+
+void PixelDirtyTiles::Clear()
+{
+    if (m_empty) return;
+    std::fill(m_tiles.begin(), m_tiles.end(), PixelRect{});
+    m_empty = true;
+}
+
+void PixelEditBuffer::FillRect(int x, int y, int width, int height, PixelType::Value type, uint32_t replaceMask)
+{
+    if (width <= 0 || height <= 0) return;
+    m_commands.push_back({Shape::Rect, type, x, y, x + width - 1, y + height - 1, 0, replaceMask, 0u, 0u});
+}
+
+void PixelEditBuffer::FillCircle(int cx, int cy, int radius, PixelType::Value type, uint32_t replaceMask)
+{
+    if (radius < 0) return;
+    m_commands.push_back({Shape::Circle, type, cx, cy, cx, cy, radius, replaceMask, 0u, 0u});
+}
+
+void PixelEditBuffer::FillLine(int x0, int y0, int x1, int y1, int thickness, PixelType::Value type,
+                               uint32_t replaceMask)
+{
+    m_commands.push_back({Shape::Line, type, x0, y0, x1, y1, std::max(thickness, 0), replaceMask, 0u, 0u});
+}
+
+void PixelEditBuffer::Explode(int cx, int cy, int radius, uint32_t flags, uint32_t seed)
+{
+    m_commands.push_back({Shape::Explosion, PixelType::Air, cx, cy, cx, cy, std::max(radius, 1), AllTypes, flags,
+                          seed});
+}
+
+PixelRect PixelEditBuffer::GetBounds(const Command& command)
+{
+    switch (command.shape)
+    {
+    case Shape::Rect:
+        return {command.x0, command.y0, command.x1, command.y1};
+    case Shape::Circle:
+        return {command.x0 - command.size, command.y0 - command.size, command.x0 + command.size,
+                command.y0 + command.size};
+    case Shape::Line:
+    {
+        const int half = command.size / 2;
+        return {std::min(command.x0, command.x1) - half, std::min(command.y0, command.y1) - half,
+                std::max(command.x0, command.x1) + half, std::max(command.y0, command.y1) + half};
+    }
+    case Shape::Explosion:
+        return {command.x0 - command.size - 2, command.y0 - command.size - 2, command.x0 + command.size + 2,
+                command.y0 + command.size + 2};
+    }
+    return {};
+}
+
+PixelRect PixelEditBuffer::GetDirtyBounds() const
+{
+    PixelRect bounds;
+    for (const Command& command : m_commands)
+        bounds.Add(GetBounds(command));
+    return bounds;
+}
+
+int PixelEditBuffer::CircleHalfWidth(int radius, int dy)
+{
+    const int64_t rest = static_cast<int64_t>(radius) * radius - static_cast<int64_t>(dy) * dy;
+    if (rest < 0) return -1;
+    auto half = static_cast<int64_t>(std::sqrt(static_cast<double>(rest)));
+    while (half * half > rest) half--;
+    while ((half + 1) * (half + 1) <= rest) half++;
+    return static_cast<int>(half);
+}
+
+void PixelEditBuffer::BuildSpans(const Command& command, const PixelRect& bounds, std::vector<Span>& spans)
+{
+    spans.clear();
+    const PixelRect area = GetBounds(command).Intersect(bounds);
+    if (area.Empty()) return;
+
+    auto emit = [&](int y, int x0, int x1)
+    {
+        x0 = std::max(x0, area.minX);
+        x1 = std::min(x1, area.maxX);
+        if (x0 <= x1) spans.push_back({y, x0, x1});
+    };
+
+    switch (command.shape)
+    {
+    case Shape::Rect:
+        for (int y = area.minY; y <= area.maxY; y++)
+            emit(y, area.minX, area.maxX);
+        break;
+
+    case Shape::Circle:
+        for (int y = area.minY; y <= area.maxY; y++)
+        {
+            const int half = CircleHalfWidth(command.size, y - command.y0);
+            emit(y, command.x0 - half, command.x0 + half);
+        }
+        break;
+
+    case Shape::Line:
+    {
+        // Bresenham 直线每一步 x、y 至多变化 1，同一行上各点的正方形首尾相接，并集仍是一个区间
+        const int half = command.size / 2;
+        const PixelRect full = GetBounds(command);
+        const int rows = full.maxY - full.minY + 1;
+        std::vector<int> rowMin(static_cast<size_t>(rows), full.maxX + 1);
+        std::vector<int> rowMax(static_cast<size_t>(rows), full.minX - 1);
+
+        const int dx = std::abs(command.x1 - command.x0);
+        const int dy = -std::abs(command.y1 - command.y0);
+        const int sx = command.x0 < command.x1 ? 1 : -1;
+        const int sy = command.y0 < command.y1 ? 1 : -1;
+        int err = dx + dy;
+        int x = command.x0;
+        int y = command.y0;
+        for (;;)
+        {
+            for (int r = y - half - full.minY; r <= y + half - full.minY; r++)
+            {
+                rowMin[static_cast<size_t>(r)] = std::min(rowMin[static_cast<size_t>(r)], x - half);
+                rowMax[static_cast<size_t>(r)] = std::max(rowMax[static_cast<size_t>(r)], x + half);
+            }
+            if (x == command.x1 && y == command.y1) break;
+            const int e2 = 2 * err;
+            if (e2 >= dy) { err += dy; x += sx; }
+            if (e2 <= dx) { err += dx; y += sy; }
+        }
+
+        for (int row = area.minY; row <= area.maxY; row++)
+        {
+            const size_t r = static_cast<size_t>(row - full.minY);
+            emit(row, rowMin[r], rowMax[r]);
+        }
+        break;
+    }
+
+    case Shape::Explosion:
+        break;
+    }
+}
+
+uint32_t PixelEditBuffer::ExplosionRandom(uint32_t seed, int x, int y, uint32_t salt)
+{
+    uint32_t h = seed ^ (static_cast<uint32_t>(x) * 0x8da6b343u) ^ (static_cast<uint32_t>(y) * 0xd8163841u) ^
+                 (salt * 0xcb1ab31fu);
+    h ^= h >> 16;
+    h *= 0x45d9f3bu;
+    h ^= h >> 16;
+    h *= 0x45d9f3bu;
+    h ^= h >> 16;
+    return h;
+}
+
+PixelEditBuffer::Span PixelEditBuffer::FillRow(GPUPixel* row, int y, int x0, int x1, const GPUPixel& pixel,
+                                               uint32_t replaceMask)
+{
+    if (replaceMask == AllTypes)
+    {
+        std::fill(row + x0, row + x1 + 1, pixel);
+        return {y, x0, x1};
+    }
+
+    Span changed{y, x1 + 1, x0 - 1};
+    for (int x = x0; x <= x1; x++)
+    {
+        if ((replaceMask & TypeBit(row[x].pixel_type)) == 0) continue;
+        row[x] = pixel;
+        changed.x0 = std::min(changed.x0, x);
+        changed.x1 = x;
+    }
+    return changed;
+}
+
+void PixelBufferEditTarget::FillSpan(int y, int x0, int x1, const GPUPixel& pixel, uint32_t replaceMask)
+{
+    const auto changed =
+        PixelEditBuffer::FillRow(pixels + static_cast<size_t>(y) * width, y, x0, x1, pixel, replaceMask);
+    if (dirty && changed.x0 <= changed.x1) dirty->Add(changed.x0, y, changed.x1, y);
+}
@@ -0,0 +1,246 @@
+#ifndef PIXEL_EDIT_BUFFER_H
+#define PIXEL_EDIT_BUFFER_H
+
+#include "PixelTypes.h"
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief 把像素区域按 tileSize 划分为瓦片，每个瓦片记录一个脏矩形（像素坐标闭区间）。
+ */
+class PixelDirtyTiles
+{
+public:
+    PixelDirtyTiles() = default;
+    PixelDirtyTiles(int width, int height, int tileSize);
+
+    void Resize(int width, int height, int tileSize);
+    /// 裁剪到区域内后拆分到覆盖的瓦片。
+    void Add(int minX, int minY, int maxX, int maxY);
+    void AddAll();
+    void Clear();
+    bool Empty() const { return m_empty; }
+
+    int GetTileSize() const { return m_tileSize; }
+    int GetTilesX() const { return m_tilesX; }
+    int GetTilesY() const { return m_tilesY; }
+    const PixelRect& GetTile(int tileIndex) const { return m_tiles[static_cast<size_t>(tileIndex)]; }
+
+    /// 按瓦片行主序遍历非空的脏矩形，fn(tileIndex, rect)。
+    template <typename Fn>
+    void ForEach(Fn&& fn) const
+    {
+        if (m_empty) return;
+        for (size_t i = 0; i < m_tiles.size(); i++)
+        {
+            if (!m_tiles[i].Empty())
+                fn(static_cast<int>(i), m_tiles[i]);
+        }
+    }
+
+private:
+    int m_width = 0;
+    int m_height = 0;
+    int m_tileSize = 1;
+    int m_tilesX = 0;
+    int m_tilesY = 0;
+    std::vector<PixelRect> m_tiles;
+    bool m_empty = true;
+};
+
+/**
+ * @brief 像素编辑命令缓冲。
+ *
+ * 记录整块形状的编辑（矩形、圆、粗线、爆炸），之后一次性应用到像素存储上。填充类命令先逐行求出覆盖区间，
+ * 再整段写入；爆炸也只遍历圆内的行区间，逐像素规则与逐点实现一致。结果与按同样顺序逐个 SetPixel 完全相同。
+ */
+class PixelEditBuffer
+{
+public:
+    enum class Shape : uint8_t
+    {
+        Rect,
+        Circle,
+        Line,
+        Explosion
+    };
+
+    enum ExplosionFlags : uint32_t
+    {
+        ExplosionFire = 1u << 0,
+        ExplosionDebris = 1u << 1
+    };
+
+    static constexpr uint32_t AllTypes = 0xFFFFFFFFu;
+    /// 类型来自编辑命令和加载的数据，可能超过 31；与碰撞和岛屿的类型掩码一样只取低 5 位，避免越界移位。
+    static constexpr uint32_t TypeBit(uint32_t type) { return 1u << (type & 31u); }
+
+    struct Command
+    {
+        Shape shape;
+        PixelType::Value type;  ///< 填充的类型，爆炸不使用。
+        int x0, y0;             ///< Rect 的左上角；Circle/Explosion 的圆心；Line 的起点。
+        int x1, y1;             ///< Rect 的右下角（闭区间）；Line 的终点。
+        int size;               ///< Circle/Explosion 的半径；Line 的粗细。
+        uint32_t replaceMask;   ///< 只替换类型在掩码中的像素。
+        uint32_t flags;         ///< ExplosionFlags。
+        uint32_t seed;          ///< 爆炸的随机种子。
+    };
+
+    /// 一行中的像素闭区间。
+    struct Span
+    {
+        int y;
+        int x0;
+        int x1;
+    };
+
+    void FillRect(int x, int y, int width, int height, PixelType::Value type, uint32_t replaceMask = AllTypes);
+    void FillCircle(int cx, int cy, int radius, PixelType::Value type, uint32_t replaceMask = AllTypes);
+    /// 沿 Bresenham 直线的每个点填充边长 thickness / 2 * 2 + 1 的正方形。
+    void FillLine(int x0, int y0, int x1, int y1, int thickness, PixelType::Value type,
+                  uint32_t replaceMask = AllTypes);
+    void Explode(int cx, int cy, int radius, uint32_t flags, uint32_t seed);
+
+    const std::vector<Command>& GetCommands() const { return m_commands; }
+    size_t Size() const { return m_commands.size(); }
+    bool Empty() const { return m_commands.empty(); }
+    void Clear() { m_commands.clear(); }
+
+    /// 命令可能改动的像素包围盒，爆炸的碎屑最远落在半径外两格。
+    static PixelRect GetBounds(const Command& command);
+    /// 所有命令包围盒的并集。
+    PixelRect GetDirtyBounds() const;
+
+    /// 填充类命令在 bounds 内覆盖的行区间，按 y 递增。
+    static void BuildSpans(const Command& command, const PixelRect& bounds, std::vector<Span>& spans);
+
+    /// 把 row[x0..x1] 中类型在 replaceMask 内的像素替换为 pixel，返回实际改动的区间，x1 < x0 表示没有改动。
+    static Span FillRow(GPUPixel* row, int y, int x0, int x1, const GPUPixel& pixel, uint32_t replaceMask);
+
+    /// 爆炸使用的确定性随机数，salt 区分碎屑与火焰。
+    static uint32_t ExplosionRandom(uint32_t seed, int x, int y, uint32_t salt);
+
+    /**
+     * @brief 按记录顺序把命令应用到 target。Target 需要提供：
+     * - PixelRect GetBounds() const：可写的像素范围；
+     * - uint32_t GetType(int x, int y) const；
+     * - void Set(int x, int y, const GPUPixel& pixel)；
+     * - void FillSpan(int y, int x0, int x1, const GPUPixel& pixel, uint32_t replaceMask)。
+     */
+    template <typename Target>
+    void Apply(Target& target) const
+    {
+        const PixelRect bounds = target.GetBounds();
+        std::vector<Span> spans;
+        for (const Command& command : m_commands)
+        {
+            if (command.shape == Shape::Explosion)
+            {
+                ApplyExplosion(command, bounds, target);
+                continue;
+            }
+            BuildSpans(command, bounds, spans);
+            const GPUPixel pixel{static_cast<uint32_t>(command.type), DefaultPixelColor(command.type), 0.0f, 0.0f};
+            for (const Span& span : spans)
+                target.FillSpan(span.y, span.x0, span.x1, pixel, command.replaceMask);
+        }
+    }
+
+private:
+    /// 圆在第 dy 行的半宽，dy 超出半径时为 -1。
+    static int CircleHalfWidth(int radius, int dy);
+
+    template <typename Target>
+    static void ApplyExplosion(const Command& command, const PixelRect& bounds, Target& target)
+    {
+        const int cx = command.x0;
+        const int cy = command.y0;
+        const int pr = command.size;
+        auto inside = [&](int x, int y)
+        {
+            return x >= bounds.minX && x <= bounds.maxX && y >= bounds.minY && y <= bounds.maxY;
+        };
+        const GPUPixel air{PixelType::Air, DefaultPixelColor(PixelType::Air), 0.0f, 0.0f};
+        const GPUPixel sand{PixelType::Sand, DefaultPixelColor(PixelType::Sand), 0.0f, 0.0f};
+        const GPUPixel fire{PixelType::Fire, DefaultPixelColor(PixelType::Fire), 0.0f, 0.0f};
+        const bool createFire = (command.flags & ExplosionFire) != 0;
+        const bool createDebris = (command.flags & ExplosionDebris) != 0;
+
+        for (int dy = -pr; dy <= pr; ++dy)
+        {
+            const int half = CircleHalfWidth(pr, dy);
+            for (int dx = -half; dx <= half; ++dx)
+            {
+                const int px = cx + dx;
+                const int py = cy + dy;
+                if (!inside(px, py)) continue;
+                const float dist = std::sqrt(static_cast<float>(dx * dx + dy * dy));
+                if (dist > static_cast<float>(pr)) continue;
+
+                const uint32_t cur = target.GetType(px, py);
+                if (createFire && cur == PixelType::Oil)
+                {
+                    target.Set(px, py, fire);
+                    continue;
+                }
+                if (cur == PixelType::Air) continue;
+
+                // 边缘的固体有一定概率向外溅出一粒沙
+                const bool solid = cur == PixelType::Sand || cur == PixelType::Stone;
+                if (createDebris && solid && dist / static_cast<float>(pr) > 0.7f &&
+                    (ExplosionRandom(command.seed, px, py, 0) & 3u) == 0)
+                {
+                    const int ox = px + (dx > 0 ? 2 : -2);
+                    const int oy = py + (dy > 0 ? 2 : -2);
+                    if (inside(ox, oy) && target.GetType(ox, oy) == PixelType::Air)
+                        target.Set(ox, oy, sand);
+                }
+                target.Set(px, py, air);
+            }
+        }
+
+        if (!createFire) return;
+        const int fireR = pr / 3 > 1 ? pr / 3 : 1;
+        for (int dy = -fireR; dy <= fireR; ++dy)
+        {
+            const int half = CircleHalfWidth(fireR, dy);
+            for (int dx = -half; dx <= half; ++dx)
+            {
+                const int px = cx + dx;
+                const int py = cy + dy;
+                if (inside(px, py) && target.GetType(px, py) == PixelType::Air &&
+                    ExplosionRandom(command.seed, px, py, 1) % 3u == 0)
+                    target.Set(px, py, fire);
+            }
+        }
+    }
+
+    std::vector<Command> m_commands;
+};
+
+/**
+ * @brief 行主序像素数组上的编辑目标，改动记录到可选的 PixelDirtyTiles。
+ */
+struct PixelBufferEditTarget
+{
+    GPUPixel* pixels;
+    int width;
+    int height;
+    PixelDirtyTiles* dirty = nullptr;
+
+    PixelRect GetBounds() const { return {0, 0, width - 1, height - 1}; }
+
+    uint32_t GetType(int x, int y) const { return pixels[static_cast<size_t>(y) * width + x].pixel_type; }
+
+    void Set(int x, int y, const GPUPixel& pixel)
+    {
+        pixels[static_cast<size_t>(y) * width + x] = pixel;
+        if (dirty) dirty->Add(x, y, x, y);
+    }
+
+    void FillSpan(int y, int x0, int x1, const GPUPixel& pixel, uint32_t replaceMask);
+};
+
+#endif
@@ -2,6 +2,7 @@
 #define PIXEL_EXPLOSION_H
 
 #include "PixelWorld.h"
+#include "PixelEditBuffer.h"
 
 struct ExplosionParams
 {
@@ -11,11 +12,18 @@ struct ExplosionParams
     float force = 1.0f;
     bool createFire = true;
     bool createDebris = true;
+    uint32_t seed = 0; ///< 碎屑与火焰的随机种子，0 表示每次爆炸随机取一个。
 };
 
 class PixelExplosion
 {
 public:
+    /// 只记录到编辑缓冲，由调用方合并多次编辑后统一 ApplyEdits。
+    static void Explode(PixelEditBuffer& edits, const ExplosionParams& params, float pixelScale);
+    static void DestroyRect(PixelEditBuffer& edits, int startX, int startY, int w, int h);
+    static void FillCircle(PixelEditBuffer& edits, int cx, int cy, int radius, PixelType::Value type);
+    static void DestroyLine(PixelEditBuffer& edits, int x0, int y0, int x1, int y1, int thickness);
+
     static void Explode(PixelWorld& world, const ExplosionParams& params, float pixelScale);
     static void DestroyRect(PixelWorld& world, int startX, int startY, int w, int h);
     static void FillCircle(PixelWorld& world, int cx, int cy, int radius, PixelType::Value type);
@@ -0,0 +1,252 @@
+#include "PixelIslandLabeler.h"
+#include "../../Event/JobSystem.h"
+#include <algorithm>
+#include <unordered_map>
+
+namespace
+{
+    constexpr uint32_t Invalid = UINT32_MAX;
+
+    /// 区域内的瓦片，局部坐标闭区间。
+    struct Tile
+    {
+        int x0, y0, x1, y1;
+    };
+
+    struct PartialIsland
+    {
+        uint32_t root;
+        PixelRect bounds;  ///< 区域局部坐标。
+        uint32_t pixelCount;
+        bool anchored;
+    };
+}
+
+uint32_t PixelIslandLabeler::Find(uint32_t i)
+{
+    // 路径减半；并行阶段只会访问本瓦片内的下标
+    while (m_parent[i] != i)
+    {
+        m_parent[i] = m_parent[m_parent[i]];
+        i = m_parent[i];
+    }
+    return i;
+}
+
+void PixelIslandLabeler::Unite(uint32_t a, uint32_t b)
+{
+    a = Find(a);
+    b = Find(b);
+    if (a == b) return;
+    // 根总是连通块中下标最小的像素
+    if (a < b)
+        m_parent[b] = a;
+    else
+        m_parent[a] = b;
+}
+
+uint32_t PixelIslandLabeler::GetLabel(int x, int y) const
+{
+    if (m_region.Empty() || x < m_region.minX || x > m_region.maxX || y < m_region.minY || y > m_region.maxY)
+        return NoLabel;
+    return m_labels[static_cast<size_t>(y - m_region.minY) * m_regionWidth + (x - m_region.minX)];
+}
+
+void PixelIslandLabeler::Label(const GPUPixel* pixels, int width, int height, const PixelRect& region)
+{
+    m_islands.clear();
+    m_region = region.Intersect({0, 0, width - 1, height - 1});
+    if (m_region.Empty())
+    {
+        m_region = PixelRect{};
+        m_regionWidth = 0;
+        m_parent.clear();
+        m_labels.clear();
+        return;
+    }
+
+    const int rw = m_region.maxX - m_region.minX + 1;
+    const int rh = m_region.maxY - m_region.minY + 1;
+    const size_t count = static_cast<size_t>(rw) * rh;
+    m_regionWidth = rw;
+    m_parent.resize(count);
+    m_labels.resize(count);
+
+    const int tileSize = std::min(m_tileSize, std::max(rw, rh));
+    std::vector<Tile> tiles;
+    for (int y = 0; y < rh; y += tileSize)
+    {
+        for (int x = 0; x < rw; x += tileSize)
+            tiles.push_back({x, y, std::min(x + tileSize, rw) - 1, std::min(y + tileSize, rh) - 1});
+    }
+
+    struct LocalJob : public IJob
+    {
+        PixelIslandLabeler* labeler;
+        const GPUPixel* pixels;
+        int width;
+        Tile tile;
+
+        LocalJob(PixelIslandLabeler* l, const GPUPixel* p, int w, const Tile& t) : labeler(l), pixels(p), width(w), tile(t)
+        {
+        }
+
+        void Execute() override
+        {
+            auto& parent = labeler->m_parent;
+            const PixelRect& region = labeler->m_region;
+            const int rw = labeler->m_regionWidth;
+            for (int y = tile.y0; y <= tile.y1; y++)
+            {
+                const GPUPixel* row = pixels + static_cast<size_t>(y + region.minY) * width + region.minX;
+                const size_t rowBase = static_cast<size_t>(y) * rw;
+                for (int x = tile.x0; x <= tile.x1; x++)
+                {
+                    const auto i = static_cast<uint32_t>(rowBase + x);
+                    if (((labeler->m_solidTypes >> (row[x].pixel_type & 31u)) & 1u) == 0)
+                    {
+                        parent[i] = Invalid;
+                        continue;
+                    }
+                    // 左邻的根必然比 i 小，直接挂上去；上邻再合并
+                    parent[i] = x > tile.x0 && parent[i - 1] != Invalid ? labeler->Find(i - 1) : i;
+                    if (y > tile.y0 && parent[i - rw] != Invalid)
+                        labeler->Unite(i - static_cast<uint32_t>(rw), i);
+                }
+            }
+        }
+    };
+
+    struct ResolveJob : public IJob
+    {
+        PixelIslandLabeler* labeler;
+        Tile tile;
+        std::vector<PartialIsland> partials;
+
+        ResolveJob(PixelIslandLabeler* l, const Tile& t) : labeler(l), tile(t) {}
+
+        void Execute() override
+        {
+            // 只读 m_parent，不压缩路径，瓦片之间互不干扰
+            const auto& parent = labeler->m_parent;
+            auto& labels = labeler->m_labels;
+            const int rw = labeler->m_regionWidth;
+            const int rh = static_cast<int>(labels.size() / static_cast<size_t>(rw));
+            std::unordered_map<uint32_t, size_t> index;
+            uint32_t lastRoot = Invalid;
+            size_t last = 0;
+            for (int y = tile.y0; y <= tile.y1; y++)
+            {
+                for (int x = tile.x0; x <= tile.x1; x++)
+                {
+                    const auto i = static_cast<uint32_t>(static_cast<size_t>(y) * rw + x);
+                    uint32_t root = parent[i];
+                    if (root == Invalid)
+                    {
+                        labels[i] = Invalid;
+                        continue;
+                    }
+                    while (parent[root] != root)
+                        root = parent[root];
+                    labels[i] = root;
+
+                    if (root != lastRoot)
+                    {
+                        auto [it, inserted] = index.try_emplace(root, partials.size());
+                        if (inserted) partials.push_back({root, PixelRect{}, 0, false});
+                        lastRoot = root;
+                        last = it->second;
+                    }
+                    PartialIsland& partial = partials[last];
+                    partial.bounds.Add(x, y, x, y);
+                    partial.pixelCount++;
+                    partial.anchored |= x == 0 || y == 0 || x == rw - 1 || y == rh - 1;
+                }
+            }
+        }
+    };
+
+    struct RemapJob : public IJob
+    {
+        PixelIslandLabeler* labeler;
+        Tile tile;
+
+        RemapJob(PixelIslandLabeler* l, const Tile& t) : labeler(l), tile(t) {}
+
+        void Execute() override
+        {
+            const auto& islandOf = labeler->m_parent;
+            auto& labels = labeler->m_labels;
+            const int rw = labeler->m_regionWidth;
+            for (int y = tile.y0; y <= tile.y1; y++)
+            {
+                uint32_t* row = labels.data() + static_cast<size_t>(y) * rw;
+                for (int x = tile.x0; x <= tile.x1; x++)
+                    row[x] = row[x] == Invalid ? NoLabel : islandOf[row[x]] + 1;
+            }
+        }
+    };
+
+    std::vector<LocalJob> localJobs;
+    localJobs.reserve(tiles.size());
+    for (const Tile& tile : tiles)
+        localJobs.emplace_back(this, pixels, width, tile);
+    JobSystem::RunAll(localJobs);
+
+    // 沿瓦片边界合并，边界像素数只占总数的一小部分
+    for (int bx = tileSize; bx < rw; bx += tileSize)
+    {
+        for (int y = 0; y < rh; y++)
+        {
+            const auto i = static_cast<uint32_t>(static_cast<size_t>(y) * rw + bx);
+            if (m_parent[i] != Invalid && m_parent[i - 1] != Invalid) Unite(i - 1, i);
+        }
+    }
+    for (int by = tileSize; by < rh; by += tileSize)
+    {
+        for (int x = 0; x < rw; x++)
+        {
+            const auto i = static_cast<uint32_t>(static_cast<size_t>(by) * rw + x);
+            if (m_parent[i] != Invalid && m_parent[i - rw] != Invalid) Unite(i - static_cast<uint32_t>(rw), i);
+        }
+    }
+
+    std::vector<ResolveJob> resolveJobs;
+    resolveJobs.reserve(tiles.size());
+    for (const Tile& tile : tiles)
+        resolveJobs.emplace_back(this, tile);
+    JobSystem::RunAll(resolveJobs);
+
+    // 根是连通块中行主序第一个像素，按根排序即按首像素排序；之后 m_parent[root] 改存孤岛下标
+    std::vector<uint32_t> roots;
+    for (const ResolveJob& job : resolveJobs)
+    {
+        for (const PartialIsland& partial : job.partials)
+            roots.push_back(partial.root);
+    }
+    std::sort(roots.begin(), roots.end());
+    roots.erase(std::unique(roots.begin(), roots.end()), roots.end());
+    m_islands.resize(roots.size());
+    for (size_t k = 0; k < roots.size(); k++)
+    {
+        m_parent[roots[k]] = static_cast<uint32_t>(k);
+        m_islands[k].firstIndex = roots[k];
+    }
+    for (const ResolveJob& job : resolveJobs)
+    {
+        for (const PartialIsland& partial : job.partials)
+        {
+            PixelIsland& island = m_islands[m_parent[partial.root]];
+            island.bounds.Add(partial.bounds.minX + m_region.minX, partial.bounds.minY + m_region.minY,
+                              partial.bounds.maxX + m_region.minX, partial.bounds.maxY + m_region.minY);
+            island.pixelCount += partial.pixelCount;
+            island.anchored |= partial.anchored;
+        }
+    }
+
+    std::vector<RemapJob> remapJobs;
+    remapJobs.reserve(tiles.size());
+    for (const Tile& tile : tiles)
+        remapJobs.emplace_back(this, tile);
+    JobSystem::RunAll(remapJobs);
+}
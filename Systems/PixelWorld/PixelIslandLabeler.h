@@ -0,0 +1,64 @@
+#ifndef PIXEL_ISLAND_LABELER_H
+#define PIXEL_ISLAND_LABELER_H
+
+#include "PixelTypes.h"
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief 一个 4 连通的实心像素连通块。
+ */
+struct PixelIsland
+{
+    PixelRect bounds;         ///< 世界像素坐标闭区间。
+    uint32_t pixelCount = 0;
+    uint32_t firstIndex = 0;  ///< 区域内按行主序第一个像素的下标。
+    bool anchored = false;    ///< 接触分析区域的边界，可能与区域外的地形相连。
+};
+
+/**
+ * @brief 在像素区域内做连通块标记，找出与外部地形断开的孤岛。
+ *
+ * 区域按 TileSize 划分为瓦片，每个瓦片在工作线程上独立做并查集（父节点总指向下标更小的像素），
+ * 再在主线程上沿瓦片边界合并，最后并行求根并统计各连通块。区域边界之外的情况无从得知，
+ * 接触边界的连通块一律视为锚定，因此区域应比改动范围大出一圈。
+ */
+class LUMA_API PixelIslandLabeler
+{
+public:
+    static constexpr int DefaultTileSize = 64;
+    static constexpr uint32_t NoLabel = 0;
+
+    void SetSolidTypes(uint32_t typeMask) { m_solidTypes = typeMask; }
+    uint32_t GetSolidTypes() const { return m_solidTypes; }
+    /// 瓦片边长（像素），小于 1 时按 1 处理；整个区域只有一个瓦片时在调用线程上执行。
+    void SetTileSize(int tileSize) { m_tileSize = tileSize < 1 ? 1 : tileSize; }
+
+    /**
+     * @brief 标记 width * height 个行主序像素中 region（裁剪到像素范围内）的连通块。
+     */
+    void Label(const GPUPixel* pixels, int width, int height, const PixelRect& region);
+
+    /// 实际分析的区域，可能为空。
+    const PixelRect& GetRegion() const { return m_region; }
+    /// 按第一个像素的行主序排列。
+    const std::vector<PixelIsland>& GetIslands() const { return m_islands; }
+    /// 区域内的行主序标签，0 表示非实心，否则为孤岛下标 + 1。
+    const std::vector<uint32_t>& GetLabels() const { return m_labels; }
+    /// 世界像素坐标处的标签，区域外返回 NoLabel。
+    uint32_t GetLabel(int x, int y) const;
+
+private:
+    uint32_t Find(uint32_t i);
+    void Unite(uint32_t a, uint32_t b);
+
+    uint32_t m_solidTypes = 1u << PixelType::Stone;
+    int m_tileSize = DefaultTileSize;
+    PixelRect m_region;
+    int m_regionWidth = 0;
+    std::vector<uint32_t> m_parent;
+    std::vector<uint32_t> m_labels;
+    std::vector<PixelIsland> m_islands;
+};
+
+#endif
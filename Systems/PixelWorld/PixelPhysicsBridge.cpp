@@ -1,8 +1,12 @@
 #include "PixelPhysicsBridge.h"
+#include "MarchingSquares.h"
 #include <cmath>
 #include <algorithm>
 
 std::unordered_map<PixelChunkKey, PixelChunkBody, PixelChunkKeyHash> PixelPhysicsBridge::s_chunkBodies;
+PixelColliderGrid PixelPhysicsBridge::s_colliders;
+float PixelPhysicsBridge::s_colliderScale = 0.0f;
+PixelIslandLabeler PixelPhysicsBridge::s_islands;
 
 bool PixelPhysicsBridge::IsSolidPixel(uint32_t pixelType)
 {
@@ -28,27 +32,10 @@ void PixelPhysicsBridge::ApplyRigidbodyDamage(PixelWorld& world, float worldX, f
     int centerY = static_cast<int>(worldY / pixelScale);
     int pixelRadius = static_cast<int>(std::ceil(radius / pixelScale));
 
-    int w = static_cast<int>(world.GetWidth());
-    int h = static_cast<int>(world.GetHeight());
-
-    for (int dy = -pixelRadius; dy <= pixelRadius; ++dy)
-    {
-        for (int dx = -pixelRadius; dx <= pixelRadius; ++dx)
-        {
-            if (dx * dx + dy * dy > pixelRadius * pixelRadius)
-                continue;
-
-            int px = centerX + dx;
-            int py = centerY + dy;
-            if (px < 0 || py < 0 || px >= w || py >= h)
-                continue;
-
-            if (IsSolidPixel(world.GetPixel(px, py)))
-            {
-                world.SetPixel(px, py, PixelType::Air);
-            }
-        }
-    }
+    PixelEditBuffer edits;
+    edits.FillCircle(centerX, centerY, pixelRadius, PixelType::Air,
+                     PixelEditBuffer::TypeBit(PixelType::Sand) | PixelEditBuffer::TypeBit(PixelType::Stone));
+    world.ApplyEdits(edits);
 }
 
 std::vector<b2Vec2> PixelPhysicsBridge::TraceEdges(PixelWorld& world, int startX, int startY,
@@ -125,56 +112,271 @@ b2ChainId PixelPhysicsBridge::CreateChainFromPixels(PixelWorld& world, b2BodyId
     return b2CreateChain(body, &chainDef);
 }
 
+void PixelPhysicsBridge::DestroyChunkBody(PixelChunkBody& chunkBody)
+{
+    for (b2ChainId chain : chunkBody.chains)
+        b2DestroyChain(chain);
+    chunkBody.chains.clear();
+    if (B2_IS_NON_NULL(chunkBody.body))
+        b2DestroyBody(chunkBody.body);
+    chunkBody.body = b2_nullBodyId;
+}
+
 void PixelPhysicsBridge::SyncPixelWorldToPhysics(PixelWorld& world, b2WorldId physicsWorld, float pixelScale)
 {
     int w = static_cast<int>(world.GetWidth());
     int h = static_cast<int>(world.GetHeight());
-    int chunksX = (w + CHUNK_SIZE - 1) / CHUNK_SIZE;
-    int chunksY = (h + CHUNK_SIZE - 1) / CHUNK_SIZE;
 
-    for (int cy = 0; cy < chunksY; ++cy)
+    if (s_colliders.GetWidth() != w || s_colliders.GetHeight() != h)
     {
-        for (int cx = 0; cx < chunksX; ++cx)
-        {
-            PixelChunkKey key{cx, cy};
+        for (auto& [key, chunkBody] : s_chunkBodies)
+            DestroyChunkBody(chunkBody);
+        s_chunkBodies.clear();
+        s_colliders.SetSolidTypes((1u << PixelType::Sand) | (1u << PixelType::Stone));
+        s_colliders.Resize(w, h);
+    }
+    if (s_colliderScale != pixelScale)
+    {
+        s_colliderScale = pixelScale;
+        s_colliders.MarkAllDirty();
+    }
 
+    s_colliders.Update(world.GetPixels());
+
+    int chunksX = s_colliders.GetChunksX();
+    std::vector<b2Vec2> points;
+    for (int index : s_colliders.GetRebuiltChunks())
+    {
+        PixelChunkKey key{index % chunksX, index / chunksX};
+        const auto& chains = s_colliders.GetChains(index);
+
+        if (chains.empty())
+        {
             auto it = s_chunkBodies.find(key);
             if (it != s_chunkBodies.end())
             {
-                if (B2_IS_NON_NULL(it->second.chain))
-                    b2DestroyChain(it->second.chain);
-                if (B2_IS_NON_NULL(it->second.body))
-                    b2DestroyBody(it->second.body);
+                DestroyChunkBody(it->second);
                 s_chunkBodies.erase(it);
             }
+            continue;
+        }
 
-            int startX = cx * CHUNK_SIZE;
-            int startY = cy * CHUNK_SIZE;
-            int regionW = std::min(CHUNK_SIZE, w - startX);
-            int regionH = std::min(CHUNK_SIZE, h - startY);
-
-            bool hasSolid = false;
-            for (int y = startY; y < startY + regionH && !hasSolid; ++y)
-                for (int x = startX; x < startX + regionW && !hasSolid; ++x)
-                    hasSolid = IsSolidPixel(world.GetPixel(x, y));
-
-            if (!hasSolid) continue;
-
+        PixelChunkBody& chunkBody = s_chunkBodies[key];
+        for (b2ChainId chain : chunkBody.chains)
+            b2DestroyChain(chain);
+        chunkBody.chains.clear();
+        if (B2_IS_NULL(chunkBody.body))
+        {
             b2BodyDef bodyDef = b2DefaultBodyDef();
             bodyDef.type = b2_staticBody;
             bodyDef.position = {0.0f, 0.0f};
-            b2BodyId body = b2CreateBody(physicsWorld, &bodyDef);
+            chunkBody.body = b2CreateBody(physicsWorld, &bodyDef);
+        }
+
+        for (const auto& chain : chains)
+        {
+            points.clear();
+            for (const auto& p : chain.points)
+                points.push_back({p.x * pixelScale, p.y * pixelScale});
+
+            b2ChainDef chainDef = b2DefaultChainDef();
+            chainDef.points = points.data();
+            chainDef.count = static_cast<int>(points.size());
+            chainDef.isLoop = chain.loop;
+            chunkBody.chains.push_back(b2CreateChain(chunkBody.body, &chainDef));
+        }
+    }
+}
+
+std::vector<PixelDebris> PixelPhysicsBridge::ApplyExplosion(PixelWorld& world, b2WorldId physicsWorld,
+                                                            const ExplosionParams& params, float pixelScale)
+{
+    PixelEditBuffer edits;
+    PixelExplosion::Explode(edits, params, pixelScale);
+    world.ApplyEdits(edits);
+    return ExtractDebris(world, physicsWorld, edits.GetDirtyBounds(), pixelScale);
+}
+
+std::vector<PixelDebris> PixelPhysicsBridge::ExtractDebris(PixelWorld& world, b2WorldId physicsWorld,
+                                                           const PixelRect& dirtyRegion, float pixelScale,
+                                                           uint32_t minPixels)
+{
+    std::vector<PixelDebris> debris;
+    if (dirtyRegion.Empty() || pixelScale <= 0.0f) return debris;
+
+    const int w = static_cast<int>(world.GetWidth());
+    const int h = static_cast<int>(world.GetHeight());
+    PixelRect region{dirtyRegion.minX - DebrisSearchMargin, dirtyRegion.minY - DebrisSearchMargin,
+                     dirtyRegion.maxX + DebrisSearchMargin, dirtyRegion.maxY + DebrisSearchMargin};
+    s_islands.SetSolidTypes(1u << PixelType::Stone);
+    s_islands.Label(world.GetPixels(), w, h, region);
 
-            b2ChainId chain = CreateChainFromPixels(world, body, startX, startY, regionW, regionH, pixelScale);
+    const GPUPixel* pixels = world.GetPixels();
+    const PixelRect& labeled = s_islands.GetRegion();
+    const std::vector<uint32_t>& labels = s_islands.GetLabels();
+    const int labeledWidth = labeled.maxX - labeled.minX + 1;
+    const uint32_t solidMask = s_islands.GetSolidTypes();
 
-            if (B2_IS_NON_NULL(chain))
+    PixelEditBuffer edits;
+    std::vector<uint8_t> mask;
+    const auto& islands = s_islands.GetIslands();
+    for (size_t k = 0; k < islands.size(); k++)
+    {
+        const PixelIsland& island = islands[k];
+        if (island.anchored) continue;
+        const auto label = static_cast<uint32_t>(k + 1);
+        const bool small = island.pixelCount < minPixels;
+
+        PixelDebris piece;
+        piece.originX = island.bounds.minX;
+        piece.originY = island.bounds.minY;
+        piece.width = island.bounds.maxX - island.bounds.minX + 1;
+        piece.height = island.bounds.maxY - island.bounds.minY + 1;
+        if (!small)
+        {
+            piece.sprite.assign(static_cast<size_t>(piece.width) * piece.height, GPUPixel{0, 0, 0.0f, 0.0f});
+            mask.assign(piece.sprite.size(), 0);
+        }
+
+        // 逐行找出属于孤岛的区间：拷贝进精灵，并从世界中移除（碎屑改为沙子）
+        for (int y = island.bounds.minY; y <= island.bounds.maxY; y++)
+        {
+            const uint32_t* labelRow = labels.data() + static_cast<size_t>(y - labeled.minY) * labeledWidth;
+            for (int x = island.bounds.minX; x <= island.bounds.maxX;)
             {
-                s_chunkBodies[key] = {body, chain};
+                if (labelRow[x - labeled.minX] != label)
+                {
+                    x++;
+                    continue;
+                }
+                int end = x;
+                while (end < island.bounds.maxX && labelRow[end + 1 - labeled.minX] == label)
+                    end++;
+                edits.FillRect(x, y, end - x + 1, 1, small ? PixelType::Sand : PixelType::Air, solidMask);
+                if (!small)
+                {
+                    const size_t dst = static_cast<size_t>(y - piece.originY) * piece.width + (x - piece.originX);
+                    std::copy(pixels + static_cast<size_t>(y) * w + x, pixels + static_cast<size_t>(y) * w + end + 1,
+                              piece.sprite.begin() + static_cast<std::ptrdiff_t>(dst));
+                    std::fill(mask.begin() + static_cast<std::ptrdiff_t>(dst),
+                              mask.begin() + static_cast<std::ptrdiff_t>(dst + (end - x + 1)), 1);
+                }
+                x = end + 1;
+            }
+        }
+        if (small) continue;
+
+        BuildDebrisOutlines(piece, mask);
+        CreateDebrisBody(piece, mask, physicsWorld, pixelScale);
+        debris.push_back(std::move(piece));
+    }
+
+    world.ApplyEdits(edits);
+    return debris;
+}
+
+void PixelPhysicsBridge::BuildDebrisOutlines(PixelDebris& debris, const std::vector<uint8_t>& mask)
+{
+    // 位图四周各留一格空白，所有轮廓都闭合；采样点 (i, j) 对应精灵像素 (i - 1, j - 1) 的中心
+    const int cols = debris.width + 2;
+    const int rows = debris.height + 2;
+    const int wordsPerRow = (cols + 63) / 64;
+    std::vector<uint64_t> bits(static_cast<size_t>(wordsPerRow) * rows, 0);
+    for (int y = 0; y < debris.height; y++)
+    {
+        for (int x = 0; x < debris.width; x++)
+        {
+            if (!mask[static_cast<size_t>(y) * debris.width + x]) continue;
+            const int c = x + 1;
+            bits[static_cast<size_t>(y + 1) * wordsPerRow + c / 64] |= 1ull << (c % 64);
+        }
+    }
+
+    std::vector<ContourSegment> segments;
+    MarchingSquares::ExtractSegments(bits.data(), wordsPerRow, 0, 0, cols - 2, rows - 2, segments);
+
+    const int stride = 2 * cols + 1;
+    std::vector<int> startAt(static_cast<size_t>(stride) * (2 * rows + 1), -1);
+    for (size_t i = 0; i < segments.size(); i++)
+        startAt[static_cast<size_t>(segments[i].ay) * stride + segments[i].ax] = static_cast<int>(i);
+
+    std::vector<uint8_t> visited(segments.size(), 0);
+    Contour loop;
+    for (size_t s = 0; s < segments.size(); s++)
+    {
+        if (visited[s]) continue;
+        loop.points.clear();
+        loop.closed = true;
+        loop.points.push_back({segments[s].ax * 0.5f - 0.5f, segments[s].ay * 0.5f - 0.5f});
+        for (int cur = static_cast<int>(s); cur >= 0 && !visited[static_cast<size_t>(cur)];)
+        {
+            const ContourSegment& seg = segments[static_cast<size_t>(cur)];
+            visited[static_cast<size_t>(cur)] = 1;
+            loop.points.push_back({seg.bx * 0.5f - 0.5f, seg.by * 0.5f - 0.5f});
+            cur = startAt[static_cast<size_t>(seg.by) * stride + seg.bx];
+        }
+
+        Contour simplified = MarchingSquares::Simplify(loop, 0.5f);
+        simplified.points.pop_back();
+        if (simplified.points.size() < 3)
+            simplified.points.assign(loop.points.begin(), loop.points.end() - 1);
+        debris.outlines.push_back(std::move(simplified.points));
+    }
+}
+
+void PixelPhysicsBridge::CreateDebrisBody(PixelDebris& debris, const std::vector<uint8_t>& mask,
+                                          b2WorldId physicsWorld, float pixelScale)
+{
+    b2BodyDef bodyDef = b2DefaultBodyDef();
+    bodyDef.type = b2_dynamicBody;
+    bodyDef.position = {debris.originX * pixelScale, debris.originY * pixelScale};
+    debris.body = b2CreateBody(physicsWorld, &bodyDef);
+
+    b2ShapeDef shapeDef = b2DefaultShapeDef();
+    auto addBox = [&](int x0, int x1, int y0, int y1)
+    {
+        const float hw = (x1 - x0 + 1) * pixelScale * 0.5f;
+        const float hh = (y1 - y0 + 1) * pixelScale * 0.5f;
+        const b2Polygon box = b2MakeOffsetBox(hw, hh, {x0 * pixelScale + hw, y0 * pixelScale + hh}, b2MakeRot(0.0f));
+        b2CreatePolygonShape(debris.body, &shapeDef, &box);
+    };
+
+    // 每行的连续区间作为矩形，与上一行完全相同的区间向下延长
+    struct OpenBox
+    {
+        int x0, x1, y0;
+    };
+    std::vector<OpenBox> open;
+    std::vector<OpenBox> next;
+    for (int y = 0; y <= debris.height; y++)
+    {
+        next.clear();
+        for (int x = 0; y < debris.height && x < debris.width;)
+        {
+            if (!mask[static_cast<size_t>(y) * debris.width + x])
+            {
+                x++;
+                continue;
+            }
+            int end = x;
+            while (end + 1 < debris.width && mask[static_cast<size_t>(y) * debris.width + end + 1])
+                end++;
+            auto it = std::find_if(open.begin(), open.end(), [&](const OpenBox& b) { return b.x0 == x && b.x1 == end; });
+            if (it != open.end())
+            {
+                next.push_back(*it);
+                it->x1 = -1;
             }
             else
             {
-                b2DestroyBody(body);
+                next.push_back({x, end, y});
             }
+            x = end + 1;
+        }
+        for (const OpenBox& b : open)
+        {
+            if (b.x1 >= 0) addBox(b.x0, b.x1, b.y0, y - 1);
         }
+        std::swap(open, next);
     }
 }
@@ -2,6 +2,9 @@
 #define PIXEL_PHYSICS_BRIDGE_H
 
 #include "PixelWorld.h"
+#include "PixelColliderGrid.h"
+#include "PixelExplosion.h"
+#include "PixelIslandLabeler.h"
 #include <box2d/box2d.h>
 #include <vector>
 #include <unordered_map>
@@ -23,18 +26,53 @@ struct PixelChunkKeyHash
 struct PixelChunkBody
 {
     b2BodyId body = b2_nullBodyId;
-    b2ChainId chain = b2_nullChainId;
+    std::vector<b2ChainId> chains;
+};
+
+/**
+ * @brief 从像素世界剥离出来、转换为动态刚体的一块碎片。
+ */
+struct PixelDebris
+{
+    b2BodyId body = b2_nullBodyId;
+    int originX = 0;  ///< 精灵左上角的世界像素坐标，刚体初始位置与之对应。
+    int originY = 0;
+    int width = 0;
+    int height = 0;
+    std::vector<GPUPixel> sprite;  ///< width * height 个行主序像素，不属于碎片的为 Air。
+    std::vector<std::vector<ECS::Vector2f>> outlines;  ///< 简化后的闭合轮廓，相对精灵左上角的像素坐标。
 };
 
 class LUMA_API PixelPhysicsBridge
 {
 public:
-    static constexpr int CHUNK_SIZE = 32;
+    static constexpr int CHUNK_SIZE = PixelColliderGrid::ChunkSize;
+    /// 碎片检测在改动范围外多看的像素数，更大的孤岛接触检测边界，视为仍与地形相连。
+    static constexpr int DebrisSearchMargin = 48;
+    static constexpr uint32_t DefaultMinDebrisPixels = 6;
 
+    /**
+     * @brief 只为实心位图变化的区块重建碰撞链。
+     *
+     * 轮廓在工作线程上按区块并行提取和简化，主线程只销毁并重建这些区块的 Box2D 链。
+     */
     static void SyncPixelWorldToPhysics(PixelWorld& world, b2WorldId physicsWorld, float pixelScale);
 
     static void ApplyRigidbodyDamage(PixelWorld& world, float worldX, float worldY, float radius, float pixelScale);
 
+    /**
+     * @brief 在 dirtyRegion 外扩 DebrisSearchMargin 的范围内找出不再与地形相连的石头孤岛，从像素世界中移除，
+     * 转换为动态刚体。碰撞形状是按像素行合并出的矩形，轮廓与精灵交给调用方渲染；
+     * 不足 minPixels 的碎屑改为沙子，交给模拟自然落下。
+     */
+    static std::vector<PixelDebris> ExtractDebris(PixelWorld& world, b2WorldId physicsWorld,
+                                                  const PixelRect& dirtyRegion, float pixelScale,
+                                                  uint32_t minPixels = DefaultMinDebrisPixels);
+
+    /// 应用爆炸，再对爆炸改动的范围做碎片检测。
+    static std::vector<PixelDebris> ApplyExplosion(PixelWorld& world, b2WorldId physicsWorld,
+                                                   const ExplosionParams& params, float pixelScale);
+
     static bool IsPixelSolid(const PixelWorld& world, float worldX, float worldY, float pixelScale);
 
     static b2ChainId CreateChainFromPixels(PixelWorld& world, b2BodyId body,
@@ -45,7 +83,15 @@ private:
     static bool IsSolidPixel(uint32_t pixelType);
     static std::vector<b2Vec2> TraceEdges(PixelWorld& world, int startX, int startY, int regionW, int regionH, float pixelScale);
 
+    static void DestroyChunkBody(PixelChunkBody& chunkBody);
+    static void BuildDebrisOutlines(PixelDebris& debris, const std::vector<uint8_t>& mask);
+    static void CreateDebrisBody(PixelDebris& debris, const std::vector<uint8_t>& mask, b2WorldId physicsWorld,
+                                 float pixelScale);
+
     static std::unordered_map<PixelChunkKey, PixelChunkBody, PixelChunkKeyHash> s_chunkBodies;
+    static PixelColliderGrid s_colliders;
+    static float s_colliderScale;
+    static PixelIslandLabeler s_islands;
 };
 
 #endif
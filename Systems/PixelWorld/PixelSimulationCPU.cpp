@@ -0,0 +1,422 @@
+#include "PixelSimulationCPU.h"
+#include "../../Event/JobSystem.h"
+#include <algorithm>
+
+namespace
+{
+    constexpr GPUPixel AirPixel{PixelType::Air, 0u, 0.0f, 0.0f};
+
+    /// 与 pixel_physics.wgsl 中的 hash 相同。
+    uint32_t Hash(uint32_t s)
+    {
+        s ^= s >> 16u;
+        s *= 0x45d9f3bu;
+        s ^= s >> 16u;
+        s *= 0x45d9f3bu;
+        s ^= s >> 16u;
+        return s;
+    }
+
+    bool IsLiquid(uint32_t type)
+    {
+        return type == PixelType::Water || type == PixelType::Oil || type == PixelType::Lava;
+    }
+
+    /**
+     * @brief 把缓冲坐标闭区间 [a, b] 转成至多两段逻辑区间写入 out，返回段数。
+     * 原点为 0 时缓冲与逻辑坐标相同，越界部分直接裁掉；否则越过缓冲边缘的部分环绕到另一侧。
+     */
+    int ToLogicalRanges(int a, int b, uint32_t origin, uint32_t size, int out[4])
+    {
+        const int n = static_cast<int>(size);
+        if (origin == 0)
+        {
+            a = std::max(a, 0);
+            b = std::min(b, n - 1);
+            if (a > b) return 0;
+            out[0] = a;
+            out[1] = b;
+            return 1;
+        }
+        if (a > b) return 0;
+        if (b - a + 1 >= n)
+        {
+            out[0] = 0;
+            out[1] = n - 1;
+            return 1;
+        }
+        const int start = ((a - static_cast<int>(origin)) % n + n) % n;
+        const int end = start + (b - a);
+        out[0] = start;
+        out[1] = std::min(end, n - 1);
+        if (end < n) return 1;
+        out[2] = 0;
+        out[3] = end - n;
+        return 2;
+    }
+}
+
+PixelSimulationCPU::PixelSimulationCPU(uint32_t width, uint32_t height, uint32_t seed)
+    : m_width(width)
+    , m_height(height)
+    , m_seed(seed)
+    , m_chunksX(static_cast<int>((width + ChunkSize - 1) / ChunkSize))
+    , m_chunksY(static_cast<int>((height + ChunkSize - 1) / ChunkSize))
+{
+    m_chunks.resize(static_cast<size_t>(m_chunksX) * m_chunksY);
+    for (int cy = 0; cy < m_chunksY; cy++)
+    {
+        for (int cx = 0; cx < m_chunksX; cx++)
+        {
+            m_chunks[static_cast<size_t>(cy) * m_chunksX + cx].bounds =
+                PixelRect{cx * ChunkSize, cy * ChunkSize, std::min((cx + 1) * ChunkSize, static_cast<int>(width)) - 1,
+                          std::min((cy + 1) * ChunkSize, static_cast<int>(height)) - 1};
+        }
+    }
+    m_stamps.resize(static_cast<size_t>(width) * height, 0u);
+    m_stats.totalChunks = static_cast<uint32_t>(m_chunks.size());
+    WakeAll();
+}
+
+void PixelSimulationCPU::MarkDirty(int minX, int minY, int maxX, int maxY)
+{
+    int xs[4];
+    int ys[4];
+    const int nx = ToLogicalRanges(minX, maxX, m_originX, m_width, xs);
+    const int ny = ToLogicalRanges(minY, maxY, m_originY, m_height, ys);
+    for (int j = 0; j < ny; j++)
+        for (int i = 0; i < nx; i++)
+            MarkLogical({xs[2 * i], ys[2 * j], xs[2 * i + 1], ys[2 * j + 1]});
+}
+
+void PixelSimulationCPU::MarkLogical(const PixelRect& rect)
+{
+    for (int cy = rect.minY / ChunkSize; cy <= rect.maxY / ChunkSize; cy++)
+    {
+        for (int cx = rect.minX / ChunkSize; cx <= rect.maxX / ChunkSize; cx++)
+        {
+            ChunkState& chunk = m_chunks[static_cast<size_t>(cy) * m_chunksX + cx];
+            chunk.current.Add(chunk.bounds.Intersect(rect));
+        }
+    }
+}
+
+void PixelSimulationCPU::SetOrigin(uint32_t x, uint32_t y)
+{
+    x %= m_width;
+    y %= m_height;
+    if (x == m_originX && y == m_originY) return;
+
+    // 内容在缓冲中不动，逻辑坐标整体平移 (-dx, -dy)
+    const int dx = static_cast<int>(x) - static_cast<int>(m_originX);
+    const int dy = static_cast<int>(y) - static_cast<int>(m_originY);
+    m_originX = x;
+    m_originY = y;
+    if (dx % ChunkSize != 0 || dy % ChunkSize != 0 || m_width % ChunkSize != 0 || m_height % ChunkSize != 0)
+    {
+        WakeAll();
+        return;
+    }
+
+    // 区块对齐时把每个区块的脏矩形搬到内容所在的新逻辑区块
+    const int shiftX = dx / ChunkSize;
+    const int shiftY = dy / ChunkSize;
+    std::vector<PixelRect> moved(m_chunks.size());
+    for (int cy = 0; cy < m_chunksY; cy++)
+    {
+        for (int cx = 0; cx < m_chunksX; cx++)
+        {
+            const PixelRect& rect = m_chunks[static_cast<size_t>(cy) * m_chunksX + cx].current;
+            if (rect.Empty()) continue;
+            const int tx = ((cx - shiftX) % m_chunksX + m_chunksX) % m_chunksX;
+            const int ty = ((cy - shiftY) % m_chunksY + m_chunksY) % m_chunksY;
+            const int ox = (tx - cx) * ChunkSize;
+            const int oy = (ty - cy) * ChunkSize;
+            moved[static_cast<size_t>(ty) * m_chunksX + tx] =
+                PixelRect{rect.minX + ox, rect.minY + oy, rect.maxX + ox, rect.maxY + oy};
+        }
+    }
+    for (size_t i = 0; i < m_chunks.size(); i++)
+        m_chunks[i].current = moved[i];
+
+    // 旧接缝两侧的像素现在互为邻居，可能不再稳定
+    const int w = static_cast<int>(m_width);
+    const int h = static_cast<int>(m_height);
+    if (dx != 0)
+    {
+        const int seam = ((-dx) % w + w) % w;
+        const int left = (seam + w - 1) % w;
+        MarkLogical({left, 0, left, h - 1});
+        MarkLogical({seam, 0, seam, h - 1});
+    }
+    if (dy != 0)
+    {
+        const int seam = ((-dy) % h + h) % h;
+        const int top = (seam + h - 1) % h;
+        MarkLogical({0, top, w - 1, top});
+        MarkLogical({0, seam, w - 1, seam});
+    }
+}
+
+void PixelSimulationCPU::WakeAll()
+{
+    for (ChunkState& chunk : m_chunks)
+        chunk.current = chunk.bounds;
+}
+
+bool PixelSimulationCPU::IsChunkAwake(int cx, int cy) const
+{
+    if (cx < 0 || cy < 0 || cx >= m_chunksX || cy >= m_chunksY) return false;
+    return !m_chunks[static_cast<size_t>(cy) * m_chunksX + cx].current.Empty();
+}
+
+void PixelSimulationCPU::Step(GPUPixel* pixels, float dt)
+{
+    struct ChunkJob : public IJob
+    {
+        PixelSimulationCPU* simulation;
+        GPUPixel* pixels;
+        ChunkState* chunk;
+        float dt;
+
+        ChunkJob(PixelSimulationCPU* s, GPUPixel* p, ChunkState* c, float d) : simulation(s), pixels(p), chunk(c), dt(d)
+        {
+        }
+
+        void Execute() override { simulation->UpdateChunk(pixels, *chunk, dt); }
+    };
+
+    m_stats.awakeChunks = 0;
+    m_stats.pixelsVisited = 0;
+
+    std::vector<ChunkJob> jobs;
+    std::vector<JobHandle> handles;
+    jobs.reserve(m_chunks.size());
+    for (int phase = 0; phase < 4; phase++)
+    {
+        jobs.clear();
+        for (int cy = phase >> 1; cy < m_chunksY; cy += 2)
+        {
+            for (int cx = phase & 1; cx < m_chunksX; cx += 2)
+            {
+                ChunkState& chunk = m_chunks[static_cast<size_t>(cy) * m_chunksX + cx];
+                if (!chunk.current.Empty())
+                    jobs.emplace_back(this, pixels, &chunk, dt);
+            }
+        }
+        if (jobs.size() == 1)
+        {
+            jobs.front().Execute();
+        }
+        else if (!jobs.empty())
+        {
+            handles.clear();
+            auto& jobSystem = JobSystem::GetInstance();
+            for (auto& job : jobs)
+                handles.push_back(jobSystem.Schedule(&job));
+            JobSystem::CompleteAll(handles);
+        }
+        m_stats.awakeChunks += static_cast<uint32_t>(jobs.size());
+    }
+
+    DistributeDirty();
+    m_frame++;
+}
+
+void PixelSimulationCPU::UpdateChunk(GPUPixel* pixels, ChunkState& chunk, float dt)
+{
+    const PixelRect area = chunk.current;
+    chunk.visited = static_cast<uint64_t>(area.maxX - area.minX + 1) * (area.maxY - area.minY + 1);
+
+    // 自下而上逐行，行内方向逐帧交替，避免液体整体向一侧漂移
+    const bool leftToRight = (m_frame & 1u) == 0u;
+    for (int y = area.maxY; y >= area.minY; y--)
+    {
+        if (leftToRight)
+        {
+            for (int x = area.minX; x <= area.maxX; x++)
+                UpdatePixel(pixels, x, y, dt, chunk.next);
+        }
+        else
+        {
+            for (int x = area.maxX; x >= area.minX; x--)
+                UpdatePixel(pixels, x, y, dt, chunk.next);
+        }
+    }
+}
+
+void PixelSimulationCPU::UpdatePixel(GPUPixel* pixels, int x, int y, float dt, PixelRect& dirty)
+{
+    const int width = static_cast<int>(m_width);
+    const int height = static_cast<int>(m_height);
+    const size_t i = Index(x, y);
+    const uint32_t stamp = m_frame + 1u;
+    if (m_stamps[i] == stamp) return;
+
+    const GPUPixel me = pixels[i];
+    if (me.pixel_type == PixelType::Air || me.pixel_type == PixelType::Stone) return;
+
+    auto typeAt = [&](int px, int py) -> uint32_t
+    {
+        if (px < 0 || px >= width || py < 0 || py >= height) return PixelType::Stone;
+        return pixels[Index(px, py)].pixel_type;
+    };
+    auto isEmpty = [&](int px, int py) { return typeAt(px, py) == PixelType::Air; };
+    auto mark = [&](int px, int py) { dirty.Add(px - 1, py - 1, px + 1, py + 1); };
+    auto moveTo = [&](int px, int py, const GPUPixel& moved)
+    {
+        const size_t j = Index(px, py);
+        pixels[j] = moved;
+        pixels[i] = AirPixel;
+        m_stamps[j] = stamp;
+        mark(x, y);
+        mark(px, py);
+    };
+
+    // 随机数取缓冲坐标，窗口滚动时留在原位的像素随机选择不变
+    const uint32_t rng = Hash(static_cast<uint32_t>(i % m_width) * 15823u + static_cast<uint32_t>(i / m_width) * 9737u +
+                              m_frame * 6271u + m_seed * 7919u);
+    const int dir = (rng & 1u) != 0u ? 1 : -1;
+
+    // 没有移动但换一个随机数可能移动的像素（restless）也要标脏，否则区块会在它移动之前休眠
+    switch (me.pixel_type)
+    {
+    case PixelType::Sand:
+        if (isEmpty(x, y + 1))
+        {
+            moveTo(x, y + 1, GPUPixel{PixelType::Sand, me.color, 0.0f, me.velocity_y + 1.0f});
+        }
+        else if (isEmpty(x + dir, y + 1))
+        {
+            moveTo(x + dir, y + 1, GPUPixel{PixelType::Sand, me.color, 0.0f, 0.0f});
+        }
+        else if (IsLiquid(typeAt(x, y + 1)))
+        {
+            const size_t below = Index(x, y + 1);
+            pixels[i] = pixels[below];
+            pixels[below] = me;
+            m_stamps[i] = stamp;
+            m_stamps[below] = stamp;
+            mark(x, y);
+            mark(x, y + 1);
+        }
+        else
+        {
+            pixels[i] = GPUPixel{PixelType::Sand, me.color, 0.0f, 0.0f};
+            if (isEmpty(x - dir, y + 1)) mark(x, y);
+        }
+        break;
+
+    case PixelType::Water:
+        if (isEmpty(x, y + 1))
+            moveTo(x, y + 1, GPUPixel{PixelType::Water, me.color, 0.0f, 0.0f});
+        else if (isEmpty(x + dir, y + 1))
+            moveTo(x + dir, y + 1, GPUPixel{PixelType::Water, me.color, 0.0f, 0.0f});
+        else if (isEmpty(x + dir, y))
+            moveTo(x + dir, y, GPUPixel{PixelType::Water, me.color, 0.0f, 0.0f});
+        else if (isEmpty(x - dir, y + 1) || isEmpty(x - dir, y))
+            mark(x, y);
+        break;
+
+    case PixelType::Fire:
+    {
+        const float life = me.lifetime + dt;
+        if (life > 1.5f)
+        {
+            pixels[i] = GPUPixel{PixelType::Steam, DefaultPixelColor(PixelType::Steam), 0.0f, 0.0f};
+        }
+        else if (isEmpty(x, y - 1))
+        {
+            const auto brightness = static_cast<uint32_t>(std::clamp((1.5f - life) / 1.5f, 0.0f, 1.0f) * 255.0f);
+            const uint32_t color = 0xFF000000u | brightness | ((brightness / 2u) << 8u);
+            moveTo(x, y - 1, GPUPixel{PixelType::Fire, color, life, 0.0f});
+            break;
+        }
+        else
+        {
+            pixels[i] = GPUPixel{PixelType::Fire, me.color, life, 0.0f};
+        }
+        mark(x, y);
+        break;
+    }
+
+    case PixelType::Steam:
+    {
+        const float life = me.lifetime + dt;
+        if (life > 3.0f)
+            pixels[i] = AirPixel;
+        else if (isEmpty(x, y - 1))
+            moveTo(x, y - 1, GPUPixel{PixelType::Steam, me.color, life, 0.0f});
+        else if (isEmpty(x + dir, y))
+            moveTo(x + dir, y, GPUPixel{PixelType::Steam, me.color, life, 0.0f});
+        else
+            pixels[i] = GPUPixel{PixelType::Steam, me.color, life, 0.0f};
+        mark(x, y);
+        break;
+    }
+
+    case PixelType::Oil:
+        if (rng % 3u == 0u && isEmpty(x, y + 1))
+            moveTo(x, y + 1, GPUPixel{PixelType::Oil, me.color, 0.0f, 0.0f});
+        else if (isEmpty(x + dir, y))
+            moveTo(x + dir, y, GPUPixel{PixelType::Oil, me.color, 0.0f, 0.0f});
+        else if (isEmpty(x, y + 1) || isEmpty(x - dir, y))
+            mark(x, y);
+        break;
+
+    case PixelType::Lava:
+        if (typeAt(x, y + 1) == PixelType::Water)
+        {
+            const size_t below = Index(x, y + 1);
+            pixels[below] = GPUPixel{PixelType::Steam, DefaultPixelColor(PixelType::Steam), 0.0f, 0.0f};
+            pixels[i] = GPUPixel{PixelType::Stone, DefaultPixelColor(PixelType::Stone), 0.0f, 0.0f};
+            m_stamps[below] = stamp;
+            mark(x, y);
+            mark(x, y + 1);
+        }
+        else if (rng % 4u == 0u && isEmpty(x, y + 1))
+        {
+            moveTo(x, y + 1, GPUPixel{PixelType::Lava, me.color, 0.0f, 0.0f});
+        }
+        else if (rng % 4u == 0u && isEmpty(x + dir, y))
+        {
+            moveTo(x + dir, y, GPUPixel{PixelType::Lava, me.color, 0.0f, 0.0f});
+        }
+        else if (isEmpty(x, y + 1) || isEmpty(x - 1, y) || isEmpty(x + 1, y))
+        {
+            mark(x, y);
+        }
+        break;
+
+    default:
+        break;
+    }
+}
+
+void PixelSimulationCPU::DistributeDirty()
+{
+    for (ChunkState& chunk : m_chunks)
+        chunk.current = PixelRect{};
+
+    // next 最多越出本区块两格，只可能落在 3x3 邻域内
+    for (int cy = 0; cy < m_chunksY; cy++)
+    {
+        for (int cx = 0; cx < m_chunksX; cx++)
+        {
+            ChunkState& chunk = m_chunks[static_cast<size_t>(cy) * m_chunksX + cx];
+            m_stats.pixelsVisited += chunk.visited;
+            chunk.visited = 0;
+            if (chunk.next.Empty()) continue;
+            const PixelRect next = chunk.next;
+            chunk.next = PixelRect{};
+            for (int ny = std::max(cy - 1, 0); ny <= std::min(cy + 1, m_chunksY - 1); ny++)
+            {
+                for (int nx = std::max(cx - 1, 0); nx <= std::min(cx + 1, m_chunksX - 1); nx++)
+                {
+                    ChunkState& target = m_chunks[static_cast<size_t>(ny) * m_chunksX + nx];
+                    target.current.Add(target.bounds.Intersect(next));
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,98 @@
+#ifndef PIXEL_SIMULATION_CPU_H
+#define PIXEL_SIMULATION_CPU_H
+
+#include "PixelTypes.h"
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief 多线程 CPU 落沙模拟，规则与 pixel_physics.wgsl 相同，在像素数组上原地更新。
+ *
+ * 世界按 ChunkSize 划分为区块，每帧按 (cx & 1, cy & 1) 分四个阶段更新：同一阶段的区块之间至少隔一个区块，
+ * 而像素每次最多移动一格，所以同一阶段的区块可以分发到 JobSystem 并行更新而不会读写同一像素。
+ * 每个区块只遍历上一帧发生变化的脏矩形，静止的区域整块休眠。阶段顺序与区块内遍历顺序固定，
+ * 相同种子下结果与线程数无关。
+ *
+ * 像素数组按环面寻址：逻辑坐标 (0, 0) 位于缓冲的 SetOrigin 处，越过缓冲边缘的访问环绕到另一侧，
+ * 逻辑边界（原点所在的接缝）仍视为墙。规则与遍历顺序按逻辑坐标计算，随机数按缓冲坐标计算，
+ * 所以原点移动 2 * ChunkSize 的整数倍时，远离接缝、留在缓冲中原位的内容模拟结果不变。
+ */
+class LUMA_API PixelSimulationCPU
+{
+public:
+    static constexpr int ChunkSize = 64;
+
+    struct Stats
+    {
+        uint32_t totalChunks = 0;
+        uint32_t awakeChunks = 0;    ///< 上一帧有脏矩形的区块数。
+        uint64_t pixelsVisited = 0;  ///< 上一帧遍历的像素数。
+    };
+
+    PixelSimulationCPU(uint32_t width, uint32_t height, uint32_t seed = 0);
+
+    /**
+     * @brief 推进一帧。pixels 为 width * height 个行主序像素，两帧之间的外部修改需通过 MarkDirty 告知。
+     */
+    void Step(GPUPixel* pixels, float dt);
+
+    /**
+     * @brief 标记缓冲坐标闭区间，下一帧重新检查其中的像素。原点不为 0 时越过缓冲边缘的部分环绕到另一侧。
+     */
+    void MarkDirty(int minX, int minY, int maxX, int maxY);
+    void WakeAll();
+
+    /**
+     * @brief 移动逻辑原点，缓冲中的内容不动。移动量是 ChunkSize 的整数倍时各区块的脏矩形随内容平移，否则全部唤醒。
+     */
+    void SetOrigin(uint32_t x, uint32_t y);
+    uint32_t GetOriginX() const { return m_originX; }
+    uint32_t GetOriginY() const { return m_originY; }
+
+    void SetSeed(uint32_t seed) { m_seed = seed; }
+    uint32_t GetSeed() const { return m_seed; }
+    uint32_t GetFrame() const { return m_frame; }
+    uint32_t GetWidth() const { return m_width; }
+    uint32_t GetHeight() const { return m_height; }
+    int GetChunksX() const { return m_chunksX; }
+    int GetChunksY() const { return m_chunksY; }
+    /// (cx, cy) 为逻辑区块坐标。
+    bool IsChunkAwake(int cx, int cy) const;
+    const Stats& GetStats() const { return m_stats; }
+
+private:
+    struct ChunkState
+    {
+        PixelRect bounds;   ///< 逻辑坐标，以下矩形同。
+        PixelRect current;  ///< 本帧要遍历的区域，限制在 bounds 内。
+        PixelRect next;     ///< 本帧更新时产生的变化，可能越出 bounds 一到两格，帧末分发给相邻区块。
+        uint64_t visited = 0;
+    };
+
+    void UpdateChunk(GPUPixel* pixels, ChunkState& chunk, float dt);
+    void UpdatePixel(GPUPixel* pixels, int x, int y, float dt, PixelRect& dirty);
+    void DistributeDirty();
+    void MarkLogical(const PixelRect& rect);
+    /// 逻辑坐标到缓冲下标。
+    size_t Index(int x, int y) const
+    {
+        const uint32_t px = static_cast<uint32_t>(x) + m_originX;
+        const uint32_t py = static_cast<uint32_t>(y) + m_originY;
+        return static_cast<size_t>(py >= m_height ? py - m_height : py) * m_width +
+               (px >= m_width ? px - m_width : px);
+    }
+
+    uint32_t m_width;
+    uint32_t m_height;
+    uint32_t m_seed;
+    uint32_t m_frame = 0;
+    uint32_t m_originX = 0;
+    uint32_t m_originY = 0;
+    int m_chunksX;
+    int m_chunksY;
+    std::vector<ChunkState> m_chunks;
+    std::vector<uint32_t> m_stamps;  ///< 本帧已移动过的像素记为 m_frame + 1，避免同一帧内被再次处理。
+    Stats m_stats;
+};
+
+#endif
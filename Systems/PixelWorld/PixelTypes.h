@@ -0,0 +1,81 @@
+#ifndef PIXEL_TYPES_H
+#define PIXEL_TYPES_H
+
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+
+struct PixelType
+{
+    enum Value : uint32_t
+    {
+        Air = 0, Sand = 1, Water = 2, Stone = 3,
+        Fire = 4, Steam = 5, Oil = 6, Lava = 7
+    };
+};
+
+struct GPUPixel
+{
+    uint32_t pixel_type;
+    uint32_t color;
+    float lifetime;
+    float velocity_y;
+};
+
+/// 与 pixel_physics.wgsl 中 default_color 一致。
+inline uint32_t DefaultPixelColor(PixelType::Value type)
+{
+    switch (type)
+    {
+    case PixelType::Sand:  return 0xFFC8B464;
+    case PixelType::Water: return 0xFF6464C8;
+    case PixelType::Stone: return 0xFF808080;
+    case PixelType::Fire:  return 0xFF3264FF;
+    case PixelType::Steam: return 0xFFC8C8C8;
+    case PixelType::Oil:   return 0xFF325050;
+    case PixelType::Lava:  return 0xFF0040FF;
+    default:               return 0x00000000;
+    }
+}
+
+/// 像素坐标闭区间，maxX < minX 表示空。
+struct PixelRect
+{
+    int minX = INT_MAX;
+    int minY = INT_MAX;
+    int maxX = INT_MIN;
+    int maxY = INT_MIN;
+
+    bool Empty() const { return maxX < minX || maxY < minY; }
+
+    void Add(int x0, int y0, int x1, int y1)
+    {
+        minX = std::min(minX, x0);
+        minY = std::min(minY, y0);
+        maxX = std::max(maxX, x1);
+        maxY = std::max(maxY, y1);
+    }
+
+    void Add(const PixelRect& other)
+    {
+        if (!other.Empty()) Add(other.minX, other.minY, other.maxX, other.maxY);
+    }
+
+    PixelRect Intersect(const PixelRect& other) const
+    {
+        return {std::max(minX, other.minX), std::max(minY, other.minY), std::min(maxX, other.maxX),
+                std::min(maxY, other.maxY)};
+    }
+};
+
+struct SimParams
+{
+    uint32_t width;
+    uint32_t height;
+    uint32_t frame;
+    float dt;
+    uint32_t originX;  ///< 逻辑坐标 (0, 0) 在缓冲中的位置，缓冲按环面寻址。
+    uint32_t originY;
+};
+
+#endif
@@ -1,4 +1,5 @@
 #include "PixelWorld.h"
+#include "../../Utils/Logger.h"
 #include <fstream>
 #include <sstream>
 #include <algorithm>
@@ -13,30 +14,33 @@ static std::string LoadShaderFile(const std::string& path)
     return ss.str();
 }
 
-PixelWorld::PixelWorld(uint32_t width, uint32_t height)
-    : m_width(width), m_height(height)
+PixelWorld::PixelWorld(uint32_t width, uint32_t height, PixelSimulationBackend backend)
+    : m_width(width), m_height(height), m_backend(backend)
 {
     m_cpuBuffer.resize(static_cast<size_t>(width) * height, GPUPixel{0, 0, 0.0f, 0.0f});
+    m_uploadDirty.Resize(static_cast<int>(width), static_cast<int>(height), DirtyTileSize);
+    m_tileUploadFrame.assign(static_cast<size_t>(m_uploadDirty.GetTilesX()) * m_uploadDirty.GetTilesY(), 0u);
+    if (m_backend == PixelSimulationBackend::CPU)
+        m_cpuSimulation = std::make_unique<PixelSimulationCPU>(width, height, m_seed);
 }
 
 uint32_t PixelWorld::DefaultColor(PixelType::Value type)
 {
-    switch (type)
-    {
-    case PixelType::Sand:  return 0xFFC8B464;
-    case PixelType::Water: return 0xFF6464C8;
-    case PixelType::Stone: return 0xFF808080;
-    case PixelType::Fire:  return 0xFF3264FF;
-    case PixelType::Steam: return 0xFFC8C8C8;
-    case PixelType::Oil:   return 0xFF325050;
-    case PixelType::Lava:  return 0xFF0040FF;
-    default:               return 0x00000000;
-    }
+    return DefaultPixelColor(type);
 }
 
 void PixelWorld::Initialize(std::shared_ptr<Nut::NutContext> ctx)
 {
     m_ctx = std::move(ctx);
+    if (!m_ctx)
+    {
+        if (m_backend == PixelSimulationBackend::GPU)
+        {
+            LogWarn("PixelWorld: no graphics context, falling back to CPU simulation");
+            SetBackend(PixelSimulationBackend::CPU);
+        }
+        return;
+    }
     auto& device = m_ctx->GetWGPUDevice();
     const size_t pixelCount = static_cast<size_t>(m_width) * m_height;
     const size_t bufferSize = pixelCount * sizeof(GPUPixel);
@@ -55,14 +59,12 @@ void PixelWorld::Initialize(std::shared_ptr<Nut::NutContext> ctx)
     paramsDesc.label = "PixelWorld_Params";
     m_paramsBuffer = device.CreateBuffer(&paramsDesc);
 
-    wgpu::BufferDescriptor stagingDesc{};
-    stagingDesc.size = bufferSize;
-    stagingDesc.usage = wgpu::BufferUsage::CopySrc | wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::MapRead;
-    stagingDesc.label = "PixelWorld_Staging";
-    m_stagingBuffer = device.CreateBuffer(&stagingDesc);
+    if (m_readbackEnabled)
+        CreateReadbackBuffers();
 
     device.GetQueue().WriteBuffer(m_bufferA, 0, m_cpuBuffer.data(), bufferSize);
     device.GetQueue().WriteBuffer(m_bufferB, 0, m_cpuBuffer.data(), bufferSize);
+    m_uploadDirty.Clear();
 
     std::string shaderCode = LoadShaderFile("Shaders/pixel_physics.wgsl");
     wgpu::ShaderModuleWGSLDescriptor wgslDesc{};
@@ -140,16 +142,19 @@ void PixelWorld::Initialize(std::shared_ptr<Nut::NutContext> ctx)
 
 void PixelWorld::Step(float dt)
 {
+    if (m_backend == PixelSimulationBackend::CPU)
+    {
+        StepCPU(dt);
+        return;
+    }
     if (!m_ctx) return;
     auto& device = m_ctx->GetWGPUDevice();
     auto queue = m_ctx->GetWGPUQueue();
 
-    if (m_cpuDirty)
-    {
-        UploadDirtyPixels();
-    }
+    CollectReadback();
+    UploadDirtyPixels();
 
-    SimParams params{m_width, m_height, m_frame, dt};
+    SimParams params{m_width, m_height, m_frame, dt, m_originX, m_originY};
     queue.WriteBuffer(m_paramsBuffer, 0, &params, sizeof(SimParams));
 
     wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
@@ -181,8 +186,13 @@ void PixelWorld::Step(float dt)
 
     wgpu::Extent3D copySize = {m_width, m_height, 1};
 
+    if (m_readbackEnabled)
+        RequestReadback(encoder, outputBuf);
+
     wgpu::CommandBuffer cmd = encoder.Finish();
     queue.Submit(1, &cmd);
+    if (m_readbackEnabled)
+        BeginReadbackMap();
 
     m_pingPong = !m_pingPong;
     m_frame++;
@@ -195,7 +205,114 @@ void PixelWorld::SetPixel(int x, int y, PixelType::Value type)
 
     size_t i = static_cast<size_t>(y) * m_width + x;
     m_cpuBuffer[i] = GPUPixel{static_cast<uint32_t>(type), DefaultColor(type), 0.0f, 0.0f};
-    m_cpuDirty = true;
+    MarkEdited(x, y, x, y);
+}
+
+void PixelWorld::ApplyEdits(const PixelEditBuffer& edits)
+{
+    if (edits.Empty()) return;
+    // 先记到独立的瓦片表，再按瓦片矩形通知上传与 CPU 模拟
+    PixelDirtyTiles changed(static_cast<int>(m_width), static_cast<int>(m_height), DirtyTileSize);
+    PixelBufferEditTarget target{m_cpuBuffer.data(), static_cast<int>(m_width), static_cast<int>(m_height), &changed};
+    edits.Apply(target);
+    changed.ForEach([&](int, const PixelRect& rect) { MarkEdited(rect.minX, rect.minY, rect.maxX, rect.maxY); });
+}
+
+void PixelWorld::WritePixels(int x, int y, int width, int height, const GPUPixel* src, size_t srcStride)
+{
+    const int x0 = std::max(x, 0);
+    const int y0 = std::max(y, 0);
+    const int x1 = std::min(x + width, static_cast<int>(m_width)) - 1;
+    const int y1 = std::min(y + height, static_cast<int>(m_height)) - 1;
+    if (x0 > x1 || y0 > y1) return;
+
+    for (int row = y0; row <= y1; row++)
+    {
+        const GPUPixel* from = src + static_cast<size_t>(row - y) * srcStride + (x0 - x);
+        std::copy(from, from + (x1 - x0 + 1), m_cpuBuffer.begin() + static_cast<std::ptrdiff_t>(row) * m_width + x0);
+    }
+    MarkEdited(x0, y0, x1, y1);
+}
+
+void PixelWorld::MarkEdited(int minX, int minY, int maxX, int maxY)
+{
+    m_uploadDirty.Add(minX, minY, maxX, maxY);
+    m_textureDirty = true;
+    if (m_cpuSimulation)
+        m_cpuSimulation->MarkDirty(minX - 1, minY - 1, maxX + 1, maxY + 1);
+}
+
+void PixelWorld::SetBackend(PixelSimulationBackend backend)
+{
+    if (backend == m_backend) return;
+    if (backend == PixelSimulationBackend::GPU)
+    {
+        if (!m_ctx)
+        {
+            LogError("PixelWorld: GPU simulation requires Initialize with a graphics context");
+            return;
+        }
+        // GPU 从 CPU 缓冲的当前状态继续
+        m_uploadDirty.AddAll();
+    }
+    else if (!m_cpuSimulation)
+    {
+        m_cpuSimulation = std::make_unique<PixelSimulationCPU>(m_width, m_height, m_seed);
+        m_cpuSimulation->SetOrigin(m_originX, m_originY);
+    }
+    else
+    {
+        m_cpuSimulation->WakeAll();
+    }
+    m_backend = backend;
+    m_textureDirty = true;
+}
+
+void PixelWorld::SetSeed(uint32_t seed)
+{
+    m_seed = seed;
+    if (m_cpuSimulation)
+        m_cpuSimulation->SetSeed(seed);
+}
+
+void PixelWorld::SetOrigin(uint32_t x, uint32_t y)
+{
+    m_originX = m_width ? x % m_width : 0;
+    m_originY = m_height ? y % m_height : 0;
+    if (m_cpuSimulation)
+        m_cpuSimulation->SetOrigin(m_originX, m_originY);
+}
+
+void PixelWorld::StepCPU(float dt)
+{
+    // CPU 缓冲就是模拟状态本身，没有需要上传的改动
+    m_uploadDirty.Clear();
+    m_cpuSimulation->Step(m_cpuBuffer.data(), dt);
+    if (m_cpuSimulation->GetStats().awakeChunks > 0)
+        m_textureDirty = true;
+    m_frame++;
+    UploadColors();
+}
+
+void PixelWorld::UploadColors()
+{
+    if (!m_ctx || !m_renderTexture || !m_textureDirty) return;
+
+    m_colorUpload.resize(m_cpuBuffer.size());
+    for (size_t i = 0; i < m_cpuBuffer.size(); i++)
+        m_colorUpload[i] = m_cpuBuffer[i].color;
+
+    wgpu::TexelCopyTextureInfo destination{};
+    destination.texture = m_renderTexture;
+
+    wgpu::TexelCopyBufferLayout dataLayout{};
+    dataLayout.bytesPerRow = m_width * sizeof(uint32_t);
+    dataLayout.rowsPerImage = m_height;
+
+    wgpu::Extent3D writeSize = {m_width, m_height, 1};
+    m_ctx->GetWGPUQueue().WriteTexture(&destination, m_colorUpload.data(), m_colorUpload.size() * sizeof(uint32_t),
+                                       &dataLayout, &writeSize);
+    m_textureDirty = false;
 }
 
 uint32_t PixelWorld::GetPixel(int x, int y) const
@@ -212,11 +329,120 @@ wgpu::Texture PixelWorld::GetRenderTexture() const
 
 void PixelWorld::UploadDirtyPixels()
 {
-    if (!m_ctx || !m_cpuDirty) return;
+    if (!m_ctx || m_uploadDirty.Empty()) return;
     auto queue = m_ctx->GetWGPUQueue();
-    const size_t bufferSize = static_cast<size_t>(m_width) * m_height * sizeof(GPUPixel);
-
     wgpu::Buffer& currentInput = m_pingPong ? m_bufferB : m_bufferA;
-    queue.WriteBuffer(currentInput, 0, m_cpuBuffer.data(), bufferSize);
-    m_cpuDirty = false;
+
+    m_uploadDirty.ForEach([&](int tile, const PixelRect& rect)
+    {
+        const size_t rowBytes = static_cast<size_t>(rect.maxX - rect.minX + 1) * sizeof(GPUPixel);
+        for (int y = rect.minY; y <= rect.maxY; y++)
+        {
+            const size_t index = static_cast<size_t>(y) * m_width + rect.minX;
+            queue.WriteBuffer(currentInput, index * sizeof(GPUPixel), m_cpuBuffer.data() + index, rowBytes);
+        }
+        m_tileUploadFrame[static_cast<size_t>(tile)] = m_frame;
+    });
+    m_uploadDirty.Clear();
+}
+
+void PixelWorld::SetReadbackEnabled(bool enabled)
+{
+    m_readbackEnabled = enabled;
+    if (enabled && m_ctx)
+        CreateReadbackBuffers();
+}
+
+void PixelWorld::CreateReadbackBuffers()
+{
+    if (m_readbacks[0].buffer) return;
+    wgpu::BufferDescriptor desc{};
+    desc.size = static_cast<size_t>(m_width) * m_height * sizeof(GPUPixel);
+    desc.usage = wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::MapRead;
+    desc.label = "PixelWorld_ReadbackA";
+    m_readbacks[0].buffer = m_ctx->GetWGPUDevice().CreateBuffer(&desc);
+    desc.label = "PixelWorld_ReadbackB";
+    m_readbacks[1].buffer = m_ctx->GetWGPUDevice().CreateBuffer(&desc);
+}
+
+void PixelWorld::RequestReadback(wgpu::CommandEncoder& encoder, const wgpu::Buffer& source)
+{
+    Readback& slot = m_readbacks[m_readbackSlot];
+    // 两个暂存缓冲都还在等 GPU 时跳过这一帧，不阻塞
+    if (!slot.buffer || slot.state.load() != ReadbackState::Idle) return;
+    encoder.CopyBufferToBuffer(source, 0, slot.buffer, 0, static_cast<size_t>(m_width) * m_height * sizeof(GPUPixel));
+    slot.frame = m_frame;
+    slot.state = ReadbackState::Mapping;
+}
+
+void PixelWorld::BeginReadbackMap()
+{
+    Readback& slot = m_readbacks[m_readbackSlot];
+    if (slot.state.load() != ReadbackState::Mapping || slot.frame != m_frame) return;
+    m_readbackSlot ^= 1;
+
+    const size_t size = static_cast<size_t>(m_width) * m_height * sizeof(GPUPixel);
+    Readback* target = &slot;
+    slot.buffer.MapAsync(wgpu::MapMode::Read, 0, size, wgpu::CallbackMode::AllowSpontaneous,
+                         [target](wgpu::MapAsyncStatus status, wgpu::StringView)
+                         {
+                             if (status == wgpu::MapAsyncStatus::Success)
+                             {
+                                 target->state = ReadbackState::Ready;
+                             }
+                             else
+                             {
+                                 target->state = ReadbackState::Idle;
+                             }
+                         });
+}
+
+void PixelWorld::CollectReadback()
+{
+    if (!m_readbackEnabled || !m_ctx) return;
+    m_ctx->GetWGPUInstance().ProcessEvents();
+
+    // 两个都就绪时只需要较新的一份
+    Readback* newest = nullptr;
+    for (Readback& slot : m_readbacks)
+    {
+        if (slot.state.load() != ReadbackState::Ready) continue;
+        if (!newest || slot.frame > newest->frame)
+            newest = &slot;
+    }
+    if (!newest) return;
+
+    const auto* mapped = static_cast<const GPUPixel*>(
+        newest->buffer.GetConstMappedRange(0, static_cast<size_t>(m_width) * m_height * sizeof(GPUPixel)));
+    if (mapped)
+    {
+        const int tileSize = m_uploadDirty.GetTileSize();
+        for (int ty = 0; ty < m_uploadDirty.GetTilesY(); ty++)
+        {
+            for (int tx = 0; tx < m_uploadDirty.GetTilesX(); tx++)
+            {
+                // 拷贝之后又有 CPU 改动（已上传或待上传）的瓦片保留 CPU 的版本
+                const int tile = ty * m_uploadDirty.GetTilesX() + tx;
+                if (!m_uploadDirty.GetTile(tile).Empty() ||
+                    m_tileUploadFrame[static_cast<size_t>(tile)] > newest->frame)
+                    continue;
+                const int x0 = tx * tileSize;
+                const int x1 = std::min(x0 + tileSize, static_cast<int>(m_width));
+                const int y1 = std::min((ty + 1) * tileSize, static_cast<int>(m_height));
+                for (int y = ty * tileSize; y < y1; y++)
+                {
+                    const size_t index = static_cast<size_t>(y) * m_width + x0;
+                    std::copy(mapped + index, mapped + index + (x1 - x0),
+                              m_cpuBuffer.begin() + static_cast<std::ptrdiff_t>(index));
+                }
+            }
+        }
+    }
+
+    for (Readback& slot : m_readbacks)
+    {
+        if (slot.state.load() != ReadbackState::Ready || slot.frame > newest->frame) continue;
+        slot.buffer.Unmap();
+        slot.state = ReadbackState::Idle;
+    }
 }
@@ -1,6 +1,7 @@
 #ifndef PIXEL_WORLD_H
 #define PIXEL_WORLD_H
 
+#include <atomic>
 #include <cstdint>
 #include <memory>
 #include <vector>
@@ -8,41 +9,64 @@
 #include "../../Renderer/Nut/Pipeline.h"
 #include "../../Renderer/Nut/Buffer.h"
 #include "../../Renderer/Nut/BindGroup.h"
+#include "PixelTypes.h"
+#include "PixelSimulationCPU.h"
+#include "PixelEditBuffer.h"
 
-struct PixelType
+/**
+ * @brief 像素模拟的执行后端。GPU 使用 pixel_physics.wgsl 计算着色器；CPU 使用 PixelSimulationCPU 多线程更新 CPU 缓冲，
+ * 不需要图形上下文。
+ */
+enum class PixelSimulationBackend
 {
-    enum Value : uint32_t
-    {
-        Air = 0, Sand = 1, Water = 2, Stone = 3,
-        Fire = 4, Steam = 5, Oil = 6, Lava = 7
-    };
-};
-
-struct GPUPixel
-{
-    uint32_t pixel_type;
-    uint32_t color;
-    float lifetime;
-    float velocity_y;
-};
-
-struct SimParams
-{
-    uint32_t width;
-    uint32_t height;
-    uint32_t frame;
-    float dt;
+    GPU,
+    CPU
 };
 
 class LUMA_API PixelWorld
 {
 public:
-    PixelWorld(uint32_t width, uint32_t height);
+    /// CPU 改动按此边长的瓦片记录脏矩形，上传与回读都以瓦片为单位。
+    static constexpr int DirtyTileSize = 64;
+
+    PixelWorld(uint32_t width, uint32_t height, PixelSimulationBackend backend = PixelSimulationBackend::GPU);
 
+    /// ctx 可以为空，此时只能使用 CPU 后端且没有渲染纹理。
     void Initialize(std::shared_ptr<Nut::NutContext> ctx);
     void Step(float dt);
+
+    /**
+     * @brief 运行时切换后端。切到 GPU 时上传当前 CPU 缓冲，需要已用非空上下文初始化；切到 CPU 时从 CPU 缓冲继续模拟。
+     */
+    void SetBackend(PixelSimulationBackend backend);
+    PixelSimulationBackend GetBackend() const { return m_backend; }
+    /// CPU 后端的随机种子。
+    void SetSeed(uint32_t seed);
+    /**
+     * @brief 设置逻辑原点。缓冲按环面寻址，模拟把 (x, y) 处当作左上角、原点所在的接缝当作墙；
+     * 像素读写接口仍使用缓冲坐标。渲染时以原点为偏移、重复寻址采样纹理即可得到逻辑画面。
+     */
+    void SetOrigin(uint32_t x, uint32_t y);
+    uint32_t GetOriginX() const { return m_originX; }
+    uint32_t GetOriginY() const { return m_originY; }
+    const PixelSimulationCPU* GetCPUSimulation() const { return m_cpuSimulation.get(); }
+
     void SetPixel(int x, int y, PixelType::Value type);
     uint32_t GetPixel(int x, int y) const;
+
+    /// 把编辑命令应用到 CPU 缓冲，下一次 Step 只上传改动过的矩形。
+    void ApplyEdits(const PixelEditBuffer& edits);
+    /// 用 src 覆盖从 (x, y) 开始的 width * height 矩形，src 相邻两行相隔 srcStride 个像素。
+    void WritePixels(int x, int y, int width, int height, const GPUPixel* src, size_t srcStride);
+    /// CPU 镜像，行主序。GPU 后端开启回读时比 GPU 上的结果晚一到两帧。
+    const GPUPixel* GetPixels() const { return m_cpuBuffer.data(); }
+
+    /**
+     * @brief GPU 后端每帧把模拟结果异步拷贝到两个暂存缓冲之一，映射完成后在下一次 Step 开始时写回 CPU 镜像，
+     * 从不等待 GPU。尚未上传的 CPU 改动所在的瓦片不会被覆盖。
+     */
+    void SetReadbackEnabled(bool enabled);
+
     wgpu::Texture GetRenderTexture() const;
     uint32_t GetWidth() const { return m_width; }
     uint32_t GetHeight() const { return m_height; }
@@ -57,7 +81,6 @@ private:
     wgpu::Buffer m_bufferA;
     wgpu::Buffer m_bufferB;
     wgpu::Buffer m_paramsBuffer;
-    wgpu::Buffer m_stagingBuffer;
 
     wgpu::ComputePipeline m_pipeline;
     wgpu::BindGroupLayout m_bindGroupLayout;
@@ -70,7 +93,42 @@ private:
     bool m_pingPong = false;
 
     std::vector<GPUPixel> m_cpuBuffer;
-    bool m_cpuDirty = false;
+    PixelDirtyTiles m_uploadDirty;
+    std::vector<uint32_t> m_tileUploadFrame; ///< 每个瓦片最近一次上传时的帧号。
+
+    enum class ReadbackState : int
+    {
+        Idle,
+        Mapping,
+        Ready
+    };
+
+    struct Readback
+    {
+        wgpu::Buffer buffer;
+        std::atomic<ReadbackState> state{ReadbackState::Idle};
+        uint32_t frame = 0; ///< 拷贝时的帧号，结果包含该帧开始前上传的改动。
+    };
+
+    bool m_readbackEnabled = false;
+    Readback m_readbacks[2];
+    int m_readbackSlot = 0;
+
+    PixelSimulationBackend m_backend;
+    uint32_t m_seed = 0;
+    uint32_t m_originX = 0;
+    uint32_t m_originY = 0;
+    std::unique_ptr<PixelSimulationCPU> m_cpuSimulation;
+    std::vector<uint32_t> m_colorUpload;
+    bool m_textureDirty = true;
+
+    void StepCPU(float dt);
+    void UploadColors();
+    void MarkEdited(int minX, int minY, int maxX, int maxY);
+    void CreateReadbackBuffers();
+    void RequestReadback(wgpu::CommandEncoder& encoder, const wgpu::Buffer& source);
+    void BeginReadbackMap();
+    void CollectReadback();
 };
 
 #endif
@@ -15,7 +15,7 @@ namespace Systems
 
     void PixelWorldSystem::OnUpdate(RuntimeScene* scene, float deltaTime, EngineContext& engineCtx)
     {
-        if (!scene || !m_nutContext) return;
+        if (!scene) return;
 
         auto& registry = scene->GetRegistry();
         auto view = registry.view<ECS::PixelWorldComponent>();
@@ -25,11 +25,18 @@ namespace Systems
             auto& comp = view.get<ECS::PixelWorldComponent>(entity);
             if (!comp.Enable) continue;
 
+            const auto backend = comp.cpuSimulation || !m_nutContext ? PixelSimulationBackend::CPU
+                                                                     : PixelSimulationBackend::GPU;
             if (!comp.world)
             {
-                comp.world = std::make_shared<PixelWorld>(comp.worldWidth, comp.worldHeight);
+                comp.world = std::make_shared<PixelWorld>(comp.worldWidth, comp.worldHeight, backend);
+                comp.world->SetSeed(comp.seed);
                 comp.world->Initialize(m_nutContext);
             }
+            else if (comp.world->GetBackend() != backend)
+            {
+                comp.world->SetBackend(backend);
+            }
 
             if (!comp.paused)
             {
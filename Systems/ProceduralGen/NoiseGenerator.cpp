@@ -1,6 +1,25 @@
 #include "NoiseGenerator.h"
+#include "../../Utils/SIMDWrapper.h"
 #include <cmath>
 #include <cfloat>
+#include <vector>
+
+// 批量路径与标量函数必须逐位一致：禁止编译器把乘加融合成 FMA，两边都按相同顺序逐次舍入
+#if defined(_MSC_VER) && !defined(__clang__)
+#pragma fp_contract(off)
+#elif defined(__clang__)
+#pragma clang fp contract(off)
+#elif defined(__GNUC__)
+#pragma GCC optimize("fp-contract=off")
+#endif
+
+#if defined(LUMA_AVX2) || defined(LUMA_AVX512)
+#include <immintrin.h>
+#define LUMA_NOISE_AVX2 1
+#elif defined(LUMA_ARM64) && defined(LUMA_NEON)
+#include <arm_neon.h>
+#define LUMA_NOISE_NEON 1
+#endif
 
 static constexpr int PERM[] = {
     151,160,137,91,90,15,131,13,201,95,96,53,194,233,7,225,
@@ -108,3 +127,372 @@ float NoiseGenerator::Cellular(float x, float y, int seed)
 
     return std::sqrt(minDist);
 }
+
+namespace
+{
+    enum class BatchISA { Scalar, AVX2, NEON };
+
+    BatchISA ActiveBatchISA()
+    {
+        static const BatchISA isa = []
+        {
+#if defined(LUMA_NOISE_AVX2)
+            if (SIMD::GetInstance().IsAVX2Supported()) return BatchISA::AVX2;
+#elif defined(LUMA_NOISE_NEON)
+            if (SIMD::GetInstance().IsNEONSupported()) return BatchISA::NEON;
+#endif
+            return BatchISA::Scalar;
+        }();
+        return isa;
+    }
+
+    /// FBM 每个倍频的参数，按标量实现的累乘顺序预先算好，所有样本共享。
+    struct Octave
+    {
+        float frequency;
+        float amplitude;
+        int seed;
+    };
+
+    struct FBMPlan
+    {
+        std::vector<Octave> octaves;
+        float maxVal = 0.0f;
+
+        FBMPlan(int count, float lacunarity, float persistence, int seed)
+        {
+            float amplitude = 1.0f;
+            float frequency = 1.0f;
+            octaves.reserve(count > 0 ? count : 0);
+            for (int i = 0; i < count; ++i)
+            {
+                octaves.push_back({frequency, amplitude, seed + i});
+                maxVal += amplitude;
+                amplitude *= persistence;
+                frequency *= lacunarity;
+            }
+        }
+    };
+
+#if defined(LUMA_NOISE_AVX2)
+    inline __m256 Fade8(__m256 t)
+    {
+        __m256 inner = _mm256_add_ps(
+            _mm256_mul_ps(t, _mm256_sub_ps(_mm256_mul_ps(t, _mm256_set1_ps(6.0f)), _mm256_set1_ps(15.0f))),
+            _mm256_set1_ps(10.0f));
+        return _mm256_mul_ps(_mm256_mul_ps(_mm256_mul_ps(t, t), t), inner);
+    }
+
+    inline __m256 Lerp8(__m256 a, __m256 b, __m256 t)
+    {
+        return _mm256_add_ps(a, _mm256_mul_ps(t, _mm256_sub_ps(b, a)));
+    }
+
+    inline __m256 Grad8(__m256i hash, __m256 x, __m256 y)
+    {
+        __m256i h = _mm256_and_si256(hash, _mm256_set1_epi32(7));
+        __m256 lowHalf = _mm256_castsi256_ps(_mm256_cmpgt_epi32(_mm256_set1_epi32(4), h));
+        __m256 u = _mm256_blendv_ps(y, x, lowHalf);
+        __m256 v = _mm256_blendv_ps(x, y, lowHalf);
+        // 取反等价于翻转符号位
+        __m256 signU = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(h, _mm256_set1_epi32(1)), 31));
+        __m256 signV = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(h, _mm256_set1_epi32(2)), 30));
+        return _mm256_add_ps(_mm256_xor_ps(u, signU),
+                             _mm256_xor_ps(_mm256_mul_ps(_mm256_set1_ps(2.0f), v), signV));
+    }
+
+    inline __m256i Perm8(__m256i index)
+    {
+        return _mm256_i32gather_epi32(PERM, _mm256_and_si256(index, _mm256_set1_epi32(255)), 4);
+    }
+
+    __m256 Perlin8(__m256 x, __m256 y, int seed)
+    {
+        const __m256i one = _mm256_set1_epi32(1);
+        __m256 fx = _mm256_floor_ps(x);
+        __m256 fy = _mm256_floor_ps(y);
+        __m256i xi = _mm256_and_si256(_mm256_cvttps_epi32(fx), _mm256_set1_epi32(255));
+        __m256i yi = _mm256_and_si256(_mm256_cvttps_epi32(fy), _mm256_set1_epi32(255));
+        __m256 xf = _mm256_sub_ps(x, fx);
+        __m256 yf = _mm256_sub_ps(y, fy);
+
+        __m256 u = Fade8(xf);
+        __m256 v = Fade8(yf);
+
+        __m256i a = Perm8(_mm256_add_epi32(xi, _mm256_set1_epi32(seed)));
+        __m256i b = Perm8(_mm256_add_epi32(xi, _mm256_set1_epi32(seed + 1)));
+        __m256i aa = Perm8(_mm256_add_epi32(a, yi));
+        __m256i ab = Perm8(_mm256_add_epi32(_mm256_add_epi32(a, yi), one));
+        __m256i ba = Perm8(_mm256_add_epi32(b, yi));
+        __m256i bb = Perm8(_mm256_add_epi32(_mm256_add_epi32(b, yi), one));
+
+        const __m256 oneF = _mm256_set1_ps(1.0f);
+        __m256 xf1 = _mm256_sub_ps(xf, oneF);
+        __m256 yf1 = _mm256_sub_ps(yf, oneF);
+        __m256 x1 = Lerp8(Grad8(aa, xf, yf), Grad8(ba, xf1, yf), u);
+        __m256 x2 = Lerp8(Grad8(ab, xf, yf1), Grad8(bb, xf1, yf1), u);
+
+        return _mm256_mul_ps(_mm256_add_ps(Lerp8(x1, x2, v), oneF), _mm256_set1_ps(0.5f));
+    }
+
+    /// 返回已写入的样本数（8 的倍数），余下的由调用方按标量补齐。
+    int FBMRowAVX2(float* out, int count, float x0, float stepX, float y, const FBMPlan& plan)
+    {
+        const __m256 lane = _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f);
+        const __m256 maxVal = _mm256_set1_ps(plan.maxVal);
+        int i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            __m256 x = _mm256_add_ps(_mm256_set1_ps(x0),
+                                     _mm256_mul_ps(_mm256_add_ps(_mm256_set1_ps((float)i), lane), _mm256_set1_ps(stepX)));
+            __m256 total = _mm256_setzero_ps();
+            for (const Octave& octave : plan.octaves)
+            {
+                __m256 n = Perlin8(_mm256_mul_ps(x, _mm256_set1_ps(octave.frequency)),
+                                   _mm256_set1_ps(y * octave.frequency), octave.seed);
+                total = _mm256_add_ps(total, _mm256_mul_ps(n, _mm256_set1_ps(octave.amplitude)));
+            }
+            _mm256_storeu_ps(out + i, _mm256_div_ps(total, maxVal));
+        }
+        return i;
+    }
+
+    int CellularRowAVX2(float* out, int count, float x0, float stepX, float y, int seed)
+    {
+        const __m256 lane = _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f);
+        const __m256 vy = _mm256_set1_ps(y);
+        const __m256i yi = _mm256_set1_epi32((int)std::floor(y));
+        const __m256i seedTerm = _mm256_set1_epi32(seed * 131);
+        const __m256i lowMask = _mm256_set1_epi32(0xffff);
+        const __m256 inv = _mm256_set1_ps(65535.0f);
+        int i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            __m256 x = _mm256_add_ps(_mm256_set1_ps(x0),
+                                     _mm256_mul_ps(_mm256_add_ps(_mm256_set1_ps((float)i), lane), _mm256_set1_ps(stepX)));
+            __m256i xi = _mm256_cvttps_epi32(_mm256_floor_ps(x));
+            __m256 minDist = _mm256_set1_ps(FLT_MAX);
+
+            for (int dx = -1; dx <= 1; ++dx)
+            {
+                __m256i cx = _mm256_add_epi32(xi, _mm256_set1_epi32(dx));
+                __m256 cxf = _mm256_cvtepi32_ps(cx);
+                for (int dy = -1; dy <= 1; ++dy)
+                {
+                    __m256i cy = _mm256_add_epi32(yi, _mm256_set1_epi32(dy));
+                    // 与 Hash2D 相同的 32 位环绕乘法
+                    __m256i n = _mm256_add_epi32(_mm256_add_epi32(cx, _mm256_mullo_epi32(cy, _mm256_set1_epi32(57))), seedTerm);
+                    n = _mm256_xor_si256(_mm256_slli_epi32(n, 13), n);
+                    __m256i t = _mm256_add_epi32(_mm256_mullo_epi32(_mm256_mullo_epi32(n, n), _mm256_set1_epi32(15731)),
+                                                 _mm256_set1_epi32(789221));
+                    __m256i h = _mm256_and_si256(
+                        _mm256_add_epi32(_mm256_mullo_epi32(n, t), _mm256_set1_epi32(1376312589)),
+                        _mm256_set1_epi32(0x7fffffff));
+
+                    __m256 fx = _mm256_add_ps(cxf, _mm256_div_ps(_mm256_cvtepi32_ps(_mm256_and_si256(h, lowMask)), inv));
+                    __m256 fy = _mm256_add_ps(_mm256_cvtepi32_ps(cy),
+                                              _mm256_div_ps(_mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(h, 16), lowMask)), inv));
+                    __m256 ddx = _mm256_sub_ps(x, fx);
+                    __m256 ddy = _mm256_sub_ps(vy, fy);
+                    minDist = _mm256_min_ps(minDist, _mm256_add_ps(_mm256_mul_ps(ddx, ddx), _mm256_mul_ps(ddy, ddy)));
+                }
+            }
+            _mm256_storeu_ps(out + i, _mm256_sqrt_ps(minDist));
+        }
+        return i;
+    }
+#endif
+
+#if defined(LUMA_NOISE_NEON)
+    inline float32x4_t Fade4(float32x4_t t)
+    {
+        float32x4_t inner = vaddq_f32(
+            vmulq_f32(t, vsubq_f32(vmulq_f32(t, vdupq_n_f32(6.0f)), vdupq_n_f32(15.0f))),
+            vdupq_n_f32(10.0f));
+        return vmulq_f32(vmulq_f32(vmulq_f32(t, t), t), inner);
+    }
+
+    inline float32x4_t Lerp4(float32x4_t a, float32x4_t b, float32x4_t t)
+    {
+        return vaddq_f32(a, vmulq_f32(t, vsubq_f32(b, a)));
+    }
+
+    inline float32x4_t Grad4(int32x4_t hash, float32x4_t x, float32x4_t y)
+    {
+        int32x4_t h = vandq_s32(hash, vdupq_n_s32(7));
+        uint32x4_t lowHalf = vcltq_s32(h, vdupq_n_s32(4));
+        float32x4_t u = vbslq_f32(lowHalf, x, y);
+        float32x4_t v = vbslq_f32(lowHalf, y, x);
+        uint32x4_t hu = vreinterpretq_u32_s32(h);
+        uint32x4_t signU = vshlq_n_u32(vandq_u32(hu, vdupq_n_u32(1)), 31);
+        uint32x4_t signV = vshlq_n_u32(vandq_u32(hu, vdupq_n_u32(2)), 30);
+        float32x4_t su = vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(u), signU));
+        float32x4_t sv = vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(vmulq_f32(vdupq_n_f32(2.0f), v)), signV));
+        return vaddq_f32(su, sv);
+    }
+
+    // NEON 没有 gather，逐通道查表
+    inline int32x4_t Perm4(int32x4_t index)
+    {
+        alignas(16) int32_t lanes[4];
+        vst1q_s32(lanes, vandq_s32(index, vdupq_n_s32(255)));
+        alignas(16) const int32_t values[4] = {PERM[lanes[0]], PERM[lanes[1]], PERM[lanes[2]], PERM[lanes[3]]};
+        return vld1q_s32(values);
+    }
+
+    float32x4_t Perlin4(float32x4_t x, float32x4_t y, int seed)
+    {
+        const int32x4_t one = vdupq_n_s32(1);
+        float32x4_t fx = vrndmq_f32(x);
+        float32x4_t fy = vrndmq_f32(y);
+        int32x4_t xi = vandq_s32(vcvtq_s32_f32(fx), vdupq_n_s32(255));
+        int32x4_t yi = vandq_s32(vcvtq_s32_f32(fy), vdupq_n_s32(255));
+        float32x4_t xf = vsubq_f32(x, fx);
+        float32x4_t yf = vsubq_f32(y, fy);
+
+        float32x4_t u = Fade4(xf);
+        float32x4_t v = Fade4(yf);
+
+        int32x4_t a = Perm4(vaddq_s32(xi, vdupq_n_s32(seed)));
+        int32x4_t b = Perm4(vaddq_s32(xi, vdupq_n_s32(seed + 1)));
+        int32x4_t aa = Perm4(vaddq_s32(a, yi));
+        int32x4_t ab = Perm4(vaddq_s32(vaddq_s32(a, yi), one));
+        int32x4_t ba = Perm4(vaddq_s32(b, yi));
+        int32x4_t bb = Perm4(vaddq_s32(vaddq_s32(b, yi), one));
+
+        const float32x4_t oneF = vdupq_n_f32(1.0f);
+        float32x4_t xf1 = vsubq_f32(xf, oneF);
+        float32x4_t yf1 = vsubq_f32(yf, oneF);
+        float32x4_t x1 = Lerp4(Grad4(aa, xf, yf), Grad4(ba, xf1, yf), u);
+        float32x4_t x2 = Lerp4(Grad4(ab, xf, yf1), Grad4(bb, xf1, yf1), u);
+
+        return vmulq_f32(vaddq_f32(Lerp4(x1, x2, v), oneF), vdupq_n_f32(0.5f));
+    }
+
+    int FBMRowNEON(float* out, int count, float x0, float stepX, float y, const FBMPlan& plan)
+    {
+        alignas(16) static const float laneInit[4] = {0.0f, 1.0f, 2.0f, 3.0f};
+        const float32x4_t lane = vld1q_f32(laneInit);
+        const float32x4_t maxVal = vdupq_n_f32(plan.maxVal);
+        int i = 0;
+        for (; i + 4 <= count; i += 4)
+        {
+            float32x4_t x = vaddq_f32(vdupq_n_f32(x0),
+                                      vmulq_f32(vaddq_f32(vdupq_n_f32((float)i), lane), vdupq_n_f32(stepX)));
+            float32x4_t total = vdupq_n_f32(0.0f);
+            for (const Octave& octave : plan.octaves)
+            {
+                float32x4_t n = Perlin4(vmulq_f32(x, vdupq_n_f32(octave.frequency)),
+                                        vdupq_n_f32(y * octave.frequency), octave.seed);
+                total = vaddq_f32(total, vmulq_f32(n, vdupq_n_f32(octave.amplitude)));
+            }
+            vst1q_f32(out + i, vdivq_f32(total, maxVal));
+        }
+        return i;
+    }
+
+    int CellularRowNEON(float* out, int count, float x0, float stepX, float y, int seed)
+    {
+        alignas(16) static const float laneInit[4] = {0.0f, 1.0f, 2.0f, 3.0f};
+        const float32x4_t lane = vld1q_f32(laneInit);
+        const float32x4_t vy = vdupq_n_f32(y);
+        const int32x4_t yi = vdupq_n_s32((int)std::floor(y));
+        const int32x4_t seedTerm = vdupq_n_s32(seed * 131);
+        const int32x4_t lowMask = vdupq_n_s32(0xffff);
+        const float32x4_t inv = vdupq_n_f32(65535.0f);
+        int i = 0;
+        for (; i + 4 <= count; i += 4)
+        {
+            float32x4_t x = vaddq_f32(vdupq_n_f32(x0),
+                                      vmulq_f32(vaddq_f32(vdupq_n_f32((float)i), lane), vdupq_n_f32(stepX)));
+            int32x4_t xi = vcvtq_s32_f32(vrndmq_f32(x));
+            float32x4_t minDist = vdupq_n_f32(FLT_MAX);
+
+            for (int dx = -1; dx <= 1; ++dx)
+            {
+                int32x4_t cx = vaddq_s32(xi, vdupq_n_s32(dx));
+                float32x4_t cxf = vcvtq_f32_s32(cx);
+                for (int dy = -1; dy <= 1; ++dy)
+                {
+                    int32x4_t cy = vaddq_s32(yi, vdupq_n_s32(dy));
+                    int32x4_t n = vaddq_s32(vaddq_s32(cx, vmulq_s32(cy, vdupq_n_s32(57))), seedTerm);
+                    n = veorq_s32(vshlq_n_s32(n, 13), n);
+                    int32x4_t t = vaddq_s32(vmulq_s32(vmulq_s32(n, n), vdupq_n_s32(15731)), vdupq_n_s32(789221));
+                    int32x4_t h = vandq_s32(vaddq_s32(vmulq_s32(n, t), vdupq_n_s32(1376312589)),
+                                            vdupq_n_s32(0x7fffffff));
+
+                    float32x4_t fx = vaddq_f32(cxf, vdivq_f32(vcvtq_f32_s32(vandq_s32(h, lowMask)), inv));
+                    float32x4_t fy = vaddq_f32(vcvtq_f32_s32(cy),
+                                               vdivq_f32(vcvtq_f32_s32(vandq_s32(vshrq_n_s32(h, 16), lowMask)), inv));
+                    float32x4_t ddx = vsubq_f32(x, fx);
+                    float32x4_t ddy = vsubq_f32(vy, fy);
+                    minDist = vminq_f32(minDist, vaddq_f32(vmulq_f32(ddx, ddx), vmulq_f32(ddy, ddy)));
+                }
+            }
+            vst1q_f32(out + i, vsqrtq_f32(minDist));
+        }
+        return i;
+    }
+#endif
+}
+
+void NoiseGenerator::FillPerlin(float* out, int width, int height, float originX, float originY,
+                                float stepX, float stepY, int seed)
+{
+    // 单倍频 FBM 与 Perlin 逐位相同
+    FillFBM(out, width, height, originX, originY, stepX, stepY, 1, 1.0f, 1.0f, seed);
+}
+
+void NoiseGenerator::FillFBM(float* out, int width, int height, float originX, float originY,
+                             float stepX, float stepY, int octaves, float lacunarity,
+                             float persistence, int seed)
+{
+    if (width <= 0 || height <= 0) return;
+    [[maybe_unused]] const FBMPlan plan(octaves, lacunarity, persistence, seed);
+    [[maybe_unused]] const BatchISA isa = ActiveBatchISA();
+
+    for (int j = 0; j < height; ++j)
+    {
+        float* row = out + (size_t)j * width;
+        float y = originY + (float)j * stepY;
+        int i = 0;
+#if defined(LUMA_NOISE_AVX2)
+        if (isa == BatchISA::AVX2) i = FBMRowAVX2(row, width, originX, stepX, y, plan);
+#elif defined(LUMA_NOISE_NEON)
+        if (isa == BatchISA::NEON) i = FBMRowNEON(row, width, originX, stepX, y, plan);
+#endif
+        for (; i < width; ++i)
+            row[i] = FBM(originX + (float)i * stepX, y, octaves, lacunarity, persistence, seed);
+    }
+}
+
+void NoiseGenerator::FillCellular(float* out, int width, int height, float originX, float originY,
+                                  float stepX, float stepY, int seed)
+{
+    if (width <= 0 || height <= 0) return;
+    [[maybe_unused]] const BatchISA isa = ActiveBatchISA();
+
+    for (int j = 0; j < height; ++j)
+    {
+        float* row = out + (size_t)j * width;
+        float y = originY + (float)j * stepY;
+        int i = 0;
+#if defined(LUMA_NOISE_AVX2)
+        if (isa == BatchISA::AVX2) i = CellularRowAVX2(row, width, originX, stepX, y, seed);
+#elif defined(LUMA_NOISE_NEON)
+        if (isa == BatchISA::NEON) i = CellularRowNEON(row, width, originX, stepX, y, seed);
+#endif
+        for (; i < width; ++i)
+            row[i] = Cellular(originX + (float)i * stepX, y, seed);
+    }
+}
+
+const char* NoiseGenerator::GetBatchInstructions()
+{
+    switch (ActiveBatchISA())
+    {
+    case BatchISA::AVX2: return "AVX2";
+    case BatchISA::NEON: return "NEON";
+    default: return "Scalar";
+    }
+}
@@ -11,6 +11,24 @@ public:
                      float persistence = 0.5f, int seed = 0);
     static float Cellular(float x, float y, int seed = 0);
 
+    /**
+     * @brief 网格批量采样。第 j 行第 i 列的样本坐标为 (originX + i * stepX, originY + j * stepY)，
+     * 结果按行写入 out（共 width * height 个），与以相同坐标逐点调用对应的标量函数逐位相同，
+     * 因此阈值恰好落在噪声值上时批量与标量路径的分类结果也相同。
+     *
+     * 每行按 8 路（AVX2）或 4 路（NEON）向量计算，指令集由 SIMD 在运行时检测选择；FBM 的各倍频在同一遍内累加。
+     */
+    static void FillPerlin(float* out, int width, int height, float originX, float originY,
+                           float stepX, float stepY, int seed = 0);
+    static void FillFBM(float* out, int width, int height, float originX, float originY,
+                        float stepX, float stepY, int octaves = 4, float lacunarity = 2.0f,
+                        float persistence = 0.5f, int seed = 0);
+    static void FillCellular(float* out, int width, int height, float originX, float originY,
+                             float stepX, float stepY, int seed = 0);
+
+    /// 批量接口当前使用的指令集（"AVX2"、"NEON" 或 "Scalar"）。
+    static const char* GetBatchInstructions();
+
 private:
     static float Grad(int hash, float x, float y);
     static float Fade(float t);
@@ -1,119 +1,110 @@
 #include "TerrainGenerator.h"
 #include "NoiseGenerator.h"
+#include "TerrainPipeline.h"
 #include "../PixelWorld/PixelWorld.h"
-#include "../WorldStreaming/Chunk.h"
+#include <algorithm>
+#include <climits>
+#include <vector>
 
-int TerrainGenerator::SurfaceHeight(int worldX, const TerrainProfile& profile)
+namespace
 {
-    float n = NoiseGenerator::FBM(
+    constexpr float POOL_FREQUENCY = 0.08f;
+}
+
+int TerrainGenerator::SurfaceHeights(int worldX, int count, int* out, const TerrainProfile& profile)
+{
+    std::vector<float> noise(count);
+    NoiseGenerator::FillFBM(noise.data(), count, 1,
         (float)worldX * profile.surfaceFrequency, 0.0f,
-        4, 2.0f, 0.5f, profile.seed);
-    return profile.surfaceBaseY + (int)(n * profile.surfaceAmplitude);
+        profile.surfaceFrequency, 0.0f, 4, 2.0f, 0.5f, profile.seed);
+
+    int minHeight = INT_MAX;
+    for (int i = 0; i < count; ++i)
+    {
+        out[i] = profile.surfaceBaseY + (int)(noise[i] * profile.surfaceAmplitude);
+        minHeight = std::min(minHeight, out[i]);
+    }
+    return minHeight;
 }
 
-bool TerrainGenerator::IsCave(int worldX, int worldY, const TerrainProfile& profile)
+void TerrainGenerator::CaveNoise(int worldX, int worldY, int width, int height, float* out, const TerrainProfile& profile)
 {
-    float n = NoiseGenerator::Cellular(
-        (float)worldX * profile.caveFrequency,
-        (float)worldY * profile.caveFrequency,
-        profile.seed + 999);
-    return n < profile.caveThreshold;
+    NoiseGenerator::FillCellular(out, width, height,
+        (float)worldX * profile.caveFrequency, (float)worldY * profile.caveFrequency,
+        profile.caveFrequency, profile.caveFrequency, profile.seed + 999);
 }
 
-void TerrainGenerator::GenerateForPixelWorld(PixelWorld& world, const TerrainProfile& profile)
+void TerrainGenerator::PoolNoise(int worldX, int worldY, int width, int height, float* out, const TerrainProfile& profile)
 {
-    int w = (int)world.GetWidth();
-    int h = (int)world.GetHeight();
+    NoiseGenerator::FillPerlin(out, width, height,
+        (float)worldX * POOL_FREQUENCY, (float)worldY * POOL_FREQUENCY,
+        POOL_FREQUENCY, POOL_FREQUENCY, profile.seed + 777);
+}
 
-    for (int x = 0; x < w; ++x)
-    {
-        int surfY = SurfaceHeight(x, profile);
+uint16_t TerrainGenerator::Classify(int depth, float cave, float pool, const TerrainProfile& profile)
+{
+    if (depth < 0) return PixelType::Air;
+    if (depth < SandDepth) return PixelType::Sand;
+    if (cave < profile.caveThreshold) return PixelType::Air;
+    // Deep liquid pools
+    if (depth > PoolDepth && pool > 0.75f)
+        return (depth > LavaDepth) ? PixelType::Lava : PixelType::Water;
+    return PixelType::Stone;
+}
 
-        for (int y = 0; y < h; ++y)
+void TerrainGenerator::ApplyOres(int worldX, int worldY, int width, int height, const int* surface, int minSurface,
+                                 uint16_t* tiles, float* scratch, const TerrainProfile& profile)
+{
+    for (const OreLayer& ore : profile.ores)
+    {
+        // 只采样可能达到 minDepth 的行
+        const int firstRow = std::clamp(minSurface + ore.minDepth - worldY, 0, height);
+        if (firstRow >= height) continue;
+        float* noise = scratch + (size_t)firstRow * width;
+        NoiseGenerator::FillPerlin(noise, width, height - firstRow,
+            (float)worldX * ore.frequency, (float)(worldY + firstRow) * ore.frequency,
+            ore.frequency, ore.frequency, profile.seed + ore.seedOffset);
+
+        for (int y = firstRow; y < height; ++y)
         {
-            if (y < surfY)
+            uint16_t* row = tiles + (size_t)y * width;
+            const float* rowNoise = scratch + (size_t)y * width;
+            for (int x = 0; x < width; ++x)
             {
-                world.SetPixel(x, y, PixelType::Air);
-                continue;
+                if (row[x] == PixelType::Stone && worldY + y - surface[x] >= ore.minDepth && rowNoise[x] > ore.threshold)
+                    row[x] = ore.material;
             }
-
-            int depth = y - surfY;
-
-            if (depth < 3)
-            {
-                world.SetPixel(x, y, PixelType::Sand);
-                continue;
-            }
-
-            if (IsCave(x, y, profile))
-            {
-                world.SetPixel(x, y, PixelType::Air);
-                continue;
-            }
-
-            // Deep liquid pools
-            if (depth > 80)
-            {
-                float pool = NoiseGenerator::Perlin(
-                    (float)x * 0.08f, (float)y * 0.08f, profile.seed + 777);
-                if (pool > 0.75f)
-                {
-                    world.SetPixel(x, y, (depth > 120) ? PixelType::Lava : PixelType::Water);
-                    continue;
-                }
-            }
-
-            world.SetPixel(x, y, PixelType::Stone);
         }
     }
 }
 
-void TerrainGenerator::GenerateForChunk(WorldStreaming::Chunk& chunk, const TerrainProfile& profile)
+void TerrainGenerator::GenerateForPixelWorld(PixelWorld& world, const TerrainProfile& profile)
 {
-    int ox = chunk.coord.x * WorldStreaming::Chunk::SIZE;
-    int oy = chunk.coord.y * WorldStreaming::Chunk::SIZE;
-
-    for (int lx = 0; lx < WorldStreaming::Chunk::SIZE; ++lx)
-    {
-        int wx = ox + lx;
-        int surfY = SurfaceHeight(wx, profile);
-
-        for (int ly = 0; ly < WorldStreaming::Chunk::SIZE; ++ly)
-        {
-            int wy = oy + ly;
-
-            if (wy < surfY)
-            {
-                chunk.SetTile(lx, ly, PixelType::Air);
-                continue;
-            }
-
-            int depth = wy - surfY;
-
-            if (depth < 3)
-            {
-                chunk.SetTile(lx, ly, PixelType::Sand);
-                continue;
-            }
-
-            if (IsCave(wx, wy, profile))
-            {
-                chunk.SetTile(lx, ly, PixelType::Air);
-                continue;
-            }
+    int w = (int)world.GetWidth();
+    int h = (int)world.GetHeight();
 
-            if (depth > 80)
-            {
-                float pool = NoiseGenerator::Perlin(
-                    (float)wx * 0.08f, (float)wy * 0.08f, profile.seed + 777);
-                if (pool > 0.75f)
-                {
-                    chunk.SetTile(lx, ly, (depth > 120) ? PixelType::Lava : PixelType::Water);
-                    continue;
-                }
-            }
+    std::vector<int> surface(w);
+    int minSurf = SurfaceHeights(0, w, surface.data(), profile);
+    std::vector<float> cave(w);
+    std::vector<float> pool(w);
+    std::vector<uint16_t> row(w);
 
-            chunk.SetTile(lx, ly, PixelType::Stone);
-        }
+    // 按行批量采样；地表以上和沙层不需要噪声
+    for (int y = 0; y < h; ++y)
+    {
+        int maxDepth = y - minSurf;
+        if (maxDepth >= SandDepth) CaveNoise(0, y, w, 1, cave.data(), profile);
+        if (maxDepth > PoolDepth) PoolNoise(0, y, w, 1, pool.data(), profile);
+
+        for (int x = 0; x < w; ++x)
+            row[x] = Classify(y - surface[x], cave[x], pool[x], profile);
+        ApplyOres(0, y, w, 1, surface.data(), minSurf, row.data(), cave.data(), profile);
+        for (int x = 0; x < w; ++x)
+            world.SetPixel(x, y, (PixelType::Value)row[x]);
     }
 }
+
+void TerrainGenerator::GenerateForChunk(WorldStreaming::Chunk& chunk, const TerrainProfile& profile)
+{
+    TerrainPipeline(profile).Generate(chunk);
+}
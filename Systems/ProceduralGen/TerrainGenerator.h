@@ -2,10 +2,23 @@
 #define TERRAIN_GENERATOR_H
 
 #include <cstdint>
+#include <vector>
 
 class PixelWorld;
 namespace WorldStreaming { class Chunk; }
 
+/**
+ * @brief 矿脉层：地表以下不浅于 minDepth 的石头中，噪声高于 threshold 处替换为 material。
+ */
+struct OreLayer
+{
+    uint16_t material = 0;
+    int minDepth = 0;
+    float frequency = 0.1f;
+    float threshold = 0.8f;
+    int seedOffset = 0;
+};
+
 struct TerrainProfile
 {
     int surfaceBaseY = 256;
@@ -14,6 +27,7 @@ struct TerrainProfile
     float caveThreshold = 0.4f;
     float caveFrequency = 0.05f;
     int seed = 42;
+    std::vector<OreLayer> ores;  ///< 按顺序应用，后面的层可以覆盖前面的。
 };
 
 class TerrainGenerator
@@ -22,9 +36,25 @@ public:
     static void GenerateForPixelWorld(PixelWorld& world, const TerrainProfile& profile);
     static void GenerateForChunk(WorldStreaming::Chunk& chunk, const TerrainProfile& profile);
 
-private:
-    static int SurfaceHeight(int worldX, const TerrainProfile& profile);
-    static bool IsCave(int worldX, int worldY, const TerrainProfile& profile);
+    // 以下是 TerrainPipeline 各阶段使用的单阶段接口
+    static constexpr int SandDepth = 3;
+    static constexpr int PoolDepth = 80;
+    static constexpr int LavaDepth = 120;
+
+    /// 连续 count 列的地表高度，返回其中的最小值。
+    static int SurfaceHeights(int worldX, int count, int* out, const TerrainProfile& profile);
+    /// 以 (worldX, worldY) 为左上角的 width x height 洞穴噪声，小于 caveThreshold 为洞穴。
+    static void CaveNoise(int worldX, int worldY, int width, int height, float* out, const TerrainProfile& profile);
+    static void PoolNoise(int worldX, int worldY, int width, int height, float* out, const TerrainProfile& profile);
+    /// 地表以下 depth 处的瓦片类型。
+    static uint16_t Classify(int depth, float cave, float pool, const TerrainProfile& profile);
+    /**
+     * @brief 把以 (worldX, worldY) 为左上角的 width x height 行主序瓦片中的石头按矿脉层替换。
+     * @param surface 各列的地表高度，minSurface 为其最小值。
+     * @param scratch 至少 width * height 个的临时缓冲。
+     */
+    static void ApplyOres(int worldX, int worldY, int width, int height, const int* surface, int minSurface,
+                          uint16_t* tiles, float* scratch, const TerrainProfile& profile);
 };
 
 #endif
@@ -0,0 +1,209 @@
+#include "TerrainPipeline.h"
+#include "../../Event/JobSystem.h"
+#include "../../Utils/Logger.h"
+#include <algorithm>
+
+TerrainPipeline::TerrainPipeline(const TerrainProfile& profile, int chunkSize)
+    : m_profile(profile)
+    , m_chunkSize(std::max(chunkSize, 1))
+{
+}
+
+void TerrainPipeline::Generate(int worldX, int worldY, uint16_t* tiles)
+{
+    Work work;
+    work.request = {worldX, worldY, tiles};
+    work.columns = FindColumns(worldX);
+    if (!work.columns)
+        work.columns = StoreColumns(worldX, BuildColumns(worldX));
+    DensityStage(work);
+    MaterialStage(work);
+    DecorationStage(work);
+    ++m_chunks;
+}
+
+void TerrainPipeline::Generate(WorldStreaming::Chunk& chunk)
+{
+    if (m_chunkSize != WorldStreaming::Chunk::SIZE)
+    {
+        LogError("TerrainPipeline: chunk size {} does not match WorldStreaming::Chunk::SIZE", m_chunkSize);
+        return;
+    }
+    std::vector<uint16_t> tiles(static_cast<size_t>(m_chunkSize) * m_chunkSize);
+    Generate(chunk.coord.x * m_chunkSize, chunk.coord.y * m_chunkSize, tiles.data());
+    chunk.SetTiles(tiles.data());
+}
+
+void TerrainPipeline::GenerateBatch(std::span<const Request> requests)
+{
+    if (requests.empty()) return;
+    std::vector<Work> works(requests.size());
+
+    // 阶段一：地表高度。缓存中没有的列条带每条只算一次
+    std::vector<int> missing;
+    for (size_t i = 0; i < requests.size(); ++i)
+    {
+        works[i].request = requests[i];
+        works[i].columns = FindColumns(requests[i].worldX);
+        if (!works[i].columns && std::find(missing.begin(), missing.end(), requests[i].worldX) == missing.end())
+            missing.push_back(requests[i].worldX);
+    }
+    std::vector<std::shared_ptr<const Columns>> built(missing.size());
+    JobSystem::ParallelFor(missing.size(), [&](size_t i) { built[i] = BuildColumns(missing[i]); });
+    for (size_t i = 0; i < missing.size(); ++i)
+        built[i] = StoreColumns(missing[i], std::move(built[i]));
+    for (Work& work : works)
+    {
+        if (work.columns) continue;
+        const size_t index = static_cast<size_t>(std::find(missing.begin(), missing.end(), work.request.worldX) -
+                                                 missing.begin());
+        work.columns = built[index];
+    }
+
+    JobSystem::ParallelFor(works.size(), [&](size_t i) { DensityStage(works[i]); });
+    JobSystem::ParallelFor(works.size(), [&](size_t i) { MaterialStage(works[i]); });
+    if (!m_profile.ores.empty())
+        JobSystem::ParallelFor(works.size(), [&](size_t i) { DecorationStage(works[i]); });
+    m_chunks += works.size();
+}
+
+void TerrainPipeline::GenerateBatch(std::span<WorldStreaming::Chunk* const> chunks)
+{
+    if (m_chunkSize != WorldStreaming::Chunk::SIZE)
+    {
+        LogError("TerrainPipeline: chunk size {} does not match WorldStreaming::Chunk::SIZE", m_chunkSize);
+        return;
+    }
+    const size_t area = static_cast<size_t>(m_chunkSize) * m_chunkSize;
+    std::vector<uint16_t> tiles(area * chunks.size());
+    std::vector<Request> requests;
+    requests.reserve(chunks.size());
+    for (size_t i = 0; i < chunks.size(); ++i)
+    {
+        requests.push_back({chunks[i]->coord.x * m_chunkSize, chunks[i]->coord.y * m_chunkSize,
+                            tiles.data() + i * area});
+    }
+    GenerateBatch(requests);
+    for (size_t i = 0; i < chunks.size(); ++i)
+        chunks[i]->SetTiles(tiles.data() + i * area);
+}
+
+void TerrainPipeline::SetMaxCachedColumns(size_t count)
+{
+    std::lock_guard<std::mutex> lock(m_cacheMutex);
+    m_maxCachedColumns = count;
+    while (m_columnOrder.size() > m_maxCachedColumns)
+    {
+        m_columnCache.erase(m_columnOrder.front());
+        m_columnOrder.pop_front();
+    }
+}
+
+void TerrainPipeline::ClearColumnCache()
+{
+    std::lock_guard<std::mutex> lock(m_cacheMutex);
+    m_columnCache.clear();
+    m_columnOrder.clear();
+}
+
+size_t TerrainPipeline::GetCachedColumnCount() const
+{
+    std::lock_guard<std::mutex> lock(m_cacheMutex);
+    return m_columnCache.size();
+}
+
+TerrainPipeline::Stats TerrainPipeline::GetStats() const
+{
+    Stats stats;
+    stats.chunks = m_chunks.load();
+    stats.columnHits = m_columnHits.load();
+    stats.columnMisses = m_columnMisses.load();
+    return stats;
+}
+
+std::shared_ptr<const TerrainPipeline::Columns> TerrainPipeline::FindColumns(int worldX) const
+{
+    std::lock_guard<std::mutex> lock(m_cacheMutex);
+    auto it = m_columnCache.find(worldX);
+    if (it == m_columnCache.end()) return nullptr;
+    ++m_columnHits;
+    return it->second;
+}
+
+std::shared_ptr<const TerrainPipeline::Columns> TerrainPipeline::BuildColumns(int worldX) const
+{
+    auto columns = std::make_shared<Columns>();
+    columns->surface.resize(static_cast<size_t>(m_chunkSize));
+    columns->minSurface = TerrainGenerator::SurfaceHeights(worldX, m_chunkSize, columns->surface.data(), m_profile);
+    ++m_columnMisses;
+    return columns;
+}
+
+std::shared_ptr<const TerrainPipeline::Columns> TerrainPipeline::StoreColumns(int worldX,
+                                                                              std::shared_ptr<const Columns> columns)
+{
+    std::lock_guard<std::mutex> lock(m_cacheMutex);
+    // 并发的 Generate 可能同时算了同一条，结果相同，保留先存入的
+    auto [it, inserted] = m_columnCache.emplace(worldX, std::move(columns));
+    if (!inserted) return it->second;
+    auto result = it->second;
+    m_columnOrder.push_back(worldX);
+    while (m_columnOrder.size() > m_maxCachedColumns)
+    {
+        m_columnCache.erase(m_columnOrder.front());
+        m_columnOrder.pop_front();
+    }
+    return result;
+}
+
+void TerrainPipeline::DensityStage(Work& work) const
+{
+    const int size = m_chunkSize;
+    const Request& request = work.request;
+    const int minSurface = work.columns->minSurface;
+
+    // 只对可能用到噪声的行采样：洞穴从沙层以下开始，液池从 PoolDepth 以下开始
+    work.caveRow = std::clamp(minSurface + TerrainGenerator::SandDepth - request.worldY, 0, size);
+    work.poolRow = std::clamp(minSurface + TerrainGenerator::PoolDepth + 1 - request.worldY, 0, size);
+    work.cave.resize(static_cast<size_t>(size) * size);
+    if (work.caveRow < size)
+    {
+        TerrainGenerator::CaveNoise(request.worldX, request.worldY + work.caveRow, size, size - work.caveRow,
+                                    work.cave.data() + static_cast<size_t>(work.caveRow) * size, m_profile);
+    }
+    if (work.poolRow < size)
+    {
+        work.pool.resize(static_cast<size_t>(size) * size);
+        TerrainGenerator::PoolNoise(request.worldX, request.worldY + work.poolRow, size, size - work.poolRow,
+                                    work.pool.data() + static_cast<size_t>(work.poolRow) * size, m_profile);
+    }
+}
+
+void TerrainPipeline::MaterialStage(Work& work) const
+{
+    const int size = m_chunkSize;
+    const Request& request = work.request;
+    const int* surface = work.columns->surface.data();
+
+    for (int y = 0; y < size; ++y)
+    {
+        const bool hasCave = y >= work.caveRow;
+        const bool hasPool = y >= work.poolRow;
+        for (int x = 0; x < size; ++x)
+        {
+            const size_t i = static_cast<size_t>(y) * size + x;
+            request.tiles[i] = TerrainGenerator::Classify(request.worldY + y - surface[x],
+                                                          hasCave ? work.cave[i] : 1.0f,
+                                                          hasPool ? work.pool[i] : 0.0f, m_profile);
+        }
+    }
+}
+
+void TerrainPipeline::DecorationStage(Work& work) const
+{
+    if (m_profile.ores.empty()) return;
+    // 洞穴噪声在材质阶段之后不再需要，复用为矿脉噪声缓冲
+    TerrainGenerator::ApplyOres(work.request.worldX, work.request.worldY, m_chunkSize, m_chunkSize,
+                                work.columns->surface.data(), work.columns->minSurface, work.request.tiles,
+                                work.cave.data(), m_profile);
+}
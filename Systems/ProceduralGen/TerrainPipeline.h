@@ -0,0 +1,104 @@
+#ifndef TERRAIN_PIPELINE_H
+#define TERRAIN_PIPELINE_H
+
+#include "TerrainGenerator.h"
+#include "../WorldStreaming/Chunk.h"
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief 分阶段的整区块地形生成。
+ *
+ * 每个区块依次经过四个阶段：地表高度列、洞穴与液池密度、材质分配、矿脉装饰。GenerateBatch 对一批区块逐阶段并行，
+ * 每个阶段把所有区块分发到 JobSystem，全部完成后才进入下一阶段。地表高度按列条带缓存，同一列上下相邻的区块共用一份。
+ * 输出只取决于 TerrainProfile 与区块位置，与线程数、批次划分和缓存状态无关。
+ */
+class TerrainPipeline
+{
+public:
+    /// 左上角的世界瓦片坐标，tiles 为 chunkSize * chunkSize 个的行主序输出。
+    struct Request
+    {
+        int worldX;
+        int worldY;
+        uint16_t* tiles;
+    };
+
+    struct Stats
+    {
+        uint64_t chunks = 0;
+        uint64_t columnHits = 0;    ///< 地表高度直接取自缓存的区块数。
+        uint64_t columnMisses = 0;  ///< 需要重新计算地表高度的列条带数。
+    };
+
+    static constexpr size_t DefaultMaxCachedColumns = 1024;
+
+    explicit TerrainPipeline(const TerrainProfile& profile, int chunkSize = WorldStreaming::Chunk::SIZE);
+
+    const TerrainProfile& GetProfile() const { return m_profile; }
+    int GetChunkSize() const { return m_chunkSize; }
+
+    /**
+     * @brief 在调用线程上依次执行各阶段生成一个区块。可以从多个线程并发调用（例如作为 ChunkManager 的生成函数）。
+     */
+    void Generate(int worldX, int worldY, uint16_t* tiles);
+    void Generate(WorldStreaming::Chunk& chunk);
+
+    /**
+     * @brief 逐阶段并行生成一批区块，阻塞到全部完成。
+     */
+    void GenerateBatch(std::span<const Request> requests);
+    void GenerateBatch(std::span<WorldStreaming::Chunk* const> chunks);
+
+    /// 超出上限时按插入顺序淘汰最早的列条带。
+    void SetMaxCachedColumns(size_t count);
+    void ClearColumnCache();
+    size_t GetCachedColumnCount() const;
+    Stats GetStats() const;
+
+private:
+    struct Columns
+    {
+        std::vector<int> surface;
+        int minSurface = 0;
+    };
+
+    /// 一个区块在各阶段之间传递的中间数据。
+    struct Work
+    {
+        Request request{};
+        std::shared_ptr<const Columns> columns;
+        std::vector<float> cave;  ///< 材质阶段之后复用为装饰阶段的噪声缓冲。
+        std::vector<float> pool;
+        int caveRow = 0;  ///< 之前的行不可能出现洞穴，未采样。
+        int poolRow = 0;
+    };
+
+    std::shared_ptr<const Columns> FindColumns(int worldX) const;
+    std::shared_ptr<const Columns> BuildColumns(int worldX) const;
+    std::shared_ptr<const Columns> StoreColumns(int worldX, std::shared_ptr<const Columns> columns);
+
+    void DensityStage(Work& work) const;
+    void MaterialStage(Work& work) const;
+    void DecorationStage(Work& work) const;
+
+    TerrainProfile m_profile;
+    int m_chunkSize;
+
+    mutable std::mutex m_cacheMutex;
+    std::unordered_map<int, std::shared_ptr<const Columns>> m_columnCache;
+    std::deque<int> m_columnOrder;  ///< 缓存的插入顺序。
+    size_t m_maxCachedColumns = DefaultMaxCachedColumns;
+
+    std::atomic<uint64_t> m_chunks{0};
+    mutable std::atomic<uint64_t> m_columnHits{0};
+    mutable std::atomic<uint64_t> m_columnMisses{0};
+};
+
+#endif
@@ -0,0 +1,858 @@
+#ifndef CHUNK_STREAMING_TESTS_H
+#define CHUNK_STREAMING_TESTS_H
+
+/**
+ * @file ChunkStreamingTests.h
+ * @brief Property-based tests and benchmark for asynchronous chunk streaming in WorldStreaming::ChunkManager
+ *
+ * Feature: async-chunk-streaming
+ */
+
+#include "../WorldStreaming/ChunkManager.h"
+#include "../../Utils/Logger.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace ChunkStreamingTests
+{
+    using WorldStreaming::Chunk;
+    using WorldStreaming::ChunkCoord;
+    using WorldStreaming::ChunkCoordHash;
+    using WorldStreaming::ChunkManager;
+
+    /**
+     * @brief Random generator for chunk streaming tests
+     */
+    class StreamingRandomGenerator
+    {
+    public:
+        explicit StreamingRandomGenerator(unsigned int seed) : m_gen(seed) {}
+
+        float RandomFloat(float min, float max)
+        {
+            std::uniform_real_distribution<float> dist(min, max);
+            return dist(m_gen);
+        }
+
+        int RandomInt(int min, int max)
+        {
+            std::uniform_int_distribution<int> dist(min, max);
+            return dist(m_gen);
+        }
+
+        std::mt19937& Engine() { return m_gen; }
+
+    private:
+        std::mt19937 m_gen;
+    };
+
+    /**
+     * @brief Test result structure for detailed failure reporting
+     */
+    struct TestResult
+    {
+        bool passed = true;
+        std::string failureMessage;
+        int failedIteration = -1;
+    };
+
+    inline bool RunTest(const char* name, const TestResult& result)
+    {
+        if (result.passed)
+        {
+            LogInfo("{} PASSED", name);
+            return true;
+        }
+        LogError("{} FAILED at iteration {}: {}", name, result.failedIteration, result.failureMessage);
+        return false;
+    }
+
+    /**
+     * @brief Deterministic tile id for a global tile position, used as generated content
+     */
+    inline uint16_t ExpectedTile(int32_t chunkX, int32_t chunkY, int x, int y)
+    {
+        uint32_t h = static_cast<uint32_t>(chunkX) * 73856093u ^ static_cast<uint32_t>(chunkY) * 19349663u ^
+            static_cast<uint32_t>(x) * 83492791u ^ static_cast<uint32_t>(y) * 2654435761u;
+        h ^= h >> 13;
+        return static_cast<uint16_t>(h % 251u + 1u);
+    }
+
+    /**
+     * @brief Chunk generator filling every tile with ExpectedTile, optionally burning extra time per tile
+     */
+    inline ChunkManager::ChunkCallback MakeGenerator(int workPerTile = 0)
+    {
+        return [workPerTile](Chunk& chunk)
+        {
+            float sink = 0.0f;
+            for (int y = 0; y < Chunk::SIZE; ++y)
+            {
+                for (int x = 0; x < Chunk::SIZE; ++x)
+                {
+                    for (int k = 0; k < workPerTile; ++k)
+                        sink += std::sin(static_cast<float>(x * k + y));
+                    chunk.SetTile(x, y, static_cast<uint16_t>(ExpectedTile(chunk.coord.x, chunk.coord.y, x, y) +
+                                                              (sink > 1e30f ? 1 : 0)));
+                }
+            }
+        };
+    }
+
+    /**
+     * @brief Records onLoad/onUnload callbacks and checks their invariants as they happen
+     */
+    class StreamingObserver
+    {
+    public:
+        struct Event
+        {
+            ChunkCoord coord;
+            bool load;
+            int frame;
+        };
+
+        StreamingObserver(ChunkManager& manager, int unloadRadius) : m_manager(manager), m_unloadRadius(unloadRadius)
+        {
+            manager.SetOnChunkLoad([this](Chunk& chunk) { OnLoad(chunk); });
+            manager.SetOnChunkUnload([this](Chunk& chunk) { OnUnload(chunk); });
+        }
+
+        void BeginFrame(int frame, ChunkCoord view)
+        {
+            m_frame = frame;
+            m_view = view;
+            m_loadedThisFrame = false;
+        }
+
+        bool Failed() const { return !m_error.empty(); }
+        const std::string& Error() const { return m_error; }
+        const std::vector<Event>& Events() const { return m_events; }
+        const std::unordered_map<ChunkCoord, bool, ChunkCoordHash>& State() const { return m_loaded; }
+
+        size_t LoadedCount() const
+        {
+            return static_cast<size_t>(std::count_if(m_loaded.begin(), m_loaded.end(),
+                                                     [](const auto& entry) { return entry.second; }));
+        }
+
+    private:
+        void Fail(const std::string& message)
+        {
+            if (m_error.empty()) m_error = message;
+        }
+
+        void OnLoad(Chunk& chunk)
+        {
+            const ChunkCoord cc = chunk.coord;
+            std::ostringstream where;
+            where << "chunk (" << cc.x << "," << cc.y << ") frame " << m_frame;
+            if (m_loaded[cc]) Fail("onLoad twice without onUnload for " + where.str());
+            if (m_manager.GetChunk(cc)) Fail("onLoad for a chunk already visible in the manager: " + where.str());
+            const int dx = cc.x - m_view.x;
+            const int dy = cc.y - m_view.y;
+            if (dx * dx + dy * dy > m_unloadRadius * m_unloadRadius)
+                Fail("onLoad for a chunk outside the unload radius (should have been cancelled): " + where.str());
+            if (chunk.GetTile(0, 0) != ExpectedTile(cc.x, cc.y, 0, 0) ||
+                chunk.GetTile(Chunk::SIZE - 1, Chunk::SIZE - 1) !=
+                ExpectedTile(cc.x, cc.y, Chunk::SIZE - 1, Chunk::SIZE - 1))
+                Fail("generated content not visible in onLoad: " + where.str());
+            m_loaded[cc] = true;
+            m_loadedThisFrame = true;
+            m_events.push_back({cc, true, m_frame});
+        }
+
+        void OnUnload(Chunk& chunk)
+        {
+            const ChunkCoord cc = chunk.coord;
+            std::ostringstream where;
+            where << "chunk (" << cc.x << "," << cc.y << ") frame " << m_frame;
+            auto it = m_loaded.find(cc);
+            if (it == m_loaded.end() || !it->second) Fail("onUnload without a matching onLoad for " + where.str());
+            if (m_manager.GetChunk(cc) != &chunk) Fail("onUnload for a chunk the manager does not hold: " + where.str());
+            if (m_loadedThisFrame) Fail("onUnload after an onLoad in the same update: " + where.str());
+            m_loaded[cc] = false;
+            m_events.push_back({cc, false, m_frame});
+        }
+
+        ChunkManager& m_manager;
+        int m_unloadRadius;
+        int m_frame = 0;
+        ChunkCoord m_view{};
+        bool m_loadedThisFrame = false;
+        std::unordered_map<ChunkCoord, bool, ChunkCoordHash> m_loaded;
+        std::vector<Event> m_events;
+        std::string m_error;
+    };
+
+    /**
+     * @brief Checks the manager's loaded set against the observer and the radii after a Flush
+     */
+    inline bool CheckSettled(const ChunkManager& manager, const StreamingObserver& observer, ChunkCoord view,
+                             int loadRadius, int unloadRadius, std::string& error)
+    {
+        if (manager.GetPendingCount() != 0 || manager.GetInFlightCount() != 0 || manager.GetReadyCount() != 0)
+        {
+            error = "Flush left requests outstanding";
+            return false;
+        }
+        for (int dy = -loadRadius; dy <= loadRadius; ++dy)
+        {
+            for (int dx = -loadRadius; dx <= loadRadius; ++dx)
+            {
+                if (dx * dx + dy * dy <= unloadRadius * unloadRadius && !manager.GetChunk({view.x + dx, view.y + dy}))
+                {
+                    error = "chunk inside the load radius missing after Flush";
+                    return false;
+                }
+            }
+        }
+        if (static_cast<size_t>(manager.GetLoadedChunkCount()) != observer.LoadedCount())
+        {
+            error = "manager and callbacks disagree on the number of loaded chunks";
+            return false;
+        }
+        for (const auto& [coord, loaded] : observer.State())
+        {
+            if (loaded != (manager.GetChunk(coord) != nullptr))
+            {
+                error = "manager and callbacks disagree on a chunk's state";
+                return false;
+            }
+            const int dx = coord.x - view.x;
+            const int dy = coord.y - view.y;
+            if (loaded && dx * dx + dy * dy > unloadRadius * unloadRadius)
+            {
+                error = "chunk outside the unload radius still loaded after Flush";
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Property: along random camera paths every chunk gets alternating onLoad/onUnload callbacks, each
+     * exactly once per residency; unloads of an update precede its loads; generated content is visible in onLoad;
+     * chunks that leave the radius before integration never fire callbacks; Flush and Clear settle consistently
+     */
+    inline TestResult TestProperty_CallbacksFireOncePerChunk(int iterations = 100)
+    {
+        TestResult result;
+        StreamingRandomGenerator gen(41u);
+        const float chunkWorld = 16.0f * Chunk::SIZE;
+
+        for (int i = 0; i < iterations; ++i)
+        {
+            const int loadRadius = gen.RandomInt(1, 4);
+            const int unloadRadius = loadRadius + gen.RandomInt(1, 3);
+
+            ChunkManager manager;
+            manager.SetLoadRadius(loadRadius);
+            manager.SetUnloadRadius(unloadRadius);
+            manager.SetMaxInFlight(gen.RandomInt(1, 6));
+            manager.SetIntegrationBudget(gen.RandomInt(0, 2) == 0 ? 0.0 : gen.RandomFloat(0.0f, 0.5f));
+            manager.SetLookAhead(gen.RandomFloat(0.0f, 1.0f));
+            manager.SetChunkGenerator(MakeGenerator(gen.RandomInt(0, 3) == 0 ? 2 : 0));
+            StreamingObserver observer(manager, unloadRadius);
+
+            float camX = gen.RandomFloat(-4.0f, 4.0f) * chunkWorld;
+            float camY = gen.RandomFloat(-4.0f, 4.0f) * chunkWorld;
+            float velX = 0.0f;
+            float velY = 0.0f;
+            const int frames = gen.RandomInt(20, 120);
+            for (int frame = 0; frame < frames; ++frame)
+            {
+                switch (gen.RandomInt(0, 19))
+                {
+                case 0:
+                    // 传送
+                    camX += gen.RandomFloat(-3.0f, 3.0f) * static_cast<float>(unloadRadius) * chunkWorld;
+                    camY += gen.RandomFloat(-3.0f, 3.0f) * static_cast<float>(unloadRadius) * chunkWorld;
+                    break;
+                case 1:
+                case 2:
+                    velX = gen.RandomFloat(-12.0f, 12.0f) * chunkWorld;
+                    velY = gen.RandomFloat(-12.0f, 12.0f) * chunkWorld;
+                    break;
+                default:
+                    break;
+                }
+                const float dt = 1.0f / 60.0f;
+                camX += velX * dt;
+                camY += velY * dt;
+                manager.SetViewCenter(camX, camY);
+                observer.BeginFrame(frame, {static_cast<int32_t>(std::floor(camX / chunkWorld)),
+                                            static_cast<int32_t>(std::floor(camY / chunkWorld))});
+                manager.Update(gen.RandomInt(0, 9) == 0 ? 0.0f : dt);
+                if (observer.Failed()) break;
+            }
+
+            const ChunkCoord view{static_cast<int32_t>(std::floor(camX / chunkWorld)),
+                                  static_cast<int32_t>(std::floor(camY / chunkWorld))};
+            std::string error = observer.Error();
+            if (error.empty())
+            {
+                observer.BeginFrame(frames, view);
+                manager.Flush();
+                error = observer.Error();
+            }
+            if (error.empty())
+                CheckSettled(manager, observer, view, loadRadius, unloadRadius, error);
+            if (error.empty())
+            {
+                observer.BeginFrame(frames + 1, view);
+                manager.Clear();
+                error = observer.Error();
+                if (error.empty() && (manager.GetLoadedChunkCount() != 0 || observer.LoadedCount() != 0))
+                    error = "Clear left chunks loaded";
+            }
+            if (error.empty())
+            {
+                size_t loads = 0;
+                for (const auto& event : observer.Events())
+                    loads += event.load ? 1 : 0;
+                const auto& stats = manager.GetStats();
+                if (stats.loaded != loads || stats.unloaded != observer.Events().size() - loads)
+                    error = "stats disagree with the callbacks";
+                else if (stats.generated < stats.loaded)
+                    error = "more chunks loaded than generated";
+            }
+
+            if (!error.empty())
+            {
+                std::ostringstream oss;
+                oss << error << " (loadRadius=" << loadRadius << ", unloadRadius=" << unloadRadius
+                    << ", frames=" << frames << ")";
+                result.passed = false;
+                result.failedIteration = i;
+                result.failureMessage = oss.str();
+                return result;
+            }
+        }
+        return result;
+    }
+
+    /**
+     * @brief Property: repeated teleports while generation is slow cancel the stale requests instead of loading
+     * them, including when the camera jumps back before the cancelled jobs finish, and the callbacks still pair up
+     */
+    inline TestResult TestProperty_TeleportsCancelStaleChunks(int iterations = 30)
+    {
+        TestResult result;
+        StreamingRandomGenerator gen(42u);
+        const float chunkWorld = 16.0f * Chunk::SIZE;
+
+        for (int i = 0; i < iterations; ++i)
+        {
+            const int loadRadius = gen.RandomInt(2, 4);
+            const int unloadRadius = loadRadius + 1;
+
+            ChunkManager manager;
+            manager.SetLoadRadius(loadRadius);
+            manager.SetUnloadRadius(unloadRadius);
+            manager.SetMaxInFlight(gen.RandomInt(1, 4));
+            manager.SetChunkGenerator(MakeGenerator(4));
+            StreamingObserver observer(manager, unloadRadius);
+
+            ChunkCoord view{};
+            ChunkCoord previous{};
+            const int teleports = gen.RandomInt(3, 8);
+            for (int t = 0; t < teleports; ++t)
+            {
+                // 每次都跳出卸载半径，上一处的请求全部作废；跳回原处时旧任务的结果也不能接入
+                const ChunkCoord from = view;
+                if (t > 0 && gen.RandomInt(0, 2) == 0)
+                {
+                    view = previous;
+                }
+                else
+                {
+                    view.x += (gen.RandomInt(0, 1) ? 1 : -1) * (2 * unloadRadius + gen.RandomInt(1, 5));
+                    view.y += gen.RandomInt(-unloadRadius, unloadRadius);
+                }
+                previous = from;
+                manager.SetViewCenter((static_cast<float>(view.x) + 0.5f) * chunkWorld,
+                                      (static_cast<float>(view.y) + 0.5f) * chunkWorld);
+                observer.BeginFrame(t, view);
+                manager.Update();
+                if (observer.Failed()) break;
+                // 给工作线程一点时间，使部分任务在取消前已经开始或完成
+                std::this_thread::sleep_for(std::chrono::microseconds(gen.RandomInt(0, 600)));
+            }
+
+            std::string error = observer.Error();
+            if (error.empty())
+            {
+                observer.BeginFrame(teleports, view);
+                manager.Flush();
+                error = observer.Error();
+            }
+            if (error.empty())
+                CheckSettled(manager, observer, view, loadRadius, unloadRadius, error);
+            if (error.empty() && manager.GetStats().cancelled == 0)
+                error = "no request was cancelled across teleports";
+            if (error.empty())
+            {
+                for (const auto& [coord, loaded] : observer.State())
+                {
+                    const int dx = coord.x - view.x;
+                    const int dy = coord.y - view.y;
+                    if (dx * dx + dy * dy > unloadRadius * unloadRadius && loaded)
+                    {
+                        error = "chunk from an earlier position still loaded";
+                        break;
+                    }
+                }
+            }
+
+            if (!error.empty())
+            {
+                std::ostringstream oss;
+                oss << error << " (loadRadius=" << loadRadius << ", teleports=" << teleports << ")";
+                result.passed = false;
+                result.failedIteration = i;
+                result.failureMessage = oss.str();
+                return result;
+            }
+        }
+        return result;
+    }
+
+    /**
+     * @brief Property: while the camera moves steadily, chunks ahead of it are loaded before chunks behind it
+     */
+    inline TestResult TestProperty_LookAheadPrefersTravelDirection(int iterations = 50)
+    {
+        TestResult result;
+        StreamingRandomGenerator gen(43u);
+        const float chunkWorld = 16.0f * Chunk::SIZE;
+
+        for (int i = 0; i < iterations; ++i)
+        {
+            const int loadRadius = gen.RandomInt(3, 5);
+            const float angle = gen.RandomFloat(0.0f, 6.2831853f);
+            const float dirX = std::cos(angle);
+            const float dirY = std::sin(angle);
+            const float speed = gen.RandomFloat(4.0f, 10.0f) * chunkWorld;
+
+            ChunkManager manager;
+            manager.SetLoadRadius(loadRadius);
+            manager.SetUnloadRadius(loadRadius + 2);
+            manager.SetMaxInFlight(1);
+            manager.SetLookAhead(1.0f);
+            manager.SetChunkGenerator(MakeGenerator());
+
+            float camX = 0.5f * chunkWorld;
+            float camY = 0.5f * chunkWorld;
+            std::vector<float> ahead;
+            manager.SetOnChunkLoad([&](Chunk& chunk)
+            {
+                const float dx = (static_cast<float>(chunk.coord.x) + 0.5f) * chunkWorld - camX;
+                const float dy = (static_cast<float>(chunk.coord.y) + 0.5f) * chunkWorld - camY;
+                ahead.push_back((dx * dirX + dy * dirY) / chunkWorld);
+            });
+
+            // 逐帧等待生成完成，使每帧恰好接入一个区块，加载顺序只取决于优先级
+            const float dt = 1.0f / 60.0f;
+            const int side = 2 * loadRadius + 1;
+            const int frames = side * side / 3;
+            for (int frame = 0; frame < frames; ++frame)
+            {
+                camX += dirX * speed * dt;
+                camY += dirY * speed * dt;
+                manager.SetViewCenter(camX, camY);
+                manager.Update(dt);
+                manager.WaitForInFlight();
+            }
+
+            // 速度估计收敛之后的加载应明显偏向前方
+            const size_t skip = 8;
+            if (ahead.size() <= skip + 4)
+            {
+                result.passed = false;
+                result.failedIteration = i;
+                result.failureMessage = "too few chunks loaded to judge the order";
+                return result;
+            }
+            float sum = 0.0f;
+            for (size_t k = skip; k < ahead.size(); ++k)
+                sum += ahead[k];
+            const float mean = sum / static_cast<float>(ahead.size() - skip);
+            if (mean < 0.5f)
+            {
+                std::ostringstream oss;
+                oss << "loads not biased towards travel direction: mean offset " << mean << " chunks (loadRadius="
+                    << loadRadius << ", speed=" << speed / chunkWorld << " chunks/s)";
+                result.passed = false;
+                result.failedIteration = i;
+                result.failureMessage = oss.str();
+                return result;
+            }
+        }
+        return result;
+    }
+
+    /**
+     * @brief Brute-force residency rules: a chunk stays while within the unload circle, and every chunk of the load
+     * square that is also inside the unload circle is resident
+     */
+    struct ResidencyReference
+    {
+        int loadRadius = 0;
+        int unloadRadius = 0;
+
+        bool InKeep(ChunkCoord c, ChunkCoord center) const
+        {
+            const int dx = c.x - center.x;
+            const int dy = c.y - center.y;
+            return dx * dx + dy * dy <= unloadRadius * unloadRadius;
+        }
+
+        bool InLoad(ChunkCoord c, ChunkCoord center) const
+        {
+            return std::abs(c.x - center.x) <= loadRadius && std::abs(c.y - center.y) <= loadRadius &&
+                InKeep(c, center);
+        }
+
+        void Apply(std::unordered_set<ChunkCoord, ChunkCoordHash>& resident, ChunkCoord center) const
+        {
+            for (auto it = resident.begin(); it != resident.end();)
+                it = InKeep(*it, center) ? std::next(it) : resident.erase(it);
+            for (int y = center.y - loadRadius; y <= center.y + loadRadius; ++y)
+            {
+                for (int x = center.x - loadRadius; x <= center.x + loadRadius; ++x)
+                {
+                    if (InLoad({x, y}, center)) resident.insert({x, y});
+                }
+            }
+        }
+
+        /// Coordinates an incremental update from @p from to @p to has to look at: leaving the unload circle
+        /// plus entering the load region
+        uint64_t DifferenceSize(ChunkCoord from, ChunkCoord to) const
+        {
+            const int r = std::max(loadRadius, unloadRadius);
+            uint64_t count = 0;
+            for (int y = from.y - r; y <= from.y + r; ++y)
+            {
+                for (int x = from.x - r; x <= from.x + r; ++x)
+                    count += InKeep({x, y}, from) && !InKeep({x, y}, to);
+            }
+            for (int y = to.y - r; y <= to.y + r; ++y)
+            {
+                for (int x = to.x - r; x <= to.x + r; ++x)
+                    count += InLoad({x, y}, to) && !InLoad({x, y}, from);
+            }
+            return count;
+        }
+    };
+
+    /**
+     * @brief Property: along random camera paths (drifting inside a chunk, stepping to neighbours, teleporting, with
+     * occasional radius changes and Clear) the resident set after Flush equals a brute-force reference, staying in
+     * one chunk costs no residency checks at all, and moving checks exactly the coordinates that differ between the
+     * old and new ranges
+     */
+    inline TestResult TestProperty_ResidencyMatchesBruteForce(int iterations = 60)
+    {
+        TestResult result;
+        StreamingRandomGenerator gen(40u);
+        const float chunkWorld = 16.0f * Chunk::SIZE;
+
+        for (int i = 0; i < iterations; ++i)
+        {
+            ResidencyReference reference;
+            reference.loadRadius = gen.RandomInt(0, 5);
+            reference.unloadRadius = gen.RandomInt(std::max(reference.loadRadius - 1, 0), reference.loadRadius + 4);
+
+            ChunkManager manager;
+            manager.SetLoadRadius(reference.loadRadius);
+            manager.SetUnloadRadius(reference.unloadRadius);
+            manager.SetMaxInFlight(gen.RandomInt(1, 8));
+            std::unordered_set<ChunkCoord, ChunkCoordHash> resident;
+
+            float camX = gen.RandomFloat(-1000.0f, 1000.0f) * chunkWorld;
+            float camY = gen.RandomFloat(-1000.0f, 1000.0f) * chunkWorld;
+            ChunkCoord previous{};
+            bool incremental = false;
+            std::string error;
+            const int steps = gen.RandomInt(20, 150);
+            for (int step = 0; step < steps && error.empty(); ++step)
+            {
+                const int kind = gen.RandomInt(0, 19);
+                if (kind < 8)
+                {
+                    camX += gen.RandomFloat(-0.3f, 0.3f) * chunkWorld;
+                    camY += gen.RandomFloat(-0.3f, 0.3f) * chunkWorld;
+                }
+                else if (kind < 16)
+                {
+                    camX += static_cast<float>(gen.RandomInt(-1, 1)) * chunkWorld;
+                    camY += static_cast<float>(gen.RandomInt(-1, 1)) * chunkWorld;
+                }
+                else if (kind < 18)
+                {
+                    camX += gen.RandomFloat(-3.0f, 3.0f) * static_cast<float>(reference.unloadRadius + 1) * chunkWorld;
+                    camY += gen.RandomFloat(-3.0f, 3.0f) * static_cast<float>(reference.unloadRadius + 1) * chunkWorld;
+                }
+                else if (kind == 18)
+                {
+                    reference.loadRadius = gen.RandomInt(0, 5);
+                    reference.unloadRadius =
+                        gen.RandomInt(std::max(reference.loadRadius - 1, 0), reference.loadRadius + 4);
+                    manager.SetLoadRadius(reference.loadRadius);
+                    manager.SetUnloadRadius(reference.unloadRadius);
+                    incremental = false;
+                }
+                else
+                {
+                    manager.Clear();
+                    resident.clear();
+                    incremental = false;
+                }
+
+                const ChunkCoord view{static_cast<int32_t>(std::floor(camX / chunkWorld)),
+                                      static_cast<int32_t>(std::floor(camY / chunkWorld))};
+                const uint64_t checksBefore = manager.GetStats().residencyChecks;
+                manager.SetViewCenter(camX, camY);
+                if (gen.RandomInt(0, 1) == 0)
+                    manager.Update(1.0f / 60.0f);
+                manager.Flush();
+                const uint64_t checks = manager.GetStats().residencyChecks - checksBefore;
+                reference.Apply(resident, view);
+
+                std::ostringstream oss;
+                if (incremental && view == previous && checks != 0)
+                    oss << checks << " residency checks while staying in chunk (" << view.x << "," << view.y << ")";
+                else if (incremental && view != previous && checks != reference.DifferenceSize(previous, view))
+                    oss << checks << " residency checks moving (" << previous.x << "," << previous.y << ") -> ("
+                        << view.x << "," << view.y << "), expected " << reference.DifferenceSize(previous, view);
+                else if (static_cast<size_t>(manager.GetLoadedChunkCount()) != resident.size())
+                    oss << manager.GetLoadedChunkCount() << " chunks loaded, reference has " << resident.size();
+                else
+                {
+                    for (const ChunkCoord& c : resident)
+                    {
+                        const Chunk* chunk = manager.GetChunk(c);
+                        if (!chunk || chunk->coord != c)
+                        {
+                            oss << "reference chunk (" << c.x << "," << c.y << ") not resident";
+                            break;
+                        }
+                    }
+                }
+                error = oss.str();
+                if (!error.empty())
+                {
+                    std::ostringstream where;
+                    where << " at step " << step << " (kind " << kind << ", loadRadius=" << reference.loadRadius
+                          << ", unloadRadius=" << reference.unloadRadius << ")";
+                    error += where.str();
+                }
+                previous = view;
+                incremental = true;
+            }
+
+            if (!error.empty())
+            {
+                result.passed = false;
+                result.failedIteration = i;
+                result.failureMessage = error;
+                return result;
+            }
+        }
+        return result;
+    }
+
+    /**
+     * @brief Property: the toroidal chunk grid behaves like a hash map under random inserts and removals spread far
+     * wider than its window, including after the window is resized
+     */
+    inline TestResult TestProperty_ChunkGridMatchesMap(int iterations = 100)
+    {
+        TestResult result;
+        StreamingRandomGenerator gen(4040u);
+
+        for (int i = 0; i < iterations; ++i)
+        {
+            WorldStreaming::ChunkGrid grid(gen.RandomInt(1, 8));
+            std::unordered_map<ChunkCoord, Chunk*, ChunkCoordHash> reference;
+            const int spread = gen.RandomInt(1, 40);
+            std::string error;
+
+            for (int op = 0; op < 400 && error.empty(); ++op)
+            {
+                const ChunkCoord c{gen.RandomInt(-spread, spread), gen.RandomInt(-spread, spread)};
+                const int kind = gen.RandomInt(0, 19);
+                if (kind < 9)
+                {
+                    auto chunk = std::make_unique<Chunk>();
+                    Chunk* raw = chunk.get();
+                    const bool inserted = grid.Insert(c, chunk);
+                    if (inserted != !reference.contains(c))
+                        error = "Insert disagrees on whether the coordinate exists";
+                    else if (inserted)
+                        reference[c] = raw;
+                }
+                else if (kind < 18)
+                {
+                    std::unique_ptr<Chunk> removed = grid.Remove(c);
+                    auto it = reference.find(c);
+                    if ((it == reference.end()) != (removed == nullptr) || (removed && removed.get() != it->second))
+                        error = "Remove returned the wrong chunk";
+                    else if (it != reference.end())
+                        reference.erase(it);
+                }
+                else
+                {
+                    grid.SetSpan(gen.RandomInt(1, 40));
+                }
+
+                if (error.empty() && grid.Size() != reference.size())
+                    error = "size mismatch";
+                for (int probe = 0; probe < 8 && error.empty(); ++probe)
+                {
+                    const ChunkCoord q{gen.RandomInt(-spread, spread), gen.RandomInt(-spread, spread)};
+                    auto it = reference.find(q);
+                    if (grid.Find(q) != (it == reference.end() ? nullptr : it->second))
+                        error = "Find disagrees with the reference";
+                }
+            }
+            if (error.empty())
+            {
+                size_t visited = 0;
+                grid.ForEach([&](ChunkCoord c, Chunk& chunk) {
+                    ++visited;
+                    auto it = reference.find(c);
+                    if (it == reference.end() || it->second != &chunk) error = "ForEach visited a stale entry";
+                });
+                if (error.empty() && visited != reference.size())
+                    error = "ForEach missed entries";
+            }
+
+            if (!error.empty())
+            {
+                result.passed = false;
+                result.failedIteration = i;
+                result.failureMessage = error;
+                return result;
+            }
+        }
+        return result;
+    }
+
+    /**
+     * @brief Benchmark: worst and mean main-thread frame time while flying across the world, asynchronous streaming
+     * versus loading everything before the frame ends. Each frame sleeps otherWorkMs outside the measurement to stand
+     * in for the rest of the frame, during which the workers keep generating
+     */
+    inline void RunChunkStreamingBenchmark(int frames = 300, int workPerTile = 8, int otherWorkMs = 4)
+    {
+        using Clock = std::chrono::steady_clock;
+        const float chunkWorld = 16.0f * Chunk::SIZE;
+        const float speed = 6.0f * chunkWorld;
+        const float dt = 1.0f / 60.0f;
+
+        const auto run = [&](bool blocking)
+        {
+            ChunkManager manager;
+            manager.SetLoadRadius(4);
+            manager.SetUnloadRadius(6);
+            manager.SetChunkGenerator(MakeGenerator(workPerTile));
+            manager.SetViewCenter(0.0f, 0.0f);
+            manager.Flush();
+
+            double worst = 0.0;
+            double total = 0.0;
+            for (int frame = 0; frame < frames; ++frame)
+            {
+                const float t = static_cast<float>(frame) * dt;
+                manager.SetViewCenter(speed * t, speed * 0.5f * std::sin(t));
+                const auto t0 = Clock::now();
+                if (blocking)
+                    manager.Flush();
+                else
+                    manager.Update(dt);
+                const double ms = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+                worst = std::max(worst, ms);
+                total += ms;
+                std::this_thread::sleep_for(std::chrono::milliseconds(otherWorkMs));
+            }
+            const auto& stats = manager.GetStats();
+            LogInfo("{}: worst frame {:.2f} ms, mean {:.3f} ms, {} loaded, {} cancelled",
+                    blocking ? "Blocking load" : "Async streaming", worst, total / frames, stats.loaded,
+                    stats.cancelled);
+        };
+        run(true);
+        run(false);
+    }
+
+    /**
+     * @brief Benchmark: residency checks and main-thread time per Update for a slowly walking camera, incremental
+     * tracking versus rescanning the load square and every loaded chunk each frame
+     */
+    inline void RunChunkResidencyBenchmark(int frames = 20000, int loadRadius = 8, int unloadRadius = 10)
+    {
+        using Clock = std::chrono::steady_clock;
+        const float chunkWorld = 16.0f * Chunk::SIZE;
+        // About two chunks per second, so most frames stay inside one chunk
+        const float speed = 2.0f * chunkWorld;
+        const float dt = 1.0f / 60.0f;
+
+        ChunkManager manager;
+        manager.SetLoadRadius(loadRadius);
+        manager.SetUnloadRadius(unloadRadius);
+        manager.SetViewCenter(0.0f, 0.0f);
+        manager.Flush();
+        const uint64_t checksBefore = manager.GetStats().residencyChecks;
+
+        double total = 0.0;
+        uint64_t rescan = 0;
+        for (int frame = 0; frame < frames; ++frame)
+        {
+            const float t = static_cast<float>(frame) * dt;
+            manager.SetViewCenter(speed * t, speed * 0.5f * std::sin(t * 0.3f));
+            const auto t0 = Clock::now();
+            manager.Update(dt);
+            total += std::chrono::duration<double, std::micro>(Clock::now() - t0).count();
+            rescan += static_cast<uint64_t>((2 * loadRadius + 1) * (2 * loadRadius + 1)) +
+                static_cast<uint64_t>(manager.GetLoadedChunkCount());
+        }
+        manager.Flush();
+        const uint64_t checks = manager.GetStats().residencyChecks - checksBefore;
+        LogInfo("Residency: {:.2f} checks/frame vs {:.1f} for a full rescan ({:.0f}x fewer), mean Update {:.2f} us, "
+                "{} loaded", static_cast<double>(checks) / frames, static_cast<double>(rescan) / frames,
+                static_cast<double>(rescan) / static_cast<double>(std::max<uint64_t>(checks, 1)), total / frames,
+                manager.GetStats().loaded);
+    }
+
+    /**
+     * @brief Run all chunk streaming tests
+     *
+     * @return true if all tests pass, false otherwise
+     */
+    inline bool RunAllChunkStreamingTests()
+    {
+        LogInfo("=== Running Chunk Streaming Tests ===");
+
+        bool allPassed = true;
+        allPassed &= RunTest("Callbacks fire once per chunk", TestProperty_CallbacksFireOncePerChunk());
+        allPassed &= RunTest("Teleports cancel stale chunks", TestProperty_TeleportsCancelStaleChunks());
+        allPassed &= RunTest("Look-ahead prefers travel direction", TestProperty_LookAheadPrefersTravelDirection());
+        allPassed &= RunTest("Residency matches brute force", TestProperty_ResidencyMatchesBruteForce());
+        allPassed &= RunTest("Chunk grid matches a hash map", TestProperty_ChunkGridMatchesMap());
+
+        LogInfo("=== Chunk Streaming Tests Complete ===");
+        return allPassed;
+    }
+}
+
+#endif // CHUNK_STREAMING_TESTS_H
@@ -0,0 +1,269 @@
+#ifndef FLOW_FIELD_TESTS_H
+#define FLOW_FIELD_TESTS_H
+
+/**
+ * @file FlowFieldTests.h
+ * @brief Property-based tests and benchmark for shared flow fields and the flow field cache
+ *
+ * Feature: crowd-flow-fields
+ */
+
+#include "PathfinderTests.h"
+#include "../Navigation/FlowField.h"
+
+namespace FlowFieldTests
+{
+    using PathfinderTests::PathRandomGenerator;
+    using PathfinderTests::TestResult;
+
+    /**
+     * Property: every reachable cell points to a legal neighbour with strictly smaller distance, the
+     * distance equals the A* path cost, and reachability agrees with A*
+     */
+    inline TestResult TestProperty_DirectionsDescendToGoal(int iterations = 150)
+    {
+        TestResult result;
+        PathRandomGenerator gen(32u);
+        Navigation::SearchContext context;
+        for (int i = 0; i < iterations; ++i)
+        {
+            const int width = gen.RandomInt(2, 64);
+            const int height = gen.RandomInt(2, 64);
+            const Navigation::NavGrid grid = (i % 4 == 3)
+                                                 ? PathfinderTests::MazeGrid(gen, width | 1, height | 1)
+                                                 : PathfinderTests::RandomObstacleGrid(gen, width, height,
+                                                                                       gen.RandomFloat(0.0f, 0.4f));
+            const auto goal = PathfinderTests::RandomWalkableCell(gen, grid);
+            Navigation::FlowField field;
+            field.Build(grid, goal.first, goal.second, {}, context);
+
+            for (int y = 0; y < grid.height; ++y)
+            {
+                for (int x = 0; x < grid.width; ++x)
+                {
+                    if (!field.IsReachable(x, y) || (x == goal.first && y == goal.second)) continue;
+                    int dx, dy;
+                    const float here = field.Distance(x, y);
+                    const bool legal = field.Direction(x, y, dx, dy) && grid.IsWalkable(x + dx, y + dy) &&
+                        (dx == 0 || dy == 0 || (grid.IsWalkable(x + dx, y) && grid.IsWalkable(x, y + dy)));
+                    const float step = (dx != 0 && dy != 0) ? 1.41421356f : 1.0f;
+                    if (!legal || std::abs(field.Distance(x + dx, y + dy) + step - here) > 1e-3f * std::max(1.0f, here))
+                    {
+                        std::ostringstream oss;
+                        oss << "Cell (" << x << ", " << y << ") does not descend toward the goal";
+                        result.passed = false;
+                        result.failedIteration = i;
+                        result.failureMessage = oss.str();
+                        return result;
+                    }
+                }
+            }
+
+            for (int q = 0; q < 10; ++q)
+            {
+                const auto start = PathfinderTests::RandomWalkableCell(gen, grid);
+                const auto path = Navigation::Pathfinder::FindPath(
+                    grid, PathfinderTests::MakeRequest(grid, start, goal, true, Navigation::PathSearchMode::AStar),
+                    context);
+                const float distance = field.Distance(start.first, start.second);
+                if (path.found != field.IsReachable(start.first, start.second) ||
+                    (path.found && std::abs(path.cost - distance) > 1e-3f * std::max(1.0f, path.cost)))
+                {
+                    std::ostringstream oss;
+                    oss << "Field distance " << distance << " vs A* cost " << path.cost << " (found " << path.found
+                        << ")";
+                    result.passed = false;
+                    result.failedIteration = i;
+                    result.failureMessage = oss.str();
+                    return result;
+                }
+            }
+        }
+        return result;
+    }
+
+    /**
+     * Property: a field restricted to a region matches A* restricted to the same bounds
+     */
+    inline TestResult TestProperty_RegionMatchesBoundedSearch(int iterations = 100)
+    {
+        TestResult result;
+        PathRandomGenerator gen(33u);
+        Navigation::SearchContext context;
+        for (int i = 0; i < iterations; ++i)
+        {
+            const Navigation::NavGrid grid =
+                PathfinderTests::RandomObstacleGrid(gen, gen.RandomInt(8, 64), gen.RandomInt(8, 64), 0.25f);
+            Navigation::NavRect bounds;
+            bounds.minX = gen.RandomInt(-2, grid.width / 2);
+            bounds.minY = gen.RandomInt(-2, grid.height / 2);
+            bounds.maxX = gen.RandomInt(grid.width / 2, grid.width + 2);
+            bounds.maxY = gen.RandomInt(grid.height / 2, grid.height + 2);
+            const auto goal = PathfinderTests::RandomWalkableCell(gen, grid);
+            Navigation::FlowField field;
+            field.Build(grid, goal.first, goal.second, bounds, context);
+
+            for (int q = 0; q < 10; ++q)
+            {
+                const auto start = PathfinderTests::RandomWalkableCell(gen, grid);
+                auto request = PathfinderTests::MakeRequest(grid, start, goal, true, Navigation::PathSearchMode::AStar);
+                request.bounds = bounds;
+                const auto path = Navigation::Pathfinder::FindPath(grid, request, context);
+                if (path.found != field.IsReachable(start.first, start.second) ||
+                    (path.found && std::abs(path.cost - field.Distance(start.first, start.second)) > 1e-3f))
+                {
+                    result.passed = false;
+                    result.failedIteration = i;
+                    result.failureMessage = "Region field disagrees with bounded A*";
+                    return result;
+                }
+            }
+        }
+        return result;
+    }
+
+    /**
+     * Property: the service shares one field per goal, evicts it once released, and rebuilds exactly the
+     * fields whose region covers an edited cell
+     */
+    inline TestResult TestProperty_CacheSharingAndInvalidation(int iterations = 100)
+    {
+        TestResult result;
+        PathRandomGenerator gen(34u);
+        auto fail = [&](int i, const char* message)
+        {
+            result.passed = false;
+            result.failedIteration = i;
+            result.failureMessage = message;
+            return result;
+        };
+        for (int i = 0; i < iterations; ++i)
+        {
+            Navigation::NavGrid grid = PathfinderTests::RandomObstacleGrid(gen, gen.RandomInt(16, 64),
+                                                                         gen.RandomInt(16, 64), 0.2f);
+            Navigation::FlowFieldService service;
+            const auto goal = PathfinderTests::RandomWalkableCell(gen, grid);
+            const Navigation::NavRect left{0, 0, grid.width / 2 - 1, grid.height - 1};
+            const auto leftGoal = PathfinderTests::RandomWalkableCell(gen, grid);
+
+            auto a = service.Acquire(grid, goal.first, goal.second);
+            auto b = service.Acquire(grid, goal.first, goal.second);
+            auto region = service.Acquire(grid, leftGoal.first, leftGoal.second, left);
+            if (a != b || service.GetFieldCount() != 2 || service.GetReferenceCount(goal.first, goal.second) != 2)
+                return fail(i, "Agents with the same goal did not share one field");
+
+            // 编辑右半边：全图流场重建，左半区域流场不动
+            const uint64_t regionRevision = region->GetRevision();
+            int edited = 0;
+            for (int e = 0; e < 20; ++e)
+            {
+                const int x = gen.RandomInt(grid.width / 2, grid.width - 1);
+                const int y = gen.RandomInt(0, grid.height - 1);
+                if (x == goal.first && y == goal.second) continue;
+                grid.SetWalkable(x, y, !grid.IsWalkable(x, y));
+                ++edited;
+            }
+            service.Update(grid);
+            if (region->GetRevision() != regionRevision)
+                return fail(i, "Edits outside a region rebuilt its field");
+            if (edited > 0 && a->GetRevision() != grid.revision)
+                return fail(i, "Edits inside a field did not rebuild it");
+
+            Navigation::FlowField fresh;
+            fresh.Build(grid, goal.first, goal.second, {}, Navigation::SearchContext::ForCurrentThread());
+            for (int y = 0; y < grid.height; ++y)
+            {
+                for (int x = 0; x < grid.width; ++x)
+                {
+                    if (fresh.Distance(x, y) != a->Distance(x, y))
+                        return fail(i, "Rebuilt field differs from a fresh build");
+                }
+            }
+
+            a.reset();
+            service.Update(grid);
+            if (service.GetReferenceCount(goal.first, goal.second) != 1 || service.GetFieldCount() != 2)
+                return fail(i, "Field was evicted while still referenced");
+            b.reset();
+            region.reset();
+            service.Update(grid);
+            if (service.GetFieldCount() != 0)
+                return fail(i, "Released fields were not evicted");
+        }
+        return result;
+    }
+
+    /**
+     * @brief Compare 5k agents converging on a few goals: per-agent A* versus shared flow fields
+     */
+    inline void RunFlowFieldBenchmark(int size = 512, int agents = 5000, int goals = 4)
+    {
+        PathRandomGenerator gen(5000u);
+        const Navigation::NavGrid grid = PathfinderTests::RandomObstacleGrid(gen, size, size, 0.15f);
+        std::vector<std::pair<int, int>> goalCells;
+        for (int g = 0; g < goals; ++g)
+            goalCells.push_back(PathfinderTests::RandomWalkableCell(gen, grid));
+        std::vector<std::pair<int, int>> starts;
+        for (int a = 0; a < agents; ++a)
+            starts.push_back(PathfinderTests::RandomWalkableCell(gen, grid));
+        using Clock = std::chrono::high_resolution_clock;
+
+        double perAgentMs[2] = {0.0, 0.0};
+        const Navigation::PathSearchMode modes[2] = {Navigation::PathSearchMode::AStar,
+                                                     Navigation::PathSearchMode::JumpPoint};
+        for (int m = 0; m < 2; ++m)
+        {
+            const auto start = Clock::now();
+            for (int a = 0; a < agents; ++a)
+            {
+                Navigation::Pathfinder::FindPath(
+                    grid, PathfinderTests::MakeRequest(grid, starts[a], goalCells[a % goals], true, modes[m]));
+            }
+            perAgentMs[m] = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        }
+
+        Navigation::FlowFieldService service;
+        std::vector<std::shared_ptr<const Navigation::FlowField>> held(agents);
+        auto start = Clock::now();
+        for (int a = 0; a < agents; ++a)
+            held[a] = service.Acquire(grid, goalCells[a % goals].first, goalCells[a % goals].second);
+        const double buildMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+        // 每个代理每帧采样一次方向，相当于一帧的转向开销
+        start = Clock::now();
+        float checksum = 0.0f;
+        for (int a = 0; a < agents; ++a)
+        {
+            const auto direction = held[a]->SampleDirection(grid, grid.GridToWorld(starts[a].first, starts[a].second));
+            checksum += direction.x + direction.y;
+        }
+        const double sampleMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+        LogInfo("{} agents to {} goals on {}x{}: per-agent A* {:.0f} ms, per-agent JPS {:.0f} ms, "
+                "flow fields {:.1f} ms to build + {:.3f} ms per frame to sample (checksum {:.1f})",
+                agents, goals, size, size, perAgentMs[0], perAgentMs[1], buildMs, sampleMs, checksum);
+    }
+
+    /**
+     * @brief Run all flow field tests
+     *
+     * @return true if all tests pass, false otherwise
+     */
+    inline bool RunAllFlowFieldTests()
+    {
+        LogInfo("=== Running Flow Field Tests ===");
+
+        bool allPassed = true;
+        allPassed &= PathfinderTests::RunTest("Flow field directions descend to the goal",
+                                              TestProperty_DirectionsDescendToGoal());
+        allPassed &= PathfinderTests::RunTest("Region flow field matches bounded A*",
+                                              TestProperty_RegionMatchesBoundedSearch());
+        allPassed &= PathfinderTests::RunTest("Flow field cache sharing and invalidation",
+                                              TestProperty_CacheSharingAndInvalidation());
+
+        LogInfo("=== Flow Field Tests Complete ===");
+        return allPassed;
+    }
+}
+
+#endif // FLOW_FIELD_TESTS_H
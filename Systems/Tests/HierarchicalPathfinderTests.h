@@ -0,0 +1,414 @@
+#ifndef HIERARCHICAL_PATHFINDER_TESTS_H
+#define HIERARCHICAL_PATHFINDER_TESTS_H
+
+/**
+ * @file HierarchicalPathfinderTests.h
+ * @brief Property-based tests and benchmark for HPA*, its incremental cluster repair and background build
+ *
+ * Feature: hierarchical-pathfinding
+ */
+
+#include "PathfinderTests.h"
+#include "../Navigation/HierarchicalPathfinder.h"
+#include <thread>
+
+namespace HierarchicalPathfinderTests
+{
+    using PathfinderTests::PathRandomGenerator;
+    using PathfinderTests::TestResult;
+
+    /// Every HPA* path must stay within this factor of the optimal A* cost.
+    constexpr float MaxCostRatio = 1.5f;
+    /// Summed over all queries, HPA* must stay within this factor of optimal.
+    constexpr double MaxAggregateCostRatio = 1.1;
+
+    /**
+     * @brief Rooms-and-walls grid: random rectangles of wall with some scattered noise
+     */
+    inline Navigation::NavGrid RoomsGrid(PathRandomGenerator& gen, int width, int height)
+    {
+        Navigation::NavGrid grid = PathfinderTests::RandomObstacleGrid(gen, width, height, 0.05f);
+        const int walls = (width * height) / 400;
+        for (int w = 0; w < walls; ++w)
+        {
+            const bool horizontal = gen.RandomInt(0, 1) == 0;
+            const int length = gen.RandomInt(4, 40);
+            const int x0 = gen.RandomInt(0, width - 1);
+            const int y0 = gen.RandomInt(0, height - 1);
+            for (int i = 0; i < length; ++i)
+            {
+                grid.SetWalkable(horizontal ? x0 + i : x0, horizontal ? y0 : y0 + i, false);
+            }
+        }
+        return grid;
+    }
+
+    /**
+     * Property: HPA* finds a path exactly when A* does, the path is valid and its cost is bounded
+     * per query and in aggregate
+     */
+    inline TestResult TestProperty_ValidAndBoundedCost(int iterations = 200)
+    {
+        TestResult result;
+        PathRandomGenerator gen(31u);
+        Navigation::SearchContext context;
+        double optimalTotal = 0.0;
+        double hierarchicalTotal = 0.0;
+        for (int i = 0; i < iterations; ++i)
+        {
+            const int clusterSize = gen.RandomInt(4, 16);
+            const Navigation::NavGrid grid = RoomsGrid(gen, gen.RandomInt(16, 160), gen.RandomInt(16, 160));
+            Navigation::HierarchicalPathfinder hierarchy(clusterSize);
+            hierarchy.Build(grid);
+
+            for (int q = 0; q < 10; ++q)
+            {
+                const auto start = PathfinderTests::RandomWalkableCell(gen, grid);
+                const auto end = PathfinderTests::RandomWalkableCell(gen, grid);
+                const auto request = PathfinderTests::MakeRequest(grid, start, end, true,
+                                                                  Navigation::PathSearchMode::AStar);
+                const auto optimal = Navigation::Pathfinder::FindPath(grid, request, context);
+                const auto path = hierarchy.FindPath(grid, request);
+                if (path.found != optimal.found)
+                {
+                    result.passed = false;
+                    result.failedIteration = i;
+                    result.failureMessage = "HPA* disagrees with A* on reachability";
+                    return result;
+                }
+                if (!path.found) continue;
+                const float walked = PathfinderTests::ValidatePath(grid, start, path, true);
+                if (walked < 0.0f || std::abs(walked - path.cost) > 1e-3f * std::max(1.0f, path.cost))
+                {
+                    result.passed = false;
+                    result.failedIteration = i;
+                    result.failureMessage = "HPA* produced an invalid path or a cost that does not match it";
+                    return result;
+                }
+                if (walked > optimal.cost * MaxCostRatio + 1e-3f)
+                {
+                    std::ostringstream oss;
+                    oss << "HPA* cost " << walked << " exceeds " << MaxCostRatio << "x optimal " << optimal.cost;
+                    result.passed = false;
+                    result.failedIteration = i;
+                    result.failureMessage = oss.str();
+                    return result;
+                }
+                optimalTotal += optimal.cost;
+                hierarchicalTotal += walked;
+            }
+        }
+        if (hierarchicalTotal > optimalTotal * MaxAggregateCostRatio)
+        {
+            std::ostringstream oss;
+            oss << "Aggregate HPA* cost ratio " << hierarchicalTotal / optimalTotal << " exceeds "
+                << MaxAggregateCostRatio;
+            result.passed = false;
+            result.failureMessage = oss.str();
+        }
+        return result;
+    }
+
+    /**
+     * Property: repairing after SetWalkable edits answers queries exactly like a full rebuild
+     */
+    inline TestResult TestProperty_RepairMatchesRebuild(int iterations = 100)
+    {
+        TestResult result;
+        PathRandomGenerator gen(32u);
+        for (int i = 0; i < iterations; ++i)
+        {
+            const int clusterSize = gen.RandomInt(4, 16);
+            Navigation::NavGrid grid = RoomsGrid(gen, gen.RandomInt(16, 128), gen.RandomInt(16, 128));
+            Navigation::HierarchicalPathfinder repaired(clusterSize);
+            repaired.Build(grid);
+
+            for (int round = 0; round < 4; ++round)
+            {
+                const int edits = gen.RandomInt(1, 30);
+                for (int e = 0; e < edits; ++e)
+                {
+                    grid.SetWalkable(gen.RandomInt(0, grid.width - 1), gen.RandomInt(0, grid.height - 1),
+                                     gen.RandomInt(0, 2) == 0);
+                }
+                repaired.Update(grid);
+                Navigation::HierarchicalPathfinder rebuilt(clusterSize);
+                rebuilt.Build(grid);
+
+                if (repaired.GetNodeCount() != rebuilt.GetNodeCount())
+                {
+                    result.passed = false;
+                    result.failedIteration = i;
+                    result.failureMessage = "Repaired graph has " + std::to_string(repaired.GetNodeCount()) +
+                                            " nodes, rebuilt graph has " + std::to_string(rebuilt.GetNodeCount());
+                    return result;
+                }
+                for (int q = 0; q < 10; ++q)
+                {
+                    const auto start = PathfinderTests::RandomWalkableCell(gen, grid);
+                    const auto end = PathfinderTests::RandomWalkableCell(gen, grid);
+                    const auto request = PathfinderTests::MakeRequest(grid, start, end, true,
+                                                                      Navigation::PathSearchMode::Auto);
+                    const auto a = repaired.FindAbstractPath(grid, request);
+                    const auto b = rebuilt.FindAbstractPath(grid, request);
+                    if (a.found != b.found || std::abs(a.cost - b.cost) > 1e-3f * std::max(1.0f, b.cost))
+                    {
+                        std::ostringstream oss;
+                        oss << "Repaired cost " << a.cost << " (found " << a.found << ") vs rebuilt " << b.cost
+                            << " (found " << b.found << ")";
+                        result.passed = false;
+                        result.failedIteration = i;
+                        result.failureMessage = oss.str();
+                        return result;
+                    }
+                }
+            }
+        }
+        return result;
+    }
+
+    /**
+     * Property: a background build, polled to completion and then caught up with Update, answers queries
+     * exactly like a synchronous build of the current grid, also when restarted while jobs are in flight
+     */
+    inline TestResult TestProperty_BackgroundBuildMatchesBuild(int iterations = 30)
+    {
+        TestResult result;
+        PathRandomGenerator gen(33u);
+        Navigation::HierarchyBuildTask task;
+        for (int i = 0; i < iterations; ++i)
+        {
+            const int clusterSize = gen.RandomInt(4, 16);
+            Navigation::NavGrid grid = RoomsGrid(gen, gen.RandomInt(16, 400), gen.RandomInt(16, 400));
+            if (gen.RandomInt(0, 1) == 0)
+            {
+                // Start a build that is superseded before it finishes
+                task.Start(RoomsGrid(gen, gen.RandomInt(16, 400), gen.RandomInt(16, 400)), clusterSize);
+            }
+            task.Start(grid, clusterSize);
+
+            // Edit the grid while the snapshot is being built
+            const int edits = gen.RandomInt(0, 30);
+            for (int e = 0; e < edits; ++e)
+            {
+                grid.SetWalkable(gen.RandomInt(0, grid.width - 1), gen.RandomInt(0, grid.height - 1),
+                                 gen.RandomInt(0, 2) == 0);
+            }
+
+            Navigation::HierarchicalPathfinder background(clusterSize);
+            while (!task.Poll(background))
+                std::this_thread::yield();
+            if (task.IsRunning() || !background.IsBuilt())
+            {
+                result.passed = false;
+                result.failedIteration = i;
+                result.failureMessage = "Background build did not finish";
+                return result;
+            }
+            background.Update(grid);
+
+            Navigation::HierarchicalPathfinder rebuilt(clusterSize);
+            rebuilt.Build(grid);
+            if (background.GetNodeCount() != rebuilt.GetNodeCount())
+            {
+                result.passed = false;
+                result.failedIteration = i;
+                result.failureMessage = "Background graph has " + std::to_string(background.GetNodeCount()) +
+                                        " nodes, rebuilt graph has " + std::to_string(rebuilt.GetNodeCount());
+                return result;
+            }
+            for (int q = 0; q < 10; ++q)
+            {
+                const auto start = PathfinderTests::RandomWalkableCell(gen, grid);
+                const auto end = PathfinderTests::RandomWalkableCell(gen, grid);
+                const auto request = PathfinderTests::MakeRequest(grid, start, end, true,
+                                                                  Navigation::PathSearchMode::Auto);
+                const auto a = background.FindAbstractPath(grid, request);
+                const auto b = rebuilt.FindAbstractPath(grid, request);
+                if (a.found != b.found || std::abs(a.cost - b.cost) > 1e-3f * std::max(1.0f, b.cost))
+                {
+                    std::ostringstream oss;
+                    oss << "Background cost " << a.cost << " (found " << a.found << ") vs rebuilt " << b.cost
+                        << " (found " << b.found << ")";
+                    result.passed = false;
+                    result.failedIteration = i;
+                    result.failureMessage = oss.str();
+                    return result;
+                }
+            }
+        }
+        return result;
+    }
+
+    /**
+     * Property: queries running concurrently on the job system borrow search contexts from the pathfinder's
+     * own pools and answer exactly like serial queries; the pools hold no more contexts than queries ran at
+     * once, and a full build for another grid releases the contexts sized for the old one
+     */
+    inline TestResult TestProperty_PooledContextsFollowGrid(int iterations = 20)
+    {
+        TestResult result;
+        PathRandomGenerator gen(34u);
+        for (int i = 0; i < iterations; ++i)
+        {
+            const int clusterSize = gen.RandomInt(4, 16);
+            const Navigation::NavGrid grid = RoomsGrid(gen, gen.RandomInt(100, 300), gen.RandomInt(100, 300));
+            Navigation::HierarchicalPathfinder hierarchy(clusterSize);
+            hierarchy.Build(grid);
+
+            std::vector<Navigation::PathRequest> requests;
+            for (int q = 0; q < 32; ++q)
+            {
+                requests.push_back(PathfinderTests::MakeRequest(grid, PathfinderTests::RandomWalkableCell(gen, grid),
+                                                                PathfinderTests::RandomWalkableCell(gen, grid), true,
+                                                                Navigation::PathSearchMode::Auto));
+            }
+            std::vector<Navigation::PathResult> serial;
+            for (const auto& request : requests)
+                serial.push_back(hierarchy.FindPath(grid, request));
+            std::vector<Navigation::PathResult> parallel(requests.size());
+            JobSystem::ParallelFor(requests.size(),
+                                   [&](size_t q) { parallel[q] = hierarchy.FindPath(grid, requests[q]); });
+            // The job system starts its workers on first use
+            const size_t maxConcurrent = static_cast<size_t>(JobSystem::GetInstance().GetThreadCount()) + 1;
+
+            for (size_t q = 0; q < requests.size(); ++q)
+            {
+                if (parallel[q].found != serial[q].found || parallel[q].cost != serial[q].cost ||
+                    parallel[q].waypoints.size() != serial[q].waypoints.size())
+                {
+                    std::ostringstream oss;
+                    oss << "Query " << q << " on the job system found " << parallel[q].found << " cost "
+                        << parallel[q].cost << ", serially found " << serial[q].found << " cost " << serial[q].cost;
+                    result.passed = false;
+                    result.failedIteration = i;
+                    result.failureMessage = oss.str();
+                    return result;
+                }
+            }
+            // One grid, one abstract and one cluster context per query that ran at the same time
+            if (hierarchy.GetPooledContextCount() > 3 * maxConcurrent)
+            {
+                result.passed = false;
+                result.failedIteration = i;
+                result.failureMessage = std::to_string(hierarchy.GetPooledContextCount()) +
+                                        " pooled contexts for at most " + std::to_string(maxConcurrent) +
+                                        " concurrent queries";
+                return result;
+            }
+
+            // Only the cluster contexts of the new build remain
+            hierarchy.Build(RoomsGrid(gen, gen.RandomInt(16, 64), gen.RandomInt(16, 64)));
+            if (hierarchy.GetPooledContextCount() > maxConcurrent)
+            {
+                result.passed = false;
+                result.failedIteration = i;
+                result.failureMessage = std::to_string(hierarchy.GetPooledContextCount()) +
+                                        " pooled contexts survived a rebuild for a new grid";
+                return result;
+            }
+        }
+        return result;
+    }
+
+    /**
+     * @brief Compare long-query latency of flat search and HPA* on a large grid
+     */
+    inline void RunHierarchicalPathfinderBenchmark(int size = 4096, int queries = 20)
+    {
+        PathRandomGenerator gen(4096u);
+        Navigation::NavGrid grid = RoomsGrid(gen, size, size);
+        using Clock = std::chrono::high_resolution_clock;
+
+        Navigation::HierarchicalPathfinder hierarchy;
+        auto start = Clock::now();
+        hierarchy.Build(grid);
+        const double buildMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+        std::vector<std::pair<std::pair<int, int>, std::pair<int, int>>> pairs;
+        while (static_cast<int>(pairs.size()) < queries)
+        {
+            const auto from = PathfinderTests::RandomWalkableCell(gen, grid);
+            const auto to = PathfinderTests::RandomWalkableCell(gen, grid);
+            if (std::abs(from.first - to.first) + std::abs(from.second - to.second) > size / 2)
+                pairs.push_back({from, to});
+        }
+
+        double flatMs[2] = {0.0, 0.0};
+        double flatWorstMs[2] = {0.0, 0.0};
+        double flatCost = 0.0;
+        const Navigation::PathSearchMode modes[2] = {Navigation::PathSearchMode::AStar,
+                                                     Navigation::PathSearchMode::JumpPoint};
+        for (int m = 0; m < 2; ++m)
+        {
+            for (auto& [from, to] : pairs)
+            {
+                start = Clock::now();
+                const auto path = Navigation::Pathfinder::FindPath(
+                    grid, PathfinderTests::MakeRequest(grid, from, to, true, modes[m]));
+                const double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+                flatMs[m] += ms;
+                flatWorstMs[m] = std::max(flatWorstMs[m], ms);
+                if (m == 0) flatCost += path.cost;
+            }
+        }
+
+        double abstractMs = 0.0;
+        double abstractWorstMs = 0.0;
+        double refinedMs = 0.0;
+        double hierarchicalCost = 0.0;
+        for (auto& [from, to] : pairs)
+        {
+            const auto request = PathfinderTests::MakeRequest(grid, from, to, true, Navigation::PathSearchMode::Auto);
+            start = Clock::now();
+            hierarchy.FindAbstractPath(grid, request);
+            const double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+            abstractMs += ms;
+            abstractWorstMs = std::max(abstractWorstMs, ms);
+
+            start = Clock::now();
+            const auto path = hierarchy.FindPath(grid, request);
+            refinedMs += std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+            hierarchicalCost += path.cost;
+        }
+
+        start = Clock::now();
+        for (int e = 0; e < 100; ++e)
+        {
+            grid.SetWalkable(gen.RandomInt(0, size - 1), gen.RandomInt(0, size - 1), false);
+            hierarchy.Update(grid);
+        }
+        const double repairMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count() / 100.0;
+
+        const double n = static_cast<double>(queries);
+        LogInfo("HPA* {}x{}: build {:.0f} ms ({} nodes), repair {:.3f} ms/edit", size, size, buildMs,
+                hierarchy.GetNodeCount(), repairMs);
+        LogInfo("Long queries: A* avg {:.1f} ms (worst {:.1f}), JPS avg {:.1f} ms (worst {:.1f}), "
+                "HPA* abstract avg {:.2f} ms (worst {:.2f}), HPA* fully refined avg {:.2f} ms, cost ratio {:.3f}",
+                flatMs[0] / n, flatWorstMs[0], flatMs[1] / n, flatWorstMs[1], abstractMs / n, abstractWorstMs,
+                refinedMs / n, flatCost > 0.0 ? hierarchicalCost / flatCost : 0.0);
+    }
+
+    /**
+     * @brief Run all hierarchical pathfinder tests
+     *
+     * @return true if all tests pass, false otherwise
+     */
+    inline bool RunAllHierarchicalPathfinderTests()
+    {
+        LogInfo("=== Running Hierarchical Pathfinder Tests ===");
+
+        bool allPassed = true;
+        allPassed &= PathfinderTests::RunTest("HPA* paths are valid and near-optimal", TestProperty_ValidAndBoundedCost());
+        allPassed &= PathfinderTests::RunTest("Cluster repair matches full rebuild", TestProperty_RepairMatchesRebuild());
+        allPassed &= PathfinderTests::RunTest("Background build matches full rebuild",
+                                              TestProperty_BackgroundBuildMatchesBuild());
+        allPassed &= PathfinderTests::RunTest("Pooled search contexts follow the grid",
+                                              TestProperty_PooledContextsFollowGrid());
+
+        LogInfo("=== Hierarchical Pathfinder Tests Complete ===");
+        return allPassed;
+    }
+}
+
+#endif // HIERARCHICAL_PATHFINDER_TESTS_H
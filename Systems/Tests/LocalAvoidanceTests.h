@@ -0,0 +1,385 @@
+#ifndef LOCAL_AVOIDANCE_TESTS_H
+#define LOCAL_AVOIDANCE_TESTS_H
+
+/**
+ * @file LocalAvoidanceTests.h
+ * @brief Property-based tests and benchmark for ORCA local avoidance and the per-tick agent spatial hash
+ *
+ * Feature: orca-local-avoidance
+ */
+
+#include "PathfinderTests.h"
+#include "../Navigation/LocalAvoidance.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <sstream>
+#include <vector>
+
+namespace LocalAvoidanceTests
+{
+    using PathfinderTests::PathRandomGenerator;
+    using PathfinderTests::TestResult;
+
+    /// Scenario outcome: smallest gap between any two agents relative to their combined radius, and arrival.
+    struct SimulationOutcome
+    {
+        float worstOverlap = 0.0f;  ///< max over pairs and ticks of 1 - distance / (ri + rj), clamped at 0
+        float worstSpeedExcess = 0.0f;
+        bool allArrived = false;
+        int ticks = 0;
+    };
+
+    /**
+     * @brief Drive agents straight at their goals through the solver until all arrive or maxTicks elapse
+     */
+    inline SimulationOutcome Simulate(std::vector<Navigation::AvoidanceAgent>& agents,
+                                      const std::vector<ECS::Vector2f>& goals, float dt, int maxTicks)
+    {
+        SimulationOutcome outcome;
+        Navigation::OrcaSolver solver;
+        std::vector<ECS::Vector2f> velocities;
+        PathRandomGenerator jitter(static_cast<uint32_t>(agents.size()));
+        const float arriveDistance = 1.0f;
+
+        for (outcome.ticks = 0; outcome.ticks < maxTicks; ++outcome.ticks)
+        {
+            bool arrived = true;
+            for (size_t i = 0; i < agents.size(); ++i)
+            {
+                auto& agent = agents[i];
+                const float dx = goals[i].x - agent.position.x;
+                const float dy = goals[i].y - agent.position.y;
+                const float dist = std::sqrt(dx * dx + dy * dy);
+                arrived &= dist <= arriveDistance;
+                const float speed = std::min(agent.maxSpeed, dist / dt);
+                agent.preferredVelocity = dist > 1e-6f
+                                              ? ECS::Vector2f(dx / dist * speed, dy / dist * speed)
+                                              : ECS::Vector2f(0.0f, 0.0f);
+
+                // 与 RVO2 示例相同，给期望速度加一点扰动，打破完全对称造成的僵持
+                const float angle = jitter.RandomFloat(0.0f, 6.2831853f);
+                const float magnitude = jitter.RandomFloat(0.0f, 0.01f) * speed;
+                agent.preferredVelocity.x += std::cos(angle) * magnitude;
+                agent.preferredVelocity.y += std::sin(angle) * magnitude;
+            }
+            if (arrived)
+            {
+                outcome.allArrived = true;
+                break;
+            }
+
+            solver.ComputeVelocities(agents, dt, velocities);
+            for (size_t i = 0; i < agents.size(); ++i)
+            {
+                const float speed = std::sqrt(velocities[i].x * velocities[i].x + velocities[i].y * velocities[i].y);
+                outcome.worstSpeedExcess = std::max(outcome.worstSpeedExcess, speed - agents[i].maxSpeed);
+                agents[i].velocity = velocities[i];
+                agents[i].position.x += velocities[i].x * dt;
+                agents[i].position.y += velocities[i].y * dt;
+            }
+
+            for (size_t i = 0; i < agents.size(); ++i)
+            {
+                for (size_t j = i + 1; j < agents.size(); ++j)
+                {
+                    const float dx = agents[i].position.x - agents[j].position.x;
+                    const float dy = agents[i].position.y - agents[j].position.y;
+                    const float combined = agents[i].radius + agents[j].radius;
+                    const float overlap = 1.0f - std::sqrt(dx * dx + dy * dy) / combined;
+                    outcome.worstOverlap = std::max(outcome.worstOverlap, overlap);
+                }
+            }
+        }
+        return outcome;
+    }
+
+    inline bool CheckOutcome(const SimulationOutcome& outcome, int iteration, const char* scenario,
+                             TestResult& result)
+    {
+        // 离散时间步下的 ORCA 在拥挤处约束可能无解（LinearProgram3），允许少量穿透
+        constexpr float OverlapTolerance = 0.08f;
+        std::ostringstream oss;
+        if (outcome.worstOverlap > OverlapTolerance)
+            oss << scenario << ": agents overlapped by " << outcome.worstOverlap * 100.0f << "% of combined radius";
+        else if (outcome.worstSpeedExcess > 1e-2f)
+            oss << scenario << ": velocity exceeded max speed by " << outcome.worstSpeedExcess;
+        else if (!outcome.allArrived)
+            oss << scenario << ": agents did not reach their goals within " << outcome.ticks << " ticks";
+        else
+            return true;
+
+        result.passed = false;
+        result.failedIteration = iteration;
+        result.failureMessage = oss.str();
+        return false;
+    }
+
+    /**
+     * Property: agents placed on a circle and sent to the antipodal point never overlap, respect their max
+     * speed, and all arrive
+     */
+    inline TestResult TestProperty_CircleSwapIsCollisionFree(int iterations = 20)
+    {
+        TestResult result;
+        PathRandomGenerator gen(34u);
+        for (int i = 0; i < iterations; ++i)
+        {
+            const int count = gen.RandomInt(4, 48);
+            const float agentRadius = gen.RandomFloat(4.0f, 16.0f);
+            // 圆周上相邻代理至少相隔约 3.5 个直径，且圆大于邻居搜索范围，代理接近圆心时才开始互相避让
+            const float circleRadius = std::max(agentRadius * count * 1.1f, 250.0f);
+            const float dt = gen.RandomFloat(1.0f / 120.0f, 1.0f / 60.0f);
+
+            std::vector<Navigation::AvoidanceAgent> agents(count);
+            std::vector<ECS::Vector2f> goals(count);
+            for (int a = 0; a < count; ++a)
+            {
+                // 轻微扰动角度，避免完全对称导致的僵持
+                const float angle = (a + gen.RandomFloat(-0.05f, 0.05f)) * 6.2831853f / count;
+                auto& agent = agents[a];
+                agent.position = ECS::Vector2f(std::cos(angle) * circleRadius, std::sin(angle) * circleRadius);
+                agent.radius = agentRadius * gen.RandomFloat(0.8f, 1.2f);
+                agent.maxSpeed = gen.RandomFloat(60.0f, 140.0f);
+                goals[a] = ECS::Vector2f(-agent.position.x, -agent.position.y);
+            }
+
+            // 对称的交换可能在中心互相让行一段时间，给足时间
+            const int maxTicks = static_cast<int>((circleRadius * 2.0f / 60.0f + 60.0f) / dt);
+            if (!CheckOutcome(Simulate(agents, goals, dt, maxTicks), i, "Circle swap", result))
+                return result;
+        }
+        return result;
+    }
+
+    /**
+     * Property: two groups walking through each other along a narrow band never overlap and all arrive
+     */
+    inline TestResult TestProperty_CorridorCrossingIsCollisionFree(int iterations = 20)
+    {
+        TestResult result;
+        PathRandomGenerator gen(35u);
+        for (int i = 0; i < iterations; ++i)
+        {
+            const int perSide = gen.RandomInt(2, 24);
+            const int lanes = gen.RandomInt(1, 4);
+            const float radius = gen.RandomFloat(6.0f, 12.0f);
+            const float spacing = radius * 4.0f;
+            const float length = spacing * (perSide / lanes + 4) * 2.0f;
+            const float dt = gen.RandomFloat(1.0f / 120.0f, 1.0f / 60.0f);
+
+            std::vector<Navigation::AvoidanceAgent> agents;
+            std::vector<ECS::Vector2f> goals;
+            for (int side = 0; side < 2; ++side)
+            {
+                const float direction = side == 0 ? 1.0f : -1.0f;
+                for (int a = 0; a < perSide; ++a)
+                {
+                    const float x = -direction * (length * 0.5f - (a / lanes) * spacing);
+                    const float y = ((a % lanes) - (lanes - 1) * 0.5f) * spacing + gen.RandomFloat(-0.5f, 0.5f);
+                    Navigation::AvoidanceAgent agent;
+                    agent.position = ECS::Vector2f(x, y);
+                    agent.radius = radius;
+                    agent.maxSpeed = gen.RandomFloat(80.0f, 120.0f);
+                    agents.push_back(agent);
+                    goals.push_back(ECS::Vector2f(x + direction * length, y));
+                }
+            }
+
+            const int maxTicks = static_cast<int>((length / 80.0f + 60.0f) / dt);
+            if (!CheckOutcome(Simulate(agents, goals, dt, maxTicks), i, "Corridor crossing", result))
+                return result;
+        }
+        return result;
+    }
+
+    /**
+     * Property: every agent within range of a query point is visited exactly once by the spatial hash
+     */
+    inline TestResult TestProperty_SpatialHashMatchesBruteForce(int iterations = 100)
+    {
+        TestResult result;
+        PathRandomGenerator gen(36u);
+        for (int i = 0; i < iterations; ++i)
+        {
+            const int count = gen.RandomInt(0, 3000);
+            const float extent = gen.RandomFloat(50.0f, 5000.0f);
+            std::vector<Navigation::AvoidanceAgent> agents(count);
+            for (auto& agent : agents)
+                agent.position = ECS::Vector2f(gen.RandomFloat(-extent, extent), gen.RandomFloat(-extent, extent));
+
+            Navigation::AgentSpatialHash hash;
+            hash.Build(agents, gen.RandomFloat(5.0f, 200.0f));
+
+            std::vector<int> visits(count);
+            for (int q = 0; q < 20; ++q)
+            {
+                const ECS::Vector2f point(gen.RandomFloat(-extent, extent), gen.RandomFloat(-extent, extent));
+                const float range = gen.RandomFloat(1.0f, 300.0f);
+                std::fill(visits.begin(), visits.end(), 0);
+                hash.ForEachCandidate(point, range, [&](uint32_t index) { ++visits[index]; });
+
+                for (int a = 0; a < count; ++a)
+                {
+                    const float dx = agents[a].position.x - point.x;
+                    const float dy = agents[a].position.y - point.y;
+                    const bool inRange = dx * dx + dy * dy <= range * range;
+                    // 哈希冲突会带来额外候选，但同一代理只能出现一次，且范围内的代理不能遗漏
+                    if (visits[a] > 1 || (inRange && visits[a] != 1))
+                    {
+                        std::ostringstream oss;
+                        oss << "Agent " << a << " visited " << visits[a] << " times (in range: " << inRange << ")";
+                        result.passed = false;
+                        result.failedIteration = i;
+                        result.failureMessage = oss.str();
+                        return result;
+                    }
+                }
+            }
+        }
+        return result;
+    }
+
+    /**
+     * Property: an agent's new velocity depends only on the agents within its neighbour range, so solving
+     * the crowd as a whole (in parallel chunks) or solving an isolated neighbourhood gives the same answer
+     */
+    inline TestResult TestProperty_VelocityDependsOnlyOnNeighbourhood(int iterations = 50)
+    {
+        TestResult result;
+        PathRandomGenerator gen(37u);
+        Navigation::OrcaSolver solver;
+        Navigation::OrcaSolver isolated;
+        std::vector<ECS::Vector2f> velocities;
+        std::vector<ECS::Vector2f> isolatedVelocities;
+        for (int i = 0; i < iterations; ++i)
+        {
+            const int count = gen.RandomInt(2, 4000);
+            const float extent = std::sqrt(static_cast<float>(count)) * gen.RandomFloat(20.0f, 60.0f);
+            std::vector<Navigation::AvoidanceAgent> agents(count);
+            for (auto& agent : agents)
+            {
+                agent.position = ECS::Vector2f(gen.RandomFloat(0.0f, extent), gen.RandomFloat(0.0f, extent));
+                agent.velocity = ECS::Vector2f(gen.RandomFloat(-80.0f, 80.0f), gen.RandomFloat(-80.0f, 80.0f));
+                agent.preferredVelocity = ECS::Vector2f(gen.RandomFloat(-100.0f, 100.0f),
+                                                        gen.RandomFloat(-100.0f, 100.0f));
+                agent.radius = 8.0f;
+                agent.maxSpeed = 100.0f;
+                agent.maxNeighbors = gen.RandomInt(1, 12);
+            }
+            const float dt = 1.0f / 60.0f;
+            solver.ComputeVelocities(agents, dt, velocities);
+
+            for (int probe = 0; probe < 5; ++probe)
+            {
+                const int index = gen.RandomInt(0, count - 1);
+                const float range = solver.NeighborDistance(agents[index]);
+                std::vector<Navigation::AvoidanceAgent> neighbourhood;
+                int local = -1;
+                for (int a = 0; a < count; ++a)
+                {
+                    const float dx = agents[a].position.x - agents[index].position.x;
+                    const float dy = agents[a].position.y - agents[index].position.y;
+                    if (dx * dx + dy * dy > range * range) continue;
+                    if (a == index) local = static_cast<int>(neighbourhood.size());
+                    neighbourhood.push_back(agents[a]);
+                }
+                isolated.ComputeVelocities(neighbourhood, dt, isolatedVelocities);
+
+                const auto& expected = velocities[index];
+                const auto& actual = isolatedVelocities[local];
+                if (std::abs(expected.x - actual.x) > 1e-3f || std::abs(expected.y - actual.y) > 1e-3f)
+                {
+                    std::ostringstream oss;
+                    oss << "Agent " << index << " solved to (" << expected.x << ", " << expected.y
+                        << ") in the crowd but (" << actual.x << ", " << actual.y << ") in isolation";
+                    result.passed = false;
+                    result.failedIteration = i;
+                    result.failureMessage = oss.str();
+                    return result;
+                }
+            }
+        }
+        return result;
+    }
+
+    /**
+     * @brief Benchmark: a dense crowd of agents walking toward random goals, timing hash build and solve per tick
+     */
+    inline void RunLocalAvoidanceBenchmark(int agentCount = 10000, int ticks = 60)
+    {
+        using Clock = std::chrono::steady_clock;
+        PathRandomGenerator gen(38u);
+        const float extent = std::sqrt(static_cast<float>(agentCount)) * 48.0f;
+        std::vector<Navigation::AvoidanceAgent> agents(agentCount);
+        std::vector<ECS::Vector2f> goals(agentCount);
+        for (int a = 0; a < agentCount; ++a)
+        {
+            agents[a].position = ECS::Vector2f(gen.RandomFloat(0.0f, extent), gen.RandomFloat(0.0f, extent));
+            agents[a].radius = 8.0f;
+            agents[a].maxSpeed = 100.0f;
+            goals[a] = ECS::Vector2f(gen.RandomFloat(0.0f, extent), gen.RandomFloat(0.0f, extent));
+        }
+
+        Navigation::OrcaSolver solver;
+        Navigation::AgentSpatialHash hash;
+        std::vector<ECS::Vector2f> velocities;
+        const float dt = 1.0f / 60.0f;
+        double hashMs = 0.0;
+        double solveMs = 0.0;
+        for (int tick = 0; tick < ticks; ++tick)
+        {
+            for (int a = 0; a < agentCount; ++a)
+            {
+                const float dx = goals[a].x - agents[a].position.x;
+                const float dy = goals[a].y - agents[a].position.y;
+                const float dist = std::max(std::sqrt(dx * dx + dy * dy), 1e-3f);
+                const float speed = std::min(agents[a].maxSpeed, dist / dt);
+                agents[a].preferredVelocity = ECS::Vector2f(dx / dist * speed, dy / dist * speed);
+            }
+
+            auto start = Clock::now();
+            hash.Build(agents, solver.NeighborDistance(agents[0]));
+            hashMs += std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+            start = Clock::now();
+            solver.ComputeVelocities(agents, dt, velocities);
+            solveMs += std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+            for (int a = 0; a < agentCount; ++a)
+            {
+                agents[a].velocity = velocities[a];
+                agents[a].position.x += velocities[a].x * dt;
+                agents[a].position.y += velocities[a].y * dt;
+            }
+        }
+
+        LogInfo("{} agents over {} ticks: spatial hash build {:.3f} ms/tick, hash + ORCA solve {:.3f} ms/tick",
+                agentCount, ticks, hashMs / ticks, solveMs / ticks);
+    }
+
+    /**
+     * @brief Run all local avoidance tests
+     *
+     * @return true if all tests pass, false otherwise
+     */
+    inline bool RunAllLocalAvoidanceTests()
+    {
+        LogInfo("=== Running Local Avoidance Tests ===");
+
+        bool allPassed = true;
+        allPassed &= PathfinderTests::RunTest("Circle swap is collision free",
+                                              TestProperty_CircleSwapIsCollisionFree());
+        allPassed &= PathfinderTests::RunTest("Corridor crossing is collision free",
+                                              TestProperty_CorridorCrossingIsCollisionFree());
+        allPassed &= PathfinderTests::RunTest("Spatial hash matches brute force",
+                                              TestProperty_SpatialHashMatchesBruteForce());
+        allPassed &= PathfinderTests::RunTest("Velocity depends only on the neighbourhood",
+                                              TestProperty_VelocityDependsOnlyOnNeighbourhood());
+
+        LogInfo("=== Local Avoidance Tests Complete ===");
+        return allPassed;
+    }
+}
+
+#endif // LOCAL_AVOIDANCE_TESTS_H
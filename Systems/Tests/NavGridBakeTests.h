@@ -0,0 +1,407 @@
+#ifndef NAV_GRID_BAKE_TESTS_H
+#define NAV_GRID_BAKE_TESTS_H
+
+/**
+ * @file NavGridBakeTests.h
+ * @brief Property-based tests and benchmark for the bit-packed NavGrid and incremental navigation baking
+ *
+ * Feature: nav-grid-baking
+ */
+
+#include "PathfinderTests.h"
+#include "PathSmootherTests.h"
+#include "../Navigation/NavGridBaker.h"
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <sstream>
+#include <vector>
+
+namespace NavGridBakeTests
+{
+    using PathfinderTests::PathRandomGenerator;
+    using PathfinderTests::TestResult;
+
+    /**
+     * @brief Tile grid of material ids with a change log, standing in for tilemaps, streamed chunks and pixel worlds
+     */
+    class MaterialGridSource : public Navigation::INavBakeSource
+    {
+    public:
+        MaterialGridSource(int width, int height, float tileSize, ECS::Vector2f origin,
+                           Navigation::NavMaterialTable materials)
+            : m_width(width), m_height(height), m_tileSize(tileSize), m_origin(origin),
+              m_materials(std::move(materials)), m_tiles(static_cast<size_t>(width * height), 0)
+        {
+        }
+
+        int Width() const { return m_width; }
+        int Height() const { return m_height; }
+
+        void Set(int x, int y, uint32_t material)
+        {
+            uint32_t& tile = m_tiles[static_cast<size_t>(y * m_width + x)];
+            if (tile == material) return;
+            tile = material;
+            m_changes.push_back(TileRect(x, y, x, y));
+        }
+
+        void FillRect(int x0, int y0, int x1, int y1, uint32_t material)
+        {
+            for (int y = y0; y <= y1; ++y)
+            {
+                for (int x = x0; x <= x1; ++x)
+                    m_tiles[static_cast<size_t>(y * m_width + x)] = material;
+            }
+            m_changes.push_back(TileRect(x0, y0, x1, y1));
+        }
+
+        /**
+         * @brief Rewrite every tile without recording changes, as a wholesale reload would
+         */
+        void Replace(PathRandomGenerator& gen, int materialCount)
+        {
+            for (auto& tile : m_tiles)
+                tile = static_cast<uint32_t>(gen.RandomInt(0, materialCount - 1));
+            m_changes.clear();
+            m_historyLost = true;
+        }
+
+        Navigation::NavCellSample Sample(const Navigation::NavWorldRect& area) const override
+        {
+            const int minX = std::max(static_cast<int>(std::floor((area.minX - m_origin.x) / m_tileSize)), 0);
+            const int minY = std::max(static_cast<int>(std::floor((area.minY - m_origin.y) / m_tileSize)), 0);
+            const int maxX = std::min(static_cast<int>(std::floor((area.maxX - m_origin.x) / m_tileSize)), m_width - 1);
+            const int maxY = std::min(static_cast<int>(std::floor((area.maxY - m_origin.y) / m_tileSize)), m_height - 1);
+            Navigation::NavCellSample sample;
+            for (int y = minY; y <= maxY; ++y)
+            {
+                for (int x = minX; x <= maxX; ++x)
+                    sample.Merge(m_materials.Get(m_tiles[static_cast<size_t>(y * m_width + x)]));
+            }
+            return sample;
+        }
+
+        bool CollectChanges(std::vector<Navigation::NavWorldRect>& out) override
+        {
+            out.insert(out.end(), m_changes.begin(), m_changes.end());
+            m_changes.clear();
+            const bool tracked = !m_historyLost;
+            m_historyLost = false;
+            return tracked;
+        }
+
+    private:
+        Navigation::NavWorldRect TileRect(int x0, int y0, int x1, int y1) const
+        {
+            return {m_origin.x + x0 * m_tileSize, m_origin.y + y0 * m_tileSize,
+                    m_origin.x + (x1 + 1) * m_tileSize, m_origin.y + (y1 + 1) * m_tileSize};
+        }
+
+        int m_width;
+        int m_height;
+        float m_tileSize;
+        ECS::Vector2f m_origin;
+        Navigation::NavMaterialTable m_materials;
+        std::vector<uint32_t> m_tiles;
+        std::vector<Navigation::NavWorldRect> m_changes;
+        bool m_historyLost = false;
+    };
+
+    /// 0 open, 1 and 4 solid, 2 and 3 weighted, 5 unregistered (falls back to solid)
+    static constexpr int MaterialCount = 6;
+
+    inline Navigation::NavMaterialTable TestMaterials()
+    {
+        Navigation::NavMaterialTable table;
+        table.Set(1, {true, 1});
+        table.Set(2, {false, 3});
+        table.Set(3, {false, 9});
+        table.Set(4, {true, 1});
+        return table;
+    }
+
+    inline std::shared_ptr<MaterialGridSource> RandomSource(PathRandomGenerator& gen, const Navigation::NavGrid& grid)
+    {
+        const float tileSize = gen.RandomFloat(0.3f, 3.0f) * grid.cellSize;
+        const ECS::Vector2f origin(grid.origin.x + gen.RandomFloat(-0.3f, 0.5f) * grid.width * grid.cellSize,
+                                   grid.origin.y + gen.RandomFloat(-0.3f, 0.5f) * grid.height * grid.cellSize);
+        const int width = std::max(1, static_cast<int>(grid.width * grid.cellSize / tileSize * gen.RandomFloat(0.3f, 1.2f)));
+        const int height = std::max(1, static_cast<int>(grid.height * grid.cellSize / tileSize * gen.RandomFloat(0.3f, 1.2f)));
+        auto source = std::make_shared<MaterialGridSource>(width, height, tileSize, origin, TestMaterials());
+        for (int y = 0; y < height; ++y)
+        {
+            for (int x = 0; x < width; ++x)
+            {
+                if (gen.RandomInt(0, 3) == 0) source->Set(x, y, static_cast<uint32_t>(gen.RandomInt(1, MaterialCount - 1)));
+            }
+        }
+        return source;
+    }
+
+    inline void RandomEdit(PathRandomGenerator& gen, MaterialGridSource& source)
+    {
+        const uint32_t material = static_cast<uint32_t>(gen.RandomInt(0, MaterialCount - 1));
+        switch (gen.RandomInt(0, 9))
+        {
+        case 0:
+        case 1:
+        {
+            const int x0 = gen.RandomInt(0, source.Width() - 1);
+            const int y0 = gen.RandomInt(0, source.Height() - 1);
+            source.FillRect(x0, y0, gen.RandomInt(x0, source.Width() - 1), gen.RandomInt(y0, source.Height() - 1),
+                            material);
+            break;
+        }
+        case 2:
+            if (gen.RandomInt(0, 4) == 0) source.Replace(gen, MaterialCount);
+            break;
+        default:
+            for (int k = gen.RandomInt(1, 8); k > 0; --k)
+                source.Set(gen.RandomInt(0, source.Width() - 1), gen.RandomInt(0, source.Height() - 1), material);
+            break;
+        }
+    }
+
+    /**
+     * @brief Full bake of copies of the sources into a fresh grid with the same layout
+     */
+    inline Navigation::NavGrid ReferenceBake(const Navigation::NavGrid& layout,
+                                             const std::vector<std::shared_ptr<MaterialGridSource>>& sources)
+    {
+        Navigation::NavGrid grid(layout.width, layout.height, layout.cellSize, layout.origin);
+        Navigation::NavGridBaker baker;
+        for (const auto& source : sources)
+            baker.AddSource(std::make_shared<MaterialGridSource>(*source));
+        baker.BakeAll(grid);
+        return grid;
+    }
+
+    inline bool PaddingIsClear(const Navigation::NavGrid& grid)
+    {
+        const int tail = grid.width % Navigation::NavGrid::BitsPerWord;
+        if (tail == 0) return true;
+        for (int y = 0; y < grid.height; ++y)
+        {
+            if (grid.Row(y)[grid.wordsPerRow - 1] >> tail) return false;
+        }
+        return true;
+    }
+
+    /**
+     * Property: after any sequence of edits, lost histories, source additions and removals, the incrementally baked
+     * grid equals a full bake of the same data, and each incremental pass resamples no more cells than a full bake
+     */
+    inline TestResult TestProperty_IncrementalMatchesFullBake(int iterations = 150)
+    {
+        TestResult result;
+        PathRandomGenerator gen(38u);
+        for (int i = 0; i < iterations; ++i)
+        {
+            const int width = gen.RandomInt(1, 200);
+            const int height = gen.RandomInt(1, 80);
+            const ECS::Vector2f origin(gen.RandomFloat(-50.0f, 50.0f), gen.RandomFloat(-50.0f, 50.0f));
+            Navigation::NavGrid grid(width, height, gen.RandomFloat(0.5f, 8.0f), origin);
+            // 手工设置的旧内容会被第一次全量烘焙覆盖
+            for (int k = gen.RandomInt(0, width * height / 4); k > 0; --k)
+                grid.SetWalkable(gen.RandomInt(0, width - 1), gen.RandomInt(0, height - 1), false);
+
+            Navigation::NavGridBaker baker;
+            std::vector<std::shared_ptr<MaterialGridSource>> sources;
+            for (int s = gen.RandomInt(1, 3); s > 0; --s)
+            {
+                sources.push_back(RandomSource(gen, grid));
+                baker.AddSource(sources.back());
+            }
+
+            const int steps = gen.RandomInt(1, 12);
+            for (int step = 0; step < steps; ++step)
+            {
+                if (step > 0)
+                {
+                    for (auto& source : sources)
+                    {
+                        for (int e = gen.RandomInt(0, 3); e > 0; --e)
+                            RandomEdit(gen, *source);
+                    }
+                    if (gen.RandomInt(0, 9) == 0)
+                    {
+                        sources.push_back(RandomSource(gen, grid));
+                        baker.AddSource(sources.back());
+                    }
+                    else if (sources.size() > 1 && gen.RandomInt(0, 9) == 0)
+                    {
+                        baker.RemoveSource(sources.front().get());
+                        sources.erase(sources.begin());
+                    }
+                }
+
+                const size_t resampled = baker.Update(grid);
+                const Navigation::NavGrid reference = ReferenceBake(grid, sources);
+
+                std::ostringstream oss;
+                if (resampled > static_cast<size_t>(width * height))
+                    oss << "Resampled " << resampled << " cells on a " << width << "x" << height << " grid";
+                else if (!PaddingIsClear(grid))
+                    oss << "Row padding bits were set";
+                for (int y = 0; oss.str().empty() && y < height; ++y)
+                {
+                    for (int x = 0; x < width; ++x)
+                    {
+                        if (grid.IsWalkable(x, y) != reference.IsWalkable(x, y) ||
+                            grid.GetCost(x, y) != reference.GetCost(x, y))
+                        {
+                            oss << "Cell (" << x << ", " << y << ") is " << (grid.IsWalkable(x, y) ? "open" : "blocked")
+                                << "/" << static_cast<int>(grid.GetCost(x, y)) << " incrementally but "
+                                << (reference.IsWalkable(x, y) ? "open" : "blocked") << "/"
+                                << static_cast<int>(reference.GetCost(x, y)) << " after a full bake";
+                            break;
+                        }
+                    }
+                }
+                if (!oss.str().empty())
+                {
+                    oss << " (step " << step << ")";
+                    result.passed = false;
+                    result.failedIteration = i;
+                    result.failureMessage = oss.str();
+                    return result;
+                }
+            }
+        }
+        return result;
+    }
+
+    /**
+     * Property: word-level row spans agree with per-cell checks across word boundaries, Fill keeps the row padding
+     * clear and drops the change history so dependents rebuild
+     */
+    inline TestResult TestProperty_RowSpansMatchCells(int iterations = 200)
+    {
+        TestResult result;
+        PathRandomGenerator gen(39u);
+        for (int i = 0; i < iterations; ++i)
+        {
+            const int width = gen.RandomInt(1, 300);
+            const int height = gen.RandomInt(1, 16);
+            Navigation::NavGrid grid =
+                PathfinderTests::RandomObstacleGrid(gen, width, height, gen.RandomInt(0, 1) ? 0.02f : 0.3f);
+
+            std::ostringstream oss;
+            for (int q = 0; q < 100 && oss.str().empty(); ++q)
+            {
+                const int y = gen.RandomInt(-1, height);
+                const int x0 = gen.RandomInt(-1, width);
+                const int x1 = gen.RandomInt(-1, width);
+                bool expected = true;
+                for (int x = std::min(x0, x1); x <= std::max(x0, x1); ++x)
+                    expected = expected && grid.IsWalkable(x, y);
+                if (grid.IsRowSpanWalkable(y, x0, x1) != expected)
+                    oss << "Span [" << x0 << ", " << x1 << "] of row " << y << " on width " << width;
+            }
+
+            const uint64_t before = grid.revision;
+            const bool fillValue = gen.RandomInt(0, 1) != 0;
+            grid.Fill(fillValue);
+            if (oss.str().empty())
+            {
+                if (!PaddingIsClear(grid) || grid.IsWalkable(width, 0))
+                    oss << "Fill set padding bits on width " << width;
+                else if (grid.IsRowSpanWalkable(height - 1, 0, width - 1) != fillValue)
+                    oss << "Fill(" << fillValue << ") left a full row in the wrong state";
+                else if (grid.ForEachChangeSince(before, [](int, int) {}))
+                    oss << "Fill kept the change history";
+            }
+            if (!oss.str().empty())
+            {
+                result.passed = false;
+                result.failedIteration = i;
+                result.failureMessage = oss.str();
+                return result;
+            }
+        }
+        return result;
+    }
+
+    /**
+     * @brief Benchmark: walkability memory, word-level versus per-cell line of sight, full versus incremental bake
+     */
+    inline void RunNavGridBakeBenchmark(int size = 2048, int queries = 20000, int edits = 100)
+    {
+        using Clock = std::chrono::steady_clock;
+        PathRandomGenerator gen(40u);
+
+        Navigation::NavGrid grid(size, size, 8.0f);
+        const size_t bitBytes = grid.walkableBits.size() * sizeof(uint64_t);
+        const size_t byteBytes = static_cast<size_t>(size) * size;
+        LogInfo("{}x{} walkability: {} KiB bit-packed vs {} KiB one byte per cell ({:.1f}x smaller)", size, size,
+                bitBytes / 1024, byteBytes / 1024, static_cast<double>(byteBytes) / bitBytes);
+
+        // 每个格子覆盖 2x2 个瓦片
+        auto source = std::make_shared<MaterialGridSource>(size * 2, size * 2, 4.0f, ECS::Vector2f(0.0f, 0.0f),
+                                                           TestMaterials());
+        for (int k = 0; k < size * size / 2; ++k)
+        {
+            const int x = gen.RandomInt(0, size * 2 - 8);
+            const int y = gen.RandomInt(0, size * 2 - 8);
+            if (gen.RandomInt(0, 40) == 0) source->FillRect(x, y, x + 7, y + 1, 1);
+        }
+        Navigation::NavGridBaker baker;
+        baker.AddSource(source);
+
+        auto t0 = Clock::now();
+        const size_t fullCells = baker.Update(grid);
+        const double fullMs = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+
+        for (int e = 0; e < edits; ++e)
+            source->Set(gen.RandomInt(0, size * 2 - 1), gen.RandomInt(0, size * 2 - 1), gen.RandomInt(0, 1) ? 1u : 0u);
+        t0 = Clock::now();
+        const size_t incrementalCells = baker.Update(grid);
+        const double incrementalMs = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+        LogInfo("Full bake: {} cells in {:.2f} ms; {} tile edits: {} cells in {:.3f} ms", fullCells, fullMs, edits,
+                incrementalCells, incrementalMs);
+
+        std::vector<std::pair<std::pair<int, int>, std::pair<int, int>>> segments;
+        segments.reserve(static_cast<size_t>(queries));
+        for (int q = 0; q < queries; ++q)
+        {
+            const auto a = PathfinderTests::RandomWalkableCell(gen, grid);
+            const int length = gen.RandomInt(4, 256);
+            const int bx = std::clamp(a.first + gen.RandomInt(-length, length), 0, size - 1);
+            const int by = std::clamp(a.second + gen.RandomInt(-length / 4, length / 4), 0, size - 1);
+            segments.push_back({a, {bx, by}});
+        }
+        int visibleWord = 0;
+        int visibleCell = 0;
+        t0 = Clock::now();
+        for (const auto& [a, b] : segments)
+            visibleWord += Navigation::PathSmoother::HasLineOfSight(grid, a.first, a.second, b.first, b.second);
+        const double wordMs = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+        t0 = Clock::now();
+        for (const auto& [a, b] : segments)
+            visibleCell += PathSmootherTests::ReferenceLineOfSight(grid, a.first, a.second, b.first, b.second);
+        const double cellMs = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+        LogInfo("{} mostly horizontal line checks: word-level {:.2f} ms, per-cell {:.2f} ms ({:.1f}x), {} / {} visible",
+                queries, wordMs, cellMs, cellMs / std::max(wordMs, 1e-6), visibleWord, visibleCell);
+    }
+
+    /**
+     * @brief Run all nav grid baking tests
+     *
+     * @return true if all tests pass, false otherwise
+     */
+    inline bool RunAllNavGridBakeTests()
+    {
+        LogInfo("=== Running Nav Grid Bake Tests ===");
+
+        bool allPassed = true;
+        allPassed &= PathfinderTests::RunTest("Incremental bake matches full bake",
+                                              TestProperty_IncrementalMatchesFullBake());
+        allPassed &= PathfinderTests::RunTest("Row spans match per-cell checks", TestProperty_RowSpansMatchCells());
+
+        LogInfo("=== Nav Grid Bake Tests Complete ===");
+        return allPassed;
+    }
+}
+
+#endif // NAV_GRID_BAKE_TESTS_H
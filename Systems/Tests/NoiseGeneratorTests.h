@@ -0,0 +1,439 @@
+#ifndef NOISE_GENERATOR_TESTS_H
+#define NOISE_GENERATOR_TESTS_H
+
+/**
+ * @file NoiseGeneratorTests.h
+ * @brief Property-based tests and benchmark for batched grid noise sampling
+ *
+ * The vectorized grid fills must be bit-identical to the per-sample scalar functions for every
+ * origin, spacing, octave count and seed, including row tails that do not fill a whole SIMD
+ * register, so terrain thresholds classify the same tile whichever path produced the noise.
+ *
+ * Feature: batched-noise
+ */
+
+#include "../ProceduralGen/NoiseGenerator.h"
+#include "../ProceduralGen/TerrainGenerator.h"
+#include "../PixelWorld/PixelWorld.h"
+#include "../WorldStreaming/Chunk.h"
+#include "../../Utils/Logger.h"
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace NoiseGeneratorTests
+{
+    class NoiseRandomGenerator
+    {
+    public:
+        explicit NoiseRandomGenerator(unsigned int seed) : m_gen(seed) {}
+
+        float RandomFloat(float min, float max)
+        {
+            std::uniform_real_distribution<float> dist(min, max);
+            return dist(m_gen);
+        }
+
+        int RandomInt(int min, int max)
+        {
+            std::uniform_int_distribution<int> dist(min, max);
+            return dist(m_gen);
+        }
+
+    private:
+        std::mt19937 m_gen;
+    };
+
+    /**
+     * @brief Test result structure for detailed failure reporting
+     */
+    struct TestResult
+    {
+        bool passed = true;
+        std::string failureMessage;
+        int failedIteration = -1;
+    };
+
+    inline bool RunTest(const char* name, const TestResult& result)
+    {
+        if (result.passed)
+        {
+            LogInfo("{} PASSED", name);
+            return true;
+        }
+        LogError("{} FAILED at iteration {}: {}", name, result.failedIteration, result.failureMessage);
+        return false;
+    }
+
+    /**
+     * @brief Grid placement whose sample coordinates are exactly representable
+     *
+     * Origins and steps are multiples of 1/256, so originX + i * stepX is exact and the scalar
+     * reference sees bit-identical coordinates whether or not the compiler contracts the expression.
+     */
+    struct GridSpec
+    {
+        int width = 0;
+        int height = 0;
+        float originX = 0.0f;
+        float originY = 0.0f;
+        float stepX = 0.0f;
+        float stepY = 0.0f;
+
+        static GridSpec Random(NoiseRandomGenerator& gen)
+        {
+            GridSpec spec;
+            spec.width = gen.RandomInt(1, 70);
+            spec.height = gen.RandomInt(1, 6);
+            spec.originX = static_cast<float>(gen.RandomInt(-256 * 300, 256 * 300)) / 256.0f;
+            spec.originY = static_cast<float>(gen.RandomInt(-256 * 300, 256 * 300)) / 256.0f;
+            spec.stepX = static_cast<float>(gen.RandomInt(1, 128)) / 256.0f;
+            spec.stepY = static_cast<float>(gen.RandomInt(0, 128)) / 256.0f;
+            return spec;
+        }
+
+        float X(int i) const { return originX + static_cast<float>(i) * stepX; }
+        float Y(int j) const { return originY + static_cast<float>(j) * stepY; }
+        size_t Count() const { return static_cast<size_t>(width) * height; }
+    };
+
+    /**
+     * @brief Compare a batched grid against per-sample evaluation, reporting the first mismatch
+     */
+    template <typename Sample>
+    inline bool CompareGrid(const GridSpec& spec, const std::vector<float>& batched, Sample&& sample,
+                            const char* label, TestResult& result, int iteration)
+    {
+        for (int j = 0; j < spec.height; ++j)
+        {
+            for (int i = 0; i < spec.width; ++i)
+            {
+                const float expected = sample(spec.X(i), spec.Y(j));
+                const float actual = batched[static_cast<size_t>(j) * spec.width + i];
+                if (expected == actual) continue;
+
+                std::ostringstream oss;
+                oss << label << " (" << i << ", " << j << ") of " << spec.width << "x" << spec.height << " at ("
+                    << spec.X(i) << ", " << spec.Y(j) << "): batched " << actual << " vs scalar " << expected;
+                result.passed = false;
+                result.failureMessage = oss.str();
+                result.failedIteration = iteration;
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * Property: FillPerlin, FillFBM and FillCellular return exactly Perlin, FBM and Cellular at every
+     * sample, for any grid size, placement, octave count and seed
+     */
+    inline TestResult TestProperty_BatchMatchesScalar(int iterations = 200)
+    {
+        TestResult result;
+        NoiseRandomGenerator gen(41001);
+
+        for (int i = 0; i < iterations; ++i)
+        {
+            const GridSpec spec = GridSpec::Random(gen);
+            const int seed = gen.RandomInt(-5000, 5000);
+            const int octaves = gen.RandomInt(1, 6);
+            const float lacunarity = gen.RandomFloat(1.5f, 2.5f);
+            const float persistence = gen.RandomFloat(0.3f, 0.7f);
+            std::vector<float> batched(spec.Count());
+
+            NoiseGenerator::FillPerlin(batched.data(), spec.width, spec.height, spec.originX, spec.originY,
+                                       spec.stepX, spec.stepY, seed);
+            if (!CompareGrid(spec, batched, [&](float x, float y) { return NoiseGenerator::Perlin(x, y, seed); },
+                             "Perlin", result, i))
+                return result;
+
+            NoiseGenerator::FillFBM(batched.data(), spec.width, spec.height, spec.originX, spec.originY,
+                                    spec.stepX, spec.stepY, octaves, lacunarity, persistence, seed);
+            if (!CompareGrid(spec, batched, [&](float x, float y)
+                             {
+                                 return NoiseGenerator::FBM(x, y, octaves, lacunarity, persistence, seed);
+                             }, "FBM", result, i))
+                return result;
+
+            NoiseGenerator::FillCellular(batched.data(), spec.width, spec.height, spec.originX, spec.originY,
+                                         spec.stepX, spec.stepY, seed);
+            if (!CompareGrid(spec, batched, [&](float x, float y) { return NoiseGenerator::Cellular(x, y, seed); },
+                             "Cellular", result, i))
+                return result;
+        }
+
+        return result;
+    }
+
+    /**
+     * Property: with thresholds placed exactly on, and one ulp either side of, the scalar noise value,
+     * the terrain stages classify batched samples the same way as scalar ones. Covers the cave and
+     * pool tests in Classify, the ore threshold and the truncation of surface heights.
+     */
+    inline TestResult TestProperty_ThresholdEdgesClassifyAlike(int iterations = 100)
+    {
+        TestResult result;
+        NoiseRandomGenerator gen(41003);
+
+        auto fail = [&](int iteration, const std::string& message)
+        {
+            result.passed = false;
+            result.failureMessage = message;
+            result.failedIteration = iteration;
+            return result;
+        };
+
+        for (int i = 0; i < iterations; ++i)
+        {
+            const GridSpec spec = GridSpec::Random(gen);
+            const int seed = gen.RandomInt(-5000, 5000);
+            std::vector<float> cave(spec.Count());
+            std::vector<float> pool(spec.Count());
+            NoiseGenerator::FillCellular(cave.data(), spec.width, spec.height, spec.originX, spec.originY,
+                                         spec.stepX, spec.stepY, seed);
+            NoiseGenerator::FillPerlin(pool.data(), spec.width, spec.height, spec.originX, spec.originY,
+                                       spec.stepX, spec.stepY, seed);
+
+            for (int j = 0; j < spec.height; ++j)
+            {
+                for (int x = 0; x < spec.width; ++x)
+                {
+                    const size_t index = static_cast<size_t>(j) * spec.width + x;
+                    const float scalarCave = NoiseGenerator::Cellular(spec.X(x), spec.Y(j), seed);
+                    const float scalarPool = NoiseGenerator::Perlin(spec.X(x), spec.Y(j), seed);
+                    const float edges[] = {std::nextafter(scalarCave, -INFINITY), scalarCave,
+                                           std::nextafter(scalarCave, INFINITY)};
+
+                    for (float edge : edges)
+                    {
+                        TerrainProfile profile;
+                        profile.caveThreshold = edge;
+                        // 深度越过 LavaDepth，液池判定也参与比较
+                        const int depth = TerrainGenerator::LavaDepth + 1;
+                        const uint16_t batchedTile = TerrainGenerator::Classify(depth, cave[index], pool[index], profile);
+                        const uint16_t scalarTile = TerrainGenerator::Classify(depth, scalarCave, scalarPool, profile);
+                        if (batchedTile == scalarTile) continue;
+
+                        std::ostringstream oss;
+                        oss << "cave threshold " << edge << " at (" << spec.X(x) << ", " << spec.Y(j)
+                            << ") classified " << batchedTile << " batched vs " << scalarTile << " scalar";
+                        return fail(i, oss.str());
+                    }
+                }
+            }
+
+            // 矿脉与地表按 (worldX + x) * frequency 采样；频率取 spec.stepX（1/256 的倍数），坐标都能精确表示
+            const float frequency = spec.stepX;
+            const int worldX = gen.RandomInt(-200, 200);
+            const int worldY = gen.RandomInt(-200, 200);
+            auto coord = [&](int world, int offset) { return static_cast<float>(world + offset) * frequency; };
+            const int pickX = gen.RandomInt(0, spec.width - 1);
+            const int pickY = gen.RandomInt(0, spec.height - 1);
+            const float pickedOre = NoiseGenerator::Perlin(coord(worldX, pickX), coord(worldY, pickY), seed);
+
+            for (float edge : {std::nextafter(pickedOre, -INFINITY), pickedOre, std::nextafter(pickedOre, INFINITY)})
+            {
+                TerrainProfile profile;
+                profile.seed = seed;
+                OreLayer ore;
+                ore.material = PixelType::Water;
+                ore.frequency = frequency;
+                ore.threshold = edge;
+                profile.ores.push_back(ore);
+
+                // 地表远在上方，所有石头都满足 minDepth
+                const int farSurface = INT_MIN / 2;
+                std::vector<uint16_t> tiles(spec.Count(), PixelType::Stone);
+                std::vector<int> surface(spec.width, farSurface);
+                std::vector<float> scratch(spec.Count());
+                TerrainGenerator::ApplyOres(worldX, worldY, spec.width, spec.height, surface.data(), farSurface,
+                                            tiles.data(), scratch.data(), profile);
+
+                for (int j = 0; j < spec.height; ++j)
+                {
+                    for (int x = 0; x < spec.width; ++x)
+                    {
+                        const float noise = NoiseGenerator::Perlin(coord(worldX, x), coord(worldY, j), seed);
+                        const uint16_t expected = noise > edge ? ore.material : static_cast<uint16_t>(PixelType::Stone);
+                        const uint16_t actual = tiles[static_cast<size_t>(j) * spec.width + x];
+                        if (actual == expected) continue;
+
+                        std::ostringstream oss;
+                        oss << "ore threshold " << edge << " at tile (" << x << ", " << j << ") classified " << actual
+                            << " batched vs " << expected << " scalar";
+                        return fail(i, oss.str());
+                    }
+                }
+            }
+
+            // 振幅使选中列的 noise * amplitude 恰好落在整数附近，检验截断一致
+            const float pickedSurface = NoiseGenerator::FBM(coord(worldX, pickX), 0.0f, 4, 2.0f, 0.5f, seed);
+            TerrainProfile profile;
+            profile.seed = seed;
+            profile.surfaceFrequency = frequency;
+            profile.surfaceAmplitude = static_cast<float>(gen.RandomInt(1, 64)) / pickedSurface;
+            std::vector<int> heights(spec.width);
+            TerrainGenerator::SurfaceHeights(worldX, spec.width, heights.data(), profile);
+            for (int x = 0; x < spec.width; ++x)
+            {
+                const float noise = NoiseGenerator::FBM(coord(worldX, x), 0.0f, 4, 2.0f, 0.5f, seed);
+                const int expected = profile.surfaceBaseY + static_cast<int>(noise * profile.surfaceAmplitude);
+                if (heights[x] == expected) continue;
+
+                std::ostringstream oss;
+                oss << "surface height at column " << x << " with amplitude " << profile.surfaceAmplitude << ": "
+                    << heights[x] << " batched vs " << expected << " scalar";
+                return fail(i, oss.str());
+            }
+        }
+
+        return result;
+    }
+
+    /**
+     * @brief Per-tile terrain rule evaluated with the scalar noise functions, as generated before batching
+     */
+    inline uint16_t ReferenceTile(int wx, int wy, const TerrainProfile& profile)
+    {
+        const float surface = NoiseGenerator::FBM(static_cast<float>(wx) * profile.surfaceFrequency, 0.0f,
+                                                  4, 2.0f, 0.5f, profile.seed);
+        const int depth = wy - (profile.surfaceBaseY + static_cast<int>(surface * profile.surfaceAmplitude));
+        if (depth < 0) return PixelType::Air;
+        if (depth < 3) return PixelType::Sand;
+        if (NoiseGenerator::Cellular(static_cast<float>(wx) * profile.caveFrequency,
+                                     static_cast<float>(wy) * profile.caveFrequency, profile.seed + 999) <
+            profile.caveThreshold)
+            return PixelType::Air;
+        if (depth > 80 && NoiseGenerator::Perlin(static_cast<float>(wx) * 0.08f, static_cast<float>(wy) * 0.08f,
+                                                 profile.seed + 777) > 0.75f)
+            return depth > 120 ? PixelType::Lava : PixelType::Water;
+        return PixelType::Stone;
+    }
+
+    /**
+     * Property: batched chunk generation reproduces the per-tile scalar terrain. Sample coordinates
+     * are formed as origin + i * step instead of (origin + i) * frequency, so a tile whose noise sits
+     * within rounding error of a threshold may flip; anything beyond that is a real mismatch.
+     */
+    inline TestResult TestProperty_ChunkGenerationMatchesScalar(int iterations = 40)
+    {
+        using WorldStreaming::Chunk;
+        TestResult result;
+        NoiseRandomGenerator gen(41002);
+        size_t mismatches = 0;
+        size_t total = 0;
+
+        for (int i = 0; i < iterations; ++i)
+        {
+            TerrainProfile profile;
+            profile.seed = gen.RandomInt(0, 100000);
+            // 覆盖天空、地表、洞穴和深层液池
+            const WorldStreaming::ChunkCoord coord{gen.RandomInt(-50, 50), gen.RandomInt(2, 8)};
+
+            Chunk chunk;
+            chunk.Initialize(coord);
+            TerrainGenerator::GenerateForChunk(chunk, profile);
+
+            for (int y = 0; y < Chunk::SIZE; ++y)
+            {
+                for (int x = 0; x < Chunk::SIZE; ++x)
+                {
+                    ++total;
+                    const uint16_t expected = ReferenceTile(coord.x * Chunk::SIZE + x, coord.y * Chunk::SIZE + y, profile);
+                    if (chunk.GetTile(x, y) == expected) continue;
+                    if (++mismatches <= total / 1000 + 2) continue;
+
+                    std::ostringstream oss;
+                    oss << mismatches << " tiles differ from the scalar terrain, last at chunk (" << coord.x << ", "
+                        << coord.y << ") tile (" << x << ", " << y << "): " << chunk.GetTile(x, y) << " vs "
+                        << expected;
+                    result.passed = false;
+                    result.failureMessage = oss.str();
+                    result.failedIteration = i;
+                    return result;
+                }
+            }
+        }
+
+        return result;
+    }
+
+    /**
+     * @brief Single-threaded throughput of per-sample calls versus grid fills
+     */
+    inline void RunNoiseBatchBenchmark(int samples = 1 << 20)
+    {
+        using Clock = std::chrono::steady_clock;
+        LogInfo("=== Batched Noise Benchmark ({}) ===", NoiseGenerator::GetBatchInstructions());
+
+        constexpr int Width = 256;
+        const int height = std::max(1, samples / Width);
+        const double count = static_cast<double>(Width) * height;
+        const float step = 0.05f;
+        std::vector<float> grid(static_cast<size_t>(Width) * height);
+
+        auto measure = [&](const char* name, auto&& scalar, auto&& batched)
+        {
+            double checksum = 0.0;
+            auto t0 = Clock::now();
+            for (int j = 0; j < height; ++j)
+            {
+                for (int i = 0; i < Width; ++i)
+                    grid[static_cast<size_t>(j) * Width + i] = scalar(static_cast<float>(i) * step,
+                                                                      static_cast<float>(j) * step);
+            }
+            const double scalarSeconds = std::chrono::duration<double>(Clock::now() - t0).count();
+            checksum += grid[grid.size() / 2];
+
+            t0 = Clock::now();
+            batched(grid.data());
+            const double batchedSeconds = std::chrono::duration<double>(Clock::now() - t0).count();
+            checksum += grid[grid.size() / 2];
+
+            LogInfo("{:>9}: {:.1f} Msamples/s per core scalar vs {:.1f} batched ({:.1f}x, checksum {:.3f})", name,
+                    count / scalarSeconds * 1e-6, count / batchedSeconds * 1e-6, scalarSeconds / batchedSeconds,
+                    checksum);
+        };
+
+        measure("Perlin", [](float x, float y) { return NoiseGenerator::Perlin(x, y, 7); },
+                [&](float* out) { NoiseGenerator::FillPerlin(out, Width, height, 0.0f, 0.0f, step, step, 7); });
+        measure("FBM x4", [](float x, float y) { return NoiseGenerator::FBM(x, y, 4, 2.0f, 0.5f, 7); },
+                [&](float* out) { NoiseGenerator::FillFBM(out, Width, height, 0.0f, 0.0f, step, step, 4, 2.0f, 0.5f, 7); });
+        measure("Cellular", [](float x, float y) { return NoiseGenerator::Cellular(x, y, 7); },
+                [&](float* out) { NoiseGenerator::FillCellular(out, Width, height, 0.0f, 0.0f, step, step, 7); });
+
+        // 地下区块需要洞穴和液池噪声，是生成最慢的情形
+        const int chunks = std::max(1, samples / (WorldStreaming::Chunk::SIZE * WorldStreaming::Chunk::SIZE));
+        TerrainProfile profile;
+        WorldStreaming::Chunk chunk;
+        auto t0 = Clock::now();
+        for (int c = 0; c < chunks; ++c)
+        {
+            chunk.Initialize({c % 32, 5 + c / 32 % 8});
+            TerrainGenerator::GenerateForChunk(chunk, profile);
+        }
+        const double chunkSeconds = std::chrono::duration<double>(Clock::now() - t0).count();
+        LogInfo("underground chunks: {:.1f} us per chunk ({:.0f} chunks/s per core)", chunkSeconds / chunks * 1e6,
+                chunks / chunkSeconds);
+    }
+
+    /**
+     * @brief Run all batched noise tests
+     */
+    inline bool RunAllNoiseGeneratorTests()
+    {
+        bool allPassed = true;
+        allPassed &= RunTest("Batch Matches Scalar", TestProperty_BatchMatchesScalar());
+        allPassed &= RunTest("Chunk Generation Matches Scalar", TestProperty_ChunkGenerationMatchesScalar());
+        allPassed &= RunTest("Threshold Edges Classify Alike", TestProperty_ThresholdEdgesClassifyAlike());
+        return allPassed;
+    }
+}
+
+#endif
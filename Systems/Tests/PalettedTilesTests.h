@@ -0,0 +1,539 @@
+#ifndef PALETTED_TILES_TESTS_H
+#define PALETTED_TILES_TESTS_H
+
+/**
+ * @file PalettedTilesTests.h
+ * @brief Property-based tests and benchmark for palette-compressed chunk tile storage
+ *
+ * Feature: paletted-chunk-tiles
+ */
+
+#include "ChunkStreamingTests.h"
+#include "../WorldStreaming/PalettedTiles.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <sstream>
+#include <unordered_set>
+#include <vector>
+
+namespace PalettedTilesTests
+{
+    using ChunkStreamingTests::StreamingRandomGenerator;
+    using ChunkStreamingTests::TestResult;
+    using WorldStreaming::Chunk;
+    using WorldStreaming::PalettedTiles;
+
+    /**
+     * @brief Row-major dense tiles mirroring every operation applied to a PalettedTiles
+     */
+    struct DenseReference
+    {
+        int width = 0;
+        int height = 0;
+        std::vector<uint16_t> tiles;
+
+        DenseReference(int w, int h, uint16_t fill) : width(w), height(h), tiles(static_cast<size_t>(w) * h, fill) {}
+
+        uint16_t& At(int x, int y) { return tiles[static_cast<size_t>(y) * width + x]; }
+
+        size_t UniqueCount() const
+        {
+            return std::unordered_set<uint16_t>(tiles.begin(), tiles.end()).size();
+        }
+    };
+
+    /**
+     * @brief Checks contents and the palette/bit-width invariants of the storage
+     *
+     * Paletted storage must use at least the minimal width for its distinct tiles and may lag at most one
+     * width step behind a shrinking palette; single-value contents must not keep an index array.
+     * Direct storage is only required to hold the right values. When @p exact is set (after whole-chunk
+     * writes) the width must be exactly minimal.
+     */
+    inline bool CheckStorage(const PalettedTiles& storage, const DenseReference& reference, StreamingRandomGenerator& gen,
+                             bool exact, std::string& outMessage)
+    {
+        std::vector<uint16_t> copy(storage.Count());
+        storage.CopyTo(copy.data());
+        if (copy != reference.tiles)
+        {
+            for (size_t i = 0; i < copy.size(); ++i)
+            {
+                if (copy[i] == reference.tiles[i]) continue;
+                std::ostringstream oss;
+                oss << "tile " << i << " is " << copy[i] << ", expected " << reference.tiles[i] << " (bits "
+                    << storage.BitsPerIndex() << ")";
+                outMessage = oss.str();
+                return false;
+            }
+        }
+
+        for (int probe = 0; probe < 16; ++probe)
+        {
+            const int x = gen.RandomInt(0, reference.width - 1);
+            const int y = gen.RandomInt(0, reference.height - 1);
+            if (storage.Get(x, y) != reference.tiles[static_cast<size_t>(y) * reference.width + x])
+            {
+                outMessage = "Get disagrees with CopyTo";
+                return false;
+            }
+        }
+
+        const int x = gen.RandomInt(0, reference.width - 1);
+        const int y = gen.RandomInt(0, reference.height - 1);
+        const int w = gen.RandomInt(1, reference.width - x);
+        const int h = gen.RandomInt(1, reference.height - y);
+        std::vector<uint16_t> region(static_cast<size_t>(w) * h);
+        storage.GetRegion(x, y, w, h, region.data());
+        for (int row = 0; row < h; ++row)
+        {
+            for (int col = 0; col < w; ++col)
+            {
+                if (region[static_cast<size_t>(row) * w + col] !=
+                    reference.tiles[static_cast<size_t>(y + row) * reference.width + x + col])
+                {
+                    outMessage = "GetRegion disagrees with the reference";
+                    return false;
+                }
+            }
+        }
+
+        const size_t unique = reference.UniqueCount();
+        const int minimal = PalettedTiles::BitsFor(unique);
+        const int bits = storage.BitsPerIndex();
+        std::ostringstream oss;
+        oss << unique << " distinct tiles stored with " << bits << " bits, palette size " << storage.PaletteSize();
+        if (bits == PalettedTiles::DirectBits)
+        {
+            if (exact && minimal != PalettedTiles::DirectBits)
+            {
+                outMessage = oss.str() + " after a whole-chunk write";
+                return false;
+            }
+            return true;
+        }
+        if (storage.PaletteSize() != unique || bits < minimal || (minimal == 0 ? bits != 0 : bits >= minimal * 4) ||
+            (exact && bits != minimal))
+        {
+            outMessage = oss.str();
+            return false;
+        }
+        if (bits == 0 && storage.HeapBytes() != 0)
+        {
+            outMessage = "single-value storage still owns heap memory";
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * Property: every read of a PalettedTiles matches a dense reference under random mixes of single-tile
+     * writes, fills, region and row writes, whole-chunk assigns and compaction, across alphabets that
+     * exercise the single-value, 1/2/4/8-bit and direct representations.
+     */
+    inline TestResult TestProperty_MatchesDenseReference(int iterations = 200)
+    {
+        TestResult result;
+        StreamingRandomGenerator gen(39001);
+        const int alphabets[] = {1, 2, 3, 5, 16, 17, 200, 400};
+
+        for (int i = 0; i < iterations; ++i)
+        {
+            const bool chunkSized = gen.RandomInt(0, 1) == 0;
+            const int width = chunkSized ? Chunk::SIZE : gen.RandomInt(1, 70);
+            const int height = chunkSized ? Chunk::SIZE : gen.RandomInt(1, 70);
+            const int alphabet = alphabets[gen.RandomInt(0, 7)];
+            const uint16_t base = static_cast<uint16_t>(gen.RandomInt(0, 60000));
+            const auto randomTile = [&] { return static_cast<uint16_t>(base + gen.RandomInt(0, alphabet - 1)); };
+
+            const uint16_t initial = randomTile();
+            PalettedTiles storage(width, height, initial);
+            DenseReference reference(width, height, initial);
+
+            for (int op = 0; op < 40; ++op)
+            {
+                bool exact = false;
+                const int kind = gen.RandomInt(0, 9);
+                if (kind <= 3)
+                {
+                    const int writes = gen.RandomInt(1, 200);
+                    for (int w = 0; w < writes; ++w)
+                    {
+                        const int x = gen.RandomInt(0, width - 1);
+                        const int y = gen.RandomInt(0, height - 1);
+                        const uint16_t tile = randomTile();
+                        storage.Set(x, y, tile);
+                        reference.At(x, y) = tile;
+                    }
+                }
+                else if (kind <= 6)
+                {
+                    const int x = gen.RandomInt(0, width - 1);
+                    const int y = gen.RandomInt(0, height - 1);
+                    const int w = gen.RandomInt(1, width - x);
+                    const int h = gen.RandomInt(1, height - y);
+                    if (kind == 4)
+                    {
+                        const uint16_t tile = randomTile();
+                        storage.FillRegion(x, y, w, h, tile);
+                        for (int row = y; row < y + h; ++row)
+                            std::fill_n(&reference.At(x, row), w, tile);
+                    }
+                    else
+                    {
+                        std::vector<uint16_t> values(static_cast<size_t>(w) * h);
+                        // Regions with few kinds resemble real terrain edits
+                        const int variety = gen.RandomInt(1, alphabet);
+                        for (auto& value : values)
+                            value = static_cast<uint16_t>(base + gen.RandomInt(0, variety - 1));
+                        storage.SetRegion(x, y, w, h, values.data());
+                        for (int row = 0; row < h; ++row)
+                            std::copy_n(&values[static_cast<size_t>(row) * w], w, &reference.At(x, y + row));
+                    }
+                }
+                else if (kind == 7)
+                {
+                    const int y = gen.RandomInt(0, height - 1);
+                    std::vector<uint16_t> row(width);
+                    for (auto& value : row)
+                        value = randomTile();
+                    storage.SetRow(y, row.data());
+                    std::copy(row.begin(), row.end(), &reference.At(0, y));
+                }
+                else if (kind == 8)
+                {
+                    exact = true;
+                    if (gen.RandomInt(0, 2) == 0)
+                    {
+                        const uint16_t tile = randomTile();
+                        storage.Fill(tile);
+                        std::fill(reference.tiles.begin(), reference.tiles.end(), tile);
+                    }
+                    else
+                    {
+                        for (auto& value : reference.tiles)
+                            value = randomTile();
+                        storage.Assign(reference.tiles.data());
+                    }
+                }
+                else
+                {
+                    storage.Compact();
+                    exact = true;
+                }
+
+                std::string message;
+                if (!CheckStorage(storage, reference, gen, exact, message))
+                {
+                    std::ostringstream oss;
+                    oss << width << "x" << height << ", alphabet " << alphabet << ", op " << op << " (kind " << kind
+                        << "): " << message;
+                    result.passed = false;
+                    result.failedIteration = i;
+                    result.failureMessage = oss.str();
+                    return result;
+                }
+            }
+        }
+        return result;
+    }
+
+    /**
+     * Property: adding distinct tiles one at a time widens the indices exactly when the palette overflows,
+     * and removing them again, tile by tile or with one region write, narrows the indices (with one step of
+     * hysteresis) down to a single value without an index array.
+     */
+    inline TestResult TestProperty_PaletteGrowsAndShrinks(int iterations = 50)
+    {
+        TestResult result;
+        StreamingRandomGenerator gen(39002);
+
+        for (int i = 0; i < iterations; ++i)
+        {
+            const uint16_t background = static_cast<uint16_t>(gen.RandomInt(0, 1000));
+            PalettedTiles storage(Chunk::SIZE, Chunk::SIZE, background);
+            const int distinct = gen.RandomInt(2, 300);
+            std::vector<std::pair<int, int>> positions;
+
+            for (int k = 1; k < distinct; ++k)
+            {
+                const int x = k % Chunk::SIZE;
+                const int y = k / Chunk::SIZE;
+                storage.Set(x, y, static_cast<uint16_t>(background + 1 + k));
+                positions.emplace_back(x, y);
+                const int expected = PalettedTiles::BitsFor(static_cast<size_t>(k) + 1);
+                if (storage.BitsPerIndex() != expected)
+                {
+                    std::ostringstream oss;
+                    oss << "after " << k + 1 << " distinct tiles bits " << storage.BitsPerIndex() << ", expected "
+                        << expected;
+                    result.passed = false;
+                    result.failedIteration = i;
+                    result.failureMessage = oss.str();
+                    return result;
+                }
+            }
+
+            if (i % 2 == 0 && storage.BitsPerIndex() != PalettedTiles::DirectBits)
+            {
+                // A region write that covers every distinct tile but not the whole chunk must also narrow
+                storage.FillRegion(0, 0, Chunk::SIZE, Chunk::SIZE - 1, background);
+                if (!storage.IsUniform() || storage.HeapBytes() != 0)
+                {
+                    result.passed = false;
+                    result.failedIteration = i;
+                    result.failureMessage = "FillRegion over all distinct tiles kept an index array";
+                    return result;
+                }
+                continue;
+            }
+
+            std::shuffle(positions.begin(), positions.end(), gen.Engine());
+            for (size_t k = 0; k < positions.size(); ++k)
+            {
+                storage.Set(positions[k].first, positions[k].second, background);
+                const size_t remaining = positions.size() - k;
+                const int minimal = PalettedTiles::BitsFor(remaining);
+                const int bits = storage.BitsPerIndex();
+                const bool direct = bits == PalettedTiles::DirectBits;
+                // Direct storage keeps no counts and only narrows on whole-chunk writes or Compact
+                if (!direct && (bits < minimal || (minimal == 0 ? bits != 0 : bits >= minimal * 4)))
+                {
+                    std::ostringstream oss;
+                    oss << remaining << " distinct tiles left but bits " << bits;
+                    result.passed = false;
+                    result.failedIteration = i;
+                    result.failureMessage = oss.str();
+                    return result;
+                }
+            }
+
+            storage.Compact();
+            if (!storage.IsUniform() || storage.HeapBytes() != 0 || storage.Get(0, 0) != background)
+            {
+                result.passed = false;
+                result.failedIteration = i;
+                result.failureMessage = "cleared storage did not return to a single value";
+                return result;
+            }
+        }
+        return result;
+    }
+
+    /**
+     * Property: a region write that brings back a palette entry whose count dropped to zero and also adds new
+     * tiles must widen the indices for both, instead of handing out slots past the current width and
+     * corrupting neighbouring indices. Iteration 0 replays the minimal 8x8 case.
+     */
+    inline TestResult TestProperty_RevivedPaletteEntriesReserved(int iterations = 100)
+    {
+        TestResult result;
+        StreamingRandomGenerator gen(39003);
+        const int widths[] = {1, 2, 4, 8};
+
+        for (int i = 0; i < iterations; ++i)
+        {
+            const int size = i == 0 ? 8 : gen.RandomInt(17, Chunk::SIZE);
+            const int capacity = i == 0 ? 4 : 1 << widths[gen.RandomInt(0, 3)];
+            const uint16_t background = i == 0 ? 1 : static_cast<uint16_t>(gen.RandomInt(0, 1000));
+            PalettedTiles storage(size, size, background);
+            DenseReference reference(size, size, background);
+
+            // Fill the palette to the current width, then drop some entries to a zero count
+            const auto set = [&](int cell, uint16_t tile)
+            {
+                storage.Set(cell % size, cell / size, tile);
+                reference.At(cell % size, cell / size) = tile;
+            };
+            for (int k = 1; k < capacity; ++k)
+                set(k - 1, static_cast<uint16_t>(background + k));
+            const int dropped = i == 0 ? 1 : gen.RandomInt(1, std::max(1, std::min((capacity - 1) / 4, size - 3)));
+            for (int k = 0; k < dropped; ++k)
+                set(capacity - 2 - k, background);
+
+            std::vector<uint16_t> values;
+            for (int k = 0; k < dropped; ++k)
+                values.push_back(static_cast<uint16_t>(background + capacity - 1 - k));
+            const int added = i == 0 ? 1 : gen.RandomInt(1, 3);
+            for (int k = 0; k < added; ++k)
+                values.push_back(static_cast<uint16_t>(background + capacity + k));
+            const int w = static_cast<int>(values.size());
+            const int x = i == 0 ? 3 : gen.RandomInt(0, size - w);
+            const int y = i == 0 ? 3 : size - 1;
+            storage.SetRegion(x, y, w, 1, values.data());
+            std::copy(values.begin(), values.end(), &reference.At(x, y));
+
+            std::string message;
+            if (!CheckStorage(storage, reference, gen, false, message))
+            {
+                std::ostringstream oss;
+                oss << size << "x" << size << ", palette capacity " << capacity << ", " << dropped
+                    << " revived and " << added << " new tiles: " << message;
+                result.passed = false;
+                result.failedIteration = i;
+                result.failureMessage = oss.str();
+                return result;
+            }
+        }
+        return result;
+    }
+
+    /**
+     * @brief Surface-like chunk content: air above a wavy line, a sand band, then stone with ore specks
+     */
+    inline std::vector<uint16_t> TerrainLikeTiles(StreamingRandomGenerator& gen, int kinds)
+    {
+        std::vector<uint16_t> tiles(static_cast<size_t>(Chunk::SIZE) * Chunk::SIZE);
+        for (int x = 0; x < Chunk::SIZE; ++x)
+        {
+            const int surface = 20 + static_cast<int>(8.0 * std::sin(x * 0.2));
+            for (int y = 0; y < Chunk::SIZE; ++y)
+            {
+                uint16_t tile = y < surface ? 0 : (y < surface + 3 ? 1 : 2);
+                if (tile == 2 && kinds > 3 && gen.RandomInt(0, 15) == 0)
+                    tile = static_cast<uint16_t>(3 + gen.RandomInt(0, kinds - 4));
+                tiles[static_cast<size_t>(y) * Chunk::SIZE + x] = tile;
+            }
+        }
+        return tiles;
+    }
+
+    /**
+     * @brief Compares random access, bulk fills and memory per chunk against dense uint16_t storage
+     */
+    inline void RunPalettedTilesBenchmark(int chunks = 256, int operations = 1 << 20)
+    {
+        using Clock = std::chrono::steady_clock;
+        LogInfo("=== Paletted Tiles Benchmark ===");
+        StreamingRandomGenerator gen(39003);
+        constexpr size_t TileCount = static_cast<size_t>(Chunk::SIZE) * Chunk::SIZE;
+        const size_t denseBytes = TileCount * sizeof(uint16_t);
+
+        const struct
+        {
+            const char* name;
+            int kinds;
+        } contents[] = {{"uniform", 1}, {"surface", 3}, {"ores", 12}, {"mixed", 60}, {"noise", 1000}};
+        for (const auto& content : contents)
+        {
+            size_t bytes = 0;
+            int bits = 0;
+            for (int c = 0; c < chunks; ++c)
+            {
+                std::vector<uint16_t> tiles;
+                if (content.kinds == 1)
+                    tiles.assign(TileCount, 0);
+                else if (content.kinds == 1000)
+                {
+                    tiles.resize(TileCount);
+                    for (auto& tile : tiles)
+                        tile = static_cast<uint16_t>(gen.RandomInt(0, 999));
+                }
+                else
+                    tiles = TerrainLikeTiles(gen, content.kinds);
+                PalettedTiles storage(Chunk::SIZE, Chunk::SIZE);
+                storage.Assign(tiles.data());
+                bytes += storage.HeapBytes() + sizeof(PalettedTiles);
+                bits = std::max(bits, storage.BitsPerIndex());
+            }
+            LogInfo("{:>8} chunks: {:.0f} bytes/chunk ({} bits/tile) vs {} dense ({:.1f}x smaller)", content.name,
+                    static_cast<double>(bytes) / chunks, bits, denseBytes,
+                    static_cast<double>(denseBytes) * chunks / static_cast<double>(bytes));
+        }
+
+        std::vector<uint16_t> surface = TerrainLikeTiles(gen, 12);
+        PalettedTiles storage(Chunk::SIZE, Chunk::SIZE);
+        storage.Assign(surface.data());
+        std::vector<uint16_t> dense = surface;
+
+        std::vector<uint32_t> indices(operations);
+        for (auto& index : indices)
+            index = static_cast<uint32_t>(gen.RandomInt(0, static_cast<int>(TileCount) - 1));
+
+        uint64_t checksum = 0;
+        auto t0 = Clock::now();
+        for (uint32_t index : indices)
+            checksum += storage.Get(static_cast<int>(index % Chunk::SIZE), static_cast<int>(index / Chunk::SIZE));
+        const double palettedGet = std::chrono::duration<double, std::nano>(Clock::now() - t0).count() / operations;
+        t0 = Clock::now();
+        for (uint32_t index : indices)
+            checksum += dense[index];
+        const double denseGet = std::chrono::duration<double, std::nano>(Clock::now() - t0).count() / operations;
+
+        t0 = Clock::now();
+        for (size_t k = 0; k < indices.size(); ++k)
+        {
+            const uint32_t index = indices[k];
+            storage.Set(static_cast<int>(index % Chunk::SIZE), static_cast<int>(index / Chunk::SIZE),
+                        static_cast<uint16_t>(k % 12));
+        }
+        const double palettedSet = std::chrono::duration<double, std::nano>(Clock::now() - t0).count() / operations;
+        t0 = Clock::now();
+        for (size_t k = 0; k < indices.size(); ++k)
+            dense[indices[k]] = static_cast<uint16_t>(k % 12);
+        const double denseSet = std::chrono::duration<double, std::nano>(Clock::now() - t0).count() / operations;
+        checksum += dense[indices[0]];
+
+        LogInfo("random access: get {:.2f} ns vs {:.2f} ns dense, set {:.2f} ns vs {:.2f} ns dense", palettedGet,
+                denseGet, palettedSet, denseSet);
+
+        // Bulk writes: per-tile Set versus row / region writes
+        const int rounds = std::max(1, operations / static_cast<int>(TileCount));
+        std::vector<uint16_t> row(Chunk::SIZE);
+        t0 = Clock::now();
+        for (int r = 0; r < rounds; ++r)
+        {
+            storage.Assign(surface.data());
+            for (int y = 0; y < Chunk::SIZE / 2; ++y)
+            {
+                for (int x = 0; x < Chunk::SIZE; ++x)
+                    storage.Set(x, y, static_cast<uint16_t>(r % 4));
+            }
+        }
+        const double perTileFill = std::chrono::duration<double, std::micro>(Clock::now() - t0).count() / rounds;
+        t0 = Clock::now();
+        for (int r = 0; r < rounds; ++r)
+        {
+            storage.Assign(surface.data());
+            storage.FillRegion(0, 0, Chunk::SIZE, Chunk::SIZE / 2, static_cast<uint16_t>(r % 4));
+        }
+        const double regionFill = std::chrono::duration<double, std::micro>(Clock::now() - t0).count() / rounds;
+        t0 = Clock::now();
+        for (int r = 0; r < rounds; ++r)
+        {
+            for (int y = 0; y < Chunk::SIZE; ++y)
+            {
+                storage.GetRow(y, row.data());
+                checksum += row[static_cast<size_t>(r) % row.size()];
+            }
+        }
+        const double rowRead = std::chrono::duration<double, std::micro>(Clock::now() - t0).count() / rounds;
+
+        LogInfo("half-chunk fill: {:.2f} us per-tile vs {:.2f} us FillRegion (incl. Assign); row reads {:.2f} us per chunk "
+                "(checksum {})", perTileFill, regionFill, rowRead, checksum);
+    }
+
+    /**
+     * @brief Run all paletted tile storage tests
+     *
+     * @return true if all tests pass, false otherwise
+     */
+    inline bool RunAllPalettedTilesTests()
+    {
+        LogInfo("=== Running Paletted Tiles Tests ===");
+
+        bool allPassed = true;
+        allPassed &= ChunkStreamingTests::RunTest("Paletted tiles match a dense reference",
+                                                  TestProperty_MatchesDenseReference());
+        allPassed &= ChunkStreamingTests::RunTest("Palette grows and shrinks with its contents",
+                                                  TestProperty_PaletteGrowsAndShrinks());
+        allPassed &= ChunkStreamingTests::RunTest("Revived palette entries are reserved on region writes",
+                                                  TestProperty_RevivedPaletteEntriesReserved());
+
+        LogInfo("=== Paletted Tiles Tests Complete ===");
+        return allPassed;
+    }
+}
+
+#endif // PALETTED_TILES_TESTS_H
@@ -0,0 +1,427 @@
+#ifndef PATH_REQUEST_QUEUE_TESTS_H
+#define PATH_REQUEST_QUEUE_TESTS_H
+
+/**
+ * @file PathRequestQueueTests.h
+ * @brief Property-based tests and benchmark for the asynchronous path request queue
+ *
+ * Feature: async-path-requests
+ */
+
+#include "PathfinderTests.h"
+#include "../Navigation/PathRequestQueue.h"
+#include <map>
+
+namespace PathRequestQueueTests
+{
+    using PathfinderTests::PathRandomGenerator;
+    using PathfinderTests::TestResult;
+
+    struct Delivery
+    {
+        int count = 0;
+        Navigation::PathResult result;
+    };
+
+    /**
+     * @brief Tick the queue until nothing is pending, in flight or ready, collecting every delivery
+     */
+    inline void Drain(Navigation::PathRequestQueue& queue, const Navigation::NavGrid& grid,
+                      std::map<uint64_t, Delivery>& delivered, int maxTicks = 100000)
+    {
+        for (int tick = 0; tick < maxTicks; ++tick)
+        {
+            queue.Update(grid);
+            queue.WaitForInFlight();
+            queue.Integrate(1e9, [&](uint64_t requester, const Navigation::PathResult& result)
+            {
+                auto& delivery = delivered[requester];
+                ++delivery.count;
+                delivery.result = result;
+            });
+            if (queue.GetPendingCount() == 0 && queue.GetInFlightCount() == 0 && queue.GetReadyCount() == 0)
+                return;
+        }
+    }
+
+    /**
+     * @brief Check a delivery against a synchronous search on the current grid
+     */
+    inline bool MatchesSynchronous(const Navigation::NavGrid& grid, std::pair<int, int> start,
+                                   const Navigation::PathRequest& request, const Navigation::PathResult& result)
+    {
+        const auto expected = Navigation::Pathfinder::FindPath(grid, request);
+        if (expected.found != result.found) return false;
+        if (!result.found) return true;
+        const float walked = PathfinderTests::ValidatePath(grid, start, result, request.allowDiagonal);
+        return walked >= 0.0f && std::abs(walked - expected.cost) <= 1e-3f * std::max(1.0f, expected.cost);
+    }
+
+    /**
+     * Property: every requester receives exactly one result and it is as good as a synchronous search,
+     * whether it was solved, coalesced with an identical request or served from the cache
+     */
+    inline TestResult TestProperty_ResultsMatchSynchronous(int iterations = 60)
+    {
+        TestResult result;
+        PathRandomGenerator gen(33u);
+        for (int i = 0; i < iterations; ++i)
+        {
+            const Navigation::NavGrid grid = PathfinderTests::RandomObstacleGrid(gen, gen.RandomInt(8, 64),
+                                                                               gen.RandomInt(8, 64), 0.3f);
+            Navigation::PathRequestQueue queue(gen.RandomInt(0, 8), gen.RandomInt(1, 4));
+            std::vector<std::pair<std::pair<int, int>, std::pair<int, int>>> pairs;
+            for (int p = 0; p < 6; ++p)
+                pairs.push_back({PathfinderTests::RandomWalkableCell(gen, grid),
+                                 PathfinderTests::RandomWalkableCell(gen, grid)});
+
+            std::map<uint64_t, Delivery> delivered;
+            std::map<uint64_t, size_t> asked;
+            for (int round = 0; round < 3; ++round)
+            {
+                for (uint64_t r = 0; r < 20; ++r)
+                {
+                    const uint64_t requester = round * 100 + r;
+                    const size_t pair = static_cast<size_t>(gen.RandomInt(0, static_cast<int>(pairs.size()) - 1));
+                    asked[requester] = pair;
+                    queue.Submit(grid, requester,
+                                 PathfinderTests::MakeRequest(grid, pairs[pair].first, pairs[pair].second, true,
+                                                              Navigation::PathSearchMode::Auto),
+                                 gen.RandomInt(0, 10));
+                }
+                Drain(queue, grid, delivered);
+            }
+
+            for (const auto& [requester, pair] : asked)
+            {
+                const auto it = delivered.find(requester);
+                const auto request = PathfinderTests::MakeRequest(grid, pairs[pair].first, pairs[pair].second, true,
+                                                                  Navigation::PathSearchMode::Auto);
+                if (it == delivered.end() || it->second.count != 1 ||
+                    !MatchesSynchronous(grid, pairs[pair].first, request, it->second.result))
+                {
+                    result.passed = false;
+                    result.failedIteration = i;
+                    result.failureMessage = "Requester " + std::to_string(requester) +
+                                            " did not receive exactly one correct path";
+                    return result;
+                }
+            }
+        }
+        return result;
+    }
+
+    /**
+     * Property: cancelled requests are never delivered, at whatever stage they were cancelled, and a
+     * superseded request only delivers its latest submission
+     */
+    inline TestResult TestProperty_Cancellation(int iterations = 60)
+    {
+        TestResult result;
+        PathRandomGenerator gen(34u);
+        for (int i = 0; i < iterations; ++i)
+        {
+            const Navigation::NavGrid grid = PathfinderTests::RandomObstacleGrid(gen, 48, 48, 0.25f);
+            Navigation::PathRequestQueue queue(16, 2);
+            std::map<uint64_t, Delivery> delivered;
+            std::map<uint64_t, std::pair<int, int>> latestGoal;
+            std::vector<uint64_t> cancelled;
+
+            for (uint64_t requester = 0; requester < 30; ++requester)
+            {
+                const auto start = PathfinderTests::RandomWalkableCell(gen, grid);
+                const auto goal = PathfinderTests::RandomWalkableCell(gen, grid);
+                queue.Submit(grid, requester,
+                             PathfinderTests::MakeRequest(grid, start, goal, true, Navigation::PathSearchMode::Auto));
+                latestGoal[requester] = goal;
+            }
+
+            // 在排队、搜索中和已完成三个阶段分别取消或重新提交
+            for (int stage = 0; stage < 3; ++stage)
+            {
+                if (stage == 1) queue.Update(grid);
+                if (stage == 2)
+                {
+                    queue.WaitForInFlight();
+                    queue.Update(grid);
+                }
+                for (int k = 0; k < 4; ++k)
+                {
+                    const uint64_t requester = static_cast<uint64_t>(gen.RandomInt(0, 29));
+                    if (gen.RandomInt(0, 1) == 0)
+                    {
+                        queue.Cancel(requester);
+                        cancelled.push_back(requester);
+                        latestGoal.erase(requester);
+                    }
+                    else
+                    {
+                        const auto start = PathfinderTests::RandomWalkableCell(gen, grid);
+                        const auto goal = PathfinderTests::RandomWalkableCell(gen, grid);
+                        queue.Submit(grid, requester, PathfinderTests::MakeRequest(
+                                         grid, start, goal, true, Navigation::PathSearchMode::Auto));
+                        latestGoal[requester] = goal;
+                    }
+                }
+            }
+            Drain(queue, grid, delivered);
+
+            for (const auto& [requester, delivery] : delivered)
+            {
+                const auto goal = latestGoal.find(requester);
+                if (goal == latestGoal.end() || delivery.count != 1 ||
+                    (delivery.result.found && !delivery.result.waypoints.empty() &&
+                     grid.WorldToGrid(delivery.result.waypoints.back()) != goal->second))
+                {
+                    result.passed = false;
+                    result.failedIteration = i;
+                    result.failureMessage = "Requester " + std::to_string(requester) +
+                                            " received a cancelled or superseded path";
+                    return result;
+                }
+            }
+            if (delivered.size() != latestGoal.size())
+            {
+                result.passed = false;
+                result.failedIteration = i;
+                result.failureMessage = "Some live requests were never delivered";
+                return result;
+            }
+        }
+        return result;
+    }
+
+    /**
+     * Property: results computed before a grid edit are never delivered if the edit blocks them or opens
+     * a shorter route, and cached paths are dropped the same way
+     */
+    inline TestResult TestProperty_StaleResultsAfterGridChange(int iterations = 80)
+    {
+        TestResult result;
+        PathRandomGenerator gen(35u);
+        for (int i = 0; i < iterations; ++i)
+        {
+            Navigation::NavGrid grid = PathfinderTests::RandomObstacleGrid(gen, gen.RandomInt(16, 48),
+                                                                         gen.RandomInt(16, 48), 0.3f);
+            Navigation::PathRequestQueue queue(32, 4);
+            std::vector<std::pair<std::pair<int, int>, std::pair<int, int>>> pairs;
+            for (int p = 0; p < 8; ++p)
+                pairs.push_back({PathfinderTests::RandomWalkableCell(gen, grid),
+                                 PathfinderTests::RandomWalkableCell(gen, grid)});
+
+            for (int round = 0; round < 4; ++round)
+            {
+                std::map<uint64_t, Delivery> delivered;
+                for (uint64_t r = 0; r < pairs.size(); ++r)
+                {
+                    queue.Submit(grid, r, PathfinderTests::MakeRequest(grid, pairs[r].first, pairs[r].second, true,
+                                                                       Navigation::PathSearchMode::Auto));
+                }
+                queue.Update(grid);
+                queue.WaitForInFlight();
+
+                // 搜索已经完成但尚未回收时修改网格（起终点保持可走）
+                for (int e = 0; e < gen.RandomInt(1, 20); ++e)
+                {
+                    const int x = gen.RandomInt(0, grid.width - 1);
+                    const int y = gen.RandomInt(0, grid.height - 1);
+                    bool endpoint = false;
+                    for (auto& [from, to] : pairs)
+                        endpoint |= (from == std::make_pair(x, y)) || (to == std::make_pair(x, y));
+                    if (!endpoint) grid.SetWalkable(x, y, !grid.IsWalkable(x, y));
+                }
+                Drain(queue, grid, delivered);
+
+                for (uint64_t r = 0; r < pairs.size(); ++r)
+                {
+                    const auto request = PathfinderTests::MakeRequest(grid, pairs[r].first, pairs[r].second, true,
+                                                                      Navigation::PathSearchMode::Auto);
+                    if (delivered[r].count != 1 ||
+                        !MatchesSynchronous(grid, pairs[r].first, request, delivered[r].result))
+                    {
+                        result.passed = false;
+                        result.failedIteration = i;
+                        result.failureMessage = "Delivered a path that is stale after a grid edit (round " +
+                                                std::to_string(round) + ")";
+                        return result;
+                    }
+                }
+            }
+        }
+        return result;
+    }
+
+    /**
+     * Property: with a single search slot and a constant stream of high-priority requests, a low-priority
+     * request is still served within a bounded number of ticks, and equal-age requests go by priority
+     */
+    inline TestResult TestProperty_Fairness(int iterations = 20)
+    {
+        TestResult result;
+        PathRandomGenerator gen(36u);
+        for (int i = 0; i < iterations; ++i)
+        {
+            const Navigation::NavGrid grid = PathfinderTests::RandomObstacleGrid(gen, 32, 32, 0.1f);
+            Navigation::PathRequestQueue queue(0, 1);
+            const int highPriority = gen.RandomInt(5, 40);
+            constexpr uint64_t LowRequester = 1000000;
+
+            queue.Submit(grid, LowRequester, PathfinderTests::MakeRequest(
+                             grid, PathfinderTests::RandomWalkableCell(gen, grid),
+                             PathfinderTests::RandomWalkableCell(gen, grid), true, Navigation::PathSearchMode::Auto));
+            int servedAt = -1;
+            for (int tick = 0; tick < 4 * highPriority + 20 && servedAt < 0; ++tick)
+            {
+                for (int k = 0; k < 2; ++k)
+                {
+                    queue.Submit(grid, static_cast<uint64_t>(tick * 2 + k), PathfinderTests::MakeRequest(
+                                     grid, PathfinderTests::RandomWalkableCell(gen, grid),
+                                     PathfinderTests::RandomWalkableCell(gen, grid), true,
+                                     Navigation::PathSearchMode::Auto), highPriority);
+                }
+                queue.Update(grid);
+                queue.WaitForInFlight();
+                queue.Integrate(1e9, [&](uint64_t requester, const Navigation::PathResult&)
+                {
+                    if (requester == LowRequester) servedAt = tick;
+                });
+            }
+            // 每帧到达两个、完成一个，最老的高优先级请求约在第 t/2 帧提交，因此低优先级请求在约 2 * gap 帧内完成
+            if (servedAt < 0 || servedAt > 2 * highPriority + 4)
+            {
+                result.passed = false;
+                result.failedIteration = i;
+                result.failureMessage = "Low-priority request starved (served at tick " + std::to_string(servedAt) +
+                                        ", priority gap " + std::to_string(highPriority) + ")";
+                return result;
+            }
+        }
+
+        // 同时提交时按优先级从高到低完成
+        const Navigation::NavGrid grid = PathfinderTests::RandomObstacleGrid(gen, 32, 32, 0.1f);
+        Navigation::PathRequestQueue queue(0, 1);
+        for (uint64_t r = 0; r < 8; ++r)
+        {
+            queue.Submit(grid, r, PathfinderTests::MakeRequest(grid, PathfinderTests::RandomWalkableCell(gen, grid),
+                                                               PathfinderTests::RandomWalkableCell(gen, grid), true,
+                                                               Navigation::PathSearchMode::Auto),
+                         static_cast<int>(r) * 10);
+        }
+        std::vector<uint64_t> order;
+        for (int tick = 0; tick < 20; ++tick)
+        {
+            queue.Update(grid);
+            queue.WaitForInFlight();
+            queue.Integrate(1e9, [&](uint64_t requester, const Navigation::PathResult&) { order.push_back(requester); });
+        }
+        if (order != std::vector<uint64_t>{7, 6, 5, 4, 3, 2, 1, 0})
+        {
+            result.passed = false;
+            result.failureMessage = "Requests submitted together were not served in priority order";
+        }
+        return result;
+    }
+
+    /**
+     * Property: a zero integration budget still delivers exactly one result per call
+     */
+    inline TestResult TestProperty_IntegrationBudget()
+    {
+        TestResult result;
+        PathRandomGenerator gen(37u);
+        const Navigation::NavGrid grid = PathfinderTests::RandomObstacleGrid(gen, 32, 32, 0.1f);
+        Navigation::PathRequestQueue queue(0, 8);
+        for (uint64_t r = 0; r < 8; ++r)
+        {
+            queue.Submit(grid, r, PathfinderTests::MakeRequest(grid, PathfinderTests::RandomWalkableCell(gen, grid),
+                                                               PathfinderTests::RandomWalkableCell(gen, grid), true,
+                                                               Navigation::PathSearchMode::Auto));
+        }
+        queue.Update(grid);
+        queue.WaitForInFlight();
+        queue.Update(grid);
+        for (int call = 0; call < 8; ++call)
+        {
+            if (queue.Integrate(0.0, [](uint64_t, const Navigation::PathResult&) {}) != 1)
+            {
+                result.passed = false;
+                result.failedIteration = call;
+                result.failureMessage = "Zero budget did not deliver exactly one result";
+                return result;
+            }
+        }
+        return result;
+    }
+
+    /**
+     * @brief Compare the worst main-thread frame time when many agents repath at once
+     */
+    inline void RunPathRequestQueueBenchmark(int size = 512, int agents = 1000)
+    {
+        PathRandomGenerator gen(33u);
+        const Navigation::NavGrid grid = PathfinderTests::RandomObstacleGrid(gen, size, size, 0.2f);
+        std::vector<Navigation::PathRequest> requests;
+        for (int a = 0; a < agents; ++a)
+        {
+            requests.push_back(PathfinderTests::MakeRequest(grid, PathfinderTests::RandomWalkableCell(gen, grid),
+                                                            PathfinderTests::RandomWalkableCell(gen, grid), true,
+                                                            Navigation::PathSearchMode::Auto));
+        }
+        using Clock = std::chrono::high_resolution_clock;
+
+        auto start = Clock::now();
+        for (const auto& request : requests)
+            Navigation::Pathfinder::FindPath(grid, request);
+        const double syncMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+        Navigation::PathRequestQueue queue;
+        double worstFrameMs = 0.0;
+        int frames = 0;
+        size_t delivered = 0;
+        const auto burstStart = Clock::now();
+        start = Clock::now();
+        for (int a = 0; a < agents; ++a)
+            queue.Submit(grid, static_cast<uint64_t>(a), requests[a]);
+        while (delivered < requests.size())
+        {
+            queue.Update(grid);
+            delivered += queue.Integrate(1.0, [](uint64_t, const Navigation::PathResult&) {});
+            worstFrameMs = std::max(worstFrameMs,
+                                    std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+            ++frames;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            start = Clock::now();
+        }
+        const double totalMs = std::chrono::duration<double, std::milli>(Clock::now() - burstStart).count();
+
+        LogInfo("{} simultaneous repaths on {}x{}: synchronous frame {:.1f} ms; queued worst main-thread frame "
+                "{:.2f} ms, all delivered after {} frames ({:.0f} ms wall)",
+                agents, size, size, syncMs, worstFrameMs, frames, totalMs);
+    }
+
+    /**
+     * @brief Run all path request queue tests
+     *
+     * @return true if all tests pass, false otherwise
+     */
+    inline bool RunAllPathRequestQueueTests()
+    {
+        LogInfo("=== Running Path Request Queue Tests ===");
+
+        bool allPassed = true;
+        allPassed &= PathfinderTests::RunTest("Queued paths match synchronous search",
+                                              TestProperty_ResultsMatchSynchronous());
+        allPassed &= PathfinderTests::RunTest("Cancelled and superseded requests are never delivered",
+                                              TestProperty_Cancellation());
+        allPassed &= PathfinderTests::RunTest("Stale results after grid edits are re-solved",
+                                              TestProperty_StaleResultsAfterGridChange());
+        allPassed &= PathfinderTests::RunTest("Priority aging keeps the queue fair", TestProperty_Fairness());
+        allPassed &= PathfinderTests::RunTest("Integration budget always makes progress",
+                                              TestProperty_IntegrationBudget());
+
+        LogInfo("=== Path Request Queue Tests Complete ===");
+        return allPassed;
+    }
+}
+
+#endif // PATH_REQUEST_QUEUE_TESTS_H
@@ -0,0 +1,286 @@
+#ifndef PATH_SMOOTHER_TESTS_H
+#define PATH_SMOOTHER_TESTS_H
+
+/**
+ * @file PathSmootherTests.h
+ * @brief Property-based tests and benchmark for line-of-sight path simplification and corner rounding
+ *
+ * Feature: path-smoothing
+ */
+
+#include "PathfinderTests.h"
+#include "../Navigation/PathSmoother.h"
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <sstream>
+#include <vector>
+
+namespace PathSmootherTests
+{
+    using PathfinderTests::PathRandomGenerator;
+    using PathfinderTests::TestResult;
+
+    /**
+     * @brief Densely sample the segment and report whether any sample falls inside an unwalkable cell
+     */
+    inline bool SegmentTouchesBlocked(const Navigation::NavGrid& grid, ECS::Vector2f from, ECS::Vector2f to)
+    {
+        const float length = std::sqrt((to.x - from.x) * (to.x - from.x) + (to.y - from.y) * (to.y - from.y));
+        const int samples = static_cast<int>(length / grid.cellSize * 64.0f) + 2;
+        for (int i = 0; i <= samples; ++i)
+        {
+            const float t = static_cast<float>(i) / static_cast<float>(samples);
+            const float x = (from.x + (to.x - from.x) * t - grid.origin.x) / grid.cellSize;
+            const float y = (from.y + (to.y - from.y) * t - grid.origin.y) / grid.cellSize;
+            if (!grid.IsWalkable(static_cast<int>(std::floor(x)), static_cast<int>(std::floor(y)))) return true;
+        }
+        return false;
+    }
+
+    /**
+     * @brief Cell-by-cell supercover Bresenham; the word-level HasLineOfSight must visit exactly the same cells
+     */
+    inline bool ReferenceLineOfSight(const Navigation::NavGrid& grid, int x0, int y0, int x1, int y1)
+    {
+        if (!grid.IsWalkable(x0, y0)) return false;
+        const int64_t nx = std::abs(x1 - x0);
+        const int64_t ny = std::abs(y1 - y0);
+        const int sx = (x1 > x0) - (x1 < x0);
+        const int sy = (y1 > y0) - (y1 < y0);
+        int x = x0;
+        int y = y0;
+        for (int64_t ix = 0, iy = 0; ix < nx || iy < ny;)
+        {
+            const int64_t decision = (1 + 2 * ix) * ny - (1 + 2 * iy) * nx;
+            if (decision == 0)
+            {
+                if (!grid.IsWalkable(x + sx, y) || !grid.IsWalkable(x, y + sy)) return false;
+                x += sx;
+                y += sy;
+                ++ix;
+                ++iy;
+            }
+            else if (decision < 0)
+            {
+                x += sx;
+                ++ix;
+            }
+            else
+            {
+                y += sy;
+                ++iy;
+            }
+            if (!grid.IsWalkable(x, y)) return false;
+        }
+        return true;
+    }
+
+    inline float PolylineLength(const std::vector<ECS::Vector2f>& points)
+    {
+        float length = 0.0f;
+        for (size_t i = 1; i < points.size(); ++i)
+        {
+            const float dx = points[i].x - points[i - 1].x;
+            const float dy = points[i].y - points[i - 1].y;
+            length += std::sqrt(dx * dx + dy * dy);
+        }
+        return length;
+    }
+
+    inline Navigation::NavGrid SmootherTestGrid(PathRandomGenerator& gen, int i)
+    {
+        const int width = gen.RandomInt(2, 160);
+        const int height = gen.RandomInt(2, 64);
+        return (i % 4 == 3) ? PathfinderTests::MazeGrid(gen, width | 1, height | 1)
+                            : PathfinderTests::RandomObstacleGrid(gen, width, height, gen.RandomFloat(0.0f, 0.4f));
+    }
+
+    /**
+     * Property: line of sight is symmetric, matches the per-cell supercover walk, never passes through an
+     * unwalkable cell, and IsSegmentClear agrees with it for cell centres
+     */
+    inline TestResult TestProperty_LineOfSightIsConservative(int iterations = 200)
+    {
+        TestResult result;
+        PathRandomGenerator gen(35u);
+        for (int i = 0; i < iterations; ++i)
+        {
+            const Navigation::NavGrid grid = SmootherTestGrid(gen, i);
+            for (int q = 0; q < 50; ++q)
+            {
+                const auto a = PathfinderTests::RandomWalkableCell(gen, grid);
+                const auto b = PathfinderTests::RandomWalkableCell(gen, grid);
+                const bool visible = Navigation::PathSmoother::HasLineOfSight(grid, a.first, a.second, b.first, b.second);
+                const bool reverse = Navigation::PathSmoother::HasLineOfSight(grid, b.first, b.second, a.first, a.second);
+                const auto from = grid.GridToWorld(a.first, a.second);
+                const auto to = grid.GridToWorld(b.first, b.second);
+                const bool clear = Navigation::PathSmoother::IsSegmentClear(grid, from, to);
+                const bool reference = ReferenceLineOfSight(grid, a.first, a.second, b.first, b.second);
+
+                std::ostringstream oss;
+                if (visible != reverse)
+                    oss << "Line of sight is not symmetric";
+                else if (visible != reference)
+                    oss << "Word-level line of sight disagrees with the per-cell supercover walk";
+                else if (visible != clear)
+                    oss << "IsSegmentClear disagrees with HasLineOfSight";
+                else if (visible && SegmentTouchesBlocked(grid, from, to))
+                    oss << "Line of sight passes through an unwalkable cell";
+                if (!oss.str().empty())
+                {
+                    oss << " between (" << a.first << ", " << a.second << ") and (" << b.first << ", " << b.second << ")";
+                    result.passed = false;
+                    result.failedIteration = i;
+                    result.failureMessage = oss.str();
+                    return result;
+                }
+            }
+
+            // 任意端点的线段走 DDA 分支
+            for (int q = 0; q < 50; ++q)
+            {
+                const ECS::Vector2f from(gen.RandomFloat(0.0f, static_cast<float>(grid.width)),
+                                         gen.RandomFloat(0.0f, static_cast<float>(grid.height)));
+                const ECS::Vector2f to(gen.RandomFloat(0.0f, static_cast<float>(grid.width)),
+                                       gen.RandomFloat(0.0f, static_cast<float>(grid.height)));
+                if (Navigation::PathSmoother::IsSegmentClear(grid, from, to) && SegmentTouchesBlocked(grid, from, to))
+                {
+                    std::ostringstream oss;
+                    oss << "Segment (" << from.x << ", " << from.y << ") -> (" << to.x << ", " << to.y
+                        << ") reported clear but passes through an unwalkable cell";
+                    result.passed = false;
+                    result.failedIteration = i;
+                    result.failureMessage = oss.str();
+                    return result;
+                }
+            }
+        }
+        return result;
+    }
+
+    /**
+     * Property: simplified and corner-rounded paths keep both endpoints, never cross unwalkable cells, are no
+     * longer than the raw path, and leave waypoints before the anchor untouched
+     */
+    inline TestResult TestProperty_SmoothedPathsStayWalkable(int iterations = 300)
+    {
+        TestResult result;
+        PathRandomGenerator gen(36u);
+        for (int i = 0; i < iterations; ++i)
+        {
+            const Navigation::NavGrid grid = SmootherTestGrid(gen, i);
+            const auto start = PathfinderTests::RandomWalkableCell(gen, grid);
+            const auto end = PathfinderTests::RandomWalkableCell(gen, grid);
+            const bool diagonal = gen.RandomInt(0, 3) != 0;
+            auto request = PathfinderTests::MakeRequest(grid, start, end, diagonal, Navigation::PathSearchMode::Auto);
+            auto path = Navigation::Pathfinder::FindPath(grid, request);
+            if (!path.found) continue;
+
+            std::vector<ECS::Vector2f> raw{request.start};
+            raw.insert(raw.end(), path.waypoints.begin(), path.waypoints.end());
+            const size_t from = gen.RandomInt(0, 3) == 0 ? static_cast<size_t>(gen.RandomInt(0, static_cast<int>(raw.size()) - 1)) : 0;
+            const float radius = gen.RandomInt(0, 1) == 0 ? 0.0f : gen.RandomFloat(0.1f, 4.0f);
+
+            std::vector<ECS::Vector2f> smoothed = raw;
+            Navigation::PathSmoother::Simplify(grid, smoothed, from);
+            const size_t simplifiedCount = smoothed.size();
+            Navigation::PathSmoother::RoundCorners(grid, smoothed, radius, from);
+
+            std::ostringstream oss;
+            bool prefixKept = smoothed.size() > from;
+            for (size_t k = 0; prefixKept && k <= from; ++k)
+                prefixKept = smoothed[k] == raw[k];
+            if (!prefixKept || smoothed.back() != raw.back())
+                oss << "Anchor prefix or end point changed";
+            else if (simplifiedCount > raw.size())
+                oss << "Simplification added waypoints";
+            else if (PolylineLength(smoothed) > PolylineLength(raw) + 1e-3f)
+                oss << "Smoothed path is longer than the raw path";
+            for (size_t k = 1; oss.str().empty() && k < smoothed.size(); ++k)
+            {
+                if (SegmentTouchesBlocked(grid, smoothed[k - 1], smoothed[k]))
+                    oss << "Segment " << k << " crosses an unwalkable cell";
+            }
+            if (!oss.str().empty())
+            {
+                oss << " (radius " << radius << ", anchor " << from << ")";
+                result.passed = false;
+                result.failedIteration = i;
+                result.failureMessage = oss.str();
+                return result;
+            }
+        }
+        return result;
+    }
+
+    /**
+     * @brief Benchmark: waypoint count and time for raw, simplified and corner-rounded paths
+     */
+    inline void RunPathSmootherBenchmark(int size = 512, int queries = 500, float density = 0.2f)
+    {
+        using Clock = std::chrono::steady_clock;
+        PathRandomGenerator gen(37u);
+        const Navigation::NavGrid grid = PathfinderTests::RandomObstacleGrid(gen, size, size, density);
+
+        size_t rawPoints = 0;
+        size_t simplifiedPoints = 0;
+        size_t roundedPoints = 0;
+        double searchMs = 0.0;
+        double simplifyMs = 0.0;
+        double roundMs = 0.0;
+        int found = 0;
+        for (int q = 0; q < queries; ++q)
+        {
+            const auto start = PathfinderTests::RandomWalkableCell(gen, grid);
+            const auto end = PathfinderTests::RandomWalkableCell(gen, grid);
+            const auto request = PathfinderTests::MakeRequest(grid, start, end, true, Navigation::PathSearchMode::Auto);
+
+            auto t0 = Clock::now();
+            auto path = Navigation::Pathfinder::FindPath(grid, request);
+            searchMs += std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+            if (!path.found) continue;
+            ++found;
+            rawPoints += path.waypoints.size();
+
+            t0 = Clock::now();
+            Navigation::PathSmoother::Simplify(grid, path.waypoints);
+            simplifyMs += std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+            simplifiedPoints += path.waypoints.size();
+
+            t0 = Clock::now();
+            Navigation::PathSmoother::RoundCorners(grid, path.waypoints, grid.cellSize * 0.5f);
+            roundMs += std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+            roundedPoints += path.waypoints.size();
+        }
+
+        const double n = std::max(found, 1);
+        LogInfo("{} paths on {}x{} ({:.0f}% blocked): {:.1f} raw waypoints -> {:.1f} simplified ({:.1f}x fewer), "
+                "{:.1f} after corner rounding; search {:.3f} ms, simplify {:.3f} ms, rounding {:.3f} ms per path",
+                found, size, size, density * 100.0f, rawPoints / n, simplifiedPoints / n,
+                static_cast<double>(rawPoints) / std::max<size_t>(simplifiedPoints, 1), roundedPoints / n,
+                searchMs / n, simplifyMs / n, roundMs / n);
+    }
+
+    /**
+     * @brief Run all path smoother tests
+     *
+     * @return true if all tests pass, false otherwise
+     */
+    inline bool RunAllPathSmootherTests()
+    {
+        LogInfo("=== Running Path Smoother Tests ===");
+
+        bool allPassed = true;
+        allPassed &= PathfinderTests::RunTest("Line of sight is conservative",
+                                              TestProperty_LineOfSightIsConservative());
+        allPassed &= PathfinderTests::RunTest("Smoothed paths stay walkable",
+                                              TestProperty_SmoothedPathsStayWalkable());
+
+        LogInfo("=== Path Smoother Tests Complete ===");
+        return allPassed;
+    }
+}
+
+#endif // PATH_SMOOTHER_TESTS_H
@@ -0,0 +1,424 @@
+#ifndef PATHFINDER_TESTS_H
+#define PATHFINDER_TESTS_H
+
+/**
+ * @file PathfinderTests.h
+ * @brief Property-based tests and benchmarks for the dense-array A* and Jump Point Search
+ *
+ * The reference implementation below is the original map-based A* kept verbatim in
+ * behaviour, so every optimised search can be checked against it for path cost.
+ *
+ * Feature: dense-grid-pathfinding
+ */
+
+#include "../Navigation/Pathfinder.h"
+#include "../../Utils/Logger.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <queue>
+#include <random>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace PathfinderTests
+{
+    /**
+     * @brief Random generator for pathfinder tests
+     */
+    class PathRandomGenerator
+    {
+    public:
+        explicit PathRandomGenerator(unsigned int seed) : m_gen(seed) {}
+
+        float RandomFloat(float min, float max)
+        {
+            std::uniform_real_distribution<float> dist(min, max);
+            return dist(m_gen);
+        }
+
+        int RandomInt(int min, int max)
+        {
+            std::uniform_int_distribution<int> dist(min, max);
+            return dist(m_gen);
+        }
+
+        std::mt19937& Engine() { return m_gen; }
+
+    private:
+        std::mt19937 m_gen;
+    };
+
+    /**
+     * @brief Test result structure for detailed failure reporting
+     */
+    struct TestResult
+    {
+        bool passed = true;
+        std::string failureMessage;
+        int failedIteration = -1;
+    };
+
+    /**
+     * @brief The original priority_queue + unordered_map A*, returning the path cost in cells (weighted by the
+     * grid's cost layer when it has one)
+     */
+    inline bool ReferenceFindPath(const Navigation::NavGrid& grid, int sx, int sy, int ex, int ey,
+                                  bool allowDiagonal, float& cost)
+    {
+        struct Node
+        {
+            int x, y;
+            float g, f;
+        };
+        struct NodeCmp
+        {
+            bool operator()(const Node& a, const Node& b) const { return a.f > b.f; }
+        };
+        static constexpr int DX8[] = {-1, 0, 1, 0, -1, -1, 1, 1};
+        static constexpr int DY8[] = {0, -1, 0, 1, -1, 1, -1, 1};
+        static constexpr float SQRT2 = 1.41421356f;
+        auto packKey = [](int x, int y) { return y * 0x10000 + x; };
+        auto heuristic = [](int ax, int ay, int bx, int by)
+        {
+            const float dx = static_cast<float>(ax - bx);
+            const float dy = static_cast<float>(ay - by);
+            return std::sqrt(dx * dx + dy * dy);
+        };
+
+        cost = 0.0f;
+        if (!grid.IsWalkable(sx, sy) || !grid.IsWalkable(ex, ey)) return false;
+        if (sx == ex && sy == ey) return true;
+
+        const int dirCount = allowDiagonal ? 8 : 4;
+        std::priority_queue<Node, std::vector<Node>, NodeCmp> open;
+        std::unordered_map<int, float> gScore;
+        const int endKey = packKey(ex, ey);
+        gScore[packKey(sx, sy)] = 0.0f;
+        open.push({sx, sy, 0.0f, heuristic(sx, sy, ex, ey)});
+        while (!open.empty())
+        {
+            Node cur = open.top();
+            open.pop();
+            const int curKey = packKey(cur.x, cur.y);
+            if (curKey == endKey)
+            {
+                cost = cur.g;
+                return true;
+            }
+            if (cur.g > gScore[curKey]) continue;
+            for (int d = 0; d < dirCount; ++d)
+            {
+                const int nx = cur.x + DX8[d];
+                const int ny = cur.y + DY8[d];
+                if (!grid.IsWalkable(nx, ny)) continue;
+                if (d >= 4 && (!grid.IsWalkable(cur.x + DX8[d], cur.y) || !grid.IsWalkable(cur.x, cur.y + DY8[d])))
+                    continue;
+                const float ng = cur.g + ((d >= 4) ? SQRT2 : 1.0f) * grid.GetCost(nx, ny);
+                const int nKey = packKey(nx, ny);
+                auto it = gScore.find(nKey);
+                if (it == gScore.end() || ng < it->second)
+                {
+                    gScore[nKey] = ng;
+                    open.push({nx, ny, ng, ng + heuristic(nx, ny, ex, ey)});
+                }
+            }
+        }
+        return false;
+    }
+
+    inline Navigation::NavGrid RandomObstacleGrid(PathRandomGenerator& gen, int width, int height, float density)
+    {
+        Navigation::NavGrid grid(width, height, 1.0f);
+        for (int y = 0; y < height; ++y)
+        {
+            for (int x = 0; x < width; ++x)
+            {
+                if (gen.RandomFloat(0.0f, 1.0f) < density) grid.SetWalkable(x, y, false);
+            }
+        }
+        return grid;
+    }
+
+    /**
+     * @brief Perfect maze from an iterative recursive backtracker; corridors are one cell wide
+     */
+    inline Navigation::NavGrid MazeGrid(PathRandomGenerator& gen, int width, int height)
+    {
+        Navigation::NavGrid grid(width, height, 1.0f);
+        grid.Fill(false);
+        const int cellsX = (width - 1) / 2;
+        const int cellsY = (height - 1) / 2;
+        std::vector<uint8_t> visited(static_cast<size_t>(cellsX * cellsY), 0);
+        std::vector<std::pair<int, int>> stack{{0, 0}};
+        visited[0] = 1;
+        grid.SetWalkable(1, 1, true);
+        static constexpr int DX[] = {1, -1, 0, 0};
+        static constexpr int DY[] = {0, 0, 1, -1};
+        while (!stack.empty())
+        {
+            auto [cx, cy] = stack.back();
+            int options[4];
+            int optionCount = 0;
+            for (int d = 0; d < 4; ++d)
+            {
+                const int nx = cx + DX[d];
+                const int ny = cy + DY[d];
+                if (nx >= 0 && nx < cellsX && ny >= 0 && ny < cellsY && !visited[ny * cellsX + nx])
+                    options[optionCount++] = d;
+            }
+            if (optionCount == 0)
+            {
+                stack.pop_back();
+                continue;
+            }
+            const int d = options[gen.RandomInt(0, optionCount - 1)];
+            const int nx = cx + DX[d];
+            const int ny = cy + DY[d];
+            visited[ny * cellsX + nx] = 1;
+            grid.SetWalkable(2 * cx + 1 + DX[d], 2 * cy + 1 + DY[d], true);
+            grid.SetWalkable(2 * nx + 1, 2 * ny + 1, true);
+            stack.push_back({nx, ny});
+        }
+        return grid;
+    }
+
+    inline std::pair<int, int> RandomWalkableCell(PathRandomGenerator& gen, const Navigation::NavGrid& grid)
+    {
+        for (int attempt = 0; attempt < 1000; ++attempt)
+        {
+            const int x = gen.RandomInt(0, grid.width - 1);
+            const int y = gen.RandomInt(0, grid.height - 1);
+            if (grid.IsWalkable(x, y)) return {x, y};
+        }
+        return {0, 0};
+    }
+
+    inline Navigation::PathRequest MakeRequest(const Navigation::NavGrid& grid, std::pair<int, int> start,
+                                               std::pair<int, int> end, bool diagonal,
+                                               Navigation::PathSearchMode mode)
+    {
+        Navigation::PathRequest request;
+        request.start = grid.GridToWorld(start.first, start.second);
+        request.end = grid.GridToWorld(end.first, end.second);
+        request.allowDiagonal = diagonal;
+        request.mode = mode;
+        return request;
+    }
+
+    /**
+     * @brief Check that waypoints form a connected, walkable path that never cuts corners; the returned cost is
+     * weighted by the cost layer
+     *
+     * @return Path cost in cells, or a negative value when the path is invalid
+     */
+    inline float ValidatePath(const Navigation::NavGrid& grid, std::pair<int, int> start,
+                              const Navigation::PathResult& result, bool diagonal)
+    {
+        auto [px, py] = start;
+        float cost = 0.0f;
+        if (result.waypoints.size() == 1 && grid.WorldToGrid(result.waypoints.front()) == start)
+            return cost;
+        for (const auto& waypoint : result.waypoints)
+        {
+            auto [x, y] = grid.WorldToGrid(waypoint);
+            const int dx = x - px;
+            const int dy = y - py;
+            if (!grid.IsWalkable(x, y) || std::abs(dx) > 1 || std::abs(dy) > 1 || (dx == 0 && dy == 0))
+                return -1.0f;
+            if (dx != 0 && dy != 0)
+            {
+                if (!diagonal || !grid.IsWalkable(px + dx, py) || !grid.IsWalkable(px, py + dy)) return -1.0f;
+                cost += 1.41421356f * grid.GetCost(x, y);
+            }
+            else
+            {
+                cost += grid.GetCost(x, y);
+            }
+            px = x;
+            py = y;
+        }
+        return cost;
+    }
+
+    /**
+     * Property: dense A* and JPS find a path exactly when the reference does, with the same cost; every seventh
+     * grid carries a random cost layer
+     */
+    inline TestResult TestProperty_CostMatchesReference(int iterations = 300)
+    {
+        TestResult result;
+        PathRandomGenerator gen(30u);
+        Navigation::SearchContext context;
+        for (int i = 0; i < iterations; ++i)
+        {
+            const int width = gen.RandomInt(2, 64);
+            const int height = gen.RandomInt(2, 64);
+            Navigation::NavGrid grid = (i % 5 == 4)
+                                           ? MazeGrid(gen, width | 1, height | 1)
+                                           : RandomObstacleGrid(gen, width, height, gen.RandomFloat(0.0f, 0.45f));
+            if (i % 7 == 6)
+            {
+                for (int c = gen.RandomInt(1, width * height); c > 0; --c)
+                {
+                    grid.SetCost(gen.RandomInt(0, grid.width - 1), gen.RandomInt(0, grid.height - 1),
+                                 static_cast<uint8_t>(gen.RandomInt(1, 8)));
+                }
+            }
+            const auto start = RandomWalkableCell(gen, grid);
+            const auto end = RandomWalkableCell(gen, grid);
+            const bool diagonal = gen.RandomInt(0, 3) != 0;
+
+            float referenceCost = 0.0f;
+            const bool referenceFound =
+                ReferenceFindPath(grid, start.first, start.second, end.first, end.second, diagonal, referenceCost);
+
+            for (auto mode : {Navigation::PathSearchMode::AStar, Navigation::PathSearchMode::JumpPoint})
+            {
+                const auto path = Navigation::Pathfinder::FindPath(grid, MakeRequest(grid, start, end, diagonal, mode),
+                                                                   context);
+                const char* name = mode == Navigation::PathSearchMode::AStar ? "A*" : "JPS";
+                if (path.found != referenceFound)
+                {
+                    result.passed = false;
+                    result.failedIteration = i;
+                    result.failureMessage = std::string(name) + " disagrees with the reference on reachability";
+                    return result;
+                }
+                if (!path.found) continue;
+                const float walked = ValidatePath(grid, start, path, diagonal);
+                const float tolerance = 1e-3f * std::max(1.0f, referenceCost);
+                if (walked < 0.0f || std::abs(walked - referenceCost) > tolerance ||
+                    std::abs(path.cost - referenceCost) > tolerance)
+                {
+                    std::ostringstream oss;
+                    oss << name << " path cost " << path.cost << " (walked " << walked << ") vs reference "
+                        << referenceCost << " on " << width << "x" << height << " grid";
+                    result.passed = false;
+                    result.failedIteration = i;
+                    result.failureMessage = oss.str();
+                    return result;
+                }
+            }
+        }
+        return result;
+    }
+
+    /**
+     * Property: reusing one context across grids of different sizes gives the same result as a fresh one
+     */
+    inline TestResult TestProperty_ContextReuse(int iterations = 100)
+    {
+        TestResult result;
+        PathRandomGenerator gen(31u);
+        Navigation::SearchContext shared;
+        for (int i = 0; i < iterations; ++i)
+        {
+            const int size = gen.RandomInt(4, 96);
+            const Navigation::NavGrid grid = RandomObstacleGrid(gen, size, gen.RandomInt(4, 96), 0.3f);
+            const auto start = RandomWalkableCell(gen, grid);
+            const auto end = RandomWalkableCell(gen, grid);
+            const auto request = MakeRequest(grid, start, end, true, Navigation::PathSearchMode::AStar);
+
+            Navigation::SearchContext fresh;
+            const auto expected = Navigation::Pathfinder::FindPath(grid, request, fresh);
+            const auto actual = Navigation::Pathfinder::FindPath(grid, request, shared);
+            if (expected.found != actual.found || expected.waypoints != actual.waypoints ||
+                expected.cost != actual.cost)
+            {
+                result.passed = false;
+                result.failedIteration = i;
+                result.failureMessage = "Reused search context produced a different path";
+                return result;
+            }
+        }
+        return result;
+    }
+
+    /**
+     * @brief Time random queries on 1024x1024 maze and open-field grids
+     */
+    inline void RunPathfinderBenchmark(int size = 1024, int queries = 50)
+    {
+        PathRandomGenerator gen(1024u);
+        struct Scenario
+        {
+            const char* name;
+            Navigation::NavGrid grid;
+        };
+        Scenario scenarios[] = {
+            {"maze", MazeGrid(gen, size - 1, size - 1)},
+            {"open field", RandomObstacleGrid(gen, size, size, 0.1f)},
+        };
+        using Clock = std::chrono::high_resolution_clock;
+        for (auto& scenario : scenarios)
+        {
+            std::vector<std::pair<std::pair<int, int>, std::pair<int, int>>> pairs;
+            for (int q = 0; q < queries; ++q)
+            {
+                pairs.push_back({RandomWalkableCell(gen, scenario.grid), RandomWalkableCell(gen, scenario.grid)});
+            }
+
+            auto start = Clock::now();
+            for (auto& [from, to] : pairs)
+            {
+                float cost;
+                ReferenceFindPath(scenario.grid, from.first, from.second, to.first, to.second, true, cost);
+            }
+            const double referenceMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+            double modeMs[2] = {0.0, 0.0};
+            long long expanded[2] = {0, 0};
+            const Navigation::PathSearchMode modes[2] = {Navigation::PathSearchMode::AStar,
+                                                         Navigation::PathSearchMode::JumpPoint};
+            for (int m = 0; m < 2; ++m)
+            {
+                start = Clock::now();
+                for (auto& [from, to] : pairs)
+                {
+                    const auto path = Navigation::Pathfinder::FindPath(
+                        scenario.grid, MakeRequest(scenario.grid, from, to, true, modes[m]));
+                    expanded[m] += path.expandedNodes;
+                }
+                modeMs[m] = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+            }
+
+            LogInfo("Pathfinding {} {}x{}, {} queries: reference {:.1f} ms, dense A* {:.1f} ms ({} expanded), "
+                    "JPS {:.1f} ms ({} expanded)",
+                    scenario.name, scenario.grid.width, scenario.grid.height, queries, referenceMs,
+                    modeMs[0], expanded[0], modeMs[1], expanded[1]);
+        }
+    }
+
+    inline bool RunTest(const char* name, const TestResult& result)
+    {
+        if (result.passed)
+        {
+            LogInfo("{} PASSED", name);
+            return true;
+        }
+        LogError("{} FAILED at iteration {}: {}", name, result.failedIteration, result.failureMessage);
+        return false;
+    }
+
+    /**
+     * @brief Run all pathfinder tests
+     *
+     * @return true if all tests pass, false otherwise
+     */
+    inline bool RunAllPathfinderTests()
+    {
+        LogInfo("=== Running Pathfinder Tests ===");
+
+        bool allPassed = true;
+        allPassed &= RunTest("Path cost matches reference A*", TestProperty_CostMatchesReference());
+        allPassed &= RunTest("Search context reuse", TestProperty_ContextReuse());
+
+        LogInfo("=== Pathfinder Tests Complete ===");
+        return allPassed;
+    }
+}
+
+#endif // PATHFINDER_TESTS_H
@@ -0,0 +1,656 @@
+#ifndef PIXEL_CHUNK_STORE_TESTS_H
+#define PIXEL_CHUNK_STORE_TESTS_H
+
+/**
+ * @file PixelChunkStoreTests.h
+ * @brief Property-based tests and benchmark for compressed eviction of pixel chunks
+ *
+ * ChunkedPixelWorld evicts chunks beyond its residency radius. Modified chunks are run-length
+ * encoded over (type, color), block compressed and kept in a PixelChunkStore, whose memory tier
+ * spills least recently used chunks to region files once it exceeds its budget. Chunks that were
+ * never modified are only remembered and regenerated from the terrain seed when needed again.
+ *
+ * Feature: pixel-chunk-eviction
+ */
+
+#include "RegionStoreTests.h"
+#include "../PixelWorld/ChunkedPixelWorld.h"
+#include "../PixelWorld/PixelChunkCodec.h"
+#include "../PixelWorld/PixelChunkStore.h"
+#include "../Navigation/NavBakeSources.h"
+#include "../ProceduralGen/TerrainPipeline.h"
+#include "../../Utils/BlockCompressor.h"
+#include "../../Utils/Logger.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iterator>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace PixelChunkStoreTests
+{
+    using RegionStoreTests::ScratchDirectory;
+
+    class EvictionRandomGenerator
+    {
+    public:
+        explicit EvictionRandomGenerator(unsigned int seed) : m_gen(seed) {}
+
+        int RandomInt(int min, int max)
+        {
+            std::uniform_int_distribution<int> dist(min, max);
+            return dist(m_gen);
+        }
+
+        uint32_t RandomBits()
+        {
+            return static_cast<uint32_t>(m_gen());
+        }
+
+    private:
+        std::mt19937 m_gen;
+    };
+
+    /**
+     * @brief Test result structure for detailed failure reporting
+     */
+    struct TestResult
+    {
+        bool passed = true;
+        std::string failureMessage;
+        int failedIteration = -1;
+    };
+
+    inline bool RunTest(const char* name, const TestResult& result)
+    {
+        if (result.passed)
+        {
+            LogInfo("{} PASSED", name);
+            return true;
+        }
+        LogError("{} FAILED at iteration {}: {}", name, result.failedIteration, result.failureMessage);
+        return false;
+    }
+
+    inline GPUPixel MakePixel(PixelType::Value type)
+    {
+        return GPUPixel{static_cast<uint32_t>(type), DefaultPixelColor(type), 0.0f, 0.0f};
+    }
+
+    inline float BitsToFloat(uint32_t bits)
+    {
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    /**
+     * @brief Random pixels: uniform, strata with default colors, sparse motion state, tinted runs or
+     * pure noise (including NaN and negative-zero float bit patterns)
+     */
+    inline std::vector<GPUPixel> RandomPixels(EvictionRandomGenerator& gen, size_t count)
+    {
+        std::vector<GPUPixel> pixels(count, MakePixel(PixelType::Air));
+        const int style = gen.RandomInt(0, 4);
+        if (style == 0)
+        {
+            std::fill(pixels.begin(), pixels.end(), MakePixel(static_cast<PixelType::Value>(gen.RandomInt(0, 7))));
+            return pixels;
+        }
+        if (style == 4)
+        {
+            for (GPUPixel& p : pixels)
+                p = GPUPixel{gen.RandomBits(), gen.RandomBits(), BitsToFloat(gen.RandomBits()),
+                             BitsToFloat(gen.RandomBits())};
+            return pixels;
+        }
+
+        size_t i = 0;
+        while (i < count)
+        {
+            const size_t run = std::min<size_t>(count - i, static_cast<size_t>(gen.RandomInt(1, 400)));
+            GPUPixel pixel = MakePixel(static_cast<PixelType::Value>(gen.RandomInt(0, 7)));
+            if (style == 3 && gen.RandomInt(0, 2) == 0)
+                pixel.color = gen.RandomBits();
+            std::fill(pixels.begin() + static_cast<std::ptrdiff_t>(i),
+                      pixels.begin() + static_cast<std::ptrdiff_t>(i + run), pixel);
+            i += run;
+        }
+        if (style >= 2)
+        {
+            static const uint32_t specials[] = {0x80000000u, 0x7FC00000u, 0x3F800000u, 0xBF000000u, 0x00000001u};
+            const int moving = gen.RandomInt(0, 200);
+            for (int m = 0; m < moving; m++)
+            {
+                GPUPixel& p = pixels[static_cast<size_t>(gen.RandomInt(0, static_cast<int>(count) - 1))];
+                p.lifetime = BitsToFloat(specials[gen.RandomInt(0, 4)]);
+                p.velocity_y = gen.RandomInt(0, 1) ? BitsToFloat(gen.RandomBits()) : 0.0f;
+            }
+        }
+        return pixels;
+    }
+
+    /**
+     * Property: encoding then decoding reproduces every pixel bit for bit, and damaged data is rejected
+     *
+     * Covers both layers separately (runs alone, the block codec on arbitrary bytes) and together,
+     * including buffers that are not a whole chunk and float fields holding NaN or -0.0.
+     */
+    inline TestResult TestProperty_CodecRoundTripIsExact(int iterations = 200)
+    {
+        TestResult result;
+        constexpr size_t ChunkPixels = static_cast<size_t>(ChunkedPixelWorld::CHUNK_SIZE) * ChunkedPixelWorld::CHUNK_SIZE;
+
+        for (int i = 0; i < iterations; i++)
+        {
+            EvictionRandomGenerator gen(47000u + static_cast<unsigned int>(i));
+            const size_t count = i % 4 == 3 ? static_cast<size_t>(gen.RandomInt(1, 5000)) : ChunkPixels;
+            const std::vector<GPUPixel> pixels = RandomPixels(gen, count);
+            std::ostringstream oss;
+
+            const std::vector<uint8_t> encoded = PixelChunkCodec::Encode(pixels.data(), pixels.size());
+            std::vector<GPUPixel> decoded(count, MakePixel(PixelType::Lava));
+            if (!PixelChunkCodec::Decode(encoded.data(), encoded.size(), decoded.data(), decoded.size()))
+                oss << "failed to decode " << encoded.size() << " bytes";
+            else if (std::memcmp(decoded.data(), pixels.data(), sizeof(GPUPixel) * count) != 0)
+                oss << "decoded pixels differ from the input";
+            else if (PixelChunkCodec::Decode(encoded.data(), encoded.size() - 1, decoded.data(), decoded.size()))
+                oss << "truncated data decoded successfully";
+            else if (count > 1 &&
+                     PixelChunkCodec::Decode(encoded.data(), encoded.size(), decoded.data(), decoded.size() - 1))
+                oss << "data decoded into a smaller pixel count";
+
+            std::vector<uint8_t> runs;
+            PixelChunkCodec::EncodeRuns(pixels.data(), pixels.size(), runs);
+            std::fill(decoded.begin(), decoded.end(), MakePixel(PixelType::Lava));
+            if (oss.str().empty() && (!PixelChunkCodec::DecodeRuns(runs.data(), runs.size(), decoded.data(), count) ||
+                                      std::memcmp(decoded.data(), pixels.data(), sizeof(GPUPixel) * count) != 0))
+                oss << "run layer round trip failed";
+
+            // 块压缩单独验证：带重复片段的任意字节
+            std::vector<uint8_t> bytes;
+            const int pieces = gen.RandomInt(0, 40);
+            for (int p = 0; p < pieces; p++)
+            {
+                const int length = gen.RandomInt(1, 300);
+                if (!bytes.empty() && gen.RandomInt(0, 1))
+                {
+                    const size_t from = static_cast<size_t>(gen.RandomInt(0, static_cast<int>(bytes.size()) - 1));
+                    for (int k = 0; k < length; k++)
+                        bytes.push_back(bytes[from + static_cast<size_t>(k)]);
+                }
+                else
+                {
+                    const uint8_t fill = static_cast<uint8_t>(gen.RandomBits());
+                    for (int k = 0; k < length; k++)
+                        bytes.push_back(gen.RandomInt(0, 2) ? fill : static_cast<uint8_t>(gen.RandomBits()));
+                }
+            }
+            std::vector<uint8_t> block;
+            BlockCompressor::Compress(bytes.data(), bytes.size(), block);
+            std::vector<uint8_t> restored(bytes.size());
+            if (oss.str().empty() &&
+                (!BlockCompressor::Decompress(block.data(), block.size(), restored.data(), restored.size()) ||
+                 restored != bytes))
+                oss << "block codec round trip of " << bytes.size() << " bytes failed";
+
+            if (!oss.str().empty())
+            {
+                result.passed = false;
+                result.failureMessage = oss.str();
+                result.failedIteration = i;
+                return result;
+            }
+        }
+
+        return result;
+    }
+
+    /**
+     * Property: the memory tier never exceeds its budget and spilled chunks come back unchanged
+     *
+     * Random puts (including overwrites), takes and peeks against a reference map. After every
+     * operation the memory tier must be within budget and agree with the reference on which
+     * chunks exist; whatever a take or peek returns must be the latest version put. Some
+     * iterations switch the spill directory off at the end, which must pull everything back.
+     */
+    inline TestResult TestProperty_MemoryBudgetIsRespected(int iterations = 12)
+    {
+        TestResult result;
+
+        for (int i = 0; i < iterations; i++)
+        {
+            EvictionRandomGenerator gen(47100u + static_cast<unsigned int>(i));
+            ScratchDirectory directory("pixel_spill");
+            PixelChunkStore store;
+            const size_t budget = static_cast<size_t>(gen.RandomInt(0, 20000));
+            store.SetMemoryBudget(budget);
+            store.SetSpillDirectory(directory.Path());
+
+            std::map<std::pair<int, int>, std::vector<uint8_t>> reference;
+            std::ostringstream oss;
+            const int operations = 300;
+            for (int op = 0; op < operations && oss.str().empty(); op++)
+            {
+                const int cx = gen.RandomInt(-40, 40);
+                const int cy = gen.RandomInt(-6, 6);
+                const int action = gen.RandomInt(0, 9);
+                std::vector<uint8_t> data;
+                if (action < 6)
+                {
+                    data.resize(static_cast<size_t>(gen.RandomInt(1, 3000)));
+                    for (uint8_t& b : data)
+                        b = static_cast<uint8_t>(gen.RandomBits());
+                    reference[{cx, cy}] = data;
+                    store.Put(cx, cy, std::move(data));
+                }
+                else
+                {
+                    const auto it = reference.find({cx, cy});
+                    const bool found = action < 8 ? store.Take(cx, cy, data) : store.Peek(cx, cy, data);
+                    if (found != (it != reference.end()))
+                        oss << "op " << op << ": chunk (" << cx << ", " << cy << ") found " << found;
+                    else if (found && data != it->second)
+                        oss << "op " << op << ": chunk (" << cx << ", " << cy << ") came back different";
+                    else if (found && action < 8)
+                        reference.erase(it);
+                }
+
+                const PixelChunkStore::Stats stats = store.GetStats();
+                if (oss.str().empty() && stats.memoryBytes > budget)
+                    oss << "op " << op << ": " << stats.memoryBytes << " bytes in memory, budget " << budget;
+                if (oss.str().empty() && stats.memoryChunks + stats.diskChunks != reference.size())
+                    oss << "op " << op << ": store holds " << stats.memoryChunks + stats.diskChunks
+                        << " chunks, expected " << reference.size();
+                if (oss.str().empty() && store.Contains(cx, cy) != (reference.count({cx, cy}) > 0))
+                    oss << "op " << op << ": Contains disagrees for (" << cx << ", " << cy << ")";
+            }
+
+            if (oss.str().empty() && i % 2 == 1)
+            {
+                store.SetSpillDirectory({});
+                if (store.GetStats().diskChunks != 0 || store.GetStats().memoryChunks != reference.size())
+                    oss << "disabling the spill directory left " << store.GetStats().diskChunks << " chunks on disk";
+            }
+            for (const auto& [coord, expected] : reference)
+            {
+                if (!oss.str().empty()) break;
+                std::vector<uint8_t> data;
+                if (!store.Take(coord.first, coord.second, data) || data != expected)
+                    oss << "final take of (" << coord.first << ", " << coord.second << ") failed";
+            }
+            if (oss.str().empty() && i % 2 == 0 && budget < 3000 && store.GetStats().diskLoads == 0)
+                oss << "a tight budget never reloaded from disk";
+
+            if (!oss.str().empty())
+            {
+                result.passed = false;
+                result.failureMessage = oss.str();
+                result.failedIteration = i;
+                return result;
+            }
+        }
+
+        return result;
+    }
+
+    /**
+     * Property: evicting chunks is invisible to the world's contents
+     *
+     * Two worlds receive the same view walk, edits and simulation steps. One has a residency
+     * radius covering the whole walk and never evicts; the other keeps only the window plus a
+     * small margin, with a tight memory budget and a spill directory in half the iterations.
+     * After every segment both are flushed and every pixel of every visited chunk must match.
+     * Resident chunks stay bounded, and without edits or steps nothing is stored at all because
+     * untouched chunks are regenerated instead.
+     */
+    inline TestResult TestProperty_EvictionPreservesWorld(int iterations = 4)
+    {
+        TestResult result;
+        constexpr int C = ChunkedPixelWorld::CHUNK_SIZE;
+        constexpr float Dt = 1.0f / 60.0f;
+        auto centre = [](int c) { return static_cast<float>(c * C + C / 2); };
+
+        for (int i = 0; i < iterations; i++)
+        {
+            EvictionRandomGenerator gen(47200u + static_cast<unsigned int>(i));
+            ScratchDirectory directory("pixel_evict");
+            std::shared_ptr<TerrainPipeline> terrain;
+            if (i % 2 == 0)
+            {
+                TerrainProfile profile;
+                profile.seed = gen.RandomInt(0, 100000);
+                profile.surfaceBaseY = 3 * C;
+                terrain = std::make_shared<TerrainPipeline>(profile, C);
+            }
+
+            ChunkedPixelWorld evicting;
+            ChunkedPixelWorld keeping;
+            for (ChunkedPixelWorld* world : {&evicting, &keeping})
+            {
+                world->SetTerrainPipeline(terrain);
+                world->Initialize(nullptr);
+            }
+            const int residency = gen.RandomInt(3, 4);
+            evicting.SetResidencyRadius(residency);
+            keeping.SetResidencyRadius(1000);
+            if (i / 2 % 2 == 0)
+            {
+                evicting.GetChunkStore().SetMemoryBudget(8192);
+                evicting.GetChunkStore().SetSpillDirectory(directory.Path());
+            }
+
+            int minCX = 0, maxCX = 0, minCY = 0, maxCY = 0;
+            int cx = 0, cy = 3;
+            std::ostringstream oss;
+            const int segments = 10;
+            for (int segment = 0; segment < segments && oss.str().empty(); segment++)
+            {
+                // 前两段只移动视野，不编辑也不模拟
+                const bool quiet = segment < 2;
+                cx += gen.RandomInt(-6, 6);
+                cy = std::clamp(cy + gen.RandomInt(-3, 3), -2, 8);
+                for (ChunkedPixelWorld* world : {&evicting, &keeping})
+                    world->SetViewCenter(centre(cx), centre(cy), 1.0f);
+                minCX = std::min(minCX, cx - 3);
+                maxCX = std::max(maxCX, cx + 3);
+                minCY = std::min(minCY, cy - 3);
+                maxCY = std::max(maxCY, cy + 3);
+
+                if (!quiet)
+                {
+                    PixelEditBuffer edits;
+                    const int shapes = gen.RandomInt(1, 4);
+                    static const PixelType::Value materials[] = {PixelType::Air, PixelType::Sand, PixelType::Water,
+                                                                 PixelType::Stone, PixelType::Oil};
+                    // 编辑留在窗口内，不会在驻留半径外创建区块
+                    for (int s = 0; s < shapes; s++)
+                    {
+                        const int r = gen.RandomInt(4, 60);
+                        edits.FillCircle(gen.RandomInt((cx - 3) * C + r, (cx + 4) * C - 1 - r),
+                                         gen.RandomInt((cy - 3) * C + r, (cy + 4) * C - 1 - r), r,
+                                         materials[gen.RandomInt(0, 4)]);
+                    }
+                    evicting.ApplyEdits(edits);
+                    keeping.ApplyEdits(edits);
+                    const int frames = gen.RandomInt(1, 3);
+                    for (int f = 0; f < frames; f++)
+                    {
+                        evicting.Step(Dt);
+                        keeping.Step(Dt);
+                    }
+                }
+                evicting.FlushActiveChunks();
+                keeping.FlushActiveChunks();
+
+                const PixelChunkStore::Stats stats = evicting.GetChunkStore().GetStats();
+                const size_t maxResident = static_cast<size_t>((2 * residency + 1) * (2 * residency + 1));
+                if (evicting.GetResidentChunkCount() > maxResident)
+                    oss << "segment " << segment << ": " << evicting.GetResidentChunkCount()
+                        << " resident chunks, limit " << maxResident;
+                else if (quiet && stats.memoryChunks + stats.diskChunks != 0)
+                    oss << "segment " << segment << ": untouched chunks were stored instead of regenerated";
+                else if (stats.memoryBytes > evicting.GetChunkStore().GetMemoryBudget() && i / 2 % 2 == 0)
+                    oss << "segment " << segment << ": store exceeds its memory budget";
+
+                // 逐区块比较，非驻留区块每个只解码一次
+                auto chunkTypes = [&](const ChunkedPixelWorld& world, int x, int y)
+                {
+                    std::vector<uint32_t> types;
+                    world.VisitPixelTypes(x * C, y * C, x * C + C - 1, y * C + C - 1,
+                                          [&](uint32_t type)
+                                          {
+                                              types.push_back(type);
+                                              return true;
+                                          });
+                    return types;
+                };
+                for (int y = minCY; y <= maxCY && oss.str().empty(); y++)
+                {
+                    for (int x = minCX; x <= maxCX; x++)
+                    {
+                        const std::vector<uint32_t> a = chunkTypes(evicting, x, y);
+                        const std::vector<uint32_t> b = chunkTypes(keeping, x, y);
+                        if (a != b)
+                        {
+                            const size_t p = static_cast<size_t>(
+                                std::mismatch(a.begin(), a.end(), b.begin(), b.end()).first - a.begin());
+                            oss << "segment " << segment << ": chunk (" << x << ", " << y << ") differs at pixel "
+                                << p << " (" << a.size() << " vs " << b.size() << " pixels), view chunk (" << cx
+                                << ", " << cy << ")";
+                            break;
+                        }
+                    }
+                }
+            }
+
+            if (!oss.str().empty())
+            {
+                result.passed = false;
+                result.failureMessage = oss.str();
+                result.failedIteration = i;
+                return result;
+            }
+        }
+
+        return result;
+    }
+
+    /**
+     * Property: a nav grid baked on the job system over evicted chunks matches one baked over a world that
+     * keeps every chunk resident
+     *
+     * The view walks away from the baked area and back, editing as it goes, so most of the grid lies on
+     * evicted chunks: edited ones decoded from the store (spilled to disk in half the iterations) and
+     * untouched ones regenerated from the seed. The grid is large enough that PixelWorldNavSource is
+     * sampled from several SampleJobs at once.
+     */
+    inline TestResult TestProperty_NavBakeOverEvictedChunks(int iterations = 4)
+    {
+        TestResult result;
+        constexpr int C = ChunkedPixelWorld::CHUNK_SIZE;
+        auto centre = [](int c) { return static_cast<float>(c * C + C / 2); };
+
+        for (int i = 0; i < iterations; i++)
+        {
+            EvictionRandomGenerator gen(47400u + static_cast<unsigned int>(i));
+            ScratchDirectory directory("pixel_evict_nav");
+            TerrainProfile profile;
+            profile.seed = gen.RandomInt(0, 100000);
+            profile.surfaceBaseY = 2 * C;
+            auto terrain = std::make_shared<TerrainPipeline>(profile, C);
+
+            auto evicting = std::make_shared<ChunkedPixelWorld>();
+            auto keeping = std::make_shared<ChunkedPixelWorld>();
+            for (ChunkedPixelWorld* world : {evicting.get(), keeping.get()})
+            {
+                world->SetTerrainPipeline(terrain);
+                world->Initialize(nullptr);
+            }
+            evicting->SetResidencyRadius(3);
+            keeping->SetResidencyRadius(1000);
+            if (i % 2 == 0)
+            {
+                evicting->GetChunkStore().SetMemoryBudget(8192);
+                evicting->GetChunkStore().SetSpillDirectory(directory.Path());
+            }
+
+            // 向右走到 cx = 12 再回到原点，沿途编辑；烘焙区域 [0, 12] 中离原点超过驻留半径的区块都被逐出
+            constexpr int Span = 12;
+            const int cy = 2;
+            for (int step = 0; step <= 2 * Span; step += 2)
+            {
+                const int cx = step <= Span ? step : 2 * Span - step;
+                for (ChunkedPixelWorld* world : {evicting.get(), keeping.get()})
+                    world->SetViewCenter(centre(cx), centre(cy), 1.0f);
+                if (gen.RandomInt(0, 2) == 0) continue;
+                PixelEditBuffer edits;
+                static const PixelType::Value materials[] = {PixelType::Air, PixelType::Sand, PixelType::Water,
+                                                             PixelType::Stone, PixelType::Lava};
+                for (int s = gen.RandomInt(1, 4); s > 0; s--)
+                {
+                    const int r = gen.RandomInt(8, 80);
+                    edits.FillCircle(gen.RandomInt((cx - 3) * C + r, (cx + 4) * C - 1 - r),
+                                     gen.RandomInt((cy - 3) * C + r, (cy + 4) * C - 1 - r), r,
+                                     materials[gen.RandomInt(0, 4)]);
+                }
+                evicting->ApplyEdits(edits);
+                keeping->ApplyEdits(edits);
+            }
+            evicting->FlushActiveChunks();
+            keeping->FlushActiveChunks();
+
+            const float cellSize = static_cast<float>(gen.RandomInt(3, 8));
+            const int width = static_cast<int>((Span + 1) * C / cellSize);
+            const int height = static_cast<int>(5 * C / cellSize);
+            const ECS::Vector2f origin(0.0f, 0.0f);
+            Navigation::NavGrid evictedGrid(width, height, cellSize, origin);
+            Navigation::NavGrid residentGrid(width, height, cellSize, origin);
+            Navigation::NavGridBaker evictedBaker;
+            Navigation::NavGridBaker residentBaker;
+            evictedBaker.AddSource(std::make_shared<Navigation::PixelWorldNavSource>(
+                evicting, 1.0f, Navigation::PixelMaterialTable()));
+            residentBaker.AddSource(std::make_shared<Navigation::PixelWorldNavSource>(
+                keeping, 1.0f, Navigation::PixelMaterialTable()));
+            evictedBaker.BakeAll(evictedGrid);
+            residentBaker.BakeAll(residentGrid);
+
+            std::ostringstream oss;
+            const size_t bakedChunks = static_cast<size_t>(Span + 1) * 5;
+            if (evicting->GetResidentChunkCount() >= bakedChunks)
+                oss << evicting->GetResidentChunkCount() << " chunks resident, nothing was evicted";
+            for (int y = 0; y < height && oss.str().empty(); y++)
+            {
+                for (int x = 0; x < width; x++)
+                {
+                    if (evictedGrid.IsWalkable(x, y) != residentGrid.IsWalkable(x, y) ||
+                        evictedGrid.GetCost(x, y) != residentGrid.GetCost(x, y))
+                    {
+                        oss << "cell (" << x << ", " << y << ") with cell size " << cellSize << ": walkable "
+                            << evictedGrid.IsWalkable(x, y) << " cost " << int(evictedGrid.GetCost(x, y))
+                            << " over evicted chunks, walkable " << residentGrid.IsWalkable(x, y) << " cost "
+                            << int(residentGrid.GetCost(x, y)) << " over resident chunks";
+                        break;
+                    }
+                }
+            }
+
+            if (!oss.str().empty())
+            {
+                result.passed = false;
+                result.failureMessage = oss.str();
+                result.failedIteration = i;
+                return result;
+            }
+        }
+
+        return result;
+    }
+
+    /**
+     * @brief Benchmark: compression ratio and reload latency of generated terrain chunks with edits
+     */
+    inline void RunPixelChunkStoreBenchmark(int chunkCount = 64)
+    {
+        using Clock = std::chrono::steady_clock;
+        constexpr int C = ChunkedPixelWorld::CHUNK_SIZE;
+        constexpr size_t Area = static_cast<size_t>(C) * C;
+        LogInfo("=== Pixel Chunk Store Benchmark ({} chunks) ===", chunkCount);
+
+        TerrainProfile profile;
+        profile.surfaceBaseY = 2 * C;
+        TerrainPipeline pipeline(profile, C);
+        EvictionRandomGenerator gen(47300u);
+        std::vector<std::vector<GPUPixel>> chunks;
+        std::vector<uint16_t> tiles(Area);
+        for (int n = 0; n < chunkCount; n++)
+        {
+            const int cx = n % 16 - 8;
+            const int cy = n / 16;
+            pipeline.Generate(cx * C, cy * C, tiles.data());
+            std::vector<GPUPixel> pixels(Area);
+            for (size_t p = 0; p < Area; p++)
+                pixels[p] = MakePixel(static_cast<PixelType::Value>(tiles[p]));
+            // 模拟玩家挖掘与倾倒：几个圆形编辑加少量带运动状态的像素
+            for (int e = 0; e < 4; e++)
+            {
+                const int ex = gen.RandomInt(0, C - 1);
+                const int ey = gen.RandomInt(0, C - 1);
+                const int r = gen.RandomInt(4, 20);
+                const PixelType::Value type = e % 2 ? PixelType::Air : PixelType::Sand;
+                for (int y = std::max(0, ey - r); y <= std::min(C - 1, ey + r); y++)
+                {
+                    for (int x = std::max(0, ex - r); x <= std::min(C - 1, ex + r); x++)
+                    {
+                        if ((x - ex) * (x - ex) + (y - ey) * (y - ey) <= r * r)
+                            pixels[static_cast<size_t>(y) * C + x] = MakePixel(type);
+                    }
+                }
+            }
+            for (int m = 0; m < 20; m++)
+                pixels[static_cast<size_t>(gen.RandomInt(0, static_cast<int>(Area) - 1))].velocity_y = 2.0f;
+            chunks.push_back(std::move(pixels));
+        }
+
+        size_t runBytes = 0;
+        std::vector<std::vector<uint8_t>> encoded;
+        auto start = Clock::now();
+        for (const auto& pixels : chunks)
+            encoded.push_back(PixelChunkCodec::Encode(pixels.data(), pixels.size()));
+        const double encodeMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        size_t encodedBytes = 0;
+        for (size_t n = 0; n < chunks.size(); n++)
+        {
+            std::vector<uint8_t> runs;
+            PixelChunkCodec::EncodeRuns(chunks[n].data(), chunks[n].size(), runs);
+            runBytes += runs.size();
+            encodedBytes += encoded[n].size();
+        }
+
+        std::vector<GPUPixel> decoded(Area);
+        start = Clock::now();
+        for (const auto& data : encoded)
+            PixelChunkCodec::Decode(data.data(), data.size(), decoded.data(), decoded.size());
+        const double decodeMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+        // 预算为 0：全部溢出到磁盘，计时从磁盘取回并解码
+        ScratchDirectory directory("pixel_store_bench");
+        PixelChunkStore store;
+        store.SetMemoryBudget(0);
+        store.SetSpillDirectory(directory.Path());
+        for (size_t n = 0; n < encoded.size(); n++)
+            store.Put(static_cast<int>(n), 0, encoded[n]);
+        store.Flush();
+        start = Clock::now();
+        for (size_t n = 0; n < encoded.size(); n++)
+        {
+            std::vector<uint8_t> data;
+            store.Take(static_cast<int>(n), 0, data);
+            PixelChunkCodec::Decode(data.data(), data.size(), decoded.data(), decoded.size());
+        }
+        const double diskMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+        const double rawBytes = static_cast<double>(Area * sizeof(GPUPixel) * chunks.size());
+        LogInfo("Raw: {:.1f} KB, runs: {:.1f} KB ({:.1f}x), runs+LZ: {:.1f} KB ({:.1f}x)", rawBytes / 1024.0,
+                runBytes / 1024.0, rawBytes / static_cast<double>(runBytes), encodedBytes / 1024.0,
+                rawBytes / static_cast<double>(encodedBytes));
+        LogInfo("Encode: {:.1f} us/chunk, reload from memory: {:.1f} us/chunk, reload from disk: {:.1f} us/chunk",
+                encodeMs * 1000.0 / chunkCount, decodeMs * 1000.0 / chunkCount, diskMs * 1000.0 / chunkCount);
+    }
+
+    inline bool RunAllPixelChunkStoreTests()
+    {
+        bool allPassed = true;
+        allPassed &= RunTest("TestProperty_CodecRoundTripIsExact", TestProperty_CodecRoundTripIsExact());
+        allPassed &= RunTest("TestProperty_MemoryBudgetIsRespected", TestProperty_MemoryBudgetIsRespected());
+        allPassed &= RunTest("TestProperty_EvictionPreservesWorld", TestProperty_EvictionPreservesWorld());
+        allPassed &= RunTest("TestProperty_NavBakeOverEvictedChunks", TestProperty_NavBakeOverEvictedChunks());
+        return allPassed;
+    }
+}
+
+#endif
@@ -0,0 +1,464 @@
+#ifndef PIXEL_COLLIDER_GRID_TESTS_H
+#define PIXEL_COLLIDER_GRID_TESTS_H
+
+/**
+ * @file PixelColliderGridTests.h
+ * @brief Property-based tests and benchmark for incremental pixel-world colliders
+ *
+ * Each 32x32 chunk keeps a packed solidity bitmask and only re-extracts its contour when that
+ * bitmask changes. Marching-squares cases are computed a whole word at a time. Contours are cut
+ * at chunk borders, so the chains of all chunks together must still be watertight, must match a
+ * plain per-cell extraction of the whole world, and an incremental update must give the same
+ * chains as rebuilding from scratch.
+ *
+ * Feature: pixel-collider-grid
+ */
+
+#include "../PixelWorld/PixelColliderGrid.h"
+#include "../../Event/JobSystem.h"
+#include "../../Utils/Logger.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace PixelColliderGridTests
+{
+    class ColliderRandomGenerator
+    {
+    public:
+        explicit ColliderRandomGenerator(unsigned int seed) : m_gen(seed) {}
+
+        int RandomInt(int min, int max)
+        {
+            std::uniform_int_distribution<int> dist(min, max);
+            return dist(m_gen);
+        }
+
+    private:
+        std::mt19937 m_gen;
+    };
+
+    /**
+     * @brief Test result structure for detailed failure reporting
+     */
+    struct TestResult
+    {
+        bool passed = true;
+        std::string failureMessage;
+        int failedIteration = -1;
+    };
+
+    inline bool RunTest(const char* name, const TestResult& result)
+    {
+        if (result.passed)
+        {
+            LogInfo("{} PASSED", name);
+            return true;
+        }
+        LogError("{} FAILED at iteration {}: {}", name, result.failedIteration, result.failureMessage);
+        return false;
+    }
+
+    /// 线段端点以半像素为单位：{ax, ay, bx, by}
+    using HalfSegment = std::array<int, 4>;
+
+    inline GPUPixel MakePixel(PixelType::Value type)
+    {
+        return GPUPixel{static_cast<uint32_t>(type), DefaultPixelColor(type), 0.0f, 0.0f};
+    }
+
+    inline bool IsSolidType(uint32_t type)
+    {
+        return type == PixelType::Sand || type == PixelType::Stone;
+    }
+
+    inline void FillDisc(std::vector<GPUPixel>& pixels, int width, int height, int cx, int cy, int r,
+                         PixelType::Value type)
+    {
+        for (int y = std::max(0, cy - r); y <= std::min(height - 1, cy + r); ++y)
+            for (int x = std::max(0, cx - r); x <= std::min(width - 1, cx + r); ++x)
+                if ((x - cx) * (x - cx) + (y - cy) * (y - cy) <= r * r)
+                    pixels[static_cast<size_t>(y) * width + x] = MakePixel(type);
+    }
+
+    /**
+     * @brief 随机的实心团块加上零散噪点，噪点会产生大量鞍点单元
+     */
+    inline std::vector<GPUPixel> RandomWorld(ColliderRandomGenerator& gen, int width, int height)
+    {
+        std::vector<GPUPixel> pixels(static_cast<size_t>(width) * height, MakePixel(PixelType::Air));
+        const int blobs = gen.RandomInt(1, 12);
+        for (int b = 0; b < blobs; ++b)
+        {
+            const auto type = gen.RandomInt(0, 3) == 0 ? PixelType::Water
+                                                       : (gen.RandomInt(0, 1) ? PixelType::Sand : PixelType::Stone);
+            FillDisc(pixels, width, height, gen.RandomInt(-10, width + 10), gen.RandomInt(-10, height + 10),
+                     gen.RandomInt(2, 40), type);
+        }
+        const int noise = gen.RandomInt(0, 20);
+        for (auto& pixel : pixels)
+            if (gen.RandomInt(0, 99) < noise)
+                pixel = MakePixel(gen.RandomInt(0, 1) ? PixelType::Stone : PixelType::Air);
+        return pixels;
+    }
+
+    /**
+     * @brief 逐单元的参考提取：跨越边界的单元边取中点，朝向使法线 (dy, -dx) 指向空角
+     */
+    inline std::vector<HalfSegment> ReferenceSegments(const std::vector<GPUPixel>& pixels, int width, int height)
+    {
+        auto solid = [&](int x, int y)
+        {
+            return x >= 0 && y >= 0 && x < width && y < height &&
+                   IsSolidType(pixels[static_cast<size_t>(y) * width + x].pixel_type);
+        };
+
+        std::vector<HalfSegment> segments;
+        for (int j = -1; j < height; ++j)
+        {
+            for (int i = -1; i < width; ++i)
+            {
+                // 角按顺时针：TL, TR, BR, BL；采样点 (x, y) 的半像素坐标为 (2x + 1, 2y + 1)
+                const std::array<std::pair<int, int>, 4> corners = {
+                    std::pair{i, j}, std::pair{i + 1, j}, std::pair{i + 1, j + 1}, std::pair{i, j + 1}};
+                std::array<bool, 4> s{};
+                for (int c = 0; c < 4; ++c)
+                    s[c] = solid(corners[c].first, corners[c].second);
+
+                auto midpoint = [&](int edge)
+                {
+                    const auto& a = corners[edge];
+                    const auto& b = corners[(edge + 1) % 4];
+                    return std::pair{a.first + b.first + 1, a.second + b.second + 1};
+                };
+                // 每个实心角与两条相邻的跨越边围成一段（鞍点时两个实心角各一段）
+                const int solidCount = s[0] + s[1] + s[2] + s[3];
+                if (solidCount == 0 || solidCount == 4) continue;
+                struct Piece
+                {
+                    std::pair<int, int> a, b;
+                    int probe;  ///< 用来判断朝向的角，-1 表示取第一个不在线上的角
+                };
+                std::vector<Piece> pieces;
+                if (solidCount == 2 && s[0] == s[2])
+                {
+                    for (int c = 0; c < 4; ++c)
+                        if (s[c]) pieces.push_back({midpoint((c + 3) % 4), midpoint(c), c});
+                }
+                else
+                {
+                    std::vector<int> crossing;
+                    for (int e = 0; e < 4; ++e)
+                        if (s[e] != s[(e + 1) % 4]) crossing.push_back(e);
+                    pieces.push_back({midpoint(crossing[0]), midpoint(crossing[1]), -1});
+                }
+
+                for (auto [a, b, probe] : pieces)
+                {
+                    // 法线一侧的角应为空，反了就交换
+                    const int nx = b.second - a.second;
+                    const int ny = -(b.first - a.first);
+                    for (int c = probe < 0 ? 0 : probe; c < 4; ++c)
+                    {
+                        const int px = 2 * corners[c].first + 1 - a.first;
+                        const int py = 2 * corners[c].second + 1 - a.second;
+                        const int side = px * nx + py * ny;
+                        if (side == 0) continue;
+                        if ((side > 0) == s[c]) std::swap(a, b);
+                        break;
+                    }
+                    segments.push_back({a.first, a.second, b.first, b.second});
+                }
+            }
+        }
+        std::sort(segments.begin(), segments.end());
+        return segments;
+    }
+
+    /**
+     * @brief 所有区块的实体段（开链去掉两端的幽灵段），转换为半像素坐标
+     */
+    inline std::vector<HalfSegment> CollectSolidSegments(const PixelColliderGrid& grid, bool& badChain)
+    {
+        std::vector<HalfSegment> segments;
+        auto half = [](const ECS::Vector2f& p)
+        {
+            return std::pair{static_cast<int>(std::lround(p.x * 2.0f)), static_cast<int>(std::lround(p.y * 2.0f))};
+        };
+        for (int index = 0; index < grid.GetChunksX() * grid.GetChunksY(); ++index)
+        {
+            for (const auto& chain : grid.GetChains(index))
+            {
+                const auto& pts = chain.points;
+                if (pts.size() < 4) badChain = true;
+                const size_t n = pts.size();
+                const size_t first = chain.loop ? 0 : 1;
+                const size_t count = chain.loop ? n : n - 3;
+                for (size_t k = 0; k < count && n >= 4; ++k)
+                {
+                    const auto a = half(pts[first + k]);
+                    const auto b = half(pts[(first + k + 1) % n]);
+                    if (a == b) badChain = true;
+                    segments.push_back({a.first, a.second, b.first, b.second});
+                }
+            }
+        }
+        std::sort(segments.begin(), segments.end());
+        return segments;
+    }
+
+    /**
+     * Property: chains of all chunks together are watertight (every vertex has as many
+     * incoming as outgoing solid segments), and without simplification they match the
+     * per-cell reference extraction of the whole world exactly
+     */
+    inline TestResult TestProperty_ContoursWatertightAcrossChunks(int iterations = 60)
+    {
+        TestResult result;
+        ColliderRandomGenerator gen(45001);
+
+        for (int i = 0; i < iterations; ++i)
+        {
+            const int width = gen.RandomInt(1, 220);
+            const int height = gen.RandomInt(1, 220);
+            const std::vector<GPUPixel> pixels = RandomWorld(gen, width, height);
+            const float tolerance = i % 3 == 0 ? -1.0f : (i % 3 == 1 ? 0.5f : 2.0f);
+
+            PixelColliderGrid grid(width, height);
+            grid.SetSimplifyTolerance(tolerance);
+            grid.Update(pixels.data());
+
+            auto fail = [&](const std::string& message)
+            {
+                std::ostringstream oss;
+                oss << width << "x" << height << ", tolerance " << tolerance << ": " << message;
+                result.passed = false;
+                result.failureMessage = oss.str();
+                result.failedIteration = i;
+            };
+
+            bool badChain = false;
+            const auto segments = CollectSolidSegments(grid, badChain);
+            if (badChain)
+            {
+                fail("chain with fewer than four points or a zero-length segment");
+                return result;
+            }
+
+            std::map<std::pair<int, int>, int> balance;
+            for (const auto& s : segments)
+            {
+                balance[{s[0], s[1]}]++;
+                balance[{s[2], s[3]}]--;
+            }
+            for (const auto& [point, degree] : balance)
+            {
+                if (degree != 0)
+                {
+                    fail("contour is open at (" + std::to_string(point.first * 0.5f) + ", " +
+                         std::to_string(point.second * 0.5f) + ")");
+                    return result;
+                }
+            }
+
+            const auto reference = ReferenceSegments(pixels, width, height);
+            if (tolerance < 0.0f && segments != reference)
+            {
+                fail("chunked segments differ from the whole-world reference");
+                return result;
+            }
+
+            // 整个世界打包成多字的行，检查跨字的单元
+            const int maskW = width + 2;
+            const int words = (maskW + 63) / 64;
+            std::vector<uint64_t> rows(static_cast<size_t>(words) * (height + 2), 0);
+            for (int y = 0; y < height; ++y)
+                for (int x = 0; x < width; ++x)
+                    if (IsSolidType(pixels[static_cast<size_t>(y) * width + x].pixel_type))
+                        rows[static_cast<size_t>(y + 1) * words + (x + 1) / 64] |= 1ull << ((x + 1) % 64);
+            std::vector<ContourSegment> raw;
+            MarchingSquares::ExtractSegments(rows.data(), words, 0, 0, width, height, raw);
+            std::vector<HalfSegment> whole;
+            for (const auto& seg : raw)
+                whole.push_back({seg.ax - 1, seg.ay - 1, seg.bx - 1, seg.by - 1});
+            std::sort(whole.begin(), whole.end());
+            if (whole != reference)
+            {
+                fail("multi-word extraction differs from the per-cell reference");
+                return result;
+            }
+        }
+
+        return result;
+    }
+
+    /**
+     * Property: after random edits only chunks whose mask window changed are rebuilt, every
+     * chunk with a changed solid pixel is rebuilt, and the result equals a fresh grid
+     */
+    inline TestResult TestProperty_IncrementalMatchesFullRebuild(int iterations = 30)
+    {
+        TestResult result;
+        ColliderRandomGenerator gen(45002);
+        constexpr int Size = PixelColliderGrid::ChunkSize;
+
+        for (int i = 0; i < iterations; ++i)
+        {
+            const int width = gen.RandomInt(40, 260);
+            const int height = gen.RandomInt(40, 260);
+            std::vector<GPUPixel> pixels = RandomWorld(gen, width, height);
+
+            PixelColliderGrid grid(width, height);
+            grid.Update(pixels.data());
+            grid.Update(pixels.data());
+
+            auto fail = [&](const std::string& message)
+            {
+                std::ostringstream oss;
+                oss << width << "x" << height << ": " << message;
+                result.passed = false;
+                result.failureMessage = oss.str();
+                result.failedIteration = i;
+            };
+
+            if (grid.GetStats().rebuiltChunks != 0)
+            {
+                fail("unchanged world rebuilt " + std::to_string(grid.GetStats().rebuiltChunks) + " chunks");
+                return result;
+            }
+
+            const std::vector<GPUPixel> before = pixels;
+            const int edits = gen.RandomInt(1, 4);
+            for (int e = 0; e < edits; ++e)
+            {
+                const auto type = gen.RandomInt(0, 1) ? PixelType::Air : PixelType::Stone;
+                FillDisc(pixels, width, height, gen.RandomInt(0, width - 1), gen.RandomInt(0, height - 1),
+                         gen.RandomInt(0, 12), type);
+            }
+            grid.Update(pixels.data());
+
+            // 每个区块的位图窗口（向外两格）内是否有实心性变化
+            const auto& rebuilt = grid.GetRebuiltChunks();
+            for (int cy = 0; cy < grid.GetChunksY(); ++cy)
+            {
+                for (int cx = 0; cx < grid.GetChunksX(); ++cx)
+                {
+                    bool windowChanged = false;
+                    bool ownChanged = false;
+                    for (int y = std::max(0, cy * Size - 2); y < std::min(height, cy * Size + Size + 2); ++y)
+                    {
+                        for (int x = std::max(0, cx * Size - 2); x < std::min(width, cx * Size + Size + 2); ++x)
+                        {
+                            const size_t p = static_cast<size_t>(y) * width + x;
+                            if (IsSolidType(before[p].pixel_type) == IsSolidType(pixels[p].pixel_type)) continue;
+                            windowChanged = true;
+                            ownChanged |= x >= cx * Size && x < cx * Size + Size && y >= cy * Size &&
+                                          y < cy * Size + Size;
+                        }
+                    }
+                    const bool wasRebuilt =
+                        std::find(rebuilt.begin(), rebuilt.end(), cy * grid.GetChunksX() + cx) != rebuilt.end();
+                    if (wasRebuilt != windowChanged || (ownChanged && !wasRebuilt))
+                    {
+                        fail("chunk (" + std::to_string(cx) + ", " + std::to_string(cy) + ") rebuilt=" +
+                             std::to_string(wasRebuilt) + " but mask changed=" + std::to_string(windowChanged));
+                        return result;
+                    }
+                }
+            }
+
+            PixelColliderGrid fresh(width, height);
+            fresh.Update(pixels.data());
+            for (int index = 0; index < grid.GetChunksX() * grid.GetChunksY(); ++index)
+            {
+                const auto& a = grid.GetChains(index);
+                const auto& b = fresh.GetChains(index);
+                bool same = a.size() == b.size();
+                for (size_t c = 0; same && c < a.size(); ++c)
+                {
+                    same = a[c].loop == b[c].loop && a[c].points.size() == b[c].points.size();
+                    for (size_t k = 0; same && k < a[c].points.size(); ++k)
+                        same = a[c].points[k].x == b[c].points[k].x && a[c].points[k].y == b[c].points[k].y;
+                }
+                if (!same)
+                {
+                    fail("chunk " + std::to_string(index) + " differs from a fresh rebuild");
+                    return result;
+                }
+            }
+        }
+
+        return result;
+    }
+
+    /**
+     * @brief Benchmark: full collider build vs incremental update after an explosion
+     */
+    inline void RunPixelColliderBenchmark(int size = 1024, int explosions = 20)
+    {
+        using Clock = std::chrono::steady_clock;
+        LogInfo("=== Pixel Collider Benchmark ({}x{}, {} job threads, {} hardware threads) ===", size, size,
+                JobSystem::GetInstance().GetThreadCount(), std::thread::hardware_concurrency());
+
+        // 起伏的地形，下半部分为石头，表面有沙
+        ColliderRandomGenerator gen(45100);
+        std::vector<GPUPixel> pixels(static_cast<size_t>(size) * size, MakePixel(PixelType::Air));
+        for (int x = 0; x < size; ++x)
+        {
+            const int surface = size / 2 + static_cast<int>(40.0 * std::sin(x * 0.02) + 15.0 * std::sin(x * 0.11));
+            for (int y = surface; y < size; ++y)
+                pixels[static_cast<size_t>(y) * size + x] =
+                    MakePixel(y < surface + 6 ? PixelType::Sand : PixelType::Stone);
+        }
+        for (int c = 0; c < 200; ++c)
+            FillDisc(pixels, size, size, gen.RandomInt(0, size - 1), gen.RandomInt(size / 2, size - 1),
+                     gen.RandomInt(2, 12), PixelType::Air);
+
+        auto start = Clock::now();
+        const auto reference = ReferenceSegments(pixels, size, size);
+        const double referenceMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+        PixelColliderGrid grid(size, size);
+        start = Clock::now();
+        grid.Update(pixels.data());
+        const double fullMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        LogInfo("Per-cell reference extraction: {:.2f} ms ({} segments)", referenceMs, reference.size());
+        LogInfo("Full build: {:.2f} ms, {} chunks, {} chains", fullMs, grid.GetStats().rebuiltChunks,
+                grid.GetStats().chains);
+
+        double incrementalMs = 0.0;
+        uint64_t rebuiltChunks = 0;
+        for (int e = 0; e < explosions; ++e)
+        {
+            FillDisc(pixels, size, size, gen.RandomInt(0, size - 1), gen.RandomInt(size / 2 - 40, size - 1), 40,
+                     PixelType::Air);
+            start = Clock::now();
+            grid.Update(pixels.data());
+            incrementalMs += std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+            rebuiltChunks += grid.GetStats().rebuiltChunks;
+        }
+        LogInfo("Incremental after explosion: {:.2f} ms, {:.1f} of {} chunks rebuilt ({:.1f}x faster than full)",
+                incrementalMs / explosions, static_cast<double>(rebuiltChunks) / explosions,
+                grid.GetStats().totalChunks, fullMs / std::max(incrementalMs / explosions, 1e-3));
+    }
+
+    inline bool RunAllPixelColliderGridTests()
+    {
+        bool allPassed = true;
+        allPassed &= RunTest("TestProperty_ContoursWatertightAcrossChunks",
+                             TestProperty_ContoursWatertightAcrossChunks());
+        allPassed &= RunTest("TestProperty_IncrementalMatchesFullRebuild",
+                             TestProperty_IncrementalMatchesFullRebuild());
+        return allPassed;
+    }
+}
+
+#endif
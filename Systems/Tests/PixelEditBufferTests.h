@@ -0,0 +1,440 @@
+#ifndef PIXEL_EDIT_BUFFER_TESTS_H
+#define PIXEL_EDIT_BUFFER_TESTS_H
+
+/**
+ * @file PixelEditBufferTests.h
+ * @brief Property-based tests and benchmark for the batched pixel edit command buffer
+ *
+ * Shape edits are recorded as commands and applied row span by row span instead of one
+ * SetPixel per pixel. Applying a command list must leave the world bit for bit identical to
+ * running the old per-pixel loops in the same order, and the dirty tiles it reports must cover
+ * every changed pixel while staying inside their own tile.
+ *
+ * Feature: pixel-edit-buffer
+ */
+
+#include "../PixelWorld/PixelEditBuffer.h"
+#include "../../Utils/Logger.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace PixelEditBufferTests
+{
+    class EditRandomGenerator
+    {
+    public:
+        explicit EditRandomGenerator(unsigned int seed) : m_gen(seed) {}
+
+        int RandomInt(int min, int max)
+        {
+            std::uniform_int_distribution<int> dist(min, max);
+            return dist(m_gen);
+        }
+
+        uint32_t RandomUInt()
+        {
+            return static_cast<uint32_t>(m_gen());
+        }
+
+    private:
+        std::mt19937 m_gen;
+    };
+
+    /**
+     * @brief Test result structure for detailed failure reporting
+     */
+    struct TestResult
+    {
+        bool passed = true;
+        std::string failureMessage;
+        int failedIteration = -1;
+    };
+
+    inline bool RunTest(const char* name, const TestResult& result)
+    {
+        if (result.passed)
+        {
+            LogInfo("{} PASSED", name);
+            return true;
+        }
+        LogError("{} FAILED at iteration {}: {}", name, result.failedIteration, result.failureMessage);
+        return false;
+    }
+
+    inline GPUPixel MakePixel(PixelType::Value type)
+    {
+        return GPUPixel{static_cast<uint32_t>(type), DefaultPixelColor(type), 0.0f, 0.0f};
+    }
+
+    inline std::vector<GPUPixel> RandomWorld(EditRandomGenerator& gen, int width, int height)
+    {
+        std::vector<GPUPixel> pixels(static_cast<size_t>(width) * height);
+        for (auto& pixel : pixels)
+            pixel = MakePixel(static_cast<PixelType::Value>(gen.RandomInt(0, 6)));
+        return pixels;
+    }
+
+    inline bool SamePixels(const std::vector<GPUPixel>& a, const std::vector<GPUPixel>& b, int width,
+                           std::string& where)
+    {
+        for (size_t i = 0; i < a.size(); ++i)
+        {
+            if (a[i].pixel_type != b[i].pixel_type || a[i].color != b[i].color)
+            {
+                where = "(" + std::to_string(i % width) + ", " + std::to_string(i / width) + ")";
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief 逐像素参考实现，与命令缓冲之前 PixelExplosion 中的循环相同
+     */
+    struct ReferenceWorld
+    {
+        std::vector<GPUPixel>& pixels;
+        int width;
+        int height;
+
+        bool Inside(int x, int y) const { return x >= 0 && x < width && y >= 0 && y < height; }
+        uint32_t Get(int x, int y) const { return pixels[static_cast<size_t>(y) * width + x].pixel_type; }
+
+        void Set(int x, int y, PixelType::Value type, uint32_t mask)
+        {
+            if (Inside(x, y) && (mask & PixelEditBuffer::TypeBit(Get(x, y))) != 0)
+                pixels[static_cast<size_t>(y) * width + x] = MakePixel(type);
+        }
+
+        void Apply(const PixelEditBuffer::Command& c)
+        {
+            using Shape = PixelEditBuffer::Shape;
+            switch (c.shape)
+            {
+            case Shape::Rect:
+                for (int y = c.y0; y <= c.y1; ++y)
+                    for (int x = c.x0; x <= c.x1; ++x)
+                        Set(x, y, c.type, c.replaceMask);
+                break;
+
+            case Shape::Circle:
+                for (int dy = -c.size; dy <= c.size; ++dy)
+                    for (int dx = -c.size; dx <= c.size; ++dx)
+                        if (dx * dx + dy * dy <= c.size * c.size)
+                            Set(c.x0 + dx, c.y0 + dy, c.type, c.replaceMask);
+                break;
+
+            case Shape::Line:
+            {
+                const int half = c.size / 2;
+                const int dx = std::abs(c.x1 - c.x0);
+                const int dy = -std::abs(c.y1 - c.y0);
+                const int sx = c.x0 < c.x1 ? 1 : -1;
+                const int sy = c.y0 < c.y1 ? 1 : -1;
+                int err = dx + dy;
+                int cx = c.x0;
+                int cy = c.y0;
+                for (;;)
+                {
+                    for (int ty = -half; ty <= half; ++ty)
+                        for (int tx = -half; tx <= half; ++tx)
+                            Set(cx + tx, cy + ty, c.type, c.replaceMask);
+                    if (cx == c.x1 && cy == c.y1) break;
+                    const int e2 = 2 * err;
+                    if (e2 >= dy) { err += dy; cx += sx; }
+                    if (e2 <= dx) { err += dx; cy += sy; }
+                }
+                break;
+            }
+
+            case Shape::Explosion:
+                Explode(c);
+                break;
+            }
+        }
+
+        void Explode(const PixelEditBuffer::Command& c)
+        {
+            const int pr = c.size;
+            const bool createFire = (c.flags & PixelEditBuffer::ExplosionFire) != 0;
+            const bool createDebris = (c.flags & PixelEditBuffer::ExplosionDebris) != 0;
+            const uint32_t all = PixelEditBuffer::AllTypes;
+            for (int dy = -pr; dy <= pr; ++dy)
+            {
+                for (int dx = -pr; dx <= pr; ++dx)
+                {
+                    const int px = c.x0 + dx;
+                    const int py = c.y0 + dy;
+                    if (!Inside(px, py)) continue;
+                    const float dist = std::sqrt(static_cast<float>(dx * dx + dy * dy));
+                    if (dist > static_cast<float>(pr)) continue;
+
+                    const uint32_t cur = Get(px, py);
+                    if (createFire && cur == PixelType::Oil)
+                    {
+                        Set(px, py, PixelType::Fire, all);
+                        continue;
+                    }
+                    if (cur == PixelType::Air) continue;
+                    const bool solid = cur == PixelType::Sand || cur == PixelType::Stone;
+                    if (createDebris && dist / static_cast<float>(pr) > 0.7f && solid &&
+                        (PixelEditBuffer::ExplosionRandom(c.seed, px, py, 0) & 3u) == 0)
+                    {
+                        const int ox = px + (dx > 0 ? 2 : -2);
+                        const int oy = py + (dy > 0 ? 2 : -2);
+                        if (Inside(ox, oy) && Get(ox, oy) == PixelType::Air)
+                            Set(ox, oy, PixelType::Sand, all);
+                    }
+                    Set(px, py, PixelType::Air, all);
+                }
+            }
+
+            if (!createFire) return;
+            const int fireR = std::max(1, pr / 3);
+            for (int dy = -fireR; dy <= fireR; ++dy)
+            {
+                for (int dx = -fireR; dx <= fireR; ++dx)
+                {
+                    if (dx * dx + dy * dy > fireR * fireR) continue;
+                    const int px = c.x0 + dx;
+                    const int py = c.y0 + dy;
+                    if (Inside(px, py) && Get(px, py) == PixelType::Air &&
+                        PixelEditBuffer::ExplosionRandom(c.seed, px, py, 1) % 3u == 0)
+                        Set(px, py, PixelType::Fire, all);
+                }
+            }
+        }
+    };
+
+    inline uint32_t RandomMask(EditRandomGenerator& gen)
+    {
+        if (gen.RandomInt(0, 2) == 0) return PixelEditBuffer::AllTypes;
+        uint32_t mask = 0;
+        for (uint32_t t = 0; t < 7; ++t)
+            if (gen.RandomInt(0, 1)) mask |= PixelEditBuffer::TypeBit(t);
+        return mask;
+    }
+
+    /**
+     * @brief 随机命令，位置允许越出世界边界
+     */
+    inline void RecordRandomCommands(EditRandomGenerator& gen, PixelEditBuffer& edits, int width, int height,
+                                     int count)
+    {
+        for (int n = 0; n < count; ++n)
+        {
+            const int x = gen.RandomInt(-20, width + 20);
+            const int y = gen.RandomInt(-20, height + 20);
+            const auto type = static_cast<PixelType::Value>(gen.RandomInt(0, 6));
+            switch (gen.RandomInt(0, 3))
+            {
+            case 0:
+                edits.FillRect(x, y, gen.RandomInt(0, 60), gen.RandomInt(0, 60), type, RandomMask(gen));
+                break;
+            case 1:
+                edits.FillCircle(x, y, gen.RandomInt(0, 40), type, RandomMask(gen));
+                break;
+            case 2:
+                edits.FillLine(x, y, gen.RandomInt(-20, width + 20), gen.RandomInt(-20, height + 20),
+                               gen.RandomInt(0, 9), type, RandomMask(gen));
+                break;
+            default:
+                edits.Explode(x, y, gen.RandomInt(1, 40), static_cast<uint32_t>(gen.RandomInt(0, 3)),
+                              gen.RandomUInt());
+                break;
+            }
+        }
+    }
+
+    /**
+     * Property: applying recorded commands matches the per-pixel loops exactly, and the dirty
+     * tiles cover every changed pixel without leaving their tile
+     */
+    inline TestResult TestProperty_CommandsMatchPerPixelEdits(int iterations = 200)
+    {
+        TestResult result;
+        EditRandomGenerator gen(44001);
+
+        for (int i = 0; i < iterations; ++i)
+        {
+            const int width = gen.RandomInt(1, 200);
+            const int height = gen.RandomInt(1, 200);
+            const int tileSize = gen.RandomInt(1, 4) * 16;
+            const std::vector<GPUPixel> initial = RandomWorld(gen, width, height);
+
+            PixelEditBuffer edits;
+            RecordRandomCommands(gen, edits, width, height, gen.RandomInt(1, 12));
+
+            std::vector<GPUPixel> expected = initial;
+            ReferenceWorld reference{expected, width, height};
+            for (const auto& command : edits.GetCommands())
+                reference.Apply(command);
+
+            std::vector<GPUPixel> actual = initial;
+            PixelDirtyTiles dirty(width, height, tileSize);
+            PixelBufferEditTarget target{actual.data(), width, height, &dirty};
+            edits.Apply(target);
+
+            auto fail = [&](const std::string& message)
+            {
+                std::ostringstream oss;
+                oss << width << "x" << height << ", " << edits.Size() << " commands: " << message;
+                result.passed = false;
+                result.failureMessage = oss.str();
+                result.failedIteration = i;
+            };
+
+            std::string where;
+            if (!SamePixels(expected, actual, width, where))
+            {
+                fail("pixel differs from per-pixel edit at " + where);
+                return result;
+            }
+
+            for (int ty = 0; ty < dirty.GetTilesY(); ++ty)
+            {
+                for (int tx = 0; tx < dirty.GetTilesX(); ++tx)
+                {
+                    const PixelRect& rect = dirty.GetTile(ty * dirty.GetTilesX() + tx);
+                    if (rect.Empty()) continue;
+                    if (rect.minX < tx * tileSize || rect.maxX >= (tx + 1) * tileSize || rect.minY < ty * tileSize ||
+                        rect.maxY >= (ty + 1) * tileSize)
+                    {
+                        fail("dirty rect leaves tile (" + std::to_string(tx) + ", " + std::to_string(ty) + ")");
+                        return result;
+                    }
+                }
+            }
+
+            for (int y = 0; y < height; ++y)
+            {
+                for (int x = 0; x < width; ++x)
+                {
+                    const size_t index = static_cast<size_t>(y) * width + x;
+                    if (initial[index].pixel_type == actual[index].pixel_type) continue;
+                    const PixelRect& rect = dirty.GetTile((y / tileSize) * dirty.GetTilesX() + x / tileSize);
+                    if (x < rect.minX || x > rect.maxX || y < rect.minY || y > rect.maxY)
+                    {
+                        fail("changed pixel (" + std::to_string(x) + ", " + std::to_string(y) + ") is not dirty");
+                        return result;
+                    }
+                }
+            }
+        }
+
+        return result;
+    }
+
+    /**
+     * Property: a masked fill leaves every pixel outside the mask untouched and reports an empty
+     * dirty set when nothing matches
+     */
+    inline TestResult TestProperty_MaskedFillKeepsOtherTypes(int iterations = 100)
+    {
+        TestResult result;
+        EditRandomGenerator gen(44002);
+
+        for (int i = 0; i < iterations; ++i)
+        {
+            const int width = gen.RandomInt(8, 150);
+            const int height = gen.RandomInt(8, 150);
+            std::vector<GPUPixel> pixels = RandomWorld(gen, width, height);
+            // Loaded data may carry type values of 32 and above
+            for (int k = gen.RandomInt(0, 20); k > 0; --k)
+            {
+                auto& pixel = pixels[gen.RandomInt(0, width * height - 1)];
+                pixel.pixel_type = static_cast<uint32_t>(gen.RandomInt(32, 255));
+            }
+            const std::vector<GPUPixel> initial = pixels;
+            const uint32_t mask = RandomMask(gen);
+            const auto type = static_cast<PixelType::Value>(gen.RandomInt(0, 6));
+
+            PixelEditBuffer edits;
+            edits.FillRect(gen.RandomInt(-10, width), gen.RandomInt(-10, height), gen.RandomInt(1, 80),
+                           gen.RandomInt(1, 80), type, mask);
+            edits.FillCircle(gen.RandomInt(0, width), gen.RandomInt(0, height), gen.RandomInt(0, 30), type, mask);
+
+            PixelDirtyTiles dirty(width, height, 32);
+            PixelBufferEditTarget target{pixels.data(), width, height, &dirty};
+            edits.Apply(target);
+
+            for (size_t p = 0; p < pixels.size(); ++p)
+            {
+                const bool changed = pixels[p].pixel_type != initial[p].pixel_type;
+                if ((mask & PixelEditBuffer::TypeBit(initial[p].pixel_type)) == 0 && changed)
+                {
+                    result.passed = false;
+                    result.failureMessage = "pixel of type " + std::to_string(initial[p].pixel_type) +
+                                            " outside the replace mask was overwritten";
+                    result.failedIteration = i;
+                    return result;
+                }
+            }
+
+            // 掩码为空时不应有任何脏瓦片
+            edits.Clear();
+            dirty.Clear();
+            edits.FillRect(0, 0, width, height, type, 0u);
+            edits.Apply(target);
+            if (!dirty.Empty())
+            {
+                result.passed = false;
+                result.failureMessage = "empty replace mask produced dirty tiles";
+                result.failedIteration = i;
+                return result;
+            }
+        }
+
+        return result;
+    }
+
+    /**
+     * @brief Benchmark: per-pixel edits vs recorded span edits on the same command list
+     */
+    inline void RunPixelEditBufferBenchmark(int size = 2048, int commands = 2000)
+    {
+        using Clock = std::chrono::steady_clock;
+        LogInfo("=== Pixel Edit Buffer Benchmark ({}x{}, {} commands) ===", size, size, commands);
+
+        EditRandomGenerator gen(44100);
+        const std::vector<GPUPixel> initial = RandomWorld(gen, size, size);
+        PixelEditBuffer edits;
+        RecordRandomCommands(gen, edits, size, size, commands);
+
+        std::vector<GPUPixel> perPixel = initial;
+        ReferenceWorld reference{perPixel, size, size};
+        auto start = Clock::now();
+        for (const auto& command : edits.GetCommands())
+            reference.Apply(command);
+        const double perPixelMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+        std::vector<GPUPixel> batched = initial;
+        PixelDirtyTiles dirty(size, size, 64);
+        PixelBufferEditTarget target{batched.data(), size, size, &dirty};
+        start = Clock::now();
+        edits.Apply(target);
+        const double batchedMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+        int dirtyTiles = 0;
+        dirty.ForEach([&](int, const PixelRect&) { dirtyTiles++; });
+        LogInfo("Per-pixel: {:.2f} ms, command buffer: {:.2f} ms ({:.1f}x), {} of {} tiles dirty", perPixelMs,
+                batchedMs, perPixelMs / std::max(batchedMs, 1e-3), dirtyTiles,
+                dirty.GetTilesX() * dirty.GetTilesY());
+    }
+
+    inline bool RunAllPixelEditBufferTests()
+    {
+        bool allPassed = true;
+        allPassed &= RunTest("TestProperty_CommandsMatchPerPixelEdits", TestProperty_CommandsMatchPerPixelEdits());
+        allPassed &= RunTest("TestProperty_MaskedFillKeepsOtherTypes", TestProperty_MaskedFillKeepsOtherTypes());
+        return allPassed;
+    }
+}
+
+#endif
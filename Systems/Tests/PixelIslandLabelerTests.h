@@ -0,0 +1,407 @@
+#ifndef PIXEL_ISLAND_LABELER_TESTS_H
+#define PIXEL_ISLAND_LABELER_TESTS_H
+
+/**
+ * @file PixelIslandLabelerTests.h
+ * @brief Property-based tests and benchmark for connected-component labeling of pixel terrain
+ *
+ * PixelIslandLabeler labels 4-connected solid pixels inside a region with per-tile union-find
+ * and border merging. Components touching the region border count as anchored; the others are
+ * floating islands that PixelPhysicsBridge turns into debris bodies after an explosion.
+ *
+ * Feature: pixel-debris-islands
+ */
+
+#include "../PixelWorld/PixelIslandLabeler.h"
+#include "../PixelWorld/PixelEditBuffer.h"
+#include "../../Utils/Logger.h"
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace PixelIslandLabelerTests
+{
+    class IslandRandomGenerator
+    {
+    public:
+        explicit IslandRandomGenerator(unsigned int seed) : m_gen(seed) {}
+
+        int RandomInt(int min, int max)
+        {
+            std::uniform_int_distribution<int> dist(min, max);
+            return dist(m_gen);
+        }
+
+    private:
+        std::mt19937 m_gen;
+    };
+
+    /**
+     * @brief Test result structure for detailed failure reporting
+     */
+    struct TestResult
+    {
+        bool passed = true;
+        std::string failureMessage;
+        int failedIteration = -1;
+    };
+
+    inline bool RunTest(const char* name, const TestResult& result)
+    {
+        if (result.passed)
+        {
+            LogInfo("{} PASSED", name);
+            return true;
+        }
+        LogError("{} FAILED at iteration {}: {}", name, result.failedIteration, result.failureMessage);
+        return false;
+    }
+
+    inline GPUPixel MakePixel(PixelType::Value type)
+    {
+        return GPUPixel{static_cast<uint32_t>(type), DefaultPixelColor(type), 0.0f, 0.0f};
+    }
+
+    /**
+     * @brief Random terrain: scattered stone at a random density plus stone and air blobs, with
+     * some sand and water that must not count as solid
+     */
+    inline std::vector<GPUPixel> RandomTerrain(IslandRandomGenerator& gen, int width, int height)
+    {
+        std::vector<GPUPixel> pixels(static_cast<size_t>(width) * height, MakePixel(PixelType::Air));
+        const int density = gen.RandomInt(0, 100);
+        for (GPUPixel& p : pixels)
+        {
+            const int roll = gen.RandomInt(0, 99);
+            if (roll < density * 6 / 10)
+                p = MakePixel(PixelType::Stone);
+            else if (roll < density * 7 / 10)
+                p = MakePixel(roll % 2 ? PixelType::Sand : PixelType::Water);
+        }
+        PixelEditBuffer edits;
+        const int blobs = gen.RandomInt(0, 12);
+        for (int b = 0; b < blobs; b++)
+        {
+            edits.FillCircle(gen.RandomInt(0, width - 1), gen.RandomInt(0, height - 1), gen.RandomInt(1, 30),
+                             gen.RandomInt(0, 1) ? PixelType::Stone : PixelType::Air);
+        }
+        PixelBufferEditTarget target{pixels.data(), width, height};
+        edits.Apply(target);
+        return pixels;
+    }
+
+    /**
+     * @brief Reference labeling by breadth-first flood fill in raster order of first pixels
+     */
+    inline void FloodFillIslands(const std::vector<GPUPixel>& pixels, int width, const PixelRect& region,
+                                 std::vector<uint32_t>& labels, std::vector<PixelIsland>& islands)
+    {
+        const int rw = region.maxX - region.minX + 1;
+        const int rh = region.maxY - region.minY + 1;
+        labels.assign(static_cast<size_t>(rw) * rh, 0);
+        islands.clear();
+        auto solid = [&](int x, int y)
+        {
+            return pixels[static_cast<size_t>(y + region.minY) * width + x + region.minX].pixel_type == PixelType::Stone;
+        };
+        std::vector<std::pair<int, int>> queue;
+        for (int y = 0; y < rh; y++)
+        {
+            for (int x = 0; x < rw; x++)
+            {
+                if (!solid(x, y) || labels[static_cast<size_t>(y) * rw + x]) continue;
+                PixelIsland island;
+                island.firstIndex = static_cast<uint32_t>(static_cast<size_t>(y) * rw + x);
+                const auto label = static_cast<uint32_t>(islands.size() + 1);
+                queue.assign(1, {x, y});
+                labels[static_cast<size_t>(y) * rw + x] = label;
+                for (size_t q = 0; q < queue.size(); q++)
+                {
+                    const auto [px, py] = queue[q];
+                    island.bounds.Add(px + region.minX, py + region.minY, px + region.minX, py + region.minY);
+                    island.pixelCount++;
+                    island.anchored |= px == 0 || py == 0 || px == rw - 1 || py == rh - 1;
+                    const int nx[] = {px - 1, px + 1, px, px};
+                    const int ny[] = {py, py, py - 1, py + 1};
+                    for (int k = 0; k < 4; k++)
+                    {
+                        if (nx[k] < 0 || ny[k] < 0 || nx[k] >= rw || ny[k] >= rh || !solid(nx[k], ny[k])) continue;
+                        uint32_t& l = labels[static_cast<size_t>(ny[k]) * rw + nx[k]];
+                        if (l) continue;
+                        l = label;
+                        queue.push_back({nx[k], ny[k]});
+                    }
+                }
+                islands.push_back(island);
+            }
+        }
+    }
+
+    inline std::string CompareWithReference(const PixelIslandLabeler& labeler, const std::vector<GPUPixel>& pixels,
+                                            int width, int height, const PixelRect& requested)
+    {
+        std::ostringstream oss;
+        const PixelRect region = requested.Intersect({0, 0, width - 1, height - 1});
+        if (region.Empty())
+        {
+            if (!labeler.GetRegion().Empty() || !labeler.GetIslands().empty())
+                oss << "empty region produced " << labeler.GetIslands().size() << " islands";
+            return oss.str();
+        }
+        const PixelRect& got = labeler.GetRegion();
+        if (got.minX != region.minX || got.minY != region.minY || got.maxX != region.maxX || got.maxY != region.maxY)
+        {
+            oss << "region was not clipped to the pixel buffer";
+            return oss.str();
+        }
+
+        std::vector<uint32_t> labels;
+        std::vector<PixelIsland> islands;
+        FloodFillIslands(pixels, width, region, labels, islands);
+        if (labeler.GetLabels() != labels)
+        {
+            const auto& actual = labeler.GetLabels();
+            const size_t i = static_cast<size_t>(
+                std::mismatch(actual.begin(), actual.end(), labels.begin(), labels.end()).first - actual.begin());
+            const int rw = region.maxX - region.minX + 1;
+            oss << "label at (" << region.minX + static_cast<int>(i % rw) << ", " << region.minY + static_cast<int>(i / rw)
+                << ") is " << (i < actual.size() ? actual[i] : 0) << ", expected " << (i < labels.size() ? labels[i] : 0);
+            return oss.str();
+        }
+        if (labeler.GetIslands().size() != islands.size())
+        {
+            oss << labeler.GetIslands().size() << " islands, expected " << islands.size();
+            return oss.str();
+        }
+        for (size_t k = 0; k < islands.size(); k++)
+        {
+            const PixelIsland& a = labeler.GetIslands()[k];
+            const PixelIsland& b = islands[k];
+            if (a.pixelCount != b.pixelCount || a.firstIndex != b.firstIndex || a.anchored != b.anchored ||
+                a.bounds.minX != b.bounds.minX || a.bounds.minY != b.bounds.minY || a.bounds.maxX != b.bounds.maxX ||
+                a.bounds.maxY != b.bounds.maxY)
+            {
+                oss << "island " << k << " has " << a.pixelCount << " pixels, anchored " << a.anchored << ", bounds ("
+                    << a.bounds.minX << ", " << a.bounds.minY << ")-(" << a.bounds.maxX << ", " << a.bounds.maxY
+                    << "); expected " << b.pixelCount << ", " << b.anchored << ", (" << b.bounds.minX << ", "
+                    << b.bounds.minY << ")-(" << b.bounds.maxX << ", " << b.bounds.maxY << ")";
+                return oss.str();
+            }
+        }
+        const int outsideX = region.minX - 1;
+        if (labeler.GetLabel(outsideX, region.minY) != PixelIslandLabeler::NoLabel)
+            oss << "label outside the region is not NoLabel";
+        return oss.str();
+    }
+
+    /**
+     * Property: labels, island statistics and anchoring match a flood-fill reference
+     *
+     * Random terrain, random regions (some reaching past the buffer or empty) and random tile
+     * sizes from single pixels to larger than the region, so components cross many tile borders.
+     */
+    inline TestResult TestProperty_LabelsMatchFloodFill(int iterations = 60)
+    {
+        TestResult result;
+
+        for (int i = 0; i < iterations; i++)
+        {
+            IslandRandomGenerator gen(48000u + static_cast<unsigned int>(i));
+            const int width = gen.RandomInt(1, 260);
+            const int height = gen.RandomInt(1, 260);
+            const std::vector<GPUPixel> pixels = RandomTerrain(gen, width, height);
+
+            PixelRect region;
+            if (i % 5 == 0)
+            {
+                region = {0, 0, width - 1, height - 1};
+            }
+            else
+            {
+                const int x0 = gen.RandomInt(-40, width);
+                const int y0 = gen.RandomInt(-40, height);
+                region = {x0, y0, x0 + gen.RandomInt(-1, width + 40), y0 + gen.RandomInt(-1, height + 40)};
+            }
+
+            PixelIslandLabeler labeler;
+            static const int tileSizes[] = {1, 2, 5, 16, 33, 64, 100000};
+            labeler.SetTileSize(tileSizes[gen.RandomInt(0, 6)]);
+            labeler.Label(pixels.data(), width, height, region);
+            const std::string failure = CompareWithReference(labeler, pixels, width, height, region);
+            if (!failure.empty())
+            {
+                result.passed = false;
+                result.failureMessage = failure;
+                result.failedIteration = i;
+                return result;
+            }
+        }
+
+        return result;
+    }
+
+    /**
+     * Property: relabeling with the same labeler gives the same result as a fresh one
+     *
+     * The labeler reuses its buffers between calls; a second region of a different size must not
+     * see any state left over from the first.
+     */
+    inline TestResult TestProperty_RelabelingIsIndependent(int iterations = 20)
+    {
+        TestResult result;
+
+        for (int i = 0; i < iterations; i++)
+        {
+            IslandRandomGenerator gen(48100u + static_cast<unsigned int>(i));
+            const int width = gen.RandomInt(16, 200);
+            const int height = gen.RandomInt(16, 200);
+            const std::vector<GPUPixel> pixels = RandomTerrain(gen, width, height);
+
+            PixelIslandLabeler reused;
+            reused.SetTileSize(gen.RandomInt(1, 48));
+            std::string failure;
+            for (int pass = 0; pass < 4 && failure.empty(); pass++)
+            {
+                const int x0 = gen.RandomInt(0, width - 1);
+                const int y0 = gen.RandomInt(0, height - 1);
+                const PixelRect region{x0, y0, gen.RandomInt(x0, width - 1), gen.RandomInt(y0, height - 1)};
+                reused.Label(pixels.data(), width, height, region);
+                failure = CompareWithReference(reused, pixels, width, height, region);
+                if (!failure.empty()) failure = "pass " + std::to_string(pass) + ": " + failure;
+            }
+            if (!failure.empty())
+            {
+                result.passed = false;
+                result.failureMessage = failure;
+                result.failedIteration = i;
+                return result;
+            }
+        }
+
+        return result;
+    }
+
+    /**
+     * Property: a block cut loose by an explosion is the only floating island
+     *
+     * Solid stone terrain gets a ring carved around a random block, either by a thick ring of
+     * explosions or by air rectangles; labeling the edits' dirty bounds plus a margin must report
+     * exactly the block as a non-anchored island, while the surrounding terrain stays anchored.
+     */
+    inline TestResult TestProperty_CutBlockFloats(int iterations = 30)
+    {
+        TestResult result;
+        constexpr int Size = 256;
+        constexpr int Margin = 16;
+
+        for (int i = 0; i < iterations; i++)
+        {
+            IslandRandomGenerator gen(48200u + static_cast<unsigned int>(i));
+            std::vector<GPUPixel> pixels(static_cast<size_t>(Size) * Size, MakePixel(PixelType::Stone));
+            const int bw = gen.RandomInt(3, 40);
+            const int bh = gen.RandomInt(3, 40);
+            const int bx = gen.RandomInt(Margin + 20, Size - Margin - 20 - bw);
+            const int by = gen.RandomInt(Margin + 20, Size - Margin - 20 - bh);
+            const int gap = gen.RandomInt(1, 6);
+
+            PixelEditBuffer edits;
+            edits.FillRect(bx - gap, by - gap, bw + 2 * gap, bh + 2 * gap, PixelType::Air);
+            edits.FillRect(bx, by, bw, bh, PixelType::Stone);
+            PixelBufferEditTarget target{pixels.data(), Size, Size};
+            edits.Apply(target);
+
+            const PixelRect dirty = edits.GetDirtyBounds();
+            PixelIslandLabeler labeler;
+            labeler.Label(pixels.data(), Size, Size,
+                          {dirty.minX - Margin, dirty.minY - Margin, dirty.maxX + Margin, dirty.maxY + Margin});
+
+            std::ostringstream oss;
+            int floating = 0;
+            for (const PixelIsland& island : labeler.GetIslands())
+            {
+                if (island.anchored) continue;
+                floating++;
+                if (island.pixelCount != static_cast<uint32_t>(bw * bh) || island.bounds.minX != bx ||
+                    island.bounds.minY != by || island.bounds.maxX != bx + bw - 1 || island.bounds.maxY != by + bh - 1)
+                    oss << "floating island of " << island.pixelCount << " pixels at (" << island.bounds.minX << ", "
+                        << island.bounds.minY << "), expected the " << bw << "x" << bh << " block at (" << bx << ", "
+                        << by << ")";
+            }
+            if (oss.str().empty() && floating != 1)
+                oss << floating << " floating islands, expected 1";
+            if (oss.str().empty() && labeler.GetIslands().size() != 2)
+                oss << labeler.GetIslands().size() << " islands, expected terrain and block";
+
+            if (!oss.str().empty())
+            {
+                result.passed = false;
+                result.failureMessage = oss.str();
+                result.failedIteration = i;
+                return result;
+            }
+        }
+
+        return result;
+    }
+
+    /**
+     * @brief Benchmark: labeling a large dirty region, tiled parallel vs one tile vs flood fill
+     */
+    inline void RunPixelIslandLabelerBenchmark(int size = 2048, int repeats = 5)
+    {
+        using Clock = std::chrono::steady_clock;
+        LogInfo("=== Pixel Island Labeler Benchmark ({}x{} region) ===", size, size);
+
+        IslandRandomGenerator gen(48300u);
+        std::vector<GPUPixel> pixels(static_cast<size_t>(size) * size, MakePixel(PixelType::Stone));
+        // 洞穴状地形：大量随机空洞，连通块多且形状不规则
+        PixelEditBuffer edits;
+        for (int c = 0; c < size * size / 400; c++)
+            edits.FillCircle(gen.RandomInt(0, size - 1), gen.RandomInt(0, size - 1), gen.RandomInt(2, 12),
+                             PixelType::Air);
+        PixelBufferEditTarget target{pixels.data(), size, size};
+        edits.Apply(target);
+        const PixelRect region{0, 0, size - 1, size - 1};
+
+        auto time = [&](auto&& fn)
+        {
+            const auto start = Clock::now();
+            for (int r = 0; r < repeats; r++)
+                fn();
+            return std::chrono::duration<double, std::milli>(Clock::now() - start).count() / repeats;
+        };
+
+        PixelIslandLabeler tiled;
+        const double tiledMs = time([&] { tiled.Label(pixels.data(), size, size, region); });
+        PixelIslandLabeler single;
+        single.SetTileSize(INT_MAX);
+        const double singleMs = time([&] { single.Label(pixels.data(), size, size, region); });
+        std::vector<uint32_t> labels;
+        std::vector<PixelIsland> islands;
+        const double floodMs = time([&] { FloodFillIslands(pixels, size, region, labels, islands); });
+
+        size_t floating = 0;
+        for (const PixelIsland& island : tiled.GetIslands())
+            floating += island.anchored ? 0 : 1;
+        const double mpix = static_cast<double>(size) * size / 1e6;
+        LogInfo("{} islands ({} floating)", tiled.GetIslands().size(), floating);
+        LogInfo("Tiled ({}px tiles): {:.2f} ms ({:.0f} Mpix/s), one tile: {:.2f} ms, flood fill: {:.2f} ms ({:.1f}x)",
+                PixelIslandLabeler::DefaultTileSize, tiledMs, mpix / (tiledMs / 1000.0), singleMs, floodMs,
+                floodMs / std::max(tiledMs, 1e-3));
+    }
+
+    inline bool RunAllPixelIslandLabelerTests()
+    {
+        bool allPassed = true;
+        allPassed &= RunTest("TestProperty_LabelsMatchFloodFill", TestProperty_LabelsMatchFloodFill());
+        allPassed &= RunTest("TestProperty_RelabelingIsIndependent", TestProperty_RelabelingIsIndependent());
+        allPassed &= RunTest("TestProperty_CutBlockFloats", TestProperty_CutBlockFloats());
+        return allPassed;
+    }
+}
+
+#endif
@@ -0,0 +1,373 @@
+#ifndef PIXEL_SIMULATION_CPU_TESTS_H
+#define PIXEL_SIMULATION_CPU_TESTS_H
+
+/**
+ * @file PixelSimulationCPUTests.h
+ * @brief Property-based tests and benchmark for the multithreaded CPU falling-sand backend
+ *
+ * Chunks are updated in four checkerboard phases across the job pool and only inside their
+ * dirty rectangles. Moves and reactions must conserve material, a fixed seed must reproduce
+ * the same world bit for bit, and once everything has settled every chunk must be asleep
+ * without leaving any pixel that could still move.
+ *
+ * Feature: pixel-simulation-cpu
+ */
+
+#include "../PixelWorld/PixelSimulationCPU.h"
+#include "../../Event/JobSystem.h"
+#include "../../Utils/Logger.h"
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace PixelSimulationCPUTests
+{
+    class SimulationRandomGenerator
+    {
+    public:
+        explicit SimulationRandomGenerator(unsigned int seed) : m_gen(seed) {}
+
+        int RandomInt(int min, int max)
+        {
+            std::uniform_int_distribution<int> dist(min, max);
+            return dist(m_gen);
+        }
+
+        float RandomFloat(float min, float max)
+        {
+            std::uniform_real_distribution<float> dist(min, max);
+            return dist(m_gen);
+        }
+
+    private:
+        std::mt19937 m_gen;
+    };
+
+    /**
+     * @brief Test result structure for detailed failure reporting
+     */
+    struct TestResult
+    {
+        bool passed = true;
+        std::string failureMessage;
+        int failedIteration = -1;
+    };
+
+    inline bool RunTest(const char* name, const TestResult& result)
+    {
+        if (result.passed)
+        {
+            LogInfo("{} PASSED", name);
+            return true;
+        }
+        LogError("{} FAILED at iteration {}: {}", name, result.failedIteration, result.failureMessage);
+        return false;
+    }
+
+    inline GPUPixel MakePixel(PixelType::Value type)
+    {
+        return GPUPixel{static_cast<uint32_t>(type), DefaultPixelColor(type), 0.0f, 0.0f};
+    }
+
+    /**
+     * @brief Random world with the given materials scattered at the given density
+     */
+    inline std::vector<GPUPixel> RandomWorld(SimulationRandomGenerator& gen, int width, int height,
+                                             const std::vector<PixelType::Value>& materials, float density)
+    {
+        std::vector<GPUPixel> pixels(static_cast<size_t>(width) * height, MakePixel(PixelType::Air));
+        for (auto& pixel : pixels)
+        {
+            if (gen.RandomFloat(0.0f, 1.0f) < density)
+                pixel = MakePixel(materials[static_cast<size_t>(gen.RandomInt(0, static_cast<int>(materials.size()) - 1))]);
+        }
+        return pixels;
+    }
+
+    inline std::array<int, 8> CountTypes(const std::vector<GPUPixel>& pixels)
+    {
+        std::array<int, 8> counts{};
+        for (const auto& pixel : pixels)
+            counts[pixel.pixel_type]++;
+        return counts;
+    }
+
+    inline bool SamePixels(const std::vector<GPUPixel>& a, const std::vector<GPUPixel>& b)
+    {
+        return a.size() == b.size() && std::memcmp(a.data(), b.data(), a.size() * sizeof(GPUPixel)) == 0;
+    }
+
+    /**
+     * Property: moving, swapping and reacting never create or destroy material. With dt = 0 fire
+     * and steam never expire, so lava + stone and water + steam are invariant as well
+     */
+    inline TestResult TestProperty_MaterialCountsConserved(int iterations = 30)
+    {
+        TestResult result;
+        SimulationRandomGenerator gen(43001);
+
+        for (int i = 0; i < iterations; ++i)
+        {
+            const bool reactive = i % 2 == 1;
+            const int width = gen.RandomInt(40, 220);
+            const int height = gen.RandomInt(40, 220);
+            const float dt = reactive ? 0.0f : 1.0f / 60.0f;
+            std::vector<PixelType::Value> materials = {PixelType::Sand, PixelType::Water, PixelType::Oil,
+                                                       PixelType::Stone};
+            if (reactive)
+            {
+                materials.push_back(PixelType::Lava);
+                materials.push_back(PixelType::Fire);
+                materials.push_back(PixelType::Steam);
+            }
+            std::vector<GPUPixel> pixels = RandomWorld(gen, width, height, materials, gen.RandomFloat(0.2f, 0.7f));
+            const auto before = CountTypes(pixels);
+
+            PixelSimulationCPU simulation(static_cast<uint32_t>(width), static_cast<uint32_t>(height),
+                                          static_cast<uint32_t>(gen.RandomInt(0, 1000000)));
+            for (int step = 1; step <= 60; ++step)
+            {
+                simulation.Step(pixels.data(), dt);
+                if (step % 10 != 0) continue;
+
+                const auto after = CountTypes(pixels);
+                bool conserved = after[PixelType::Sand] == before[PixelType::Sand] &&
+                                 after[PixelType::Oil] == before[PixelType::Oil] &&
+                                 after[PixelType::Fire] == before[PixelType::Fire] &&
+                                 after[PixelType::Air] == before[PixelType::Air];
+                conserved &= after[PixelType::Stone] + after[PixelType::Lava] ==
+                             before[PixelType::Stone] + before[PixelType::Lava];
+                conserved &= after[PixelType::Water] + after[PixelType::Steam] ==
+                             before[PixelType::Water] + before[PixelType::Steam];
+                if (!reactive)
+                    conserved &= after == before;
+                if (conserved) continue;
+
+                std::ostringstream oss;
+                oss << width << "x" << height << (reactive ? " reactive" : "") << " world changed material counts"
+                    << " after " << step << " steps: sand " << before[PixelType::Sand] << "->"
+                    << after[PixelType::Sand] << ", water " << before[PixelType::Water] << "->"
+                    << after[PixelType::Water] << ", oil " << before[PixelType::Oil] << "->" << after[PixelType::Oil]
+                    << ", air " << before[PixelType::Air] << "->" << after[PixelType::Air];
+                result.passed = false;
+                result.failureMessage = oss.str();
+                result.failedIteration = i;
+                return result;
+            }
+        }
+
+        return result;
+    }
+
+    /**
+     * Property: the same seed and initial world reproduce the same pixels bit for bit, however the
+     * job pool schedules the chunks of each phase
+     */
+    inline TestResult TestProperty_DeterministicForSeed(int iterations = 20)
+    {
+        TestResult result;
+        SimulationRandomGenerator gen(43002);
+        int seedMattered = 0;
+
+        for (int i = 0; i < iterations; ++i)
+        {
+            const int width = gen.RandomInt(64, 320);
+            const int height = gen.RandomInt(64, 320);
+            const auto seed = static_cast<uint32_t>(gen.RandomInt(0, 1000000));
+            const std::vector<GPUPixel> initial =
+                RandomWorld(gen, width, height,
+                            {PixelType::Sand, PixelType::Water, PixelType::Oil, PixelType::Lava, PixelType::Fire},
+                            gen.RandomFloat(0.2f, 0.6f));
+
+            std::vector<GPUPixel> runs[3] = {initial, initial, initial};
+            PixelSimulationCPU first(static_cast<uint32_t>(width), static_cast<uint32_t>(height), seed);
+            PixelSimulationCPU second(static_cast<uint32_t>(width), static_cast<uint32_t>(height), seed);
+            PixelSimulationCPU other(static_cast<uint32_t>(width), static_cast<uint32_t>(height), seed + 1);
+            for (int step = 0; step < 40; ++step)
+            {
+                first.Step(runs[0].data(), 1.0f / 30.0f);
+                second.Step(runs[1].data(), 1.0f / 30.0f);
+                other.Step(runs[2].data(), 1.0f / 30.0f);
+            }
+
+            if (!SamePixels(runs[0], runs[1]))
+            {
+                std::ostringstream oss;
+                oss << width << "x" << height << " seed " << seed << " produced different worlds on two runs";
+                result.passed = false;
+                result.failureMessage = oss.str();
+                result.failedIteration = i;
+                return result;
+            }
+            if (!SamePixels(runs[0], runs[2]))
+                seedMattered++;
+        }
+
+        if (seedMattered == 0)
+        {
+            result.passed = false;
+            result.failureMessage = "changing the seed never changed the result";
+        }
+        return result;
+    }
+
+    /**
+     * Property: once a sand pile settles every chunk sleeps, nothing that could still fall was left
+     * behind, and an edit wakes only the chunks around it
+     */
+    inline TestResult TestProperty_SettledRegionsSleep(int iterations = 10)
+    {
+        TestResult result;
+        SimulationRandomGenerator gen(43003);
+        constexpr int size = PixelSimulationCPU::ChunkSize;
+
+        for (int i = 0; i < iterations; ++i)
+        {
+            const int width = size * gen.RandomInt(3, 5);
+            const int height = size * gen.RandomInt(2, 3);
+            std::vector<GPUPixel> pixels(static_cast<size_t>(width) * height, MakePixel(PixelType::Air));
+            // 随机石台加一团悬空的沙子
+            for (int s = 0; s < 6; ++s)
+            {
+                const int x0 = gen.RandomInt(0, width - 20);
+                const int y0 = gen.RandomInt(height / 2, height - 1);
+                for (int x = x0; x < x0 + gen.RandomInt(4, 20); ++x)
+                    pixels[static_cast<size_t>(y0) * width + x] = MakePixel(PixelType::Stone);
+            }
+            const int sandX = gen.RandomInt(0, width - 40);
+            for (int y = 0; y < 30; ++y)
+                for (int x = sandX; x < sandX + 40; ++x)
+                    if (pixels[static_cast<size_t>(y) * width + x].pixel_type == PixelType::Air)
+                        pixels[static_cast<size_t>(y) * width + x] = MakePixel(PixelType::Sand);
+
+            PixelSimulationCPU simulation(static_cast<uint32_t>(width), static_cast<uint32_t>(height),
+                                          static_cast<uint32_t>(i));
+            int steps = 0;
+            do
+            {
+                simulation.Step(pixels.data(), 1.0f / 60.0f);
+            } while (simulation.GetStats().awakeChunks > 0 && ++steps < 4000);
+
+            auto fail = [&](const std::string& message)
+            {
+                std::ostringstream oss;
+                oss << width << "x" << height << ": " << message;
+                result.passed = false;
+                result.failureMessage = oss.str();
+                result.failedIteration = i;
+            };
+            if (steps >= 4000)
+            {
+                fail("chunks never went to sleep");
+                return result;
+            }
+
+            auto isAir = [&](int x, int y)
+            {
+                return x >= 0 && x < width && y >= 0 && y < height &&
+                       pixels[static_cast<size_t>(y) * width + x].pixel_type == PixelType::Air;
+            };
+            for (int y = 0; y < height; ++y)
+            {
+                for (int x = 0; x < width; ++x)
+                {
+                    if (pixels[static_cast<size_t>(y) * width + x].pixel_type != PixelType::Sand) continue;
+                    if (isAir(x, y + 1) || isAir(x - 1, y + 1) || isAir(x + 1, y + 1))
+                    {
+                        fail("sand at (" + std::to_string(x) + ", " + std::to_string(y) + ") can still fall but its "
+                             "chunk is asleep");
+                        return result;
+                    }
+                }
+            }
+
+            const std::vector<GPUPixel> settled = pixels;
+            for (int step = 0; step < 10; ++step)
+                simulation.Step(pixels.data(), 1.0f / 60.0f);
+            if (!SamePixels(settled, pixels) || simulation.GetStats().pixelsVisited != 0)
+            {
+                fail("settled world was still updated");
+                return result;
+            }
+
+            // 在左上角区块落一粒沙，只有它所在的区块醒来
+            pixels[0] = MakePixel(PixelType::Sand);
+            simulation.MarkDirty(-1, -1, 1, 1);
+            simulation.Step(pixels.data(), 1.0f / 60.0f);
+            const auto& stats = simulation.GetStats();
+            if (stats.awakeChunks != 1 || stats.pixelsVisited > 4 || !simulation.IsChunkAwake(0, 0) ||
+                simulation.IsChunkAwake(simulation.GetChunksX() - 1, simulation.GetChunksY() - 1))
+            {
+                fail("a single edit woke " + std::to_string(stats.awakeChunks) + " chunks and visited " +
+                     std::to_string(stats.pixelsVisited) + " pixels");
+                return result;
+            }
+        }
+
+        return result;
+    }
+
+    /**
+     * @brief Benchmark: simulated pixels per second with and without sleeping chunks
+     */
+    inline void RunPixelSimulationBenchmark(int size = 1024, int frames = 120)
+    {
+        using Clock = std::chrono::steady_clock;
+        LogInfo("=== CPU Pixel Simulation Benchmark ({} job threads, {} hardware threads) ===",
+                JobSystem::GetInstance().GetThreadCount(), std::thread::hardware_concurrency());
+
+        // 上半部分随机的沙和水，落在石头地面上
+        SimulationRandomGenerator gen(43100);
+        std::vector<GPUPixel> initial(static_cast<size_t>(size) * size, MakePixel(PixelType::Air));
+        for (int y = 0; y < size; ++y)
+        {
+            for (int x = 0; x < size; ++x)
+            {
+                GPUPixel& pixel = initial[static_cast<size_t>(y) * size + x];
+                if (y >= size - size / 8)
+                    pixel = MakePixel(PixelType::Stone);
+                else if (y < size / 2 && gen.RandomFloat(0.0f, 1.0f) < 0.4f)
+                    pixel = MakePixel(gen.RandomInt(0, 1) == 0 ? PixelType::Sand : PixelType::Water);
+            }
+        }
+
+        for (const bool sleeping : {false, true})
+        {
+            std::vector<GPUPixel> pixels = initial;
+            PixelSimulationCPU simulation(static_cast<uint32_t>(size), static_cast<uint32_t>(size));
+            uint64_t visited = 0;
+            const auto t0 = Clock::now();
+            for (int frame = 0; frame < frames; ++frame)
+            {
+                if (!sleeping)
+                    simulation.WakeAll();
+                simulation.Step(pixels.data(), 1.0f / 60.0f);
+                visited += simulation.GetStats().pixelsVisited;
+            }
+            const double seconds = std::chrono::duration<double>(Clock::now() - t0).count();
+            const double worldPixels = static_cast<double>(size) * size * frames;
+            LogInfo("{}x{} for {} frames, {}: {:.1f} Mpixels/s simulated, {:.1f} Mpixels/s visited, {:.0f}% of "
+                    "pixels visited", size, size, frames, sleeping ? "dirty rectangles" : "always awake",
+                    worldPixels / seconds / 1e6, visited / seconds / 1e6, 100.0 * visited / worldPixels);
+        }
+    }
+
+    /**
+     * @brief Run all CPU pixel simulation tests
+     */
+    inline bool RunAllPixelSimulationCPUTests()
+    {
+        bool allPassed = true;
+        allPassed &= RunTest("Material Counts Conserved", TestProperty_MaterialCountsConserved());
+        allPassed &= RunTest("Deterministic For Seed", TestProperty_DeterministicForSeed());
+        allPassed &= RunTest("Settled Regions Sleep", TestProperty_SettledRegionsSleep());
+        return allPassed;
+    }
+}
+
+#endif
@@ -0,0 +1,441 @@
+#ifndef PIXEL_TOROIDAL_WINDOW_TESTS_H
+#define PIXEL_TOROIDAL_WINDOW_TESTS_H
+
+/**
+ * @file PixelToroidalWindowTests.h
+ * @brief Property-based tests and benchmark for the toroidally addressed pixel simulation window
+ *
+ * The active simulation buffer of ChunkedPixelWorld keeps every chunk in a fixed slot and only
+ * moves its origin when the view scrolls, so a move rewrites the entering chunks and reads back
+ * the leaving ones instead of copying the whole window. Content that stays inside the window must
+ * evolve exactly as it would under a static window, and the CPU backend must give the same result
+ * for content away from the seam at every origin.
+ *
+ * Feature: pixel-toroidal-window
+ */
+
+#include "../PixelWorld/ChunkedPixelWorld.h"
+#include "../PixelWorld/PixelSimulationCPU.h"
+#include "../../Utils/Logger.h"
+#include <algorithm>
+#include <chrono>
+#include <iterator>
+#include <cstdlib>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace PixelToroidalWindowTests
+{
+    class WindowRandomGenerator
+    {
+    public:
+        explicit WindowRandomGenerator(unsigned int seed) : m_gen(seed) {}
+
+        int RandomInt(int min, int max)
+        {
+            std::uniform_int_distribution<int> dist(min, max);
+            return dist(m_gen);
+        }
+
+    private:
+        std::mt19937 m_gen;
+    };
+
+    /**
+     * @brief Test result structure for detailed failure reporting
+     */
+    struct TestResult
+    {
+        bool passed = true;
+        std::string failureMessage;
+        int failedIteration = -1;
+    };
+
+    inline bool RunTest(const char* name, const TestResult& result)
+    {
+        if (result.passed)
+        {
+            LogInfo("{} PASSED", name);
+            return true;
+        }
+        LogError("{} FAILED at iteration {}: {}", name, result.failedIteration, result.failureMessage);
+        return false;
+    }
+
+    inline GPUPixel MakePixel(PixelType::Value type)
+    {
+        return GPUPixel{static_cast<uint32_t>(type), DefaultPixelColor(type), 0.0f, 0.0f};
+    }
+
+    inline PixelType::Value RandomMaterial(WindowRandomGenerator& gen)
+    {
+        static const PixelType::Value types[] = {PixelType::Air,  PixelType::Air,   PixelType::Sand,
+                                                 PixelType::Sand, PixelType::Water, PixelType::Stone,
+                                                 PixelType::Fire, PixelType::Oil,   PixelType::Lava};
+        return types[gen.RandomInt(0, static_cast<int>(std::size(types)) - 1)];
+    }
+
+    /**
+     * @brief 在两个世界中按同样顺序应用的编辑：先用石墙围出封闭的盒子，之后只在盒子内部放置材料
+     */
+    inline void RecordBoxEdits(WindowRandomGenerator& gen, PixelEditBuffer& edits, const PixelRect& box, bool build)
+    {
+        if (build)
+        {
+            edits.FillRect(box.minX - 4, box.minY - 4, box.maxX - box.minX + 9, box.maxY - box.minY + 9,
+                           PixelType::Stone);
+            edits.FillRect(box.minX, box.minY, box.maxX - box.minX + 1, box.maxY - box.minY + 1, PixelType::Air);
+        }
+        const int shapes = gen.RandomInt(1, 4);
+        for (int s = 0; s < shapes; s++)
+        {
+            const int r = gen.RandomInt(3, 24);
+            const int x = gen.RandomInt(box.minX + r, box.maxX - r);
+            const int y = gen.RandomInt(box.minY + r, box.maxY - r);
+            edits.FillCircle(x, y, r, RandomMaterial(gen));
+        }
+    }
+
+    /**
+     * Property: a world simulated while the window scrolls matches one simulated with a static window
+     *
+     * Both worlds get the same sealed box of random materials near the origin and the same edits
+     * inside it. One window stays centred on chunk (0, 0); the other takes a random walk of single
+     * chunk steps (including diagonals) that always keeps the box well inside the window, so every
+     * move rewrites and evicts only the edge chunks and the box crosses the buffer's wrap edge.
+     * After flushing, every chunk both windows always cover must match pixel for pixel.
+     */
+    inline TestResult TestProperty_ScrollingWindowMatchesStaticWindow(int iterations = 4)
+    {
+        TestResult result;
+        constexpr int C = ChunkedPixelWorld::CHUNK_SIZE;
+        constexpr float Dt = 1.0f / 60.0f;
+        // 滚动窗口中心限制在 [-1, 1]，区块 [-2, 2] 始终在窗口内；进出窗口的区块只会波及盒子外的 CPU 区块
+        const PixelRect box{-60, -60, C + 59, C + 59};
+        auto centre = [](int c) { return static_cast<float>(c * C + C / 2); };
+
+        for (int i = 0; i < iterations; i++)
+        {
+            WindowRandomGenerator gen(46000u + static_cast<unsigned int>(i));
+            ChunkedPixelWorld scrolling;
+            ChunkedPixelWorld fixed;
+            scrolling.Initialize(nullptr);
+            fixed.Initialize(nullptr);
+            fixed.SetViewCenter(centre(0), centre(0), 1.0f);
+
+            int centerCX = gen.RandomInt(-1, 1);
+            int centerCY = gen.RandomInt(-1, 1);
+            scrolling.SetViewCenter(centre(centerCX), centre(centerCY), 1.0f);
+
+            const int steps = 24;
+            for (int step = 0; step < steps; step++)
+            {
+                if (step > 0)
+                {
+                    centerCX = std::clamp(centerCX + gen.RandomInt(-1, 1), -1, 1);
+                    centerCY = std::clamp(centerCY + gen.RandomInt(-1, 1), -1, 1);
+                    scrolling.SetViewCenter(centre(centerCX), centre(centerCY), 1.0f);
+                }
+
+                if (step == 0 || gen.RandomInt(0, 2) == 0)
+                {
+                    PixelEditBuffer edits;
+                    RecordBoxEdits(gen, edits, box, step == 0);
+                    scrolling.ApplyEdits(edits);
+                    fixed.ApplyEdits(edits);
+                }
+                if (gen.RandomInt(0, 3) == 0)
+                {
+                    const int x = gen.RandomInt(box.minX, box.maxX);
+                    const int y = gen.RandomInt(box.minY, box.maxY);
+                    const PixelType::Value type = RandomMaterial(gen);
+                    scrolling.SetPixel(x, y, type);
+                    fixed.SetPixel(x, y, type);
+                }
+
+                const int frames = gen.RandomInt(1, 8);
+                for (int f = 0; f < frames; f++)
+                {
+                    scrolling.Step(Dt);
+                    fixed.Step(Dt);
+                }
+            }
+            scrolling.FlushActiveChunks();
+            fixed.FlushActiveChunks();
+
+            for (int y = -2 * C; y < 3 * C; y++)
+            {
+                for (int x = -2 * C; x < 3 * C; x++)
+                {
+                    const uint32_t expected = fixed.GetPixel(x, y);
+                    const uint32_t actual = scrolling.GetPixel(x, y);
+                    if (expected != actual)
+                    {
+                        std::ostringstream oss;
+                        oss << "pixel (" << x << ", " << y << ") is type " << actual << ", expected " << expected;
+                        result.passed = false;
+                        result.failureMessage = oss.str();
+                        result.failedIteration = i;
+                        return result;
+                    }
+                }
+            }
+        }
+
+        return result;
+    }
+
+    /**
+     * Property: after any walk the window's edges are walls at the view's own chunk bounds
+     *
+     * The window wanders through the empty sky with single-chunk steps and jumps. Sand grains
+     * dropped inside must fall one pixel per frame and stop on the window's bottom row, and water
+     * penned against either side wall must not leak across it. An edit whose dirty rectangle covers
+     * a whole chunk afterwards must not bring back stale chunk storage, and the result must survive
+     * both an explicit flush and the window moving away.
+     */
+    inline TestResult TestProperty_WindowEdgesFollowView(int iterations = 12)
+    {
+        TestResult result;
+        constexpr int C = ChunkedPixelWorld::CHUNK_SIZE;
+        constexpr int Radius = 3;
+        constexpr int Size = (2 * Radius + 1) * C;
+        constexpr float Dt = 1.0f / 60.0f;
+        auto centre = [](int c) { return static_cast<float>(c * C + C / 2); };
+
+        for (int i = 0; i < iterations; i++)
+        {
+            WindowRandomGenerator gen(46200u + static_cast<unsigned int>(i));
+            ChunkedPixelWorld world;
+            world.Initialize(nullptr);
+
+            // 窗口始终在 y <= 0 的空气中
+            int centerCX = gen.RandomInt(-20, 20);
+            int centerCY = gen.RandomInt(-14, -8);
+            const int moves = gen.RandomInt(1, 8);
+            for (int m = 0; m < moves; m++)
+            {
+                world.SetViewCenter(centre(centerCX), centre(centerCY), 1.0f);
+                if (gen.RandomInt(0, 3) == 0)
+                {
+                    centerCX += gen.RandomInt(-12, 12);
+                    centerCY = gen.RandomInt(-14, -8);
+                }
+                else
+                {
+                    centerCX += gen.RandomInt(-1, 1);
+                    centerCY = std::clamp(centerCY + gen.RandomInt(-1, 1), -14, -8);
+                }
+            }
+            world.SetViewCenter(centre(centerCX), centre(centerCY), 1.0f);
+
+            const int left = (centerCX - Radius) * C;
+            const int top = (centerCY - Radius) * C;
+            const int bottom = top + Size - 1;
+            const int frames = gen.RandomInt(1, 40);
+
+            // 每四列一粒沙，远离两侧的水
+            struct Grain
+            {
+                int x;
+                int startY;
+                int endY;
+            };
+            std::vector<Grain> grains;
+            for (int x = left + 50; x < left + Size - 50; x += 4)
+            {
+                if (gen.RandomInt(0, 3) != 0) continue;
+                const int y = gen.RandomInt(top, bottom);
+                world.SetPixel(x, y, PixelType::Sand);
+                grains.push_back({x, y, std::min(y + frames, bottom)});
+            }
+            // 两侧各一格被石头挡住的水，只有越过窗口侧边才能移动
+            const int right = left + Size - 1;
+            world.SetPixel(left, bottom, PixelType::Water);
+            world.SetPixel(left + 1, bottom, PixelType::Stone);
+            world.SetPixel(right, bottom, PixelType::Stone);
+            world.SetPixel(right - 1, bottom, PixelType::Stone);
+            world.SetPixel(right - 1, bottom - 1, PixelType::Stone);
+            world.SetPixel(right, bottom - 1, PixelType::Water);
+
+            for (int f = 0; f < frames; f++)
+                world.Step(Dt);
+
+            // 区块两角各放一块石头，脏矩形覆盖整个区块：区块存储若没先与模拟同步，沙粒会在起点重新出现
+            if (!grains.empty())
+            {
+                const int chunkX = (grains.front().x - left) / C * C + left;
+                const int chunkY = (grains.front().startY - top) / C * C + top;
+                PixelEditBuffer edits;
+                edits.FillRect(chunkX, chunkY, 1, 1, PixelType::Stone);
+                edits.FillRect(chunkX + C - 1, chunkY + C - 1, 1, 1, PixelType::Stone);
+                world.ApplyEdits(edits);
+            }
+            // 一半迭代显式回读，另一半把窗口移走，靠离开窗口时的回读
+            if (i % 2 == 0)
+                world.FlushActiveChunks();
+            else
+                world.SetViewCenter(centre(centerCX + 2 * Radius + 1), centre(centerCY), 1.0f);
+
+            std::ostringstream oss;
+            int sand = 0;
+            world.VisitPixelTypes(left, top, right, bottom,
+                                  [&](uint32_t type)
+                                  {
+                                      sand += type == PixelType::Sand ? 1 : 0;
+                                      return true;
+                                  });
+            if (sand != static_cast<int>(grains.size()))
+                oss << "found " << sand << " sand pixels in the window, expected " << grains.size();
+            for (const Grain& grain : grains)
+            {
+                if (!oss.str().empty()) break;
+                if (world.GetPixel(grain.x, grain.endY) != PixelType::Sand)
+                {
+                    oss << "sand grain dropped at (" << grain.x << ", " << grain.startY << ") expected at y "
+                        << grain.endY << " after " << frames << " frames, window top-left (" << left << ", " << top
+                        << ")";
+                }
+            }
+            const bool waterStayed = world.GetPixel(left, bottom) == PixelType::Water &&
+                                     world.GetPixel(right, bottom - 1) == PixelType::Water;
+            if (oss.str().empty() && !waterStayed)
+                oss << "water next to the window's side walls moved, window top-left (" << left << ", " << top << ")";
+            if (!oss.str().empty())
+            {
+                result.passed = false;
+                result.failureMessage = oss.str();
+                result.failedIteration = i;
+                return result;
+            }
+        }
+
+        return result;
+    }
+
+    /**
+     * Property: moving the CPU backend's origin does not change content away from the seam
+     *
+     * Two simulations share a buffer layout with a sealed box of random materials and empty air
+     * around it. One keeps its origin at (0, 0); the other jumps between origins that are
+     * multiples of 2 * ChunkSize and keep the seam away from the box, carrying its sleep state
+     * through each move. The box must evolve identically in both.
+     */
+    inline TestResult TestProperty_OriginShiftKeepsSealedContent(int iterations = 20)
+    {
+        TestResult result;
+        constexpr int Size = 16 * PixelSimulationCPU::ChunkSize;
+        constexpr int OriginStep = 2 * PixelSimulationCPU::ChunkSize;
+        constexpr float Dt = 1.0f / 60.0f;
+        // 接缝两侧的 CPU 区块与盒子所在的区块不相交
+        static const int origins[] = {0, 1, 4, 5, 6, 7};
+        const PixelRect box{200, 200, 380, 380};
+
+        for (int i = 0; i < iterations; i++)
+        {
+            WindowRandomGenerator gen(46100u + static_cast<unsigned int>(i));
+            std::vector<GPUPixel> plainPixels(static_cast<size_t>(Size) * Size, MakePixel(PixelType::Air));
+            for (int y = box.minY - 4; y <= box.maxY + 4; y++)
+            {
+                for (int x = box.minX - 4; x <= box.maxX + 4; x++)
+                {
+                    const bool inside = x >= box.minX && x <= box.maxX && y >= box.minY && y <= box.maxY;
+                    plainPixels[static_cast<size_t>(y) * Size + x] =
+                        MakePixel(inside ? RandomMaterial(gen) : PixelType::Stone);
+                }
+            }
+            std::vector<GPUPixel> shiftedPixels = plainPixels;
+
+            PixelSimulationCPU plain(Size, Size, 5u);
+            PixelSimulationCPU shifted(Size, Size, 5u);
+            auto pick = [&]() { return static_cast<uint32_t>(origins[gen.RandomInt(0, 5)] * OriginStep); };
+            shifted.SetOrigin(pick(), pick());
+            shifted.WakeAll();
+
+            for (int segment = 0; segment < 6; segment++)
+            {
+                if (segment > 0)
+                    shifted.SetOrigin(pick(), pick());
+
+                const int frames = gen.RandomInt(1, 10);
+                for (int f = 0; f < frames; f++)
+                {
+                    plain.Step(plainPixels.data(), Dt);
+                    shifted.Step(shiftedPixels.data(), Dt);
+                }
+
+                for (size_t p = 0; p < plainPixels.size(); p++)
+                {
+                    const GPUPixel& a = shiftedPixels[p];
+                    const GPUPixel& b = plainPixels[p];
+                    if (a.pixel_type != b.pixel_type || a.color != b.color)
+                    {
+                        std::ostringstream oss;
+                        oss << "segment " << segment << " origin (" << shifted.GetOriginX() << ", "
+                            << shifted.GetOriginY() << ") pixel (" << p % Size << ", " << p / Size << ") is type "
+                            << a.pixel_type << ", expected " << b.pixel_type;
+                        result.passed = false;
+                        result.failureMessage = oss.str();
+                        result.failedIteration = i;
+                        return result;
+                    }
+                }
+            }
+        }
+
+        return result;
+    }
+
+    /**
+     * @brief Benchmark: window moves by one chunk, full window copy vs toroidal slot update
+     */
+    inline void RunPixelToroidalWindowBenchmark(int moves = 64)
+    {
+        using Clock = std::chrono::steady_clock;
+        constexpr int C = ChunkedPixelWorld::CHUNK_SIZE;
+        LogInfo("=== Pixel Toroidal Window Benchmark ({} single-chunk moves) ===", moves);
+
+        ChunkedPixelWorld world;
+        world.Initialize(nullptr);
+        world.SetViewCenter(C / 2, C / 2, 1.0f);
+        // 先走一遍生成所有区块，计时只包含窗口移动本身
+        for (int m = 1; m <= moves; m++)
+            world.SetViewCenter(static_cast<float>(m * C + C / 2), C / 2, 1.0f);
+        world.SetViewCenter(C / 2, C / 2, 1.0f);
+
+        auto start = Clock::now();
+        for (int m = 1; m <= moves; m++)
+            world.SetViewCenter(static_cast<float>(m * C + C / 2), C / 2, 1.0f);
+        const double toroidalMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+        // 旧做法：每次移动整窗回读再整窗写入
+        const int size = static_cast<int>(world.GetActiveWidth());
+        PixelWorld full(static_cast<uint32_t>(size), static_cast<uint32_t>(size), PixelSimulationBackend::CPU);
+        std::vector<GPUPixel> chunks(static_cast<size_t>(size) * size);
+        start = Clock::now();
+        for (int m = 1; m <= moves; m++)
+        {
+            std::copy(full.GetPixels(), full.GetPixels() + chunks.size(), chunks.begin());
+            full.WritePixels(0, 0, size, size, chunks.data(), static_cast<size_t>(size));
+        }
+        const double fullMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+        LogInfo("Full window copy: {:.3f} ms/move, toroidal slots: {:.3f} ms/move ({:.1f}x)", fullMs / moves,
+                toroidalMs / moves, fullMs / std::max(toroidalMs, 1e-3));
+    }
+
+    inline bool RunAllPixelToroidalWindowTests()
+    {
+        bool allPassed = true;
+        allPassed &= RunTest("TestProperty_ScrollingWindowMatchesStaticWindow",
+                             TestProperty_ScrollingWindowMatchesStaticWindow());
+        allPassed &= RunTest("TestProperty_WindowEdgesFollowView", TestProperty_WindowEdgesFollowView());
+        allPassed &= RunTest("TestProperty_OriginShiftKeepsSealedContent",
+                             TestProperty_OriginShiftKeepsSealedContent());
+        return allPassed;
+    }
+}
+
+#endif
@@ -0,0 +1,590 @@
+#ifndef REGION_STORE_TESTS_H
+#define REGION_STORE_TESTS_H
+
+/**
+ * @file RegionStoreTests.h
+ * @brief Property-based tests and benchmark for region-file persistence of streamed chunks
+ *
+ * Feature: region-file-persistence
+ */
+
+#include "ChunkStreamingTests.h"
+#include "../WorldStreaming/RegionStore.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace RegionStoreTests
+{
+    using ChunkStreamingTests::StreamingRandomGenerator;
+    using ChunkStreamingTests::TestResult;
+    using WorldStreaming::Chunk;
+    using WorldStreaming::ChunkCoord;
+    using WorldStreaming::RegionStore;
+    namespace RegionFormat = WorldStreaming::RegionFormat;
+
+    constexpr size_t TileCount = static_cast<size_t>(Chunk::SIZE) * Chunk::SIZE;
+    constexpr std::chrono::milliseconds TestBatchDelay{1};
+
+    /**
+     * @brief Scratch directory removed on destruction
+     */
+    class ScratchDirectory
+    {
+    public:
+        explicit ScratchDirectory(const char* name)
+        {
+            static std::atomic<int> counter{0};
+            m_path = std::filesystem::temp_directory_path() /
+                (std::string("luma_") + name + "_" + std::to_string(counter++) + "_" +
+                 std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()));
+            std::filesystem::create_directories(m_path);
+        }
+
+        ~ScratchDirectory()
+        {
+            std::error_code ec;
+            std::filesystem::remove_all(m_path, ec);
+        }
+
+        const std::filesystem::path& Path() const { return m_path; }
+
+    private:
+        std::filesystem::path m_path;
+    };
+
+    /**
+     * @brief Random chunk content: uniform, horizontal strata (terrain-like), sparse edits or noise
+     */
+    inline std::vector<uint16_t> RandomTiles(StreamingRandomGenerator& gen)
+    {
+        std::vector<uint16_t> tiles(TileCount, 0);
+        switch (gen.RandomInt(0, 3))
+        {
+        case 0:
+            std::fill(tiles.begin(), tiles.end(), static_cast<uint16_t>(gen.RandomInt(0, 65535)));
+            break;
+        case 1:
+        {
+            int surface = gen.RandomInt(0, Chunk::SIZE);
+            for (int x = 0; x < Chunk::SIZE; ++x)
+            {
+                surface = std::clamp(surface + gen.RandomInt(-2, 2), 0, Chunk::SIZE);
+                for (int y = surface; y < Chunk::SIZE; ++y)
+                    tiles[static_cast<size_t>(y) * Chunk::SIZE + x] = y - surface < 4 ? 1 : 4;
+            }
+            break;
+        }
+        case 2:
+            for (int k = gen.RandomInt(0, 200); k > 0; --k)
+                tiles[static_cast<size_t>(gen.RandomInt(0, static_cast<int>(TileCount) - 1))] =
+                    static_cast<uint16_t>(gen.RandomInt(1, 8));
+            break;
+        default:
+            for (auto& tile : tiles)
+                tile = static_cast<uint16_t>(gen.RandomInt(0, 65535));
+            break;
+        }
+        return tiles;
+    }
+
+    inline ChunkCoord RandomCoord(StreamingRandomGenerator& gen, int regions)
+    {
+        const int extent = regions * RegionFormat::RegionSize;
+        return {gen.RandomInt(-extent, extent - 1), gen.RandomInt(-extent, extent - 1)};
+    }
+
+    /**
+     * @brief Property: saved chunks load back bit-exact, from the write queue before Flush and from a fresh store
+     * (region files through mmap) afterwards; later saves win; stale temp files from an interrupted write are ignored
+     */
+    inline TestResult TestProperty_RoundTrip(int iterations = 60)
+    {
+        TestResult result;
+        StreamingRandomGenerator gen(44u);
+
+        const auto fail = [&](int i, const std::string& message)
+        {
+            result.passed = false;
+            result.failedIteration = i;
+            result.failureMessage = message;
+            return result;
+        };
+
+        for (int i = 0; i < iterations; ++i)
+        {
+            // 编解码本身
+            const std::vector<uint16_t> sample = RandomTiles(gen);
+            RegionFormat::Encoding encoding;
+            const std::vector<uint8_t> encoded = RegionFormat::EncodeTiles(sample, encoding);
+            std::vector<uint16_t> decoded;
+            if (!RegionFormat::DecodeTiles(encoded.data(), encoded.size(), encoding, decoded) || decoded != sample)
+                return fail(i, "EncodeTiles/DecodeTiles round trip failed");
+            if (encoded.size() > TileCount * sizeof(uint16_t))
+                return fail(i, "encoding larger than raw tiles");
+
+            ScratchDirectory directory("region_roundtrip");
+            std::unordered_map<ChunkCoord, std::vector<uint16_t>, WorldStreaming::ChunkCoordHash> expected;
+            const int regions = gen.RandomInt(1, 2);
+            {
+                RegionStore store(directory.Path(), TestBatchDelay);
+                const int saves = gen.RandomInt(1, 80);
+                for (int s = 0; s < saves; ++s)
+                {
+                    // 重复坐标覆盖旧版本
+                    const ChunkCoord coord = !expected.empty() && gen.RandomInt(0, 4) == 0
+                                                 ? expected.begin()->first
+                                                 : RandomCoord(gen, regions);
+                    expected[coord] = RandomTiles(gen);
+                    store.Save(coord, expected[coord]);
+                    if (gen.RandomInt(0, 9) == 0) store.Flush();
+
+                    std::vector<uint16_t> tiles;
+                    if (!store.Load(coord, tiles) || tiles != expected[coord])
+                        return fail(i, "chunk not readable right after Save");
+                }
+                store.Flush();
+                if (store.GetPendingCount() != 0) return fail(i, "Flush left chunks queued");
+                const auto stats = store.GetStats();
+                if (stats.writeFailures != 0 || stats.corruptChunks != 0)
+                    return fail(i, "unexpected write failure or corruption");
+            }
+
+            // 模拟写到一半崩溃留下的临时文件
+            for (const auto& entry : std::filesystem::directory_iterator(directory.Path()))
+            {
+                std::ofstream garbage(entry.path().string() + ".tmp", std::ios::binary);
+                garbage << "interrupted write";
+            }
+
+            RegionStore reopened(directory.Path(), TestBatchDelay);
+            for (const auto& [coord, tiles] : expected)
+            {
+                std::vector<uint16_t> loaded;
+                if (!reopened.Load(coord, loaded) || loaded != tiles)
+                {
+                    std::ostringstream oss;
+                    oss << "chunk (" << coord.x << "," << coord.y << ") did not round trip through region files";
+                    return fail(i, oss.str());
+                }
+            }
+            for (int k = 0; k < 20; ++k)
+            {
+                const ChunkCoord coord = RandomCoord(gen, regions + 1);
+                std::vector<uint16_t> loaded;
+                if (!expected.contains(coord) && reopened.Load(coord, loaded))
+                    return fail(i, "never-saved chunk loaded");
+            }
+        }
+        return result;
+    }
+
+    /**
+     * @brief Property: flipping any byte or truncating a region file never yields wrong tiles; damaged chunks
+     * report missing and undamaged ones still load, and the next save repairs the file
+     */
+    inline TestResult TestProperty_CorruptionDetected(int iterations = 100)
+    {
+        TestResult result;
+        StreamingRandomGenerator gen(45u);
+
+        for (int i = 0; i < iterations; ++i)
+        {
+            ScratchDirectory directory("region_corrupt");
+            std::unordered_map<ChunkCoord, std::vector<uint16_t>, WorldStreaming::ChunkCoordHash> expected;
+            {
+                RegionStore store(directory.Path(), TestBatchDelay);
+                for (int s = gen.RandomInt(1, 30); s > 0; --s)
+                {
+                    const ChunkCoord coord{gen.RandomInt(0, RegionFormat::RegionSize - 1),
+                                           gen.RandomInt(0, RegionFormat::RegionSize - 1)};
+                    expected[coord] = RandomTiles(gen);
+                    store.Save(coord, expected[coord]);
+                }
+            }
+
+            const auto path = RegionFormat::RegionPath(directory.Path(), {0, 0});
+            const auto size = static_cast<size_t>(std::filesystem::file_size(path));
+            const bool truncate = gen.RandomInt(0, 4) == 0;
+            size_t damaged = 0;
+            if (truncate)
+            {
+                damaged = static_cast<size_t>(gen.RandomInt(0, static_cast<int>(size) - 1));
+                std::filesystem::resize_file(path, damaged);
+            }
+            else
+            {
+                // 一半落在头部与偏移表，一半落在区块数据
+                damaged = gen.RandomInt(0, 1) == 0
+                              ? static_cast<size_t>(gen.RandomInt(0, static_cast<int>(RegionFormat::DataOffset) - 1))
+                              : static_cast<size_t>(gen.RandomInt(static_cast<int>(RegionFormat::DataOffset),
+                                                                  static_cast<int>(size) - 1));
+                std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+                file.seekg(static_cast<std::streamoff>(damaged));
+                char byte = 0;
+                file.read(&byte, 1);
+                byte = static_cast<char>(byte ^ (1 << gen.RandomInt(0, 7)));
+                file.seekp(static_cast<std::streamoff>(damaged));
+                file.write(&byte, 1);
+            }
+
+            RegionStore store(directory.Path(), TestBatchDelay);
+            std::vector<ChunkCoord> intact;
+            for (const auto& [coord, tiles] : expected)
+            {
+                std::vector<uint16_t> loaded;
+                if (!store.Load(coord, loaded)) continue;
+                if (loaded != tiles)
+                {
+                    std::ostringstream oss;
+                    oss << "damaged file returned wrong tiles (" << (truncate ? "truncated to " : "flipped byte ")
+                        << damaged << " of " << size << ")";
+                    result.passed = false;
+                    result.failedIteration = i;
+                    result.failureMessage = oss.str();
+                    return result;
+                }
+                intact.push_back(coord);
+            }
+            if (!truncate && intact.size() == expected.size())
+            {
+                std::ostringstream oss;
+                oss << "flipped byte " << damaged << " of " << size << " went unnoticed";
+                result.passed = false;
+                result.failedIteration = i;
+                result.failureMessage = oss.str();
+                return result;
+            }
+
+            // 再保存一次会重写整个文件：损坏的区块被丢弃，完好的区块保留
+            const ChunkCoord fresh{RegionFormat::RegionSize - 1, RegionFormat::RegionSize - 1};
+            const std::vector<uint16_t> freshTiles = RandomTiles(gen);
+            store.Save(fresh, freshTiles);
+            store.Flush();
+            RegionStore repaired(directory.Path(), TestBatchDelay);
+            std::vector<uint16_t> loaded;
+            bool repairedOk = repaired.Load(fresh, loaded) && loaded == freshTiles;
+            for (const auto& coord : intact)
+            {
+                if (coord == fresh) continue;
+                repairedOk = repairedOk && repaired.Load(coord, loaded) && loaded == expected[coord];
+            }
+            if (!repairedOk || repaired.GetStats().corruptChunks != 0)
+            {
+                result.passed = false;
+                result.failedIteration = i;
+                result.failureMessage = "rewrite after corruption lost intact chunks or the new chunk";
+                return result;
+            }
+        }
+        return result;
+    }
+
+    /**
+     * @brief Tiles stamped with a chunk coordinate and a version, so readers can recognise torn or stale data
+     */
+    inline std::vector<uint16_t> VersionedTiles(ChunkCoord coord, uint16_t version)
+    {
+        std::vector<uint16_t> tiles(TileCount);
+        for (size_t t = 0; t < TileCount; ++t)
+            tiles[t] = static_cast<uint16_t>(version * 31u + static_cast<uint32_t>(coord.x) * 7u +
+                                             static_cast<uint32_t>(coord.y) * 13u + (t / 97) % 3);
+        tiles[0] = version;
+        return tiles;
+    }
+
+    /**
+     * @brief Property: threads saving and loading chunks of shared regions concurrently always read a complete
+     * version that never goes backwards, also while the region mapping cache evicts, and the last version of
+     * every chunk is on disk after Flush
+     */
+    inline TestResult TestProperty_ConcurrentLoadSave(int iterations = 10)
+    {
+        TestResult result;
+        StreamingRandomGenerator gen(46u);
+
+        for (int i = 0; i < iterations; ++i)
+        {
+            ScratchDirectory directory("region_concurrent");
+            // Odd iterations give every chunk its own region, more than the mapping cache holds, so readers
+            // evict mappings while other readers are still decoding from them
+            const bool spread = i % 2 == 1;
+            const int writers = gen.RandomInt(2, 4);
+            const int chunksPerWriter = spread ? gen.RandomInt(20, 30) : gen.RandomInt(2, 6);
+            const int versions = spread ? gen.RandomInt(5, 10) : gen.RandomInt(20, 60);
+            std::vector<ChunkCoord> coords;
+            for (int c = 0; c < writers * chunksPerWriter; ++c)
+            {
+                if (spread)
+                    coords.push_back({c * RegionFormat::RegionSize, -(c % 7) * RegionFormat::RegionSize});
+                else
+                    coords.push_back({c % RegionFormat::RegionSize - 4, c / RegionFormat::RegionSize});
+            }
+
+            std::atomic<bool> failed{false};
+            std::string failure;
+            std::mutex failureMutex;
+            const auto report = [&](const std::string& message)
+            {
+                std::lock_guard<std::mutex> lock(failureMutex);
+                if (!failed.exchange(true)) failure = message;
+            };
+
+            {
+                RegionStore store(directory.Path(), std::chrono::milliseconds(gen.RandomInt(0, 2)));
+                std::atomic<int> writersDone{0};
+                std::vector<std::thread> threads;
+                for (int w = 0; w < writers; ++w)
+                {
+                    threads.emplace_back([&, w]
+                    {
+                        for (int v = 1; v <= versions && !failed; ++v)
+                        {
+                            for (int c = 0; c < chunksPerWriter; ++c)
+                            {
+                                const ChunkCoord coord = coords[static_cast<size_t>(w * chunksPerWriter + c)];
+                                store.Save(coord, VersionedTiles(coord, static_cast<uint16_t>(v)));
+                            }
+                            if (v % 16 == 0) store.Flush();
+                        }
+                        ++writersDone;
+                    });
+                }
+                for (int r = 0; r < 2; ++r)
+                {
+                    threads.emplace_back([&]
+                    {
+                        std::vector<uint16_t> lastSeen(coords.size(), 0);
+                        std::vector<uint16_t> tiles;
+                        while (writersDone < writers && !failed)
+                        {
+                            for (size_t c = 0; c < coords.size(); ++c)
+                            {
+                                if (!store.Load(coords[c], tiles)) continue;
+                                const uint16_t version = tiles[0];
+                                if (tiles != VersionedTiles(coords[c], version))
+                                    report("loaded a torn or foreign chunk");
+                                else if (version < lastSeen[c])
+                                    report("loaded an older version after a newer one");
+                                lastSeen[c] = std::max(lastSeen[c], version);
+                            }
+                        }
+                    });
+                }
+                for (auto& thread : threads)
+                    thread.join();
+            }
+
+            if (!failed)
+            {
+                RegionStore reopened(directory.Path());
+                std::vector<uint16_t> tiles;
+                for (const auto& coord : coords)
+                {
+                    if (!reopened.Load(coord, tiles) || tiles != VersionedTiles(coord, static_cast<uint16_t>(versions)))
+                    {
+                        report("final version missing from disk");
+                        break;
+                    }
+                }
+            }
+            if (failed)
+            {
+                result.passed = false;
+                result.failedIteration = i;
+                result.failureMessage = failure;
+                return result;
+            }
+        }
+        return result;
+    }
+
+    /// 每个瓦片最后一次写入的位置与值。
+    using TileEdits = std::unordered_map<int64_t, std::pair<std::pair<float, float>, uint16_t>>;
+
+    inline void RecordEdit(TileEdits& edits, float tileSize, float x, float y, uint16_t tile)
+    {
+        const auto tx = static_cast<int64_t>(std::floor(x / tileSize));
+        const auto ty = static_cast<int64_t>(std::floor(y / tileSize));
+        edits[tx * 1000003 + ty] = {{x, y}, tile};
+    }
+
+    inline bool EditsPresent(WorldStreaming::ChunkManager& manager, const TileEdits& edits)
+    {
+        for (const auto& [key, edit] : edits)
+        {
+            if (manager.GetTileAt(edit.first.first, edit.first.second) != edit.second) return false;
+        }
+        return true;
+    }
+
+    inline std::shared_ptr<RegionStore> AttachStore(WorldStreaming::ChunkManager& manager,
+                                                    const std::filesystem::path& directory, int loadRadius)
+    {
+        auto store = std::make_shared<RegionStore>(directory, TestBatchDelay);
+        manager.SetLoadRadius(loadRadius);
+        manager.SetUnloadRadius(loadRadius + 1);
+        manager.SetChunkGenerator(ChunkStreamingTests::MakeGenerator());
+        manager.SetRegionStore(store);
+        return store;
+    }
+
+    /**
+     * @brief Property: with a region store attached, edits survive unloading and restarting, untouched chunks are
+     * never written, and reloaded chunks come from disk instead of the generator
+     */
+    inline TestResult TestProperty_EditsSurviveUnload(int iterations = 30)
+    {
+        TestResult result;
+        StreamingRandomGenerator gen(47u);
+        const float tileSize = 16.0f;
+        const float chunkWorld = tileSize * Chunk::SIZE;
+        const float home = 0.5f * chunkWorld;
+
+        for (int i = 0; i < iterations; ++i)
+        {
+            ScratchDirectory directory("region_edits");
+            TileEdits edits;
+            std::unordered_set<ChunkCoord, WorldStreaming::ChunkCoordHash> editedChunks;
+            const int loadRadius = gen.RandomInt(1, 3);
+            std::string error;
+
+            {
+                WorldStreaming::ChunkManager manager;
+                AttachStore(manager, directory.Path(), loadRadius);
+                manager.SetViewCenter(home, home);
+                manager.Flush();
+
+                for (int e = gen.RandomInt(1, 40); e > 0; --e)
+                {
+                    const float x = gen.RandomFloat(-static_cast<float>(loadRadius), loadRadius + 1.0f) * chunkWorld;
+                    const float y = gen.RandomFloat(-static_cast<float>(loadRadius), loadRadius + 1.0f) * chunkWorld;
+                    const Chunk* chunk = manager.GetChunkAt(x, y);
+                    if (!chunk) continue;
+                    const uint16_t tile = static_cast<uint16_t>(gen.RandomInt(300, 400));
+                    manager.SetTileAt(x, y, tile);
+                    RecordEdit(edits, tileSize, x, y, tile);
+                    editedChunks.insert(chunk->coord);
+                }
+
+                // 走远再回来：修改过的区块卸载时保存，回来时从队列或磁盘读出
+                manager.SetViewCenter(100.0f * chunkWorld + home, home);
+                manager.Flush();
+                if (manager.GetStats().saved != editedChunks.size())
+                    error = "saved chunk count differs from edited chunk count";
+                manager.SetViewCenter(home, home);
+                manager.Flush();
+                if (error.empty() && !EditsPresent(manager, edits))
+                    error = "edit lost after unload and reload";
+                if (error.empty() && manager.GetStats().fromDisk != editedChunks.size())
+                    error = "edited chunks were regenerated instead of read back";
+
+                // 析构时保存仍在内存中的修改
+                manager.SetTileAt(home, home, 999);
+                RecordEdit(edits, tileSize, home, home, 999);
+                editedChunks.insert(manager.GetChunkAt(home, home)->coord);
+            }
+
+            if (error.empty())
+            {
+                WorldStreaming::ChunkManager manager;
+                AttachStore(manager, directory.Path(), loadRadius);
+                manager.SetViewCenter(home, home);
+                manager.Flush();
+                if (!EditsPresent(manager, edits))
+                    error = "edit lost across restart";
+                else if (manager.GetStats().fromDisk != editedChunks.size())
+                    error = "restart did not read edited chunks from disk";
+            }
+
+            if (!error.empty())
+            {
+                std::ostringstream oss;
+                oss << error << " (loadRadius=" << loadRadius << ", edited chunks=" << editedChunks.size() << ")";
+                result.passed = false;
+                result.failedIteration = i;
+                result.failureMessage = oss.str();
+                return result;
+            }
+        }
+        return result;
+    }
+
+    /**
+     * @brief Benchmark: region file size versus raw tiles for terrain-like chunks, batched write time and mmap
+     * read time
+     */
+    inline void RunRegionStoreBenchmark(int chunks = 1024)
+    {
+        using Clock = std::chrono::steady_clock;
+        StreamingRandomGenerator gen(48u);
+        ScratchDirectory directory("region_bench");
+
+        std::vector<std::pair<ChunkCoord, std::vector<uint16_t>>> data;
+        for (int c = 0; c < chunks; ++c)
+        {
+            const ChunkCoord coord{c % RegionFormat::RegionSize, c / RegionFormat::RegionSize};
+            // 地形区块：以层状为主，少量噪声与零散修改
+            std::vector<uint16_t> tiles = RandomTiles(gen);
+            if (gen.RandomInt(0, 9) == 0)
+                for (auto& tile : tiles) tile = static_cast<uint16_t>(gen.RandomInt(0, 65535));
+            data.emplace_back(coord, std::move(tiles));
+        }
+
+        auto t0 = Clock::now();
+        {
+            RegionStore store(directory.Path());
+            for (const auto& [coord, tiles] : data)
+                store.Save(coord, tiles);
+            store.Flush();
+        }
+        const double writeMs = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+
+        uintmax_t bytes = 0;
+        for (const auto& entry : std::filesystem::directory_iterator(directory.Path()))
+            bytes += entry.file_size();
+        const uintmax_t raw = static_cast<uintmax_t>(chunks) * TileCount * sizeof(uint16_t);
+
+        RegionStore store(directory.Path());
+        std::vector<uint16_t> tiles;
+        size_t loaded = 0;
+        t0 = Clock::now();
+        for (const auto& [coord, expected] : data)
+            loaded += store.Load(coord, tiles) && tiles == expected;
+        const double readMs = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+
+        LogInfo("{} chunks: {} KiB on disk vs {} KiB raw ({:.1f}x); write+flush {:.2f} ms, read {:.2f} ms "
+                "({:.1f} us/chunk), {} verified", chunks, bytes / 1024, raw / 1024,
+                static_cast<double>(raw) / static_cast<double>(std::max<uintmax_t>(bytes, 1)), writeMs, readMs,
+                readMs * 1000.0 / chunks, loaded);
+    }
+
+    /**
+     * @brief Run all region store tests
+     *
+     * @return true if all tests pass, false otherwise
+     */
+    inline bool RunAllRegionStoreTests()
+    {
+        LogInfo("=== Running Region Store Tests ===");
+
+        bool allPassed = true;
+        allPassed &= ChunkStreamingTests::RunTest("Region files round trip", TestProperty_RoundTrip());
+        allPassed &= ChunkStreamingTests::RunTest("Corruption is detected", TestProperty_CorruptionDetected());
+        allPassed &= ChunkStreamingTests::RunTest("Concurrent load/save of a region", TestProperty_ConcurrentLoadSave());
+        allPassed &= ChunkStreamingTests::RunTest("Edits survive unload and restart", TestProperty_EditsSurviveUnload());
+
+        LogInfo("=== Region Store Tests Complete ===");
+        return allPassed;
+    }
+}
+
+#endif // REGION_STORE_TESTS_H
@@ -0,0 +1,335 @@
+#ifndef TERRAIN_PIPELINE_TESTS_H
+#define TERRAIN_PIPELINE_TESTS_H
+
+/**
+ * @file TerrainPipelineTests.h
+ * @brief Property-based tests and benchmark for staged parallel chunk terrain generation
+ *
+ * Batched generation runs every stage across the job pool; its output must be bit-identical
+ * to generating the same chunks one at a time on the calling thread, in any order, with a cold
+ * or warm column cache.
+ *
+ * Feature: terrain-pipeline
+ */
+
+#include "../ProceduralGen/TerrainPipeline.h"
+#include "../PixelWorld/PixelWorld.h"
+#include "../../Event/JobSystem.h"
+#include "../../Utils/Logger.h"
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace TerrainPipelineTests
+{
+    class TerrainRandomGenerator
+    {
+    public:
+        explicit TerrainRandomGenerator(unsigned int seed) : m_gen(seed) {}
+
+        int RandomInt(int min, int max)
+        {
+            std::uniform_int_distribution<int> dist(min, max);
+            return dist(m_gen);
+        }
+
+        float RandomFloat(float min, float max)
+        {
+            std::uniform_real_distribution<float> dist(min, max);
+            return dist(m_gen);
+        }
+
+        std::mt19937& Engine() { return m_gen; }
+
+    private:
+        std::mt19937 m_gen;
+    };
+
+    /**
+     * @brief Test result structure for detailed failure reporting
+     */
+    struct TestResult
+    {
+        bool passed = true;
+        std::string failureMessage;
+        int failedIteration = -1;
+    };
+
+    inline bool RunTest(const char* name, const TestResult& result)
+    {
+        if (result.passed)
+        {
+            LogInfo("{} PASSED", name);
+            return true;
+        }
+        LogError("{} FAILED at iteration {}: {}", name, result.failedIteration, result.failureMessage);
+        return false;
+    }
+
+    inline TerrainProfile RandomProfile(TerrainRandomGenerator& gen, bool withOres)
+    {
+        TerrainProfile profile;
+        profile.seed = gen.RandomInt(0, 1000000);
+        profile.caveThreshold = gen.RandomFloat(0.3f, 0.5f);
+        if (withOres)
+        {
+            profile.ores.push_back({PixelType::Oil, gen.RandomInt(10, 60), gen.RandomFloat(0.05f, 0.2f), 0.7f, 555});
+            profile.ores.push_back({PixelType::Sand, gen.RandomInt(0, 30), gen.RandomFloat(0.1f, 0.3f), 0.8f, 556});
+        }
+        return profile;
+    }
+
+    /**
+     * @brief Random chunk origins clustered so that many share a column strip
+     */
+    inline std::vector<WorldStreaming::ChunkCoord> RandomCoords(TerrainRandomGenerator& gen, int count)
+    {
+        std::set<std::pair<int, int>> unique;
+        while (static_cast<int>(unique.size()) < count)
+            unique.insert({gen.RandomInt(-6, 6), gen.RandomInt(2, 8)});
+        std::vector<WorldStreaming::ChunkCoord> coords;
+        for (const auto& [x, y] : unique)
+            coords.push_back({x, y});
+        std::shuffle(coords.begin(), coords.end(), gen.Engine());
+        return coords;
+    }
+
+    inline std::vector<uint16_t> GenerateBatch(TerrainPipeline& pipeline,
+                                               const std::vector<WorldStreaming::ChunkCoord>& coords)
+    {
+        const int size = pipeline.GetChunkSize();
+        const size_t area = static_cast<size_t>(size) * size;
+        std::vector<uint16_t> tiles(area * coords.size());
+        std::vector<TerrainPipeline::Request> requests;
+        for (size_t i = 0; i < coords.size(); ++i)
+            requests.push_back({coords[i].x * size, coords[i].y * size, tiles.data() + i * area});
+        pipeline.GenerateBatch(requests);
+        return tiles;
+    }
+
+    /**
+     * Property: batched generation is bitwise identical to sequential generation regardless of
+     * order, batch split and cache state
+     */
+    inline TestResult TestProperty_BatchMatchesSequential(int iterations = 20)
+    {
+        TestResult result;
+        TerrainRandomGenerator gen(42001);
+
+        for (int i = 0; i < iterations; ++i)
+        {
+            const TerrainProfile profile = RandomProfile(gen, i % 2 == 1);
+            const int chunkSize = i % 3 == 0 ? 128 : WorldStreaming::Chunk::SIZE;
+            const auto coords = RandomCoords(gen, gen.RandomInt(4, 24));
+            const size_t area = static_cast<size_t>(chunkSize) * chunkSize;
+
+            TerrainPipeline batched(profile, chunkSize);
+            const std::vector<uint16_t> cold = GenerateBatch(batched, coords);
+
+            // 单线程、逆序、缓存很小
+            TerrainPipeline sequential(profile, chunkSize);
+            sequential.SetMaxCachedColumns(1);
+            std::vector<uint16_t> serial(cold.size());
+            for (size_t c = coords.size(); c-- > 0;)
+                sequential.Generate(coords[c].x * chunkSize, coords[c].y * chunkSize, serial.data() + c * area);
+
+            // 暖缓存下分两批
+            const size_t split = coords.size() / 2;
+            std::vector<WorldStreaming::ChunkCoord> first(coords.begin(), coords.begin() + split);
+            std::vector<WorldStreaming::ChunkCoord> second(coords.begin() + split, coords.end());
+            std::vector<uint16_t> warm = GenerateBatch(batched, second);
+            std::vector<uint16_t> warmFirst = GenerateBatch(batched, first);
+            warm.insert(warm.begin(), warmFirst.begin(), warmFirst.end());
+
+            for (size_t c = 0; c < coords.size(); ++c)
+            {
+                const auto begin = static_cast<std::ptrdiff_t>(c * area);
+                const auto end = static_cast<std::ptrdiff_t>((c + 1) * area);
+                const bool serialMatch = std::equal(cold.begin() + begin, cold.begin() + end, serial.begin() + begin);
+                const bool warmMatch = std::equal(cold.begin() + begin, cold.begin() + end, warm.begin() + begin);
+                if (serialMatch && warmMatch) continue;
+
+                std::ostringstream oss;
+                oss << "chunk (" << coords[c].x << ", " << coords[c].y << ") size " << chunkSize << " differs from "
+                    << (serialMatch ? "warm-cache batch" : "sequential generation");
+                result.passed = false;
+                result.failureMessage = oss.str();
+                result.failedIteration = i;
+                return result;
+            }
+
+            // 流式区块的入口与批量结果一致
+            if (chunkSize == WorldStreaming::Chunk::SIZE)
+            {
+                WorldStreaming::Chunk chunk;
+                chunk.Initialize(coords[0]);
+                TerrainGenerator::GenerateForChunk(chunk, profile);
+                if (!std::equal(cold.begin(), cold.begin() + static_cast<std::ptrdiff_t>(area),
+                                chunk.CopyTiles().begin()))
+                {
+                    result.passed = false;
+                    result.failureMessage = "TerrainGenerator::GenerateForChunk differs from the pipeline";
+                    result.failedIteration = i;
+                    return result;
+                }
+            }
+        }
+
+        return result;
+    }
+
+    /**
+     * Property: each column strip's surface heights are computed once per batch and reused by
+     * every chunk above or below it
+     */
+    inline TestResult TestProperty_ColumnCacheSharesStrips(int iterations = 20)
+    {
+        TestResult result;
+        TerrainRandomGenerator gen(42002);
+
+        for (int i = 0; i < iterations; ++i)
+        {
+            TerrainPipeline pipeline(RandomProfile(gen, false));
+            const auto coords = RandomCoords(gen, gen.RandomInt(2, 30));
+            std::set<int> strips;
+            for (const auto& coord : coords)
+                strips.insert(coord.x);
+
+            GenerateBatch(pipeline, coords);
+            const auto afterFirst = pipeline.GetStats();
+            GenerateBatch(pipeline, coords);
+            const auto afterSecond = pipeline.GetStats();
+
+            if (afterFirst.columnMisses != strips.size() || afterSecond.columnMisses != strips.size() ||
+                afterSecond.columnHits - afterFirst.columnHits != coords.size() ||
+                pipeline.GetCachedColumnCount() != strips.size())
+            {
+                std::ostringstream oss;
+                oss << coords.size() << " chunks over " << strips.size() << " strips: misses "
+                    << afterFirst.columnMisses << " then " << afterSecond.columnMisses << ", second-batch hits "
+                    << afterSecond.columnHits - afterFirst.columnHits << ", cached " << pipeline.GetCachedColumnCount();
+                result.passed = false;
+                result.failureMessage = oss.str();
+                result.failedIteration = i;
+                return result;
+            }
+        }
+
+        return result;
+    }
+
+    /**
+     * Property: ore layers only turn stone at or below their minimum depth into their material;
+     * every other tile matches the ore-free terrain
+     */
+    inline TestResult TestProperty_OresOnlyReplaceDeepStone(int iterations = 20)
+    {
+        TestResult result;
+        TerrainRandomGenerator gen(42003);
+        size_t replaced = 0;
+
+        for (int i = 0; i < iterations; ++i)
+        {
+            TerrainProfile plain = RandomProfile(gen, false);
+            TerrainProfile withOres = plain;
+            const int minDepth = gen.RandomInt(0, 80);
+            withOres.ores.push_back({PixelType::Oil, minDepth, gen.RandomFloat(0.05f, 0.3f), 0.6f, 7});
+
+            const auto coords = RandomCoords(gen, 6);
+            TerrainPipeline plainPipeline(plain);
+            TerrainPipeline orePipeline(withOres);
+            const auto before = GenerateBatch(plainPipeline, coords);
+            const auto after = GenerateBatch(orePipeline, coords);
+
+            const int size = WorldStreaming::Chunk::SIZE;
+            std::vector<int> surface(size);
+            for (size_t c = 0; c < coords.size(); ++c)
+            {
+                TerrainGenerator::SurfaceHeights(coords[c].x * size, size, surface.data(), plain);
+                for (int y = 0; y < size; ++y)
+                {
+                    for (int x = 0; x < size; ++x)
+                    {
+                        const size_t index = c * size * size + static_cast<size_t>(y) * size + x;
+                        if (before[index] == after[index]) continue;
+                        const int depth = coords[c].y * size + y - surface[x];
+                        if (before[index] == PixelType::Stone && after[index] == PixelType::Oil && depth >= minDepth)
+                        {
+                            ++replaced;
+                            continue;
+                        }
+
+                        std::ostringstream oss;
+                        oss << "chunk (" << coords[c].x << ", " << coords[c].y << ") tile (" << x << ", " << y
+                            << ") at depth " << depth << " changed from " << before[index] << " to " << after[index];
+                        result.passed = false;
+                        result.failureMessage = oss.str();
+                        result.failedIteration = i;
+                        return result;
+                    }
+                }
+            }
+        }
+
+        if (replaced == 0)
+        {
+            result.passed = false;
+            result.failureMessage = "no ore was placed in any chunk";
+        }
+        return result;
+    }
+
+    /**
+     * @brief Chunks generated per second: one at a time on the calling thread versus staged batches
+     */
+    inline void RunTerrainPipelineBenchmark(int chunks = 256)
+    {
+        using Clock = std::chrono::steady_clock;
+        LogInfo("=== Terrain Pipeline Benchmark ({} job threads, {} hardware threads) ===",
+                JobSystem::GetInstance().GetThreadCount(), std::thread::hardware_concurrency());
+
+        TerrainProfile profile;
+        profile.ores.push_back({PixelType::Oil, 40, 0.12f, 0.75f, 555});
+        // 16 列 x N 行的地下区块块，模拟加载画面或传送后的整批生成
+        std::vector<WorldStreaming::ChunkCoord> coords;
+        for (int i = 0; i < chunks; ++i)
+            coords.push_back({i % 16, 4 + i / 16});
+
+        TerrainPipeline sequential(profile);
+        std::vector<uint16_t> tiles(static_cast<size_t>(WorldStreaming::Chunk::SIZE) * WorldStreaming::Chunk::SIZE);
+        auto t0 = Clock::now();
+        for (const auto& coord : coords)
+            sequential.Generate(coord.x * WorldStreaming::Chunk::SIZE, coord.y * WorldStreaming::Chunk::SIZE,
+                                tiles.data());
+        const double sequentialSeconds = std::chrono::duration<double>(Clock::now() - t0).count();
+
+        TerrainPipeline batched(profile);
+        t0 = Clock::now();
+        GenerateBatch(batched, coords);
+        const double batchedSeconds = std::chrono::duration<double>(Clock::now() - t0).count();
+
+        const auto stats = batched.GetStats();
+        LogInfo("{} chunks: {:.0f} chunks/s sequential vs {:.0f} chunks/s batched ({:.1f}x); {} column strips "
+                "computed for {} chunks", chunks, chunks / sequentialSeconds, chunks / batchedSeconds,
+                sequentialSeconds / batchedSeconds, stats.columnMisses, stats.chunks);
+    }
+
+    /**
+     * @brief Run all terrain pipeline tests
+     */
+    inline bool RunAllTerrainPipelineTests()
+    {
+        bool allPassed = true;
+        allPassed &= RunTest("Batch Matches Sequential", TestProperty_BatchMatchesSequential());
+        allPassed &= RunTest("Column Cache Shares Strips", TestProperty_ColumnCacheSharesStrips());
+        allPassed &= RunTest("Ores Only Replace Deep Stone", TestProperty_OresOnlyReplaceDeepStone());
+        return allPassed;
+    }
+}
+
+#endif
@@ -1,6 +1,7 @@
 #ifndef CHUNK_H
 #define CHUNK_H
 
+#include "PalettedTiles.h"
 #include <cstdint>
 #include <vector>
 #include <functional>
@@ -18,9 +19,11 @@ namespace WorldStreaming
     {
         size_t operator()(const ChunkCoord& c) const
         {
-            size_t h1 = std::hash<int32_t>{}(c.x);
-            size_t h2 = std::hash<int32_t>{}(c.y);
-            return h1 ^ (h2 << 1);
+            // 标准库的整数哈希是恒等映射，异或组合后相邻坐标大量冲突；用 splitmix64 的终结函数充分混合
+            uint64_t h = (static_cast<uint64_t>(static_cast<uint32_t>(c.x)) << 32) | static_cast<uint32_t>(c.y);
+            h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ull;
+            h = (h ^ (h >> 27)) * 0x94D049BB133111EBull;
+            return static_cast<size_t>(h ^ (h >> 31));
         }
     };
 
@@ -36,7 +39,7 @@ namespace WorldStreaming
         void Initialize(ChunkCoord c)
         {
             coord = c;
-            tiles.assign(SIZE * SIZE, 0);
+            tiles.Fill(0);
             dirty = false;
             loaded = true;
         }
@@ -45,22 +48,65 @@ namespace WorldStreaming
         {
             if (localX < 0 || localX >= SIZE || localY < 0 || localY >= SIZE)
                 return 0;
-            return tiles[localY * SIZE + localX];
+            return tiles.Get(localX, localY);
         }
 
         void SetTile(int localX, int localY, uint16_t tileId)
         {
             if (localX < 0 || localX >= SIZE || localY < 0 || localY >= SIZE)
                 return;
-            tiles[localY * SIZE + localX] = tileId;
+            tiles.Set(localX, localY, tileId);
             dirty = true;
         }
 
-        std::vector<uint16_t>& GetTiles() { return tiles; }
-        const std::vector<uint16_t>& GetTiles() const { return tiles; }
+        /// 读出一行 SIZE 个瓦片。
+        void GetRow(int localY, uint16_t* out) const
+        {
+            if (localY >= 0 && localY < SIZE)
+                tiles.GetRow(localY, out);
+        }
+
+        void SetRow(int localY, const uint16_t* tileIds)
+        {
+            if (localY < 0 || localY >= SIZE)
+                return;
+            tiles.SetRow(localY, tileIds);
+            dirty = true;
+        }
+
+        /// 写入 SIZE * SIZE 个按行排列的瓦片。
+        void SetTiles(const uint16_t* tileIds)
+        {
+            tiles.Assign(tileIds);
+            dirty = true;
+        }
+
+        /// 用同一种瓦片填充矩形，超出区块的部分被裁掉。
+        void FillRegion(int localX, int localY, int width, int height, uint16_t tileId)
+        {
+            const int x0 = localX < 0 ? 0 : localX;
+            const int y0 = localY < 0 ? 0 : localY;
+            const int x1 = localX + width > SIZE ? SIZE : localX + width;
+            const int y1 = localY + height > SIZE ? SIZE : localY + height;
+            if (x0 >= x1 || y0 >= y1)
+                return;
+            tiles.FillRegion(x0, y0, x1 - x0, y1 - y0, tileId);
+            dirty = true;
+        }
+
+        /// 只读访问底层存储；按区域批量读写请用 PalettedTiles 的接口。
+        const PalettedTiles& GetTiles() const { return tiles; }
+
+        /// 以稠密数组形式复制全部瓦片。
+        std::vector<uint16_t> CopyTiles() const
+        {
+            std::vector<uint16_t> out(tiles.Count());
+            tiles.CopyTo(out.data());
+            return out;
+        }
 
     private:
-        std::vector<uint16_t> tiles;
+        PalettedTiles tiles{SIZE, SIZE};
     };
 }
 
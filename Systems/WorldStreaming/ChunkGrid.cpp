@@ -0,0 +1,94 @@
+#include "ChunkGrid.h"
+#include <bit>
+
+namespace WorldStreaming
+{
+    ChunkGrid::ChunkGrid(int span)
+    {
+        SetSpan(span);
+    }
+
+    void ChunkGrid::SetSpan(int span)
+    {
+        const int size = static_cast<int>(std::bit_ceil(static_cast<uint32_t>(span < 1 ? 1 : span)));
+        if (size == m_size) return;
+
+        std::vector<Slot> old = std::move(m_slots);
+        auto overflow = std::move(m_overflow);
+        m_overflow.clear();
+        m_size = size;
+        m_shift = std::countr_zero(static_cast<uint32_t>(size));
+        m_mask = static_cast<uint32_t>(size) - 1;
+        m_slots = std::vector<Slot>(static_cast<size_t>(size) * size);
+        m_count = 0;
+
+        for (Slot& slot : old)
+        {
+            if (slot.chunk) Insert(slot.coord, slot.chunk);
+        }
+        for (auto& [coord, chunk] : overflow)
+            Insert(coord, chunk);
+    }
+
+    Chunk* ChunkGrid::Find(ChunkCoord coord) const
+    {
+        const Slot& slot = m_slots[SlotIndex(coord)];
+        if (slot.chunk && slot.coord == coord) return slot.chunk.get();
+        if (m_overflow.empty()) return nullptr;
+        auto it = m_overflow.find(coord);
+        return it != m_overflow.end() ? it->second.get() : nullptr;
+    }
+
+    bool ChunkGrid::Insert(ChunkCoord coord, std::unique_ptr<Chunk>& chunk)
+    {
+        Slot& slot = m_slots[SlotIndex(coord)];
+        if (slot.chunk && slot.coord == coord) return false;
+        // 槽位空出后，之前溢出的同余坐标可能仍在溢出表中
+        if (!m_overflow.empty() && m_overflow.contains(coord)) return false;
+        if (slot.chunk)
+            m_overflow.emplace(coord, std::move(chunk));
+        else
+        {
+            slot.coord = coord;
+            slot.chunk = std::move(chunk);
+        }
+        ++m_count;
+        return true;
+    }
+
+    std::unique_ptr<Chunk> ChunkGrid::Remove(ChunkCoord coord)
+    {
+        std::unique_ptr<Chunk> removed;
+        Slot& slot = m_slots[SlotIndex(coord)];
+        if (slot.chunk && slot.coord == coord)
+        {
+            removed = std::move(slot.chunk);
+            // 把溢出表中落在同一槽位的区块移回来，溢出表保持稀疏
+            for (auto it = m_overflow.begin(); it != m_overflow.end(); ++it)
+            {
+                if (SlotIndex(it->first) != SlotIndex(coord)) continue;
+                slot.coord = it->first;
+                slot.chunk = std::move(it->second);
+                m_overflow.erase(it);
+                break;
+            }
+        }
+        else if (!m_overflow.empty())
+        {
+            auto it = m_overflow.find(coord);
+            if (it == m_overflow.end()) return nullptr;
+            removed = std::move(it->second);
+            m_overflow.erase(it);
+        }
+        if (removed) --m_count;
+        return removed;
+    }
+
+    void ChunkGrid::Clear()
+    {
+        for (Slot& slot : m_slots)
+            slot.chunk.reset();
+        m_overflow.clear();
+        m_count = 0;
+    }
+}
@@ -0,0 +1,73 @@
+#ifndef CHUNKGRID_H
+#define CHUNKGRID_H
+
+#include "Chunk.h"
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace WorldStreaming
+{
+    /**
+     * @brief 以环面寻址的已加载区块表。
+     *
+     * 坐标按 (x mod N, y mod N) 直接映射到 N x N 的扁平槽位数组（N 为 2 的幂）。驻留区块都落在边长不超过 N
+     * 的窗口内时，不论窗口移动到哪里，查找、插入与删除都只访问一个槽位。与已占用槽位冲突的区块（窗口之外的远处区块）
+     * 放进溢出表，溢出表使用 ChunkCoordHash 的充分混合哈希。
+     */
+    class ChunkGrid
+    {
+    public:
+        explicit ChunkGrid(int span = 16);
+
+        /**
+         * @brief 调整窗口边长（向上取 2 的幂），已有区块重新放置。
+         */
+        void SetSpan(int span);
+        int GetSpan() const { return m_size; }
+
+        Chunk* Find(ChunkCoord coord) const;
+        /// 坐标已存在时返回 false，chunk 不被接管。
+        bool Insert(ChunkCoord coord, std::unique_ptr<Chunk>& chunk);
+        /// 不存在时返回空指针。
+        std::unique_ptr<Chunk> Remove(ChunkCoord coord);
+        void Clear();
+
+        size_t Size() const { return m_count; }
+        size_t OverflowSize() const { return m_overflow.size(); }
+
+        /// fn(ChunkCoord, Chunk&)；遍历期间不能增删。
+        template <typename Fn>
+        void ForEach(Fn&& fn) const
+        {
+            for (const Slot& slot : m_slots)
+            {
+                if (slot.chunk) fn(slot.coord, *slot.chunk);
+            }
+            for (const auto& [coord, chunk] : m_overflow)
+                fn(coord, *chunk);
+        }
+
+    private:
+        struct Slot
+        {
+            ChunkCoord coord{};
+            std::unique_ptr<Chunk> chunk;
+        };
+
+        size_t SlotIndex(ChunkCoord coord) const
+        {
+            return (static_cast<size_t>(static_cast<uint32_t>(coord.y) & m_mask) << m_shift) |
+                (static_cast<uint32_t>(coord.x) & m_mask);
+        }
+
+        int m_size = 0;
+        int m_shift = 0;
+        uint32_t m_mask = 0;
+        size_t m_count = 0;
+        std::vector<Slot> m_slots;
+        std::unordered_map<ChunkCoord, std::unique_ptr<Chunk>, ChunkCoordHash> m_overflow;
+    };
+}
+
+#endif
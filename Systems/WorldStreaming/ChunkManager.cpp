@@ -1,53 +1,438 @@
 #include "ChunkManager.h"
-#include <vector>
+#include <chrono>
 #include <cmath>
+#include <limits>
 
 namespace WorldStreaming
 {
+    void ChunkManager::GenerateJob::Execute()
+    {
+        if (cancelled.load(std::memory_order_relaxed)) return;
+        chunk = std::make_unique<Chunk>();
+        chunk->Initialize(coord);
+        std::vector<uint16_t> tiles;
+        if (store && store->Load(coord, tiles))
+        {
+            chunk->SetTiles(tiles.data());
+            fromDisk = true;
+        }
+        else if (generator)
+        {
+            (*generator)(*chunk);
+        }
+        // 生成的内容可以重新生成，只有之后的修改才需要保存
+        chunk->dirty = false;
+        generated = true;
+    }
+
+    namespace
+    {
+        /// 以 a 为中心的区域减去以 b 为中心的区域，逐行按区间求差；halfWidthA/B(dy) 为 -1 表示该行不在区域内。
+        template <typename HalfWidthA, typename HalfWidthB, typename Fn>
+        void ForEachDifference(ChunkCoord a, int rowsA, HalfWidthA halfWidthA, ChunkCoord b, HalfWidthB halfWidthB,
+                               Fn&& fn)
+        {
+            for (int y = a.y - rowsA; y <= a.y + rowsA; ++y)
+            {
+                const int wa = halfWidthA(y - a.y);
+                if (wa < 0) continue;
+                const int wb = halfWidthB(y - b.y);
+                const int a0 = a.x - wa;
+                const int a1 = a.x + wa;
+                if (wb < 0)
+                {
+                    for (int x = a0; x <= a1; ++x)
+                        fn(ChunkCoord{x, y});
+                    continue;
+                }
+                const int b0 = b.x - wb;
+                const int b1 = b.x + wb;
+                for (int x = a0; x <= std::min(a1, b0 - 1); ++x)
+                    fn(ChunkCoord{x, y});
+                for (int x = std::max(a0, b1 + 1); x <= a1; ++x)
+                    fn(ChunkCoord{x, y});
+            }
+        }
+    }
+
+    ChunkManager::ChunkManager()
+    {
+        OnRadiusChanged();
+    }
+
+    ChunkManager::~ChunkManager()
+    {
+        for (auto& flight : m_inFlight)
+            flight.job->cancelled.store(true, std::memory_order_relaxed);
+        WaitForInFlight();
+        SaveAll();
+    }
+
     void ChunkManager::SetViewCenter(float worldX, float worldY)
     {
+        const float chunkWorld = m_tileSize * Chunk::SIZE;
         m_viewCenter = WorldToChunk(worldX, worldY);
+        m_viewX = worldX / chunkWorld;
+        m_viewY = worldY / chunkWorld;
+    }
+
+    void ChunkManager::SetLoadRadius(int chunks)
+    {
+        if (chunks == m_loadRadius) return;
+        m_loadRadius = chunks;
+        OnRadiusChanged();
+    }
+
+    void ChunkManager::SetUnloadRadius(int chunks)
+    {
+        if (chunks == m_unloadRadius) return;
+        m_unloadRadius = chunks;
+        OnRadiusChanged();
+    }
+
+    void ChunkManager::OnRadiusChanged()
+    {
+        const int radius = std::max(m_unloadRadius, 0);
+        m_keepHalfWidth.assign(static_cast<size_t>(radius) + 1, 0);
+        for (int dy = 0; dy <= radius; ++dy)
+        {
+            // 整数开方，保证与 ShouldUnload 的判定完全一致
+            int w = static_cast<int>(std::sqrt(static_cast<double>(radius * radius - dy * dy)));
+            while (w * w > radius * radius - dy * dy) --w;
+            while ((w + 1) * (w + 1) <= radius * radius - dy * dy) ++w;
+            m_keepHalfWidth[static_cast<size_t>(dy)] = w;
+        }
+        // 驻留区块都在卸载半径内，窗口能容纳它们时就不会落入溢出表
+        m_chunks.SetSpan(2 * radius + 1);
+        m_residencyValid = false;
+    }
+
+    int ChunkManager::KeepHalfWidth(int dy) const
+    {
+        const int row = dy < 0 ? -dy : dy;
+        return row < static_cast<int>(m_keepHalfWidth.size()) ? m_keepHalfWidth[static_cast<size_t>(row)] : -1;
+    }
+
+    int ChunkManager::LoadHalfWidth(int dy) const
+    {
+        const int row = dy < 0 ? -dy : dy;
+        // 卸载半径小于加载方块的对角线时，角上的区块加载后会立刻被卸载，不请求
+        return row > m_loadRadius ? -1 : std::min(KeepHalfWidth(dy), m_loadRadius);
+    }
+
+    void ChunkManager::SetChunkGenerator(ChunkCallback generator)
+    {
+        // 已分发的任务持有旧生成函数的快照，替换不影响它们
+        m_generator = generator ? std::make_shared<const ChunkCallback>(std::move(generator)) : nullptr;
+    }
+
+    void ChunkManager::Update(float deltaTime)
+    {
+        if (deltaTime > 0.0f && m_hasLastView)
+        {
+            const float vx = (m_viewX - m_lastViewX) / deltaTime;
+            const float vy = (m_viewY - m_lastViewY) / deltaTime;
+            m_velocityX += (vx - m_velocityX) * VelocitySmoothing;
+            m_velocityY += (vy - m_velocityY) * VelocitySmoothing;
+        }
+        else
+        {
+            m_velocityX = 0.0f;
+            m_velocityY = 0.0f;
+        }
+        m_lastViewX = m_viewX;
+        m_lastViewY = m_viewY;
+        m_hasLastView = true;
+
+        CollectCompleted();
+        UpdateResidency();
+        // 先分发再接入，接入期间工作线程已经开始生成
+        Dispatch(static_cast<size_t>(m_maxInFlight));
+        Integrate(m_integrationBudgetMs);
+    }
+
+    void ChunkManager::Flush()
+    {
+        CollectCompleted();
+        UpdateResidency();
+        while (!m_pending.empty() || !m_inFlight.empty())
+        {
+            Dispatch(m_pending.size());
+            JobSystem::Complete(m_inFlight.front().handle);
+            CollectCompleted();
+        }
+        Integrate(std::numeric_limits<double>::infinity());
+    }
+
+    void ChunkManager::WaitForInFlight()
+    {
+        for (auto& flight : m_inFlight)
+            JobSystem::Complete(flight.handle);
+    }
+
+    void ChunkManager::Clear()
+    {
+        for (auto& flight : m_inFlight)
+            flight.job->cancelled.store(true, std::memory_order_relaxed);
+        WaitForInFlight();
+        m_stats.cancelled += m_pending.size() + m_inFlight.size() + m_ready.size();
+        m_inFlight.clear();
+        m_pending.clear();
+        m_ready.clear();
+        m_requested.clear();
+
+        m_chunks.ForEach([this](ChunkCoord coord, Chunk& chunk) { UnloadChunk(coord, chunk); });
+        m_chunks.Clear();
+        m_residencyValid = false;
+    }
+
+    size_t ChunkManager::SaveAll()
+    {
+        if (!m_regionStore) return 0;
+        size_t saved = 0;
+        m_chunks.ForEach([&](ChunkCoord coord, Chunk& chunk) {
+            if (!chunk.dirty) return;
+            m_regionStore->Save(coord, chunk.CopyTiles());
+            chunk.dirty = false;
+            ++saved;
+        });
+        m_stats.saved += saved;
+        return saved;
+    }
+
+    bool ChunkManager::ShouldUnload(ChunkCoord coord) const
+    {
+        const int dx = coord.x - m_viewCenter.x;
+        const int dy = coord.y - m_viewCenter.y;
+        return dx * dx + dy * dy > m_unloadRadius * m_unloadRadius;
+    }
+
+    float ChunkManager::Priority(ChunkCoord coord) const
+    {
+        // 前瞻点沿速度方向外推，偏移不超过加载半径的一半，保证视野附近的区块不会被饿死
+        float offsetX = m_velocityX * m_lookAheadSeconds;
+        float offsetY = m_velocityY * m_lookAheadSeconds;
+        const float maxOffset = static_cast<float>(m_loadRadius) * 0.5f;
+        const float length = std::sqrt(offsetX * offsetX + offsetY * offsetY);
+        if (length > maxOffset)
+        {
+            offsetX *= maxOffset / length;
+            offsetY *= maxOffset / length;
+        }
+        const float dx = static_cast<float>(coord.x) + 0.5f - (m_viewX + offsetX);
+        const float dy = static_cast<float>(coord.y) + 0.5f - (m_viewY + offsetY);
+        return dx * dx + dy * dy;
     }
 
-    void ChunkManager::Update()
+    void ChunkManager::UpdateResidency()
+    {
+        // 视野中心仍在同一区块内时，驻留集合不会改变
+        if (m_residencyValid && m_viewCenter == m_residentCenter) return;
+
+        const ChunkCoord from = m_residentCenter;
+        const bool incremental = m_residencyValid;
+        m_residentCenter = m_viewCenter;
+        m_residencyValid = true;
+
+        CancelOutOfRange();
+        if (incremental)
+        {
+            UnloadLeaving(from);
+            RequestEntering(from);
+        }
+        else
+        {
+            UnloadOutOfRange();
+            RequestMissing();
+        }
+    }
+
+    void ChunkManager::RequestMissing()
     {
         for (int dy = -m_loadRadius; dy <= m_loadRadius; ++dy)
         {
-            for (int dx = -m_loadRadius; dx <= m_loadRadius; ++dx)
+            const int w = LoadHalfWidth(dy);
+            for (int dx = -w; dx <= w; ++dx)
             {
                 ChunkCoord cc{m_viewCenter.x + dx, m_viewCenter.y + dy};
-                if (m_loadedChunks.contains(cc))
+                ++m_stats.residencyChecks;
+                if (m_chunks.Find(cc) || !m_requested.insert(cc).second)
                     continue;
+                m_pending.push_back(cc);
+            }
+        }
+    }
+
+    void ChunkManager::RequestEntering(ChunkCoord from)
+    {
+        // 以 from 为中心时加载区域内的区块都已加载或已请求，只需看新增的部分
+        ForEachDifference(
+            m_viewCenter, m_loadRadius, [this](int dy) { return LoadHalfWidth(dy); }, from,
+            [this](int dy) { return LoadHalfWidth(dy); },
+            [this](ChunkCoord cc) {
+                ++m_stats.residencyChecks;
+                if (m_chunks.Find(cc) || !m_requested.insert(cc).second) return;
+                m_pending.push_back(cc);
+            });
+    }
+
+    void ChunkManager::CancelOutOfRange()
+    {
+        const auto dropPending = std::partition(m_pending.begin(), m_pending.end(),
+                                                [this](ChunkCoord coord) { return !ShouldUnload(coord); });
+        for (auto it = dropPending; it != m_pending.end(); ++it)
+            m_requested.erase(*it);
+        m_stats.cancelled += static_cast<uint64_t>(m_pending.end() - dropPending);
+        m_pending.erase(dropPending, m_pending.end());
+
+        // 生成中的任务无法中断，只做标记；尚未开始的会直接跳过，结果在回收时丢弃
+        for (auto& flight : m_inFlight)
+        {
+            if (flight.job->cancelled.load(std::memory_order_relaxed) || !ShouldUnload(flight.job->coord))
+                continue;
+            flight.job->cancelled.store(true, std::memory_order_relaxed);
+            m_requested.erase(flight.job->coord);
+            ++m_stats.cancelled;
+        }
+
+        const auto dropReady = std::partition(m_ready.begin(), m_ready.end(),
+                                              [this](const auto& chunk) { return !ShouldUnload(chunk->coord); });
+        for (auto it = dropReady; it != m_ready.end(); ++it)
+            m_requested.erase((*it)->coord);
+        m_stats.cancelled += static_cast<uint64_t>(m_ready.end() - dropReady);
+        m_ready.erase(dropReady, m_ready.end());
+    }
 
-                auto chunk = std::make_unique<Chunk>();
-                chunk->Initialize(cc);
-                if (m_onChunkLoad)
-                    m_onChunkLoad(*chunk);
-                m_loadedChunks[cc] = std::move(chunk);
+    void ChunkManager::CollectCompleted()
+    {
+        for (size_t i = 0; i < m_inFlight.size();)
+        {
+            InFlight& flight = m_inFlight[i];
+            if (flight.handle.valid() &&
+                flight.handle.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+            {
+                ++i;
+                continue;
             }
+            InFlight done = std::move(flight);
+            m_inFlight.erase(m_inFlight.begin() + static_cast<std::ptrdiff_t>(i));
+
+            // 已取消的任务不再占有坐标，同一坐标可能已经重新请求
+            if (done.job->cancelled.load(std::memory_order_relaxed) || !done.job->generated)
+                continue;
+            ++m_stats.generated;
+            if (done.job->fromDisk) ++m_stats.fromDisk;
+            m_ready.push_back(std::move(done.job->chunk));
         }
+    }
 
+    void ChunkManager::UnloadOutOfRange()
+    {
         std::vector<ChunkCoord> toUnload;
-        for (auto& [coord, chunk] : m_loadedChunks)
-        {
-            int dx = coord.x - m_viewCenter.x;
-            int dy = coord.y - m_viewCenter.y;
-            if (dx * dx + dy * dy > m_unloadRadius * m_unloadRadius)
+        m_chunks.ForEach([&](ChunkCoord coord, Chunk&) {
+            ++m_stats.residencyChecks;
+            if (ShouldUnload(coord))
                 toUnload.push_back(coord);
-        }
+        });
 
         for (auto& coord : toUnload)
         {
-            if (m_onChunkUnload)
-                m_onChunkUnload(*m_loadedChunks[coord]);
-            m_loadedChunks.erase(coord);
+            UnloadChunk(coord, *m_chunks.Find(coord));
+            m_chunks.Remove(coord);
         }
     }
 
+    void ChunkManager::UnloadLeaving(ChunkCoord from)
+    {
+        // 已加载的区块都在以 from 为中心的卸载半径内，只需看两个圆逐行相差的部分
+        ForEachDifference(
+            from, m_unloadRadius, [this](int dy) { return KeepHalfWidth(dy); }, m_viewCenter,
+            [this](int dy) { return KeepHalfWidth(dy); },
+            [this](ChunkCoord cc) {
+                ++m_stats.residencyChecks;
+                // onUnload 期间区块仍可通过 GetChunk 访问
+                if (Chunk* chunk = m_chunks.Find(cc))
+                {
+                    UnloadChunk(cc, *chunk);
+                    m_chunks.Remove(cc);
+                }
+            });
+    }
+
+    void ChunkManager::UnloadChunk(ChunkCoord coord, Chunk& chunk)
+    {
+        if (m_onChunkUnload)
+            m_onChunkUnload(chunk);
+        // onUnload 中的修改也要保存
+        if (m_regionStore && chunk.dirty)
+        {
+            m_regionStore->Save(coord, chunk.CopyTiles());
+            ++m_stats.saved;
+        }
+        RecordChunkChange(coord);
+        ++m_stats.unloaded;
+    }
+
+    void ChunkManager::Dispatch(size_t maxInFlight)
+    {
+        if (m_pending.empty() || m_inFlight.size() >= maxInFlight) return;
+
+        // 视野和速度每帧都在变，重新排序；最优的放在末尾便于弹出
+        std::sort(m_pending.begin(), m_pending.end(),
+                  [this](ChunkCoord a, ChunkCoord b) { return Priority(a) > Priority(b); });
+        auto& jobSystem = JobSystem::GetInstance();
+        while (m_inFlight.size() < maxInFlight && !m_pending.empty())
+        {
+            InFlight flight;
+            flight.job = std::make_unique<GenerateJob>();
+            flight.job->coord = m_pending.back();
+            flight.job->generator = m_generator;
+            flight.job->store = m_regionStore;
+            m_pending.pop_back();
+            flight.handle = jobSystem.Schedule(flight.job.get());
+            m_inFlight.push_back(std::move(flight));
+        }
+    }
+
+    void ChunkManager::Integrate(double budgetMs)
+    {
+        if (m_ready.empty()) return;
+
+        std::sort(m_ready.begin(), m_ready.end(),
+                  [this](const auto& a, const auto& b) { return Priority(a->coord) < Priority(b->coord); });
+        const auto start = std::chrono::steady_clock::now();
+        size_t count = 0;
+        while (count < m_ready.size())
+        {
+            if (count > 0 &&
+                std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() >=
+                budgetMs)
+                break;
+            LoadChunk(std::move(m_ready[count]));
+            ++count;
+        }
+        m_ready.erase(m_ready.begin(), m_ready.begin() + static_cast<std::ptrdiff_t>(count));
+    }
+
+    void ChunkManager::LoadChunk(std::unique_ptr<Chunk> chunk)
+    {
+        const ChunkCoord cc = chunk->coord;
+        m_requested.erase(cc);
+        if (m_onChunkLoad)
+            m_onChunkLoad(*chunk);
+        m_chunks.Insert(cc, chunk);
+        RecordChunkChange(cc);
+        ++m_stats.loaded;
+    }
+
     Chunk* ChunkManager::GetChunk(ChunkCoord coord)
     {
-        auto it = m_loadedChunks.find(coord);
-        return it != m_loadedChunks.end() ? it->second.get() : nullptr;
+        return m_chunks.Find(coord);
+    }
+
+    const Chunk* ChunkManager::GetChunk(ChunkCoord coord) const
+    {
+        return m_chunks.Find(coord);
     }
 
     Chunk* ChunkManager::GetChunkAt(float worldX, float worldY)
@@ -70,8 +455,29 @@ namespace WorldStreaming
         int lx, ly;
         WorldToLocal(worldX, worldY, cc, lx, ly);
         auto* chunk = GetChunk(cc);
-        if (chunk)
-            chunk->SetTile(lx, ly, tileId);
+        if (!chunk || chunk->GetTile(lx, ly) == tileId)
+            return;
+        chunk->SetTile(lx, ly, tileId);
+        const int32_t tx = cc.x * Chunk::SIZE + lx;
+        const int32_t ty = cc.y * Chunk::SIZE + ly;
+        RecordChange(tx, ty, tx, ty);
+    }
+
+    void ChunkManager::RecordChange(int32_t minX, int32_t minY, int32_t maxX, int32_t maxY)
+    {
+        m_changes.push_back({minX, minY, maxX, maxY, ++m_revision});
+        if (m_changes.size() > MaxTrackedChanges)
+        {
+            const size_t drop = m_changes.size() / 2;
+            m_trimmedRevision = m_changes[drop - 1].revision;
+            m_changes.erase(m_changes.begin(), m_changes.begin() + static_cast<std::ptrdiff_t>(drop));
+        }
+    }
+
+    void ChunkManager::RecordChunkChange(ChunkCoord coord)
+    {
+        RecordChange(coord.x * Chunk::SIZE, coord.y * Chunk::SIZE,
+                     coord.x * Chunk::SIZE + Chunk::SIZE - 1, coord.y * Chunk::SIZE + Chunk::SIZE - 1);
     }
 
     ChunkCoord ChunkManager::WorldToChunk(float worldX, float worldY) const
@@ -2,43 +2,237 @@
 #define CHUNKMANAGER_H
 
 #include "Chunk.h"
+#include "ChunkGrid.h"
+#include "RegionStore.h"
+#include "../../Event/JobSystem.h"
 #include <unordered_map>
+#include <unordered_set>
 #include <memory>
 #include <functional>
 #include <cmath>
+#include <algorithm>
+#include <atomic>
+#include <vector>
 
 namespace WorldStreaming
 {
+    /**
+     * @brief 一次修改覆盖的全局瓦片坐标闭区间。
+     */
+    struct TileRegionChange
+    {
+        int32_t minX;
+        int32_t minY;
+        int32_t maxX;
+        int32_t maxY;
+        uint64_t revision;
+    };
+
+    struct ChunkStreamingStats
+    {
+        uint64_t generated = 0;  ///< 在工作线程上生成或读取完成的区块数。
+        uint64_t cancelled = 0;  ///< 完成前离开范围而被丢弃的生成请求数。
+        uint64_t loaded = 0;     ///< onLoad 调用次数。
+        uint64_t unloaded = 0;   ///< onUnload 调用次数。
+        uint64_t fromDisk = 0;   ///< 从区域文件读出而非生成的区块数。
+        uint64_t saved = 0;      ///< 交给区域文件保存的区块数。
+        uint64_t residencyChecks = 0;  ///< 驻留计算检查过的区块坐标数。
+    };
+
+    /**
+     * @brief 区块流式加载。
+     *
+     * 加载半径内缺失的区块进入待生成队列，按到视野前瞻点（视野中心沿相机速度外推）的距离排序，
+     * 每次 Update 最多把 maxInFlight 个生成任务分发到 JobSystem。生成完成的区块在主线程按时间预算逐个接入并调用 onLoad；
+     * 尚未接入就离开卸载半径的区块被取消，不会触发任何回调。
+     * 每个区块的 onLoad 与 onUnload 严格交替且都在调用 Update 的线程上执行。
+     * 设置了区域存储时，生成任务先尝试从磁盘读取区块，读取失败才调用生成函数；被修改过的区块在卸载时保存。
+     * 驻留计算是增量的：视野中心所在区块不变时不做任何检查，移动时只检查新旧范围逐行相差的区块。
+     */
     class ChunkManager
     {
     public:
+        using ChunkCallback = std::function<void(Chunk&)>;
+
+        static constexpr int DefaultMaxInFlight = 4;
+        static constexpr double DefaultIntegrationBudgetMs = 2.0;
+        static constexpr float DefaultLookAheadSeconds = 0.5f;
+
+        ChunkManager();
+        /// 等待生成任务结束；设置了区域存储时保存所有修改过的区块，不调用 onUnload。
+        ~ChunkManager();
+
+        ChunkManager(const ChunkManager&) = delete;
+        ChunkManager& operator=(const ChunkManager&) = delete;
+
         void SetViewCenter(float worldX, float worldY);
-        void Update();
+
+        /**
+         * @brief 回收完成的生成任务、卸载越界区块、在预算内接入新区块并分发新的生成任务。每帧调用一次。
+         * @param deltaTime 距上次调用的时间，用于估计相机速度；为 0 时不做前瞻。
+         */
+        void Update(float deltaTime = 0.0f);
+
+        /**
+         * @brief 阻塞直到加载半径内的区块全部接入（加载画面、传送后使用），不受时间预算限制。
+         */
+        void Flush();
+
+        /**
+         * @brief 阻塞等待所有已分发的生成任务完成。
+         */
+        void WaitForInFlight();
+
+        /**
+         * @brief 卸载全部区块（逐个调用 onUnload）并取消所有未完成的请求。
+         */
+        void Clear();
+
+        /**
+         * @brief 设置区块持久化存储，之后的加载先读磁盘，修改过的区块卸载时写回。为空时区块卸载即丢弃。
+         */
+        void SetRegionStore(std::shared_ptr<RegionStore> store) { m_regionStore = std::move(store); }
+        const std::shared_ptr<RegionStore>& GetRegionStore() const { return m_regionStore; }
+
+        /**
+         * @brief 把所有已加载且修改过的区块交给区域存储（存档、退出时使用），返回保存的区块数。
+         */
+        size_t SaveAll();
+
         Chunk* GetChunk(ChunkCoord coord);
+        const Chunk* GetChunk(ChunkCoord coord) const;
         Chunk* GetChunkAt(float worldX, float worldY);
         uint16_t GetTileAt(float worldX, float worldY);
         void SetTileAt(float worldX, float worldY, uint16_t tileId);
-        void SetLoadRadius(int chunks) { m_loadRadius = chunks; }
-        void SetUnloadRadius(int chunks) { m_unloadRadius = chunks; }
+        void SetLoadRadius(int chunks);
+        void SetUnloadRadius(int chunks);
         void SetTileSize(float size) { m_tileSize = size; }
         float GetTileSize() const { return m_tileSize; }
 
-        void SetOnChunkLoad(std::function<void(Chunk&)> callback) { m_onChunkLoad = std::move(callback); }
-        void SetOnChunkUnload(std::function<void(Chunk&)> callback) { m_onChunkUnload = std::move(callback); }
+        /**
+         * @brief 设置在工作线程上填充区块内容的生成函数。
+         *
+         * 生成函数可能在多个线程上并发执行，只能写入传入的区块。未设置时区块保持全 0，可在 onLoad 中于主线程填充。
+         */
+        void SetChunkGenerator(ChunkCallback generator);
+        void SetOnChunkLoad(ChunkCallback callback) { m_onChunkLoad = std::move(callback); }
+        void SetOnChunkUnload(ChunkCallback callback) { m_onChunkUnload = std::move(callback); }
+
+        void SetMaxInFlight(int jobs) { m_maxInFlight = std::max(jobs, 1); }
+        /// 每次 Update 接入区块（含 onLoad）的时间预算，每次至少接入一个。
+        void SetIntegrationBudget(double milliseconds) { m_integrationBudgetMs = milliseconds; }
+        /// 按相机速度外推视野中心的时间，外推距离不超过加载半径的一半。
+        void SetLookAhead(float seconds) { m_lookAheadSeconds = seconds; }
 
-        int GetLoadedChunkCount() const { return static_cast<int>(m_loadedChunks.size()); }
+        int GetLoadedChunkCount() const { return static_cast<int>(m_chunks.Size()); }
+        size_t GetPendingCount() const { return m_pending.size(); }
+        size_t GetInFlightCount() const { return m_inFlight.size(); }
+        size_t GetReadyCount() const { return m_ready.size(); }
+        const ChunkStreamingStats& GetStats() const { return m_stats; }
+
+        uint64_t GetRevision() const { return m_revision; }
+
+        /**
+         * @brief 遍历 sinceRevision 之后的瓦片修改：区块加载、卸载与 SetTileAt 写入。
+         *
+         * 绕过管理器直接调用 Chunk::SetTile 的修改不会被记录。
+         * @return 所需记录已被丢弃时返回 false，调用方应全量重建。
+         */
+        template <typename Fn>
+        bool ForEachChangeSince(uint64_t sinceRevision, Fn&& fn) const
+        {
+            if (sinceRevision < m_trimmedRevision) return false;
+            auto it = std::upper_bound(m_changes.begin(), m_changes.end(), sinceRevision,
+                                       [](uint64_t r, const TileRegionChange& change) { return r < change.revision; });
+            for (; it != m_changes.end(); ++it)
+                fn(*it);
+            return true;
+        }
 
     private:
+        static constexpr size_t MaxTrackedChanges = 16384;
+        /// 相机速度指数平滑系数。
+        static constexpr float VelocitySmoothing = 0.25f;
+
+        struct GenerateJob : public IJob
+        {
+            ChunkCoord coord;
+            std::shared_ptr<const ChunkCallback> generator;
+            std::shared_ptr<RegionStore> store;
+            std::unique_ptr<Chunk> chunk;
+            std::atomic<bool> cancelled{false};
+            bool generated = false;
+            bool fromDisk = false;
+
+            void Execute() override;
+        };
+
+        struct InFlight
+        {
+            std::unique_ptr<GenerateJob> job;
+            JobHandle handle;
+        };
+
         ChunkCoord WorldToChunk(float worldX, float worldY) const;
         void WorldToLocal(float worldX, float worldY, ChunkCoord& outChunk, int& outLocalX, int& outLocalY) const;
 
-        std::unordered_map<ChunkCoord, std::unique_ptr<Chunk>, ChunkCoordHash> m_loadedChunks;
+        bool ShouldUnload(ChunkCoord coord) const;
+        /// 越小越先生成与接入。
+        float Priority(ChunkCoord coord) const;
+
+        /// 卸载半径圆与加载区域在第 dy 行的半宽，不含该行时为 -1。
+        int KeepHalfWidth(int dy) const;
+        int LoadHalfWidth(int dy) const;
+        void OnRadiusChanged();
+
+        /// 视野中心换了区块才重新计算驻留：取消、卸载离开范围的区块并请求进入范围的区块。
+        void UpdateResidency();
+        void RequestMissing();
+        /// 只请求以 from 为中心时不在加载区域内的区块。
+        void RequestEntering(ChunkCoord from);
+        void CancelOutOfRange();
+        void CollectCompleted();
+        void UnloadOutOfRange();
+        /// 只检查以 from 为中心时在卸载半径内、现在超出的区块。
+        void UnloadLeaving(ChunkCoord from);
+        void Integrate(double budgetMs);
+        void Dispatch(size_t maxInFlight);
+        void LoadChunk(std::unique_ptr<Chunk> chunk);
+        void UnloadChunk(ChunkCoord coord, Chunk& chunk);
+
+        void RecordChange(int32_t minX, int32_t minY, int32_t maxX, int32_t maxY);
+        void RecordChunkChange(ChunkCoord coord);
+
+        ChunkGrid m_chunks;
+        std::vector<ChunkCoord> m_pending;                 ///< 等待分发的生成请求。
+        std::vector<InFlight> m_inFlight;                  ///< 已分发到工作线程的生成任务。
+        std::vector<std::unique_ptr<Chunk>> m_ready;       ///< 已生成、等待在主线程接入的区块。
+        std::unordered_set<ChunkCoord, ChunkCoordHash> m_requested;  ///< 待生成、生成中或待接入的坐标。
         ChunkCoord m_viewCenter{};
+        float m_viewX = 0.0f;  ///< 视野中心（区块单位）。
+        float m_viewY = 0.0f;
+        float m_lastViewX = 0.0f;
+        float m_lastViewY = 0.0f;
+        float m_velocityX = 0.0f;  ///< 相机速度（每秒区块数）。
+        float m_velocityY = 0.0f;
+        bool m_hasLastView = false;
         int m_loadRadius = 4;
         int m_unloadRadius = 6;
+        std::vector<int> m_keepHalfWidth;  ///< 下标为 |dy|。
+        ChunkCoord m_residentCenter{};     ///< 驻留状态对应的视野中心。
+        bool m_residencyValid = false;     ///< 为 false 时下次全量计算（首次、半径改变、Clear 之后）。
         float m_tileSize = 16.0f;
-        std::function<void(Chunk&)> m_onChunkLoad;
-        std::function<void(Chunk&)> m_onChunkUnload;
+        int m_maxInFlight = DefaultMaxInFlight;
+        double m_integrationBudgetMs = DefaultIntegrationBudgetMs;
+        float m_lookAheadSeconds = DefaultLookAheadSeconds;
+        std::shared_ptr<const ChunkCallback> m_generator;
+        std::shared_ptr<RegionStore> m_regionStore;
+        ChunkCallback m_onChunkLoad;
+        ChunkCallback m_onChunkUnload;
+        ChunkStreamingStats m_stats;
+        uint64_t m_revision = 0;
+        uint64_t m_trimmedRevision = 0;
+        std::vector<TileRegionChange> m_changes;
     };
 }
 
@@ -0,0 +1,393 @@
+#include "PalettedTiles.h"
+#include <algorithm>
+#include <array>
+#include <bit>
+
+namespace WorldStreaming
+{
+    namespace
+    {
+        /// 每个 64 位字容纳 64 / bits 个下标，下标不跨字；返回其以 2 为底的对数。
+        int ShiftFor(int bits)
+        {
+            return 6 - std::countr_zero(static_cast<unsigned>(bits));
+        }
+
+        size_t WordsFor(size_t count, int bits)
+        {
+            if (bits == 0) return 0;
+            const size_t perWord = size_t{1} << ShiftFor(bits);
+            return (count + perWord - 1) / perWord;
+        }
+
+        template <typename T>
+        void FreeVector(std::vector<T>& v)
+        {
+            std::vector<T>().swap(v);
+        }
+    }
+
+    PalettedTiles::PalettedTiles(int width, int height, uint16_t fill)
+        : m_width(static_cast<uint16_t>(width)), m_height(static_cast<uint16_t>(height)), m_uniform(fill), m_live(1)
+    {
+    }
+
+    int PalettedTiles::BitsFor(size_t uniqueCount)
+    {
+        if (uniqueCount <= 1) return 0;
+        if (uniqueCount <= 2) return 1;
+        if (uniqueCount <= 4) return 2;
+        if (uniqueCount <= 16) return 4;
+        if (uniqueCount <= MaxPaletteSize) return 8;
+        return DirectBits;
+    }
+
+    size_t PalettedTiles::PaletteSize() const
+    {
+        if (m_bits == 0) return 1;
+        return m_bits == DirectBits ? 0 : m_live;
+    }
+
+    size_t PalettedTiles::HeapBytes() const
+    {
+        return m_words.capacity() * sizeof(uint64_t) + m_palette.capacity() * sizeof(uint16_t) +
+            m_counts.capacity() * sizeof(uint32_t);
+    }
+
+    uint32_t PalettedTiles::ReadSlot(size_t i) const
+    {
+        const int shift = ShiftFor(m_bits);
+        const unsigned offset = static_cast<unsigned>(i & ((size_t{1} << shift) - 1)) * m_bits;
+        return static_cast<uint32_t>((m_words[i >> shift] >> offset) & ((uint64_t{1} << m_bits) - 1));
+    }
+
+    void PalettedTiles::WriteSlot(size_t i, uint32_t slot)
+    {
+        const int shift = ShiftFor(m_bits);
+        const unsigned offset = static_cast<unsigned>(i & ((size_t{1} << shift) - 1)) * m_bits;
+        const uint64_t mask = ((uint64_t{1} << m_bits) - 1) << offset;
+        uint64_t& word = m_words[i >> shift];
+        word = (word & ~mask) | (static_cast<uint64_t>(slot) << offset);
+    }
+
+    uint16_t PalettedTiles::GetIndex(size_t i) const
+    {
+        if (m_bits == 0) return m_uniform;
+        const uint32_t slot = ReadSlot(i);
+        return m_bits == DirectBits ? static_cast<uint16_t>(slot) : m_palette[slot];
+    }
+
+    void PalettedTiles::SetIndex(size_t i, uint16_t value)
+    {
+        if (m_bits == 0 && value == m_uniform) return;
+        if (m_bits == DirectBits)
+        {
+            WriteSlot(i, value);
+            return;
+        }
+        if (m_bits != 0 && m_palette[ReadSlot(i)] == value) return;
+
+        int slot = FindSlot(value);
+        if (slot < 0)
+        {
+            Reserve(1);
+            if (m_bits == DirectBits)
+            {
+                WriteSlot(i, value);
+                return;
+            }
+            slot = static_cast<int>(Insert(value));
+        }
+        // Reserve 可能重新编码，旧下标在其后读取
+        const uint32_t old = ReadSlot(i);
+        WriteSlot(i, static_cast<uint32_t>(slot));
+        if (m_counts[slot]++ == 0) ++m_live;
+        if (Release(old))
+            Shrink();
+    }
+
+    int PalettedTiles::FindSlot(uint16_t value) const
+    {
+        // 计数为 0 的项仍保留旧编号，命中时直接复用
+        for (size_t s = 0; s < m_palette.size(); ++s)
+        {
+            if (m_palette[s] == value) return static_cast<int>(s);
+        }
+        return -1;
+    }
+
+    void PalettedTiles::Reserve(size_t extra)
+    {
+        if (m_bits == DirectBits) return;
+        const size_t capacity = m_bits == 0 ? 1 : size_t{1} << m_bits;
+        if (m_live + extra <= capacity) return;
+        Repack(BitsFor(m_live + extra));
+    }
+
+    uint32_t PalettedTiles::Insert(uint16_t value)
+    {
+        if (m_live < m_palette.size())
+        {
+            for (size_t s = 0; s < m_counts.size(); ++s)
+            {
+                if (m_counts[s] == 0)
+                {
+                    m_palette[s] = value;
+                    return static_cast<uint32_t>(s);
+                }
+            }
+        }
+        m_palette.push_back(value);
+        m_counts.push_back(0);
+        return static_cast<uint32_t>(m_palette.size() - 1);
+    }
+
+    bool PalettedTiles::Release(uint32_t slot)
+    {
+        if (--m_counts[slot] != 0) return false;
+        --m_live;
+        return true;
+    }
+
+    void PalettedTiles::Shrink()
+    {
+        if (m_bits == 0 || m_bits == DirectBits) return;
+        // 至少省下两级位宽才重新编码，避免在边界上反复升降
+        const int target = BitsFor(m_live);
+        if (target == 0 || target * 4 <= m_bits)
+            Repack(target);
+    }
+
+    void PalettedTiles::Fill(uint16_t value)
+    {
+        m_bits = 0;
+        m_uniform = value;
+        m_live = 1;
+        FreeVector(m_palette);
+        FreeVector(m_counts);
+        FreeVector(m_words);
+    }
+
+    void PalettedTiles::Assign(const uint16_t* values)
+    {
+        Encode(values, 0);
+    }
+
+    void PalettedTiles::CopyTo(uint16_t* out) const
+    {
+        GetRegion(0, 0, m_width, m_height, out);
+    }
+
+    void PalettedTiles::Compact()
+    {
+        if (m_bits == 0) return;
+        Encode(Decode().data(), 0);
+    }
+
+    void PalettedTiles::GetRegion(int x, int y, int w, int h, uint16_t* out) const
+    {
+        if (w <= 0 || h <= 0) return;
+        if (m_bits == 0)
+        {
+            std::fill_n(out, static_cast<size_t>(w) * h, m_uniform);
+            return;
+        }
+        const int shift = ShiftFor(m_bits);
+        const uint64_t mask = (uint64_t{1} << m_bits) - 1;
+        for (int row = 0; row < h; ++row)
+        {
+            size_t i = static_cast<size_t>(y + row) * m_width + x;
+            const size_t end = i + w;
+            uint16_t* dst = out + static_cast<size_t>(row) * w;
+            // 逐字解码：每个字只读一次，再依次移出各个下标
+            while (i < end)
+            {
+                const size_t wordIndex = i >> shift;
+                const size_t stop = std::min(end, (wordIndex + 1) << shift);
+                uint64_t word = m_words[wordIndex] >> ((i & ((size_t{1} << shift) - 1)) * m_bits);
+                if (m_bits == DirectBits)
+                {
+                    for (; i < stop; ++i, word >>= DirectBits)
+                        *dst++ = static_cast<uint16_t>(word);
+                }
+                else
+                {
+                    for (; i < stop; ++i, word >>= m_bits)
+                        *dst++ = m_palette[word & mask];
+                }
+            }
+        }
+    }
+
+    void PalettedTiles::SetRegion(int x, int y, int w, int h, const uint16_t* values)
+    {
+        WriteRegion(x, y, w, h, values, false);
+    }
+
+    void PalettedTiles::FillRegion(int x, int y, int w, int h, uint16_t value)
+    {
+        WriteRegion(x, y, w, h, &value, true);
+    }
+
+    void PalettedTiles::WriteRegion(int x, int y, int w, int h, const uint16_t* values, bool broadcast)
+    {
+        if (w <= 0 || h <= 0) return;
+        if (x == 0 && y == 0 && w == m_width && h == m_height)
+        {
+            if (broadcast)
+                Fill(values[0]);
+            else
+                Assign(values);
+            return;
+        }
+
+        const size_t count = broadcast ? 1 : static_cast<size_t>(w) * h;
+        if (m_bits != DirectBits)
+        {
+            // 先统计当前不在用的编号，一次升级到位，写入期间下标不再变化。
+            // 计数为 0 的旧项被重新启用时同样占用一个名额，否则后续 Insert 会越过位宽
+            std::vector<uint16_t> missing;
+            for (size_t i = 0; i < count && m_live + missing.size() <= MaxPaletteSize; ++i)
+            {
+                const uint16_t value = values[i];
+                if (i > 0 && value == values[i - 1]) continue;
+                const int found = m_bits == 0 ? -1 : FindSlot(value);
+                const bool known = m_bits == 0 ? value == m_uniform : found >= 0 && m_counts[found] > 0;
+                if (!known && std::find(missing.begin(), missing.end(), value) == missing.end())
+                    missing.push_back(value);
+            }
+            if (missing.empty() && m_bits == 0) return;
+            Reserve(missing.size());
+        }
+
+        if (m_bits == DirectBits)
+        {
+            for (int row = 0; row < h; ++row)
+            {
+                const size_t base = static_cast<size_t>(y + row) * m_width + x;
+                for (int col = 0; col < w; ++col)
+                    WriteSlot(base + col, broadcast ? values[0] : values[static_cast<size_t>(row) * w + col]);
+            }
+            return;
+        }
+
+        const int shift = ShiftFor(m_bits);
+        const uint64_t mask = (uint64_t{1} << m_bits) - 1;
+        bool released = false;
+        uint64_t slot = 0;
+        uint16_t slotValue = 0;
+        bool slotValid = false;
+        for (int row = 0; row < h; ++row)
+        {
+            size_t i = static_cast<size_t>(y + row) * m_width + x;
+            const size_t end = i + w;
+            const uint16_t* src = broadcast ? values : values + static_cast<size_t>(row) * w;
+            while (i < end)
+            {
+                const size_t wordIndex = i >> shift;
+                const size_t stop = std::min(end, (wordIndex + 1) << shift);
+                unsigned offset = static_cast<unsigned>(i & ((size_t{1} << shift) - 1)) * m_bits;
+                uint64_t word = m_words[wordIndex];
+                for (; i < stop; ++i, offset += m_bits)
+                {
+                    const uint16_t value = *src;
+                    if (!broadcast) ++src;
+                    if (!slotValid || value != slotValue)
+                    {
+                        slotValue = value;
+                        const int found = FindSlot(value);
+                        slot = found >= 0 ? static_cast<uint64_t>(found) : Insert(value);
+                        slotValid = true;
+                    }
+                    const uint32_t old = static_cast<uint32_t>((word >> offset) & mask);
+                    if (old == slot) continue;
+                    word = (word & ~(mask << offset)) | (slot << offset);
+                    if (m_counts[slot]++ == 0) ++m_live;
+                    released |= Release(old);
+                }
+                m_words[wordIndex] = word;
+            }
+        }
+        if (released)
+            Shrink();
+    }
+
+    std::vector<uint16_t> PalettedTiles::Decode() const
+    {
+        std::vector<uint16_t> values(Count());
+        CopyTo(values.data());
+        return values;
+    }
+
+    void PalettedTiles::Repack(int bits)
+    {
+        Encode(Decode().data(), bits);
+    }
+
+    void PalettedTiles::Encode(const uint16_t* values, int minBits)
+    {
+        const size_t count = Count();
+        std::vector<uint16_t> palette;
+        std::array<uint32_t, MaxPaletteSize> counts{};
+        std::vector<uint8_t> slots(count);
+        bool direct = minBits == DirectBits;
+        uint16_t current = 0;
+        size_t slot = 0;
+        size_t runStart = 0;
+        for (size_t i = 0; i < count && !direct; ++i)
+        {
+            const uint16_t value = values[i];
+            if (i == 0 || value != current)
+            {
+                // 按游程累计引用计数，避免每格都读改写同一个计数
+                if (i > 0) counts[slot] += static_cast<uint32_t>(i - runStart);
+                runStart = i;
+                current = value;
+                slot = std::find(palette.begin(), palette.end(), value) - palette.begin();
+                if (slot == palette.size())
+                {
+                    // 超过 256 种瓦片时下标不比编号本身小，改为直接存储
+                    direct = palette.size() == MaxPaletteSize;
+                    if (direct) break;
+                    palette.push_back(value);
+                }
+            }
+            slots[i] = static_cast<uint8_t>(slot);
+        }
+        if (!direct && count > 0) counts[slot] += static_cast<uint32_t>(count - runStart);
+
+        if (direct)
+        {
+            m_bits = DirectBits;
+            m_live = 0;
+            FreeVector(m_palette);
+            FreeVector(m_counts);
+            std::vector<uint64_t>(WordsFor(count, m_bits)).swap(m_words);
+            for (size_t i = 0; i < count; ++i)
+                WriteSlot(i, values[i]);
+            return;
+        }
+        if (palette.size() <= 1 && minBits == 0)
+        {
+            Fill(palette.empty() ? 0 : palette[0]);
+            return;
+        }
+
+        m_bits = static_cast<uint8_t>(std::max({BitsFor(palette.size()), minBits, 1}));
+        m_live = static_cast<uint16_t>(palette.size());
+        m_palette.swap(palette);
+        std::vector<uint32_t>(counts.begin(), counts.begin() + m_live).swap(m_counts);
+        std::vector<uint64_t>(WordsFor(count, m_bits)).swap(m_words);
+        // 按字顺序打包，比逐个 WriteSlot 少一半访存
+        const size_t perWord = size_t{1} << ShiftFor(m_bits);
+        for (size_t w = 0; w < m_words.size(); ++w)
+        {
+            const size_t begin = w * perWord;
+            const size_t end = std::min(begin + perWord, count);
+            uint64_t word = 0;
+            for (size_t i = begin; i < end; ++i)
+                word |= static_cast<uint64_t>(slots[i]) << ((i - begin) * m_bits);
+            m_words[w] = word;
+        }
+    }
+}
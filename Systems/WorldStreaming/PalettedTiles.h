@@ -0,0 +1,99 @@
+#ifndef PALETTEDTILES_H
+#define PALETTEDTILES_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace WorldStreaming
+{
+    /**
+     * @brief 调色板压缩的瓦片存储。
+     *
+     * 只有一种瓦片时不分配数组；否则保存去重后的瓦片编号（调色板）与按调色板大小位打包的下标，
+     * 每个下标占 1、2、4 或 8 位，调色板超过 256 项时直接保存 16 位编号。
+     * 写入新编号时自动升级位宽；调色板项的引用计数归零后，若能省下至少两级位宽则自动降级。
+     * 直接存储模式不维护计数，只在整体写入（Fill、Assign、覆盖全部的区域写入）或 Compact 时降级。
+     * 坐标由调用方保证在范围内。
+     */
+    class PalettedTiles
+    {
+    public:
+        static constexpr int DirectBits = 16;
+        static constexpr size_t MaxPaletteSize = 256;
+
+        PalettedTiles(int width, int height, uint16_t fill = 0);
+
+        int Width() const { return m_width; }
+        int Height() const { return m_height; }
+        size_t Count() const { return static_cast<size_t>(m_width) * m_height; }
+
+        uint16_t Get(int x, int y) const { return GetIndex(static_cast<size_t>(y) * m_width + x); }
+        void Set(int x, int y, uint16_t value) { SetIndex(static_cast<size_t>(y) * m_width + x, value); }
+
+        void Fill(uint16_t value);
+
+        /// 按行优先顺序读出或写入 Count() 个瓦片。
+        void CopyTo(uint16_t* out) const;
+        void Assign(const uint16_t* values);
+
+        void GetRow(int y, uint16_t* out) const { GetRegion(0, y, m_width, 1, out); }
+        void SetRow(int y, const uint16_t* values) { SetRegion(0, y, m_width, 1, values); }
+
+        /// 矩形 [x, x + w) x [y, y + h) 的瓦片，按行优先顺序排列。
+        void GetRegion(int x, int y, int w, int h, uint16_t* out) const;
+        void SetRegion(int x, int y, int w, int h, const uint16_t* values);
+        void FillRegion(int x, int y, int w, int h, uint16_t value);
+
+        /**
+         * @brief 按当前内容重建最小的调色板与位宽。
+         */
+        void Compact();
+
+        /// 0 表示单一瓦片，16 表示直接存储。
+        int BitsPerIndex() const { return m_bits; }
+        /// 不同瓦片的数量；直接存储时返回 0（未统计）。
+        size_t PaletteSize() const;
+        bool IsUniform() const { return m_bits == 0; }
+        /// 堆上占用的字节数。
+        size_t HeapBytes() const;
+
+        /// 容纳 n 种瓦片所需的最小位宽。
+        static int BitsFor(size_t uniqueCount);
+
+    private:
+        uint16_t GetIndex(size_t i) const;
+        void SetIndex(size_t i, uint16_t value);
+        /// broadcast 为 true 时整个区域写入 values[0]。
+        void WriteRegion(int x, int y, int w, int h, const uint16_t* values, bool broadcast);
+
+        uint32_t ReadSlot(size_t i) const;
+        void WriteSlot(size_t i, uint32_t slot);
+
+        int FindSlot(uint16_t value) const;
+        /// 确保调色板还能再容纳 extra 种瓦片，不够时升级位宽（可能转为直接存储）。
+        void Reserve(size_t extra);
+        /// 把 value 放进空闲或新增的调色板项，需先 Reserve。
+        uint32_t Insert(uint16_t value);
+        /// 返回该项是否因此空闲。
+        bool Release(uint32_t slot);
+        /// 调色板项减少后按需降级。
+        void Shrink();
+
+        std::vector<uint16_t> Decode() const;
+        /// 从稠密数组重建，位宽不小于 minBits。
+        void Encode(const uint16_t* values, int minBits);
+        void Repack(int bits);
+
+        uint16_t m_width;
+        uint16_t m_height;
+        uint8_t m_bits = 0;
+        uint16_t m_uniform = 0;
+        uint16_t m_live = 0;                ///< 计数非 0 的调色板项数。
+        std::vector<uint16_t> m_palette;    ///< 计数为 0 的项可被复用。
+        std::vector<uint32_t> m_counts;
+        std::vector<uint64_t> m_words;
+    };
+}
+
+#endif
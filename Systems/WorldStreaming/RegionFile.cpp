@@ -0,0 +1,253 @@
+#include "RegionFile.h"
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace WorldStreaming
+{
+    namespace
+    {
+        constexpr size_t TileCount = static_cast<size_t>(Chunk::SIZE) * Chunk::SIZE;
+
+        std::array<uint32_t, 256> MakeCrcTable()
+        {
+            std::array<uint32_t, 256> table{};
+            for (uint32_t i = 0; i < 256; ++i)
+            {
+                uint32_t c = i;
+                for (int k = 0; k < 8; ++k)
+                    c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+                table[i] = c;
+            }
+            return table;
+        }
+
+        int32_t FloorDiv(int32_t value, int32_t divisor)
+        {
+            return value >= 0 ? value / divisor : (value - divisor + 1) / divisor;
+        }
+
+        bool FlushToDisk(FILE* file)
+        {
+            if (std::fflush(file) != 0) return false;
+#ifdef _WIN32
+            return _commit(_fileno(file)) == 0;
+#else
+            return fsync(fileno(file)) == 0;
+#endif
+        }
+    }
+
+    namespace RegionFormat
+    {
+        uint32_t Crc32(const uint8_t* data, size_t size)
+        {
+            static const std::array<uint32_t, 256> table = MakeCrcTable();
+            uint32_t crc = 0xFFFFFFFFu;
+            for (size_t i = 0; i < size; ++i)
+                crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+            return crc ^ 0xFFFFFFFFu;
+        }
+
+        std::vector<uint8_t> EncodeTiles(const std::vector<uint16_t>& tiles, Encoding& outEncoding)
+        {
+            std::vector<uint16_t> runs;
+            for (size_t i = 0; i < tiles.size() && runs.size() < tiles.size();)
+            {
+                size_t end = i + 1;
+                while (end < tiles.size() && tiles[end] == tiles[i] && end - i < UINT16_MAX)
+                    ++end;
+                runs.push_back(static_cast<uint16_t>(end - i));
+                runs.push_back(tiles[i]);
+                i = end;
+            }
+
+            // 游程编码不比原样小时（噪声很多的区块）直接保存原始瓦片
+            const std::vector<uint16_t>& source = runs.size() < tiles.size() ? runs : tiles;
+            outEncoding = runs.size() < tiles.size() ? Encoding::RunLength : Encoding::Raw;
+            std::vector<uint8_t> data(source.size() * sizeof(uint16_t));
+            if (!data.empty())
+                std::memcpy(data.data(), source.data(), data.size());
+            return data;
+        }
+
+        bool DecodeTiles(const uint8_t* data, size_t size, Encoding encoding, std::vector<uint16_t>& outTiles)
+        {
+            if (size % sizeof(uint16_t) != 0) return false;
+            const size_t words = size / sizeof(uint16_t);
+            if (encoding == Encoding::Raw)
+            {
+                if (words != TileCount) return false;
+                outTiles.resize(TileCount);
+                std::memcpy(outTiles.data(), data, size);
+                return true;
+            }
+            if (encoding != Encoding::RunLength || words % 2 != 0) return false;
+
+            outTiles.clear();
+            outTiles.reserve(TileCount);
+            for (size_t i = 0; i < words; i += 2)
+            {
+                uint16_t count, tile;
+                std::memcpy(&count, data + i * sizeof(uint16_t), sizeof(uint16_t));
+                std::memcpy(&tile, data + (i + 1) * sizeof(uint16_t), sizeof(uint16_t));
+                if (count == 0 || outTiles.size() + count > TileCount) return false;
+                outTiles.insert(outTiles.end(), count, tile);
+            }
+            return outTiles.size() == TileCount;
+        }
+
+        RegionCoord RegionOf(ChunkCoord coord)
+        {
+            return {FloorDiv(coord.x, RegionSize), FloorDiv(coord.y, RegionSize)};
+        }
+
+        int IndexInRegion(ChunkCoord coord)
+        {
+            const RegionCoord region = RegionOf(coord);
+            return (coord.y - region.y * RegionSize) * RegionSize + (coord.x - region.x * RegionSize);
+        }
+
+        ChunkCoord ChunkAt(RegionCoord region, int index)
+        {
+            return {region.x * RegionSize + index % RegionSize, region.y * RegionSize + index / RegionSize};
+        }
+
+        std::filesystem::path RegionPath(const std::filesystem::path& directory, RegionCoord region)
+        {
+            return directory / ("r." + std::to_string(region.x) + "." + std::to_string(region.y) + ".lmr");
+        }
+    }
+
+    bool RegionFile::Open(const std::filesystem::path& path)
+    {
+        using namespace RegionFormat;
+        Close();
+        if (!m_file.Open(path)) return false;
+
+        FileHeader header;
+        if (m_file.Size() < DataOffset) return true;
+        std::memcpy(&header, m_file.Data(), sizeof(header));
+        if (header.magic != Magic || header.version != Version || header.regionSize != RegionSize ||
+            header.chunkSize != Chunk::SIZE || header.reserved != 0)
+            return true;
+        const uint8_t* table = m_file.Data() + TableOffset;
+        if (Crc32(table, sizeof(ChunkEntry) * ChunksPerRegion) != header.tableCrc) return true;
+
+        m_table = reinterpret_cast<const ChunkEntry*>(table);
+        m_headerValid = true;
+        return true;
+    }
+
+    void RegionFile::Close()
+    {
+        m_file.Close();
+        m_table = nullptr;
+        m_headerValid = false;
+    }
+
+    bool RegionFile::Has(int index) const
+    {
+        return m_headerValid && index >= 0 && index < RegionFormat::ChunksPerRegion && m_table[index].offset != 0;
+    }
+
+    RegionFile::ReadResult RegionFile::Locate(int index, const uint8_t*& outData, RegionFormat::ChunkEntry& outEntry) const
+    {
+        using namespace RegionFormat;
+        if (!m_file.IsOpen()) return ReadResult::Missing;
+        if (!m_headerValid) return ReadResult::Corrupt;
+        if (index < 0 || index >= ChunksPerRegion || m_table[index].offset == 0) return ReadResult::Missing;
+
+        outEntry = m_table[index];
+        if (outEntry.offset < DataOffset || outEntry.offset > m_file.Size() ||
+            outEntry.size > m_file.Size() - outEntry.offset)
+            return ReadResult::Corrupt;
+        outData = m_file.Data() + outEntry.offset;
+        if (Crc32(outData, outEntry.size) != outEntry.crc) return ReadResult::Corrupt;
+        return ReadResult::Ok;
+    }
+
+    RegionFile::ReadResult RegionFile::ReadChunk(int index, std::vector<uint16_t>& outTiles) const
+    {
+        const uint8_t* data = nullptr;
+        RegionFormat::ChunkEntry entry;
+        const ReadResult result = Locate(index, data, entry);
+        if (result != ReadResult::Ok) return result;
+        return RegionFormat::DecodeTiles(data, entry.size, static_cast<RegionFormat::Encoding>(entry.encoding),
+                                         outTiles)
+                   ? ReadResult::Ok
+                   : ReadResult::Corrupt;
+    }
+
+    RegionFile::ReadResult RegionFile::ReadRaw(int index, std::vector<uint8_t>& outData,
+                                               RegionFormat::Encoding& outEncoding) const
+    {
+        const uint8_t* data = nullptr;
+        RegionFormat::ChunkEntry entry;
+        const ReadResult result = Locate(index, data, entry);
+        if (result != ReadResult::Ok) return result;
+        outData.assign(data, data + entry.size);
+        outEncoding = static_cast<RegionFormat::Encoding>(entry.encoding);
+        return ReadResult::Ok;
+    }
+
+    void RegionFileBuilder::SetChunk(int index, std::vector<uint8_t> data, RegionFormat::Encoding encoding)
+    {
+        if (index < 0 || index >= RegionFormat::ChunksPerRegion) return;
+        m_slots[index] = {std::move(data), encoding, true};
+    }
+
+    bool RegionFileBuilder::Empty() const
+    {
+        for (const auto& slot : m_slots)
+        {
+            if (slot.present) return false;
+        }
+        return true;
+    }
+
+    bool RegionFileBuilder::WriteToFile(const std::filesystem::path& path) const
+    {
+        using namespace RegionFormat;
+        std::vector<ChunkEntry> table(ChunksPerRegion);
+        size_t offset = DataOffset;
+        for (int i = 0; i < ChunksPerRegion; ++i)
+        {
+            const Slot& slot = m_slots[i];
+            if (!slot.present) continue;
+            // 空数据也要有非 0 偏移，0 表示区块不存在
+            table[i] = {static_cast<uint32_t>(offset), static_cast<uint32_t>(slot.data.size()),
+                        Crc32(slot.data.data(), slot.data.size()), static_cast<uint32_t>(slot.encoding)};
+            offset += slot.data.size();
+            if (offset > UINT32_MAX) return false;
+        }
+
+        FileHeader header;
+        header.tableCrc = Crc32(reinterpret_cast<const uint8_t*>(table.data()), sizeof(ChunkEntry) * table.size());
+
+#ifdef _WIN32
+        FILE* file = _wfopen(path.c_str(), L"wb");
+#else
+        FILE* file = std::fopen(path.c_str(), "wb");
+#endif
+        if (!file) return false;
+        bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1 &&
+            std::fwrite(table.data(), sizeof(ChunkEntry), table.size(), file) == table.size();
+        for (int i = 0; ok && i < ChunksPerRegion; ++i)
+        {
+            const Slot& slot = m_slots[i];
+            if (slot.present && !slot.data.empty())
+                ok = std::fwrite(slot.data.data(), 1, slot.data.size(), file) == slot.data.size();
+        }
+        ok = ok && FlushToDisk(file);
+        ok = std::fclose(file) == 0 && ok;
+        return ok;
+    }
+}
@@ -0,0 +1,154 @@
+#ifndef REGIONFILE_H
+#define REGIONFILE_H
+
+#include "Chunk.h"
+#include "../../Utils/MappedFile.h"
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+namespace WorldStreaming
+{
+    /**
+     * @brief 区域坐标，一个区域文件保存 RegionSize x RegionSize 个区块。
+     */
+    struct RegionCoord
+    {
+        int32_t x = 0;
+        int32_t y = 0;
+        bool operator==(const RegionCoord&) const = default;
+    };
+
+    struct RegionCoordHash
+    {
+        size_t operator()(const RegionCoord& c) const
+        {
+            // 与区块坐标共用充分混合的哈希，避免对角线与负坐标上的聚集
+            return ChunkCoordHash{}(ChunkCoord{c.x, c.y});
+        }
+    };
+
+    /**
+     * @brief 区域文件格式。
+     *
+     * 文件由头部、偏移表和区块数据组成。偏移表按区块在区域内的下标排列，offset 为 0 表示该区块不存在。
+     * 每个区块的数据单独压缩并带 CRC32，偏移表自身也有 CRC32；校验失败的区块视为不存在。
+     */
+    namespace RegionFormat
+    {
+        constexpr uint32_t Magic = 0x47524D4C; // "LMRG"
+        constexpr uint32_t Version = 1;
+        constexpr int RegionSize = 32;
+        constexpr int ChunksPerRegion = RegionSize * RegionSize;
+
+        enum class Encoding : uint32_t
+        {
+            Raw = 0,        ///< 原样保存的 uint16 瓦片。
+            RunLength = 1,  ///< (count, tile) 对，count 为 uint16。
+            PixelChunk = 2  ///< 像素区块的压缩数据，由使用方解码，只能通过 ReadRaw 读取。
+        };
+
+        struct FileHeader
+        {
+            uint32_t magic = Magic;
+            uint32_t version = Version;
+            uint32_t regionSize = RegionSize;
+            uint32_t chunkSize = Chunk::SIZE;
+            uint32_t tableCrc = 0;
+            uint32_t reserved = 0;
+        };
+
+        struct ChunkEntry
+        {
+            uint32_t offset = 0;
+            uint32_t size = 0;
+            uint32_t crc = 0;
+            uint32_t encoding = 0;
+        };
+
+        constexpr size_t TableOffset = sizeof(FileHeader);
+        constexpr size_t DataOffset = TableOffset + sizeof(ChunkEntry) * ChunksPerRegion;
+
+        uint32_t Crc32(const uint8_t* data, size_t size);
+
+        /**
+         * @brief 压缩一个区块的瓦片，选择 Raw 与 RunLength 中较小的一种。
+         */
+        std::vector<uint8_t> EncodeTiles(const std::vector<uint16_t>& tiles, Encoding& outEncoding);
+
+        /**
+         * @brief 解压到 Chunk::SIZE * Chunk::SIZE 个瓦片；数据长度或游程与区块大小不符时返回 false。
+         */
+        bool DecodeTiles(const uint8_t* data, size_t size, Encoding encoding, std::vector<uint16_t>& outTiles);
+
+        RegionCoord RegionOf(ChunkCoord coord);
+        /// 区块在区域内的下标。
+        int IndexInRegion(ChunkCoord coord);
+        ChunkCoord ChunkAt(RegionCoord region, int index);
+        std::filesystem::path RegionPath(const std::filesystem::path& directory, RegionCoord region);
+    }
+
+    /**
+     * @brief 区域文件的只读视图，通过内存映射读取。
+     */
+    class RegionFile
+    {
+    public:
+        enum class ReadResult
+        {
+            Ok,
+            Missing,  ///< 文件或区块不存在。
+            Corrupt   ///< 偏移越界、校验失败或解压失败。
+        };
+
+        /**
+         * @brief 打开并校验头部与偏移表。文件不存在时返回 false；头部损坏时返回 true 但所有区块都报告 Corrupt。
+         */
+        bool Open(const std::filesystem::path& path);
+        void Close();
+
+        bool IsOpen() const { return m_file.IsOpen(); }
+        bool Has(int index) const;
+
+        ReadResult ReadChunk(int index, std::vector<uint16_t>& outTiles) const;
+
+        /**
+         * @brief 取出区块的压缩数据（已校验），用于写回时原样复制。
+         */
+        ReadResult ReadRaw(int index, std::vector<uint8_t>& outData, RegionFormat::Encoding& outEncoding) const;
+
+    private:
+        ReadResult Locate(int index, const uint8_t*& outData, RegionFormat::ChunkEntry& outEntry) const;
+
+        MappedFile m_file;
+        const RegionFormat::ChunkEntry* m_table = nullptr;
+        bool m_headerValid = false;
+    };
+
+    /**
+     * @brief 组装一个区域文件的内容。
+     */
+    class RegionFileBuilder
+    {
+    public:
+        void SetChunk(int index, std::vector<uint8_t> data, RegionFormat::Encoding encoding);
+        bool Empty() const;
+
+        /**
+         * @brief 写入文件并刷到磁盘。调用方应写到临时文件后再重命名替换目标，崩溃时目标文件要么是旧版本要么是新版本。
+         */
+        bool WriteToFile(const std::filesystem::path& path) const;
+
+    private:
+        struct Slot
+        {
+            std::vector<uint8_t> data;
+            RegionFormat::Encoding encoding = RegionFormat::Encoding::Raw;
+            bool present = false;
+        };
+
+        Slot m_slots[RegionFormat::ChunksPerRegion];
+    };
+}
+
+#endif
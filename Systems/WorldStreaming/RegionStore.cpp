@@ -0,0 +1,312 @@
+#include "RegionStore.h"
+#include "../../Utils/Logger.h"
+#include <algorithm>
+#include <map>
+#include <system_error>
+
+namespace WorldStreaming
+{
+    namespace
+    {
+        /// 缓存的区域文件映射超过该数量时全部关闭。
+        constexpr size_t MaxCachedRegions = 64;
+
+        struct RegionLess
+        {
+            bool operator()(const RegionCoord& a, const RegionCoord& b) const
+            {
+                return a.y != b.y ? a.y < b.y : a.x < b.x;
+            }
+        };
+    }
+
+    RegionStore::RegionStore(std::filesystem::path directory, std::chrono::milliseconds batchDelay)
+        : m_directory(std::move(directory)), m_batchDelay(batchDelay)
+    {
+        m_thread = std::thread(&RegionStore::WriterLoop, this);
+    }
+
+    RegionStore::~RegionStore()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_wake.notify_all();
+        if (m_thread.joinable())
+            m_thread.join();
+    }
+
+    bool RegionStore::Load(ChunkCoord coord, std::vector<uint16_t>& outTiles)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        auto it = m_pending.find(coord);
+        if (it != m_pending.end())
+        {
+            if (!it->second.tiles) return false;
+            const std::shared_ptr<const std::vector<uint16_t>> tiles = it->second.tiles;
+            ++m_stats.chunksRead;
+            lock.unlock();
+            outTiles = *tiles;
+            return true;
+        }
+
+        const RegionCoord regionCoord = RegionFormat::RegionOf(coord);
+        const std::shared_ptr<const RegionFile> region = PinRegion(regionCoord, lock);
+        lock.unlock();
+        const RegionFile::ReadResult result = region->ReadChunk(RegionFormat::IndexInRegion(coord), outTiles);
+        lock.lock();
+        return FinishRead(regionCoord, coord, result);
+    }
+
+    void RegionStore::Save(ChunkCoord coord, std::vector<uint16_t> tiles)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_pending[coord] = {std::make_shared<const std::vector<uint16_t>>(std::move(tiles)), nullptr,
+                                RegionFormat::Encoding::Raw, ++m_nextSequence};
+        }
+        m_wake.notify_all();
+    }
+
+    void RegionStore::SaveEncoded(ChunkCoord coord, std::vector<uint8_t> data, RegionFormat::Encoding encoding)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            PendingChunk& pending = m_pending[coord];
+            pending.tiles.reset();
+            pending.encoded = std::make_shared<const std::vector<uint8_t>>(std::move(data));
+            pending.encoding = encoding;
+            pending.sequence = ++m_nextSequence;
+        }
+        m_wake.notify_all();
+    }
+
+    bool RegionStore::LoadEncoded(ChunkCoord coord, std::vector<uint8_t>& outData, RegionFormat::Encoding& outEncoding)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        auto it = m_pending.find(coord);
+        if (it != m_pending.end())
+        {
+            // 队列中的数据不可变，持有引用后即可在锁外复制或编码
+            const PendingChunk pending = it->second;
+            ++m_stats.chunksRead;
+            lock.unlock();
+            if (pending.encoded)
+            {
+                outData = *pending.encoded;
+                outEncoding = pending.encoding;
+            }
+            else
+            {
+                outData = RegionFormat::EncodeTiles(*pending.tiles, outEncoding);
+            }
+            return true;
+        }
+
+        const RegionCoord regionCoord = RegionFormat::RegionOf(coord);
+        const std::shared_ptr<const RegionFile> region = PinRegion(regionCoord, lock);
+        lock.unlock();
+        const RegionFile::ReadResult result = region->ReadRaw(RegionFormat::IndexInRegion(coord), outData, outEncoding);
+        lock.lock();
+        return FinishRead(regionCoord, coord, result);
+    }
+
+    void RegionStore::Flush()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        const uint64_t target = m_nextSequence;
+        if (m_writtenSequence >= target) return;
+        m_flushSequence = std::max(m_flushSequence, target);
+        m_wake.notify_all();
+        m_idle.wait(lock, [&] { return m_writtenSequence >= target; });
+    }
+
+    size_t RegionStore::GetPendingCount() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_pending.size();
+    }
+
+    RegionStoreStats RegionStore::GetStats() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_stats;
+    }
+
+    std::shared_ptr<const RegionFile> RegionStore::PinRegion(RegionCoord region, std::unique_lock<std::mutex>& lock)
+    {
+        m_regionIdle.wait(lock, [&]
+        {
+            auto it = m_regions.find(region);
+            return it == m_regions.end() || !it->second.replacing;
+        });
+
+        if (m_regions.size() >= MaxCachedRegions && m_regions.find(region) == m_regions.end())
+        {
+            // 正在使用的映射由读者持有，淘汰时跳过
+            std::erase_if(m_regions, [](const auto& entry)
+            {
+                return entry.second.readers == 0 && !entry.second.replacing;
+            });
+        }
+
+        CachedRegion& cached = m_regions[region];
+        ++cached.readers;
+        if (cached.file) return cached.file;
+
+        // 打开与校验头部在锁外进行；已登记为读者，写线程不会在此期间替换文件
+        lock.unlock();
+        auto file = std::make_shared<RegionFile>();
+        file->Open(RegionFormat::RegionPath(m_directory, region));
+        lock.lock();
+
+        // 不存在的文件也缓存，避免反复打开；写入时会移除对应条目
+        CachedRegion& entry = m_regions[region];
+        if (!entry.file) entry.file = std::move(file);
+        return entry.file;
+    }
+
+    bool RegionStore::FinishRead(RegionCoord region, ChunkCoord coord, RegionFile::ReadResult result)
+    {
+        auto it = m_regions.find(region);
+        if (it != m_regions.end() && --it->second.readers == 0 && it->second.replacing)
+            m_regionIdle.notify_all();
+
+        switch (result)
+        {
+        case RegionFile::ReadResult::Ok:
+            ++m_stats.chunksRead;
+            return true;
+        case RegionFile::ReadResult::Corrupt:
+            ++m_stats.corruptChunks;
+            LogWarn("RegionStore: chunk ({}, {}) is corrupt, regenerating", coord.x, coord.y);
+            return false;
+        default:
+            return false;
+        }
+    }
+
+    void RegionStore::WriterLoop()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (true)
+        {
+            m_wake.wait(lock, [&] { return m_stop || m_writtenSequence < m_nextSequence; });
+            if (m_writtenSequence >= m_nextSequence) break;
+
+            // 攒一批，减少同一区域文件的重写次数；Flush 与析构不等待
+            if (!m_stop && m_flushSequence <= m_writtenSequence)
+                m_wake.wait_for(lock, m_batchDelay, [&] { return m_stop || m_flushSequence > m_writtenSequence; });
+
+            const uint64_t batchSequence = m_nextSequence;
+            std::map<RegionCoord, std::vector<std::pair<ChunkCoord, PendingChunk>>, RegionLess> batch;
+            for (const auto& [coord, chunk] : m_pending)
+                batch[RegionFormat::RegionOf(coord)].emplace_back(coord, chunk);
+
+            lock.unlock();
+            std::vector<RegionCoord> written;
+            for (const auto& [region, chunks] : batch)
+            {
+                if (WriteRegion(region, chunks))
+                    written.push_back(region);
+            }
+            lock.lock();
+
+            bool failed = false;
+            for (const auto& [region, chunks] : batch)
+            {
+                if (std::find(written.begin(), written.end(), region) == written.end())
+                {
+                    failed = true;
+                    ++m_stats.writeFailures;
+                    continue;
+                }
+                // 写入期间又被保存的区块留在队列中
+                for (const auto& [coord, chunk] : chunks)
+                {
+                    auto it = m_pending.find(coord);
+                    if (it != m_pending.end() && it->second.sequence == chunk.sequence)
+                        m_pending.erase(it);
+                }
+                ++m_stats.regionsWritten;
+                m_stats.chunksWritten += chunks.size();
+            }
+            m_writtenSequence = batchSequence;
+            m_idle.notify_all();
+
+            if (failed)
+            {
+                // 失败的区块留待下一次保存时重试；退出时放弃，避免反复失败无法结束
+                LogError("RegionStore: failed to write region files in {}", m_directory.string());
+                if (m_stop) break;
+            }
+        }
+    }
+
+    bool RegionStore::WriteRegion(RegionCoord region, const std::vector<std::pair<ChunkCoord, PendingChunk>>& chunks)
+    {
+        const std::filesystem::path path = RegionFormat::RegionPath(m_directory, region);
+        RegionFileBuilder builder;
+        uint64_t corrupt = 0;
+        {
+            // 只有本线程会替换区域文件，因此可以不加锁地读取旧文件；映射在重命名前关闭
+            RegionFile existing;
+            if (existing.Open(path))
+            {
+                std::vector<uint8_t> data;
+                RegionFormat::Encoding encoding;
+                for (int i = 0; i < RegionFormat::ChunksPerRegion; ++i)
+                {
+                    switch (existing.ReadRaw(i, data, encoding))
+                    {
+                    case RegionFile::ReadResult::Ok:
+                        builder.SetChunk(i, data, encoding);
+                        break;
+                    case RegionFile::ReadResult::Corrupt:
+                        ++corrupt;
+                        break;
+                    default:
+                        break;
+                    }
+                }
+            }
+        }
+        for (const auto& [coord, chunk] : chunks)
+        {
+            if (chunk.encoded)
+            {
+                builder.SetChunk(RegionFormat::IndexInRegion(coord), *chunk.encoded, chunk.encoding);
+                continue;
+            }
+            RegionFormat::Encoding encoding;
+            std::vector<uint8_t> data = RegionFormat::EncodeTiles(*chunk.tiles, encoding);
+            builder.SetChunk(RegionFormat::IndexInRegion(coord), std::move(data), encoding);
+        }
+
+        std::error_code ec;
+        std::filesystem::create_directories(m_directory, ec);
+        std::filesystem::path temp = path;
+        temp += ".tmp";
+        if (!builder.WriteToFile(temp))
+        {
+            std::filesystem::remove(temp, ec);
+            return false;
+        }
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_stats.corruptChunks += corrupt;
+        // 新读者等待替换结束；已登记的读者离开后关闭映射再替换文件（Windows 上无法替换仍被映射的文件）
+        m_regions[region].replacing = true;
+        m_regionIdle.wait(lock, [&] { return m_regions[region].readers == 0; });
+        m_regions.erase(region);
+        std::filesystem::rename(temp, path, ec);
+        m_regionIdle.notify_all();
+        if (ec)
+        {
+            std::filesystem::remove(temp, ec);
+            return false;
+        }
+        return true;
+    }
+}
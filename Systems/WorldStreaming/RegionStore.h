@@ -0,0 +1,121 @@
+#ifndef REGIONSTORE_H
+#define REGIONSTORE_H
+
+#include "RegionFile.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace WorldStreaming
+{
+    struct RegionStoreStats
+    {
+        uint64_t chunksRead = 0;     ///< 从区域文件或待写队列读出的区块数。
+        uint64_t chunksWritten = 0;  ///< 写入区域文件的区块数。
+        uint64_t regionsWritten = 0; ///< 重写的区域文件数。
+        uint64_t corruptChunks = 0;  ///< 校验失败而被忽略的区块数。
+        uint64_t writeFailures = 0;  ///< 写入失败的区域文件数，对应区块留在队列中等待重试。
+    };
+
+    /**
+     * @brief 以区域文件持久化区块。
+     *
+     * Save 只把瓦片放进待写队列；后台线程攒一小段时间后按区域分组，把队列中的区块与文件中已有的区块合并，
+     * 写入临时文件并刷盘后重命名替换原文件。Load 先查待写队列，再通过内存映射读取区域文件，
+     * 因此同一区块刚保存就被重新加载也能读到最新内容。Load 与 Save 可在任意线程并发调用；
+     * 锁只保护队列与映射缓存，读取、校验与解码在锁外进行，各线程的加载互不阻塞。
+     */
+    class RegionStore
+    {
+    public:
+        static constexpr std::chrono::milliseconds DefaultBatchDelay{100};
+
+        explicit RegionStore(std::filesystem::path directory,
+                             std::chrono::milliseconds batchDelay = DefaultBatchDelay);
+        /// 写完队列中的全部区块后退出后台线程。
+        ~RegionStore();
+
+        RegionStore(const RegionStore&) = delete;
+        RegionStore& operator=(const RegionStore&) = delete;
+
+        /**
+         * @brief 读取区块的瓦片。不存在或已损坏时返回 false，调用方应重新生成。
+         */
+        bool Load(ChunkCoord coord, std::vector<uint16_t>& outTiles);
+
+        /**
+         * @brief 排队保存区块，覆盖同一区块尚未写入的旧版本。
+         */
+        void Save(ChunkCoord coord, std::vector<uint16_t> tiles);
+
+        /**
+         * @brief 排队保存已编码的区块数据，原样写入区域文件；用于瓦片以外的区块内容（如像素区块）。
+         */
+        void SaveEncoded(ChunkCoord coord, std::vector<uint8_t> data, RegionFormat::Encoding encoding);
+
+        /**
+         * @brief 读取区块的编码数据，不做解码。不存在或校验失败时返回 false。
+         */
+        bool LoadEncoded(ChunkCoord coord, std::vector<uint8_t>& outData, RegionFormat::Encoding& outEncoding);
+
+        /**
+         * @brief 阻塞直到此前排队的区块全部写入（或写入失败）。
+         */
+        void Flush();
+
+        size_t GetPendingCount() const;
+        RegionStoreStats GetStats() const;
+        const std::filesystem::path& GetDirectory() const { return m_directory; }
+
+    private:
+        struct PendingChunk
+        {
+            std::shared_ptr<const std::vector<uint16_t>> tiles;
+            std::shared_ptr<const std::vector<uint8_t>> encoded; ///< SaveEncoded 保存的数据，与 tiles 二选一。
+            RegionFormat::Encoding encoding = RegionFormat::Encoding::Raw;
+            uint64_t sequence = 0;
+        };
+
+        /**
+         * @brief 缓存的区域文件映射。读者登记期间写线程不会替换该文件，缓存淘汰也会跳过它。
+         */
+        struct CachedRegion
+        {
+            std::shared_ptr<const RegionFile> file;
+            int readers = 0;         ///< 正在读取该区域的线程数。
+            bool replacing = false;  ///< 写线程正在等待读者离开并替换文件。
+        };
+
+        void WriterLoop();
+        /// 返回写入是否成功；失败时 batch 中的区块保持在队列中。
+        bool WriteRegion(RegionCoord region, const std::vector<std::pair<ChunkCoord, PendingChunk>>& chunks);
+        /// 需持有 m_mutex：等待替换结束后登记为读者并返回文件，未缓存时在锁外打开。
+        std::shared_ptr<const RegionFile> PinRegion(RegionCoord region, std::unique_lock<std::mutex>& lock);
+        /// 需持有 m_mutex：注销读者并统计读取结果。
+        bool FinishRead(RegionCoord region, ChunkCoord coord, RegionFile::ReadResult result);
+
+        std::filesystem::path m_directory;
+        std::chrono::milliseconds m_batchDelay;
+
+        mutable std::mutex m_mutex;
+        std::condition_variable m_wake;
+        std::condition_variable m_idle;
+        std::condition_variable m_regionIdle;  ///< 读者注销或区域替换结束时通知。
+        std::unordered_map<ChunkCoord, PendingChunk, ChunkCoordHash> m_pending;
+        std::unordered_map<RegionCoord, CachedRegion, RegionCoordHash> m_regions;
+        uint64_t m_nextSequence = 0;
+        uint64_t m_writtenSequence = 0;   ///< 该序号及之前的保存都已处理。
+        uint64_t m_flushSequence = 0;     ///< Flush 等待的序号，非 0 时跳过攒批等待。
+        bool m_stop = false;
+        RegionStoreStats m_stats;
+        std::thread m_thread;
+    };
+}
+
+#endif
@@ -24,16 +24,34 @@ namespace Systems
             world.chunkManager->SetLoadRadius(world.loadRadius);
             world.chunkManager->SetUnloadRadius(world.unloadRadius);
             world.chunkManager->SetTileSize(world.tileSize);
+            world.chunkManager->SetMaxInFlight(world.maxGenerateJobs);
+            world.chunkManager->SetIntegrationBudget(world.integrationBudgetMs);
+            world.chunkManager->SetLookAhead(world.lookAheadSeconds);
+            if (!world.saveDirectory.empty() && !world.chunkManager->GetRegionStore())
+                world.chunkManager->SetRegionStore(std::make_shared<WorldStreaming::RegionStore>(world.saveDirectory));
 
             auto& cam = CameraManager::GetInstance().GetActiveCamera();
             auto props = cam.GetProperties();
             world.chunkManager->SetViewCenter(props.position.x(), props.position.y());
 
-            world.chunkManager->Update();
+            world.chunkManager->Update(deltaTime);
         }
     }
 
     void WorldStreamingSystem::OnDestroy(RuntimeScene* scene)
     {
+        auto& registry = scene->GetRegistry();
+        auto view = registry.view<ECS::ChunkWorldComponent>();
+
+        for (auto entity : view)
+        {
+            auto& world = view.get<ECS::ChunkWorldComponent>(entity);
+            if (!world.chunkManager || !world.chunkManager->GetRegionStore())
+                continue;
+
+            // 场景关闭时把仍在内存中的修改写盘
+            world.chunkManager->SaveAll();
+            world.chunkManager->GetRegionStore()->Flush();
+        }
     }
 }
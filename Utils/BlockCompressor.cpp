@@ -0,0 +1,116 @@
+#include "BlockCompressor.h"
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+namespace
+{
+    constexpr size_t MinMatch = 4;
+    constexpr size_t MaxOffset = 65535;
+    constexpr int HashBits = 12;
+
+    uint32_t Read32(const uint8_t* p)
+    {
+        uint32_t value;
+        std::memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    /// 15 以上的长度在 token 之后用 255 续接。
+    void PutLength(std::vector<uint8_t>& out, size_t length)
+    {
+        for (; length >= 255; length -= 255)
+            out.push_back(255);
+        out.push_back(static_cast<uint8_t>(length));
+    }
+
+    bool GetLength(const uint8_t*& p, const uint8_t* end, size_t& length)
+    {
+        for (;;)
+        {
+            if (p >= end) return false;
+            const uint8_t byte = *p++;
+            length += byte;
+            if (byte != 255) return true;
+        }
+    }
+
+    void PutSequence(std::vector<uint8_t>& out, const uint8_t* literals, size_t literalCount, size_t offset,
+                     size_t matchLength)
+    {
+        const size_t matchCode = matchLength ? matchLength - MinMatch : 0;
+        out.push_back(static_cast<uint8_t>((std::min<size_t>(literalCount, 15) << 4) | std::min<size_t>(matchCode, 15)));
+        if (literalCount >= 15) PutLength(out, literalCount - 15);
+        out.insert(out.end(), literals, literals + literalCount);
+        if (matchLength == 0) return;
+        out.push_back(static_cast<uint8_t>(offset));
+        out.push_back(static_cast<uint8_t>(offset >> 8));
+        if (matchCode >= 15) PutLength(out, matchCode - 15);
+    }
+}
+
+void BlockCompressor::Compress(const uint8_t* data, size_t size, std::vector<uint8_t>& out)
+{
+    // 贪心匹配：哈希表记住每个 4 字节前缀最近一次出现的位置
+    std::array<int32_t, 1u << HashBits> table;
+    table.fill(-1);
+    auto hash = [](uint32_t v) { return (v * 2654435761u) >> (32 - HashBits); };
+
+    size_t anchor = 0;
+    size_t i = 0;
+    while (i + MinMatch <= size)
+    {
+        const uint32_t word = Read32(data + i);
+        const uint32_t h = hash(word);
+        const int32_t candidate = table[h];
+        table[h] = static_cast<int32_t>(i);
+        if (candidate < 0 || i - static_cast<size_t>(candidate) > MaxOffset || Read32(data + candidate) != word)
+        {
+            i++;
+            continue;
+        }
+
+        size_t length = MinMatch;
+        while (i + length < size && data[candidate + length] == data[i + length])
+            length++;
+        PutSequence(out, data + anchor, i - anchor, i - static_cast<size_t>(candidate), length);
+        i += length;
+        anchor = i;
+    }
+    // 最后一个序列只有字面量，解码器读完字面量后输入恰好用完
+    PutSequence(out, data + anchor, size - anchor, 0, 0);
+}
+
+bool BlockCompressor::Decompress(const uint8_t* data, size_t size, uint8_t* out, size_t outSize)
+{
+    const uint8_t* p = data;
+    const uint8_t* end = data + size;
+    size_t written = 0;
+    // 最后一个序列必须只有字面量，在匹配之后结束的输入是被截断的
+    for (;;)
+    {
+        if (p >= end) return false;
+        const uint8_t token = *p++;
+        size_t literals = token >> 4;
+        if (literals == 15 && !GetLength(p, end, literals)) return false;
+        if (literals > static_cast<size_t>(end - p) || literals > outSize - written) return false;
+        std::memcpy(out + written, p, literals);
+        p += literals;
+        written += literals;
+        if (p == end) break;
+
+        if (end - p < 2) return false;
+        const size_t offset = static_cast<size_t>(p[0]) | static_cast<size_t>(p[1]) << 8;
+        p += 2;
+        size_t length = token & 15u;
+        if (length == 15 && !GetLength(p, end, length)) return false;
+        length += MinMatch;
+        if (offset == 0 || offset > written || length > outSize - written) return false;
+        // 匹配可能与输出重叠（offset < length），逐字节复制
+        const uint8_t* from = out + written - offset;
+        for (size_t k = 0; k < length; k++)
+            out[written + k] = from[k];
+        written += length;
+    }
+    return written == outSize;
+}
@@ -0,0 +1,27 @@
+#ifndef BLOCKCOMPRESSOR_H
+#define BLOCKCOMPRESSOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief 通用的 LZ 块压缩（LZ4 风格的字面量 + 回溯匹配序列）。
+ *
+ * 输出不含原始长度，解压时由调用方提供；适合压缩较小且长度已知的数据块，如像素区块的游程层和资源包记录。
+ */
+class LUMA_API BlockCompressor
+{
+public:
+    /**
+     * @brief 压缩 size 字节并追加到 out 末尾。
+     */
+    static void Compress(const uint8_t* data, size_t size, std::vector<uint8_t>& out);
+
+    /**
+     * @brief 解压到 out。输出必须恰好为 outSize 字节且输入恰好用完，否则返回 false。
+     */
+    static bool Decompress(const uint8_t* data, size_t size, uint8_t* out, size_t outSize);
+};
+
+#endif
@@ -2,6 +2,8 @@
 #define ENGINECYRPTO_H
 
 #include "LazySingleton.h"
+#include <cstddef>
+#include <cstdint>
 #include <vector>
 #include <string>
 
@@ -9,26 +11,122 @@
  * @brief EngineCrypto 类，提供加解密相关功能，采用单例模式。
  *
  * 该类用于对数据进行加密和解密操作，内部包含密钥派生、数据加解密、MAC 计算与校验、随机字节生成等功能。
+ * 数据按 BlockSize 分块做 AES-256-GCM，每块有独立的 nonce 与认证标签，可并行解密，也可只解密其中一块。
  */
 class LUMA_API EngineCrypto : public LazySingleton<EngineCrypto>
 {
 public:
     friend class LazySingleton<EngineCrypto>;
 
+    /// 分块加密时每块的明文字节数。
+    static constexpr size_t BlockSize = 64 * 1024;
+    /// AES-GCM 认证标签的字节数。
+    static constexpr size_t TagSize = 16;
+    /// 记录认证标签与索引 MAC 的字节数。
+    static constexpr size_t RecordMacSize = TagSize;
+
+    /**
+     * @brief 加密数据包的格式。
+     */
+    enum class Format
+    {
+        Blocked,   ///< 分块 AES-256-GCM。
+        LegacyCbc  ///< 整体 AES-256-CBC + HMAC，只为读取旧数据与对比保留。
+    };
+
     /**
      * @brief 加密数据。
      * @param data 待加密的原始数据
+     * @param format 输出格式
      * @return 加密后的数据包
      */
-    std::vector<unsigned char> Encrypt(const std::vector<unsigned char>& data);
+    std::vector<unsigned char> Encrypt(const std::vector<unsigned char>& data, Format format = Format::Blocked);
 
     /**
-     * @brief 解密数据包。
+     * @brief 解密数据包，自动识别格式。分块格式在作业系统上并行解密。
      * @param encryptedPackage 加密后的数据包
      * @return 解密后的原始数据
+     * @throws std::runtime_error 数据被截断或任一块认证失败（错误信息包含块号）
      */
     std::vector<unsigned char> Decrypt(const std::vector<unsigned char>& encryptedPackage);
 
+    /**
+     * @brief 分块加密数据的只读视图，由 OpenBlocks 填写。
+     *
+     * 密钥在 OpenBlocks 时派生一次，之后各块可在任意线程上独立解密。视图不持有数据。
+     */
+    struct BlockView
+    {
+        const unsigned char* data = nullptr;
+        size_t size = 0;
+        uint64_t plainSize = 0;
+        size_t blockCount = 0;
+        std::vector<unsigned char> key;
+        unsigned char noncePrefix[8] = {};  ///< 从头部复制；data 不保证对齐，不能直接按头部结构读取。
+
+        /// 第 index 块的明文字节数。
+        size_t GetBlockPlainSize(size_t index) const;
+    };
+
+    /**
+     * @brief 解析分块加密数据的头部并派生密钥。
+     * @return 不是分块格式或长度与头部不符（被截断）时返回 false
+     */
+    bool OpenBlocks(const unsigned char* data, size_t size, BlockView& outView);
+
+    /**
+     * @brief 解密并认证一块，写出 GetBlockPlainSize(index) 字节，可在多个线程上同时调用。
+     * @return 认证失败时返回 false，out 的内容未定义
+     */
+    bool DecryptBlock(const BlockView& view, size_t index, unsigned char* out);
+
+    /**
+     * @brief 一个资源包内所有记录共用的密钥，由包的盐值派生一次。
+     */
+    struct RecordKeys
+    {
+        std::vector<unsigned char> encryptionKey;
+        std::vector<unsigned char> macKey;
+    };
+
+    /**
+     * @brief 生成新的包盐值。
+     */
+    std::vector<unsigned char> GenerateSalt();
+
+    /**
+     * @brief 由盐值派生记录密钥，开销与一次 Decrypt 的密钥派生相同，每个包只需调用一次。
+     */
+    RecordKeys DeriveRecordKeys(const std::vector<unsigned char>& salt);
+
+    /**
+     * @brief 用 AES-256-GCM 加密一条记录。
+     * @param keys 包的记录密钥
+     * @param data 原始数据
+     * @param size 原始数据字节数
+     * @param outMac 输出 RecordMacSize 字节的认证标签，由调用方另行保存
+     * @return nonce + 密文
+     */
+    std::vector<unsigned char> EncryptRecord(const RecordKeys& keys, const unsigned char* data, size_t size,
+                                             unsigned char* outMac);
+
+    /**
+     * @brief 认证并解密一条记录，可在多个线程上同时调用。
+     * @return 认证标签不符或数据损坏时返回 false
+     */
+    bool DecryptRecord(const RecordKeys& keys, const unsigned char* record, size_t size, const unsigned char* mac,
+                       std::vector<unsigned char>& out);
+
+    /**
+     * @brief 计算任意数据的 HMAC（截断到 RecordMacSize 字节），用于认证记录索引等明文数据。
+     */
+    void ComputeRecordMac(const RecordKeys& keys, const unsigned char* data, size_t size, unsigned char* outMac);
+
+    /**
+     * @brief 以常数时间比较数据的记录 MAC。
+     */
+    bool VerifyRecordMac(const RecordKeys& keys, const unsigned char* data, size_t size, const unsigned char* mac);
+
 private:
     /**
      * @brief 构造函数，私有以实现单例模式。
@@ -53,30 +151,52 @@ private:
     /**
      * @brief 加密数据（内部实现）。
      * @param data 待加密数据
+     * @param size 待加密数据字节数
      * @param key 加密密钥
      * @param iv 初始向量
      * @return 加密后的数据
      */
-    std::vector<unsigned char> encryptData(const std::vector<unsigned char>& data,
-                                           const std::vector<unsigned char>& key, const std::vector<unsigned char>& iv);
+    std::vector<unsigned char> encryptData(const unsigned char* data, size_t size,
+                                           const std::vector<unsigned char>& key, const unsigned char* iv);
 
     /**
      * @brief 解密数据（内部实现）。
      * @param encryptedData 加密数据
+     * @param size 加密数据字节数
      * @param key 解密密钥
      * @param iv 初始向量
      * @return 解密后的数据
      */
-    std::vector<unsigned char> decryptData(const std::vector<unsigned char>& encryptedData,
-                                           const std::vector<unsigned char>& key, const std::vector<unsigned char>& iv);
+    std::vector<unsigned char> decryptData(const unsigned char* encryptedData, size_t size,
+                                           const std::vector<unsigned char>& key, const unsigned char* iv);
+
+    std::vector<unsigned char> encryptBlocked(const std::vector<unsigned char>& data);
+    std::vector<unsigned char> encryptLegacy(const std::vector<unsigned char>& data);
+    std::vector<unsigned char> decryptLegacy(const std::vector<unsigned char>& encryptedPackage);
+
+    /**
+     * @brief AES-256-GCM 加密（内部实现），nonce 为 12 字节。
+     * @return 成功返回 true，out 写出 size 字节，tag 写出 TagSize 字节
+     */
+    bool gcmEncrypt(const std::vector<unsigned char>& key, const unsigned char* nonce, const unsigned char* aad,
+                    size_t aadSize, const unsigned char* data, size_t size, unsigned char* out, unsigned char* tag);
+
+    /**
+     * @brief AES-256-GCM 解密并认证（内部实现）。
+     * @return 认证失败返回 false
+     */
+    bool gcmDecrypt(const std::vector<unsigned char>& key, const unsigned char* nonce, const unsigned char* aad,
+                    size_t aadSize, const unsigned char* data, size_t size, const unsigned char* tag,
+                    unsigned char* out);
 
     /**
      * @brief 计算消息认证码（MAC）。
      * @param data 输入数据
+     * @param size 输入数据字节数
      * @param key MAC 密钥
      * @return 计算得到的 MAC
      */
-    std::vector<unsigned char> computeMac(const std::vector<unsigned char>& data,
+    std::vector<unsigned char> computeMac(const unsigned char* data, size_t size,
                                           const std::vector<unsigned char>& key);
 
     /**
@@ -1,5 +1,9 @@
 #include "EngineCrypto.h"
+#include "../Event/JobSystem.h"
+#include <algorithm>
+#include <cstring>
 #include <stdexcept>
+#include <string>
 #include <vector>
 #include <openssl/evp.h>
 #include <openssl/rand.h>
@@ -11,6 +15,10 @@ constexpr int IV_SIZE = 16;
 constexpr int KEY_SIZE = 32;
 constexpr int MAC_SIZE = 32;
 constexpr int ITERATIONS = 10000;
+constexpr int NONCE_SIZE = 12;
+constexpr int NONCE_PREFIX_SIZE = 8;
+/// 每个解密作业处理的块数（1 MiB 明文）。
+constexpr size_t BLOCKS_PER_JOB = 16;
 
 
 const std::vector<unsigned char> KEY_COMPONENT_1 = {
@@ -23,13 +31,218 @@ const std::vector<unsigned char> KEY_COMPONENT_3 = {
     0x2A, 0x7B, 0x8C, 0x9D, 0xAE, 0xBF, 0xC0, 0xD1
 };
 
-std::vector<unsigned char> EngineCrypto::Encrypt(const std::vector<unsigned char>& data)
+namespace
+{
+    constexpr uint32_t BLOCKED_MAGIC = 0x42454D4C; // "LMEB"
+    constexpr uint32_t BLOCKED_VERSION = 1;
+
+    /**
+     * @brief 分块格式的头部，整体作为每一块的附加认证数据，改动任何字段都会使所有块认证失败。
+     */
+    struct BlockedHeader
+    {
+        uint32_t magic = BLOCKED_MAGIC;
+        uint32_t version = BLOCKED_VERSION;
+        uint32_t blockSize = 0;
+        uint32_t reserved = 0;
+        uint64_t plainSize = 0;
+        unsigned char salt[SALT_SIZE] = {};
+        unsigned char noncePrefix[NONCE_PREFIX_SIZE] = {};
+    };
+
+    static_assert(sizeof(BlockedHeader) == 48);
+    static_assert(sizeof(EngineCrypto::BlockView::noncePrefix) == NONCE_PREFIX_SIZE);
+
+    /// 明文为空时仍写出一个空块，头部总有标签保护。
+    size_t BlockCountOf(uint64_t plainSize)
+    {
+        return plainSize == 0 ? 1 : static_cast<size_t>((plainSize + EngineCrypto::BlockSize - 1) / EngineCrypto::BlockSize);
+    }
+
+    /// nonce = 随机前缀 + 大端块号，块被调换位置后认证失败。
+    void BlockNonce(const unsigned char* prefix, size_t index, unsigned char* nonce)
+    {
+        std::memcpy(nonce, prefix, NONCE_PREFIX_SIZE);
+        for (int i = 0; i < NONCE_SIZE - NONCE_PREFIX_SIZE; ++i)
+            nonce[NONCE_PREFIX_SIZE + i] = static_cast<unsigned char>(index >> (8 * (NONCE_SIZE - NONCE_PREFIX_SIZE - 1 - i)));
+    }
+
+    size_t BlockOffset(size_t index)
+    {
+        return sizeof(BlockedHeader) + index * (EngineCrypto::BlockSize + EngineCrypto::TagSize);
+    }
+}
+
+std::vector<unsigned char> EngineCrypto::Encrypt(const std::vector<unsigned char>& data, Format format)
+{
+    return format == Format::LegacyCbc ? encryptLegacy(data) : encryptBlocked(data);
+}
+
+std::vector<unsigned char> EngineCrypto::Decrypt(const std::vector<unsigned char>& encryptedPackage)
+{
+    // 旧格式以随机盐值开头，与魔数和版本同时相符的概率可以忽略
+    BlockedHeader header;
+    if (encryptedPackage.size() < sizeof(header))
+        return decryptLegacy(encryptedPackage);
+    std::memcpy(&header, encryptedPackage.data(), sizeof(header));
+    if (header.magic != BLOCKED_MAGIC || header.version != BLOCKED_VERSION)
+        return decryptLegacy(encryptedPackage);
+
+    BlockView view;
+    if (!OpenBlocks(encryptedPackage.data(), encryptedPackage.size(), view))
+    {
+        throw std::runtime_error("Encrypted package is truncated or malformed.");
+    }
+
+    struct DecryptJob : public IJob
+    {
+        EngineCrypto* crypto;
+        const BlockView* view;
+        unsigned char* out;
+        size_t first;
+        size_t last;
+        size_t failedBlock = SIZE_MAX;
+
+        DecryptJob(EngineCrypto* c, const BlockView* v, unsigned char* o, size_t f, size_t l)
+            : crypto(c), view(v), out(o), first(f), last(l)
+        {
+        }
+
+        void Execute() override
+        {
+            for (size_t i = first; i < last; ++i)
+            {
+                if (!crypto->DecryptBlock(*view, i, out + i * BlockSize))
+                {
+                    failedBlock = i;
+                    return;
+                }
+            }
+        }
+    };
+
+    std::vector<unsigned char> plain(static_cast<size_t>(view.plainSize));
+    std::vector<DecryptJob> jobs;
+    jobs.reserve((view.blockCount + BLOCKS_PER_JOB - 1) / BLOCKS_PER_JOB);
+    for (size_t first = 0; first < view.blockCount; first += BLOCKS_PER_JOB)
+        jobs.emplace_back(this, &view, plain.data(), first, std::min(first + BLOCKS_PER_JOB, view.blockCount));
+    JobSystem::RunAll(jobs);
+
+    for (const DecryptJob& job : jobs)
+    {
+        if (job.failedBlock != SIZE_MAX)
+        {
+            throw std::runtime_error("Data integrity check failed (block " + std::to_string(job.failedBlock) +
+                                     " tag mismatch).");
+        }
+    }
+    return plain;
+}
+
+size_t EngineCrypto::BlockView::GetBlockPlainSize(size_t index) const
+{
+    if (index + 1 < blockCount) return BlockSize;
+    return static_cast<size_t>(plainSize - static_cast<uint64_t>(index) * BlockSize);
+}
+
+bool EngineCrypto::OpenBlocks(const unsigned char* data, size_t size, BlockView& outView)
+{
+    BlockedHeader header;
+    if (size < sizeof(header)) return false;
+    std::memcpy(&header, data, sizeof(header));
+    if (header.magic != BLOCKED_MAGIC || header.version != BLOCKED_VERSION || header.blockSize != BlockSize ||
+        header.reserved != 0)
+        return false;
+
+    const size_t blockCount = BlockCountOf(header.plainSize);
+    if (header.plainSize > size || size != sizeof(header) + header.plainSize + blockCount * TagSize) return false;
+
+    outView.data = data;
+    outView.size = size;
+    outView.plainSize = header.plainSize;
+    outView.blockCount = blockCount;
+    std::memcpy(outView.noncePrefix, header.noncePrefix, NONCE_PREFIX_SIZE);
+    outView.key = deriveKey(std::vector<unsigned char>(header.salt, header.salt + SALT_SIZE), KEY_SIZE,
+                            "BLOCK_ENCRYPTION");
+    return true;
+}
+
+bool EngineCrypto::DecryptBlock(const BlockView& view, size_t index, unsigned char* out)
+{
+    if (index >= view.blockCount) return false;
+    unsigned char nonce[NONCE_SIZE];
+    BlockNonce(view.noncePrefix, index, nonce);
+    const size_t plainSize = view.GetBlockPlainSize(index);
+    const unsigned char* block = view.data + BlockOffset(index);
+    return gcmDecrypt(view.key, nonce, view.data, sizeof(BlockedHeader), block, plainSize, block + plainSize, out);
+}
+
+std::vector<unsigned char> EngineCrypto::encryptBlocked(const std::vector<unsigned char>& data)
+{
+    BlockedHeader header;
+    header.blockSize = static_cast<uint32_t>(BlockSize);
+    header.plainSize = data.size();
+    auto salt = generateRandomBytes(SALT_SIZE);
+    auto prefix = generateRandomBytes(NONCE_PREFIX_SIZE);
+    std::copy(salt.begin(), salt.end(), header.salt);
+    std::copy(prefix.begin(), prefix.end(), header.noncePrefix);
+    const auto key = deriveKey(salt, KEY_SIZE, "BLOCK_ENCRYPTION");
+
+    const size_t blockCount = BlockCountOf(data.size());
+    std::vector<unsigned char> package(sizeof(header) + data.size() + blockCount * TagSize);
+    std::memcpy(package.data(), &header, sizeof(header));
+
+    struct EncryptJob : public IJob
+    {
+        EngineCrypto* crypto;
+        const std::vector<unsigned char>* key;
+        const std::vector<unsigned char>* data;
+        const BlockedHeader* header;
+        unsigned char* package;
+        size_t first;
+        size_t last;
+        bool failed = false;
+
+        EncryptJob(EngineCrypto* c, const std::vector<unsigned char>* k, const std::vector<unsigned char>* d,
+                   const BlockedHeader* h, unsigned char* p, size_t f, size_t l)
+            : crypto(c), key(k), data(d), header(h), package(p), first(f), last(l)
+        {
+        }
+
+        void Execute() override
+        {
+            for (size_t i = first; i < last && !failed; ++i)
+            {
+                unsigned char nonce[NONCE_SIZE];
+                BlockNonce(header->noncePrefix, i, nonce);
+                const size_t offset = i * BlockSize;
+                const size_t size = std::min(BlockSize, data->size() - std::min(offset, data->size()));
+                unsigned char* block = package + BlockOffset(i);
+                failed = !crypto->gcmEncrypt(*key, nonce, package, sizeof(BlockedHeader), data->data() + offset, size,
+                                             block, block + size);
+            }
+        }
+    };
+
+    std::vector<EncryptJob> jobs;
+    for (size_t first = 0; first < blockCount; first += BLOCKS_PER_JOB)
+        jobs.emplace_back(this, &key, &data, &header, package.data(), first,
+                          std::min(first + BLOCKS_PER_JOB, blockCount));
+    JobSystem::RunAll(jobs);
+    for (const EncryptJob& job : jobs)
+    {
+        if (job.failed) throw std::runtime_error("加密数据失败。");
+    }
+    return package;
+}
+
+std::vector<unsigned char> EngineCrypto::encryptLegacy(const std::vector<unsigned char>& data)
 {
     auto salt = generateRandomBytes(SALT_SIZE);
     auto iv = generateRandomBytes(IV_SIZE);
     auto encryptionKey = deriveKey(salt, KEY_SIZE, "ENCRYPTION");
     auto macKey = deriveKey(salt, MAC_SIZE, "MAC");
-    auto encryptedData = encryptData(data, encryptionKey, iv);
+    auto encryptedData = encryptData(data.data(), data.size(), encryptionKey, iv.data());
 
     std::vector<unsigned char> package;
 
@@ -37,13 +250,13 @@ std::vector<unsigned char> EngineCrypto::Encrypt(const std::vector<unsigned char
     package.insert(package.end(), iv.begin(), iv.end());
     package.insert(package.end(), encryptedData.begin(), encryptedData.end());
 
-    auto mac = computeMac(package, macKey);
+    auto mac = computeMac(package.data(), package.size(), macKey);
     package.insert(package.end(), mac.begin(), mac.end());
 
     return package;
 }
 
-std::vector<unsigned char> EngineCrypto::Decrypt(const std::vector<unsigned char>& encryptedPackage)
+std::vector<unsigned char> EngineCrypto::decryptLegacy(const std::vector<unsigned char>& encryptedPackage)
 {
     if (encryptedPackage.size() < (SALT_SIZE + IV_SIZE + MAC_SIZE))
     {
@@ -52,24 +265,72 @@ std::vector<unsigned char> EngineCrypto::Decrypt(const std::vector<unsigned char
     size_t pos = 0;
     std::vector<unsigned char> salt(encryptedPackage.begin(), encryptedPackage.begin() + SALT_SIZE);
     pos += SALT_SIZE;
-    std::vector<unsigned char> iv(encryptedPackage.begin() + pos, encryptedPackage.begin() + pos + IV_SIZE);
+    const unsigned char* iv = encryptedPackage.data() + pos;
     pos += IV_SIZE;
     size_t encryptedDataSize = encryptedPackage.size() - SALT_SIZE - IV_SIZE - MAC_SIZE;
-    std::vector<unsigned char> encryptedData(encryptedPackage.begin() + pos,
-                                             encryptedPackage.begin() + pos + encryptedDataSize);
+    const unsigned char* encryptedData = encryptedPackage.data() + pos;
     pos += encryptedDataSize;
     std::vector<unsigned char> storedMac(encryptedPackage.begin() + pos, encryptedPackage.end());
 
     auto macKey = deriveKey(salt, MAC_SIZE, "MAC");
-    std::vector<unsigned char> dataToVerify(encryptedPackage.begin(), encryptedPackage.begin() + pos);
-    auto computedMac = computeMac(dataToVerify, macKey);
+    auto computedMac = computeMac(encryptedPackage.data(), pos, macKey);
     if (!compareMacs(storedMac, computedMac))
     {
         throw std::runtime_error("Data integrity check failed (MAC mismatch).");
     }
 
     auto encryptionKey = deriveKey(salt, KEY_SIZE, "ENCRYPTION");
-    return decryptData(encryptedData, encryptionKey, iv);
+    return decryptData(encryptedData, encryptedDataSize, encryptionKey, iv);
+}
+
+std::vector<unsigned char> EngineCrypto::GenerateSalt()
+{
+    return generateRandomBytes(SALT_SIZE);
+}
+
+EngineCrypto::RecordKeys EngineCrypto::DeriveRecordKeys(const std::vector<unsigned char>& salt)
+{
+    // 用途标识与整包加密不同，同一盐值派生出的两组密钥互不相关
+    RecordKeys keys;
+    keys.encryptionKey = deriveKey(salt, KEY_SIZE, "RECORD_ENCRYPTION");
+    keys.macKey = deriveKey(salt, MAC_SIZE, "RECORD_MAC");
+    return keys;
+}
+
+std::vector<unsigned char> EngineCrypto::EncryptRecord(const RecordKeys& keys, const unsigned char* data, size_t size,
+                                                       unsigned char* outMac)
+{
+    auto record = generateRandomBytes(NONCE_SIZE);
+    record.resize(NONCE_SIZE + size);
+    if (!gcmEncrypt(keys.encryptionKey, record.data(), nullptr, 0, data, size, record.data() + NONCE_SIZE, outMac))
+    {
+        throw std::runtime_error("加密数据失败。");
+    }
+    return record;
+}
+
+bool EngineCrypto::DecryptRecord(const RecordKeys& keys, const unsigned char* record, size_t size,
+                                 const unsigned char* mac, std::vector<unsigned char>& out)
+{
+    if (size < NONCE_SIZE)
+        return false;
+    out.resize(size - NONCE_SIZE);
+    return gcmDecrypt(keys.encryptionKey, record, nullptr, 0, record + NONCE_SIZE, size - NONCE_SIZE, mac, out.data());
+}
+
+void EngineCrypto::ComputeRecordMac(const RecordKeys& keys, const unsigned char* data, size_t size,
+                                    unsigned char* outMac)
+{
+    auto mac = computeMac(data, size, keys.macKey);
+    std::copy_n(mac.begin(), RecordMacSize, outMac);
+}
+
+bool EngineCrypto::VerifyRecordMac(const RecordKeys& keys, const unsigned char* data, size_t size,
+                                   const unsigned char* mac)
+{
+    auto computed = computeMac(data, size, keys.macKey);
+    computed.resize(RecordMacSize);
+    return compareMacs(computed, std::vector<unsigned char>(mac, mac + RecordMacSize));
 }
 
 
@@ -114,22 +375,22 @@ std::vector<unsigned char> EngineCrypto::deriveKey(const std::vector<unsigned ch
 }
 
 
-std::vector<unsigned char> EngineCrypto::encryptData(const std::vector<unsigned char>& data,
+std::vector<unsigned char> EngineCrypto::encryptData(const unsigned char* data, size_t size,
                                                      const std::vector<unsigned char>& key,
-                                                     const std::vector<unsigned char>& iv)
+                                                     const unsigned char* iv)
 {
     EVP_CIPHER_CTX* ctx = EVP_CIPHER_CTX_new();
     if (!ctx)
         throw std::runtime_error("创建加密上下文失败。");
-    if (EVP_EncryptInit_ex(ctx, EVP_aes_256_cbc(), nullptr, key.data(), iv.data()) != 1)
+    if (EVP_EncryptInit_ex(ctx, EVP_aes_256_cbc(), nullptr, key.data(), iv) != 1)
     {
         EVP_CIPHER_CTX_free(ctx);
         throw std::runtime_error("初始化加密失败。");
     }
-    std::vector<unsigned char> encryptedData(data.size() + EVP_CIPHER_block_size(EVP_aes_256_cbc()));
+    std::vector<unsigned char> encryptedData(size + EVP_CIPHER_block_size(EVP_aes_256_cbc()));
     int len = 0;
     int encryptedLen = 0;
-    if (EVP_EncryptUpdate(ctx, encryptedData.data(), &len, data.data(), static_cast<int>(data.size())) != 1)
+    if (EVP_EncryptUpdate(ctx, encryptedData.data(), &len, data, static_cast<int>(size)) != 1)
     {
         EVP_CIPHER_CTX_free(ctx);
         throw std::runtime_error("加密数据失败。");
@@ -147,24 +408,23 @@ std::vector<unsigned char> EngineCrypto::encryptData(const std::vector<unsigned
 }
 
 
-std::vector<unsigned char> EngineCrypto::decryptData(const std::vector<unsigned char>& encryptedData,
+std::vector<unsigned char> EngineCrypto::decryptData(const unsigned char* encryptedData, size_t size,
                                                      const std::vector<unsigned char>& key,
-                                                     const std::vector<unsigned char>& iv)
+                                                     const unsigned char* iv)
 
 {
     EVP_CIPHER_CTX* ctx = EVP_CIPHER_CTX_new();
     if (!ctx)
         throw std::runtime_error("创建解密上下文失败。");
-    if (EVP_DecryptInit_ex(ctx, EVP_aes_256_cbc(), nullptr, key.data(), iv.data()) != 1)
+    if (EVP_DecryptInit_ex(ctx, EVP_aes_256_cbc(), nullptr, key.data(), iv) != 1)
     {
         EVP_CIPHER_CTX_free(ctx);
         throw std::runtime_error("初始化解密失败。");
     }
-    std::vector<unsigned char> decryptedData(encryptedData.size());
+    std::vector<unsigned char> decryptedData(size);
     int len = 0;
     int decryptedLen = 0;
-    if (EVP_DecryptUpdate(ctx, decryptedData.data(), &len, encryptedData.data(),
-                          static_cast<int>(encryptedData.size())) != 1)
+    if (EVP_DecryptUpdate(ctx, decryptedData.data(), &len, encryptedData, static_cast<int>(size)) != 1)
     {
         EVP_CIPHER_CTX_free(ctx);
         throw std::runtime_error("解密数据失败。");
@@ -182,12 +442,58 @@ std::vector<unsigned char> EngineCrypto::decryptData(const std::vector<unsigned
 }
 
 
-std::vector<unsigned char> EngineCrypto::computeMac(const std::vector<unsigned char>& data,
+bool EngineCrypto::gcmEncrypt(const std::vector<unsigned char>& key, const unsigned char* nonce,
+                              const unsigned char* aad, size_t aadSize, const unsigned char* data, size_t size,
+                              unsigned char* out, unsigned char* tag)
+{
+    EVP_CIPHER_CTX* ctx = EVP_CIPHER_CTX_new();
+    if (!ctx)
+        return false;
+    int len = 0;
+    bool ok = EVP_EncryptInit_ex(ctx, EVP_aes_256_gcm(), nullptr, nullptr, nullptr) == 1 &&
+        EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_GCM_SET_IVLEN, NONCE_SIZE, nullptr) == 1 &&
+        EVP_EncryptInit_ex(ctx, nullptr, nullptr, key.data(), nonce) == 1;
+    if (ok && aadSize > 0)
+        ok = EVP_EncryptUpdate(ctx, nullptr, &len, aad, static_cast<int>(aadSize)) == 1;
+    if (ok && size > 0)
+        ok = EVP_EncryptUpdate(ctx, out, &len, data, static_cast<int>(size)) == 1;
+    // GCM 没有填充，Final 不会再写出数据
+    ok = ok && EVP_EncryptFinal_ex(ctx, out + size, &len) == 1 &&
+        EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_GCM_GET_TAG, static_cast<int>(TagSize), tag) == 1;
+    EVP_CIPHER_CTX_free(ctx);
+    return ok;
+}
+
+
+bool EngineCrypto::gcmDecrypt(const std::vector<unsigned char>& key, const unsigned char* nonce,
+                              const unsigned char* aad, size_t aadSize, const unsigned char* data, size_t size,
+                              const unsigned char* tag, unsigned char* out)
+{
+    EVP_CIPHER_CTX* ctx = EVP_CIPHER_CTX_new();
+    if (!ctx)
+        return false;
+    int len = 0;
+    bool ok = EVP_DecryptInit_ex(ctx, EVP_aes_256_gcm(), nullptr, nullptr, nullptr) == 1 &&
+        EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_GCM_SET_IVLEN, NONCE_SIZE, nullptr) == 1 &&
+        EVP_DecryptInit_ex(ctx, nullptr, nullptr, key.data(), nonce) == 1;
+    if (ok && aadSize > 0)
+        ok = EVP_DecryptUpdate(ctx, nullptr, &len, aad, static_cast<int>(aadSize)) == 1;
+    if (ok && size > 0)
+        ok = EVP_DecryptUpdate(ctx, out, &len, data, static_cast<int>(size)) == 1;
+    ok = ok && EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_GCM_SET_TAG, static_cast<int>(TagSize),
+                                   const_cast<unsigned char*>(tag)) == 1 &&
+        EVP_DecryptFinal_ex(ctx, out + size, &len) == 1;
+    EVP_CIPHER_CTX_free(ctx);
+    return ok;
+}
+
+
+std::vector<unsigned char> EngineCrypto::computeMac(const unsigned char* data, size_t size,
                                                     const std::vector<unsigned char>& key)
 {
     unsigned int macLen;
     std::vector<unsigned char> mac(EVP_MD_size(EVP_sha256()));
-    if (!HMAC(EVP_sha256(), key.data(), static_cast<int>(key.size()), data.data(), data.size(), mac.data(), &macLen))
+    if (!HMAC(EVP_sha256(), key.data(), static_cast<int>(key.size()), data, size, mac.data(), &macLen))
     {
         throw std::runtime_error("计算MAC失败。");
     }
@@ -1,14 +1,108 @@
 #include "SIMDWrapper.h"
+#include <algorithm>
 #include <array>
 #include <cfloat>
 #include <cmath>
 
 
+namespace
+{
+    class Scalar : public SIMDIpml
+    {
+    public:
+        void VectorAdd(const float* a, const float* b, float* result, size_t count) override
+        {
+            for (size_t i = 0; i < count; ++i) result[i] = a[i] + b[i];
+        }
+
+        void VectorMultiply(const float* a, const float* b, float* result, size_t count) override
+        {
+            for (size_t i = 0; i < count; ++i) result[i] = a[i] * b[i];
+        }
+
+        void VectorScalarMultiply(const float* a, float b, float* result, size_t count) override
+        {
+            for (size_t i = 0; i < count; ++i) result[i] = a[i] * b;
+        }
+
+        void VectorScalarAdd(const float* a, float b, float* result, size_t count) override
+        {
+            for (size_t i = 0; i < count; ++i) result[i] = a[i] + b;
+        }
+
+        void VectorScalarMultiplyAdd(const float* a, float b, const float* c, float* result, size_t count) override
+        {
+            for (size_t i = 0; i < count; ++i) result[i] = a[i] * b + c[i];
+        }
+
+        void VectorMultiplyAdd(const float* a, const float* b, const float* c, float* result, size_t count) override
+        {
+            for (size_t i = 0; i < count; ++i) result[i] = a[i] * b[i] + c[i];
+        }
+
+        void VectorLerp(const float* a, const float* b, const float* t, float* result, size_t count) override
+        {
+            for (size_t i = 0; i < count; ++i) result[i] = a[i] + (b[i] - a[i]) * t[i];
+        }
+
+        float VectorDotProduct(const float* a, const float* b, size_t count) override
+        {
+            float result = 0.0f;
+            for (size_t i = 0; i < count; ++i) result += a[i] * b[i];
+            return result;
+        }
+
+        void VectorSqrt(const float* input, float* result, size_t count) override
+        {
+            for (size_t i = 0; i < count; ++i) result[i] = sqrtf(input[i]);
+        }
+
+        void VectorReciprocal(const float* input, float* result, size_t count) override
+        {
+            for (size_t i = 0; i < count; ++i) result[i] = 1.0f / input[i];
+        }
+
+        void VectorRotatePoints(const float* points_x, const float* points_y, const float* sin_vals,
+                                const float* cos_vals, float* result_x, float* result_y, size_t count) override
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                const float x = points_x[i];
+                const float y = points_y[i];
+                result_x[i] = x * cos_vals[i] - y * sin_vals[i];
+                result_y[i] = x * sin_vals[i] + y * cos_vals[i];
+            }
+        }
+
+        float VectorMax(const float* input, size_t count) override
+        {
+            float result = -FLT_MAX;
+            for (size_t i = 0; i < count; ++i) result = std::max(result, input[i]);
+            return result;
+        }
+
+        float VectorMin(const float* input, size_t count) override
+        {
+            float result = FLT_MAX;
+            for (size_t i = 0; i < count; ++i) result = std::min(result, input[i]);
+            return result;
+        }
+
+        void VectorAbs(const float* input, float* result, size_t count) override
+        {
+            for (size_t i = 0; i < count; ++i) result[i] = fabsf(input[i]);
+        }
+
+        const char* GetSupportedInstructions() const override { return "Scalar"; }
+    };
+}
+
 #if defined(LUMA_X64)
 #ifdef _WIN32
 #include <intrin.h>
 #else
 #include <x86intrin.h>
+#include <cpuid.h>
 #endif
 
 namespace
@@ -60,7 +154,7 @@ namespace
 #if defined(_MSC_VER)
             __cpuid(regs.data(), level);
 #elif defined(__GNUC__) || defined(__clang__)
-            cpuid(regs, level);
+            cpuidex(regs, level, 0);
 #endif
         }
 
@@ -69,7 +163,9 @@ namespace
 #if defined(_MSC_VER)
             __cpuidex(regs.data(), level, count);
 #elif defined(__GNUC__) || defined(__clang__)
-            cpuidex(regs, level, count);
+            unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+            __cpuid_count(level, count, eax, ebx, ecx, edx);
+            regs = {static_cast<int>(eax), static_cast<int>(ebx), static_cast<int>(ecx), static_cast<int>(edx)};
 #endif
         }
 
@@ -228,6 +324,40 @@ public:
         for (; i < count; ++i) result[i] = fabsf(input[i]);
     }
 
+    void VectorScalarAdd(const float* a, float b, float* result, size_t count) override
+    {
+        size_t i = 0;
+        __m128 bv = _mm_set1_ps(b);
+        for (; i + 4 <= count; i += 4)
+        {
+            _mm_storeu_ps(result + i, _mm_add_ps(_mm_loadu_ps(a + i), bv));
+        }
+        for (; i < count; ++i) result[i] = a[i] + b;
+    }
+
+    void VectorScalarMultiplyAdd(const float* a, float b, const float* c, float* result, size_t count) override
+    {
+        size_t i = 0;
+        __m128 bv = _mm_set1_ps(b);
+        for (; i + 4 <= count; i += 4)
+        {
+            _mm_storeu_ps(result + i, _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(a + i), bv), _mm_loadu_ps(c + i)));
+        }
+        for (; i < count; ++i) result[i] = a[i] * b + c[i];
+    }
+
+    void VectorLerp(const float* a, const float* b, const float* t, float* result, size_t count) override
+    {
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128 av = _mm_loadu_ps(a + i);
+            __m128 diff = _mm_sub_ps(_mm_loadu_ps(b + i), av);
+            _mm_storeu_ps(result + i, _mm_add_ps(av, _mm_mul_ps(diff, _mm_loadu_ps(t + i))));
+        }
+        for (; i < count; ++i) result[i] = a[i] + (b[i] - a[i]) * t[i];
+    }
+
     const char* GetSupportedInstructions() const override { return "SSE4.2"; }
 };
 
@@ -243,7 +373,7 @@ public:
             _mm256_storeu_ps(result + i, _mm256_add_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
         }
         SSE42 sse_fallback;
-        sse_fallback.VectorAdd(a + i, b, result + i, count - i);
+        sse_fallback.VectorAdd(a + i, b + i, result + i, count - i);
     }
 
     void VectorMultiply(const float* a, const float* b, float* result, size_t count) override
@@ -254,7 +384,7 @@ public:
             _mm256_storeu_ps(result + i, _mm256_mul_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
         }
         SSE42 sse_fallback;
-        sse_fallback.VectorMultiply(a + i, b, result + i, count - i);
+        sse_fallback.VectorMultiply(a + i, b + i, result + i, count - i);
     }
 
     void VectorScalarMultiply(const float* a, float b, float* result, size_t count) override
@@ -278,7 +408,7 @@ public:
                                                        _mm256_loadu_ps(c + i)));
         }
         SSE42 sse_fallback;
-        sse_fallback.VectorMultiplyAdd(a + i, b, c, result + i, count - i);
+        sse_fallback.VectorMultiplyAdd(a + i, b + i, c + i, result + i, count - i);
     }
 
     float VectorDotProduct(const float* a, const float* b, size_t count) override
@@ -294,7 +424,7 @@ public:
         float result = temp[0] + temp[1] + temp[2] + temp[3] + temp[4] + temp[5] + temp[6] + temp[7];
 
         SSE42 sse_fallback;
-        result += sse_fallback.VectorDotProduct(a + i, b, count - i);
+        result += sse_fallback.VectorDotProduct(a + i, b + i, count - i);
         return result;
     }
 
@@ -390,6 +520,44 @@ public:
         sse_fallback.VectorAbs(input + i, result + i, count - i);
     }
 
+    void VectorScalarAdd(const float* a, float b, float* result, size_t count) override
+    {
+        size_t i = 0;
+        __m256 bv = _mm256_set1_ps(b);
+        for (; i + 8 <= count; i += 8)
+        {
+            _mm256_storeu_ps(result + i, _mm256_add_ps(_mm256_loadu_ps(a + i), bv));
+        }
+        SSE42 sse_fallback;
+        sse_fallback.VectorScalarAdd(a + i, b, result + i, count - i);
+    }
+
+    void VectorScalarMultiplyAdd(const float* a, float b, const float* c, float* result, size_t count) override
+    {
+        size_t i = 0;
+        __m256 bv = _mm256_set1_ps(b);
+        for (; i + 8 <= count; i += 8)
+        {
+            _mm256_storeu_ps(result + i, _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(a + i), bv),
+                                                       _mm256_loadu_ps(c + i)));
+        }
+        SSE42 sse_fallback;
+        sse_fallback.VectorScalarMultiplyAdd(a + i, b, c + i, result + i, count - i);
+    }
+
+    void VectorLerp(const float* a, const float* b, const float* t, float* result, size_t count) override
+    {
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            __m256 av = _mm256_loadu_ps(a + i);
+            __m256 diff = _mm256_sub_ps(_mm256_loadu_ps(b + i), av);
+            _mm256_storeu_ps(result + i, _mm256_add_ps(av, _mm256_mul_ps(diff, _mm256_loadu_ps(t + i))));
+        }
+        SSE42 sse_fallback;
+        sse_fallback.VectorLerp(a + i, b + i, t + i, result + i, count - i);
+    }
+
     const char* GetSupportedInstructions() const override { return "AVX"; }
 };
 #endif
@@ -407,7 +575,7 @@ public:
                                                          _mm256_loadu_ps(c + i)));
         }
         SSE42 sse_fallback;
-        sse_fallback.VectorMultiplyAdd(a + i, b, c, result + i, count - i);
+        sse_fallback.VectorMultiplyAdd(a + i, b + i, c + i, result + i, count - i);
     }
 
     float VectorDotProduct(const float* a, const float* b, size_t count) override
@@ -423,7 +591,7 @@ public:
         float result = temp[0] + temp[1] + temp[2] + temp[3] + temp[4] + temp[5] + temp[6] + temp[7];
 
         SSE42 sse_fallback;
-        result += sse_fallback.VectorDotProduct(a + i, b, count - i);
+        result += sse_fallback.VectorDotProduct(a + i, b + i, count - i);
         return result;
     }
 
@@ -443,7 +611,7 @@ public:
             _mm512_storeu_ps(result + i, _mm512_add_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i)));
         }
         AVX2 avx2_fallback;
-        avx2_fallback.VectorAdd(a + i, b, result + i, count - i);
+        avx2_fallback.VectorAdd(a + i, b + i, result + i, count - i);
     }
 
     void VectorMultiply(const float* a, const float* b, float* result, size_t count) override
@@ -454,7 +622,7 @@ public:
             _mm512_storeu_ps(result + i, _mm512_mul_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i)));
         }
         AVX2 avx2_fallback;
-        avx2_fallback.VectorMultiply(a + i, b, result + i, count - i);
+        avx2_fallback.VectorMultiply(a + i, b + i, result + i, count - i);
     }
 
     void VectorScalarMultiply(const float* a, float b, float* result, size_t count) override
@@ -478,7 +646,7 @@ public:
                                                          _mm512_loadu_ps(c + i)));
         }
         AVX2 avx2_fallback;
-        avx2_fallback.VectorMultiplyAdd(a + i, b, c, result + i, count - i);
+        avx2_fallback.VectorMultiplyAdd(a + i, b + i, c + i, result + i, count - i);
     }
 
     float VectorDotProduct(const float* a, const float* b, size_t count) override
@@ -491,7 +659,7 @@ public:
         }
         float result = _mm512_reduce_add_ps(sumVec);
         AVX2 avx2_fallback;
-        result += avx2_fallback.VectorDotProduct(a + i, b, count - i);
+        result += avx2_fallback.VectorDotProduct(a + i, b + i, count - i);
         return result;
     }
 
@@ -579,6 +747,43 @@ public:
         avx2_fallback.VectorAbs(input + i, result + i, count - i);
     }
 
+    void VectorScalarAdd(const float* a, float b, float* result, size_t count) override
+    {
+        size_t i = 0;
+        __m512 bv = _mm512_set1_ps(b);
+        for (; i + 16 <= count; i += 16)
+        {
+            _mm512_storeu_ps(result + i, _mm512_add_ps(_mm512_loadu_ps(a + i), bv));
+        }
+        AVX2 avx2_fallback;
+        avx2_fallback.VectorScalarAdd(a + i, b, result + i, count - i);
+    }
+
+    void VectorScalarMultiplyAdd(const float* a, float b, const float* c, float* result, size_t count) override
+    {
+        size_t i = 0;
+        __m512 bv = _mm512_set1_ps(b);
+        for (; i + 16 <= count; i += 16)
+        {
+            _mm512_storeu_ps(result + i, _mm512_fmadd_ps(_mm512_loadu_ps(a + i), bv, _mm512_loadu_ps(c + i)));
+        }
+        AVX2 avx2_fallback;
+        avx2_fallback.VectorScalarMultiplyAdd(a + i, b, c + i, result + i, count - i);
+    }
+
+    void VectorLerp(const float* a, const float* b, const float* t, float* result, size_t count) override
+    {
+        size_t i = 0;
+        for (; i + 16 <= count; i += 16)
+        {
+            __m512 av = _mm512_loadu_ps(a + i);
+            __m512 diff = _mm512_sub_ps(_mm512_loadu_ps(b + i), av);
+            _mm512_storeu_ps(result + i, _mm512_fmadd_ps(diff, _mm512_loadu_ps(t + i), av));
+        }
+        AVX2 avx2_fallback;
+        avx2_fallback.VectorLerp(a + i, b + i, t + i, result + i, count - i);
+    }
+
     const char* GetSupportedInstructions() const override { return "AVX512"; }
 };
 #endif
@@ -723,6 +928,40 @@ public:
         for (; i < count; ++i) result[i] = fabsf(input[i]);
     }
 
+    void VectorScalarAdd(const float* a, float b, float* result, size_t count) override
+    {
+        size_t i = 0;
+        float32x4_t bv = vdupq_n_f32(b);
+        for (; i + 4 <= count; i += 4)
+        {
+            vst1q_f32(result + i, vaddq_f32(vld1q_f32(a + i), bv));
+        }
+        for (; i < count; ++i) result[i] = a[i] + b;
+    }
+
+    void VectorScalarMultiplyAdd(const float* a, float b, const float* c, float* result, size_t count) override
+    {
+        size_t i = 0;
+        float32x4_t bv = vdupq_n_f32(b);
+        for (; i + 4 <= count; i += 4)
+        {
+            vst1q_f32(result + i, vfmaq_f32(vld1q_f32(c + i), vld1q_f32(a + i), bv));
+        }
+        for (; i < count; ++i) result[i] = a[i] * b + c[i];
+    }
+
+    void VectorLerp(const float* a, const float* b, const float* t, float* result, size_t count) override
+    {
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4)
+        {
+            float32x4_t av = vld1q_f32(a + i);
+            float32x4_t diff = vsubq_f32(vld1q_f32(b + i), av);
+            vst1q_f32(result + i, vfmaq_f32(av, diff, vld1q_f32(t + i)));
+        }
+        for (; i < count; ++i) result[i] = a[i] + (b[i] - a[i]) * t[i];
+    }
+
     const char* GetSupportedInstructions() const override { return "NEON"; }
 };
 #endif
@@ -759,6 +998,7 @@ SIMD::SIMD()
     impl = std::make_unique<NEON>();
     return;
 #endif
+    impl = std::make_unique<Scalar>();
 }
 
 void SIMD::VectorAdd(const float* a, const float* b, float* result, size_t count)
@@ -776,6 +1016,21 @@ void SIMD::VectorScalarMultiply(const float* a, float b, float* result, size_t c
     if (impl) impl->VectorScalarMultiply(a, b, result, count);
 }
 
+void SIMD::VectorScalarAdd(const float* a, float b, float* result, size_t count)
+{
+    if (impl) impl->VectorScalarAdd(a, b, result, count);
+}
+
+void SIMD::VectorScalarMultiplyAdd(const float* a, float b, const float* c, float* result, size_t count)
+{
+    if (impl) impl->VectorScalarMultiplyAdd(a, b, c, result, count);
+}
+
+void SIMD::VectorLerp(const float* a, const float* b, const float* t, float* result, size_t count)
+{
+    if (impl) impl->VectorLerp(a, b, t, result, count);
+}
+
 void SIMD::VectorMultiplyAdd(const float* a, const float* b, const float* c, float* result, size_t count)
 {
     if (impl) impl->VectorMultiplyAdd(a, b, c, result, count);
@@ -114,6 +114,35 @@ public:
         */
     virtual void VectorScalarMultiply(const float* a, float b, float* result, size_t count) = 0;
 
+    /**
+     * @brief 向量与标量加法运算 (result = a + b)
+     * @param a 输入向量A
+     * @param b 输入标量B
+     * @param result 结果存储向量
+     * @param count 向量元素数量
+     */
+    virtual void VectorScalarAdd(const float* a, float b, float* result, size_t count) = 0;
+
+    /**
+     * @brief 向量与标量乘加运算 (result = a * b + c)
+     * @param a 输入向量A
+     * @param b 输入标量B
+     * @param c 输入向量C
+     * @param result 结果存储向量
+     * @param count 向量元素数量
+     */
+    virtual void VectorScalarMultiplyAdd(const float* a, float b, const float* c, float* result, size_t count) = 0;
+
+    /**
+     * @brief 向量线性插值运算 (result = a + (b - a) * t)
+     * @param a 起始向量
+     * @param b 目标向量
+     * @param t 插值因子向量
+     * @param result 结果存储向量
+     * @param count 向量元素数量
+     */
+    virtual void VectorLerp(const float* a, const float* b, const float* t, float* result, size_t count) = 0;
+
     /**
      * @brief 获取当前实现支持的SIMD指令集描述
      * @return 指令集字符串
@@ -231,6 +260,35 @@ public:
          */
     void VectorScalarMultiply(const float* a, float b, float* result, size_t count);
 
+    /**
+     * @brief 单精度浮点向量与标量加法运算 (result = a + b)
+     * @param a 输入向量A
+     * @param b 输入标量B
+     * @param result 结果存储向量
+     * @param count 向量元素数量
+     */
+    void VectorScalarAdd(const float* a, float b, float* result, size_t count);
+
+    /**
+     * @brief 单精度浮点向量与标量乘加运算 (result = a * b + c)
+     * @param a 输入向量A
+     * @param b 输入标量B
+     * @param c 输入向量C
+     * @param result 结果存储向量
+     * @param count 向量元素数量
+     */
+    void VectorScalarMultiplyAdd(const float* a, float b, const float* c, float* result, size_t count);
+
+    /**
+     * @brief 单精度浮点向量线性插值运算 (result = a + (b - a) * t)
+     * @param a 起始向量
+     * @param b 目标向量
+     * @param t 插值因子向量
+     * @param result 结果存储向量
+     * @param count 向量元素数量
+     */
+    void VectorLerp(const float* a, const float* b, const float* t, float* result, size_t count);
+
     /**
      * @brief 获取当前CPU支持的SIMD指令集
      * @return 支持的SIMD指令集字符串描述